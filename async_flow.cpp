@@ -0,0 +1,355 @@
+#include <algorithm>
+#include "async_flow.h"
+
+std::array<std::atomic<AsyncFlow*>, LaneContext::MAX_LANES> AsyncFlow::asyncFlows_ = {};
+std::mutex AsyncFlow::mutex_;
+
+AsyncFlow::Flow::Flow(AsyncFlow* owner, const std::string& name, uint64_t generation)
+    : owner_(owner),
+    name_(name),
+    generation_(generation),
+    startTime_(std::chrono::steady_clock::now()),
+    budgetMs_(0),
+    decidedMs_(-1),
+    isOverBudget_(false)
+{
+}
+
+AsyncFlow::Flow::~Flow()
+{
+    int64_t elapsedMs = FnGetElapsedMs();
+    if (budgetMs_ > 0)
+    {
+        owner_->budgetFinished(*this, elapsedMs);
+    }
+    owner_->flowFinished(elapsedMs);
+}
+
+const std::string& AsyncFlow::Flow::FnGetName() const
+{
+    return name_;
+}
+
+bool AsyncFlow::Flow::FnIsCurrent() const
+{
+    return generation_ == owner_->generation_.load();
+}
+
+int64_t AsyncFlow::Flow::FnGetElapsedMs() const
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime_).count();
+}
+
+void AsyncFlow::Flow::FnSetBudget(int budgetMs)
+{
+    budgetMs_ = std::max(0, budgetMs);
+}
+
+int AsyncFlow::Flow::FnGetBudgetLeftMs() const
+{
+    if ((budgetMs_ <= 0) || (decidedMs_ >= 0))
+    {
+        return INT_MAX;
+    }
+    return static_cast<int>(std::max<int64_t>(0, budgetMs_ - FnGetElapsedMs()));
+}
+
+void AsyncFlow::Flow::FnRecordSource(const std::string& lookup, const std::string& source, bool isOverBudget)
+{
+    sources_ += (sources_.empty() ? "" : ", ") + lookup + "=" + source + (isOverBudget ? " (over budget)" : "");
+    isOverBudget_ = isOverBudget_ || isOverBudget;
+}
+
+void AsyncFlow::Flow::FnMarkDecided()
+{
+    if (decidedMs_ < 0)
+    {
+        decidedMs_ = FnGetElapsedMs();
+    }
+}
+
+AsyncFlow::AsyncFlow()
+    : logFileName_("flow"),
+    laneId_(LaneContext::FnGetCurrentLane()),
+    ioContext_(nullptr),
+    blockingContext_(nullptr),
+    isFlowRunning_(false),
+    generation_(0),
+    flowCount_(0),
+    queuedFlowCount_(0),
+    droppedFlowCount_(0),
+    staleStepCount_(0),
+    stepCount_(0),
+    timeoutCount_(0),
+    lateCompletionCount_(0),
+    maxStepMs_(0),
+    maxFlowMs_(0),
+    budgetFlowCount_(0),
+    budgetMissCount_(0),
+    lateAnswerCount_(0),
+    lateMismatchCount_(0)
+{
+}
+
+AsyncFlow* AsyncFlow::getInstance()
+{
+    return LazyInstance::FnGet(asyncFlows_[LaneContext::FnGetCurrentLane()], mutex_, []() { return new AsyncFlow(); });
+}
+
+void AsyncFlow::FnInit(boost::asio::io_context& ioContext, boost::asio::io_context& blockingContext)
+{
+    ioContext_ = &ioContext;
+    blockingContext_ = &blockingContext;
+    strand_ = std::make_unique<boost::asio::strand<boost::asio::io_context::executor_type>>(boost::asio::make_strand(ioContext));
+}
+
+void AsyncFlow::FnStartFlow(const std::string& name, FlowFunction flowFunction)
+{
+    boost::asio::post(*strand_, LaneContext::FnBind(laneId_, [this, name, flowFunction]()
+    {
+        if (!isFlowRunning_)
+        {
+            runFlow(name, flowFunction);
+            return;
+        }
+
+        // Keep the most recent requests, an old one is of no use once the queue is this deep
+        if (pendingFlows_.size() >= MAX_PENDING_FLOWS)
+        {
+            droppedFlowCount_.fetch_add(1);
+            Logger::getInstance()->FnLog("Flow queue full, drop " + pendingFlows_.front().first, logFileName_, "FLOW");
+            pendingFlows_.pop_front();
+        }
+
+        queuedFlowCount_.fetch_add(1);
+        pendingFlows_.emplace_back(name, flowFunction);
+    }));
+}
+
+void AsyncFlow::FnPost(std::function<void()> task)
+{
+    if (strand_ == nullptr)
+    {
+        runStage("post", task);
+        return;
+    }
+
+    boost::asio::post(*strand_, LaneContext::FnBind(laneId_, [this, task]()
+    {
+        runStage("post", task);
+    }));
+}
+
+bool AsyncFlow::FnIsAnyFlowRunning()
+{
+    for (auto& asyncFlow : asyncFlows_)
+    {
+        AsyncFlow* instance = asyncFlow.load();
+        if ((instance != nullptr) && instance->isFlowRunning_.load())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void AsyncFlow::FnInvalidateFlows()
+{
+    generation_.fetch_add(1);
+}
+
+void AsyncFlow::runFlow(const std::string& name, FlowFunction flowFunction)
+{
+    isFlowRunning_ = true;
+    flowCount_.fetch_add(1);
+
+    // The flow is released when the last step holding it completes, or here if it had nothing to wait for
+    FlowPtr flow = std::make_shared<Flow>(this, name, generation_.load());
+    runStage(name, [&]() { flowFunction(std::move(flow)); });
+}
+
+void AsyncFlow::runStage(const std::string& name, const std::function<void()>& stage)
+{
+    // A throwing stage ends its flow, it must not unwind into the io_context
+    try
+    {
+        stage();
+    }
+    catch (const std::exception& e)
+    {
+        std::stringstream ss;
+        ss << __func__ << ", Flow: " << name << ", Exception: " << e.what();
+        Logger::getInstance()->FnLogExceptionError(ss.str());
+    }
+    catch (...)
+    {
+        std::stringstream ss;
+        ss << __func__ << ", Flow: " << name << ", Exception: Unknown Exception";
+        Logger::getInstance()->FnLogExceptionError(ss.str());
+    }
+}
+
+void AsyncFlow::flowFinished(int64_t elapsedMs)
+{
+    updateMax(maxFlowMs_, static_cast<uint64_t>(std::max<int64_t>(0, elapsedMs)));
+
+    // Posted rather than run inline, the flow may be released from deep inside its own last step
+    boost::asio::post(*strand_, LaneContext::FnBind(laneId_, [this]()
+    {
+        isFlowRunning_ = false;
+
+        if (!pendingFlows_.empty())
+        {
+            auto next = std::move(pendingFlows_.front());
+            pendingFlows_.pop_front();
+            runFlow(next.first, next.second);
+        }
+    }));
+}
+
+void AsyncFlow::budgetFinished(const Flow& flow, int64_t elapsedMs)
+{
+    // A flow that ended before deciding (blacklist, superseded) counts up to its end
+    int64_t decidedMs = (flow.decidedMs_ >= 0) ? flow.decidedMs_ : elapsedMs;
+    bool isMissed = flow.isOverBudget_ || (decidedMs > flow.budgetMs_);
+
+    budgetFlowCount_.fetch_add(1);
+    if (isMissed)
+    {
+        budgetMissCount_.fetch_add(1);
+    }
+
+    std::stringstream ss;
+    ss << "Flow " << flow.name_ << (isMissed ? " missed its budget, decided in " : " decided in ") << decidedMs << " ms of " << flow.budgetMs_ << " ms";
+    if (!flow.sources_.empty())
+    {
+        ss << ": " << flow.sources_;
+    }
+    Logger::getInstance()->FnLog(ss.str(), logFileName_, "FLOW");
+}
+
+void AsyncFlow::FnRecordLateAnswer(const std::string& lookup, const std::string& key, bool isMismatch, const std::string& details)
+{
+    lateAnswerCount_.fetch_add(1);
+    if (isMismatch)
+    {
+        lateMismatchCount_.fetch_add(1);
+    }
+
+    std::stringstream ss;
+    ss << "Late central " << lookup << " for " << key << (isMismatch ? " differs from the local answer used, " : " agrees with the local answer used, ") << details;
+    Logger::getInstance()->FnLog(ss.str(), logFileName_, "FLOW");
+}
+
+void AsyncFlow::FnDelay(FlowPtr flow, int delayMs, std::function<void()> continuation)
+{
+    if (delayMs <= 0)
+    {
+        continuation();
+        return;
+    }
+
+    auto timer = std::make_shared<boost::asio::steady_timer>(*ioContext_, std::chrono::milliseconds(delayMs));
+    timer->async_wait(boost::asio::bind_executor(*strand_, LaneContext::FnBind(laneId_, [this, timer, flow, continuation](const boost::system::error_code& ec)
+    {
+        if (ec)
+        {
+            return;
+        }
+
+        if (!flow->FnIsCurrent())
+        {
+            staleStepCount_.fetch_add(1);
+            Logger::getInstance()->FnLog("Flow " + flow->FnGetName() + " superseded, drop delayed step", logFileName_, "FLOW");
+            return;
+        }
+
+        runStage(flow->FnGetName(), continuation);
+    })));
+}
+
+std::function<void()> AsyncFlow::FnJoin(int count, std::function<void()> continuation)
+{
+    auto remaining = std::make_shared<int>(count);
+    return [remaining, continuation]()
+    {
+        if (--(*remaining) == 0)
+        {
+            continuation();
+        }
+    };
+}
+
+void AsyncFlow::FnRunDetached(const std::string& stepName, std::function<void()> blockingCall)
+{
+    boost::asio::post(*blockingContext_, LaneContext::FnBind(laneId_, [stepName, blockingCall]()
+    {
+        try
+        {
+            blockingCall();
+        }
+        catch (const std::exception& e)
+        {
+            std::stringstream ss;
+            ss << __func__ << ", Step: " << stepName << ", Exception: " << e.what();
+            Logger::getInstance()->FnLogExceptionError(ss.str());
+        }
+        catch (...)
+        {
+            std::stringstream ss;
+            ss << __func__ << ", Step: " << stepName << ", Exception: Unknown Exception";
+            Logger::getInstance()->FnLogExceptionError(ss.str());
+        }
+    }));
+}
+
+void AsyncFlow::updateMax(std::atomic<uint64_t>& maxValue, uint64_t value)
+{
+    uint64_t current = maxValue.load();
+    while ((value > current) && !maxValue.compare_exchange_weak(current, value))
+    {
+    }
+}
+
+AsyncFlow::AsyncFlowStats AsyncFlow::FnGetStats() const
+{
+    AsyncFlowStats stats;
+    stats.flows = flowCount_.load();
+    stats.queuedFlows = queuedFlowCount_.load();
+    stats.droppedFlows = droppedFlowCount_.load();
+    stats.staleSteps = staleStepCount_.load();
+    stats.steps = stepCount_.load();
+    stats.timeouts = timeoutCount_.load();
+    stats.lateCompletions = lateCompletionCount_.load();
+    stats.maxStepMs = maxStepMs_.load();
+    stats.maxFlowMs = maxFlowMs_.load();
+    stats.budgetFlows = budgetFlowCount_.load();
+    stats.budgetMisses = budgetMissCount_.load();
+    stats.lateAnswers = lateAnswerCount_.load();
+    stats.lateMismatches = lateMismatchCount_.load();
+
+    return stats;
+}
+
+void AsyncFlow::FnLogStats()
+{
+    AsyncFlowStats stats = FnGetStats();
+    if (stats.flows == 0)
+    {
+        return;
+    }
+
+    std::stringstream ss;
+    ss << "Async Flow => flows: " << stats.flows;
+    ss << ", queued: " << stats.queuedFlows;
+    ss << ", dropped: " << stats.droppedFlows;
+    ss << ", stale steps: " << stats.staleSteps;
+    ss << ", steps: " << stats.steps;
+    ss << ", timeouts: " << stats.timeouts;
+    ss << ", late: " << stats.lateCompletions;
+    ss << ", max step: " << stats.maxStepMs << "ms";
+    ss << ", max flow: " << stats.maxFlowMs << "ms";
+    ss << ", budget misses: " << stats.budgetMisses << "/" << stats.budgetFlows;
+    ss << ", late answers: " << stats.lateAnswers << " (" << stats.lateMismatches << " differed)";
+    Logger::getInstance()->FnLog(ss.str(), logFileName_, "FLOW");
+}
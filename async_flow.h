@@ -0,0 +1,265 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include "boost/asio.hpp"
+#include "lane_context.h"
+#include "log.h"
+#include "lazy_instance.h"
+
+// Runs the lane's transaction flows as chains of steps on one strand of the main io_context.
+// Blocking DB calls go to the bounded blocking context of IOExecutor; a flow waiting on a step or a display delay holds no thread.
+// Only one flow runs at a time, later flows queue behind it so tEntry/tExit are never shared between two flows.
+// Each lane has its own AsyncFlow, every stage and DB step runs in the lane that started the flow.
+class AsyncFlow
+{
+public:
+    static const std::size_t MAX_PENDING_FLOWS = 16;
+
+    // Alive while any step of the flow is outstanding, the next queued flow starts when the last reference goes
+    class Flow
+    {
+    public:
+        Flow(AsyncFlow* owner, const std::string& name, uint64_t generation);
+        ~Flow();
+        const std::string& FnGetName() const;
+        bool FnIsCurrent() const;
+        int64_t FnGetElapsedMs() const;
+
+        // Time from the start of the flow to its barrier decision, lookups are cut short to keep within it
+        void FnSetBudget(int budgetMs);
+        // What is left of the budget, 0 once it is spent, INT_MAX for a flow without one
+        int FnGetBudgetLeftMs() const;
+        // Where a lookup's answer came from, isOverBudget when the budget cut the lookup short
+        void FnRecordSource(const std::string& lookup, const std::string& source, bool isOverBudget = false);
+        // The lookups are done and the flow decides, the budget ends here
+        void FnMarkDecided();
+
+    private:
+        friend class AsyncFlow;
+        AsyncFlow* owner_;
+        std::string name_;
+        uint64_t generation_;
+        std::chrono::steady_clock::time_point startTime_;
+        // Only used on the flow strand
+        int budgetMs_;
+        int64_t decidedMs_;
+        bool isOverBudget_;
+        std::string sources_;
+    };
+
+    using FlowPtr = std::shared_ptr<Flow>;
+    using FlowFunction = std::function<void(FlowPtr)>;
+
+    struct AsyncFlowStats
+    {
+        uint64_t flows;
+        uint64_t queuedFlows;
+        uint64_t droppedFlows;
+        uint64_t staleSteps;
+        uint64_t steps;
+        uint64_t timeouts;
+        uint64_t lateCompletions;
+        uint64_t maxStepMs;
+        uint64_t maxFlowMs;
+        uint64_t budgetFlows;
+        uint64_t budgetMisses;
+        uint64_t lateAnswers;
+        uint64_t lateMismatches;
+    };
+
+    static AsyncFlow* getInstance();
+    void FnInit(boost::asio::io_context& ioContext, boost::asio::io_context& blockingContext);
+
+    // Queue a flow, safe to call from any thread
+    void FnStartFlow(const std::string& name, FlowFunction flowFunction);
+
+    // Vehicle changed (Clearme), steps of older flows are dropped when they complete
+    void FnInvalidateFlows();
+
+    // Run a blocking call on the DB pool. continuation runs on the flow strand with either the result or,
+    // once timeoutMs has passed, fallbackValue and timedOut = true. lateCompletion receives a result nobody
+    // waits for any more (after the timeout, or the flow was superseded), for bookkeeping that must still happen.
+    template <typename T>
+    void FnRunStep(FlowPtr flow, const std::string& stepName, int timeoutMs,
+                   std::function<T()> blockingCall, T fallbackValue,
+                   std::function<void(T, bool)> continuation,
+                   std::function<void(T)> lateCompletion = nullptr);
+
+    // Continue the flow after delayMs, replaces sleeps used to keep a message on the display
+    void FnDelay(FlowPtr flow, int delayMs, std::function<void()> continuation);
+
+    // Returns a function to call once per finished branch, continuation runs after the count-th call.
+    // Used on the strand to run independent lookups together.
+    static std::function<void()> FnJoin(int count, std::function<void()> continuation);
+
+    // Run task on the flow strand, between the lane's flow stages; runs it in place before FnInit
+    void FnPost(std::function<void()> task);
+
+    // Blocking call that nothing waits for, e.g. audit records
+    void FnRunDetached(const std::string& stepName, std::function<void()> blockingCall);
+
+    // Whether any lane is in the middle of a transaction, background work yields to it
+    static bool FnIsAnyFlowRunning();
+
+    // A central answer that came after its flow went on with the local one, isMismatch when they differ
+    void FnRecordLateAnswer(const std::string& lookup, const std::string& key, bool isMismatch, const std::string& details);
+
+    AsyncFlowStats FnGetStats() const;
+    void FnLogStats();
+
+    /**
+     * Singleton AsyncFlow should not be cloneable.
+     */
+    AsyncFlow(AsyncFlow& asyncFlow) = delete;
+
+    /**
+     * Singleton AsyncFlow should not be assignable.
+     */
+    void operator=(const AsyncFlow&) = delete;
+
+private:
+    template <typename T>
+    struct StepState
+    {
+        StepState(boost::asio::io_context& ioContext) : timer(ioContext), isDone(false) {}
+        boost::asio::steady_timer timer;
+        bool isDone;
+        FlowPtr flow;
+        std::function<void(T, bool)> continuation;
+        std::chrono::steady_clock::time_point startTime;
+    };
+
+    static std::array<std::atomic<AsyncFlow*>, LaneContext::MAX_LANES> asyncFlows_;
+    static std::mutex mutex_;
+    std::string logFileName_;
+    int laneId_;
+    boost::asio::io_context* ioContext_;
+    std::unique_ptr<boost::asio::strand<boost::asio::io_context::executor_type>> strand_;
+    boost::asio::io_context* blockingContext_;
+    std::deque<std::pair<std::string, FlowFunction>> pendingFlows_;
+    std::atomic<bool> isFlowRunning_;
+    std::atomic<uint64_t> generation_;
+    std::atomic<uint64_t> flowCount_;
+    std::atomic<uint64_t> queuedFlowCount_;
+    std::atomic<uint64_t> droppedFlowCount_;
+    std::atomic<uint64_t> staleStepCount_;
+    std::atomic<uint64_t> stepCount_;
+    std::atomic<uint64_t> timeoutCount_;
+    std::atomic<uint64_t> lateCompletionCount_;
+    std::atomic<uint64_t> maxStepMs_;
+    std::atomic<uint64_t> maxFlowMs_;
+    std::atomic<uint64_t> budgetFlowCount_;
+    std::atomic<uint64_t> budgetMissCount_;
+    std::atomic<uint64_t> lateAnswerCount_;
+    std::atomic<uint64_t> lateMismatchCount_;
+    AsyncFlow();
+    void runFlow(const std::string& name, FlowFunction flowFunction);
+    void flowFinished(int64_t elapsedMs);
+    void budgetFinished(const Flow& flow, int64_t elapsedMs);
+    void runStage(const std::string& name, const std::function<void()>& stage);
+    static void updateMax(std::atomic<uint64_t>& maxValue, uint64_t value);
+};
+
+template <typename T>
+void AsyncFlow::FnRunStep(FlowPtr flow, const std::string& stepName, int timeoutMs,
+                          std::function<T()> blockingCall, T fallbackValue,
+                          std::function<void(T, bool)> continuation,
+                          std::function<void(T)> lateCompletion)
+{
+    stepCount_.fetch_add(1);
+
+    auto state = std::make_shared<StepState<T>>(*ioContext_);
+    state->flow = std::move(flow);
+    state->continuation = std::move(continuation);
+    state->startTime = std::chrono::steady_clock::now();
+
+    // Whichever of the timer and the result reaches the strand first completes the step. The flow
+    // reference is released right away so a slow DB call does not hold up the next flow.
+    auto complete = [this, state, stepName, lateCompletion](T result, bool timedOut)
+    {
+        state->isDone = true;
+        FlowPtr stepFlow = std::move(state->flow);
+        std::function<void(T, bool)> stepContinuation = std::move(state->continuation);
+
+        if (!stepFlow->FnIsCurrent())
+        {
+            staleStepCount_.fetch_add(1);
+            Logger::getInstance()->FnLog("Flow " + stepFlow->FnGetName() + " superseded, drop step " + stepName, logFileName_, "FLOW");
+            if (!timedOut && lateCompletion)
+            {
+                runStage(stepName, [&]() { lateCompletion(result); });
+            }
+            return;
+        }
+
+        runStage(stepFlow->FnGetName(), [&]() { stepContinuation(result, timedOut); });
+    };
+
+    state->timer.expires_after(std::chrono::milliseconds(timeoutMs));
+    state->timer.async_wait(boost::asio::bind_executor(*strand_, LaneContext::FnBind(laneId_, [this, state, stepName, fallbackValue, timeoutMs, complete](const boost::system::error_code& ec)
+    {
+        if (ec || state->isDone)
+        {
+            return;
+        }
+
+        timeoutCount_.fetch_add(1);
+        std::stringstream ss;
+        ss << "Flow " << state->flow->FnGetName() << ", step " << stepName << " timed out after " << timeoutMs << " ms, continue with fallback";
+        Logger::getInstance()->FnLog(ss.str(), logFileName_, "FLOW");
+
+        complete(fallbackValue, true);
+    })));
+
+    boost::asio::post(*blockingContext_, LaneContext::FnBind(laneId_, [this, state, stepName, blockingCall, fallbackValue, lateCompletion, complete]()
+    {
+        T result = fallbackValue;
+        try
+        {
+            result = blockingCall();
+        }
+        catch (const std::exception& e)
+        {
+            std::stringstream ss;
+            ss << __func__ << ", Step: " << stepName << ", Exception: " << e.what();
+            Logger::getInstance()->FnLogExceptionError(ss.str());
+        }
+        catch (...)
+        {
+            std::stringstream ss;
+            ss << __func__ << ", Step: " << stepName << ", Exception: Unknown Exception";
+            Logger::getInstance()->FnLogExceptionError(ss.str());
+        }
+
+        boost::asio::post(*strand_, LaneContext::FnBind(laneId_, [this, state, stepName, result, lateCompletion, complete]()
+        {
+            uint64_t stepMs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - state->startTime).count());
+            updateMax(maxStepMs_, stepMs);
+
+            if (!state->isDone)
+            {
+                state->timer.cancel();
+                complete(result, false);
+            }
+            else
+            {
+                lateCompletionCount_.fetch_add(1);
+                Logger::getInstance()->FnLog("Step " + stepName + " completed after timeout in " + std::to_string(stepMs) + " ms", logFileName_, "FLOW");
+                if (lateCompletion)
+                {
+                    runStage(stepName, [&]() { lateCompletion(result); });
+                }
+            }
+        }));
+    }));
+}
@@ -11,9 +11,10 @@
 #include <unistd.h>
 #include "barcode_reader.h"
 #include "event_manager.h"
+#include "io_executor.h"
 #include "log.h"
 
-BARCODE_READER* BARCODE_READER::barcode_ = nullptr;
+std::atomic<BARCODE_READER*> BARCODE_READER::barcode_(nullptr);
 std::mutex BARCODE_READER::mutex_;
 
 BARCODE_READER::BARCODE_READER()
@@ -24,22 +25,16 @@ BARCODE_READER::BARCODE_READER()
 
 BARCODE_READER* BARCODE_READER::getInstance()
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (barcode_ == nullptr)
-    {
-        barcode_ = new BARCODE_READER();
-    }
-
-    return barcode_;
+    return LazyInstance::FnGet(barcode_, mutex_, []() { return new BARCODE_READER(); });
 }
 
 void BARCODE_READER::destroyInstance()
 {
     std::lock_guard<std::mutex> lock(mutex_);
-    if (barcode_)
+    BARCODE_READER* instance = barcode_.exchange(nullptr);
+    if (instance)
     {
-        delete barcode_;
-        barcode_ = nullptr;
+        delete instance;
     }
 }
 
@@ -182,6 +177,8 @@ bool BARCODE_READER::isDeviceAvailable(const std::string& devicePath)
 
 void BARCODE_READER::monitoringBarcodeThreadFunction()
 {
+    IOExecutor::FnNameCurrentThread("pbs-barcode");
+
     bool isBarcodeNotConnectedLogged = false;  // Flag to log retrying message
     bool isBarcodeRecovered = false;            // Flag to log recovery message
 
@@ -202,7 +199,7 @@ void BARCODE_READER::monitoringBarcodeThreadFunction()
             if (!barcode.empty())
             {
                 Logger::getInstance()->FnLog("INFO: Barcode Scanned | Barcode: " +  barcode, logFileName_, "BCODE");
-                EventManager::getInstance()->FnEnqueueEvent("Evt_handleBarcodeReceived", barcode);
+                EventManager::getInstance()->FnEnqueueEvent(EventID::BARCODE_RECEIVED, barcode);
             }
         }
         else
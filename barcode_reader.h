@@ -5,6 +5,7 @@
 #include <iostream>
 #include <mutex>
 #include <vector>
+#include "lazy_instance.h"
 
 class BARCODE_READER
 {
@@ -92,7 +93,7 @@ public:
     void operator=(const BARCODE_READER&) = delete;
 
 private:
-    static BARCODE_READER* barcode_;
+    static std::atomic<BARCODE_READER*> barcode_;
     static std::mutex mutex_;
     std::string logFileName_;
     std::atomic<bool> isBarcodeMonitoringThreadRunning_;
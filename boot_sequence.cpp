@@ -0,0 +1,393 @@
+#include <atomic>
+#include <sstream>
+#include "boot_sequence.h"
+#include "lane_context.h"
+#include "log.h"
+
+BootSequence::BootSequence(int laneId)
+    : laneId_(laneId),
+    logFileName_("boot"),
+    finishedPhases_(0),
+    isStarted_(false),
+    context_(nullptr),
+    bootStartTime_(std::chrono::steady_clock::now())
+{
+}
+
+void BootSequence::FnAddPhase(const std::string& name, const std::vector<std::string>& dependsOn, std::function<bool()> task)
+{
+    Phase phase;
+    phase.name = name;
+    phase.dependsOn = dependsOn;
+    phase.task = std::move(task);
+    addPhase(std::move(phase));
+}
+
+void BootSequence::FnAddAsyncPhase(const std::string& name, const std::vector<std::string>& dependsOn, std::function<void(std::function<void(bool)> done)> task)
+{
+    Phase phase;
+    phase.name = name;
+    phase.dependsOn = dependsOn;
+    phase.asyncTask = std::move(task);
+    addPhase(std::move(phase));
+}
+
+void BootSequence::addPhase(Phase phase)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (isStarted_)
+    {
+        Logger::getInstance()->FnLog("Boot phase added after start, ignored : " + phase.name, logFileName_, "BOOT");
+        return;
+    }
+
+    phase.pendingDependencies = 0;
+    phase.isBlocked = false;
+    phase.state = PhaseState::PENDING;
+    phases_.push_back(std::move(phase));
+}
+
+int BootSequence::findPhase(const std::string& name) const
+{
+    for (size_t i = 0; i < phases_.size(); i++)
+    {
+        if (phases_[i].name == name)
+        {
+            return static_cast<int>(i);
+        }
+    }
+
+    return -1;
+}
+
+void BootSequence::FnStart(boost::asio::io_context& context, std::function<void()> onFinished)
+{
+    std::vector<size_t> readyPhases;
+    std::vector<size_t> blockedPhases;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (isStarted_)
+        {
+            return;
+        }
+
+        isStarted_ = true;
+        context_ = &context;
+        onFinished_ = std::move(onFinished);
+        bootStartTime_ = std::chrono::steady_clock::now();
+
+        for (size_t i = 0; i < phases_.size(); i++)
+        {
+            for (const auto& dependency : phases_[i].dependsOn)
+            {
+                int dependencyIndex = findPhase(dependency);
+                if (dependencyIndex < 0)
+                {
+                    // An unknown dependency can never finish, the phase is skipped rather than left hanging
+                    Logger::getInstance()->FnLog("Boot phase " + phases_[i].name + " depends on unknown phase " + dependency, logFileName_, "BOOT");
+                    phases_[i].isBlocked = true;
+                    continue;
+                }
+                phases_[dependencyIndex].dependents.push_back(i);
+                phases_[i].pendingDependencies++;
+            }
+        }
+
+        for (size_t i = 0; i < phases_.size(); i++)
+        {
+            if (phases_[i].pendingDependencies == 0)
+            {
+                if (phases_[i].isBlocked)
+                {
+                    blockedPhases.push_back(i);
+                }
+                else
+                {
+                    readyPhases.push_back(i);
+                }
+            }
+        }
+    }
+
+    std::stringstream ss;
+    ss << "Lane " << laneId_ << " boot started, phases : " << phases_.size();
+    Logger::getInstance()->FnLog(ss.str(), logFileName_, "BOOT");
+
+    for (size_t index : blockedPhases)
+    {
+        completePhase(index, PhaseState::SKIPPED);
+    }
+
+    auto self = shared_from_this();
+    for (size_t index : readyPhases)
+    {
+        boost::asio::post(context, [self, index]() { self->runPhase(index); });
+    }
+}
+
+void BootSequence::runPhase(size_t index)
+{
+    LaneContext::Scope laneScope(laneId_);
+    std::function<bool()> task;
+    std::function<void(std::function<void(bool)>)> asyncTask;
+    std::string name;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        phases_[index].state = PhaseState::RUNNING;
+        phases_[index].startTime = std::chrono::steady_clock::now();
+        task = phases_[index].task;
+        asyncTask = phases_[index].asyncTask;
+        name = phases_[index].name;
+    }
+
+    // done may come from any thread, only its first call, or a throw before it, finishes the phase
+    auto isDone = std::make_shared<std::atomic<bool>>(false);
+    bool isOk = false;
+    try
+    {
+        if (asyncTask)
+        {
+            auto self = shared_from_this();
+            asyncTask([self, index, isDone](bool isTaskOk)
+            {
+                if (!isDone->exchange(true))
+                {
+                    self->completePhase(index, isTaskOk ? PhaseState::DONE : PhaseState::FAILED);
+                }
+            });
+            return;
+        }
+
+        isOk = task();
+    }
+    catch (const std::exception& e)
+    {
+        std::stringstream ss;
+        ss << __func__ << ", Phase: " << name << ", Exception: " << e.what();
+        Logger::getInstance()->FnLogExceptionError(ss.str());
+    }
+    catch (...)
+    {
+        std::stringstream ss;
+        ss << __func__ << ", Phase: " << name << ", Exception: Unknown Exception";
+        Logger::getInstance()->FnLogExceptionError(ss.str());
+    }
+
+    if (!isDone->exchange(true))
+    {
+        completePhase(index, isOk ? PhaseState::DONE : PhaseState::FAILED);
+    }
+}
+
+void BootSequence::completePhase(size_t index, PhaseState state)
+{
+    std::vector<size_t> readyPhases;
+    std::vector<std::string> logLines;
+    std::vector<std::pair<std::function<void(bool)>, bool>> callbacks;
+    bool isAllFinished = false;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto now = std::chrono::steady_clock::now();
+        std::vector<std::pair<size_t, PhaseState>> finished = { { index, state } };
+
+        while (!finished.empty())
+        {
+            size_t current = finished.back().first;
+            PhaseState currentState = finished.back().second;
+            finished.pop_back();
+
+            Phase& phase = phases_[current];
+            if (currentState == PhaseState::SKIPPED)
+            {
+                phase.startTime = now;
+            }
+            phase.state = currentState;
+            phase.endTime = now;
+            finishedPhases_++;
+
+            for (auto& callback : phase.finishedCallbacks)
+            {
+                callbacks.emplace_back(std::move(callback), currentState == PhaseState::DONE);
+            }
+            phase.finishedCallbacks.clear();
+
+            std::stringstream ss;
+            ss << "Lane " << laneId_ << " boot phase " << phase.name << " " << FnGetPhaseStateName(currentState);
+            ss << " at " << elapsedMs(phase.startTime) << "ms, took " << std::chrono::duration_cast<std::chrono::milliseconds>(phase.endTime - phase.startTime).count() << "ms";
+            logLines.push_back(ss.str());
+
+            for (size_t dependent : phase.dependents)
+            {
+                Phase& next = phases_[dependent];
+                if (currentState != PhaseState::DONE)
+                {
+                    next.isBlocked = true;
+                }
+
+                next.pendingDependencies--;
+                if (next.pendingDependencies == 0)
+                {
+                    if (next.isBlocked)
+                    {
+                        finished.push_back({ dependent, PhaseState::SKIPPED });
+                    }
+                    else
+                    {
+                        readyPhases.push_back(dependent);
+                    }
+                }
+            }
+        }
+
+        isAllFinished = (finishedPhases_ == phases_.size());
+    }
+
+    for (const auto& line : logLines)
+    {
+        Logger::getInstance()->FnLog(line, logFileName_, "BOOT");
+    }
+
+    auto self = shared_from_this();
+    for (size_t ready : readyPhases)
+    {
+        boost::asio::post(*context_, [self, ready]() { self->runPhase(ready); });
+    }
+
+    finishedCond_.notify_all();
+
+    for (auto& callback : callbacks)
+    {
+        callback.first(callback.second);
+    }
+
+    if (isAllFinished)
+    {
+        Logger::getInstance()->FnLog("Lane " + std::to_string(laneId_) + " boot timeline : " + FnGetTimelineString(), logFileName_, "BOOT");
+        if (onFinished_)
+        {
+            onFinished_();
+        }
+    }
+}
+
+bool BootSequence::FnWaitFor(const std::string& name)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    int index = findPhase(name);
+    if (index < 0)
+    {
+        return false;
+    }
+
+    finishedCond_.wait(lock, [this, index]()
+    {
+        return isPhaseFinished(phases_[index].state);
+    });
+
+    return (phases_[index].state == PhaseState::DONE);
+}
+
+void BootSequence::FnOnPhaseFinished(const std::string& name, std::function<void(bool)> callback)
+{
+    bool isOk = false;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        int index = findPhase(name);
+        if ((index >= 0) && !isPhaseFinished(phases_[index].state))
+        {
+            phases_[index].finishedCallbacks.push_back(std::move(callback));
+            return;
+        }
+        isOk = (index >= 0) && (phases_[index].state == PhaseState::DONE);
+    }
+
+    callback(isOk);
+}
+
+bool BootSequence::isPhaseFinished(PhaseState state)
+{
+    return ((state == PhaseState::DONE) || (state == PhaseState::FAILED) || (state == PhaseState::SKIPPED));
+}
+
+bool BootSequence::FnIsFinished()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return (isStarted_ && (finishedPhases_ == phases_.size()));
+}
+
+std::vector<BootSequence::PhaseTiming> BootSequence::FnGetTimeline()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<PhaseTiming> timeline;
+    auto now = std::chrono::steady_clock::now();
+
+    for (const auto& phase : phases_)
+    {
+        PhaseTiming timing;
+        timing.name = phase.name;
+        timing.state = phase.state;
+        timing.startMs = (phase.state == PhaseState::PENDING) ? -1 : elapsedMs(phase.startTime);
+
+        if (phase.state == PhaseState::PENDING)
+        {
+            timing.durationMs = 0;
+        }
+        else if (phase.state == PhaseState::RUNNING)
+        {
+            timing.durationMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - phase.startTime).count();
+        }
+        else
+        {
+            timing.durationMs = std::chrono::duration_cast<std::chrono::milliseconds>(phase.endTime - phase.startTime).count();
+        }
+        timeline.push_back(timing);
+    }
+
+    return timeline;
+}
+
+// name:state@start+duration, separated by commas, e.g. params:done@12+340
+std::string BootSequence::FnGetTimelineString()
+{
+    std::stringstream ss;
+    bool isFirst = true;
+
+    for (const auto& timing : FnGetTimeline())
+    {
+        if (!isFirst)
+        {
+            ss << ",";
+        }
+        isFirst = false;
+
+        ss << timing.name << ":" << FnGetPhaseStateName(timing.state);
+        if (timing.startMs >= 0)
+        {
+            ss << "@" << timing.startMs << "+" << timing.durationMs;
+        }
+    }
+
+    return ss.str();
+}
+
+const char* BootSequence::FnGetPhaseStateName(PhaseState state)
+{
+    switch (state)
+    {
+        case PhaseState::PENDING:   return "pending";
+        case PhaseState::RUNNING:   return "running";
+        case PhaseState::DONE:      return "done";
+        case PhaseState::FAILED:    return "failed";
+        case PhaseState::SKIPPED:   return "skipped";
+        default:                    return "unknown";
+    }
+}
+
+int64_t BootSequence::elapsedMs(std::chrono::steady_clock::time_point timePoint) const
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(timePoint - bootStartTime_).count();
+}
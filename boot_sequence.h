@@ -0,0 +1,88 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "boost/asio.hpp"
+
+// Runs a lane's startup phases as a dependency graph on the executor's blocking pool. A phase is posted as
+// soon as every phase it depends on has finished, so independent DB work and device inits overlap, and a
+// phase whose dependency failed is skipped. The start and duration of every phase is kept as the boot timeline.
+class BootSequence : public std::enable_shared_from_this<BootSequence>
+{
+public:
+    enum class PhaseState
+    {
+        PENDING,
+        RUNNING,
+        DONE,
+        FAILED,
+        SKIPPED
+    };
+
+    struct PhaseTiming
+    {
+        std::string name;
+        PhaseState state;
+        int64_t startMs;
+        int64_t durationMs;
+    };
+
+    explicit BootSequence(int laneId);
+
+    // task returns false when the phase failed, phases must be added before FnStart
+    void FnAddPhase(const std::string& name, const std::vector<std::string>& dependsOn, std::function<bool()> task);
+    // The phase finishes when its task calls done, it holds no pool thread while it waits, e.g. on another lane
+    void FnAddAsyncPhase(const std::string& name, const std::vector<std::string>& dependsOn, std::function<void(std::function<void(bool)> done)> task);
+
+    // onFinished runs once every phase has finished, on the thread that ran the last phase
+    void FnStart(boost::asio::io_context& context, std::function<void()> onFinished);
+
+    // Blocks until the phase finished, returns true when it succeeded
+    bool FnWaitFor(const std::string& name);
+    bool FnIsFinished();
+    // callback gets true when the phase succeeded, it runs at once if the phase already finished
+    void FnOnPhaseFinished(const std::string& name, std::function<void(bool)> callback);
+
+    std::vector<PhaseTiming> FnGetTimeline();
+    std::string FnGetTimelineString();
+    static const char* FnGetPhaseStateName(PhaseState state);
+
+private:
+    struct Phase
+    {
+        std::string name;
+        std::vector<std::string> dependsOn;
+        std::function<bool()> task;
+        std::function<void(std::function<void(bool)>)> asyncTask;
+        std::vector<size_t> dependents;
+        std::vector<std::function<void(bool)>> finishedCallbacks;
+        size_t pendingDependencies;
+        bool isBlocked;
+        PhaseState state;
+        std::chrono::steady_clock::time_point startTime;
+        std::chrono::steady_clock::time_point endTime;
+    };
+
+    int laneId_;
+    std::string logFileName_;
+    std::mutex mutex_;
+    std::condition_variable finishedCond_;
+    std::vector<Phase> phases_;
+    size_t finishedPhases_;
+    bool isStarted_;
+    boost::asio::io_context* context_;
+    std::function<void()> onFinished_;
+    std::chrono::steady_clock::time_point bootStartTime_;
+    int findPhase(const std::string& name) const;
+    void addPhase(Phase phase);
+    static bool isPhaseFinished(PhaseState state);
+    void runPhase(size_t index);
+    void completePhase(size_t index, PhaseState state);
+    int64_t elapsedMs(std::chrono::steady_clock::time_point timePoint) const;
+};
@@ -0,0 +1,258 @@
+#include "circuit_breaker.h"
+
+CircuitBreaker::Call::Call(CircuitBreaker* breaker)
+    : breaker_(breaker),
+    isAllowed_(true),
+    isTrial_(false),
+    trialPeriod_(0),
+    isFailed_(false),
+    startTime_(std::chrono::steady_clock::now())
+{
+    if (breaker_ != nullptr)
+    {
+        isAllowed_ = breaker_->acquire(isTrial_, trialPeriod_);
+    }
+}
+
+CircuitBreaker::Call::~Call()
+{
+    if ((breaker_ != nullptr) && isAllowed_)
+    {
+        breaker_->record(isTrial_, trialPeriod_, isFailed_, std::chrono::steady_clock::now() - startTime_);
+    }
+}
+
+bool CircuitBreaker::Call::FnIsAllowed() const
+{
+    return isAllowed_;
+}
+
+void CircuitBreaker::Call::FnSetFailed()
+{
+    isFailed_ = true;
+}
+
+CircuitBreaker::CircuitBreaker(const std::string& name, const Settings& settings)
+    : name_(name),
+    settings_(settings),
+    state_(State::Closed),
+    consecutiveFailures_(0),
+    trialsInFlight_(0),
+    trialSuccesses_(0),
+    halfOpenPeriod_(0),
+    stats_()
+{
+}
+
+const char* CircuitBreaker::FnGetStateName(State state)
+{
+    switch (state)
+    {
+        case State::Closed:
+            return "closed";
+        case State::Open:
+            return "open";
+        case State::HalfOpen:
+            return "half-open";
+    }
+    return "unknown";
+}
+
+void CircuitBreaker::FnSetListener(Listener listener)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    listener_ = std::move(listener);
+}
+
+bool CircuitBreaker::FnIsOpen() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return (state_ == State::Open) && (std::chrono::steady_clock::now() - openedTime_ < settings_.openTime);
+}
+
+CircuitBreaker::State CircuitBreaker::FnGetState() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return state_;
+}
+
+CircuitBreaker::Stats CircuitBreaker::FnGetStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+const std::string& CircuitBreaker::FnGetName() const
+{
+    return name_;
+}
+
+bool CircuitBreaker::transition(State to)
+{
+    if (state_ == to)
+    {
+        return false;
+    }
+
+    state_ = to;
+    switch (to)
+    {
+        case State::Open:
+            openedTime_ = std::chrono::steady_clock::now();
+            stats_.opened++;
+            break;
+        case State::HalfOpen:
+            halfOpenPeriod_++;
+            trialsInFlight_ = 0;
+            trialSuccesses_ = 0;
+            break;
+        case State::Closed:
+            consecutiveFailures_ = 0;
+            break;
+    }
+    return true;
+}
+
+void CircuitBreaker::notify(State from, State to, const std::string& reason)
+{
+    Listener listener;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        listener = listener_;
+    }
+
+    if (listener)
+    {
+        listener(from, to, reason);
+    }
+}
+
+bool CircuitBreaker::acquire(bool& isTrial, uint64_t& trialPeriod)
+{
+    State from;
+    bool isChanged = false;
+    bool isAllowed = false;
+    isTrial = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        from = state_;
+
+        if ((state_ == State::Open) && (std::chrono::steady_clock::now() - openedTime_ >= settings_.openTime))
+        {
+            isChanged = transition(State::HalfOpen);
+        }
+
+        if (state_ == State::Closed)
+        {
+            isAllowed = true;
+        }
+        else if ((state_ == State::HalfOpen) && (trialsInFlight_ < settings_.trialCalls))
+        {
+            trialsInFlight_++;
+            isTrial = true;
+            trialPeriod = halfOpenPeriod_;
+            isAllowed = true;
+        }
+
+        if (isAllowed)
+        {
+            stats_.calls++;
+        }
+        else
+        {
+            stats_.shortCircuited++;
+        }
+    }
+
+    if (isChanged)
+    {
+        notify(from, State::HalfOpen, "open for " + std::to_string(settings_.openTime.count()) + " ms");
+    }
+    return isAllowed;
+}
+
+void CircuitBreaker::record(bool isTrial, uint64_t trialPeriod, bool isFailed, std::chrono::steady_clock::duration latency)
+{
+    bool isSlow = !isFailed && (latency > settings_.slowCall);
+    long latencyMs = static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(latency).count());
+    State from;
+    State to;
+    bool isChanged = false;
+    std::string reason;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        from = state_;
+        stats_.failures += isFailed ? 1 : 0;
+        stats_.slowCalls += isSlow ? 1 : 0;
+
+        if (isTrial)
+        {
+            // A trial of an earlier half open period may still finish after the state moved on, it neither
+            // frees a permit of the current period nor decides it
+            if ((state_ == State::HalfOpen) && (trialPeriod == halfOpenPeriod_))
+            {
+                trialsInFlight_--;
+
+                if (isFailed || isSlow)
+                {
+                    isChanged = transition(State::Open);
+                    reason = std::string("trial call ") + (isFailed ? "failed" : "slow") + " after " + std::to_string(latencyMs) + " ms";
+                }
+                else if (++trialSuccesses_ >= settings_.trialCalls)
+                {
+                    isChanged = transition(State::Closed);
+                    reason = "trial calls succeeded";
+                }
+            }
+        }
+        else if (state_ == State::Closed)
+        {
+            if (isFailed || isSlow)
+            {
+                if (++consecutiveFailures_ >= settings_.failureThreshold)
+                {
+                    isChanged = transition(State::Open);
+                    reason = std::to_string(consecutiveFailures_) + " calls failed or slow, last " + std::to_string(latencyMs) + " ms";
+                }
+            }
+            else
+            {
+                consecutiveFailures_ = 0;
+            }
+        }
+        to = state_;
+    }
+
+    if (isChanged)
+    {
+        notify(from, to, reason);
+    }
+}
+
+void CircuitBreaker::FnRecordProbe(bool isReachable)
+{
+    State from;
+    State to;
+    bool isChanged = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        from = state_;
+
+        if (!isReachable)
+        {
+            isChanged = transition(State::Open);
+            // No trial call while the server does not even answer the ping
+            openedTime_ = std::chrono::steady_clock::now();
+        }
+        else if (state_ == State::Open)
+        {
+            isChanged = transition(State::HalfOpen);
+        }
+        to = state_;
+    }
+
+    if (isChanged)
+    {
+        notify(from, to, isReachable ? "probe reached the server" : "probe failed");
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+
+// Health of one DB connection, fed by the outcome and latency of its calls and by the reachability probe.
+// Closed: calls go through. Open: calls fail at once so the caller takes its local path without waiting for a
+// timeout. Half open: after openTime, or as soon as the probe reaches the server again, a few trial calls decide
+// between closed and open.
+class CircuitBreaker
+{
+public:
+    enum class State
+    {
+        Closed,
+        Open,
+        HalfOpen
+    };
+
+    struct Settings
+    {
+        int failureThreshold;                   // consecutive failed or slow calls that open it
+        std::chrono::milliseconds slowCall;     // a call that succeeds slower than this counts as failed
+        std::chrono::milliseconds openTime;     // before trial calls are let through
+        int trialCalls;                         // trial calls at a time, all of them have to succeed to close
+    };
+
+    struct Stats
+    {
+        uint64_t calls;
+        uint64_t failures;
+        uint64_t slowCalls;
+        uint64_t shortCircuited;
+        uint64_t opened;
+    };
+
+    using Listener = std::function<void(State from, State to, const std::string& reason)>;
+
+    // Takes a permit for one call and records its outcome when it goes out of scope
+    class Call
+    {
+    public:
+        // breaker may be nullptr, the call is then always allowed and nothing is recorded
+        explicit Call(CircuitBreaker* breaker);
+        ~Call();
+
+        bool FnIsAllowed() const;
+        // The server could not be reached or did not answer, a rejected statement is not a failure
+        void FnSetFailed();
+
+        Call(const Call&) = delete;
+        void operator=(const Call&) = delete;
+
+    private:
+        CircuitBreaker* breaker_;
+        bool isAllowed_;
+        bool isTrial_;
+        uint64_t trialPeriod_;
+        bool isFailed_;
+        std::chrono::steady_clock::time_point startTime_;
+    };
+
+    CircuitBreaker(const std::string& name, const Settings& settings);
+
+    void FnSetListener(Listener listener);
+    // Result of the periodic ping: unreachable opens it, reachable again lets trial calls through without waiting
+    void FnRecordProbe(bool isReachable);
+    // Whether calls are currently failed at once, does not take a permit
+    bool FnIsOpen() const;
+    State FnGetState() const;
+    Stats FnGetStats() const;
+    const std::string& FnGetName() const;
+    static const char* FnGetStateName(State state);
+
+    CircuitBreaker(const CircuitBreaker&) = delete;
+    void operator=(const CircuitBreaker&) = delete;
+
+private:
+    mutable std::mutex mutex_;
+    std::string name_;
+    Settings settings_;
+    Listener listener_;
+    State state_;
+    int consecutiveFailures_;
+    int trialsInFlight_;
+    int trialSuccesses_;
+    // Bumped by every move to half open, a trial belongs to the period it was let through in
+    uint64_t halfOpenPeriod_;
+    std::chrono::steady_clock::time_point openedTime_;
+    Stats stats_;
+    bool acquire(bool& isTrial, uint64_t& trialPeriod);
+    void record(bool isTrial, uint64_t trialPeriod, bool isFailed, std::chrono::steady_clock::duration latency);
+    // Called with mutex_ held, returns false when the state did not change
+    bool transition(State to);
+    void notify(State from, State to, const std::string& reason);
+};
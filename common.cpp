@@ -11,7 +11,7 @@
 #include "log.h"
 #include "version.h"
 
-Common* Common::common_;
+std::atomic<Common*> Common::common_(nullptr);
 std::mutex Common::mutex_;
 
 Common::Common()
@@ -21,12 +21,7 @@ Common::Common()
 
 Common* Common::getInstance()
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (common_ == nullptr)
-    {
-        common_ = new Common();
-    }
-    return common_;
+    return LazyInstance::FnGet(common_, mutex_, []() { return new Common(); });
 }
 
 void Common::FnLogExecutableInfo(const std::string& str)
@@ -8,6 +8,7 @@
 #include <sstream>
 #include <vector>
 #include <mutex>
+#include "lazy_instance.h"
 
 #define DATE_TIME_FORMAT_SPACE  32
 
@@ -104,7 +105,7 @@ public:
     void operator=(const Common&) = delete;
 
 private:
-    static Common* common_;
+    static std::atomic<Common*> common_;
     static std::mutex mutex_;
     Common();
 };
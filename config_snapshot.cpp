@@ -0,0 +1,258 @@
+#include <chrono>
+#include <filesystem>
+#include <sstream>
+#include "config_snapshot.h"
+#include "log.h"
+
+std::array<std::atomic<ConfigSnapshot*>, LaneContext::MAX_LANES> ConfigSnapshot::configSnapshots_ = {};
+std::mutex ConfigSnapshot::mutex_;
+const std::string ConfigSnapshot::SNAPSHOT_FILE_PATH = "/home/root/carpark/Snapshot";
+
+ConfigSnapshot::ConfigSnapshot()
+    : logFileName_("boot"),
+    laneId_(LaneContext::FnGetCurrentLane()),
+    isReplaying_(false)
+{
+}
+
+ConfigSnapshot* ConfigSnapshot::getInstance()
+{
+    return LazyInstance::FnGet(configSnapshots_[LaneContext::FnGetCurrentLane()], mutex_, []() { return new ConfigSnapshot(); });
+}
+
+std::string ConfigSnapshot::getFilePath() const
+{
+    return SNAPSHOT_FILE_PATH + "/config_lane" + std::to_string(laneId_) + ".snap";
+}
+
+// A first row only select answers differently from a full one, so the flag is part of the key
+std::string ConfigSnapshot::makeKey(const std::string& statement, bool fullResult)
+{
+    return (fullResult ? "ALL " : "ONE ") + statement;
+}
+
+std::string ConfigSnapshot::getStatement(const std::string& key, bool& fullResult)
+{
+    fullResult = (key.compare(0, 4, "ALL ") == 0);
+    return key.substr(4);
+}
+
+ConfigSnapshotFile::Rows ConfigSnapshot::toRows(std::vector<ReaderItem>& result)
+{
+    ConfigSnapshotFile::Rows rows;
+    rows.reserve(result.size());
+
+    for (auto& item : result)
+    {
+        ConfigSnapshotFile::Row row;
+        for (unsigned long i = 0; i < item.getDataSize(); i++)
+        {
+            row.push_back(item.GetDataItem(i));
+        }
+        rows.push_back(std::move(row));
+    }
+
+    return rows;
+}
+
+void ConfigSnapshot::toResult(const ConfigSnapshotFile::Rows& rows, std::vector<ReaderItem>* result)
+{
+    result->clear();
+    result->reserve(rows.size());
+
+    for (const auto& row : rows)
+    {
+        ReaderItem item;
+        for (const auto& cell : row)
+        {
+            item.appendData(cell);
+        }
+        result->push_back(std::move(item));
+    }
+}
+
+bool ConfigSnapshot::FnLoad(int stationId)
+{
+    std::lock_guard<std::mutex> lock(snapshotMutex_);
+    auto startTime = std::chrono::steady_clock::now();
+    std::string error;
+    ConfigSnapshotFile file;
+
+    isReplaying_ = false;
+    if (!file.FnRead(getFilePath(), error))
+    {
+        Logger::getInstance()->FnLog("Config snapshot not used, " + error, logFileName_, "BOOT");
+        return false;
+    }
+
+    if (file.FnGetStationId() != static_cast<uint32_t>(stationId))
+    {
+        std::stringstream ss;
+        ss << "Config snapshot not used, it is for station " << file.FnGetStationId() << ", this lane is station " << stationId;
+        Logger::getInstance()->FnLog(ss.str(), logFileName_, "BOOT");
+        return false;
+    }
+
+    loaded_ = std::move(file);
+    recorded_.FnClear();
+    isReplaying_ = true;
+
+    std::stringstream ss;
+    ss << "Lane " << laneId_ << " config snapshot loaded, queries : " << loaded_.FnGetEntries().size();
+    ss << ", took " << std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count() << "us";
+    Logger::getInstance()->FnLog(ss.str(), logFileName_, "BOOT");
+    return true;
+}
+
+bool ConfigSnapshot::FnIsReplaying()
+{
+    std::lock_guard<std::mutex> lock(snapshotMutex_);
+    return isReplaying_;
+}
+
+void ConfigSnapshot::FnEndReplay()
+{
+    std::lock_guard<std::mutex> lock(snapshotMutex_);
+    isReplaying_ = false;
+}
+
+int ConfigSnapshot::FnSelect(odbc* database, const std::string& statement, std::vector<ReaderItem>* result, bool fullResult)
+{
+    std::string key = makeKey(statement, fullResult);
+
+    {
+        std::lock_guard<std::mutex> lock(snapshotMutex_);
+        const ConfigSnapshotFile::Rows* rows = isReplaying_ ? loaded_.FnGetRows(key) : nullptr;
+        if (rows != nullptr)
+        {
+            toResult(*rows, result);
+            return 0;
+        }
+    }
+
+    if (database == nullptr)
+    {
+        if (result)
+        {
+            result->clear();
+        }
+        return -1;
+    }
+
+    int r = database->SQLSelect(statement, result, fullResult);
+    if ((r == 0) && (result != nullptr))
+    {
+        std::lock_guard<std::mutex> lock(snapshotMutex_);
+        recorded_.FnSetRows(key, toRows(*result));
+    }
+
+    return r;
+}
+
+std::vector<std::string> ConfigSnapshot::FnRevalidate(odbc* database)
+{
+    std::vector<std::string> changed;
+    std::vector<std::string> keys;
+
+    {
+        std::lock_guard<std::mutex> lock(snapshotMutex_);
+        for (const auto& entry : loaded_.FnGetEntries())
+        {
+            keys.push_back(entry.first);
+        }
+    }
+
+    for (const auto& key : keys)
+    {
+        bool fullResult;
+        std::string statement = getStatement(key, fullResult);
+        std::vector<ReaderItem> result;
+
+        if ((database == nullptr) || (database->SQLSelect(statement, &result, fullResult) != 0))
+        {
+            // Not answered, the snapshot rows stay until the next boot asks again
+            Logger::getInstance()->FnLog("Config snapshot revalidation failed : " + statement, logFileName_, "BOOT");
+            continue;
+        }
+
+        ConfigSnapshotFile::Rows rows = toRows(result);
+        std::lock_guard<std::mutex> lock(snapshotMutex_);
+        const ConfigSnapshotFile::Rows* loadedRows = loaded_.FnGetRows(key);
+        if ((loadedRows == nullptr) || (*loadedRows != rows))
+        {
+            changed.push_back(statement);
+        }
+        recorded_.FnSetRows(key, rows);
+    }
+
+    return changed;
+}
+
+void ConfigSnapshot::FnReplayRevalidated()
+{
+    std::lock_guard<std::mutex> lock(snapshotMutex_);
+    for (const auto& entry : recorded_.FnGetEntries())
+    {
+        loaded_.FnSetRows(entry.first, entry.second);
+    }
+    isReplaying_ = true;
+}
+
+bool ConfigSnapshot::FnSave(int stationId)
+{
+    try
+    {
+        std::lock_guard<std::mutex> lock(snapshotMutex_);
+
+        // Queries the DB did not answer this boot keep their snapshot rows
+        for (const auto& entry : loaded_.FnGetEntries())
+        {
+            if (recorded_.FnGetRows(entry.first) == nullptr)
+            {
+                recorded_.FnSetRows(entry.first, entry.second);
+            }
+        }
+
+        if (recorded_.FnGetEntries().empty())
+        {
+            return false;
+        }
+
+        std::error_code ec;
+        std::filesystem::create_directories(SNAPSHOT_FILE_PATH, ec);
+        if (ec)
+        {
+            Logger::getInstance()->FnLog("Failed to create " + SNAPSHOT_FILE_PATH + " : " + ec.message(), logFileName_, "BOOT");
+            return false;
+        }
+
+        std::string error;
+        recorded_.FnSetStationId(static_cast<uint32_t>(stationId));
+        if (!recorded_.FnWrite(getFilePath(), error))
+        {
+            Logger::getInstance()->FnLog("Config snapshot not saved, " + error, logFileName_, "BOOT");
+            return false;
+        }
+
+        std::stringstream ss;
+        ss << "Lane " << laneId_ << " config snapshot saved, queries : " << recorded_.FnGetEntries().size();
+        Logger::getInstance()->FnLog(ss.str(), logFileName_, "BOOT");
+
+        loaded_ = recorded_;
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        std::stringstream ss;
+        ss << __func__ << ", Exception: " << e.what();
+        Logger::getInstance()->FnLogExceptionError(ss.str());
+        return false;
+    }
+    catch (...)
+    {
+        std::stringstream ss;
+        ss << __func__ << ", Exception: Unknown Exception";
+        Logger::getInstance()->FnLogExceptionError(ss.str());
+        return false;
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "config_snapshot_file.h"
+#include "lane_context.h"
+#include "lazy_instance.h"
+#include "odbc.h"
+
+// Warm boot for a lane's configuration. The rows of every configuration query the local DB answered are kept
+// in a snapshot file; at the next boot the loads replay them from the file instead of waiting for the DB, and
+// once the DB is up the same queries are run again so a changed table is picked up and the file rewritten.
+class ConfigSnapshot
+{
+public:
+    static const std::string SNAPSHOT_FILE_PATH;
+
+    static ConfigSnapshot* getInstance();
+
+    // Maps the lane's snapshot and starts replaying it, false when it is missing, corrupt or for another station
+    bool FnLoad(int stationId);
+    bool FnIsReplaying();
+    void FnEndReplay();
+
+    // SQLSelect for configuration tables: answered from the snapshot while replaying, otherwise from the DB
+    // with the rows recorded for the next snapshot. A statement the snapshot does not hold goes to the DB.
+    int FnSelect(odbc* database, const std::string& statement, std::vector<ReaderItem>* result, bool fullResult);
+
+    // Runs every snapshot statement against the DB, returns the ones whose rows changed
+    std::vector<std::string> FnRevalidate(odbc* database);
+    // Replays the rows FnRevalidate read, so a reload runs from memory rather than against the DB
+    void FnReplayRevalidated();
+
+    bool FnSave(int stationId);
+
+    /**
+     * Singleton ConfigSnapshot should not be cloneable.
+     */
+    ConfigSnapshot(ConfigSnapshot& configSnapshot) = delete;
+
+    /**
+     * Singleton ConfigSnapshot should not be assignable.
+     */
+    void operator=(const ConfigSnapshot&) = delete;
+
+private:
+    static std::array<std::atomic<ConfigSnapshot*>, LaneContext::MAX_LANES> configSnapshots_;
+    static std::mutex mutex_;
+    std::mutex snapshotMutex_;
+    std::string logFileName_;
+    int laneId_;
+    bool isReplaying_;
+    ConfigSnapshotFile loaded_;
+    ConfigSnapshotFile recorded_;
+    ConfigSnapshot();
+    std::string getFilePath() const;
+    static std::string makeKey(const std::string& statement, bool fullResult);
+    static std::string getStatement(const std::string& key, bool& fullResult);
+    static ConfigSnapshotFile::Rows toRows(std::vector<ReaderItem>& result);
+    static void toResult(const ConfigSnapshotFile::Rows& rows, std::vector<ReaderItem>* result);
+};
@@ -0,0 +1,386 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <set>
+#include "boost/crc.hpp"
+#include "config_snapshot_file.h"
+
+namespace
+{
+    const char SNAPSHOT_MAGIC[8] = { 'P', 'B', 'S', 'S', 'N', 'A', 'P', '1' };
+    const size_t HEADER_SIZE = sizeof(SNAPSHOT_MAGIC) + sizeof(uint32_t) * 2 + sizeof(int64_t) + sizeof(uint32_t) * 2 + sizeof(uint64_t);
+
+    template <typename T>
+    void appendValue(std::string& buffer, T value)
+    {
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void appendString(std::string& buffer, const std::string& value)
+    {
+        appendValue<uint32_t>(buffer, static_cast<uint32_t>(value.size()));
+        buffer.append(value);
+    }
+
+    // Bounds checked reads over the mapped file
+    class PayloadReader
+    {
+    public:
+        PayloadReader(const char* data, uint64_t size)
+            : data_(data), size_(size), offset_(0)
+        {
+        }
+
+        template <typename T>
+        bool readValue(T& value)
+        {
+            if ((size_ - offset_) < sizeof(T))
+            {
+                return false;
+            }
+            std::memcpy(&value, data_ + offset_, sizeof(T));
+            offset_ += sizeof(T);
+            return true;
+        }
+
+        bool readString(std::string& value)
+        {
+            uint32_t length;
+            if (!readValue(length) || ((size_ - offset_) < length))
+            {
+                return false;
+            }
+            value.assign(data_ + offset_, length);
+            offset_ += length;
+            return true;
+        }
+
+        bool isAtEnd() const
+        {
+            return (offset_ == size_);
+        }
+
+    private:
+        const char* data_;
+        uint64_t size_;
+        uint64_t offset_;
+    };
+
+    uint32_t checksum(const char* data, size_t size)
+    {
+        boost::crc_32_type crc;
+        crc.process_bytes(data, size);
+        return crc.checksum();
+    }
+
+    std::string joinRow(const ConfigSnapshotFile::Row& row)
+    {
+        std::string joined;
+        for (size_t i = 0; i < row.size(); i++)
+        {
+            if (i > 0)
+            {
+                joined += " | ";
+            }
+            joined += row[i];
+        }
+        return joined;
+    }
+}
+
+ConfigSnapshotFile::ConfigSnapshotFile()
+    : stationId_(0),
+    createdTime_(0)
+{
+}
+
+void ConfigSnapshotFile::FnSetStationId(uint32_t stationId)
+{
+    stationId_ = stationId;
+}
+
+uint32_t ConfigSnapshotFile::FnGetStationId() const
+{
+    return stationId_;
+}
+
+int64_t ConfigSnapshotFile::FnGetCreatedTime() const
+{
+    return createdTime_;
+}
+
+void ConfigSnapshotFile::FnSetRows(const std::string& query, const Rows& rows)
+{
+    entries_[query] = rows;
+}
+
+const ConfigSnapshotFile::Rows* ConfigSnapshotFile::FnGetRows(const std::string& query) const
+{
+    auto it = entries_.find(query);
+    return (it != entries_.end()) ? &it->second : nullptr;
+}
+
+const std::map<std::string, ConfigSnapshotFile::Rows>& ConfigSnapshotFile::FnGetEntries() const
+{
+    return entries_;
+}
+
+void ConfigSnapshotFile::FnClear()
+{
+    entries_.clear();
+    createdTime_ = 0;
+}
+
+std::string ConfigSnapshotFile::serializePayload() const
+{
+    std::string payload;
+
+    for (const auto& entry : entries_)
+    {
+        appendString(payload, entry.first);
+        appendValue<uint32_t>(payload, static_cast<uint32_t>(entry.second.size()));
+        for (const auto& row : entry.second)
+        {
+            appendValue<uint32_t>(payload, static_cast<uint32_t>(row.size()));
+            for (const auto& cell : row)
+            {
+                appendString(payload, cell);
+            }
+        }
+    }
+
+    return payload;
+}
+
+bool ConfigSnapshotFile::parsePayload(const char* data, uint64_t size, uint32_t entryCount)
+{
+    PayloadReader reader(data, size);
+    std::map<std::string, Rows> entries;
+
+    for (uint32_t i = 0; i < entryCount; i++)
+    {
+        std::string query;
+        uint32_t rowCount;
+        if (!reader.readString(query) || !reader.readValue(rowCount))
+        {
+            return false;
+        }
+
+        Rows rows;
+        for (uint32_t r = 0; r < rowCount; r++)
+        {
+            uint32_t cellCount;
+            if (!reader.readValue(cellCount))
+            {
+                return false;
+            }
+
+            Row row;
+            for (uint32_t c = 0; c < cellCount; c++)
+            {
+                std::string cell;
+                if (!reader.readString(cell))
+                {
+                    return false;
+                }
+                row.push_back(std::move(cell));
+            }
+            rows.push_back(std::move(row));
+        }
+        entries[query] = std::move(rows);
+    }
+
+    if (!reader.isAtEnd())
+    {
+        return false;
+    }
+
+    entries_ = std::move(entries);
+    return true;
+}
+
+bool ConfigSnapshotFile::FnRead(const std::string& path, std::string& error)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        error = "unable to open " + path;
+        return false;
+    }
+
+    struct stat fileStat;
+    if ((fstat(fd, &fileStat) != 0) || (static_cast<size_t>(fileStat.st_size) < HEADER_SIZE))
+    {
+        close(fd);
+        error = "too short for a header";
+        return false;
+    }
+
+    size_t fileSize = static_cast<size_t>(fileStat.st_size);
+    void* mapped = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        error = "unable to map " + path;
+        return false;
+    }
+
+    const char* data = static_cast<const char*>(mapped);
+    char magic[sizeof(SNAPSHOT_MAGIC)];
+    uint32_t formatVersion = 0;
+    uint32_t stationId = 0;
+    int64_t createdTime = 0;
+    uint32_t entryCount = 0;
+    uint32_t payloadChecksum = 0;
+    uint64_t payloadSize = 0;
+
+    std::memcpy(magic, data, sizeof(magic));
+    PayloadReader fields(data + sizeof(magic), HEADER_SIZE - sizeof(magic));
+    fields.readValue(formatVersion);
+    fields.readValue(stationId);
+    fields.readValue(createdTime);
+    fields.readValue(entryCount);
+    fields.readValue(payloadChecksum);
+    fields.readValue(payloadSize);
+
+    bool isValid = false;
+    if (std::memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) != 0)
+    {
+        error = "not a snapshot file";
+    }
+    else if (formatVersion != FORMAT_VERSION)
+    {
+        error = "format version " + std::to_string(formatVersion) + ", expected " + std::to_string(FORMAT_VERSION);
+    }
+    else if (payloadSize != (fileSize - HEADER_SIZE))
+    {
+        error = "payload size does not match the file size";
+    }
+    else if (checksum(data + HEADER_SIZE, payloadSize) != payloadChecksum)
+    {
+        error = "checksum mismatch";
+    }
+    else if (!parsePayload(data + HEADER_SIZE, payloadSize, entryCount))
+    {
+        error = "payload is malformed";
+    }
+    else
+    {
+        stationId_ = stationId;
+        createdTime_ = createdTime;
+        isValid = true;
+    }
+
+    munmap(mapped, fileSize);
+    return isValid;
+}
+
+bool ConfigSnapshotFile::FnWrite(const std::string& path, std::string& error)
+{
+    std::string payload = serializePayload();
+    createdTime_ = static_cast<int64_t>(std::time(nullptr));
+
+    std::string header(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    appendValue<uint32_t>(header, FORMAT_VERSION);
+    appendValue<uint32_t>(header, stationId_);
+    appendValue<int64_t>(header, createdTime_);
+    appendValue<uint32_t>(header, static_cast<uint32_t>(entries_.size()));
+    appendValue<uint32_t>(header, checksum(payload.data(), payload.size()));
+    appendValue<uint64_t>(header, static_cast<uint64_t>(payload.size()));
+
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            error = "unable to create " + tempPath;
+            return false;
+        }
+        file.write(header.data(), header.size());
+        file.write(payload.data(), payload.size());
+        file.flush();
+        if (!file)
+        {
+            error = "unable to write " + tempPath;
+            return false;
+        }
+    }
+
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0)
+    {
+        error = "unable to rename " + tempPath;
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+std::vector<std::string> ConfigSnapshotFile::FnDiff(const ConfigSnapshotFile& older, const ConfigSnapshotFile& newer)
+{
+    std::vector<std::string> differences;
+
+    for (const auto& entry : older.entries_)
+    {
+        if (newer.FnGetRows(entry.first) == nullptr)
+        {
+            differences.push_back("- query: " + entry.first);
+        }
+    }
+
+    for (const auto& entry : newer.entries_)
+    {
+        const Rows* olderRows = older.FnGetRows(entry.first);
+        if (olderRows == nullptr)
+        {
+            differences.push_back("+ query: " + entry.first + " (" + std::to_string(entry.second.size()) + " rows)");
+            continue;
+        }
+
+        if (*olderRows == entry.second)
+        {
+            continue;
+        }
+
+        // Rows compare as a multiset, the order a table returns them in is not a change
+        std::multiset<std::string> olderSet;
+        std::multiset<std::string> newerSet;
+        for (const auto& row : *olderRows)
+        {
+            olderSet.insert(joinRow(row));
+        }
+        for (const auto& row : entry.second)
+        {
+            newerSet.insert(joinRow(row));
+        }
+
+        std::vector<std::string> rowDifferences;
+        for (const auto& row : olderSet)
+        {
+            if (olderSet.count(row) > newerSet.count(row))
+            {
+                rowDifferences.push_back("  - " + row);
+            }
+        }
+        for (const auto& row : newerSet)
+        {
+            if (newerSet.count(row) > olderSet.count(row))
+            {
+                rowDifferences.push_back("  + " + row);
+            }
+        }
+
+        if (!rowDifferences.empty())
+        {
+            differences.push_back("~ query: " + entry.first);
+            differences.insert(differences.end(), rowDifferences.begin(), rowDifferences.end());
+        }
+    }
+
+    return differences;
+}
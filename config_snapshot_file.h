@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// On-disk form of a lane's configuration snapshot: the rows every configuration query returned, keyed by the
+// query. Layout, host byte order since the file never leaves the controller:
+//   header  : magic "PBSSNAP1", format version, station id, created (unix time), entry count, payload size, CRC-32 of payload
+//   payload : per entry the query, the row count, and per row the cell count and the cells, every string length prefixed
+// Kept free of the DB and logger so the dump/diff tool can link it alone.
+class ConfigSnapshotFile
+{
+public:
+    static const uint32_t FORMAT_VERSION = 1;
+    using Row = std::vector<std::string>;
+    using Rows = std::vector<Row>;
+
+    ConfigSnapshotFile();
+
+    void FnSetStationId(uint32_t stationId);
+    uint32_t FnGetStationId() const;
+    int64_t FnGetCreatedTime() const;
+
+    void FnSetRows(const std::string& query, const Rows& rows);
+    // Returns nullptr when the query is not in the snapshot
+    const Rows* FnGetRows(const std::string& query) const;
+    const std::map<std::string, Rows>& FnGetEntries() const;
+    void FnClear();
+
+    // Maps the file and rejects it unless magic, version, sizes and checksum all match, error says why
+    bool FnRead(const std::string& path, std::string& error);
+
+    // Writes a temporary file and renames it over path, a crash never leaves half a snapshot behind
+    bool FnWrite(const std::string& path, std::string& error);
+
+    // Human readable differences from older to newer, empty when both hold the same rows
+    static std::vector<std::string> FnDiff(const ConfigSnapshotFile& older, const ConfigSnapshotFile& newer);
+
+private:
+    uint32_t stationId_;
+    int64_t createdTime_;
+    std::map<std::string, Rows> entries_;
+    std::string serializePayload() const;
+    bool parsePayload(const char* data, uint64_t size, uint32_t entryCount);
+};
@@ -9,29 +9,36 @@
 #include "db.h"
 #include "log.h"
 #include "operation.h"
+#include "param_table.h"
 #include "common.h"
+#include "config_snapshot.h"
+#include "ini_parser.h"
+#include "lane_context.h"
+#include "paid_exit_cache.h"
 
-db* db::db_ = nullptr;
+std::atomic<db*> db::db_(nullptr);
 std::mutex db::mutex_;
 
 db::db()
+	: centraldb(nullptr),
+	localdb(nullptr),
+	tariffSnapshot_(std::make_shared<const TariffSnapshot>())
 {
 	m_remote_db_err_flag.store(0);
 }
 
 db* db::getInstance()
 {
-	std::lock_guard<std::mutex> lock(mutex_);
-    if (db_ == nullptr)
-    {
-        db_ = new db();
-    }
-    return db_;
+    return LazyInstance::FnGet(db_, mutex_, []() { return new db(); });
 }
 
 
-int db::connectcentraldb(string connectStr,string connectIP,int CentralSQLTimeOut, int SP_SQLTimeOut,float mPingTimeOut)
+void db::FnSetupCentralDB(string connectStr,string connectIP,int CentralSQLTimeOut, int SP_SQLTimeOut,float mPingTimeOut)
 {
+	if (centraldb != nullptr)
+	{
+		return;
+	}
 
 	CentralConnStr=connectStr;
 	
@@ -54,6 +61,95 @@ int db::connectcentraldb(string connectStr,string connectIP,int CentralSQLTimeOu
 	initialFlag=false;
 	//---------------------------------
 	centraldb=new odbc(SP_TimeOut,1,mPingTimeOut,central_IP,CentralConnStr);
+
+	// Every central call goes through it, so an outage costs the timeouts of a few calls, not of every car
+	CircuitBreaker::Settings settings;
+	settings.failureThreshold = IniParser::getInstance()->FnGetDBBreakerFailures();
+	settings.slowCall = std::chrono::milliseconds(IniParser::getInstance()->FnGetDBBreakerSlowMs());
+	settings.openTime = std::chrono::seconds(IniParser::getInstance()->FnGetDBBreakerOpenSec());
+	settings.trialCalls = IniParser::getInstance()->FnGetDBBreakerTrialCalls();
+	centralBreaker_ = std::make_shared<CircuitBreaker>("central", settings);
+	centralBreaker_->FnSetListener([this](CircuitBreaker::State from, CircuitBreaker::State to, const std::string& reason)
+	{
+		onCentralBreakerChange(from, to, reason);
+	});
+	centraldb->FnSetCircuitBreaker(centralBreaker_);
+}
+
+void db::onCentralBreakerChange(CircuitBreaker::State from, CircuitBreaker::State to, const std::string& reason)
+{
+	std::stringstream dbss;
+	dbss << "Central DB circuit " << CircuitBreaker::FnGetStateName(from) << " -> " << CircuitBreaker::FnGetStateName(to) << ", " << reason;
+	Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+
+	if (to == CircuitBreaker::State::Open)
+	{
+		m_remote_db_err_flag.store(1);
+	}
+	else if (to == CircuitBreaker::State::Closed)
+	{
+		m_remote_db_err_flag.store(0);
+	}
+
+	// The central DB is shared, every lane's station reports it to the monitor
+	std::string data = std::string("central,") + CircuitBreaker::FnGetStateName(to) + "," + reason;
+	for (int laneId = 0; laneId < LaneContext::FnGetLaneCount(); laneId++)
+	{
+		LaneContext::Scope laneScope(laneId, false);
+		operation::getInstance()->SendMsg2Monitor("319", data);
+	}
+}
+
+void db::FnRecordCentralDBProbe(bool isReachable)
+{
+	if (centralBreaker_ != nullptr)
+	{
+		centralBreaker_->FnRecordProbe(isReachable);
+	}
+}
+
+void db::FnLogCentralDBStats()
+{
+	if (centralBreaker_ == nullptr)
+	{
+		return;
+	}
+
+	CircuitBreaker::Stats stats = centralBreaker_->FnGetStats();
+	std::stringstream dbss;
+	dbss << "Central DB circuit " << CircuitBreaker::FnGetStateName(centralBreaker_->FnGetState());
+	dbss << ", calls: " << stats.calls << ", failed: " << stats.failures << ", slow: " << stats.slowCalls;
+	dbss << ", short circuited: " << stats.shortCircuited << ", opened: " << stats.opened;
+	Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+}
+
+void db::FnLogTableSyncStats()
+{
+	replicator_.FnLogStats();
+}
+
+int db::syncTable(const TableReplicator::Spec& spec, TableReplicator::Result* result)
+{
+	TableReplicator::Result syncResult = replicator_.FnSync(spec, centraldb, localdb);
+	m_remote_db_err_flag.store(syncResult.isCentralError ? 1 : 0);
+	m_local_db_err_flag = syncResult.isLocalError ? 1 : 0;
+
+	if (result != nullptr)
+	{
+		*result = syncResult;
+	}
+
+	if (syncResult.isCentralError || syncResult.isLocalError)
+	{
+		return -1;
+	}
+	return syncResult.applied;
+}
+
+int db::connectcentraldb(string connectStr,string connectIP,int CentralSQLTimeOut, int SP_SQLTimeOut,float mPingTimeOut)
+{
+	// Retries reuse the connection, readers may already hold it
+	FnSetupCentralDB(connectStr,connectIP,CentralSQLTimeOut,SP_SQLTimeOut,mPingTimeOut);
    
     std::stringstream dbss;
 	if (centraldb->Connect()==0) {
@@ -71,10 +167,13 @@ int db::connectcentraldb(string connectStr,string connectIP,int CentralSQLTimeOu
 	}
 }
 
-int db::connectlocaldb(string connectstr,int LocalSQLTimeOut,int SP_SQLTimeOut,float mPingTimeOut)
+void db::FnSetupLocalDB(string connectstr,int LocalSQLTimeOut,int SP_SQLTimeOut,float mPingTimeOut)
 {
+	if (localdb != nullptr)
+	{
+		return;
+	}
 
-	std::stringstream dbss;
 	localConnStr=connectstr;
 	LocalDB_TimeOut=LocalSQLTimeOut;
 	SP_TimeOut=SP_SQLTimeOut;
@@ -92,6 +191,13 @@ int db::connectlocaldb(string connectstr,int LocalSQLTimeOut,int SP_SQLTimeOut,f
 	initialFlag=false;
 	//---------------------------------
 	localdb=new odbc(LocalDB_TimeOut,1,PingTimeOut,"127.0.0.1",localConnStr);
+}
+
+int db::connectlocaldb(string connectstr,int LocalSQLTimeOut,int SP_SQLTimeOut,float mPingTimeOut)
+{
+
+	std::stringstream dbss;
+	FnSetupLocalDB(connectstr,LocalSQLTimeOut,SP_SQLTimeOut,mPingTimeOut);
 
 	if (localdb->Connect()==0) {
 		dbss << "Local DB is connected!" ;
@@ -144,7 +250,7 @@ std::string &dtValidFrom)
 
 }
 
-int db::local_isvalidseason(string L_sSeasonNo,unsigned int iZoneID)
+int db::local_isvalidseason(string L_sSeasonNo,unsigned int iZoneID, SeasonInfo& season)
 {
 	std::string sqlStmt;
 	std::string tbName="season_mst";
@@ -168,13 +274,15 @@ int db::local_isvalidseason(string L_sSeasonNo,unsigned int iZoneID)
 		if (r!=0) return iLocalFail;
 
 		if (selResult.size()>0){
-				operation::getInstance()->tSeason.SeasonType =selResult[0].GetDataItem(0);
-				operation::getInstance()->tSeason.s_status=selResult[0].GetDataItem(1);
-				operation::getInstance()->tSeason.date_from=selResult[0].GetDataItem(2);
-				operation::getInstance()->tSeason.date_to=selResult[0].GetDataItem(3);
-				operation::getInstance()->tSeason.rate_type=selResult[0].GetDataItem(5);
-				operation::getInstance()->tSeason.redeem_amt=selResult[0].GetDataItem(8);
-				operation::getInstance()->tSeason.redeem_time=selResult[0].GetDataItem(9);
+				season.sSeasonType=selResult[0].GetDataItem(0);
+				season.sStatus=selResult[0].GetDataItem(1);
+				season.sDateFrom=selResult[0].GetDataItem(2);
+				season.sDateTo=selResult[0].GetDataItem(3);
+				season.sRateType=selResult[0].GetDataItem(5);
+				season.sRedeemAmt=selResult[0].GetDataItem(8);
+				season.sRedeemTime=selResult[0].GetDataItem(9);
+				season.hasStatus = true;
+				season.hasRecord = true;
 			return iDBSuccess;
 		}
 		else
@@ -189,7 +297,7 @@ int db::local_isvalidseason(string L_sSeasonNo,unsigned int iZoneID)
 
 }
 
-int db::isvalidseason(string m_sSeasonNo,BYTE iInOut, unsigned int iZoneID)
+int db::isvalidseason(string m_sSeasonNo,BYTE iInOut, unsigned int iZoneID, SeasonInfo& season, bool* isFromLocal)
 {
 	string sSerialNo="";
 	float sFee=0;
@@ -199,6 +307,7 @@ int db::isvalidseason(string m_sSeasonNo,BYTE iInOut, unsigned int iZoneID)
 	std::string  m_dtValidTo="", m_dtValidFrom="";
 	
 	std::string  m_AllowedHolderType="";
+	if (isFromLocal != nullptr) *isFromLocal = false;
 
 	const std::string m_sBlank="";
 	int retcode;
@@ -229,16 +338,18 @@ int db::isvalidseason(string m_sSeasonNo,BYTE iInOut, unsigned int iZoneID)
 			dbss << "ValidTo = " << m_dtValidTo;
     		Logger::getInstance()->FnLog(dbss.str(), "", "DB");
 			//----
-			operation::getInstance()->tSeason.date_from=m_dtValidFrom;
-			operation::getInstance()->tSeason.date_to=m_dtValidTo;
-			operation::getInstance()->tSeason.rate_type=std::to_string(iRateType);
-			operation::getInstance()->tSeason.redeem_amt=std::to_string(m_sRedeemAmt);
-			operation::getInstance()->tSeason.redeem_time=std::to_string(m_iRedeemTime);
+			season.sDateFrom=m_dtValidFrom;
+			season.sDateTo=m_dtValidTo;
+			season.sRateType=std::to_string(iRateType);
+			season.sRedeemAmt=std::to_string(m_sRedeemAmt);
+			season.sRedeemTime=std::to_string(m_iRedeemTime);
+			season.hasRecord = true;
 		}
 	}
 	else
 	{
-		int l_ret=local_isvalidseason(m_sSeasonNo,iZoneID);
+		if (isFromLocal != nullptr) *isFromLocal = true;
+		int l_ret=local_isvalidseason(m_sSeasonNo,iZoneID,season);
 		if(l_ret==iDBSuccess) retcode = 1;
 		else 
 		retcode = 8;
@@ -547,143 +658,110 @@ void db::synccentraltime()
 
 int db::downloadseason()
 {
-	int ret = -1;
-	unsigned long j,k;
-	vector<ReaderItem> tResult;
-	vector<ReaderItem> selResult;
-	tseason_struct v;
-	int r = 0;
-	string seasonno;
-	std::string sqlStmt;
-	int w = -1;
-	std::stringstream dbss;
-	int giStnid;
-	giStnid = operation::getInstance()->gtStation.iSID;
+	std::string sStnid = to_string(operation::getInstance()->gtStation.iSID);
+
+	TableReplicator::Spec spec;
+	spec.name = "season";
+	spec.centralTable = "season_mst";
+	spec.centralSelect = "*";
+	spec.localTable = "season_mst";
+	spec.columns = {
+		{ "season_no", 1, true }, { "season_type", 2, false }, { "s_status", 3, false },
+		{ "date_from", 4, false }, { "date_to", 5, false }, { "vehicle_no", 8, false },
+		{ "rate_type", 58, false }, { "pay_to", 66, false }, { "pay_date", 67, false },
+		{ "multi_season_no", 72, false }, { "zone_id", 77, false }, { "redeem_time", 78, false },
+		{ "redeem_amt", 79, false }, { "holder_type", 6, false }, { "sub_zone_id", 80, false }
+	};
+	spec.fetchedFlag = "s" + sStnid + "_fetched";
+	spec.centralKeys = { "season_no" };
+	spec.batchRows = 500;
+	spec.isDeletingMissing = false;
+
+	int ret = syncTable(spec);
+	if (ret >= 0)
+	{
+		season_update_count += ret;
+		season_update_flag = 0;
+	}
 
-	sqlStmt = "SELECT SUM(A) FROM (";
-	sqlStmt = sqlStmt + "SELECT count(season_no) as A FROM season_mst WHERE s" + to_string(giStnid) + "_fetched = 0 ";
-	sqlStmt = sqlStmt + ") as B ";
+	return ret;
+}
 
-	r = centraldb->SQLSelect(sqlStmt, &tResult, false);
-	if(r != 0)
-	{
-		m_remote_db_err_flag.store(1);
-		return ret;
-	}
-	else 
-	{
-		if (std::stoi(tResult[0].GetDataItem(0)) == 0)
-		{
-			return ret;
-		}
-		m_remote_db_err_flag.store(0);
-		dbss << "Total: " << std::string (tResult[0].GetDataItem(0)) << " Seasons to be download.";
-    	Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-	}
-	
-	r = centraldb->SQLSelect("SELECT TOP 10 * FROM season_mst WHERE s" + to_string(giStnid) + "_fetched = 0 ", &selResult, true);
-	if(r != 0)
-	{
-		m_remote_db_err_flag.store(1);
-		return ret;
-	}
-	else
-	{
-		m_remote_db_err_flag.store(0);
-	}
+int db::downloadvehicletype()
+{
+	TableReplicator::Spec spec;
+	spec.name = "vehicle type";
+	spec.centralTable = "Vehicle_type";
+	spec.centralSelect = "*";
+	spec.localTable = "Vehicle_type";
+	spec.columns = { { "IUCode", 1, true }, { "TransType", 2, false } };
+	spec.batchRows = 0;
+	spec.isDeletingMissing = false;
+
+	return syncTable(spec);
+}
 
-	int downloadCount = 0;
-	if (selResult.size() > 0)
-	{
-		//--------------------------------------------------------
-		dbss.str("");  // Set the underlying string to an empty string
-    	dbss.clear();   // Clear the state of the stream
-		dbss << "Downloading " << std::to_string (selResult.size()) << " Records: Started";
-    	Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+int db::downloadledmessage()
+{
+	TableReplicator::Spec spec;
+	spec.name = "LED message";
+	spec.centralTable = "message_mst";
+	spec.centralSelect = "*";
+	spec.localTable = "message_mst";
+	spec.columns = { { "msg_id", 0, true }, { "msg_body", 2, false }, { "m_status", 3, false } };
+	spec.fetchedFlag = "s" + to_string(operation::getInstance()->gtStation.iSID) + "_fetched";
+	spec.centralKeys = { "msg_id" };
+	spec.batchRows = 0;
+	spec.isDeletingMissing = false;
+
+	return syncTable(spec);
+}
 
-		for(j = 0; j < selResult.size(); j++)
-		{
-			v.season_no = selResult[j].GetDataItem(1);
-			v.SeasonType = selResult[j].GetDataItem(2);  
-			seasonno = v.season_no;          
-			v.s_status = selResult[j].GetDataItem(3);   
-			v.date_from = selResult[j].GetDataItem(4);     
-			v.date_to = selResult[j].GetDataItem(5);    
-			v.vehicle_no = selResult[j].GetDataItem(8);
-			v.rate_type = selResult[j].GetDataItem(58);
-			v.pay_to = selResult[j].GetDataItem(66);
-			v.pay_date = selResult[j].GetDataItem(67);
-			v.multi_season_no=selResult[j].GetDataItem(72);
-			v.zone_id = selResult[j].GetDataItem(77);
-			v.redeem_time = selResult[j].GetDataItem(78);
-			v.redeem_amt = selResult[j].GetDataItem(79);
-			v.holder_type = selResult[j].GetDataItem(6);
-			v.sub_zone_id = selResult[j].GetDataItem(80);
-
-			season_update_count++;
-
-			w = writeseason2local(v);
-			
-			if (w == 0) 
-			{
-				dbss.str("");  // Set the underlying string to an empty string
-    			dbss.clear();   // Clear the state of the stream
-				dbss << "Download season: " << seasonno;
-				Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+int db::downloadparameter()
+{
+	int giStnid = operation::getInstance()->gtStation.iSID;
 
-				//update to central DB
-				r = centraldb->SQLExecutNoneQuery("UPDATE season_mst SET s" + to_string(giStnid) + "_fetched = '1' WHERE season_no = '" + seasonno + "'");
-				dbss.str("");  // Set the underlying string to an empty string
-    			dbss.clear();   // Clear the state of the stream
-				if (r != 0) 
-				{
-					m_remote_db_err_flag.store(2);
-					dbss.str("");  // Set the underlying string to an empty string
-    				dbss.clear();   // Clear the state of the stream
-					dbss << "update central season status failed.";
-					Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-				}
-				else 
-				{
-					downloadCount++;
-					m_remote_db_err_flag.store(0);
-					//dbss << "set central season success.";
-					//Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-				}
-			}
-			//---------------------------------------
-		}
-		dbss.str("");  // Set the underlying string to an empty string
-    	dbss.clear();   // Clear the state of the stream
-		dbss << "Downloading Records: End, Total Record :" << selResult.size() << " ,Downloaded Record :" << downloadCount;
-    	Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-	}
+	// Each station's value has a column of its own
+	TableReplicator::Spec spec;
+	spec.name = "parameter";
+	spec.centralTable = "parameter_mst";
+	spec.centralSelect = "*";
+	spec.centralFilter = "for_station=1";
+	spec.localTable = "Param_mst";
+	spec.columns = { { "ParamName", 0, true }, { "ParamValue", 49 + giStnid, false } };
+	spec.fetchedFlag = "s" + to_string(giStnid) + "_fetched";
+	spec.centralKeys = { "name" };
+	spec.batchRows = 0;
+	spec.isDeletingMissing = false;
 
-	if (selResult.size() < 10)
+	int ret = syncTable(spec);
+	if (ret >= 0)
 	{
-		season_update_flag = 0;
+		param_update_count += ret;
+	}
+	if (ret <= 0)
+	{
+		param_update_flag = 0;
 	}
-
-	ret = downloadCount;
 
 	return ret;
 }
 
-int db::writeseason2local(tseason_struct& v)
+
+int db::writeparameter2local(string name,string value)
 {
-	int r=-1;// success flag
-	int debug=0;
+	int r = -1;// success flag
 	std::string sqlStmt;
 	vector<ReaderItem> selResult;
 	std::stringstream dbss;
 	
 	try 
 	{
-		r = localdb->SQLSelect("SELECT season_type FROM season_mst Where season_no= '" + v.season_no + "'", &selResult, false);
+		r = localdb->SQLSelect("SELECT ParamName FROM Param_mst Where ParamName= '" + name + "'", &selResult, false);
 		if (r != 0)
 		{
-			m_local_db_err_flag=1;
-			operation::getInstance()->writelog("update season failed.", "DB");
+			m_local_db_err_flag = 1;
+			operation::getInstance()->writelog("update parameter fail.", "DB");
 			return r;
 		}
 		else
@@ -693,61 +771,35 @@ int db::writeseason2local(tseason_struct& v)
 
 		if (selResult.size() > 0)
 		{
-			v.found = 1;
-
-			//update season records
-			sqlStmt="Update season_mst SET ";
-			sqlStmt= sqlStmt+ "season_no='" + v.season_no + "',";
-			sqlStmt= sqlStmt+ "season_type='" + v.SeasonType + "',";
-			sqlStmt= sqlStmt+ "s_status='" + v.s_status  + "',";
-			sqlStmt= sqlStmt+ "date_from='" + v.date_from + "',";
-			sqlStmt= sqlStmt+ "date_to='" + v.date_to  + "',";
-			sqlStmt= sqlStmt+ "vehicle_no='" + v.vehicle_no  + "',";
-			sqlStmt= sqlStmt+ "rate_type='" + v.rate_type  + "',";
-			sqlStmt= sqlStmt+ "pay_to='" + v.pay_to  + "',";
-			sqlStmt= sqlStmt+ "pay_date='" + v.pay_date  + "',";
-			sqlStmt= sqlStmt+ "multi_Season_no='" + v.multi_season_no  + "',";
-			sqlStmt= sqlStmt+ "zone_id='" + v.zone_id + "',";
-			sqlStmt= sqlStmt+ "redeem_amt='" + v.redeem_amt + "',";
-			sqlStmt= sqlStmt+ " redeem_time='" + v.redeem_time + "',";
-			sqlStmt= sqlStmt+ " holder_type='" + v.holder_type + "',";
-			sqlStmt= sqlStmt+ " sub_zone_id='" + v.sub_zone_id + "'";
-			sqlStmt= sqlStmt+ " WHERE season_no='" +v.season_no + "'";
+
+			//update param records
+			sqlStmt = "Update Param_mst SET ";
+			sqlStmt = sqlStmt + "ParamValue='" + value + "'";
+			sqlStmt = sqlStmt + " Where ParamName= '" + name + "'";
 			
-			r = localdb->SQLExecutNoneQuery (sqlStmt);
+			r = localdb->SQLExecutNoneQuery(sqlStmt);
 
 			if (r != 0)  
 			{
 				m_local_db_err_flag = 1;
-				operation::getInstance()->writelog("update season failed.", "DB");
+				dbss.str("");  // Set the underlying string to an empty string
+				dbss.clear();   // Clear the state of the stream
+				dbss << "update parameter to local failed";
+				Logger::getInstance()->FnLog(dbss.str(), "", "DB");
 			}
 			else  
 			{
 				m_local_db_err_flag = 0;
+			//	printf("update Param success \n");
 			}
+			
 		}
 		else
 		{
-			v.found = 0;
-			//insert season records
-			sqlStmt ="INSERT INTO season_mst ";
-			sqlStmt = sqlStmt + " (season_no,season_type,s_status,date_from,date_to,vehicle_no,rate_type, ";
-			sqlStmt = sqlStmt + " pay_to,pay_date,multi_season_no,zone_id,redeem_amt,redeem_time,holder_type,sub_zone_id)";
-			sqlStmt = sqlStmt + " VALUES ('" + v.season_no+ "'";
-			sqlStmt = sqlStmt + ",'" + v.SeasonType  + "'";
-			sqlStmt = sqlStmt + ",'" + v.s_status + "'";
-			sqlStmt = sqlStmt + ",'" + v.date_from   + "'";
-			sqlStmt = sqlStmt + ",'" + v.date_to  + "'";
-			sqlStmt = sqlStmt + ",'" + v.vehicle_no   + "'";
-			sqlStmt = sqlStmt + ",'" + v.rate_type    + "'";
-			sqlStmt = sqlStmt + ",'" + v.pay_to + "'";
-			sqlStmt = sqlStmt + ",'" + v.pay_date    + "'";
-			sqlStmt = sqlStmt + ",'" + v.multi_season_no   + "'";
-			sqlStmt = sqlStmt + ",'" + v.zone_id   + "'";
-			sqlStmt = sqlStmt + ",'" + v.redeem_amt   + "'";
-			sqlStmt = sqlStmt + ",'" + v.redeem_time   + "'";
-			sqlStmt = sqlStmt + ",'" + v.holder_type   + "'";
-			sqlStmt = sqlStmt + ",'" + v.sub_zone_id  + "') ";
+			sqlStmt = "INSERT INTO Param_mst";
+			sqlStmt = sqlStmt + " (ParamName,ParamValue) ";
+			sqlStmt = sqlStmt + " VALUES ('" + name + "'";
+			sqlStmt = sqlStmt + ",'" + value  + "')";
 
 			r = localdb->SQLExecutNoneQuery(sqlStmt);
 
@@ -755,61 +807,57 @@ int db::writeseason2local(tseason_struct& v)
 			{
 				m_local_db_err_flag = 1;
 				dbss.str("");  // Set the underlying string to an empty string
-    			dbss.clear();   // Clear the state of the stream
-				//dbss << "Insert season to local failed. ";
-				dbss << sqlStmt;
+				dbss.clear();   // Clear the state of the stream
+				dbss << "insert parameter to local failed";
 				Logger::getInstance()->FnLog(dbss.str(), "", "DB");
 			}
 			else  
 			{
 				m_local_db_err_flag = 0;
-				dbss.str("");  // Set the underlying string to an empty string
-    			dbss.clear();   // Clear the state of the stream
-				dbss << "Insert season to local success. ";
-				Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+				//printf("set Param success \n");
 			}
 		}
+
 	}
 	catch (const std::exception &e)
 	{
 		r = -1;// success flag
+		// cout << "ERROR: " << err << endl;
 		dbss.str("");  // Set the underlying string to an empty string
-    	dbss.clear();   // Clear the state of the stream
+		dbss.clear();   // Clear the state of the stream
 		dbss << "DB: local db error in writing rec: " << std::string(e.what());
-    	Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+		Logger::getInstance()->FnLog(dbss.str(), "", "DB");
 		m_local_db_err_flag = 1;
 	}
 
 	return r;
 }
 
-int db::downloadvehicletype()
+int db::downloadstationsetup()
 {
 	int ret = -1;
-	unsigned long j;
+	tstation_struct v;
 	vector<ReaderItem> tResult;
 	vector<ReaderItem> selResult;
-	int r=0;
-	string iu_code;
-	string iu_type;
 	std::string sqlStmt;
-	int w = -1;
 	std::stringstream dbss;
-
+	int r = -1;
+	int w = -1;
+	
 	//write log for total seasons
 
 	sqlStmt = "SELECT SUM(A) FROM (";
-	sqlStmt = sqlStmt + "SELECT count(IUCode) as A FROM Vehicle_type";
+	sqlStmt = sqlStmt + "SELECT count(station_id) as A FROM station_setup";
 	sqlStmt = sqlStmt + ") as B ";
 
 	//dbss << sqlStmt;
     //Logger::getInstance()->FnLog(dbss.str(), "", "DB");
 
-	r = centraldb->SQLSelect(sqlStmt,&tResult,false);
+	r = centraldb->SQLSelect(sqlStmt, &tResult, false);
 	if (r != 0)
 	{
 		m_remote_db_err_flag.store(1);
-		operation::getInstance()->writelog("download vehicle type fail.", "DB");
+		operation::getInstance()->writelog("download station setup fail.", "DB");
 		return ret;
 	}
 	else 
@@ -817,14 +865,16 @@ int db::downloadvehicletype()
 		m_remote_db_err_flag.store(0);
 		dbss.str("");  // Set the underlying string to an empty string
     	dbss.clear();   // Clear the state of the stream
-		dbss << "Total " << std::string (tResult[0].GetDataItem(0)) << " vehicle type to be download.";
+		dbss << "Total " << std::string (tResult[0].GetDataItem(0)) << " station setup to be download.";
     	Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+		
 	}
 
-	r = centraldb->SQLSelect("SELECT  * FROM Vehicle_type", &selResult, true);
+	r = centraldb->SQLSelect("SELECT  * FROM station_setup",&selResult,true);
 	if (r != 0)
 	{
 		m_remote_db_err_flag.store(1);
+		operation::getInstance()->writelog("download station setup fail.", "DB");
 		return ret;
 	}
 	else
@@ -835,34 +885,64 @@ int db::downloadvehicletype()
 	int downloadCount = 0;
 	if (selResult.size() > 0)
 	{
-		//--------------------------------------------------------
-		dbss.str("");  // Set the underlying string to an empty string
-    	dbss.clear();   // Clear the state of the stream
-		dbss << "Downloading " << std::to_string (selResult.size()) << " Records: Started";
-    	Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-		
-
-		for(j = 0; j < selResult.size(); j++){
-			// std::cout<<"Rec "<<j<<std::endl;
-			// for (k=0;k<selResult[j].getDataSize();k++){
-			//     std::cout<<"item["<<k<< "]= " << selResult[j].GetDataItem(k)<<std::endl;                
-			// }  
-			iu_code = selResult[j].GetDataItem(1);
-			iu_type = selResult[j].GetDataItem(2); 
+		for(int j = 0; j < selResult.size(); j++)
+		{
+			v.iGroupID = std::stoi(selResult[j].GetDataItem(0));
+			v.iSID = std::stoi(selResult[j].GetDataItem(2));
+			v.sName = selResult[j].GetDataItem(3);
 
-			w = writevehicletype2local(iu_code, iu_type);
-			if (w == 0)
+			switch(std::stoi(selResult[j].GetDataItem(5)))
+			{
+			case 1:
+				v.iType = tientry;
+				break;
+			case 2:
+				v.iType = tiExit;
+				break;
+			default:
+				break;
+			};
+			v.iStatus = std::stoi(selResult[j].GetDataItem(6));
+			v.sPCName = selResult[j].GetDataItem(4);
+			v.iCHUPort = std::stoi(selResult[j].GetDataItem(17));
+			v.iAntID = std::stoi(selResult[j].GetDataItem(18));
+			v.iZoneID = std::stoi(selResult[j].GetDataItem(19));
+			v.iIsVirtual = std::stoi(selResult[j].GetDataItem(20));
+			switch(std::stoi(selResult[j].GetDataItem(22)))
+			{
+			case 0:
+				v.iSubType = iNormal;
+				break;
+			case 1:
+				v.iSubType = iXwithVENoPay;
+				break;
+			case 2:
+				v.iSubType = iXwithVEPay;
+				break;
+			default:
+				break;
+			};
+			v.iVirtualID = std::stoi(selResult[j].GetDataItem(21));
+			
+			w = writestationsetup2local(v);
+			
+			if (w == 0) 
 			{
 				downloadCount++;
+			//	printf("set station setup ok \n");
 			}
-			//---------------------------------------
-			
+			//operation::getInstance()->initStnParameters();
 		}
-		//operation::getInstance()->initStnParameters();
+
 		dbss.str("");  // Set the underlying string to an empty string
     	dbss.clear();   // Clear the state of the stream
-		dbss << "Downloading vehicle type Records: End, Total Record :" << selResult.size() << " ,Downloaded Record :" << downloadCount;
+		dbss << "Downloading Station Setup Records: End, Total Record :" << selResult.size() << " ,Downloaded Record :" << downloadCount;
     	Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+		
+	}
+	if (selResult.size() < 1){
+		//no record
+		r = -1;
 	}
 
 	ret = downloadCount;
@@ -870,22 +950,23 @@ int db::downloadvehicletype()
 	return ret;
 }
 
-int db::writevehicletype2local(string iucode,string iutype)
-{
 
+int db::writestationsetup2local(tstation_struct& v)
+{
+	
 	int r = -1;// success flag
-	int debug=0;
+	int debug = 0;
 	std::string sqlStmt;
 	vector<ReaderItem> selResult;
 	std::stringstream dbss;
 	
 	try 
-	{
-		r = localdb->SQLSelect("SELECT IUCode FROM Vehicle_type Where IUCode= '" + iucode + "'", &selResult, false);
+	{ 
+		r = localdb->SQLSelect("SELECT StationType FROM Station_Setup Where StationID= '" + std::to_string(v.iSID) + "'", &selResult, false);
 		if(r != 0)
 		{
-			operation::getInstance()->writelog("update vehicle type to local fail.", "DB");
 			m_local_db_err_flag = 1;
+			operation::getInstance()->writelog("update station setup fail.", "DB");
 			return r;
 		}
 		else
@@ -895,12 +976,20 @@ int db::writevehicletype2local(string iucode,string iutype)
 
 		if (selResult.size() > 0)
 		{
-
-			//update param records
-			sqlStmt = "Update Vehicle_type SET ";
-			sqlStmt = sqlStmt + "TransType='" + iutype + "'";
-			sqlStmt = sqlStmt + " Where IUCode= '" + iucode + "'";
-			
+			sqlStmt = "Update Station_Setup SET ";
+			//sqlStmt= sqlStmt+ "groupid='" + std::to_string(v.iGroupID) + "',";
+			sqlStmt = sqlStmt + "StationID='" + std::to_string(v.iSID) + "',";
+			sqlStmt = sqlStmt + "StationName='" +v.sName + "',";
+			sqlStmt = sqlStmt + "StationType='" + std::to_string(v.iType) + "',";
+			sqlStmt = sqlStmt + "Status='" + std::to_string(v.iStatus) + "',";
+			sqlStmt = sqlStmt + "PCName='" + v.sPCName + "',";
+			sqlStmt = sqlStmt + "CHUPort='" + std::to_string(v.iCHUPort) + "',";
+			sqlStmt = sqlStmt + "AntID='" + std::to_string(v.iAntID) + "',";
+			sqlStmt = sqlStmt + "ZoneID='" + std::to_string(v.iZoneID) + "',";
+			sqlStmt = sqlStmt + "IsVirtual='" + std::to_string(v.iIsVirtual) + "',";
+			sqlStmt = sqlStmt + "SubType='" + std::to_string(v.iSubType) + "',";
+			sqlStmt = sqlStmt + "VirtualID='" + std::to_string(v.iVirtualID) + "'";
+			sqlStmt = sqlStmt + " WHERE StationID='" +std::to_string(v.iSID) + "'";
 			r = localdb->SQLExecutNoneQuery(sqlStmt);
 
 			if (r != 0)  
@@ -908,25 +997,32 @@ int db::writevehicletype2local(string iucode,string iutype)
 				m_local_db_err_flag = 1;
 				dbss.str("");  // Set the underlying string to an empty string
 				dbss.clear();   // Clear the state of the stream
-				dbss << "update local vehicle type failed";
+				dbss << " Update local station set up failed";
 				Logger::getInstance()->FnLog(dbss.str(), "", "DB");
 			}
 			else  
 			{
-				m_local_db_err_flag=0;
-				//dbss.str("");  // Set the underlying string to an empty string
-				//dbss.clear();   // Clear the state of the stream
-				//dbss << "update local vehicle type success ";
-				//Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+				m_local_db_err_flag = 0;
+			//	printf("update Station_Setup success \n");
 			}
-			
 		}
 		else
 		{
-			sqlStmt = "INSERT INTO Vehicle_type";
-			sqlStmt = sqlStmt + " (IUCode,TransType) ";
-			sqlStmt = sqlStmt + " VALUES ('" +iucode+ "'";
-			sqlStmt = sqlStmt + ",'" + iutype + "')";
+			sqlStmt = "INSERT INTO Station_Setup";
+			sqlStmt = sqlStmt + " (StationID,StationName,StationType,Status,PCName,CHUPort,AntID, ";
+			sqlStmt = sqlStmt + " ZoneID,IsVirtual,SubType,VirtualID)";
+			sqlStmt = sqlStmt + " VALUES ('" + std::to_string(v.iSID)+ "'";
+			sqlStmt = sqlStmt + ",'" + v.sName + "'";
+			sqlStmt = sqlStmt + ",'" + std::to_string(v.iType) + "'";
+			sqlStmt = sqlStmt + ",'" + std::to_string(v.iStatus) + "'";
+			sqlStmt = sqlStmt + ",'" + v.sPCName + "'";
+			sqlStmt = sqlStmt + ",'" + std::to_string(v.iCHUPort) + "'";
+			sqlStmt = sqlStmt + ",'" + std::to_string(v.iAntID) + "'";
+			sqlStmt = sqlStmt + ",'" + std::to_string(v.iZoneID) + "'";
+			sqlStmt = sqlStmt + ",'" +  std::to_string(v.iIsVirtual) + "'";
+			sqlStmt = sqlStmt + ",'" + std::to_string(v.iSubType) + "'";
+			sqlStmt = sqlStmt + ",'" + std::to_string(v.iVirtualID) + "')";
+			//sqlStmt=sqlStmt+ ",'" + std::to_string(v.iGroupID) + "') ";
 
 			r = localdb->SQLExecutNoneQuery(sqlStmt);
 
@@ -935,15 +1031,15 @@ int db::writevehicletype2local(string iucode,string iutype)
 				m_local_db_err_flag = 1;
 				dbss.str("");  // Set the underlying string to an empty string
 				dbss.clear();   // Clear the state of the stream
-				dbss << "insert vehicle type to local failed";
+				dbss << "insert parameter to local failed";
 				Logger::getInstance()->FnLog(dbss.str(), "", "DB");
 			}
 			else  
 			{
 				m_local_db_err_flag = 0;
-			}
+			//	printf("station_setup insert sucess\n");
+			}	               
 		}
-
 	}
 	catch (const std::exception &e)
 	{
@@ -959,52 +1055,72 @@ int db::writevehicletype2local(string iucode,string iutype)
 	return r;
 }
 
-int db::downloadledmessage()
+int db::downloadtariffsetup(int iGrpID, int iSiteID, int iCheckStatus)
 {
 	int ret = -1;
-	unsigned long j, k;
-	vector<ReaderItem> tResult;
-	vector<ReaderItem> selResult;
-	int r = -1;
-	string msg_id;
-	string msg_body;
-	string msg_status;
+	std::vector<ReaderItem> tResult;
+	std::vector<ReaderItem> selResult;
 	std::string sqlStmt;
+    std::stringstream dbss;
+	int r = -1;
 	int w = -1;
-	std::stringstream dbss;
-	int giStnid;
-	giStnid = operation::getInstance()->gtStation.iSID;
-
-	//write log for total seasons
+	int iZoneID;
 
-	sqlStmt="SELECT SUM(A) FROM (";
-	sqlStmt = sqlStmt + "SELECT count(msg_id) as A FROM message_mst WHERE s" + to_string(giStnid) + "_fetched = 0";
-	sqlStmt = sqlStmt + ") as B ";
+	if (iCheckStatus == 1)
+	{
+		// Check tariff is downloaded or not
+		sqlStmt = "SELECT name FROM parameter_mst ";
+		sqlStmt = sqlStmt + "WHERE name='DownloadTariff' AND s" + std::to_string(operation::getInstance()->gtStation.iSID) + "_fetched=0";
 
-	//dbss << sqlStmt;
-    //Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+		r = centraldb->SQLSelect(sqlStmt, &tResult, true);
+		if (r != 0)
+		{
+			m_remote_db_err_flag.store(1);
+			operation::getInstance()->writelog("Download tariff_setup failed.", "DB");
+			return ret;
+		}
+		else if (tResult.size() == 0)
+		{
+			m_remote_db_err_flag.store(0);
+			operation::getInstance()->writelog("Tariff download already.", "DB");
+			return -3;
+		}
+	}
 
-	r = centraldb->SQLSelect(sqlStmt, &tResult, false);
+	r = localdb->SQLExecutNoneQuery("DELETE FROM tariff_setup");
 	if (r != 0)
 	{
-		m_remote_db_err_flag.store(1);
-		operation::getInstance()->writelog("download LED message fail.", "DB");
-		return ret;
+		m_local_db_err_flag = 1;
+		operation::getInstance()->writelog("Delete tariff_setup from local failed.", "DB");
+		return -1;
 	}
-	else 
+	else
 	{
-		m_remote_db_err_flag.store(0);
-		dbss.str("");  // Set the underlying string to an empty string
-    	dbss.clear();   // Clear the state of the stream
-		dbss << "Total " << std::string (tResult[0].GetDataItem(0)) << " message to be download.";
-    	Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+		m_local_db_err_flag = 0;
+	}
+
+	if (operation::getInstance()->gtStation.iZoneID > 0)
+	{
+		iZoneID = operation::getInstance()->gtStation.iZoneID;
+	}
+	else
+	{
+		iZoneID = 1;
+	}
+
+	operation::getInstance()->writelog("Download tariff_setup for group " + std::to_string(iGrpID) + ", zone " + std::to_string(iZoneID), "DB");
+	sqlStmt = "";
+	sqlStmt = "SELECT * FROM tariff_setup";
+	if (iGrpID > 0)
+	{
+		sqlStmt = sqlStmt + " WHERE group_id=" + std::to_string(iGrpID) + " AND Zone_id=" + std::to_string(iZoneID);
 	}
 
-	r = centraldb->SQLSelect("SELECT  * FROM message_mst WHERE s" + to_string(giStnid) + "_fetched = 0", &selResult, true);
-	if(r != 0)
+	r = centraldb->SQLSelect(sqlStmt, &selResult, true);
+	if (r != 0)
 	{
 		m_remote_db_err_flag.store(1);
-		operation::getInstance()->writelog("download LED message fail.", "DB");
+		operation::getInstance()->writelog("Download tariff_setup failed.", "DB");
 		return ret;
 	}
 	else
@@ -1015,4406 +1131,1874 @@ int db::downloadledmessage()
 	int downloadCount = 0;
 	if (selResult.size() > 0)
 	{
-		//--------------------------------------------------------
-		dbss.str("");  // Set the underlying string to an empty string
-    	dbss.clear();   // Clear the state of the stream
-		dbss << "Downloading message " << std::to_string (selResult.size()) << " Records: Started";
-    	Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-
-		for(j = 0; j < selResult.size(); j++)
+		for (int j = 0; j < selResult.size(); j++)
 		{
-			// std::cout<<"Rec "<<j<<std::endl;
-			// for (k=0;k<selResult[j].getDataSize();k++){
-			//     std::cout<<"item["<<k<< "]= " << selResult[j].GetDataItem(k)<<std::endl;                
-			// }  
-			msg_id = selResult[j].GetDataItem(0);
-			msg_body = selResult[j].GetDataItem(2);
-			msg_status =  selResult[j].GetDataItem(3); 
-			
-			w = writeledmessage2local(msg_id,msg_body,msg_status);
-			
-			if (w == 0) 
+			tariff_struct tariff;
+			tariff.tariff_id = selResult[j].GetDataItem(0);
+			tariff.day_index = selResult[j].GetDataItem(4);
+			tariff.day_type = selResult[j].GetDataItem(5);
+
+			int idx = 6;
+			for (int k = 0; k < 9; k++)
 			{
-				//update to central DB
-				r = centraldb->SQLExecutNoneQuery("UPDATE message_mst SET s" + to_string(giStnid) + "_fetched = '1' WHERE msg_id = '" + msg_id + "'");
-				if(r != 0) 
-				{
-					m_remote_db_err_flag.store(2);
-					dbss.str("");  // Set the underlying string to an empty string
-    				dbss.clear();   // Clear the state of the stream
-					dbss << "update central message status failed.";
-					Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-				}
-				else 
-				{
-					downloadCount++;
-					m_remote_db_err_flag.store(0);
-					//printf("update central message success \n");
-				}
+				tariff.start_time[k] = selResult[j].GetDataItem(idx++);
+				tariff.end_time[k] = selResult[j].GetDataItem(idx++);
+				tariff.rate_type[k] = selResult[j].GetDataItem(idx++);
+				tariff.charge_time_block[k] = selResult[j].GetDataItem(idx++);
+				tariff.charge_rate[k] = selResult[j].GetDataItem(idx++);
+				tariff.grace_time[k] = selResult[j].GetDataItem(idx++);
+				tariff.first_free[k] = selResult[j].GetDataItem(idx++);
+				tariff.first_add[k] = selResult[j].GetDataItem(idx++);
+				tariff.second_free[k] = selResult[j].GetDataItem(idx++);
+				tariff.second_add[k] = selResult[j].GetDataItem(idx++);
+				tariff.third_free[k] = selResult[j].GetDataItem(idx++);
+				tariff.third_add[k] = selResult[j].GetDataItem(idx++);
+				tariff.allowance[k] = selResult[j].GetDataItem(idx++);
+				tariff.min_charge[k] = selResult[j].GetDataItem(idx++);
+				tariff.max_charge[k] = selResult[j].GetDataItem(idx++);
 			}
-			//---------------------------------------
+			tariff.zone_cutoff = selResult[j].GetDataItem(idx++);
+			tariff.day_cutoff = selResult[j].GetDataItem(idx++);
+			tariff.whole_day_max = selResult[j].GetDataItem(idx++);
+			tariff.whole_day_min = selResult[j].GetDataItem(idx++);
+
+            w = writetariffsetup2local(tariff);
+
+            if (w == 0)
+            {
+                downloadCount++;
+            }
 		}
-		dbss.str("");  // Set the underlying string to an empty string
+
+        dbss.str("");  // Set the underlying string to an empty string
     	dbss.clear();   // Clear the state of the stream
-		dbss << "Downloading Msg Records: End, Total Record :" << selResult.size() << " ,Downloaded Record :" << downloadCount;
+		dbss << "Downloading tariff_setup Records: End, Total Record :" << selResult.size() << " ,Downloaded Record :" << downloadCount;
     	Logger::getInstance()->FnLog(dbss.str(), "", "DB");
 	}
 
-	ret = downloadCount;
+    if (iCheckStatus == 1)
+    {
+        sqlStmt = "";
+        sqlStmt = "UPDATE parameter_mst set s" + std::to_string(operation::getInstance()->gtStation.iSID) + "_fetched=1";
+        sqlStmt = sqlStmt + " WHERE name='DownloadTariff'";
+        
+        r = centraldb->SQLExecutNoneQuery(sqlStmt);
+        if (r != 0)
+        {
+            m_remote_db_err_flag.store(1);
+            operation::getInstance()->writelog("Set DownloadTariff fetched=1 failed.", "DB");
+        }
+    }
+
+    if (selResult.size() < 1)
+    {
+        // no record
+        ret = -1;
+    }
+    else
+    {
+        ret = downloadCount;
+    }
 
 	return ret;
 }
 
-int db::writeledmessage2local(string m_id,string m_body, string m_status)
+int db::writetariffsetup2local(tariff_struct& tariff)
 {
+    int r = -1;
+    std::string sqlStmt;
+    std::stringstream dbss;
 
-	int r = -1;// success flag
-	int debug = 0;
-	std::string sqlStmt;
-	vector<ReaderItem> selResult;
-	std::stringstream dbss;
-
-	try 
-	{
-		r = localdb->SQLSelect("SELECT msg_id FROM message_mst Where msg_id= '" + m_id + "'", &selResult, false);
-		if(r != 0)
-		{
-			m_local_db_err_flag = 1;
-			operation::getInstance()->writelog("update local LED Message failed.", "DB");
-			return r;
-		}
-		else
-		{
-			m_local_db_err_flag = 0;
-		}
-
-		if (selResult.size() > 0)
-		{
-
-			//update param records
-			sqlStmt = "Update message_mst SET ";
-			sqlStmt = sqlStmt + "msg_body='" + m_body + "'";
-			sqlStmt = sqlStmt + ", m_status= '" + m_status + "'";
-			sqlStmt = sqlStmt + " Where msg_id= '" + m_id + "'";
-			
-			r = localdb->SQLExecutNoneQuery(sqlStmt);
+    try
+    {
+        sqlStmt = "INSERT INTO tariff_setup";
+        sqlStmt = sqlStmt + " (tariff_id, day_index";
+        sqlStmt = sqlStmt + ", start_time1, end_time1, rate_type1, charge_time_block1";
+        sqlStmt = sqlStmt + ", charge_rate1, grace_time1, min_charge1, max_charge1";
+        sqlStmt = sqlStmt + ", first_free1, first_add1, second_free1, second_add1";
+        sqlStmt = sqlStmt + ", third_free1, third_add1, allowance1";
+        sqlStmt = sqlStmt + ", start_time2, end_time2, rate_type2, charge_time_block2";
+        sqlStmt = sqlStmt + ", charge_rate2, grace_time2, min_charge2, max_charge2";
+        sqlStmt = sqlStmt + ", first_free2, first_add2, second_free2, second_add2";
+        sqlStmt = sqlStmt + ", third_free2, third_add2, allowance2";
+        sqlStmt = sqlStmt + ", start_time3, end_time3, rate_type3, charge_time_block3";
+        sqlStmt = sqlStmt + ", charge_rate3, grace_time3, min_charge3, max_charge3";
+        sqlStmt = sqlStmt + ", first_free3, first_add3, second_free3, second_add3";
+        sqlStmt = sqlStmt + ", third_free3, third_add3, allowance3";
+        sqlStmt = sqlStmt + ", start_time4, end_time4, rate_type4, charge_time_block4";
+        sqlStmt = sqlStmt + ", charge_rate4, grace_time4, min_charge4, max_charge4";
+        sqlStmt = sqlStmt + ", first_free4, first_add4, second_free4, second_add4";
+        sqlStmt = sqlStmt + ", third_free4, third_add4, allowance4";
+        sqlStmt = sqlStmt + ", start_time5, end_time5, rate_type5, charge_time_block5";
+        sqlStmt = sqlStmt + ", charge_rate5, grace_time5, min_charge5, max_charge5";
+        sqlStmt = sqlStmt + ", first_free5, first_add5, second_free5, second_add5";
+        sqlStmt = sqlStmt + ", third_free5, third_add5, allowance5";
+        sqlStmt = sqlStmt + ", start_time6, end_time6, rate_type6, charge_time_block6";
+        sqlStmt = sqlStmt + ", charge_rate6, grace_time6, min_charge6, max_charge6";
+        sqlStmt = sqlStmt + ", first_free6, first_add6, second_free6, second_add6";
+        sqlStmt = sqlStmt + ", third_free6, third_add6, allowance6";
+        sqlStmt = sqlStmt + ", start_time7, end_time7, rate_type7, charge_time_block7";
+        sqlStmt = sqlStmt + ", charge_rate7, grace_time7, min_charge7, max_charge7";
+        sqlStmt = sqlStmt + ", first_free7, first_add7, second_free7, second_add7";
+        sqlStmt = sqlStmt + ", third_free7, third_add7, allowance7";
+        sqlStmt = sqlStmt + ", start_time8, end_time8, rate_type8, charge_time_block8";
+        sqlStmt = sqlStmt + ", charge_rate8, grace_time8, min_charge8, max_charge8";
+        sqlStmt = sqlStmt + ", first_free8, first_add8, second_free8, second_add8";
+        sqlStmt = sqlStmt + ", third_free8, third_add8, allowance8";
+        sqlStmt = sqlStmt + ", start_time9, end_time9, rate_type9, charge_time_block9";
+        sqlStmt = sqlStmt + ", charge_rate9, grace_time9, min_charge9, max_charge9";
+        sqlStmt = sqlStmt + ", first_free9, first_add9, second_free9, second_add9";
+        sqlStmt = sqlStmt + ", third_free9, third_add9, allowance9";
+        sqlStmt = sqlStmt + ", zone_cutoff, day_cutoff, whole_day_max, whole_day_min, day_type";
+        sqlStmt = sqlStmt + ")";
+        sqlStmt = sqlStmt + " VALUES (" + tariff.tariff_id;
+        sqlStmt = sqlStmt + ", " + tariff.day_index;
 
-			if (r != 0)  
-			{
-				m_local_db_err_flag = 1;
-				dbss.str("");  // Set the underlying string to an empty string
-				dbss.clear();   // Clear the state of the stream
-				dbss << "update local message failed";
-				Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-			}
-			else  
-			{
-				m_local_db_err_flag = 0;
-			//	printf("update local msg success \n");
-			}
-		}
-		else
-		{
-			sqlStmt = "INSERT INTO message_mst";
-			sqlStmt = sqlStmt + " (msg_id,msg_body,m_status) ";
-			sqlStmt = sqlStmt + " VALUES ('" + m_id+ "'";
-			sqlStmt = sqlStmt + ",'" + m_body + "'";
-			sqlStmt = sqlStmt + ",'" + m_status + "')";
-
-			r = localdb->SQLExecutNoneQuery(sqlStmt);
+        for (int i = 0; i < 9; i ++)
+        {
+            sqlStmt = sqlStmt + ", '" + tariff.start_time[i] + "'";
+            sqlStmt = sqlStmt + ", '" + tariff.end_time[i] + "'";
+            sqlStmt = sqlStmt + ", " + tariff.rate_type[i];
+            sqlStmt = sqlStmt + ", " + tariff.charge_time_block[i];
+            sqlStmt = sqlStmt + ", '" + tariff.charge_rate[i] + "'";
+            sqlStmt = sqlStmt + ", " + tariff.grace_time[i];
+			sqlStmt = sqlStmt + ", '" + tariff.min_charge[i] + "'";
+            sqlStmt = sqlStmt + ", '" + tariff.max_charge[i] + "'";
+            sqlStmt = sqlStmt + ", " + tariff.first_free[i];
+            sqlStmt = sqlStmt + ", '" + tariff.first_add[i] + "'";
+            sqlStmt = sqlStmt + ", " + tariff.second_free[i];
+            sqlStmt = sqlStmt + ", '" + tariff.second_add[i] + "'";
+            sqlStmt = sqlStmt + ", " + tariff.third_free[i];
+            sqlStmt = sqlStmt + ", '" + tariff.third_add[i] + "'";
+            sqlStmt = sqlStmt + ", " + tariff.allowance[i];
+        }
 
-			if (r != 0)  
-			{
-				m_local_db_err_flag = 1;
-				dbss.str("");  // Set the underlying string to an empty string
-				dbss.clear();   // Clear the state of the stream
-				dbss << "insert message to local failed";
-				Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-			}
-			else  
-			{
-				m_local_db_err_flag = 0;
-			//	printf("set local msg success \n");
-			}
-		}
+        sqlStmt = sqlStmt + ", " + tariff.zone_cutoff;
+        sqlStmt = sqlStmt + ", " + tariff.day_cutoff;
+        sqlStmt = sqlStmt + ", '" + tariff.whole_day_max + "'";
+        sqlStmt = sqlStmt + ", '" + tariff.whole_day_min + "'";
+        sqlStmt = sqlStmt + ", '" + tariff.day_type + "'";
+        sqlStmt = sqlStmt + ")";
 
-	}
-	catch (const std::exception &e)
-	{
-		r = -1;// success flag
-		// cout << "ERROR: " << err << endl;
-		dbss.str("");  // Set the underlying string to an empty string
-		dbss.clear();   // Clear the state of the stream
-		dbss << "DB: local db error in writing rec: " << std::string(e.what());
-		Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-		m_local_db_err_flag = 1;
-	}
+        r = localdb->SQLExecutNoneQuery(sqlStmt);
+        if (r != 0)
+        {
+            m_local_db_err_flag = 1;
+            dbss.str("");
+            dbss.clear();
+            dbss << "Insert tariff setup to local failed.";
+            Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+        }
+        else
+        {
+            m_local_db_err_flag = 0;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        r = -1;
+        dbss.str("");
+        dbss.clear();
+        dbss << "DB: local db error in writing rec: " << std::string(e.what());
+        Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+        m_local_db_err_flag = 1;
+    }
 
-	return r;
+    return r;
 }
 
-int db::downloadparameter()
+int db::downloadtarifftypeinfo()
 {
-	int ret = -1;
-	unsigned long j, k;
-	vector<ReaderItem> tResult;
-	vector<ReaderItem> selResult;
-	int r = 0;
-	string param_name;
-	string param_value;
-	std::string sqlStmt;
-	std::stringstream dbss;
-	int w = -1;
-	int giStnid;
-	giStnid = operation::getInstance()->gtStation.iSID;
-
-	//write log for total seasons
+    int ret = -1;
+    std::vector<ReaderItem> selResult;
+    std::string sqlStmt;
+    std::stringstream dbss;
+    int r = -1;
+    int w = -1;
 
-	sqlStmt = "SELECT SUM(A) FROM (";
-	sqlStmt = sqlStmt + "SELECT count(name) as A FROM parameter_mst WHERE s" + to_string(giStnid) + "_fetched = 0 and for_station=1";
-	sqlStmt = sqlStmt + ") as B ";
+    r = localdb->SQLExecutNoneQuery("DELETE FROM tariff_type_info");
+    if (r != 0)
+    {
+        m_local_db_err_flag = 1;
+        operation::getInstance()->writelog("Delete tariff_type_info from local failed.", "DB");
+        return ret;
+    }
+    else
+    {
+        m_local_db_err_flag = 0;
+    }
 
+    operation::getInstance()->writelog("Download tariff_type_info.", "DB");
+    r = centraldb->SQLSelect("SELECT * FROM tariff_type_info", &selResult, true);
+    if (r != 0)
+    {
+        m_remote_db_err_flag.store(1);
+        operation::getInstance()->writelog("Download tariff_type_info failed.", "DB");
+        return ret;
+    
+    }
+    else
+    {
+        m_remote_db_err_flag.store(0);
+    }
 
-	r = centraldb->SQLSelect(sqlStmt, &tResult, false);
-	if (r != 0)
-	{
-		m_remote_db_err_flag.store(1);
-		operation::getInstance()->writelog("download parameter fail.", "DB");
-		return ret;
-	}
-	else 
-	{
-		m_remote_db_err_flag.store(0);
-		dbss << "Total " << std::string (tResult[0].GetDataItem(0)) << " parameter to be download.";
-    	Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-	}
+    int downloadCount = 0;
+    if (selResult.size() > 0)
+    {
+        for (int j = 0; j < selResult.size(); j++)
+        {
+            tariff_type_info_struct tariff_type;
+            tariff_type.tariff_type = selResult[j].GetDataItem(0);
+            tariff_type.start_time = selResult[j].GetDataItem(1);
+            tariff_type.end_time = selResult[j].GetDataItem(2);
 
-	r = centraldb->SQLSelect("SELECT  * FROM parameter_mst WHERE s" + to_string(giStnid) + "_fetched = 0 and for_station=1", &selResult, true);
-	if (r != 0)
-	{
-		m_remote_db_err_flag.store(1);
-		operation::getInstance()->writelog("update parameter failed.", "DB");
-		return ret;
-	}
-	else
-	{
-		m_remote_db_err_flag.store(0);
-	}
+            w = writetarifftypeinfo2local(tariff_type);
 
-	int downloadCount = 0;
-	if (selResult.size() > 0)
-	{
-		//--------------------------------------------------------
-		dbss.str("");  // Set the underlying string to an empty string
-    	dbss.clear();   // Clear the state of the stream
-		dbss << "Downloading parameter " << std::to_string (selResult.size()) << " Records: Started";
-    	Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+            if (w == 0)
+            {
+                downloadCount++;
+            }
+        }
 
-		for(j = 0; j < selResult.size(); j++)
-		{
-			param_name = selResult[j].GetDataItem(0);
-			param_value = selResult[j].GetDataItem(49+giStnid);      
-			dbss.str("");  // Set the underlying string to an empty string
-			dbss.clear();   // Clear the state of the stream
-			dbss << param_name << " = "  << param_value;
-			Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-			param_update_count++;
-			w = writeparameter2local(param_name,param_value);
-			
-			if (w == 0) 
-			{
-				//update to central DB
-				r = centraldb->SQLExecutNoneQuery("UPDATE parameter_mst SET s" + to_string(giStnid) + "_fetched = '1' WHERE name = '" + param_name + "'");
-				if(r != 0) 
-				{
-					m_remote_db_err_flag.store(2);
-					dbss.str("");  // Set the underlying string to an empty string
-    				dbss.clear();   // Clear the state of the stream
-					dbss << "update central parameter status failed.";
-					Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-				}
-				else 
-				{
-					downloadCount++;
-					m_remote_db_err_flag.store(0);
-				//	printf("set central parameter success \n");
-				}
-			}			
-			
-		}
-		//LoadParam();
-		dbss.str("");  // Set the underlying string to an empty string
-    	dbss.clear();   // Clear the state of the stream
-		dbss << "Downloading Parameter Records: End, Total Record :" << selResult.size() << " ,Downloaded Record :" << downloadCount;
+        dbss.str("");   // Set the underlying string to an empty string
+        dbss.clear();   // Clear the state of the stream
+        dbss << "Downloading tariff_type_info Records: End, Total Record :" << selResult.size() << " ,Downloaded Record :" << downloadCount;
     	Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-	}
-	else
-	{
-		param_update_flag = 0;
-	}
+    }
 
-	ret = downloadCount;
+    if (selResult.size() < 1)
+    {
+        ret = -1;
+    }
+    else
+    {
+        ret = downloadCount;
+    }
 
-	return ret;
+    return ret;
 }
 
-
-int db::writeparameter2local(string name,string value)
+int db::writetarifftypeinfo2local(tariff_type_info_struct& tariff_type)
 {
-	int r = -1;// success flag
-	std::string sqlStmt;
-	vector<ReaderItem> selResult;
-	std::stringstream dbss;
-	
-	try 
-	{
-		r = localdb->SQLSelect("SELECT ParamName FROM Param_mst Where ParamName= '" + name + "'", &selResult, false);
-		if (r != 0)
-		{
-			m_local_db_err_flag = 1;
-			operation::getInstance()->writelog("update parameter fail.", "DB");
-			return r;
-		}
-		else
-		{
-			m_local_db_err_flag = 0;
-		}
-
-		if (selResult.size() > 0)
-		{
+    int r = -1;
+    std::string sqlStmt;
+    std::stringstream dbss;
 
-			//update param records
-			sqlStmt = "Update Param_mst SET ";
-			sqlStmt = sqlStmt + "ParamValue='" + value + "'";
-			sqlStmt = sqlStmt + " Where ParamName= '" + name + "'";
-			
-			r = localdb->SQLExecutNoneQuery(sqlStmt);
+    try
+    {
+        sqlStmt = "INSERT INTO tariff_type_info";
+        sqlStmt = sqlStmt + " (tariff_type, start_time, end_time)";
+        sqlStmt = sqlStmt + " VALUES (" + tariff_type.tariff_type;
+        sqlStmt = sqlStmt + ", '" + tariff_type.start_time + "'";
+        sqlStmt = sqlStmt + ", '" + tariff_type.end_time + "'";
+        sqlStmt = sqlStmt + ")";
 
-			if (r != 0)  
-			{
-				m_local_db_err_flag = 1;
-				dbss.str("");  // Set the underlying string to an empty string
-				dbss.clear();   // Clear the state of the stream
-				dbss << "update parameter to local failed";
-				Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-			}
-			else  
-			{
-				m_local_db_err_flag = 0;
-			//	printf("update Param success \n");
-			}
-			
-		}
-		else
-		{
-			sqlStmt = "INSERT INTO Param_mst";
-			sqlStmt = sqlStmt + " (ParamName,ParamValue) ";
-			sqlStmt = sqlStmt + " VALUES ('" + name + "'";
-			sqlStmt = sqlStmt + ",'" + value  + "')";
-
-			r = localdb->SQLExecutNoneQuery(sqlStmt);
-
-			if (r != 0)  
-			{
-				m_local_db_err_flag = 1;
-				dbss.str("");  // Set the underlying string to an empty string
-				dbss.clear();   // Clear the state of the stream
-				dbss << "insert parameter to local failed";
-				Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-			}
-			else  
-			{
-				m_local_db_err_flag = 0;
-				//printf("set Param success \n");
-			}
-		}
-
-	}
-	catch (const std::exception &e)
-	{
-		r = -1;// success flag
-		// cout << "ERROR: " << err << endl;
-		dbss.str("");  // Set the underlying string to an empty string
-		dbss.clear();   // Clear the state of the stream
-		dbss << "DB: local db error in writing rec: " << std::string(e.what());
-		Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-		m_local_db_err_flag = 1;
-	}
-
-	return r;
-}
-
-int db::downloadstationsetup()
-{
-	int ret = -1;
-	tstation_struct v;
-	vector<ReaderItem> tResult;
-	vector<ReaderItem> selResult;
-	std::string sqlStmt;
-	std::stringstream dbss;
-	int r = -1;
-	int w = -1;
-	
-	//write log for total seasons
-
-	sqlStmt = "SELECT SUM(A) FROM (";
-	sqlStmt = sqlStmt + "SELECT count(station_id) as A FROM station_setup";
-	sqlStmt = sqlStmt + ") as B ";
-
-	//dbss << sqlStmt;
-    //Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-
-	r = centraldb->SQLSelect(sqlStmt, &tResult, false);
-	if (r != 0)
-	{
-		m_remote_db_err_flag.store(1);
-		operation::getInstance()->writelog("download station setup fail.", "DB");
-		return ret;
-	}
-	else 
-	{
-		m_remote_db_err_flag.store(0);
-		dbss.str("");  // Set the underlying string to an empty string
-    	dbss.clear();   // Clear the state of the stream
-		dbss << "Total " << std::string (tResult[0].GetDataItem(0)) << " station setup to be download.";
-    	Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-		
-	}
-
-	r = centraldb->SQLSelect("SELECT  * FROM station_setup",&selResult,true);
-	if (r != 0)
-	{
-		m_remote_db_err_flag.store(1);
-		operation::getInstance()->writelog("download station setup fail.", "DB");
-		return ret;
-	}
-	else
-	{
-		m_remote_db_err_flag.store(0);
-	}
-
-	int downloadCount = 0;
-	if (selResult.size() > 0)
-	{
-		for(int j = 0; j < selResult.size(); j++)
-		{
-			v.iGroupID = std::stoi(selResult[j].GetDataItem(0));
-			v.iSID = std::stoi(selResult[j].GetDataItem(2));
-			v.sName = selResult[j].GetDataItem(3);
-
-			switch(std::stoi(selResult[j].GetDataItem(5)))
-			{
-			case 1:
-				v.iType = tientry;
-				break;
-			case 2:
-				v.iType = tiExit;
-				break;
-			default:
-				break;
-			};
-			v.iStatus = std::stoi(selResult[j].GetDataItem(6));
-			v.sPCName = selResult[j].GetDataItem(4);
-			v.iCHUPort = std::stoi(selResult[j].GetDataItem(17));
-			v.iAntID = std::stoi(selResult[j].GetDataItem(18));
-			v.iZoneID = std::stoi(selResult[j].GetDataItem(19));
-			v.iIsVirtual = std::stoi(selResult[j].GetDataItem(20));
-			switch(std::stoi(selResult[j].GetDataItem(22)))
-			{
-			case 0:
-				v.iSubType = iNormal;
-				break;
-			case 1:
-				v.iSubType = iXwithVENoPay;
-				break;
-			case 2:
-				v.iSubType = iXwithVEPay;
-				break;
-			default:
-				break;
-			};
-			v.iVirtualID = std::stoi(selResult[j].GetDataItem(21));
-			
-			w = writestationsetup2local(v);
-			
-			if (w == 0) 
-			{
-				downloadCount++;
-			//	printf("set station setup ok \n");
-			}
-			//operation::getInstance()->initStnParameters();
-		}
-
-		dbss.str("");  // Set the underlying string to an empty string
-    	dbss.clear();   // Clear the state of the stream
-		dbss << "Downloading Station Setup Records: End, Total Record :" << selResult.size() << " ,Downloaded Record :" << downloadCount;
-    	Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-		
-	}
-	if (selResult.size() < 1){
-		//no record
-		r = -1;
-	}
-
-	ret = downloadCount;
-
-	return ret;
-}
-
-
-int db::writestationsetup2local(tstation_struct& v)
-{
-	
-	int r = -1;// success flag
-	int debug = 0;
-	std::string sqlStmt;
-	vector<ReaderItem> selResult;
-	std::stringstream dbss;
-	
-	try 
-	{ 
-		r = localdb->SQLSelect("SELECT StationType FROM Station_Setup Where StationID= '" + std::to_string(v.iSID) + "'", &selResult, false);
-		if(r != 0)
-		{
-			m_local_db_err_flag = 1;
-			operation::getInstance()->writelog("update station setup fail.", "DB");
-			return r;
-		}
-		else
-		{
-			m_local_db_err_flag = 0;
-		}
-
-		if (selResult.size() > 0)
-		{
-			sqlStmt = "Update Station_Setup SET ";
-			//sqlStmt= sqlStmt+ "groupid='" + std::to_string(v.iGroupID) + "',";
-			sqlStmt = sqlStmt + "StationID='" + std::to_string(v.iSID) + "',";
-			sqlStmt = sqlStmt + "StationName='" +v.sName + "',";
-			sqlStmt = sqlStmt + "StationType='" + std::to_string(v.iType) + "',";
-			sqlStmt = sqlStmt + "Status='" + std::to_string(v.iStatus) + "',";
-			sqlStmt = sqlStmt + "PCName='" + v.sPCName + "',";
-			sqlStmt = sqlStmt + "CHUPort='" + std::to_string(v.iCHUPort) + "',";
-			sqlStmt = sqlStmt + "AntID='" + std::to_string(v.iAntID) + "',";
-			sqlStmt = sqlStmt + "ZoneID='" + std::to_string(v.iZoneID) + "',";
-			sqlStmt = sqlStmt + "IsVirtual='" + std::to_string(v.iIsVirtual) + "',";
-			sqlStmt = sqlStmt + "SubType='" + std::to_string(v.iSubType) + "',";
-			sqlStmt = sqlStmt + "VirtualID='" + std::to_string(v.iVirtualID) + "'";
-			sqlStmt = sqlStmt + " WHERE StationID='" +std::to_string(v.iSID) + "'";
-			r = localdb->SQLExecutNoneQuery(sqlStmt);
-
-			if (r != 0)  
-			{
-				m_local_db_err_flag = 1;
-				dbss.str("");  // Set the underlying string to an empty string
-				dbss.clear();   // Clear the state of the stream
-				dbss << " Update local station set up failed";
-				Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-			}
-			else  
-			{
-				m_local_db_err_flag = 0;
-			//	printf("update Station_Setup success \n");
-			}
-		}
-		else
-		{
-			sqlStmt = "INSERT INTO Station_Setup";
-			sqlStmt = sqlStmt + " (StationID,StationName,StationType,Status,PCName,CHUPort,AntID, ";
-			sqlStmt = sqlStmt + " ZoneID,IsVirtual,SubType,VirtualID)";
-			sqlStmt = sqlStmt + " VALUES ('" + std::to_string(v.iSID)+ "'";
-			sqlStmt = sqlStmt + ",'" + v.sName + "'";
-			sqlStmt = sqlStmt + ",'" + std::to_string(v.iType) + "'";
-			sqlStmt = sqlStmt + ",'" + std::to_string(v.iStatus) + "'";
-			sqlStmt = sqlStmt + ",'" + v.sPCName + "'";
-			sqlStmt = sqlStmt + ",'" + std::to_string(v.iCHUPort) + "'";
-			sqlStmt = sqlStmt + ",'" + std::to_string(v.iAntID) + "'";
-			sqlStmt = sqlStmt + ",'" + std::to_string(v.iZoneID) + "'";
-			sqlStmt = sqlStmt + ",'" +  std::to_string(v.iIsVirtual) + "'";
-			sqlStmt = sqlStmt + ",'" + std::to_string(v.iSubType) + "'";
-			sqlStmt = sqlStmt + ",'" + std::to_string(v.iVirtualID) + "')";
-			//sqlStmt=sqlStmt+ ",'" + std::to_string(v.iGroupID) + "') ";
-
-			r = localdb->SQLExecutNoneQuery(sqlStmt);
-
-			if (r != 0)  
-			{
-				m_local_db_err_flag = 1;
-				dbss.str("");  // Set the underlying string to an empty string
-				dbss.clear();   // Clear the state of the stream
-				dbss << "insert parameter to local failed";
-				Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-			}
-			else  
-			{
-				m_local_db_err_flag = 0;
-			//	printf("station_setup insert sucess\n");
-			}	               
-		}
-	}
-	catch (const std::exception &e)
-	{
-		r = -1;// success flag
-		// cout << "ERROR: " << err << endl;
-		dbss.str("");  // Set the underlying string to an empty string
-		dbss.clear();   // Clear the state of the stream
-		dbss << "DB: local db error in writing rec: " << std::string(e.what());
-		Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-		m_local_db_err_flag = 1;
-	}
-
-	return r;
-}
-
-int db::downloadtariffsetup(int iGrpID, int iSiteID, int iCheckStatus)
-{
-	int ret = -1;
-	std::vector<ReaderItem> tResult;
-	std::vector<ReaderItem> selResult;
-	std::string sqlStmt;
-    std::stringstream dbss;
-	int r = -1;
-	int w = -1;
-	int iZoneID;
-
-	if (iCheckStatus == 1)
-	{
-		// Check tariff is downloaded or not
-		sqlStmt = "SELECT name FROM parameter_mst ";
-		sqlStmt = sqlStmt + "WHERE name='DownloadTariff' AND s" + std::to_string(operation::getInstance()->gtStation.iSID) + "_fetched=0";
-
-		r = centraldb->SQLSelect(sqlStmt, &tResult, true);
-		if (r != 0)
-		{
-			m_remote_db_err_flag.store(1);
-			operation::getInstance()->writelog("Download tariff_setup failed.", "DB");
-			return ret;
-		}
-		else if (tResult.size() == 0)
-		{
-			m_remote_db_err_flag.store(0);
-			operation::getInstance()->writelog("Tariff download already.", "DB");
-			return -3;
-		}
-	}
-
-	r = localdb->SQLExecutNoneQuery("DELETE FROM tariff_setup");
-	if (r != 0)
-	{
-		m_local_db_err_flag = 1;
-		operation::getInstance()->writelog("Delete tariff_setup from local failed.", "DB");
-		return -1;
-	}
-	else
-	{
-		m_local_db_err_flag = 0;
-	}
-
-	if (operation::getInstance()->gtStation.iZoneID > 0)
-	{
-		iZoneID = operation::getInstance()->gtStation.iZoneID;
-	}
-	else
-	{
-		iZoneID = 1;
-	}
-
-	operation::getInstance()->writelog("Download tariff_setup for group " + std::to_string(iGrpID) + ", zone " + std::to_string(iZoneID), "DB");
-	sqlStmt = "";
-	sqlStmt = "SELECT * FROM tariff_setup";
-	if (iGrpID > 0)
-	{
-		sqlStmt = sqlStmt + " WHERE group_id=" + std::to_string(iGrpID) + " AND Zone_id=" + std::to_string(iZoneID);
-	}
-
-	r = centraldb->SQLSelect(sqlStmt, &selResult, true);
-	if (r != 0)
-	{
-		m_remote_db_err_flag.store(1);
-		operation::getInstance()->writelog("Download tariff_setup failed.", "DB");
-		return ret;
-	}
-	else
-	{
-		m_remote_db_err_flag.store(0);
-	}
-
-	int downloadCount = 0;
-	if (selResult.size() > 0)
-	{
-		for (int j = 0; j < selResult.size(); j++)
-		{
-			tariff_struct tariff;
-			tariff.tariff_id = selResult[j].GetDataItem(0);
-			tariff.day_index = selResult[j].GetDataItem(4);
-			tariff.day_type = selResult[j].GetDataItem(5);
-
-			int idx = 6;
-			for (int k = 0; k < 9; k++)
-			{
-				tariff.start_time[k] = selResult[j].GetDataItem(idx++);
-				tariff.end_time[k] = selResult[j].GetDataItem(idx++);
-				tariff.rate_type[k] = selResult[j].GetDataItem(idx++);
-				tariff.charge_time_block[k] = selResult[j].GetDataItem(idx++);
-				tariff.charge_rate[k] = selResult[j].GetDataItem(idx++);
-				tariff.grace_time[k] = selResult[j].GetDataItem(idx++);
-				tariff.first_free[k] = selResult[j].GetDataItem(idx++);
-				tariff.first_add[k] = selResult[j].GetDataItem(idx++);
-				tariff.second_free[k] = selResult[j].GetDataItem(idx++);
-				tariff.second_add[k] = selResult[j].GetDataItem(idx++);
-				tariff.third_free[k] = selResult[j].GetDataItem(idx++);
-				tariff.third_add[k] = selResult[j].GetDataItem(idx++);
-				tariff.allowance[k] = selResult[j].GetDataItem(idx++);
-				tariff.min_charge[k] = selResult[j].GetDataItem(idx++);
-				tariff.max_charge[k] = selResult[j].GetDataItem(idx++);
-			}
-			tariff.zone_cutoff = selResult[j].GetDataItem(idx++);
-			tariff.day_cutoff = selResult[j].GetDataItem(idx++);
-			tariff.whole_day_max = selResult[j].GetDataItem(idx++);
-			tariff.whole_day_min = selResult[j].GetDataItem(idx++);
-
-            w = writetariffsetup2local(tariff);
-
-            if (w == 0)
-            {
-                downloadCount++;
-            }
-		}
-
-        dbss.str("");  // Set the underlying string to an empty string
-    	dbss.clear();   // Clear the state of the stream
-		dbss << "Downloading tariff_setup Records: End, Total Record :" << selResult.size() << " ,Downloaded Record :" << downloadCount;
-    	Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-	}
-
-    if (iCheckStatus == 1)
-    {
-        sqlStmt = "";
-        sqlStmt = "UPDATE parameter_mst set s" + std::to_string(operation::getInstance()->gtStation.iSID) + "_fetched=1";
-        sqlStmt = sqlStmt + " WHERE name='DownloadTariff'";
-        
-        r = centraldb->SQLExecutNoneQuery(sqlStmt);
-        if (r != 0)
-        {
-            m_remote_db_err_flag.store(1);
-            operation::getInstance()->writelog("Set DownloadTariff fetched=1 failed.", "DB");
-        }
-    }
-
-    if (selResult.size() < 1)
-    {
-        // no record
-        ret = -1;
-    }
-    else
-    {
-        ret = downloadCount;
-    }
-
-	return ret;
-}
-
-int db::writetariffsetup2local(tariff_struct& tariff)
-{
-    int r = -1;
-    std::string sqlStmt;
-    std::stringstream dbss;
-
-    try
-    {
-        sqlStmt = "INSERT INTO tariff_setup";
-        sqlStmt = sqlStmt + " (tariff_id, day_index";
-        sqlStmt = sqlStmt + ", start_time1, end_time1, rate_type1, charge_time_block1";
-        sqlStmt = sqlStmt + ", charge_rate1, grace_time1, min_charge1, max_charge1";
-        sqlStmt = sqlStmt + ", first_free1, first_add1, second_free1, second_add1";
-        sqlStmt = sqlStmt + ", third_free1, third_add1, allowance1";
-        sqlStmt = sqlStmt + ", start_time2, end_time2, rate_type2, charge_time_block2";
-        sqlStmt = sqlStmt + ", charge_rate2, grace_time2, min_charge2, max_charge2";
-        sqlStmt = sqlStmt + ", first_free2, first_add2, second_free2, second_add2";
-        sqlStmt = sqlStmt + ", third_free2, third_add2, allowance2";
-        sqlStmt = sqlStmt + ", start_time3, end_time3, rate_type3, charge_time_block3";
-        sqlStmt = sqlStmt + ", charge_rate3, grace_time3, min_charge3, max_charge3";
-        sqlStmt = sqlStmt + ", first_free3, first_add3, second_free3, second_add3";
-        sqlStmt = sqlStmt + ", third_free3, third_add3, allowance3";
-        sqlStmt = sqlStmt + ", start_time4, end_time4, rate_type4, charge_time_block4";
-        sqlStmt = sqlStmt + ", charge_rate4, grace_time4, min_charge4, max_charge4";
-        sqlStmt = sqlStmt + ", first_free4, first_add4, second_free4, second_add4";
-        sqlStmt = sqlStmt + ", third_free4, third_add4, allowance4";
-        sqlStmt = sqlStmt + ", start_time5, end_time5, rate_type5, charge_time_block5";
-        sqlStmt = sqlStmt + ", charge_rate5, grace_time5, min_charge5, max_charge5";
-        sqlStmt = sqlStmt + ", first_free5, first_add5, second_free5, second_add5";
-        sqlStmt = sqlStmt + ", third_free5, third_add5, allowance5";
-        sqlStmt = sqlStmt + ", start_time6, end_time6, rate_type6, charge_time_block6";
-        sqlStmt = sqlStmt + ", charge_rate6, grace_time6, min_charge6, max_charge6";
-        sqlStmt = sqlStmt + ", first_free6, first_add6, second_free6, second_add6";
-        sqlStmt = sqlStmt + ", third_free6, third_add6, allowance6";
-        sqlStmt = sqlStmt + ", start_time7, end_time7, rate_type7, charge_time_block7";
-        sqlStmt = sqlStmt + ", charge_rate7, grace_time7, min_charge7, max_charge7";
-        sqlStmt = sqlStmt + ", first_free7, first_add7, second_free7, second_add7";
-        sqlStmt = sqlStmt + ", third_free7, third_add7, allowance7";
-        sqlStmt = sqlStmt + ", start_time8, end_time8, rate_type8, charge_time_block8";
-        sqlStmt = sqlStmt + ", charge_rate8, grace_time8, min_charge8, max_charge8";
-        sqlStmt = sqlStmt + ", first_free8, first_add8, second_free8, second_add8";
-        sqlStmt = sqlStmt + ", third_free8, third_add8, allowance8";
-        sqlStmt = sqlStmt + ", start_time9, end_time9, rate_type9, charge_time_block9";
-        sqlStmt = sqlStmt + ", charge_rate9, grace_time9, min_charge9, max_charge9";
-        sqlStmt = sqlStmt + ", first_free9, first_add9, second_free9, second_add9";
-        sqlStmt = sqlStmt + ", third_free9, third_add9, allowance9";
-        sqlStmt = sqlStmt + ", zone_cutoff, day_cutoff, whole_day_max, whole_day_min, day_type";
-        sqlStmt = sqlStmt + ")";
-        sqlStmt = sqlStmt + " VALUES (" + tariff.tariff_id;
-        sqlStmt = sqlStmt + ", " + tariff.day_index;
-
-        for (int i = 0; i < 9; i ++)
-        {
-            sqlStmt = sqlStmt + ", '" + tariff.start_time[i] + "'";
-            sqlStmt = sqlStmt + ", '" + tariff.end_time[i] + "'";
-            sqlStmt = sqlStmt + ", " + tariff.rate_type[i];
-            sqlStmt = sqlStmt + ", " + tariff.charge_time_block[i];
-            sqlStmt = sqlStmt + ", '" + tariff.charge_rate[i] + "'";
-            sqlStmt = sqlStmt + ", " + tariff.grace_time[i];
-			sqlStmt = sqlStmt + ", '" + tariff.min_charge[i] + "'";
-            sqlStmt = sqlStmt + ", '" + tariff.max_charge[i] + "'";
-            sqlStmt = sqlStmt + ", " + tariff.first_free[i];
-            sqlStmt = sqlStmt + ", '" + tariff.first_add[i] + "'";
-            sqlStmt = sqlStmt + ", " + tariff.second_free[i];
-            sqlStmt = sqlStmt + ", '" + tariff.second_add[i] + "'";
-            sqlStmt = sqlStmt + ", " + tariff.third_free[i];
-            sqlStmt = sqlStmt + ", '" + tariff.third_add[i] + "'";
-            sqlStmt = sqlStmt + ", " + tariff.allowance[i];
-        }
-
-        sqlStmt = sqlStmt + ", " + tariff.zone_cutoff;
-        sqlStmt = sqlStmt + ", " + tariff.day_cutoff;
-        sqlStmt = sqlStmt + ", '" + tariff.whole_day_max + "'";
-        sqlStmt = sqlStmt + ", '" + tariff.whole_day_min + "'";
-        sqlStmt = sqlStmt + ", '" + tariff.day_type + "'";
-        sqlStmt = sqlStmt + ")";
-
-        r = localdb->SQLExecutNoneQuery(sqlStmt);
-        if (r != 0)
-        {
-            m_local_db_err_flag = 1;
-            dbss.str("");
-            dbss.clear();
-            dbss << "Insert tariff setup to local failed.";
-            Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-        }
-        else
-        {
-            m_local_db_err_flag = 0;
-        }
-    }
-    catch (const std::exception& e)
-    {
-        r = -1;
-        dbss.str("");
-        dbss.clear();
-        dbss << "DB: local db error in writing rec: " << std::string(e.what());
-        Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-        m_local_db_err_flag = 1;
-    }
-
-    return r;
-}
-
-int db::downloadtarifftypeinfo()
-{
-    int ret = -1;
-    std::vector<ReaderItem> selResult;
-    std::string sqlStmt;
-    std::stringstream dbss;
-    int r = -1;
-    int w = -1;
-
-    r = localdb->SQLExecutNoneQuery("DELETE FROM tariff_type_info");
-    if (r != 0)
-    {
-        m_local_db_err_flag = 1;
-        operation::getInstance()->writelog("Delete tariff_type_info from local failed.", "DB");
-        return ret;
-    }
-    else
-    {
-        m_local_db_err_flag = 0;
-    }
-
-    operation::getInstance()->writelog("Download tariff_type_info.", "DB");
-    r = centraldb->SQLSelect("SELECT * FROM tariff_type_info", &selResult, true);
-    if (r != 0)
-    {
-        m_remote_db_err_flag.store(1);
-        operation::getInstance()->writelog("Download tariff_type_info failed.", "DB");
-        return ret;
-    
-    }
-    else
-    {
-        m_remote_db_err_flag.store(0);
-    }
-
-    int downloadCount = 0;
-    if (selResult.size() > 0)
-    {
-        for (int j = 0; j < selResult.size(); j++)
-        {
-            tariff_type_info_struct tariff_type;
-            tariff_type.tariff_type = selResult[j].GetDataItem(0);
-            tariff_type.start_time = selResult[j].GetDataItem(1);
-            tariff_type.end_time = selResult[j].GetDataItem(2);
-
-            w = writetarifftypeinfo2local(tariff_type);
-
-            if (w == 0)
-            {
-                downloadCount++;
-            }
-        }
-
-        dbss.str("");   // Set the underlying string to an empty string
-        dbss.clear();   // Clear the state of the stream
-        dbss << "Downloading tariff_type_info Records: End, Total Record :" << selResult.size() << " ,Downloaded Record :" << downloadCount;
-    	Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-    }
-
-    if (selResult.size() < 1)
-    {
-        ret = -1;
-    }
-    else
-    {
-        ret = downloadCount;
-    }
-
-    return ret;
-}
-
-int db::writetarifftypeinfo2local(tariff_type_info_struct& tariff_type)
-{
-    int r = -1;
-    std::string sqlStmt;
-    std::stringstream dbss;
-
-    try
-    {
-        sqlStmt = "INSERT INTO tariff_type_info";
-        sqlStmt = sqlStmt + " (tariff_type, start_time, end_time)";
-        sqlStmt = sqlStmt + " VALUES (" + tariff_type.tariff_type;
-        sqlStmt = sqlStmt + ", '" + tariff_type.start_time + "'";
-        sqlStmt = sqlStmt + ", '" + tariff_type.end_time + "'";
-        sqlStmt = sqlStmt + ")";
-
-        r = localdb->SQLExecutNoneQuery(sqlStmt);
-        if (r != 0)
-        {
-            m_local_db_err_flag = 1;
-            dbss.str("");
-            dbss.clear();
-            dbss << "Insert tariff type info to local failed.";
-            Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-        }
-        else
-        {
-            m_local_db_err_flag = 0;
-        }
-    }
-    catch (const std::exception& e)
-    {
-        r = -1;
-        dbss.str("");
-        dbss.clear();
-        dbss << "DB: local db error in writing rec: " << std::string(e.what());
-        Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-        m_local_db_err_flag = 1;
-    }
-
-    return r;
-}
-
-
-
-int db::downloadxtariff(int iGrpID, int iSiteID, int iCheckStatus)
-{
-    int ret = -1;
-    std::vector<ReaderItem> tResult;
-    std::vector<ReaderItem> selResult;
-    std::string sqlStmt;
-    std::stringstream dbss;
-    int r = -1;
-    int w = -1;
-
-    if (iCheckStatus == 1)
-    {
-        // Check x tariff is downloaded or not
-        sqlStmt = "SELECT name FROM parameter_mst ";
-        sqlStmt = sqlStmt + "WHERE name = 'DownloadXTariff' AND s" + std::to_string(operation::getInstance()->gtStation.iSID) + "_fetched=0";
-
-        r = centraldb->SQLSelect(sqlStmt, &tResult, true);
-        if (r != 0)
-        {
-            m_remote_db_err_flag.store(1);
-            operation::getInstance()->writelog("Download X_Tariff failed.", "DB");
-            return ret;
-        }
-        else if (tResult.size() == 0)
-        {
-            m_remote_db_err_flag.store(0);
-            operation::getInstance()->writelog("X_Tariff download already.", "DB");
-            return -3;
-        }
-    }
-
-    r = localdb->SQLExecutNoneQuery("DELETE FROM X_Tariff");
-    if (r != 0)
-    {
-        m_local_db_err_flag = 1;
-        operation::getInstance()->writelog("Delete X_Tariff from local failed.", "DB");
-        return -1;
-    }
-    else
-    {
-        m_local_db_err_flag = 0;
-    }
-
-    operation::getInstance()->writelog("Download X_Tariff for group: " + std::to_string(iGrpID) + ", site: " + std::to_string(iSiteID), "DB");
-    sqlStmt = "";
-    sqlStmt = "SELECT * FROM X_Tariff";
-    sqlStmt = sqlStmt + " WHERE group_id=" + std::to_string(iGrpID) + " AND site_id=" + std::to_string(iSiteID);
-
-    r = centraldb->SQLSelect(sqlStmt, &selResult, true);
-    if (r != 0)
-    {
-        m_remote_db_err_flag.store(1);
-        operation::getInstance()->writelog("Download X_Tariff failed.", "DB");
-        return ret;
-    }
-    else
-    {
-        m_remote_db_err_flag.store(0);
-    }
-
-    int downloadCount = 0;
-    if (selResult.size() > 0)
-    {
-        for (int j = 0; j < selResult.size(); j++)
-        {
-            x_tariff_struct x_tariff;
-            x_tariff.day_index = selResult[j].GetDataItem(2);
-            x_tariff.auto0 = selResult[j].GetDataItem(3);
-            x_tariff.fee0 = selResult[j].GetDataItem(4);
-            x_tariff.time1 = selResult[j].GetDataItem(5);
-            x_tariff.auto1 = selResult[j].GetDataItem(6);
-            x_tariff.fee1 = selResult[j].GetDataItem(7);
-            x_tariff.time2 = selResult[j].GetDataItem(8);
-            x_tariff.auto2 = selResult[j].GetDataItem(9);
-            x_tariff.fee2 = selResult[j].GetDataItem(10);
-            x_tariff.time3 = selResult[j].GetDataItem(11);
-            x_tariff.auto3 = selResult[j].GetDataItem(12);
-            x_tariff.fee3 = selResult[j].GetDataItem(13);
-            x_tariff.time4 = selResult[j].GetDataItem(14);
-            x_tariff.auto4 = selResult[j].GetDataItem(15);
-            x_tariff.fee4 = selResult[j].GetDataItem(16);
-
-            w = writextariff2local(x_tariff);
-
-            if (w == 0)
-            {
-                downloadCount++;
-            }
-        }
-
-        dbss.str("");  // Set the underlying string to an empty string
-        dbss.clear();   // Clear the state of the stream
-        dbss << "Downloading x_tariff Records: End, Total Record :" << selResult.size() << " ,Downloaded Record :" << downloadCount;
-        Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-    }
-
-    if (iCheckStatus == 1)
-    {
-        sqlStmt = "";
-        sqlStmt = "UPDATE parameter_mst set s" + std::to_string(operation::getInstance()->gtStation.iSID) + "_fetched=1";
-        sqlStmt = sqlStmt + " WHERE name='DownloadXTariff'";
-        
-        r = centraldb->SQLExecutNoneQuery(sqlStmt);
-        if (r != 0)
-        {
-            m_remote_db_err_flag.store(1);
-            operation::getInstance()->writelog("Set DownloadXTariff fetched=1 failed.", "DB");
-        }
-    }
-
-    if (selResult.size() < 1)
-    {
-        ret = -1;
-    }
-    else
-    {
-        ret = downloadCount;
-    }
-
-    return ret;
-}
-
-int db::writextariff2local(x_tariff_struct& x_tariff)
-{
-    int r = -1;
-    std::string sqlStmt;
-    std::stringstream dbss;
-
-    try
-    {
-        sqlStmt = "INSERT INTO X_Tariff";
-        sqlStmt = sqlStmt + "(day_index, auto0, fee0, time1, auto1, fee1";
-        sqlStmt = sqlStmt + ", time2, auto2, fee2, time3, auto3, fee3, time4, auto4, fee4";
-        sqlStmt = sqlStmt + ")";
-        sqlStmt = sqlStmt + " VALUES ('" + x_tariff.day_index + "'";
-        sqlStmt = sqlStmt + ", " + x_tariff.auto0;
-        sqlStmt = sqlStmt + ", " + x_tariff.fee0;
-        sqlStmt = sqlStmt + ", '" + x_tariff.time1 + "'";
-        sqlStmt = sqlStmt + ", " + x_tariff.auto1;
-        sqlStmt = sqlStmt + ", " + x_tariff.fee1;
-        sqlStmt = sqlStmt + ", '" + x_tariff.time2 + "'";
-        sqlStmt = sqlStmt + ", " + x_tariff.auto2;
-        sqlStmt = sqlStmt + ", " + x_tariff.fee2;
-        sqlStmt = sqlStmt + ", '" + x_tariff.time3 + "'";
-        sqlStmt = sqlStmt + ", " + x_tariff.auto3;
-        sqlStmt = sqlStmt + ", " + x_tariff.fee3;
-        sqlStmt = sqlStmt + ", '" + x_tariff.time4 + "'";
-        sqlStmt = sqlStmt + ", " + x_tariff.auto4;
-        sqlStmt = sqlStmt + ", " + x_tariff.fee4;
-        sqlStmt = sqlStmt + ")";
-
-        r = localdb->SQLExecutNoneQuery(sqlStmt);
-        if (r != 0)
-        {
-            m_local_db_err_flag = 1;
-            dbss.str("");
-            dbss.clear();
-            dbss << "Insert X_Tariff to local failed.";
-            Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-        }
-        else
-        {
-            m_local_db_err_flag = 0;
-        }
-    }
-    catch (const std::exception& e)
-    {
-        r = -1;
-        dbss.str("");
-        dbss.clear();
-        dbss << "DB: local db error in writing rec: " << std::string(e.what());
-        Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-        m_local_db_err_flag = 1;
-    }
-
-    return r;
-}
-
-int db::downloadholidaymst(int iCheckStatus)
-{
-    int ret = -1;
-    std::vector<ReaderItem> tResult;
-    std::vector<ReaderItem> selResult;
-    std::string sqlStmt;
-    std::stringstream dbss;
-    int r = -1;
-    int w = -1;
-
-    if (iCheckStatus == 1)
-    {
-        // Check Whether holiday mst is downloaded or not
-        sqlStmt = "SELECT name FROM parameter_mst ";
-        sqlStmt = sqlStmt + "WHERE name='DownloadHoliday' AND s" + std::to_string(operation::getInstance()->gtStation.iSID) + "_fetched=0";
-        
-        r = centraldb->SQLSelect(sqlStmt, &tResult, true);
-        if (r != 0)
-        {
-            m_remote_db_err_flag.store(1);
-            operation::getInstance()->writelog("Download holiday_mst failed.", "DB");
-            return ret;
-        }
-        else if (tResult.size() == 0)
-        {
-            m_remote_db_err_flag.store(0);
-            operation::getInstance()->writelog("holiday_mst download already.", "DB");
-            return -3;
-        }
-    }
-
-    operation::getInstance()->writelog("Download holiday_mst.", "DB");
-    sqlStmt = "";
-    sqlStmt = "SELECT holiday_date, descrip";
-    sqlStmt = sqlStmt + " FROM holiday_mst ";
-    sqlStmt = sqlStmt + "WHERE holiday_date > GETDATE() - 30";
-
-    r = centraldb->SQLSelect(sqlStmt, &selResult, true);
-    if (r != 0)
-    {
-        m_remote_db_err_flag.store(1);
-        operation::getInstance()->writelog("Download holiday_mst failed.", "DB");
-        return ret;
-    }
-    else
-    {
-        m_remote_db_err_flag.store(0);
-    }
-
-    int downloadCount = 0;
-
-    if (selResult.size() > 0)
-    {
-       	ClearHoliday();
-
-	    for (int j = 0; j < selResult.size(); j++)
-        {
-            w = writeholidaymst2local(selResult[j].GetDataItem(0), selResult[j].GetDataItem(1));
-
-            if (w == 0)
-            {
-                downloadCount++;
-			}
-        }
-
-        dbss.str("");  // Set the underlying string to an empty string
-    	dbss.clear();   // Clear the state of the stream
-		dbss << "Downloading holiday_mst Records: End, Total Record :" << selResult.size() << " ,Downloaded Record :" << downloadCount;
-    	Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-    }
-
-    if (iCheckStatus == 1)
-    {
-        sqlStmt = "";
-        sqlStmt = "UPDATE parameter_mst set s" + std::to_string(operation::getInstance()->gtStation.iSID) + "_fetched=1";
-        sqlStmt = sqlStmt + " WHERE name='DownloadHoliday'";
-
-        r = centraldb->SQLExecutNoneQuery(sqlStmt);
-        if (r != 0)
-        {
-            m_remote_db_err_flag.store(1);
-            operation::getInstance()->writelog("Set DownloadHoliday fetched=1 failed.", "DB");
-        }
-    }
-
-    if (selResult.size() < 1)
-    {
-        ret = -1;
-    }
-    else
-    {
-        ret = downloadCount;
-    }
-
-    return ret;
-}
-
-int db::writeholidaymst2local(std::string holiday_date, std::string descrip)
-{
-    int r = -1;
-    std::string sqlStmt;
-    std::stringstream dbss;
-
-    try
-    {
-        sqlStmt = "INSERT INTO holiday_mst";
-        sqlStmt = sqlStmt + " (holiday_date, descrip)";
-        sqlStmt = sqlStmt + " VALUES ('" + holiday_date + "'";
-        sqlStmt = sqlStmt + ", '" + descrip + "')";
-
-        r = localdb->SQLExecutNoneQuery(sqlStmt);
-        if (r != 0)
-        {
-            m_local_db_err_flag = 1;
-            dbss.str("");
-            dbss.clear();
-            dbss << "Insert holiday to local failed.";
-            Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-        }
-        else
-        {
-            m_local_db_err_flag = 0;
-        }
-    }
-    catch (const std::exception& e)
-    {
-        r = -1;
-        dbss.str("");
-        dbss.clear();
-        dbss << "DB: local db error in writing rec: " << std::string(e.what());
-        Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-        m_local_db_err_flag = 1;
-    }
-
-    return r;
-}
-
-int db::download3tariffinfo()
-{
-    int ret = -1;
-    std::vector<ReaderItem> selResult;
-    std::string sqlStmt;
-    std::stringstream dbss;
-    int r = -1;
-    int w = -1;
-
-    r = localdb->SQLExecutNoneQuery("DELETE FROM 3Tariff_Info");
-    if (r != 0)
-    {
-        m_local_db_err_flag = 1;
-        operation::getInstance()->writelog("Delete 3Tariff_Info from local failed.", "DB");
-        return -1;
-    }
-    else
-    {
-        m_local_db_err_flag = 0;
-    }
-
-    int zone_id = operation::getInstance()->gtStation.iZoneID;
-    operation::getInstance()->writelog("Download 3Tariff_Info.", "DB");
-    sqlStmt = "";
-    sqlStmt = "SELECT * FROM [3Tariff_Info]";
-    sqlStmt = sqlStmt + " WHERE Zone_ID='" + std::to_string(zone_id) + "'";
-    sqlStmt = sqlStmt + " OR Zone_ID LIKE '" + std::to_string(zone_id) + ",%'";
-    sqlStmt = sqlStmt + " OR Zone_ID LIKE '%," + std::to_string(zone_id) + ",%'";
-    sqlStmt = sqlStmt + " OR Zone_ID LIKE '%," + std::to_string(zone_id) + "'";
-
-    r = centraldb->SQLSelect(sqlStmt, &selResult, true);
-    if (r != 0)
-    {
-        m_remote_db_err_flag.store(1);
-        operation::getInstance()->writelog("Download 3Tariff_Info failed.", "DB");
-        return ret;
-    }
-    else
-    {
-        m_remote_db_err_flag.store(0);
-    }
-
-    int downloadCount = 0;
-    if (selResult.size() > 0)
-    {
-        for (int j = 0; j < selResult.size(); j++)
-        {
-            tariff_info_struct tariff_info;
-            tariff_info.rate_type = selResult[j].GetDataItem(1);
-            tariff_info.day_type = selResult[j].GetDataItem(2);
-            tariff_info.time_from = selResult[j].GetDataItem(3);
-            tariff_info.time_till = selResult[j].GetDataItem(4);
-            tariff_info.t3_start = selResult[j].GetDataItem(5);
-            tariff_info.t3_block = selResult[j].GetDataItem(6);
-            tariff_info.t3_rate = selResult[j].GetDataItem(7);
-
-            w = write3tariffinfo2local(tariff_info);
-
-            if (w == 0)
-            {
-                downloadCount++;
-            }
-        }
-
-        dbss.str("");  // Set the underlying string to an empty string
-    	dbss.clear();   // Clear the state of the stream
-		dbss << "Downloading 3Tariff_Info Records: End, Total Record :" << selResult.size() << " ,Downloaded Record :" << downloadCount;
-    	Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-    }
-
-    if (selResult.size() < 1)
-    {
-        ret = -1;
-    }
-    else
-    {
-        ret = downloadCount;
-    }
-
-    return ret;
-}
-
-int db::write3tariffinfo2local(tariff_info_struct& tariff_info)
-{
-    int r = -1;
-    std::string sqlStmt;
-    std::stringstream dbss;
-
-    try
-    {
-        sqlStmt = "INSERT INTO 3Tariff_Info";
-        sqlStmt = sqlStmt + " (Rate_Type, Day_Type, Time_From, Time_Till, T3_Start, T3_Block, T3_Rate)";
-        sqlStmt = sqlStmt + " VALUES(" + tariff_info.rate_type;
-        sqlStmt = sqlStmt + ", '" + tariff_info.day_type + "'";
-        sqlStmt = sqlStmt + ", '" + tariff_info.time_from + "'";
-        sqlStmt = sqlStmt + ", '" + tariff_info.time_till + "'";
-        sqlStmt = sqlStmt + ", " + tariff_info.t3_start;
-        sqlStmt = sqlStmt + ", " + tariff_info.t3_block;
-        sqlStmt = sqlStmt + ", " + tariff_info.t3_rate + ")";
-
-        r = localdb->SQLExecutNoneQuery(sqlStmt);
-        if (r != 0)
-        {
-            m_local_db_err_flag = 1;
-            dbss.str("");
-            dbss.clear();
-            dbss << "Insert 3Tariff_Info to local failed.";
-            Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-        }
-        else
-        {
-            m_local_db_err_flag = 0;
-        }
-    }
-    catch (const std::exception& e)
-    {
-        r = -1;
-        dbss.str("");
-        dbss.clear();
-        dbss << "DB: local db error in writing rec: " << std::string(e.what());
-        Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-        m_local_db_err_flag = 1;
-    }
-
-    return r;
-}
-
-int db::downloadratefreeinfo(int iCheckStatus)
-{
-    int ret = -1;
-    std::vector<ReaderItem> tResult;
-    std::vector<ReaderItem> selResult;
-    std::string sqlStmt;
-    std::stringstream dbss;
-    int r = -1;
-    int w = -1;
-
-    if (iCheckStatus == 1)
-    {
-        // Check Whether rate free info is downloaded or not
-        sqlStmt = "SELECT name FROM parameter_mst";
-        sqlStmt = sqlStmt + " WHERE name='DownloadRateFreeInfo' AND s" + std::to_string(operation::getInstance()->gtStation.iSID) + "_fetched=0";
-
-        r = centraldb->SQLSelect(sqlStmt, &tResult, true);
-        if (r != 0)
-        {
-            m_remote_db_err_flag.store(1);
-            operation::getInstance()->writelog("Download Rate_Free_Info failed.", "DB");
-            return ret;
-        }
-        else if (tResult.size() == 0)
-        {
-            m_remote_db_err_flag.store(0);
-            operation::getInstance()->writelog("Rate_Free_Info download already.", "DB");
-            return -3;
-        }
-    }
-
-    r = localdb->SQLExecutNoneQuery("DELETE FROM Rate_Free_Info");
-    if (r != 0)
-    {
-        m_local_db_err_flag = 1;
-        operation::getInstance()->writelog("Delete Rate_Free_Info from local failed.", "DB");
-        return -1;
-    }
-    else
-    {
-        m_local_db_err_flag = 0;
-    }
-
-    int zone_id = operation::getInstance()->gtStation.iZoneID;
-    operation::getInstance()->writelog("Download Rate_Free_Info.", "DB");
-    sqlStmt = "";
-    sqlStmt = "SELECT Rate_Type, Day_Type, Init_Free, Free_Beg, Free_End, Free_Time FROM Rate_Free_Info";
-    sqlStmt = sqlStmt + " WHERE Zone_ID='" + std::to_string(zone_id) + "'";
-    sqlStmt = sqlStmt + " OR Zone_ID LIKE '" + std::to_string(zone_id) + ",%'";
-    sqlStmt = sqlStmt + " OR Zone_ID LIKE '%," + std::to_string(zone_id) + ",%'";
-    sqlStmt = sqlStmt + " OR Zone_ID LIKE '%," + std::to_string(zone_id) + "'";
-
-    r = centraldb->SQLSelect(sqlStmt, &selResult, true);
-    if (r != 0)
-    {
-        m_remote_db_err_flag.store(1);
-        operation::getInstance()->writelog("Download Rate_Free_Info failed.", "DB");
-        return ret;
-    }
-    else
-    {
-        m_remote_db_err_flag.store(0);
-    }
-
-    int downloadCount = 0;
-    if (selResult.size() > 0)
-    {
-        for (int j = 0; j < selResult.size(); j++)
-        {
-            rate_free_info_struct rate_free_info;
-            rate_free_info.rate_type = selResult[j].GetDataItem(0);
-            rate_free_info.day_type = selResult[j].GetDataItem(1);
-            rate_free_info.init_free = selResult[j].GetDataItem(2);
-            rate_free_info.free_beg = selResult[j].GetDataItem(3);
-            rate_free_info.free_end = selResult[j].GetDataItem(4);
-            rate_free_info.free_time = selResult[j].GetDataItem(5);
-
-            w = writeratefreeinfo2local(rate_free_info);
-
-            if (w == 0)
-            {
-                downloadCount++;
-            }
-        }
-
-        dbss.str("");  // Set the underlying string to an empty string
-    	dbss.clear();   // Clear the state of the stream
-		dbss << "Downloading Rate_Free_Info Records: End, Total Record :" << selResult.size() << " ,Downloaded Record :" << downloadCount;
-    	Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-    }
-
-    if (iCheckStatus == 1)
-    {
-        sqlStmt = "";
-        sqlStmt = "UPDATE parameter_mst set s" + std::to_string(operation::getInstance()->gtStation.iSID) + "_fetched=1";
-        sqlStmt = sqlStmt + " WHERE name='DownloadRateFreeInfo'";
-
-        r = centraldb->SQLExecutNoneQuery(sqlStmt);
-        if (r != 0)
-        {
-            m_remote_db_err_flag.store(1);
-            operation::getInstance()->writelog("Set DownloadRateFreeInfo fetched = 1 failed.", "DB");
-        }
-    }
-
-    if (selResult.size() < 1)
-    {
-        ret = -1;
-    }
-    else
-    {
-        ret = downloadCount;
-    }
-
-    return ret;
-}
-
-int db::writeratefreeinfo2local(rate_free_info_struct& rate_free_info)
-{
-    int r = -1;
-    std::string sqlStmt;
-    std::stringstream dbss;
-
-    try
-    {
-        sqlStmt = "INSERT INTO Rate_Free_Info";
-        sqlStmt = sqlStmt + " (Rate_Type, Day_Type, Init_Free, Free_Beg, Free_End, Free_Time)";
-        sqlStmt = sqlStmt + " VALUES (" + rate_free_info.rate_type;
-        sqlStmt = sqlStmt + ", '" + rate_free_info.day_type + "'";
-        sqlStmt = sqlStmt + ", " + rate_free_info.init_free;
-        sqlStmt = sqlStmt + ", '" + rate_free_info.free_beg + "'";
-        sqlStmt = sqlStmt + ", '" + rate_free_info.free_end + "'";
-        sqlStmt = sqlStmt + ", " + rate_free_info.free_time + ")";
-
-        r = localdb->SQLExecutNoneQuery(sqlStmt);
-        if (r != 0)
-        {
-            m_local_db_err_flag = 1;
-            dbss.str("");
-            dbss.clear();
-            dbss << "Insert Rate_Free_Info to local failed.";
-            Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-        }
-        else
-        {
-            m_local_db_err_flag = 0;
-        }
-    }
-    catch (const std::exception& e)
-    {
-        r = -1;
-        dbss.str("");
-        dbss.clear();
-        dbss << "DB: local db error in writing rec: " << std::string(e.what());
-        Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-        m_local_db_err_flag = 1;
-    }
-
-    return r;
-}
-
-int db::downloadspecialdaymst(int iCheckStatus)
-{
-    int ret = -1;
-    std::vector<ReaderItem> tResult;
-    std::vector<ReaderItem> selResult;
-    std::string sqlStmt;
-    std::stringstream dbss;
-    int r = -1;
-    int w = -1;
-
-    if (iCheckStatus == 1)
-    {
-        // Check Whether special day mst is downloaded or not
-        sqlStmt = "SELECT name FROM parameter_mst";
-        sqlStmt = sqlStmt + " WHERE name='DownloadSpecialDay' AND s" + std::to_string(operation::getInstance()->gtStation.iSID) + "_fetched=0";
-
-        r = centraldb->SQLSelect(sqlStmt, &tResult, true);
-        if (r != 0)
-        {
-            m_remote_db_err_flag.store(1);
-            operation::getInstance()->writelog("Download Special_Day_mst failed.", "DB");
-            return ret;
-        }
-        else if (tResult.size() == 0)
-        {
-            m_remote_db_err_flag.store(0);
-            operation::getInstance()->writelog("Special_Day_mst download already.", "DB");
-            return -3;
-        }
-    }
-
-    r = localdb->SQLExecutNoneQuery("DELETE FROM Special_Day_mst");
-    if (r != 0)
-    {
-        m_local_db_err_flag = 1;
-        operation::getInstance()->writelog("Delete Special_Day_mst from local failed.", "DB");
-        return -1;
-    }
-    else
-    {
-        m_local_db_err_flag = 0;
-    }
-
-    int zone_id = operation::getInstance()->gtStation.iZoneID;
-    operation::getInstance()->writelog("Download Special_Day_mst.", "DB");
-    sqlStmt = "";
-    sqlStmt = "SELECT convert(char(10),Special_Date,103), Rate_Type, Day_Code FROM Special_Day_mst";
-    sqlStmt = sqlStmt + " WHERE Special_Date > getdate()-1 AND (";
-	sqlStmt = sqlStmt + " Zone_ID='" + std::to_string(zone_id) + "'";
-    sqlStmt = sqlStmt + " OR Zone_ID LIKE '" + std::to_string(zone_id) + ",%'";
-    sqlStmt = sqlStmt + " OR Zone_ID LIKE '%," + std::to_string(zone_id) + ",%'";
-    sqlStmt = sqlStmt + " OR Zone_ID LIKE '%," + std::to_string(zone_id) + "'";
-	sqlStmt = sqlStmt + ")";
-
-    r = centraldb->SQLSelect(sqlStmt, &selResult, true);
-    if (r != 0)
-    {
-        m_remote_db_err_flag.store(1);
-        operation::getInstance()->writelog("Download Special_Day_mst failed.", "DB");
-        return ret;
-    }
-    else
-    {
-        m_remote_db_err_flag.store(0);
-    }
-
-    int downloadCount = 0;
-    if (selResult.size() > 0)
-    {
-        for (int j = 0; j < selResult.size(); j++)
-        {
-            w = writespecialday2local(selResult[j].GetDataItem(0), selResult[j].GetDataItem(1), selResult[j].GetDataItem(2));
-
-            if (w == 0)
-            {
-                downloadCount++;
-            }
-        }
-
-        dbss.str("");  // Set the underlying string to an empty string
-    	dbss.clear();   // Clear the state of the stream
-		dbss << "Downloading Special_Day_mst Records: End, Total Record :" << selResult.size() << " ,Downloaded Record :" << downloadCount;
-    	Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-    }
-
-    if (iCheckStatus == 1)
-    {
-        sqlStmt = "";
-        sqlStmt = "UPDATE parameter_mst set s" + std::to_string(operation::getInstance()->gtStation.iSID) + "_fetched=1";
-        sqlStmt = sqlStmt + " WHERE name='DownloadSpecialDay'";
-
-        r = centraldb->SQLExecutNoneQuery(sqlStmt);
-        if (r != 0)
-        {
-            m_remote_db_err_flag.store(1);
-            operation::getInstance()->writelog("Set DownloadSpecialDay fetched=1 failed.", "DB");
-        }
-    }
-
-    if (selResult.size() < 1)
-    {
-        ret = -1;
-    }
-    else
-    {
-        ret = downloadCount;
-    }
-
-    return ret;
-}
-
-int db::writespecialday2local(std::string special_date, std::string rate_type, std::string day_code)
-{
-    int r = -1;
-    std::string sqlStmt;
-    std::stringstream dbss;
-
-    try
-    {
-        sqlStmt = "INSERT INTO Special_Day_mst";
-        sqlStmt = sqlStmt + " (Special_Date, Rate_Type, Day_Code)";
-        sqlStmt = sqlStmt + " VALUES('" + special_date + "'";
-        sqlStmt = sqlStmt + ", " + rate_type;
-        sqlStmt = sqlStmt + ", '" + day_code + "')";
-
-        r = localdb->SQLExecutNoneQuery(sqlStmt);
-        if (r != 0)
-        {
-            m_local_db_err_flag = 1;
-            dbss.str("");
-            dbss.clear();
-            dbss << "Insert Special_Day_mst to local failed.";
-            Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-        }
-        else
-        {
-            m_local_db_err_flag = 0;
-        }
-    }
-    catch (const std::exception& e)
-    {
-        r = -1;
-        dbss.str("");
-        dbss.clear();
-        dbss << "DB: local db error in writing rec: " << std::string(e.what());
-        Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-        m_local_db_err_flag = 1;
-    }
-
-    return r;
-}
-
-int db::downloadratetypeinfo(int iCheckStatus)
-{
-    int ret = -1;
-    std::vector<ReaderItem> tResult;
-    std::vector<ReaderItem> selResult;
-    std::string sqlStmt;
-    std::stringstream dbss;
-    int r = -1;
-    int w = -1;
-
-    if (iCheckStatus == 1)
-    {
-        // Check Whether rate type infor is downloaded or not
-        sqlStmt = "SELECT name FROM parameter_mst";
-        sqlStmt = sqlStmt + " WHERE name='DownloadRateTypeInfo' AND s" + std::to_string(operation::getInstance()->gtStation.iSID) + "_fetched=0";
-
-        r = centraldb->SQLSelect(sqlStmt, &selResult, true);
-        if (r != 0)
-        {
-            m_remote_db_err_flag.store(1);
-            operation::getInstance()->writelog("Download Rate_Type_Info failed.", "DB");
-            return ret;
-        }
-        else if (selResult.size() == 0)
-        {
-            m_remote_db_err_flag.store(0);
-            operation::getInstance()->writelog("Rate_Type_Info download already.", "DB");
-            return -3;
-        }
-    }
-
-    r = localdb->SQLExecutNoneQuery("DELETE FROM Rate_Type_Info");
-    if (r != 0)
-    {
-        m_local_db_err_flag = 1;
-        operation::getInstance()->writelog("Delete Rate_Type_Info from local failed.", "DB");
-        return -1;
-    }
-    else
-    {
-        m_local_db_err_flag = 0;
-    }
-
-    int zone_id = operation::getInstance()->gtStation.iZoneID;
-    operation::getInstance()->writelog("Download Rate_Type_Info.", "DB");
-    sqlStmt = "";
-    sqlStmt = "SELECT Rate_Type, Has_Holiday, Has_Holiday_Eve, Has_Special_Day, Has_Init_Free, Has_3Tariff, Has_Zone_Max FROM Rate_Type_Info";
-    sqlStmt = sqlStmt + " WHERE Zone_ID='" + std::to_string(zone_id) + "'";
-    sqlStmt = sqlStmt + " OR Zone_ID LIKE '" + std::to_string(zone_id) + ",%'";
-    sqlStmt = sqlStmt + " OR Zone_ID LIKE '%," + std::to_string(zone_id) + ",%'";
-    sqlStmt = sqlStmt + " OR Zone_ID LIKE '%," + std::to_string(zone_id) + "'";
-
-    r = centraldb->SQLSelect(sqlStmt, &selResult, true);
-    if (r != 0)
-    {
-        m_remote_db_err_flag.store(1);
-        operation::getInstance()->writelog("Donwload Rate_Type_Info failed.", "DB");
-        return ret;
-    }
-    else
-    {
-        m_remote_db_err_flag.store(0);
-    }
-
-    int downloadCount = 0;
-    if (selResult.size() > 0)
-    {
-        for (int j = 0; j < selResult.size(); j++)
-        {
-            rate_type_info_struct rate_type_info;
-            rate_type_info.rate_type = selResult[j].GetDataItem(0);
-            rate_type_info.has_holiday = selResult[j].GetDataItem(1);
-            rate_type_info.has_holiday_eve = selResult[j].GetDataItem(2);
-            rate_type_info.has_special_day = selResult[j].GetDataItem(3);
-            rate_type_info.has_init_free = selResult[j].GetDataItem(4);
-            rate_type_info.has_3tariff = selResult[j].GetDataItem(5);
-            rate_type_info.has_zone_max = selResult[j].GetDataItem(6);
-            //rate_type_info.has_firstentry_rate = selResult[j].GetDataItem(7);
-
-            w = writeratetypeinfo2local(rate_type_info);
-
-            if (w == 0)
-            {
-                downloadCount++;
-            }
-        }
-
-        dbss.str("");  // Set the underlying string to an empty string
-    	dbss.clear();   // Clear the state of the stream
-		dbss << "Downloading Rate_Type_Info Records: End, Total Record :" << selResult.size() << " ,Downloaded Record :" << downloadCount;
-    	Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-    }
-
-    if (iCheckStatus == 1)
-    {
-        sqlStmt = "";
-        sqlStmt = "UPDATE parameter_mst set s" + std::to_string(operation::getInstance()->gtStation.iSID) + "_fetched=1";
-        sqlStmt = sqlStmt + " WHERE name='DownloadRateTypeInfo'";
-
-        r = centraldb->SQLExecutNoneQuery(sqlStmt);
-        if (r != 0)
-        {
-            m_remote_db_err_flag.store(1);
-            operation::getInstance()->writelog("Set DownloadRateTypeInfo fetched = 1 failed.", "DB");
-        }
-    }
-
-    if (selResult.size() < 1)
-    {
-        ret = -1;
-    }
-    else
-    {
-        ret = downloadCount;
-    }
-
-    return ret;
-}
-
-int db::writeratetypeinfo2local(rate_type_info_struct rate_type_info)
-{
-    int r = -1;
-    std::string sqlStmt;
-    std::stringstream dbss;
-
-    try
-    {
-        sqlStmt = "INSERT INTO Rate_Type_Info";
-        sqlStmt = sqlStmt + " (Rate_Type, Has_Holiday, Has_Holiday_Eve, Has_Special_Day, Has_Init_Free, Has_3Tariff, Has_Zone_Max)";
-        sqlStmt = sqlStmt + " VALUES(" + rate_type_info.rate_type;
-        sqlStmt = sqlStmt + ", " + rate_type_info.has_holiday;
-        sqlStmt = sqlStmt + ", " + rate_type_info.has_holiday_eve;
-        sqlStmt = sqlStmt + ", " + rate_type_info.has_special_day;
-        sqlStmt = sqlStmt + ", " + rate_type_info.has_init_free;
-        sqlStmt = sqlStmt + ", " + rate_type_info.has_3tariff;
-        sqlStmt = sqlStmt + ", " + rate_type_info.has_zone_max;
-        sqlStmt = sqlStmt + ")";
-
-        r = localdb->SQLExecutNoneQuery(sqlStmt);
-        if (r != 0)
-        {
-            m_local_db_err_flag = 1;
-            dbss.str();
-            dbss.clear();
-            dbss << "Insert Rate_Type_Info to local failed.";
-            Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-        }
-        else
-        {
-            m_local_db_err_flag = 0;
-        }
-    }
-    catch (const std::exception& e)
-    {
-        r = -1;
-        dbss.str("");
-        dbss.clear();
-        dbss << "DB: local db error in writing rec: " << std::string(e.what());
-        Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-        m_local_db_err_flag = 1;
-    }
-
-    return r;
-}
-
-int db::downloadratemaxinfo(int iCheckStatus)
-{
-    int ret = -1;
-    std::vector<ReaderItem> tResult;
-    std::vector<ReaderItem> selResult;
-    std::string sqlStmt;
-    std::stringstream dbss;
-    int r = -1;
-    int w = -1;
-
-    if (iCheckStatus == 1)
-    {
-        // Check Whether rate max info is downloaded or not
-        sqlStmt = "SELECT name FROM parameter_mst";
-        sqlStmt = sqlStmt + " WHERE name='DownloadRateMaxInfo' AND s" + std::to_string(operation::getInstance()->gtStation.iSID) + "_fetched=0";
-
-        r = centraldb->SQLSelect(sqlStmt, &selResult, true);
-        if (r != 0)
-        {
-            m_remote_db_err_flag.store(1);
-            operation::getInstance()->writelog("Download Rate_Max_Info failed.", "DB");
-            return ret;
-        }
-        else if (selResult.size() == 0)
-        {
-            m_remote_db_err_flag.store(0);
-            operation::getInstance()->writelog("Rate_Max_Info download already.", "DB");
-            return -3;
-        }
-    }
-
-    r = localdb->SQLExecutNoneQuery("DELETE FROM Rate_Max_Info");
-    if (r != 0)
-    {
-        m_local_db_err_flag = 1;
-        operation::getInstance()->writelog("Delete Rate_Max_Info from local failed.", "DB");
-        return -1;
-    }
-    else
-    {
-        m_local_db_err_flag = 0;
-    }
-
-    int zone_id = operation::getInstance()->gtStation.iZoneID;
-    operation::getInstance()->writelog("Download Rate_Max_Info.", "DB");
-    sqlStmt = "";
-    sqlStmt = "Select Rate_Type, Day_Type, Start_Time, End_Time, Max_Fee FROM Rate_Max_Info";
-    sqlStmt = sqlStmt + " WHERE Zone_ID='" + std::to_string(zone_id) + "'";
-    sqlStmt = sqlStmt + " OR Zone_ID LIKE '" + std::to_string(zone_id) + ",%'";
-    sqlStmt = sqlStmt + " OR Zone_ID LIKE '%," + std::to_string(zone_id) + ",%'";
-    sqlStmt = sqlStmt + " OR Zone_ID LIKE '%," + std::to_string(zone_id) + "'";
-
-    r = centraldb->SQLSelect(sqlStmt, &selResult, true);
-    if (r != 0)
-    {
-        m_remote_db_err_flag.store(1);
-        operation::getInstance()->writelog("Donwload Rate_Max_Info failed.", "DB");
-        return ret;
-    }
-    else
-    {
-        m_remote_db_err_flag.store(0);
-    }
-
-    int downloadCount = 0;
-    if (selResult.size() > 0)
-    {
-        for (int j = 0; j < selResult.size(); j++)
-        {
-            rate_max_info_struct rate_max_info;
-            rate_max_info.rate_type = selResult[j].GetDataItem(0);
-            rate_max_info.day_type = selResult[j].GetDataItem(1);
-            rate_max_info.start_time = selResult[j].GetDataItem(2);
-            rate_max_info.end_time = selResult[j].GetDataItem(3);
-            rate_max_info.max_fee = selResult[j].GetDataItem(4);
-
-            w = writeratemaxinfo2local(rate_max_info);
-
-            if (w == 0)
-            {
-                downloadCount++;
-            }
-        }
-
-        dbss.str("");  // Set the underlying string to an empty string
-    	dbss.clear();   // Clear the state of the stream
-		dbss << "Downloading Rate_Max_Info Records: End, Total Record :" << selResult.size() << " ,Downloaded Record :" << downloadCount;
-    	Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-    }
-
-    if (iCheckStatus == 1)
-    {
-        sqlStmt = "";
-        sqlStmt = "UPDATE parameter_mst set s" + std::to_string(operation::getInstance()->gtStation.iSID) + "_fetched=1";
-        sqlStmt = sqlStmt + " WHERE name='DownloadRateMaxInfo'";
-
-        r = centraldb->SQLExecutNoneQuery(sqlStmt);
-        if (r != 0)
-        {
-            m_remote_db_err_flag.store(1);
-            operation::getInstance()->writelog("Set DownloadRateMaxInfo fetched = 1 failed.", "DB");
-        }
-    }
-
-    if (selResult.size() < 1)
-    {
-        ret = -1;
-    }
-    else
-    {
-        ret = downloadCount;
-    }
-
-    return ret;
-}
-
-int db::writeratemaxinfo2local(rate_max_info_struct rate_max_info)
-{
-    int r = -1;
-    std::string sqlStmt;
-    std::stringstream dbss;
-
-    try
-    {
-        sqlStmt = "INSERT INTO Rate_Max_Info";
-        sqlStmt = sqlStmt + " (Rate_Type, Day_Type, Start_Time, End_Time, Max_Fee)";
-        sqlStmt = sqlStmt + " VALUES(" + rate_max_info.rate_type;
-        sqlStmt = sqlStmt + ", '" + rate_max_info.day_type + "'";
-        sqlStmt = sqlStmt + ", '" + rate_max_info.start_time + "'";
-        sqlStmt = sqlStmt + ", '" + rate_max_info.end_time + "'";
-        sqlStmt = sqlStmt + ", " + rate_max_info.max_fee;
-        sqlStmt = sqlStmt + ")";
-
-        r = localdb->SQLExecutNoneQuery(sqlStmt);
-        if (r != 0)
-        {
-            m_local_db_err_flag = 1;
-            dbss.str();
-            dbss.clear();
-            dbss << "Insert Rate_Type_Info to local failed.";
-            Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-        }
-        else
-        {
-            m_local_db_err_flag = 0;
-        }
-    }
-    catch (const std::exception& e)
-    {
-        r = -1;
-        dbss.str("");
-        dbss.clear();
-        dbss << "DB: local db error in writing rec: " << std::string(e.what());
-        Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-        m_local_db_err_flag = 1;
-    }
-
-    return r;
-}
-
-DBError db::loadstationsetup()
-{
-	vector<ReaderItem> selResult;
-	int r = -1;
-	int giStnid;
-	giStnid = operation::getInstance()->gtStation.iSID;
-
-	r = localdb->SQLSelect("SELECT * FROM Station_Setup WHERE StationId = '" + std::to_string(giStnid) + "'", &selResult, false);
-
-	if (r != 0)
-	{
-		operation::getInstance()->writelog("get station set up fail.", "DB");
-		return iLocalFail;
-	}
-
-	if (selResult.size() > 0)
-	{            
-		//Set configuration
-		operation::getInstance()->gtStation.iSID = std::stoi(selResult[0].GetDataItem(0));
-		operation::getInstance()->gtStation.sName = selResult[0].GetDataItem(1);
-		switch (std::stoi(selResult[0].GetDataItem(2)))
-		{
-		case 1:
-			operation::getInstance()->gtStation.iType = tientry;
-			break;
-		case 2:
-			operation::getInstance()->gtStation.iType = tiExit;
-			break;
-		default:
-			break;
-		};
-		operation::getInstance()->gtStation.iStatus = std::stoi(selResult[0].GetDataItem(3));
-		operation::getInstance()->gtStation.sPCName = selResult[0].GetDataItem(4);
-		operation::getInstance()->gtStation.iCHUPort = std::stoi(selResult[0].GetDataItem(5));
-		operation::getInstance()->gtStation.iAntID = std::stoi(selResult[0].GetDataItem(6));
-		operation::getInstance()->gtStation.iZoneID = std::stoi(selResult[0].GetDataItem(7));
-		operation::getInstance()->gtStation.iIsVirtual = std::stoi(selResult[0].GetDataItem(8));
-		switch(std::stoi(selResult[0].GetDataItem(9)))
-		{
-		case 0:
-			operation::getInstance()->gtStation.iSubType = iNormal;
-			break;
-		case 1:
-			operation::getInstance()->gtStation.iSubType = iXwithVENoPay;
-			break;
-		case 2:
-			operation::getInstance()->gtStation.iSubType = iXwithVEPay;
-			break;
-		default:
-			break;
-		};
-		operation::getInstance()->gtStation.iVirtualID = std::stoi(selResult[0].GetDataItem(10));
-		operation::getInstance()->tProcess.gbloadedStnSetup = true;
-		return iDBSuccess;
-	}
-
-	return iNoData; 
-};
-
-int db::downloadTR()
-{
-	int ret = -1;
-	int r = -1;
-	int w = -1;
-	std::vector<ReaderItem> tResult;
-	std::vector<ReaderItem> selResult;
-	std::string sqlStmt;
-	std::stringstream dbss;
-	int tr_type;
-	int line_no;
-	int enabled;
-	std::string line_text;
-	std::string line_var;
-	int line_font;
-	int line_align;
-
-	sqlStmt = "SELECT COUNT(*) from TR_mst ";
-	sqlStmt = sqlStmt + "where TRType = 1 or TRType = 2 or TRType = 6 or TRType = 11 or TRType = 12";
-
-	r = centraldb->SQLSelect(sqlStmt, &tResult, false);
-	if (r != 0)
-	{
-		m_remote_db_err_flag.store(1);
-		operation::getInstance()->writelog("download TR fail.", "DB");
-		return ret;
-	}
-	else
-	{
-		m_remote_db_err_flag.store(0);
-		dbss.str("");
-		dbss.clear();
-		dbss << "Total " << std::string(tResult[0].GetDataItem(0)) << " TR type to be download.";
-		Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-	}
-
-	sqlStmt = "";
-	sqlStmt.clear();
-	sqlStmt = "SELECT TRType, Line_no, Enabled, LineText, LineVar, LineFont, LineAlign from TR_mst ";
-	sqlStmt = sqlStmt + "where TRType = 1 or TRType = 2 or TRType = 6 or TRType = 11 or TRType = 12";
-	r = centraldb->SQLSelect(sqlStmt, &selResult, true);
-	if (r != 0)
-	{
-		m_remote_db_err_flag.store(1);
-		operation::getInstance()->writelog("download TR faile.", "DB");
-		return ret;
-	}
-	else
-	{
-		m_remote_db_err_flag.store(0);
-	}
-
-	int downloadCount = 0;
-	if (selResult.size() > 0)
-	{
-		dbss.str("");
-		dbss.clear();
-		dbss << "Downloading TR " << std::to_string(selResult.size()) << " Records: Started";
-		Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-
-		for (int j = 0; j < selResult.size(); j++)
-		{
-			tr_type = std::stoi(selResult[j].GetDataItem(0));
-			line_no = std::stoi(selResult[j].GetDataItem(1));
-			enabled = std::stoi(selResult[j].GetDataItem(2));
-			line_text = selResult[j].GetDataItem(3);
-			line_var = selResult[j].GetDataItem(4);
-			line_font = std::stoi(selResult[j].GetDataItem(5));
-			line_align = std::stoi(selResult[j].GetDataItem(6));
-
-			w = writetr2local(tr_type, line_no, enabled, line_text, line_var, line_font, line_align);
-
-			if (w == 0)
-			{
-				downloadCount++;
-				m_remote_db_err_flag.store(0);
-			}
-		}
-		dbss.str("");
-		dbss.clear();
-		dbss << "Downloading TR Records, End, Total Record :" << selResult.size() << " , Downloaded Record :" << downloadCount;
-		Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-	}
-
-	ret = downloadCount;
-
-	return ret;
-}
-
-int db::writetr2local(int tr_type, int line_no, int enabled, std::string line_text, std::string line_var, int line_font, int line_align)
-{
-	int r = -1;
-	int debug = 0;
-	std::string sqlStmt;
-	vector<ReaderItem> selResult;
-	std::stringstream dbss;
-
-	try
-	{
-		r = localdb->SQLSelect("SELECT * FROM TR_mst where TRType =" + std::to_string(tr_type) + " and Line_no = " + std::to_string(line_no), &selResult, false);
-		if (r != 0)
-		{
-			m_local_db_err_flag = 1;
-			operation::getInstance()->writelog("Update local TR failed.", "DB");
-			return r;
-		}
-		else
-		{
-			m_local_db_err_flag = 0;
-		}
-
-		if (selResult.size() > 0)
-		{
-			// Update param records
-			std::string sqlStmt = "UPDATE TR_mst SET ";
-			sqlStmt += "TRType = " + std::to_string(tr_type) + ", ";
-			sqlStmt += "Line_no = " + std::to_string(line_no) + ", ";
-			sqlStmt += "Enabled = " + std::to_string(enabled) + ", ";
-			sqlStmt += "LineText = '" + line_text + "', ";
-			sqlStmt += "LineVar = '" + line_var + "', ";
-			sqlStmt += "LineFont = " + std::to_string(line_font) + ", ";
-			sqlStmt += "LineAlign = " + std::to_string(line_align) + " ";
-			sqlStmt += "WHERE TRType = " + std::to_string(tr_type) + " AND ";
-			sqlStmt += "Line_no = " + std::to_string(line_no);
-
-			r = localdb->SQLExecutNoneQuery(sqlStmt);
-			if (r != 0)
-			{
-				m_local_db_err_flag = 1;
-				dbss.str("");
-				dbss.clear();
-				dbss << "update local TR failed.";
-				Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-			}
-			else
-			{
-				m_local_db_err_flag = 0;
-			}
-		}
-		else
-		{
-			sqlStmt = "INSERT INTO TR_mst";
-			sqlStmt = sqlStmt + " (TRType, Line_no, Enabled, LineText, LineVar, LineFont, LineAlign)";
-			sqlStmt = sqlStmt + " VALUES (" + std::to_string(tr_type);
-			sqlStmt = sqlStmt + "," + std::to_string(line_no);
-			sqlStmt = sqlStmt + "," + std::to_string(enabled);
-			sqlStmt = sqlStmt + ",'" + line_text + "'";
-			sqlStmt = sqlStmt + ",'" + line_var + "'";
-			sqlStmt = sqlStmt + "," + std::to_string(line_font);
-			sqlStmt = sqlStmt + "," + std::to_string(line_align) + ")";
-
-			r = localdb->SQLExecutNoneQuery(sqlStmt);
-			if (r != 0)
-			{
-				m_local_db_err_flag = 1;
-				dbss.str("");
-				dbss.clear();
-				dbss << "insert TR to local failed";
-				Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-			}
-			else
-			{
-				m_local_db_err_flag = 0;
-			}
-		}
-	}
-	catch (const std::exception & e)
-	{
-		r = -1;
-		dbss.str("");
-		dbss.clear();
-		dbss << "DB: local db error in writing rec: " << std::string(e.what());
-		Logger::getInstance()->FnLog(dbss.str(), "", "DB");
-		m_local_db_err_flag = 1;
-	}
-
-	return r;
-}
-
-DBError db::loadZoneEntriesfromLocal()
-{
-	vector<ReaderItem> selResult;
-	int r = -1;
-	int giStnZoneid;
-	int j = 0;
-	giStnZoneid = operation::getInstance()->gtStation.iZoneID;
-
-	r = localdb->SQLSelect("SELECT StationID FROM Station_Setup WHERE StationType = 1 and ZoneID = '" + std::to_string(giStnZoneid) + "'", &selResult, false);
-
-	if (r != 0)
-	{
-		//m_log->WriteAndPrint("Get Station Setup: fail");
-		return iLocalFail;
-	}
-
-	if (selResult.size() > 0)
-	{            
-			operation::getInstance()->tParas.gsZoneEntries = ",";
-			
-			for(j=0;j<selResult.size();j++){
-				
-			 operation::getInstance()->tParas.gsZoneEntries =  operation::getInstance()->tParas.gsZoneEntries + selResult[j].GetDataItem(0) + ",";
-
-			}
-		operation::getInstance()->writelog("Load ZoneEntries from Local: " + operation::getInstance()->tParas.gsZoneEntries , "DB");
-		return iDBSuccess;
-	}
-
-	return iNoData; 
-};
-
-DBError db::loadParam()
-{
-	int r = -1;
-	vector<ReaderItem> selResult;
-	//------
-	loadZoneEntriesfromLocal();
-	//------
-	loadparamfromCentral();
-
-	operation::getInstance()->tParas.giTariffFeeMode = 0;   // for tesing, please help to load late 
-	//------
-	r = localdb->SQLSelect("SELECT ParamName, ParamValue FROM Param_mst", &selResult, true);
-	if (r != 0)
-	{
-		operation::getInstance()->writelog("load parameter failed.", "DB");
-		return iLocalFail;
-	}
-
-	if (selResult.size() > 0)
-	{
-		for (auto &readerItem : selResult)
-		{
-			if (readerItem.getDataSize() == 2)
-			{
-				try
-				{
-					if (readerItem.GetDataItem(0) == "EPS")
-					{
-						operation::getInstance()->tParas.giEPS = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "carparkcode")
-					{
-						operation::getInstance()->tParas.gscarparkcode = readerItem.GetDataItem(1);
-					}
-
-					if (readerItem.GetDataItem(0) == "CPOID")
-					{
-						operation::getInstance()->tParas.gsCPOID = readerItem.GetDataItem(1);
-					}
-
-					if (readerItem.GetDataItem(0) == "CPID")
-					{
-						operation::getInstance()->tParas.gsCPID = readerItem.GetDataItem(1);
-					}
-
-					if (readerItem.GetDataItem(0) == "CommPortLED")
-					{
-						operation::getInstance()->tParas.giCommPortLED = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "HasMCycle")
-					{
-						operation::getInstance()->tParas.giHasMCycle = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "TicketSiteID")
-					{
-						operation::getInstance()->tParas.giTicketSiteID = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "DataKeepDays")
-					{
-						operation::getInstance()->tParas.giDataKeepDays = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "BarrierPulse")
-					{
-						operation::getInstance()->tParas.gsBarrierPulse = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "AntMaxRetry")
-					{
-						operation::getInstance()->tParas.giAntMaxRetry = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "AntMinOKTimes")
-					{
-						operation::getInstance()->tParas.giAntMinOKTimes = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "AntInqTO")
-					{
-						operation::getInstance()->tParas.giAntInqTO = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "AntiIURepetition")
-					{
-						operation::getInstance()->tParas.gbAntiIURepetition = (std::stoi(readerItem.GetDataItem(1)) == 1) ? true : false;
-					}
-
-					if (readerItem.GetDataItem(0) == "commportled401")
-					{
-						operation::getInstance()->tParas.giCommportLED401 = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "IsHDBSite")
-					{
-						operation::getInstance()->tParas.giIsHDBSite = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "allowedholdertype")
-					{
-						operation::getInstance()->tParas.gsAllowedHolderType = readerItem.GetDataItem(1);
-					}
-
-					if (readerItem.GetDataItem(0) == "LEDMaxChar")
-					{
-						operation::getInstance()->tParas.giLEDMaxChar = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "AlwaysTryOnline")
-					{
-						operation::getInstance()->tParas.gbAlwaysTryOnline = (std::stoi(readerItem.GetDataItem(1)) == 1) ? true : false;
-					}
-
-					if (readerItem.GetDataItem(0) == "AutoDebitNoEntry")
-					{
-						operation::getInstance()->tParas.gbAutoDebitNoEntry = (std::stoi(readerItem.GetDataItem(1)) == 1) ? true : false;
-					}
-
-					if (readerItem.GetDataItem(0) == "LoopAHangTime")
-					{
-						operation::getInstance()->tParas.giLoopAHangTime = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "OperationTO")
-					{
-						operation::getInstance()->tParas.giOperationTO = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "FullAction")
-					{
-						operation::getInstance()->tParas.giFullAction = static_cast<eFullAction>(std::stoi(readerItem.GetDataItem(1)));
-					}
-
-					if (readerItem.GetDataItem(0) == "barrieropentoolongtime")
-					{
-						operation::getInstance()->tParas.giBarrierOpenTooLongTime = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "bitbarrierarmbroken")
-					{
-						operation::getInstance()->tParas.giBitBarrierArmBroken = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "mccontrolaction")
-					{
-						operation::getInstance()->tParas.giMCControlAction = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "LogBackFolder")
-					{
-						operation::getInstance()->tParas.gsLogBackFolder = readerItem.GetDataItem(1);
-					}
-
-					if (readerItem.GetDataItem(0) == "LogKeepDays")
-					{
-						operation::getInstance()->tParas.giLogKeepDays = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "DBBackupFolder")
-					{
-						operation::getInstance()->tParas.gsDBBackupFolder = readerItem.GetDataItem(1);
-					}
-
-					if (readerItem.GetDataItem(0) == "maxsendofflineno")
-					{
-						operation::getInstance()->tParas.giMaxSendOfflineNo = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "maxlocaldbsize")
-					{
-						operation::getInstance()->tParas.glMaxLocalDBSize = std::stol(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "MaxTransInterval")
-					{
-						operation::getInstance()->tParas.giMaxTransInterval = std::stol(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "NoIURetry")
-					{
-						operation::getInstance()->tParas.giNoIURetry = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "MaxDiffIU")
-					{
-						operation::getInstance()->tParas.giMaxDiffIU = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "LockBarrier")
-					{
-						operation::getInstance()->tParas.gbLockBarrier = (std::stoi(readerItem.GetDataItem(1)) == 1) ? true : false;
-					}
-
-					if (readerItem.GetDataItem(0) == "commportled2")
-					{
-						operation::getInstance()->tParas.giCommPortLED2 = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "CHUIP")
-					{
-						operation::getInstance()->tParas.gsCHUIP = readerItem.GetDataItem(1);
-					}
-
-					if (readerItem.GetDataItem(0) == "Site")
-					{
-						operation::getInstance()->tParas.gsSite = readerItem.GetDataItem(1);
-					}
-
-					if (readerItem.GetDataItem(0) == "Address")
-					{
-						operation::getInstance()->tParas.gsAddress = readerItem.GetDataItem(1);
-					}
-
-					if (readerItem.GetDataItem(0) == "TryTimes4NE")
-					{
-						operation::getInstance()->tParas.giTryTimes4NE = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "processreversedcmd")
-					{
-						operation::getInstance()->tParas.giProcessReversedCMD = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "hasthreewheelmc")
-					{
-						operation::getInstance()->tParas.giHasThreeWheelMC = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "MaxDebitDays")
-					{
-						operation::getInstance()->tParas.giMaxDebitDays = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "FirstHourMode")
-					{
-						operation::getInstance()->tParas.giFirstHourMode = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "PEAllowance")
-					{
-						operation::getInstance()->tParas.giPEAllowance = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "TariffFeeMode")
-					{
-						operation::getInstance()->tParas.giTariffFeeMode = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "TariffGTmode")
-					{
-						operation::getInstance()->tParas.giTariffGTMode = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "Hr2PEAllowance")
-					{
-						operation::getInstance()->tParas.giHr2PEAllowance = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "SeasonCharge")
-					{
-						operation::getInstance()->tParas.giSeasonCharge = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "ShowSeasonExpireDays")
-					{
-						operation::getInstance()->tParas.giShowSeasonExpireDays = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "ShowExpiredTime")
-					{
-						operation::getInstance()->tParas.giShowExpiredTime = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "MCyclePerDay")
-					{
-						operation::getInstance()->tParas.giMCyclePerDay = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "V3TransType")
-					{
-						operation::getInstance()->tParas.giV3TransType = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "V4TransType")
-					{
-						operation::getInstance()->tParas.giV4TransType = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "V5TransType")
-					{
-						operation::getInstance()->tParas.giV5TransType = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "FirstHour")
-					{
-						operation::getInstance()->tParas.giFirstHour = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "HasHolidayEve")
-					{
-						operation::getInstance()->tParas.giHasHolidayEve = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "HasRedemption")
-					{
-						operation::getInstance()->tParas.gbHasRedemption = (std::stoi(readerItem.GetDataItem(1)) == 1) ? true : false;
-					}
-
-					if (readerItem.GetDataItem(0) == "Company")
-					{
-						operation::getInstance()->tParas.gsCompany = readerItem.GetDataItem(1);
-					}
-
-					if (readerItem.GetDataItem(0) == "GSTNo")
-					{
-						operation::getInstance()->tParas.gsGSTNo = readerItem.GetDataItem(1);
-					}
-
-					if (readerItem.GetDataItem(0) == "Tel")
-					{
-						operation::getInstance()->tParas.gsTel = readerItem.GetDataItem(1);
-					}
-
-					if (readerItem.GetDataItem(0) == "ZIP")
-					{
-						operation::getInstance()->tParas.gsZIP = readerItem.GetDataItem(1);
-					}
-
-					if (readerItem.GetDataItem(0) == "GSTRate")
-					{
-						operation::getInstance()->tParas.gfGSTRate = std::stof(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "CHUCnTO")
-					{
-						operation::getInstance()->tParas.giCHUCnTO = std::stof(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "HdRec")
-					{
-						operation::getInstance()->tParas.gsHdRec = readerItem.GetDataItem(1);
-					}
-
-					if (readerItem.GetDataItem(0) == "HdTk")
-					{
-						operation::getInstance()->tParas.gsHdTk = readerItem.GetDataItem(1);
-					}
-
-					if (readerItem.GetDataItem(0) == "needcard4complimentary")
-					{
-						operation::getInstance()->tParas.giNeedCard4Complimentary = std::stoi(readerItem.GetDataItem(1));
-					}
-
-					if (readerItem.GetDataItem(0) == "ExitTicketRedemption")
-					{
-						operation::getInstance()->tParas.giExitTicketRedemption = std::stoi(readerItem.GetDataItem(1));
-					}
-				}
-				catch (const std::invalid_argument &e)
-				{
-					std::stringstream ss;
-					ss << "Invalid argument for key '" << readerItem.GetDataItem(0)
-						<< "' with value '" << readerItem.GetDataItem(1) << "': " << e.what();
-					Logger::getInstance()->FnLog(ss.str(), "", "DB");
-				}
-				catch (const std::out_of_range &e)
-				{
-					std::stringstream ss;
-					ss << "Out of range for key '" << readerItem.GetDataItem(0)
-						<< "' with value '" << readerItem.GetDataItem(1) << "': " << e.what();
-					Logger::getInstance()->FnLog(ss.str(), "", "DB");
-				}
-				catch (const std::exception &e)
-				{
-					std::stringstream ss;
-					ss << "Error processing key '" << readerItem.GetDataItem(0)
-						<< "': " << e.what();
-					Logger::getInstance()->FnLog(ss.str(), "", "DB");
-				}
-			}
-		}
-		operation::getInstance()->tProcess.gbloadedParam = true;
-        return iDBSuccess;
-	}
-
-	return iNoData;
-}
-
-DBError db::loadparamfromCentral()
-{
-	int r;
-	vector<ReaderItem> tResult;
-
-	operation::getInstance()->writelog ("Load parameter from Centaral DB", "DB");
-	
-	r = centraldb->SQLSelect("SELECT group_id,site_id FROM site_setup", &tResult, true);
-	if (r != 0)
-	{
-		return iCentralFail;
-	}
-
-
-	if (tResult.size()>0)
-	{
-		operation::getInstance()->tParas.giGroupID = std::stoi(tResult[0].GetDataItem(0));
-		operation::getInstance()->tParas.giSite = std::stoi(tResult[0].GetDataItem(1));
-		operation::getInstance()->writelog ("Load Group ID: " + std::to_string(operation:: getInstance()->tParas.giGroupID), "DB");
-		operation::getInstance()->writelog ("Load Site ID: " + std::to_string(operation:: getInstance()->tParas.giSite), "DB");
-	}
-	
-	r = centraldb->SQLSelect("SELECT entry_station FROM counter_definition where zone_id = " + to_string(operation::getInstance()->gtStation.iZoneID) , &tResult, true);
-	if (r != 0)
-	{
-		return iCentralFail;
-	}
-
-	if (tResult.size()>0)
-	{
-		operation::getInstance()->tParas.gsZoneEntries = "," + tResult[0].GetDataItem(0) + ",";
-		operation::getInstance()->writelog ("Load zone for entry: " + operation:: getInstance()->tParas.gsZoneEntries, "DB");
-	}
-
-	r = centraldb->SQLSelect("SELECT Max(receipt_no) FROM exit_trans where station_id  = " + to_string(operation::getInstance()->gtStation.iSID) , &tResult, true);
-	if (r != 0)
-	{
-		return iCentralFail;
-	}
-
-	if (tResult.size()>0)
-	{
-		int l; 
-		string A;
-		long k;
-		A = std::to_string(operation::getInstance()->gtStation.iSID);
-		l = tResult[0].GetDataItem(0).length() - A.length();
-		A = tResult[0].GetDataItem(0).substr(0,l);
-
-		operation::getInstance()->writelog ("Load Last Receipt No: " + A, "DB");
-		try
-		{
-			operation::getInstance()->tProcess.glLastSerialNo = std::stol(A);
-		}
-		catch (const std::exception& e)
-		{
-			operation::getInstance()->writelog ("Exception: " + std::string(e.what()), "DB");
-		}
-	
-		return iDBSuccess;
-	}
-
-	return iNoData;
-
-}
-
-DBError db::loadvehicletype()
-{
-	int r = -1;
-	vector<ReaderItem> selResult;
-
-	r = localdb->SQLSelect("SELECT IUCode, TransType FROM Vehicle_type", &selResult, true);
-	if (r != 0)
-	{
-		operation::getInstance()->writelog("load Trans Type failed.", "DB");
-		return iLocalFail;
-	}
-
-	if (selResult.size() > 0)
-	{
-		for (auto &readerItem : selResult)
-		{
-			if (readerItem.getDataSize() == 2)
-			{
-				operation::getInstance()->tVType.push_back({std::stoi(readerItem.GetDataItem(0)), std::stoi(readerItem.GetDataItem(1))});
-			}
-		}
-		operation::getInstance()->tProcess.gbloadedVehtype = true;
-		return iDBSuccess;
-	}
-	return iNoData;
-}
-
-int db::FnGetVehicleType(std::string IUCode)
-{
-	int ret = 1;
-
-	for (auto &item : operation::getInstance()->tVType)
-	{
-		if (item.iIUCode == std::stoi(IUCode))
-		{
-			ret = item.iType;
-			break;
-		}
-	}
-
-	return ret;
-}
-
-DBError db::loadEntrymessage(std::vector<ReaderItem>& selResult)
-{
-	if (selResult.size()>0)
-	{
-		for (auto &readerItem : selResult)
-		{
-			if (readerItem.getDataSize() == 2)
-			{
-				if (readerItem.GetDataItem(0) == "AltDefaultLED")
-				{
-					operation::getInstance()->tMsg.Msg_AltDefaultLED[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_AltDefaultLED[1] = readerItem.GetDataItem(1);
-				}
-
-				if (readerItem.GetDataItem(0) == "AltDefaultLED2")
-				{
-					operation::getInstance()->tMsg.Msg_AltDefaultLED2[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_AltDefaultLED2[1] = readerItem.GetDataItem(1);
-				}
-
-				if (readerItem.GetDataItem(0) == "AltDefaultLED3")
-				{
-					operation::getInstance()->tMsg.Msg_AltDefaultLED3[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_AltDefaultLED3[1] = readerItem.GetDataItem(1);
-				}
-
-				if (readerItem.GetDataItem(0) == "AltDefaultLED4")
-				{
-					operation::getInstance()->tMsg.Msg_AltDefaultLED4[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_AltDefaultLED4[1] = readerItem.GetDataItem(1);
-				}
-
-
-				if (readerItem.GetDataItem(0) == "authorizedvehicle")
-				{
-					operation::getInstance()->tMsg.Msg_authorizedvehicle[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_authorizedvehicle[1] = readerItem.GetDataItem(1);
-				}
-
-
-				if (readerItem.GetDataItem(0) == "CardReadingError")
-				{
-					operation::getInstance()->tMsg.Msg_CardReadingError[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_CardReadingError[1] = readerItem.GetDataItem(1);
-				}
-
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CCardReadingError")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_CardReadingError[1].clear();
-						operation::getInstance()->tMsg.Msg_CardReadingError[1] = readerItem.GetDataItem(1);
-					}
-				}
-
-			
-				if (readerItem.GetDataItem(0) == "CardTaken")
-				{
-					operation::getInstance()->tMsg.Msg_CardTaken[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_CardTaken[1] = readerItem.GetDataItem(1);
-				}
-
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CCardTaken")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_CardTaken[1].clear();
-						operation::getInstance()->tMsg.Msg_CardTaken[1] = readerItem.GetDataItem(1);
-					}
-				}
-
-				if (readerItem.GetDataItem(0) == "CarFullLED")
-				{
-					operation::getInstance()->tMsg.Msg_CarFullLED[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_CarFullLED[1] = readerItem.GetDataItem(1);
-				}
-
-				if (readerItem.GetDataItem(0) == "CarParkFull2LED")
-				{
-					operation::getInstance()->tMsg.Msg_CarParkFull2LED[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_CarParkFull2LED[1] = readerItem.GetDataItem(1);
-				}
-
-				if (readerItem.GetDataItem(0) == "DBError")
-				{
-					operation::getInstance()->tMsg.Msg_DBError[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_DBError[1] = readerItem.GetDataItem(1);
-				}
-
-
-				if (readerItem.GetDataItem(0) == "DefaultIU")
-				{
-					operation::getInstance()->tMsg.Msg_DefaultIU[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_DefaultIU[1] = readerItem.GetDataItem(1);
-				}
-
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CDefaultIU")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_DefaultIU[1].clear();
-						operation::getInstance()->tMsg.Msg_DefaultIU[1] = readerItem.GetDataItem(1);
-					}
-				}
-
-				if (readerItem.GetDataItem(0) == "DefaultLED")
-				{
-					operation::getInstance()->tMsg.Msg_DefaultLED[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_DefaultLED[1] = readerItem.GetDataItem(1);
-				}
-
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CDefaultLED")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_DefaultLED[1].clear();
-						operation::getInstance()->tMsg.Msg_DefaultLED[1] = readerItem.GetDataItem(1);
-					}
-				}
-
-				if (readerItem.GetDataItem(0) == "DefaultLED2")
-				{
-					operation::getInstance()->tMsg.Msg_DefaultLED2[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_DefaultLED2[1] = readerItem.GetDataItem(1);
-				}
-
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CDefaultLED2")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_DefaultLED2[1].clear();
-						operation::getInstance()->tMsg.Msg_DefaultLED2[1] = readerItem.GetDataItem(1);
-					}
-				}
-
-				if (readerItem.GetDataItem(0) == "DefaultMsg2LED")
-				{
-					operation::getInstance()->tMsg.Msg_DefaultMsg2LED[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_DefaultMsg2LED[1] = readerItem.GetDataItem(1);
-				}
-
-				if (readerItem.GetDataItem(0) == "DefaultMsgLED")
-				{
-					operation::getInstance()->tMsg.Msg_DefaultMsgLED[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_DefaultMsgLED[1] = readerItem.GetDataItem(1);
-				}
-
-				if (readerItem.GetDataItem(0) == "EenhancedMCParking")
-				{
-					operation::getInstance()->tMsg.Msg_EenhancedMCParking[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_EenhancedMCParking[1] = readerItem.GetDataItem(1);
-				}
-
-				if (readerItem.GetDataItem(0) == "ESeasonWithinAllowance")
-				{
-					operation::getInstance()->tMsg.Msg_ESeasonWithinAllowance[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_ESeasonWithinAllowance[1] = readerItem.GetDataItem(1);
-				}
-
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CESeasonWithinAllowance")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_ESeasonWithinAllowance[1].clear();
-						operation::getInstance()->tMsg.Msg_ESeasonWithinAllowance[1] = readerItem.GetDataItem(1);
-					}
-				}
+        r = localdb->SQLExecutNoneQuery(sqlStmt);
+        if (r != 0)
+        {
+            m_local_db_err_flag = 1;
+            dbss.str("");
+            dbss.clear();
+            dbss << "Insert tariff type info to local failed.";
+            Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+        }
+        else
+        {
+            m_local_db_err_flag = 0;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        r = -1;
+        dbss.str("");
+        dbss.clear();
+        dbss << "DB: local db error in writing rec: " << std::string(e.what());
+        Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+        m_local_db_err_flag = 1;
+    }
 
-				if (readerItem.GetDataItem(0) == "ESPT3Parking")
-				{
-					operation::getInstance()->tMsg.Msg_ESPT3Parking[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_ESPT3Parking[1] = readerItem.GetDataItem(1);
-				}
+    return r;
+}
 
-				if (readerItem.GetDataItem(0) == "EVIPHolderParking")
-				{
-					operation::getInstance()->tMsg.Msg_EVIPHolderParking[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_EVIPHolderParking[1] = readerItem.GetDataItem(1);
-				}
 
-				if (readerItem.GetDataItem(0) == "ExpiringSeason")
-				{
-					operation::getInstance()->tMsg.Msg_ExpiringSeason[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_ExpiringSeason[1] = readerItem.GetDataItem(1);
-				}
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CExpiringSeason")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_ExpiringSeason[1].clear();
-						operation::getInstance()->tMsg.Msg_ExpiringSeason[1] = readerItem.GetDataItem(1);
-					}
-				}
+int db::downloadxtariff(int iGrpID, int iSiteID, int iCheckStatus)
+{
+    int ret = -1;
+    std::vector<ReaderItem> tResult;
+    std::vector<ReaderItem> selResult;
+    std::string sqlStmt;
+    std::stringstream dbss;
+    int r = -1;
+    int w = -1;
 
-				if (readerItem.GetDataItem(0) == "FullLED")
-				{
-					operation::getInstance()->tMsg.Msg_FullLED[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_FullLED[1] = readerItem.GetDataItem(1);
-				}
+    if (iCheckStatus == 1)
+    {
+        // Check x tariff is downloaded or not
+        sqlStmt = "SELECT name FROM parameter_mst ";
+        sqlStmt = sqlStmt + "WHERE name = 'DownloadXTariff' AND s" + std::to_string(operation::getInstance()->gtStation.iSID) + "_fetched=0";
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CFullLED")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_FullLED[1].clear();
-						operation::getInstance()->tMsg.Msg_FullLED[1] = readerItem.GetDataItem(1);
-					}
-				}
+        r = centraldb->SQLSelect(sqlStmt, &tResult, true);
+        if (r != 0)
+        {
+            m_remote_db_err_flag.store(1);
+            operation::getInstance()->writelog("Download X_Tariff failed.", "DB");
+            return ret;
+        }
+        else if (tResult.size() == 0)
+        {
+            m_remote_db_err_flag.store(0);
+            operation::getInstance()->writelog("X_Tariff download already.", "DB");
+            return -3;
+        }
+    }
 
-				if (readerItem.GetDataItem(0) == "Idle")
-				{
-					operation::getInstance()->tMsg.Msg_Idle[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_Idle[1] = readerItem.GetDataItem(1);
-				}
+    r = localdb->SQLExecutNoneQuery("DELETE FROM X_Tariff");
+    if (r != 0)
+    {
+        m_local_db_err_flag = 1;
+        operation::getInstance()->writelog("Delete X_Tariff from local failed.", "DB");
+        return -1;
+    }
+    else
+    {
+        m_local_db_err_flag = 0;
+    }
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CIdle")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_Idle[1].clear();
-						operation::getInstance()->tMsg.Msg_Idle[1] = readerItem.GetDataItem(1);
-					}
-				}
+    operation::getInstance()->writelog("Download X_Tariff for group: " + std::to_string(iGrpID) + ", site: " + std::to_string(iSiteID), "DB");
+    sqlStmt = "";
+    sqlStmt = "SELECT * FROM X_Tariff";
+    sqlStmt = sqlStmt + " WHERE group_id=" + std::to_string(iGrpID) + " AND site_id=" + std::to_string(iSiteID);
 
-				if (readerItem.GetDataItem(0) == "InsertCashcard")
-				{
-					operation::getInstance()->tMsg.Msg_InsertCashcard[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_InsertCashcard[1] = readerItem.GetDataItem(1);
-				}
+    r = centraldb->SQLSelect(sqlStmt, &selResult, true);
+    if (r != 0)
+    {
+        m_remote_db_err_flag.store(1);
+        operation::getInstance()->writelog("Download X_Tariff failed.", "DB");
+        return ret;
+    }
+    else
+    {
+        m_remote_db_err_flag.store(0);
+    }
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CInsertCashcard")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_InsertCashcard[1].clear();
-						operation::getInstance()->tMsg.Msg_InsertCashcard[1] = readerItem.GetDataItem(1);
-					}
-				}
+    int downloadCount = 0;
+    if (selResult.size() > 0)
+    {
+        for (int j = 0; j < selResult.size(); j++)
+        {
+            x_tariff_struct x_tariff;
+            x_tariff.day_index = selResult[j].GetDataItem(2);
+            x_tariff.auto0 = selResult[j].GetDataItem(3);
+            x_tariff.fee0 = selResult[j].GetDataItem(4);
+            x_tariff.time1 = selResult[j].GetDataItem(5);
+            x_tariff.auto1 = selResult[j].GetDataItem(6);
+            x_tariff.fee1 = selResult[j].GetDataItem(7);
+            x_tariff.time2 = selResult[j].GetDataItem(8);
+            x_tariff.auto2 = selResult[j].GetDataItem(9);
+            x_tariff.fee2 = selResult[j].GetDataItem(10);
+            x_tariff.time3 = selResult[j].GetDataItem(11);
+            x_tariff.auto3 = selResult[j].GetDataItem(12);
+            x_tariff.fee3 = selResult[j].GetDataItem(13);
+            x_tariff.time4 = selResult[j].GetDataItem(14);
+            x_tariff.auto4 = selResult[j].GetDataItem(15);
+            x_tariff.fee4 = selResult[j].GetDataItem(16);
 
-				if (readerItem.GetDataItem(0) == "IUProblem")
-				{
-					operation::getInstance()->tMsg.Msg_IUProblem[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_IUProblem[1] = readerItem.GetDataItem(1);
-				}
+            w = writextariff2local(x_tariff);
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CIUProblem")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_IUProblem[1].clear();
-						operation::getInstance()->tMsg.Msg_IUProblem[1] = readerItem.GetDataItem(1);
-					}
-				}
-				
-				if (readerItem.GetDataItem(0) == "LockStation")
-				{
-					operation::getInstance()->tMsg.Msg_LockStation[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_LockStation[1] = readerItem.GetDataItem(1);
-				}
+            if (w == 0)
+            {
+                downloadCount++;
+            }
+        }
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CLockStation")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_LockStation[1].clear();
-						operation::getInstance()->tMsg.Msg_LockStation[1] = readerItem.GetDataItem(1);
-					}
-				}
+        dbss.str("");  // Set the underlying string to an empty string
+        dbss.clear();   // Clear the state of the stream
+        dbss << "Downloading x_tariff Records: End, Total Record :" << selResult.size() << " ,Downloaded Record :" << downloadCount;
+        Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+    }
 
-				if (readerItem.GetDataItem(0) == "LoopA")
-				{
-					operation::getInstance()->tMsg.Msg_LoopA[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_LoopA[1] = readerItem.GetDataItem(1);
-				}
+    if (iCheckStatus == 1)
+    {
+        sqlStmt = "";
+        sqlStmt = "UPDATE parameter_mst set s" + std::to_string(operation::getInstance()->gtStation.iSID) + "_fetched=1";
+        sqlStmt = sqlStmt + " WHERE name='DownloadXTariff'";
+        
+        r = centraldb->SQLExecutNoneQuery(sqlStmt);
+        if (r != 0)
+        {
+            m_remote_db_err_flag.store(1);
+            operation::getInstance()->writelog("Set DownloadXTariff fetched=1 failed.", "DB");
+        }
+    }
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CLoopA")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_LoopA[1].clear();
-						operation::getInstance()->tMsg.Msg_LoopA[1] = readerItem.GetDataItem(1);
-					}
-				}
+    if (selResult.size() < 1)
+    {
+        ret = -1;
+    }
+    else
+    {
+        ret = downloadCount;
+    }
 
-				if (readerItem.GetDataItem(0) == "LoopAFull")
-				{
-					operation::getInstance()->tMsg.Msg_LoopAFull[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_LoopAFull[1] = readerItem.GetDataItem(1);
-				}
+    return ret;
+}
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CLoopAFull")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_LoopAFull[1].clear();
-						operation::getInstance()->tMsg.Msg_LoopAFull[1] = readerItem.GetDataItem(1);
-					}
-				}
+int db::writextariff2local(x_tariff_struct& x_tariff)
+{
+    int r = -1;
+    std::string sqlStmt;
+    std::stringstream dbss;
 
-				if (readerItem.GetDataItem(0) == "LorryFullLED")
-				{
-					operation::getInstance()->tMsg.Msg_LorryFullLED[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_LorryFullLED[1] = readerItem.GetDataItem(1);
-				}
+    try
+    {
+        sqlStmt = "INSERT INTO X_Tariff";
+        sqlStmt = sqlStmt + "(day_index, auto0, fee0, time1, auto1, fee1";
+        sqlStmt = sqlStmt + ", time2, auto2, fee2, time3, auto3, fee3, time4, auto4, fee4";
+        sqlStmt = sqlStmt + ")";
+        sqlStmt = sqlStmt + " VALUES ('" + x_tariff.day_index + "'";
+        sqlStmt = sqlStmt + ", " + x_tariff.auto0;
+        sqlStmt = sqlStmt + ", " + x_tariff.fee0;
+        sqlStmt = sqlStmt + ", '" + x_tariff.time1 + "'";
+        sqlStmt = sqlStmt + ", " + x_tariff.auto1;
+        sqlStmt = sqlStmt + ", " + x_tariff.fee1;
+        sqlStmt = sqlStmt + ", '" + x_tariff.time2 + "'";
+        sqlStmt = sqlStmt + ", " + x_tariff.auto2;
+        sqlStmt = sqlStmt + ", " + x_tariff.fee2;
+        sqlStmt = sqlStmt + ", '" + x_tariff.time3 + "'";
+        sqlStmt = sqlStmt + ", " + x_tariff.auto3;
+        sqlStmt = sqlStmt + ", " + x_tariff.fee3;
+        sqlStmt = sqlStmt + ", '" + x_tariff.time4 + "'";
+        sqlStmt = sqlStmt + ", " + x_tariff.auto4;
+        sqlStmt = sqlStmt + ", " + x_tariff.fee4;
+        sqlStmt = sqlStmt + ")";
 
-				if (readerItem.GetDataItem(0) == "LotAdjustmentMsg")
-				{
-					operation::getInstance()->tMsg.Msg_LotAdjustmentMsg[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_LotAdjustmentMsg[1] = readerItem.GetDataItem(1);
-				}
+        r = localdb->SQLExecutNoneQuery(sqlStmt);
+        if (r != 0)
+        {
+            m_local_db_err_flag = 1;
+            dbss.str("");
+            dbss.clear();
+            dbss << "Insert X_Tariff to local failed.";
+            Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+        }
+        else
+        {
+            m_local_db_err_flag = 0;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        r = -1;
+        dbss.str("");
+        dbss.clear();
+        dbss << "DB: local db error in writing rec: " << std::string(e.what());
+        Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+        m_local_db_err_flag = 1;
+    }
 
-				if (readerItem.GetDataItem(0) == "LowBal")
-				{
-					operation::getInstance()->tMsg.Msg_LowBal[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_LowBal[1] = readerItem.GetDataItem(1);
-				}
+    return r;
+}
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CLowBal")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_LowBal[1].clear();
-						operation::getInstance()->tMsg.Msg_LowBal[1] = readerItem.GetDataItem(1);
-					}
-				}
+int db::downloadholidaymst(int iCheckStatus)
+{
+    int ret = -1;
+    std::vector<ReaderItem> tResult;
+    std::string sqlStmt;
+    int r = -1;
 
-				if (readerItem.GetDataItem(0) == "NoIU")
-				{
-					operation::getInstance()->tMsg.Msg_NoIU[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_NoIU[1] = readerItem.GetDataItem(1);
-				}
+    if (iCheckStatus == 1)
+    {
+        // Check Whether holiday mst is downloaded or not
+        sqlStmt = "SELECT name FROM parameter_mst ";
+        sqlStmt = sqlStmt + "WHERE name='DownloadHoliday' AND s" + std::to_string(operation::getInstance()->gtStation.iSID) + "_fetched=0";
+        
+        r = centraldb->SQLSelect(sqlStmt, &tResult, true);
+        if (r != 0)
+        {
+            m_remote_db_err_flag.store(1);
+            operation::getInstance()->writelog("Download holiday_mst failed.", "DB");
+            return ret;
+        }
+        else if (tResult.size() == 0)
+        {
+            m_remote_db_err_flag.store(0);
+            operation::getInstance()->writelog("holiday_mst download already.", "DB");
+            return -3;
+        }
+    }
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CNoIU")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_NoIU[1].clear();
-						operation::getInstance()->tMsg.Msg_NoIU[1] = readerItem.GetDataItem(1);
-					}
-				}
+    operation::getInstance()->writelog("Download holiday_mst.", "DB");
 
-				if (readerItem.GetDataItem(0) == "NoNightParking2LED")
-				{
-					operation::getInstance()->tMsg.Msg_NoNightParking2LED[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_NoNightParking2LED[1] = readerItem.GetDataItem(1);
-				}
+    // The local table holds what the central one returns, holidays that left it go
+    TableReplicator::Spec spec;
+    spec.name = "holiday";
+    spec.centralTable = "holiday_mst";
+    spec.centralSelect = "holiday_date, descrip";
+    spec.centralFilter = "holiday_date > GETDATE() - 30";
+    spec.localTable = "holiday_mst";
+    spec.columns = { { "holiday_date", 0, true }, { "descrip", 1, false } };
+    spec.batchRows = 0;
+    spec.isDeletingMissing = true;
+
+    TableReplicator::Result result;
+    int downloadCount = syncTable(spec, &result);
+    if (downloadCount < 0)
+    {
+        operation::getInstance()->writelog("Download holiday_mst failed.", "DB");
+        return ret;
+    }
 
-				if (readerItem.GetDataItem(0) == "Offline")
-				{
-					operation::getInstance()->tMsg.Msg_Offline[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_Offline[1] = readerItem.GetDataItem(1);
-				}
+    if (iCheckStatus == 1)
+    {
+        sqlStmt = "";
+        sqlStmt = "UPDATE parameter_mst set s" + std::to_string(operation::getInstance()->gtStation.iSID) + "_fetched=1";
+        sqlStmt = sqlStmt + " WHERE name='DownloadHoliday'";
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "COffline")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_Offline[1].clear();
-						operation::getInstance()->tMsg.Msg_Offline[1] = readerItem.GetDataItem(1);
-					}
-				}
+        r = centraldb->SQLExecutNoneQuery(sqlStmt);
+        if (r != 0)
+        {
+            m_remote_db_err_flag.store(1);
+            operation::getInstance()->writelog("Set DownloadHoliday fetched=1 failed.", "DB");
+        }
+    }
 
-				if (readerItem.GetDataItem(0) == "Processing")
-				{
-					operation::getInstance()->tMsg.Msg_Processing[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_Processing[1] = readerItem.GetDataItem(1);
-				}
+    if (result.fetched < 1)
+    {
+        ret = -1;
+    }
+    else
+    {
+        ret = downloadCount;
+    }
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CProcessing")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_Processing[1].clear();
-						operation::getInstance()->tMsg.Msg_Processing[1] = readerItem.GetDataItem(1);
-					}
-				}
+    return ret;
+}
 
-				if (readerItem.GetDataItem(0) == "ReaderCommError")
-				{
-					operation::getInstance()->tMsg.Msg_ReaderCommError[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_ReaderCommError[1] = readerItem.GetDataItem(1);
-				}
+int db::download3tariffinfo()
+{
+    int ret = -1;
+    std::vector<ReaderItem> selResult;
+    std::string sqlStmt;
+    std::stringstream dbss;
+    int r = -1;
+    int w = -1;
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CReaderCommError")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_ReaderCommError[1].clear();
-						operation::getInstance()->tMsg.Msg_ReaderCommError[1] = readerItem.GetDataItem(1);
-					}
-				}
+    r = localdb->SQLExecutNoneQuery("DELETE FROM 3Tariff_Info");
+    if (r != 0)
+    {
+        m_local_db_err_flag = 1;
+        operation::getInstance()->writelog("Delete 3Tariff_Info from local failed.", "DB");
+        return -1;
+    }
+    else
+    {
+        m_local_db_err_flag = 0;
+    }
 
-				if (readerItem.GetDataItem(0) == "ReaderError")
-				{
-					operation::getInstance()->tMsg.Msg_ReaderError[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_ReaderError[1] = readerItem.GetDataItem(1);
-				}
+    int zone_id = operation::getInstance()->gtStation.iZoneID;
+    operation::getInstance()->writelog("Download 3Tariff_Info.", "DB");
+    sqlStmt = "";
+    sqlStmt = "SELECT * FROM [3Tariff_Info]";
+    sqlStmt = sqlStmt + " WHERE Zone_ID='" + std::to_string(zone_id) + "'";
+    sqlStmt = sqlStmt + " OR Zone_ID LIKE '" + std::to_string(zone_id) + ",%'";
+    sqlStmt = sqlStmt + " OR Zone_ID LIKE '%," + std::to_string(zone_id) + ",%'";
+    sqlStmt = sqlStmt + " OR Zone_ID LIKE '%," + std::to_string(zone_id) + "'";
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CReaderError")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_ReaderError[1].clear();
-						operation::getInstance()->tMsg.Msg_ReaderError[1] = readerItem.GetDataItem(1);
-					}
-				}
+    r = centraldb->SQLSelect(sqlStmt, &selResult, true);
+    if (r != 0)
+    {
+        m_remote_db_err_flag.store(1);
+        operation::getInstance()->writelog("Download 3Tariff_Info failed.", "DB");
+        return ret;
+    }
+    else
+    {
+        m_remote_db_err_flag.store(0);
+    }
 
-				if (readerItem.GetDataItem(0) == "SameLastIU")
-				{
-					operation::getInstance()->tMsg.Msg_SameLastIU[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_SameLastIU[1] = readerItem.GetDataItem(1);
-				}
+    int downloadCount = 0;
+    if (selResult.size() > 0)
+    {
+        for (int j = 0; j < selResult.size(); j++)
+        {
+            tariff_info_struct tariff_info;
+            tariff_info.rate_type = selResult[j].GetDataItem(1);
+            tariff_info.day_type = selResult[j].GetDataItem(2);
+            tariff_info.time_from = selResult[j].GetDataItem(3);
+            tariff_info.time_till = selResult[j].GetDataItem(4);
+            tariff_info.t3_start = selResult[j].GetDataItem(5);
+            tariff_info.t3_block = selResult[j].GetDataItem(6);
+            tariff_info.t3_rate = selResult[j].GetDataItem(7);
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CSameLastIU")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_SameLastIU[1].clear();
-						operation::getInstance()->tMsg.Msg_SameLastIU[1] = readerItem.GetDataItem(1);
-					}
-				}
+            w = write3tariffinfo2local(tariff_info);
 
-				if (readerItem.GetDataItem(0) == "ScanEntryTicket")
-				{
-					operation::getInstance()->tMsg.Msg_ScanEntryTicket[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_ScanEntryTicket[1] = readerItem.GetDataItem(1);
-				}
+            if (w == 0)
+            {
+                downloadCount++;
+            }
+        }
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CScanEntryTicket")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_ScanEntryTicket[1].clear();
-						operation::getInstance()->tMsg.Msg_ScanEntryTicket[1] = readerItem.GetDataItem(1);
-					}
-				}
+        dbss.str("");  // Set the underlying string to an empty string
+    	dbss.clear();   // Clear the state of the stream
+		dbss << "Downloading 3Tariff_Info Records: End, Total Record :" << selResult.size() << " ,Downloaded Record :" << downloadCount;
+    	Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+    }
 
-				if (readerItem.GetDataItem(0) == "ScanValTicket")
-				{
-					operation::getInstance()->tMsg.Msg_ScanValTicket[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_ScanValTicket[1] = readerItem.GetDataItem(1);
-				}
+    if (selResult.size() < 1)
+    {
+        ret = -1;
+    }
+    else
+    {
+        ret = downloadCount;
+    }
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CScanValTicket")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_ScanValTicket[1].clear();
-						operation::getInstance()->tMsg.Msg_ScanValTicket[1] = readerItem.GetDataItem(1);
-					}
-				}
+    return ret;
+}
 
-				if (readerItem.GetDataItem(0) == "SeasonAsHourly")
-				{
-					operation::getInstance()->tMsg.Msg_SeasonAsHourly[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_SeasonAsHourly[1] = readerItem.GetDataItem(1);
-				}
+int db::write3tariffinfo2local(tariff_info_struct& tariff_info)
+{
+    int r = -1;
+    std::string sqlStmt;
+    std::stringstream dbss;
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CSeasonAsHourly")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_SeasonAsHourly[1].clear();
-						operation::getInstance()->tMsg.Msg_SeasonAsHourly[1] = readerItem.GetDataItem(1);
-					}
-				}
+    try
+    {
+        sqlStmt = "INSERT INTO 3Tariff_Info";
+        sqlStmt = sqlStmt + " (Rate_Type, Day_Type, Time_From, Time_Till, T3_Start, T3_Block, T3_Rate)";
+        sqlStmt = sqlStmt + " VALUES(" + tariff_info.rate_type;
+        sqlStmt = sqlStmt + ", '" + tariff_info.day_type + "'";
+        sqlStmt = sqlStmt + ", '" + tariff_info.time_from + "'";
+        sqlStmt = sqlStmt + ", '" + tariff_info.time_till + "'";
+        sqlStmt = sqlStmt + ", " + tariff_info.t3_start;
+        sqlStmt = sqlStmt + ", " + tariff_info.t3_block;
+        sqlStmt = sqlStmt + ", " + tariff_info.t3_rate + ")";
 
-				if (readerItem.GetDataItem(0) == "SeasonBlocked")
-				{
-					operation::getInstance()->tMsg.Msg_SeasonBlocked[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_SeasonBlocked[1] = readerItem.GetDataItem(1);
-				}
+        r = localdb->SQLExecutNoneQuery(sqlStmt);
+        if (r != 0)
+        {
+            m_local_db_err_flag = 1;
+            dbss.str("");
+            dbss.clear();
+            dbss << "Insert 3Tariff_Info to local failed.";
+            Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+        }
+        else
+        {
+            m_local_db_err_flag = 0;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        r = -1;
+        dbss.str("");
+        dbss.clear();
+        dbss << "DB: local db error in writing rec: " << std::string(e.what());
+        Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+        m_local_db_err_flag = 1;
+    }
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CSeasonBlocked")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_SeasonBlocked[1].clear();
-						operation::getInstance()->tMsg.Msg_SeasonBlocked[1] = readerItem.GetDataItem(1);
-					}
-				}
+    return r;
+}
 
-				if (readerItem.GetDataItem(0) == "SeasonExpired")
-				{
-					operation::getInstance()->tMsg.Msg_SeasonExpired[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_SeasonExpired[1] = readerItem.GetDataItem(1);
-				}
+int db::downloadratefreeinfo(int iCheckStatus)
+{
+    int ret = -1;
+    std::vector<ReaderItem> tResult;
+    std::vector<ReaderItem> selResult;
+    std::string sqlStmt;
+    std::stringstream dbss;
+    int r = -1;
+    int w = -1;
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CSeasonExpired")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_SeasonExpired[1].clear();
-						operation::getInstance()->tMsg.Msg_SeasonExpired[1] = readerItem.GetDataItem(1);
-					}
-				}
+    if (iCheckStatus == 1)
+    {
+        // Check Whether rate free info is downloaded or not
+        sqlStmt = "SELECT name FROM parameter_mst";
+        sqlStmt = sqlStmt + " WHERE name='DownloadRateFreeInfo' AND s" + std::to_string(operation::getInstance()->gtStation.iSID) + "_fetched=0";
 
-				if (readerItem.GetDataItem(0) == "SeasonInvalid")
-				{
-					operation::getInstance()->tMsg.Msg_SeasonInvalid[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_SeasonInvalid[1] = readerItem.GetDataItem(1);
-				}
+        r = centraldb->SQLSelect(sqlStmt, &tResult, true);
+        if (r != 0)
+        {
+            m_remote_db_err_flag.store(1);
+            operation::getInstance()->writelog("Download Rate_Free_Info failed.", "DB");
+            return ret;
+        }
+        else if (tResult.size() == 0)
+        {
+            m_remote_db_err_flag.store(0);
+            operation::getInstance()->writelog("Rate_Free_Info download already.", "DB");
+            return -3;
+        }
+    }
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CSeasonInvalid")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_SeasonInvalid[1].clear();
-						operation::getInstance()->tMsg.Msg_SeasonInvalid[1] = readerItem.GetDataItem(1);
-					}
-				}
+    r = localdb->SQLExecutNoneQuery("DELETE FROM Rate_Free_Info");
+    if (r != 0)
+    {
+        m_local_db_err_flag = 1;
+        operation::getInstance()->writelog("Delete Rate_Free_Info from local failed.", "DB");
+        return -1;
+    }
+    else
+    {
+        m_local_db_err_flag = 0;
+    }
 
-				if (readerItem.GetDataItem(0) == "SeasonMultiFound")
-				{
-					operation::getInstance()->tMsg.Msg_SeasonMultiFound[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_SeasonMultiFound[1] = readerItem.GetDataItem(1);
-				}
+    int zone_id = operation::getInstance()->gtStation.iZoneID;
+    operation::getInstance()->writelog("Download Rate_Free_Info.", "DB");
+    sqlStmt = "";
+    sqlStmt = "SELECT Rate_Type, Day_Type, Init_Free, Free_Beg, Free_End, Free_Time FROM Rate_Free_Info";
+    sqlStmt = sqlStmt + " WHERE Zone_ID='" + std::to_string(zone_id) + "'";
+    sqlStmt = sqlStmt + " OR Zone_ID LIKE '" + std::to_string(zone_id) + ",%'";
+    sqlStmt = sqlStmt + " OR Zone_ID LIKE '%," + std::to_string(zone_id) + ",%'";
+    sqlStmt = sqlStmt + " OR Zone_ID LIKE '%," + std::to_string(zone_id) + "'";
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CSeasonMultiFound")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_SeasonMultiFound[1].clear();
-						operation::getInstance()->tMsg.Msg_SeasonMultiFound[1] = readerItem.GetDataItem(1);
-					}
-				}
+    r = centraldb->SQLSelect(sqlStmt, &selResult, true);
+    if (r != 0)
+    {
+        m_remote_db_err_flag.store(1);
+        operation::getInstance()->writelog("Download Rate_Free_Info failed.", "DB");
+        return ret;
+    }
+    else
+    {
+        m_remote_db_err_flag.store(0);
+    }
 
-				if (readerItem.GetDataItem(0) == "SeasonNotFound")
-				{
-					operation::getInstance()->tMsg.Msg_SeasonNotFound[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_SeasonNotFound[1] = readerItem.GetDataItem(1);
-				}
+    int downloadCount = 0;
+    if (selResult.size() > 0)
+    {
+        for (int j = 0; j < selResult.size(); j++)
+        {
+            rate_free_info_struct rate_free_info;
+            rate_free_info.rate_type = selResult[j].GetDataItem(0);
+            rate_free_info.day_type = selResult[j].GetDataItem(1);
+            rate_free_info.init_free = selResult[j].GetDataItem(2);
+            rate_free_info.free_beg = selResult[j].GetDataItem(3);
+            rate_free_info.free_end = selResult[j].GetDataItem(4);
+            rate_free_info.free_time = selResult[j].GetDataItem(5);
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CSeasonNotFound")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_SeasonNotFound[1].clear();
-						operation::getInstance()->tMsg.Msg_SeasonNotFound[1] = readerItem.GetDataItem(1);
-					}
-				}
+            w = writeratefreeinfo2local(rate_free_info);
 
-				if (readerItem.GetDataItem(0) == "SeasonNotStart")
-				{
-					operation::getInstance()->tMsg.Msg_SeasonNotStart[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_SeasonNotStart[1] = readerItem.GetDataItem(1);
-				}
+            if (w == 0)
+            {
+                downloadCount++;
+            }
+        }
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CSeasonNotStart")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_SeasonNotStart[1].clear();
-						operation::getInstance()->tMsg.Msg_SeasonNotStart[1] = readerItem.GetDataItem(1);
-					}
-				}
+        dbss.str("");  // Set the underlying string to an empty string
+    	dbss.clear();   // Clear the state of the stream
+		dbss << "Downloading Rate_Free_Info Records: End, Total Record :" << selResult.size() << " ,Downloaded Record :" << downloadCount;
+    	Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+    }
 
-				if (readerItem.GetDataItem(0) == "SeasonNotValid")
-				{
-					operation::getInstance()->tMsg.Msg_SeasonNotValid[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_SeasonNotValid[1] = readerItem.GetDataItem(1);
-				}
+    if (iCheckStatus == 1)
+    {
+        sqlStmt = "";
+        sqlStmt = "UPDATE parameter_mst set s" + std::to_string(operation::getInstance()->gtStation.iSID) + "_fetched=1";
+        sqlStmt = sqlStmt + " WHERE name='DownloadRateFreeInfo'";
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CSeasonNotValid")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_SeasonNotValid[1].clear();
-						operation::getInstance()->tMsg.Msg_SeasonNotValid[1] = readerItem.GetDataItem(1);
-					}
-				}
+        r = centraldb->SQLExecutNoneQuery(sqlStmt);
+        if (r != 0)
+        {
+            m_remote_db_err_flag.store(1);
+            operation::getInstance()->writelog("Set DownloadRateFreeInfo fetched = 1 failed.", "DB");
+        }
+    }
 
-				if (readerItem.GetDataItem(0) == "SeasonOnly")
-				{
-					operation::getInstance()->tMsg.Msg_SeasonOnly[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_SeasonOnly[1] = readerItem.GetDataItem(1);
-				}
+    if (selResult.size() < 1)
+    {
+        ret = -1;
+    }
+    else
+    {
+        ret = downloadCount;
+    }
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CSeasonOnly")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_SeasonOnly[1].clear();
-						operation::getInstance()->tMsg.Msg_SeasonOnly[1] = readerItem.GetDataItem(1);
-					}
-				}
+    return ret;
+}
 
-				if (readerItem.GetDataItem(0) == "SeasonPassback")
-				{
-					operation::getInstance()->tMsg.Msg_SeasonPassback[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_SeasonPassback[1] = readerItem.GetDataItem(1);
-				}
+int db::writeratefreeinfo2local(rate_free_info_struct& rate_free_info)
+{
+    int r = -1;
+    std::string sqlStmt;
+    std::stringstream dbss;
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CSeasonPassback")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_SeasonPassback[1].clear();
-						operation::getInstance()->tMsg.Msg_SeasonPassback[1] = readerItem.GetDataItem(1);
-					}
-				}
+    try
+    {
+        sqlStmt = "INSERT INTO Rate_Free_Info";
+        sqlStmt = sqlStmt + " (Rate_Type, Day_Type, Init_Free, Free_Beg, Free_End, Free_Time)";
+        sqlStmt = sqlStmt + " VALUES (" + rate_free_info.rate_type;
+        sqlStmt = sqlStmt + ", '" + rate_free_info.day_type + "'";
+        sqlStmt = sqlStmt + ", " + rate_free_info.init_free;
+        sqlStmt = sqlStmt + ", '" + rate_free_info.free_beg + "'";
+        sqlStmt = sqlStmt + ", '" + rate_free_info.free_end + "'";
+        sqlStmt = sqlStmt + ", " + rate_free_info.free_time + ")";
 
-				
-				if (readerItem.GetDataItem(0) == "SeasonTerminated")
-				{
-					operation::getInstance()->tMsg.Msg_SeasonTerminated[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_SeasonTerminated[1] = readerItem.GetDataItem(1);
-				}
+        r = localdb->SQLExecutNoneQuery(sqlStmt);
+        if (r != 0)
+        {
+            m_local_db_err_flag = 1;
+            dbss.str("");
+            dbss.clear();
+            dbss << "Insert Rate_Free_Info to local failed.";
+            Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+        }
+        else
+        {
+            m_local_db_err_flag = 0;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        r = -1;
+        dbss.str("");
+        dbss.clear();
+        dbss << "DB: local db error in writing rec: " << std::string(e.what());
+        Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+        m_local_db_err_flag = 1;
+    }
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CSeasonTerminated")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_SeasonTerminated[1].clear();
-						operation::getInstance()->tMsg.Msg_SeasonTerminated[1] = readerItem.GetDataItem(1);
-					}
-				}
+    return r;
+}
 
-				
-				if (readerItem.GetDataItem(0) == "SystemError")
-				{
-					operation::getInstance()->tMsg.Msg_SystemError[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_SystemError[1] = readerItem.GetDataItem(1);
-				}
+int db::downloadspecialdaymst(int iCheckStatus)
+{
+    int ret = -1;
+    std::vector<ReaderItem> tResult;
+    std::vector<ReaderItem> selResult;
+    std::string sqlStmt;
+    std::stringstream dbss;
+    int r = -1;
+    int w = -1;
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CSystemError")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_SystemError[1].clear();
-						operation::getInstance()->tMsg.Msg_SystemError[1] = readerItem.GetDataItem(1);
-					}
-				}
+    if (iCheckStatus == 1)
+    {
+        // Check Whether special day mst is downloaded or not
+        sqlStmt = "SELECT name FROM parameter_mst";
+        sqlStmt = sqlStmt + " WHERE name='DownloadSpecialDay' AND s" + std::to_string(operation::getInstance()->gtStation.iSID) + "_fetched=0";
 
-				if (readerItem.GetDataItem(0) == "ValidSeason")
-				{
-					operation::getInstance()->tMsg.Msg_ValidSeason[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_ValidSeason[1] = readerItem.GetDataItem(1);
-				}
+        r = centraldb->SQLSelect(sqlStmt, &tResult, true);
+        if (r != 0)
+        {
+            m_remote_db_err_flag.store(1);
+            operation::getInstance()->writelog("Download Special_Day_mst failed.", "DB");
+            return ret;
+        }
+        else if (tResult.size() == 0)
+        {
+            m_remote_db_err_flag.store(0);
+            operation::getInstance()->writelog("Special_Day_mst download already.", "DB");
+            return -3;
+        }
+    }
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CValidSeason")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_ValidSeason[1].clear();
-						operation::getInstance()->tMsg.Msg_ValidSeason[1] = readerItem.GetDataItem(1);
-					}
-				}
+    r = localdb->SQLExecutNoneQuery("DELETE FROM Special_Day_mst");
+    if (r != 0)
+    {
+        m_local_db_err_flag = 1;
+        operation::getInstance()->writelog("Delete Special_Day_mst from local failed.", "DB");
+        return -1;
+    }
+    else
+    {
+        m_local_db_err_flag = 0;
+    }
 
-				if (readerItem.GetDataItem(0) == "VVIP")
-				{
-					operation::getInstance()->tMsg.Msg_VVIP[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_VVIP[1] = readerItem.GetDataItem(1);
-				}
+    int zone_id = operation::getInstance()->gtStation.iZoneID;
+    operation::getInstance()->writelog("Download Special_Day_mst.", "DB");
+    sqlStmt = "";
+    sqlStmt = "SELECT convert(char(10),Special_Date,103), Rate_Type, Day_Code FROM Special_Day_mst";
+    sqlStmt = sqlStmt + " WHERE Special_Date > getdate()-1 AND (";
+	sqlStmt = sqlStmt + " Zone_ID='" + std::to_string(zone_id) + "'";
+    sqlStmt = sqlStmt + " OR Zone_ID LIKE '" + std::to_string(zone_id) + ",%'";
+    sqlStmt = sqlStmt + " OR Zone_ID LIKE '%," + std::to_string(zone_id) + ",%'";
+    sqlStmt = sqlStmt + " OR Zone_ID LIKE '%," + std::to_string(zone_id) + "'";
+	sqlStmt = sqlStmt + ")";
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CVVIP")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_VVIP[1].clear();
-						operation::getInstance()->tMsg.Msg_VVIP[1] = readerItem.GetDataItem(1);
-					}
-				}
+    r = centraldb->SQLSelect(sqlStmt, &selResult, true);
+    if (r != 0)
+    {
+        m_remote_db_err_flag.store(1);
+        operation::getInstance()->writelog("Download Special_Day_mst failed.", "DB");
+        return ret;
+    }
+    else
+    {
+        m_remote_db_err_flag.store(0);
+    }
 
-				if (readerItem.GetDataItem(0) == "WholeDayParking")
-				{
-					operation::getInstance()->tMsg.Msg_WholeDayParking[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_WholeDayParking[1] = readerItem.GetDataItem(1);
-				}
+    int downloadCount = 0;
+    if (selResult.size() > 0)
+    {
+        for (int j = 0; j < selResult.size(); j++)
+        {
+            w = writespecialday2local(selResult[j].GetDataItem(0), selResult[j].GetDataItem(1), selResult[j].GetDataItem(2));
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CWholeDayParking")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_WholeDayParking[1].clear();
-						operation::getInstance()->tMsg.Msg_WholeDayParking[1] = readerItem.GetDataItem(1);
-					}
-				}
+            if (w == 0)
+            {
+                downloadCount++;
+            }
+        }
 
-				if (readerItem.GetDataItem(0) == "WithIU")
-				{
-					operation::getInstance()->tMsg.Msg_WithIU[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_WithIU[1] = readerItem.GetDataItem(1);
-				}
+        dbss.str("");  // Set the underlying string to an empty string
+    	dbss.clear();   // Clear the state of the stream
+		dbss << "Downloading Special_Day_mst Records: End, Total Record :" << selResult.size() << " ,Downloaded Record :" << downloadCount;
+    	Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+    }
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CWithIU")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.Msg_WithIU[1].clear();
-						operation::getInstance()->tMsg.Msg_WithIU[1] = readerItem.GetDataItem(1);
-					}
-				}
+    if (iCheckStatus == 1)
+    {
+        sqlStmt = "";
+        sqlStmt = "UPDATE parameter_mst set s" + std::to_string(operation::getInstance()->gtStation.iSID) + "_fetched=1";
+        sqlStmt = sqlStmt + " WHERE name='DownloadSpecialDay'";
 
-				if (readerItem.GetDataItem(0) == "BlackList")
-				{
-					operation::getInstance()->tMsg.MsgBlackList[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.MsgBlackList[1] = readerItem.GetDataItem(1);
-				}
+        r = centraldb->SQLExecutNoneQuery(sqlStmt);
+        if (r != 0)
+        {
+            m_remote_db_err_flag.store(1);
+            operation::getInstance()->writelog("Set DownloadSpecialDay fetched=1 failed.", "DB");
+        }
+    }
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CBlackList")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tMsg.MsgBlackList[1].clear();
-						operation::getInstance()->tMsg.MsgBlackList[1] = readerItem.GetDataItem(1);
-					}
-				}
+    if (selResult.size() < 1)
+    {
+        ret = -1;
+    }
+    else
+    {
+        ret = downloadCount;
+    }
 
-				if (readerItem.GetDataItem(0) == "E1enhancedMCParking")
-				{
-					operation::getInstance()->tMsg.Msg_E1enhancedMCParking[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tMsg.Msg_E1enhancedMCParking[1] = readerItem.GetDataItem(1);
-				}
-			}
-		}
-		operation::getInstance()->tProcess.gbloadedLEDMsg = true;
-		return iDBSuccess;
-	}
-	return iNoData;
+    return ret;
 }
 
-DBError db::loadmessage()
+int db::writespecialday2local(std::string special_date, std::string rate_type, std::string day_code)
 {
-	int r = -1;
-	DBError retErr;
-	vector<ReaderItem> ledSelResult;
-	vector<ReaderItem> lcdSelResult;
-
-	r = localdb->SQLSelect("select msg_id, msg_body from message_mst", &ledSelResult, true);
-	if (r != 0)
-	{
-		operation::getInstance()->writelog("load LED message failed.", "DB");
-		return iLocalFail;
-	}
-
-	retErr = loadEntrymessage(ledSelResult);
-	if (retErr == DBError::iNoData)
-	{
-		return retErr;
-	}
+    int r = -1;
+    std::string sqlStmt;
+    std::stringstream dbss;
 
-	r = localdb->SQLSelect("select msg_id, msg_body from message_mst where m_status >= 10", &lcdSelResult, true);
-	if (r != 0)
-	{
-		operation::getInstance()->writelog("load LCD message failed.", "DB");
-		return iLocalFail;
-	}
+    try
+    {
+        sqlStmt = "INSERT INTO Special_Day_mst";
+        sqlStmt = sqlStmt + " (Special_Date, Rate_Type, Day_Code)";
+        sqlStmt = sqlStmt + " VALUES('" + special_date + "'";
+        sqlStmt = sqlStmt + ", " + rate_type;
+        sqlStmt = sqlStmt + ", '" + day_code + "')";
 
-	retErr = loadEntrymessage(lcdSelResult);
-	if (retErr == DBError::iNoData)
-	{
-		return retErr;
-	}
+        r = localdb->SQLExecutNoneQuery(sqlStmt);
+        if (r != 0)
+        {
+            m_local_db_err_flag = 1;
+            dbss.str("");
+            dbss.clear();
+            dbss << "Insert Special_Day_mst to local failed.";
+            Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+        }
+        else
+        {
+            m_local_db_err_flag = 0;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        r = -1;
+        dbss.str("");
+        dbss.clear();
+        dbss << "DB: local db error in writing rec: " << std::string(e.what());
+        Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+        m_local_db_err_flag = 1;
+    }
 
-	return retErr;
+    return r;
 }
 
-DBError db::loadExitLcdAndLedMessage(std::vector<ReaderItem>& selResult)
+int db::downloadratetypeinfo(int iCheckStatus)
 {
-	if (selResult.size() > 0)
-	{
-		for (auto &readerItem : selResult)
-		{
-			if (readerItem.getDataSize() == 2)
-			{
-				if (readerItem.GetDataItem(0) == "BlackList")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_BlackList[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_BlackList[1] = readerItem.GetDataItem(1);
-				}
-
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CBlackList")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_BlackList[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_BlackList[1] = readerItem.GetDataItem(1);
-					}
-				}
-
-				if (readerItem.GetDataItem(0) == "CardError")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_CardError[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_CardError[1] = readerItem.GetDataItem(1);
-				}
-
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CCardError")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_CardError[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_CardError[1] = readerItem.GetDataItem(1);
-					}
-				}
+    int ret = -1;
+    std::vector<ReaderItem> tResult;
+    std::vector<ReaderItem> selResult;
+    std::string sqlStmt;
+    std::stringstream dbss;
+    int r = -1;
+    int w = -1;
 
-				if (readerItem.GetDataItem(0) == "CardIn")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_CardIn[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_CardIn[1] = readerItem.GetDataItem(1);
-				}
+    if (iCheckStatus == 1)
+    {
+        // Check Whether rate type infor is downloaded or not
+        sqlStmt = "SELECT name FROM parameter_mst";
+        sqlStmt = sqlStmt + " WHERE name='DownloadRateTypeInfo' AND s" + std::to_string(operation::getInstance()->gtStation.iSID) + "_fetched=0";
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CCardIn")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_CardIn[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_CardIn[1] = readerItem.GetDataItem(1);
-					}
-				}
+        r = centraldb->SQLSelect(sqlStmt, &selResult, true);
+        if (r != 0)
+        {
+            m_remote_db_err_flag.store(1);
+            operation::getInstance()->writelog("Download Rate_Type_Info failed.", "DB");
+            return ret;
+        }
+        else if (selResult.size() == 0)
+        {
+            m_remote_db_err_flag.store(0);
+            operation::getInstance()->writelog("Rate_Type_Info download already.", "DB");
+            return -3;
+        }
+    }
 
-				if (readerItem.GetDataItem(0) == "Comp2Val")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_Comp2Val[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_Comp2Val[1] = readerItem.GetDataItem(1);
-				}
+    r = localdb->SQLExecutNoneQuery("DELETE FROM Rate_Type_Info");
+    if (r != 0)
+    {
+        m_local_db_err_flag = 1;
+        operation::getInstance()->writelog("Delete Rate_Type_Info from local failed.", "DB");
+        return -1;
+    }
+    else
+    {
+        m_local_db_err_flag = 0;
+    }
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CComp2Val")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_Comp2Val[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_Comp2Val[1] = readerItem.GetDataItem(1);
-					}
-				}
+    int zone_id = operation::getInstance()->gtStation.iZoneID;
+    operation::getInstance()->writelog("Download Rate_Type_Info.", "DB");
+    sqlStmt = "";
+    sqlStmt = "SELECT Rate_Type, Has_Holiday, Has_Holiday_Eve, Has_Special_Day, Has_Init_Free, Has_3Tariff, Has_Zone_Max FROM Rate_Type_Info";
+    sqlStmt = sqlStmt + " WHERE Zone_ID='" + std::to_string(zone_id) + "'";
+    sqlStmt = sqlStmt + " OR Zone_ID LIKE '" + std::to_string(zone_id) + ",%'";
+    sqlStmt = sqlStmt + " OR Zone_ID LIKE '%," + std::to_string(zone_id) + ",%'";
+    sqlStmt = sqlStmt + " OR Zone_ID LIKE '%," + std::to_string(zone_id) + "'";
 
-				if (readerItem.GetDataItem(0) == "CompExpired")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_CompExpired[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_CompExpired[1] = readerItem.GetDataItem(1);
-				}
+    r = centraldb->SQLSelect(sqlStmt, &selResult, true);
+    if (r != 0)
+    {
+        m_remote_db_err_flag.store(1);
+        operation::getInstance()->writelog("Donwload Rate_Type_Info failed.", "DB");
+        return ret;
+    }
+    else
+    {
+        m_remote_db_err_flag.store(0);
+    }
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CCompExpired")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_CompExpired[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_CompExpired[1] = readerItem.GetDataItem(1);
-					}
-				}
+    int downloadCount = 0;
+    if (selResult.size() > 0)
+    {
+        for (int j = 0; j < selResult.size(); j++)
+        {
+            rate_type_info_struct rate_type_info;
+            rate_type_info.rate_type = selResult[j].GetDataItem(0);
+            rate_type_info.has_holiday = selResult[j].GetDataItem(1);
+            rate_type_info.has_holiday_eve = selResult[j].GetDataItem(2);
+            rate_type_info.has_special_day = selResult[j].GetDataItem(3);
+            rate_type_info.has_init_free = selResult[j].GetDataItem(4);
+            rate_type_info.has_3tariff = selResult[j].GetDataItem(5);
+            rate_type_info.has_zone_max = selResult[j].GetDataItem(6);
+            //rate_type_info.has_firstentry_rate = selResult[j].GetDataItem(7);
 
-				if (readerItem.GetDataItem(0) == "Complimentary")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_Complimentary[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_Complimentary[1] = readerItem.GetDataItem(1);
-				}
+            w = writeratetypeinfo2local(rate_type_info);
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CComplimentary")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_Complimentary[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_Complimentary[1] = readerItem.GetDataItem(1);
-					}
-				}
+            if (w == 0)
+            {
+                downloadCount++;
+            }
+        }
 
-				if (readerItem.GetDataItem(0) == "DebitFail")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_DebitFail[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_DebitFail[1] = readerItem.GetDataItem(1);
-				}
+        dbss.str("");  // Set the underlying string to an empty string
+    	dbss.clear();   // Clear the state of the stream
+		dbss << "Downloading Rate_Type_Info Records: End, Total Record :" << selResult.size() << " ,Downloaded Record :" << downloadCount;
+    	Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+    }
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CDebitFail")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_DebitFail[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_DebitFail[1] = readerItem.GetDataItem(1);
-					}
-				}
+    if (iCheckStatus == 1)
+    {
+        sqlStmt = "";
+        sqlStmt = "UPDATE parameter_mst set s" + std::to_string(operation::getInstance()->gtStation.iSID) + "_fetched=1";
+        sqlStmt = sqlStmt + " WHERE name='DownloadRateTypeInfo'";
 
-				if (readerItem.GetDataItem(0) == "DebitNak")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_DebitNak[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_DebitNak[1] = readerItem.GetDataItem(1);
-				}
+        r = centraldb->SQLExecutNoneQuery(sqlStmt);
+        if (r != 0)
+        {
+            m_remote_db_err_flag.store(1);
+            operation::getInstance()->writelog("Set DownloadRateTypeInfo fetched = 1 failed.", "DB");
+        }
+    }
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CDebitNak")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_DebitNak[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_DebitNak[1] = readerItem.GetDataItem(1);
-					}
-				}
+    if (selResult.size() < 1)
+    {
+        ret = -1;
+    }
+    else
+    {
+        ret = downloadCount;
+    }
 
-				if (readerItem.GetDataItem(0) == "EntryDebit")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_EntryDebit[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_EntryDebit[1] = readerItem.GetDataItem(1);
-				}
+    return ret;
+}
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CEntryDebit")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_EntryDebit[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_EntryDebit[1] = readerItem.GetDataItem(1);
-					}
-				}
+int db::writeratetypeinfo2local(rate_type_info_struct rate_type_info)
+{
+    int r = -1;
+    std::string sqlStmt;
+    std::stringstream dbss;
 
-				if (readerItem.GetDataItem(0) == "ExpCard")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_ExpCard[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_ExpCard[1] = readerItem.GetDataItem(1);
-				}
+    try
+    {
+        sqlStmt = "INSERT INTO Rate_Type_Info";
+        sqlStmt = sqlStmt + " (Rate_Type, Has_Holiday, Has_Holiday_Eve, Has_Special_Day, Has_Init_Free, Has_3Tariff, Has_Zone_Max)";
+        sqlStmt = sqlStmt + " VALUES(" + rate_type_info.rate_type;
+        sqlStmt = sqlStmt + ", " + rate_type_info.has_holiday;
+        sqlStmt = sqlStmt + ", " + rate_type_info.has_holiday_eve;
+        sqlStmt = sqlStmt + ", " + rate_type_info.has_special_day;
+        sqlStmt = sqlStmt + ", " + rate_type_info.has_init_free;
+        sqlStmt = sqlStmt + ", " + rate_type_info.has_3tariff;
+        sqlStmt = sqlStmt + ", " + rate_type_info.has_zone_max;
+        sqlStmt = sqlStmt + ")";
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CExpCard")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_ExpCard[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_ExpCard[1] = readerItem.GetDataItem(1);
-					}
-				}
+        r = localdb->SQLExecutNoneQuery(sqlStmt);
+        if (r != 0)
+        {
+            m_local_db_err_flag = 1;
+            dbss.str();
+            dbss.clear();
+            dbss << "Insert Rate_Type_Info to local failed.";
+            Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+        }
+        else
+        {
+            m_local_db_err_flag = 0;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        r = -1;
+        dbss.str("");
+        dbss.clear();
+        dbss << "DB: local db error in writing rec: " << std::string(e.what());
+        Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+        m_local_db_err_flag = 1;
+    }
 
-				if (readerItem.GetDataItem(0) == "FleetCard")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_FleetCard[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_FleetCard[1] = readerItem.GetDataItem(1);
-				}
+    return r;
+}
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CFleetCard")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_FleetCard[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_FleetCard[1] = readerItem.GetDataItem(1);
-					}
-				}
+int db::downloadratemaxinfo(int iCheckStatus)
+{
+    int ret = -1;
+    std::vector<ReaderItem> tResult;
+    std::vector<ReaderItem> selResult;
+    std::string sqlStmt;
+    std::stringstream dbss;
+    int r = -1;
+    int w = -1;
 
-				if (readerItem.GetDataItem(0) == "FreeParking")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_FreeParking[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_FreeParking[1] = readerItem.GetDataItem(1);
-				}
+    if (iCheckStatus == 1)
+    {
+        // Check Whether rate max info is downloaded or not
+        sqlStmt = "SELECT name FROM parameter_mst";
+        sqlStmt = sqlStmt + " WHERE name='DownloadRateMaxInfo' AND s" + std::to_string(operation::getInstance()->gtStation.iSID) + "_fetched=0";
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CFreeParking")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_FreeParking[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_FreeParking[1] = readerItem.GetDataItem(1);
-					}
-				}
+        r = centraldb->SQLSelect(sqlStmt, &selResult, true);
+        if (r != 0)
+        {
+            m_remote_db_err_flag.store(1);
+            operation::getInstance()->writelog("Download Rate_Max_Info failed.", "DB");
+            return ret;
+        }
+        else if (selResult.size() == 0)
+        {
+            m_remote_db_err_flag.store(0);
+            operation::getInstance()->writelog("Rate_Max_Info download already.", "DB");
+            return -3;
+        }
+    }
 
-				if (readerItem.GetDataItem(0) == "GracePeriod")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_GracePeriod[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_GracePeriod[1] = readerItem.GetDataItem(1);
-				}
+    r = localdb->SQLExecutNoneQuery("DELETE FROM Rate_Max_Info");
+    if (r != 0)
+    {
+        m_local_db_err_flag = 1;
+        operation::getInstance()->writelog("Delete Rate_Max_Info from local failed.", "DB");
+        return -1;
+    }
+    else
+    {
+        m_local_db_err_flag = 0;
+    }
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CGracePeriod")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_GracePeriod[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_GracePeriod[1] = readerItem.GetDataItem(1);
-					}
-				}
+    int zone_id = operation::getInstance()->gtStation.iZoneID;
+    operation::getInstance()->writelog("Download Rate_Max_Info.", "DB");
+    sqlStmt = "";
+    sqlStmt = "Select Rate_Type, Day_Type, Start_Time, End_Time, Max_Fee FROM Rate_Max_Info";
+    sqlStmt = sqlStmt + " WHERE Zone_ID='" + std::to_string(zone_id) + "'";
+    sqlStmt = sqlStmt + " OR Zone_ID LIKE '" + std::to_string(zone_id) + ",%'";
+    sqlStmt = sqlStmt + " OR Zone_ID LIKE '%," + std::to_string(zone_id) + ",%'";
+    sqlStmt = sqlStmt + " OR Zone_ID LIKE '%," + std::to_string(zone_id) + "'";
 
-				if (readerItem.GetDataItem(0) == "InvalidTicket")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_InvalidTicket[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_InvalidTicket[1] = readerItem.GetDataItem(1);
-				}
+    r = centraldb->SQLSelect(sqlStmt, &selResult, true);
+    if (r != 0)
+    {
+        m_remote_db_err_flag.store(1);
+        operation::getInstance()->writelog("Donwload Rate_Max_Info failed.", "DB");
+        return ret;
+    }
+    else
+    {
+        m_remote_db_err_flag.store(0);
+    }
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CInvalidTicket")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_InvalidTicket[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_InvalidTicket[1] = readerItem.GetDataItem(1);
-					}
-				}
+    int downloadCount = 0;
+    if (selResult.size() > 0)
+    {
+        for (int j = 0; j < selResult.size(); j++)
+        {
+            rate_max_info_struct rate_max_info;
+            rate_max_info.rate_type = selResult[j].GetDataItem(0);
+            rate_max_info.day_type = selResult[j].GetDataItem(1);
+            rate_max_info.start_time = selResult[j].GetDataItem(2);
+            rate_max_info.end_time = selResult[j].GetDataItem(3);
+            rate_max_info.max_fee = selResult[j].GetDataItem(4);
 
-				if (readerItem.GetDataItem(0) == "WrongTicket")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_WrongTicket[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_WrongTicket[1] = readerItem.GetDataItem(1);
-				}
+            w = writeratemaxinfo2local(rate_max_info);
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CWrongTicket")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_WrongTicket[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_WrongTicket[1] = readerItem.GetDataItem(1);
-					}
-				}
+            if (w == 0)
+            {
+                downloadCount++;
+            }
+        }
 
-				if (readerItem.GetDataItem(0) == "RedemptionExpired")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_RedemptionExpired[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_RedemptionExpired[1] = readerItem.GetDataItem(1);
-				}
+        dbss.str("");  // Set the underlying string to an empty string
+    	dbss.clear();   // Clear the state of the stream
+		dbss << "Downloading Rate_Max_Info Records: End, Total Record :" << selResult.size() << " ,Downloaded Record :" << downloadCount;
+    	Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+    }
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CRedemptionExpired")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_RedemptionExpired[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_RedemptionExpired[1] = readerItem.GetDataItem(1);
-					}
-				}
+    if (iCheckStatus == 1)
+    {
+        sqlStmt = "";
+        sqlStmt = "UPDATE parameter_mst set s" + std::to_string(operation::getInstance()->gtStation.iSID) + "_fetched=1";
+        sqlStmt = sqlStmt + " WHERE name='DownloadRateMaxInfo'";
 
-				if (readerItem.GetDataItem(0) == "IUProblem")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_IUProblem[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_IUProblem[1] = readerItem.GetDataItem(1);
-				}
+        r = centraldb->SQLExecutNoneQuery(sqlStmt);
+        if (r != 0)
+        {
+            m_remote_db_err_flag.store(1);
+            operation::getInstance()->writelog("Set DownloadRateMaxInfo fetched = 1 failed.", "DB");
+        }
+    }
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CIUProblem")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_IUProblem[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_IUProblem[1] = readerItem.GetDataItem(1);
-					}
-				}
+    if (selResult.size() < 1)
+    {
+        ret = -1;
+    }
+    else
+    {
+        ret = downloadCount;
+    }
 
-				if (readerItem.GetDataItem(0) == "MasterSeason")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_MasterSeason[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_MasterSeason[1] = readerItem.GetDataItem(1);
-				}
+    return ret;
+}
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CMasterSeason")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_MasterSeason[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_MasterSeason[1] = readerItem.GetDataItem(1);
-					}
-				}
+int db::writeratemaxinfo2local(rate_max_info_struct rate_max_info)
+{
+    int r = -1;
+    std::string sqlStmt;
+    std::stringstream dbss;
 
-				if (readerItem.GetDataItem(0) == "NoEntry")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_NoEntry[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_NoEntry[1] = readerItem.GetDataItem(1);
-				}
+    try
+    {
+        sqlStmt = "INSERT INTO Rate_Max_Info";
+        sqlStmt = sqlStmt + " (Rate_Type, Day_Type, Start_Time, End_Time, Max_Fee)";
+        sqlStmt = sqlStmt + " VALUES(" + rate_max_info.rate_type;
+        sqlStmt = sqlStmt + ", '" + rate_max_info.day_type + "'";
+        sqlStmt = sqlStmt + ", '" + rate_max_info.start_time + "'";
+        sqlStmt = sqlStmt + ", '" + rate_max_info.end_time + "'";
+        sqlStmt = sqlStmt + ", " + rate_max_info.max_fee;
+        sqlStmt = sqlStmt + ")";
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CNoEntry")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_NoEntry[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_NoEntry[1] = readerItem.GetDataItem(1);
-					}
-				}
+        r = localdb->SQLExecutNoneQuery(sqlStmt);
+        if (r != 0)
+        {
+            m_local_db_err_flag = 1;
+            dbss.str();
+            dbss.clear();
+            dbss << "Insert Rate_Type_Info to local failed.";
+            Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+        }
+        else
+        {
+            m_local_db_err_flag = 0;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        r = -1;
+        dbss.str("");
+        dbss.clear();
+        dbss << "DB: local db error in writing rec: " << std::string(e.what());
+        Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+        m_local_db_err_flag = 1;
+    }
 
-				if (readerItem.GetDataItem(0) == "RedemptionTicket")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_RedemptionTicket[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_RedemptionTicket[1] = readerItem.GetDataItem(1);
-				}
+    return r;
+}
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CRedemptionTicket")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_RedemptionTicket[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_RedemptionTicket[1] = readerItem.GetDataItem(1);
-					}
-				}
+DBError db::loadstationsetup()
+{
+	ConfigRows rows;
+	FetchStationSetupRows(rows);
+	return ApplyStationSetupRows(rows);
+}
 
-				if (readerItem.GetDataItem(0) == "SeasonBlocked")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_SeasonBlocked[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_SeasonBlocked[1] = readerItem.GetDataItem(1);
-				}
+void db::FetchStationSetupRows(ConfigRows& rows)
+{
+	int giStnid;
+	giStnid = operation::getInstance()->gtStation.iSID;
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CSeasonBlocked")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_SeasonBlocked[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_SeasonBlocked[1] = readerItem.GetDataItem(1);
-					}
-				}
+	rows.ret = selectConfig("SELECT * FROM Station_Setup WHERE StationId = '" + std::to_string(giStnid) + "'", &rows.rows, false);
+}
 
-				if (readerItem.GetDataItem(0) == "SeasonExpired")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_SeasonExpired[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_SeasonExpired[1] = readerItem.GetDataItem(1);
-				}
+DBError db::ApplyStationSetupRows(ConfigRows& rows)
+{
+	vector<ReaderItem>& selResult = rows.rows;
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CSeasonExpired")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_SeasonExpired[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_SeasonExpired[1] = readerItem.GetDataItem(1);
-					}
-				}
+	if (rows.ret != 0)
+	{
+		operation::getInstance()->writelog("get station set up fail.", "DB");
+		return iLocalFail;
+	}
 
-				if (readerItem.GetDataItem(0) == "SeasonInvalid")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_SeasonInvalid[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_SeasonInvalid[1] = readerItem.GetDataItem(1);
-				}
+	if (selResult.size() > 0)
+	{            
+		//Set configuration
+		operation::getInstance()->gtStation.iSID = std::stoi(selResult[0].GetDataItem(0));
+		operation::getInstance()->gtStation.sName = selResult[0].GetDataItem(1);
+		switch (std::stoi(selResult[0].GetDataItem(2)))
+		{
+		case 1:
+			operation::getInstance()->gtStation.iType = tientry;
+			break;
+		case 2:
+			operation::getInstance()->gtStation.iType = tiExit;
+			break;
+		default:
+			break;
+		};
+		operation::getInstance()->gtStation.iStatus = std::stoi(selResult[0].GetDataItem(3));
+		operation::getInstance()->gtStation.sPCName = selResult[0].GetDataItem(4);
+		operation::getInstance()->gtStation.iCHUPort = std::stoi(selResult[0].GetDataItem(5));
+		operation::getInstance()->gtStation.iAntID = std::stoi(selResult[0].GetDataItem(6));
+		operation::getInstance()->gtStation.iZoneID = std::stoi(selResult[0].GetDataItem(7));
+		operation::getInstance()->gtStation.iIsVirtual = std::stoi(selResult[0].GetDataItem(8));
+		switch(std::stoi(selResult[0].GetDataItem(9)))
+		{
+		case 0:
+			operation::getInstance()->gtStation.iSubType = iNormal;
+			break;
+		case 1:
+			operation::getInstance()->gtStation.iSubType = iXwithVENoPay;
+			break;
+		case 2:
+			operation::getInstance()->gtStation.iSubType = iXwithVEPay;
+			break;
+		default:
+			break;
+		};
+		operation::getInstance()->gtStation.iVirtualID = std::stoi(selResult[0].GetDataItem(10));
+		operation::getInstance()->tProcess.gbloadedStnSetup = true;
+		return iDBSuccess;
+	}
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CSeasonInvalid")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_SeasonInvalid[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_SeasonInvalid[1] = readerItem.GetDataItem(1);
-					}
-				}
+	return iNoData; 
+};
 
-				if (readerItem.GetDataItem(0) == "SeasonNotStart")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_SeasonNotStart[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_SeasonNotStart[1] = readerItem.GetDataItem(1);
-				}
+int db::downloadTR()
+{
+	int ret = -1;
+	int r = -1;
+	int w = -1;
+	std::vector<ReaderItem> tResult;
+	std::vector<ReaderItem> selResult;
+	std::string sqlStmt;
+	std::stringstream dbss;
+	int tr_type;
+	int line_no;
+	int enabled;
+	std::string line_text;
+	std::string line_var;
+	int line_font;
+	int line_align;
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CSeasonNotStart")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_SeasonNotStart[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_SeasonNotStart[1] = readerItem.GetDataItem(1);
-					}
-				}
+	sqlStmt = "SELECT COUNT(*) from TR_mst ";
+	sqlStmt = sqlStmt + "where TRType = 1 or TRType = 2 or TRType = 6 or TRType = 11 or TRType = 12";
 
-				if (readerItem.GetDataItem(0) == "SeasonOnly")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_SeasonOnly[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_SeasonOnly[1] = readerItem.GetDataItem(1);
-				}
+	r = centraldb->SQLSelect(sqlStmt, &tResult, false);
+	if (r != 0)
+	{
+		m_remote_db_err_flag.store(1);
+		operation::getInstance()->writelog("download TR fail.", "DB");
+		return ret;
+	}
+	else
+	{
+		m_remote_db_err_flag.store(0);
+		dbss.str("");
+		dbss.clear();
+		dbss << "Total " << std::string(tResult[0].GetDataItem(0)) << " TR type to be download.";
+		Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+	}
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CSeasonOnly")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_SeasonOnly[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_SeasonOnly[1] = readerItem.GetDataItem(1);
-					}
-				}
+	sqlStmt = "";
+	sqlStmt.clear();
+	sqlStmt = "SELECT TRType, Line_no, Enabled, LineText, LineVar, LineFont, LineAlign from TR_mst ";
+	sqlStmt = sqlStmt + "where TRType = 1 or TRType = 2 or TRType = 6 or TRType = 11 or TRType = 12";
+	r = centraldb->SQLSelect(sqlStmt, &selResult, true);
+	if (r != 0)
+	{
+		m_remote_db_err_flag.store(1);
+		operation::getInstance()->writelog("download TR faile.", "DB");
+		return ret;
+	}
+	else
+	{
+		m_remote_db_err_flag.store(0);
+	}
 
-				if (readerItem.GetDataItem(0) == "SeasonPassback")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_SeasonPassback[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_SeasonPassback[1] = readerItem.GetDataItem(1);
-				}
+	int downloadCount = 0;
+	if (selResult.size() > 0)
+	{
+		dbss.str("");
+		dbss.clear();
+		dbss << "Downloading TR " << std::to_string(selResult.size()) << " Records: Started";
+		Logger::getInstance()->FnLog(dbss.str(), "", "DB");
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CSeasonPassback")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_SeasonPassback[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_SeasonPassback[1] = readerItem.GetDataItem(1);
-					}
-				}
+		for (int j = 0; j < selResult.size(); j++)
+		{
+			tr_type = std::stoi(selResult[j].GetDataItem(0));
+			line_no = std::stoi(selResult[j].GetDataItem(1));
+			enabled = std::stoi(selResult[j].GetDataItem(2));
+			line_text = selResult[j].GetDataItem(3);
+			line_var = selResult[j].GetDataItem(4);
+			line_font = std::stoi(selResult[j].GetDataItem(5));
+			line_align = std::stoi(selResult[j].GetDataItem(6));
 
-				if (readerItem.GetDataItem(0) == "SeasonRegNoIU")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_SeasonRegNoIU[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_SeasonRegNoIU[1] = readerItem.GetDataItem(1);
-				}
+			w = writetr2local(tr_type, line_no, enabled, line_text, line_var, line_font, line_align);
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CSeasonRegNoIU")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_SeasonRegNoIU[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_SeasonRegNoIU[1] = readerItem.GetDataItem(1);
-					}
-				}
+			if (w == 0)
+			{
+				downloadCount++;
+				m_remote_db_err_flag.store(0);
+			}
+		}
+		dbss.str("");
+		dbss.clear();
+		dbss << "Downloading TR Records, End, Total Record :" << selResult.size() << " , Downloaded Record :" << downloadCount;
+		Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+	}
 
-				if (readerItem.GetDataItem(0) == "SeasonRegOK")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_SeasonRegOK[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_SeasonRegOK[1] = readerItem.GetDataItem(1);
-				}
+	ret = downloadCount;
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CSeasonRegOK")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_SeasonRegOK[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_SeasonRegOK[1] = readerItem.GetDataItem(1);
-					}
-				}
+	return ret;
+}
 
-				if (readerItem.GetDataItem(0) == "SeasonTerminated")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_SeasonTerminated[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_SeasonTerminated[1] = readerItem.GetDataItem(1);
-				}
+int db::writetr2local(int tr_type, int line_no, int enabled, std::string line_text, std::string line_var, int line_font, int line_align)
+{
+	int r = -1;
+	int debug = 0;
+	std::string sqlStmt;
+	vector<ReaderItem> selResult;
+	std::stringstream dbss;
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CSeasonTerminated")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_SeasonTerminated[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_SeasonTerminated[1] = readerItem.GetDataItem(1);
-					}
-				}
+	try
+	{
+		r = localdb->SQLSelect("SELECT * FROM TR_mst where TRType =" + std::to_string(tr_type) + " and Line_no = " + std::to_string(line_no), &selResult, false);
+		if (r != 0)
+		{
+			m_local_db_err_flag = 1;
+			operation::getInstance()->writelog("Update local TR failed.", "DB");
+			return r;
+		}
+		else
+		{
+			m_local_db_err_flag = 0;
+		}
 
-				if (readerItem.GetDataItem(0) == "SystemError")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_SystemError[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_SystemError[1] = readerItem.GetDataItem(1);
-				}
+		if (selResult.size() > 0)
+		{
+			// Update param records
+			std::string sqlStmt = "UPDATE TR_mst SET ";
+			sqlStmt += "TRType = " + std::to_string(tr_type) + ", ";
+			sqlStmt += "Line_no = " + std::to_string(line_no) + ", ";
+			sqlStmt += "Enabled = " + std::to_string(enabled) + ", ";
+			sqlStmt += "LineText = '" + line_text + "', ";
+			sqlStmt += "LineVar = '" + line_var + "', ";
+			sqlStmt += "LineFont = " + std::to_string(line_font) + ", ";
+			sqlStmt += "LineAlign = " + std::to_string(line_align) + " ";
+			sqlStmt += "WHERE TRType = " + std::to_string(tr_type) + " AND ";
+			sqlStmt += "Line_no = " + std::to_string(line_no);
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CSystemErrord")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_SystemError[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_SystemError[1] = readerItem.GetDataItem(1);
-					}
-				}
+			r = localdb->SQLExecutNoneQuery(sqlStmt);
+			if (r != 0)
+			{
+				m_local_db_err_flag = 1;
+				dbss.str("");
+				dbss.clear();
+				dbss << "update local TR failed.";
+				Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+			}
+			else
+			{
+				m_local_db_err_flag = 0;
+			}
+		}
+		else
+		{
+			sqlStmt = "INSERT INTO TR_mst";
+			sqlStmt = sqlStmt + " (TRType, Line_no, Enabled, LineText, LineVar, LineFont, LineAlign)";
+			sqlStmt = sqlStmt + " VALUES (" + std::to_string(tr_type);
+			sqlStmt = sqlStmt + "," + std::to_string(line_no);
+			sqlStmt = sqlStmt + "," + std::to_string(enabled);
+			sqlStmt = sqlStmt + ",'" + line_text + "'";
+			sqlStmt = sqlStmt + ",'" + line_var + "'";
+			sqlStmt = sqlStmt + "," + std::to_string(line_font);
+			sqlStmt = sqlStmt + "," + std::to_string(line_align) + ")";
 
-				if (readerItem.GetDataItem(0) == "TakeCard")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_TakeCard[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_TakeCard[1] = readerItem.GetDataItem(1);
-				}
+			r = localdb->SQLExecutNoneQuery(sqlStmt);
+			if (r != 0)
+			{
+				m_local_db_err_flag = 1;
+				dbss.str("");
+				dbss.clear();
+				dbss << "insert TR to local failed";
+				Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+			}
+			else
+			{
+				m_local_db_err_flag = 0;
+			}
+		}
+	}
+	catch (const std::exception & e)
+	{
+		r = -1;
+		dbss.str("");
+		dbss.clear();
+		dbss << "DB: local db error in writing rec: " << std::string(e.what());
+		Logger::getInstance()->FnLog(dbss.str(), "", "DB");
+		m_local_db_err_flag = 1;
+	}
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CTakeCard")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_TakeCard[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_TakeCard[1] = readerItem.GetDataItem(1);
-					}
-				}
+	return r;
+}
 
-				if (readerItem.GetDataItem(0) == "TicketExpired")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_TicketExpired[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_TicketExpired[1] = readerItem.GetDataItem(1);
-				}
+DBError db::loadParam()
+{
+	ParamRows rows;
+	FetchParamRows(rows);
+	return ApplyParamRows(rows);
+}
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CTicketExpired")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_TicketExpired[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_TicketExpired[1] = readerItem.GetDataItem(1);
-					}
-				}
+void db::FetchParamRows(ParamRows& rows)
+{
+	rows.zoneEntries.ret = selectConfig("SELECT StationID FROM Station_Setup WHERE StationType = 1 and ZoneID = '" + std::to_string(operation::getInstance()->gtStation.iZoneID) + "'", &rows.zoneEntries.rows, false);
+	//------
+	// A replayed boot has no central DB yet, the lane's centralparams boot phase loads these once it is up
+	if (!ConfigSnapshot::getInstance()->FnIsReplaying())
+	{
+		FetchCentralParams(rows.central);
+		rows.hasCentral = true;
+	}
+	//------
+	rows.params.ret = selectConfig("SELECT ParamName, ParamValue FROM Param_mst", &rows.params.rows, true);
+}
 
-				if (readerItem.GetDataItem(0) == "TicketNotFound")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_TicketNotFound[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_TicketNotFound[1] = readerItem.GetDataItem(1);
-				}
+DBError db::ApplyParamRows(ParamRows& rows)
+{
+	if ((rows.zoneEntries.ret == 0) && (rows.zoneEntries.rows.size() > 0))
+	{
+		operation::getInstance()->tParas.gsZoneEntries = ",";
+		for (auto& readerItem : rows.zoneEntries.rows)
+		{
+			operation::getInstance()->tParas.gsZoneEntries = operation::getInstance()->tParas.gsZoneEntries + readerItem.GetDataItem(0) + ",";
+		}
+		operation::getInstance()->writelog("Load ZoneEntries from Local: " + operation::getInstance()->tParas.gsZoneEntries , "DB");
+	}
+	//------
+	if (rows.hasCentral)
+	{
+		ApplyCentralParams(rows.central);
+	}
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CTicketNotFound")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_TicketNotFound[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_TicketNotFound[1] = readerItem.GetDataItem(1);
-					}
-				}
+	operation::getInstance()->tParas.giTariffFeeMode = 0;   // for tesing, please help to load late 
+	//------
+	if (rows.params.ret != 0)
+	{
+		operation::getInstance()->writelog("load parameter failed.", "DB");
+		return iLocalFail;
+	}
 
-				if (readerItem.GetDataItem(0) == "UsedTicket")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_UsedTicket[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_UsedTicket[1] = readerItem.GetDataItem(1);
-				}
+	if (rows.params.rows.size() > 0)
+	{
+		FieldTable<tParas_Struct>::ApplyReport report = ParamTable::FnGetParamTable().FnApply(operation::getInstance()->tParas, rows.params.rows);
+		logFieldReport("Param_mst", report.unknown, report.malformed);
+		operation::getInstance()->tProcess.gbloadedParam = true;
+        return iDBSuccess;
+	}
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CUsedTicket")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_UsedTicket[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_UsedTicket[1] = readerItem.GetDataItem(1);
-					}
-				}
+	return iNoData;
+}
 
-				if (readerItem.GetDataItem(0) == "WrongCard")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_WrongCard[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_WrongCard[1] = readerItem.GetDataItem(1);
-				}
+void db::logFieldReport(const std::string& tableName, const std::vector<std::string>& unknown, const std::vector<std::string>& malformed)
+{
+	if (!unknown.empty())
+	{
+		std::stringstream ss;
+		ss << tableName << " has " << unknown.size() << " unknown names: " << boost::algorithm::join(unknown, ", ");
+		Logger::getInstance()->FnLog(ss.str(), "", "DB");
+	}
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CWrongCard")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_WrongCard[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_WrongCard[1] = readerItem.GetDataItem(1);
-					}
-				}
+	if (!malformed.empty())
+	{
+		std::stringstream ss;
+		ss << tableName << " has " << malformed.size() << " malformed values, kept the previous ones: " << boost::algorithm::join(malformed, ", ");
+		Logger::getInstance()->FnLog(ss.str(), "", "DB");
+	}
+}
 
-				if (readerItem.GetDataItem(0) == "XCardAgain")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_XCardAgain[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_XCardAgain[1] = readerItem.GetDataItem(1);
-				}
+int db::selectConfig(const std::string& statement, std::vector<ReaderItem>* result, bool fullResult)
+{
+	return ConfigSnapshot::getInstance()->FnSelect(localdb, statement, result, fullResult);
+}
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CXCardAgain")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_XCardAgain[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_XCardAgain[1] = readerItem.GetDataItem(1);
-					}
-				}
+std::vector<std::string> db::FnRevalidateConfigSnapshot()
+{
+	return ConfigSnapshot::getInstance()->FnRevalidate(localdb);
+}
 
-				if (readerItem.GetDataItem(0) == "XCardTaken")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_XCardTaken[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_XCardTaken[1] = readerItem.GetDataItem(1);
-				}
+DBError db::loadparamfromCentral()
+{
+	CentralParams params;
+	DBError r = FetchCentralParams(params);
+	ApplyCentralParams(params);
+	return r;
+}
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CXCardTaken")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_XCardTaken[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_XCardTaken[1] = readerItem.GetDataItem(1);
-					}
-				}
+DBError db::FetchCentralParams(CentralParams& params)
+{
+	int r;
+	vector<ReaderItem> tResult;
 
-				if (readerItem.GetDataItem(0) == "XDefaultIU")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_XDefaultIU[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_XDefaultIU[1] = readerItem.GetDataItem(1);
-				}
+	operation::getInstance()->writelog ("Load parameter from Centaral DB", "DB");
+	
+	r = centraldb->SQLSelect("SELECT group_id,site_id FROM site_setup", &tResult, true);
+	if (r != 0)
+	{
+		return iCentralFail;
+	}
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CXDefaultIU")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_XDefaultIU[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_XDefaultIU[1] = readerItem.GetDataItem(1);
-					}
-				}
 
-				if (readerItem.GetDataItem(0) == "XDefaultLED")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_XDefaultLED[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_XDefaultLED[1] = readerItem.GetDataItem(1);
-				}
+	if (tResult.size()>0)
+	{
+		params.iGroupID = std::stoi(tResult[0].GetDataItem(0));
+		params.iSite = std::stoi(tResult[0].GetDataItem(1));
+		params.hasSite = true;
+	}
+	
+	r = centraldb->SQLSelect("SELECT entry_station FROM counter_definition where zone_id = " + to_string(operation::getInstance()->gtStation.iZoneID) , &tResult, true);
+	if (r != 0)
+	{
+		return iCentralFail;
+	}
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CXDefaultLED")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_XDefaultLED[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_XDefaultLED[1] = readerItem.GetDataItem(1);
-					}
-				}
+	if (tResult.size()>0)
+	{
+		params.sZoneEntries = "," + tResult[0].GetDataItem(0) + ",";
+		params.hasZoneEntries = true;
+	}
 
-				if (readerItem.GetDataItem(0) == "XDefaultLED2")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_XDefaultLED2[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_XDefaultLED2[1] = readerItem.GetDataItem(1);
-				}
+	r = centraldb->SQLSelect("SELECT Max(receipt_no) FROM exit_trans where station_id  = " + to_string(operation::getInstance()->gtStation.iSID) , &tResult, true);
+	if (r != 0)
+	{
+		return iCentralFail;
+	}
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CXDefaultLED2")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_XDefaultLED2[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_XDefaultLED2[1] = readerItem.GetDataItem(1);
-					}
-				}
+	if (tResult.size()>0)
+	{
+		int l; 
+		string A;
+		A = std::to_string(operation::getInstance()->gtStation.iSID);
+		l = tResult[0].GetDataItem(0).length() - A.length();
+		A = tResult[0].GetDataItem(0).substr(0,l);
 
-				if (readerItem.GetDataItem(0) == "XExpiringSeason")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_XExpiringSeason[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_XExpiringSeason[1] = readerItem.GetDataItem(1);
-				}
+		operation::getInstance()->writelog ("Load Last Receipt No: " + A, "DB");
+		try
+		{
+			params.lLastSerialNo = std::stol(A);
+			params.hasLastSerialNo = true;
+		}
+		catch (const std::exception& e)
+		{
+			operation::getInstance()->writelog ("Exception: " + std::string(e.what()), "DB");
+		}
+	
+		return iDBSuccess;
+	}
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CXExpiringSeason")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_XExpiringSeason[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_XExpiringSeason[1] = readerItem.GetDataItem(1);
-					}
-				}
+	return iNoData;
 
-				if (readerItem.GetDataItem(0) == "XIdle")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_XIdle[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_XIdle[1] = readerItem.GetDataItem(1);
-				}
+}
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CXIdle")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_XIdle[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_XIdle[1] = readerItem.GetDataItem(1);
-					}
-				}
+void db::ApplyCentralParams(const CentralParams& params)
+{
+	if (params.hasSite)
+	{
+		operation::getInstance()->tParas.giGroupID = params.iGroupID;
+		operation::getInstance()->tParas.giSite = params.iSite;
+		operation::getInstance()->writelog ("Load Group ID: " + std::to_string(operation:: getInstance()->tParas.giGroupID), "DB");
+		operation::getInstance()->writelog ("Load Site ID: " + std::to_string(operation:: getInstance()->tParas.giSite), "DB");
+	}
 
-				if (readerItem.GetDataItem(0) == "XLoopA")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_XLoopA[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_XLoopA[1] = readerItem.GetDataItem(1);
-				}
+	if (params.hasZoneEntries)
+	{
+		operation::getInstance()->tParas.gsZoneEntries = params.sZoneEntries;
+		operation::getInstance()->writelog ("Load zone for entry: " + operation:: getInstance()->tParas.gsZoneEntries, "DB");
+	}
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CXLoopA")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_XLoopA[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_XLoopA[1] = readerItem.GetDataItem(1);
-					}
-				}
+	if (params.hasLastSerialNo)
+	{
+		operation::getInstance()->tProcess.glLastSerialNo = params.lLastSerialNo;
+	}
+}
 
-				if (readerItem.GetDataItem(0) == "XLowBal")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_XLowBal[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_XLowBal[1] = readerItem.GetDataItem(1);
-				}
+DBError db::loadvehicletype()
+{
+	ConfigRows rows;
+	FetchVehicleTypeRows(rows);
+	return ApplyVehicleTypeRows(rows);
+}
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CXLowBal")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_XLowBal[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_XLowBal[1] = readerItem.GetDataItem(1);
-					}
-				}
+void db::FetchVehicleTypeRows(ConfigRows& rows)
+{
+	rows.ret = selectConfig("SELECT IUCode, TransType FROM Vehicle_type", &rows.rows, true);
+}
 
-				if (readerItem.GetDataItem(0) == "XNoCard")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_XNoCard[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_XNoCard[1] = readerItem.GetDataItem(1);
-				}
+DBError db::ApplyVehicleTypeRows(ConfigRows& rows)
+{
+	if (rows.ret != 0)
+	{
+		operation::getInstance()->writelog("load Trans Type failed.", "DB");
+		return iLocalFail;
+	}
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CXNoCard")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_XNoCard[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_XNoCard[1] = readerItem.GetDataItem(1);
-					}
-				}
+	if (rows.rows.size() > 0)
+	{
+		// A reload replaces the table, it is not appended to the one loaded at boot
+		operation::getInstance()->tVType.clear();
+		for (auto &readerItem : rows.rows)
+		{
+			if (readerItem.getDataSize() == 2)
+			{
+				operation::getInstance()->tVType.push_back({std::stoi(readerItem.GetDataItem(0)), std::stoi(readerItem.GetDataItem(1))});
+			}
+		}
+		operation::getInstance()->tProcess.gbloadedVehtype = true;
+		return iDBSuccess;
+	}
+	return iNoData;
+}
 
-				if (readerItem.GetDataItem(0) == "XNoCHU")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_XNoCHU[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_XNoCHU[1] = readerItem.GetDataItem(1);
-				}
+int db::FnGetVehicleType(std::string IUCode)
+{
+	int ret = 1;
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CXNoCHU")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_XNoCHU[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_XNoCHU[1] = readerItem.GetDataItem(1);
-					}
-				}
+	for (auto &item : operation::getInstance()->tVType)
+	{
+		if (item.iIUCode == std::stoi(IUCode))
+		{
+			ret = item.iType;
+			break;
+		}
+	}
 
-				if (readerItem.GetDataItem(0) == "XNoIU")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_XNoIU[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_XNoIU[1] = readerItem.GetDataItem(1);
-				}
+	return ret;
+}
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CXNoIU")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_XNoIU[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_XNoIU[1] = readerItem.GetDataItem(1);
-					}
-				}
+DBError db::loadEntrymessage(std::vector<ReaderItem>& selResult, bool isReportingUnknown)
+{
+	if (selResult.size()>0)
+	{
+		FieldTable<tMsg_Struct>::ApplyReport report = ParamTable::FnGetEntryMessageTable().FnApply(operation::getInstance()->tMsg, selResult);
 
-				if (readerItem.GetDataItem(0) == "XSameLastIU")
+		// message_mst also holds the exit messages, only names neither side knows are reported
+		if (isReportingUnknown)
+		{
+			std::vector<std::string> unknown;
+			for (const auto& name : report.unknown)
+			{
+				if (ParamTable::FnGetExitMessageTable().FnFind(name) == nullptr)
 				{
-					operation::getInstance()->tExitMsg.MsgExit_XSameLastIU[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_XSameLastIU[1] = readerItem.GetDataItem(1);
+					unknown.push_back(name);
 				}
+			}
+			logFieldReport("message_mst", unknown, report.malformed);
+		}
+		operation::getInstance()->tProcess.gbloadedLEDMsg = true;
+		return iDBSuccess;
+	}
+	return iNoData;
+}
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CXSameLastIU")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_XSameLastIU[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_XSameLastIU[1] = readerItem.GetDataItem(1);
-					}
-				}
+DBError db::loadmessage()
+{
+	MessageRows rows;
+	FetchMessageRows(rows);
+	return ApplyEntryMessageRows(rows);
+}
 
-				if (readerItem.GetDataItem(0) == "XSeasonWithinAllowance")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_XSeasonWithinAllowance[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_XSeasonWithinAllowance[1] = readerItem.GetDataItem(1);
-				}
+void db::FetchMessageRows(MessageRows& rows)
+{
+	rows.led.ret = selectConfig("select msg_id, msg_body from message_mst", &rows.led.rows, true);
+	if (rows.led.ret == 0)
+	{
+		rows.lcd.ret = selectConfig("select msg_id, msg_body from message_mst where m_status >= 10", &rows.lcd.rows, true);
+	}
+}
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CXSeasonWithinAllowance")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_XSeasonWithinAllowance[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_XSeasonWithinAllowance[1] = readerItem.GetDataItem(1);
-					}
-				}
+DBError db::ApplyEntryMessageRows(MessageRows& rows)
+{
+	DBError retErr;
 
-				if (readerItem.GetDataItem(0) == "XValidSeason")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_XValidSeason[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_XValidSeason[1] = readerItem.GetDataItem(1);
-				}
+	if (rows.led.ret != 0)
+	{
+		operation::getInstance()->writelog("load LED message failed.", "DB");
+		return iLocalFail;
+	}
 
-				// Update LCD Message
-				if (readerItem.GetDataItem(0) == "CXValidSeason")
-				{
-					if ((!readerItem.GetDataItem(1).empty()) && (boost::algorithm::to_lower_copy(readerItem.GetDataItem(1)) != "null"))
-					{
-						operation::getInstance()->tExitMsg.MsgExit_XValidSeason[1].clear();
-						operation::getInstance()->tExitMsg.MsgExit_XValidSeason[1] = readerItem.GetDataItem(1);
-					}
-				}
+	retErr = loadEntrymessage(rows.led.rows, true);
+	if (retErr == DBError::iNoData)
+	{
+		return retErr;
+	}
 
-				if (readerItem.GetDataItem(0) == "X1enhancedMCParking")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_X1enhancedMCParking[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_X1enhancedMCParking[1] = readerItem.GetDataItem(1);
-				}
+	if (rows.lcd.ret != 0)
+	{
+		operation::getInstance()->writelog("load LCD message failed.", "DB");
+		return iLocalFail;
+	}
 
-				if (readerItem.GetDataItem(0) == "XenhancedMCParking")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_XenhancedMCParking[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_XenhancedMCParking[1] = readerItem.GetDataItem(1);
-				}
+	// The LCD rows were reported with the first pass
+	retErr = loadEntrymessage(rows.lcd.rows, false);
+	if (retErr == DBError::iNoData)
+	{
+		return retErr;
+	}
 
-				if (readerItem.GetDataItem(0) == "XSPT3Parking")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_XSPT3Parking[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_XSPT3Parking[1] = readerItem.GetDataItem(1);
-				}
+	return retErr;
+}
 
-				if (readerItem.GetDataItem(0) == "XVIPHolderParking")
-				{
-					operation::getInstance()->tExitMsg.MsgExit_XVIPHolderParking[0] = readerItem.GetDataItem(1);
-					operation::getInstance()->tExitMsg.MsgExit_XVIPHolderParking[1] = readerItem.GetDataItem(1);
-				}
-			}
-		}
+DBError db::loadExitLcdAndLedMessage(std::vector<ReaderItem>& selResult)
+{
+	if (selResult.size() > 0)
+	{
+		// Unknown names are reported by the entry message load, message_mst is shared
+		ParamTable::FnGetExitMessageTable().FnApply(operation::getInstance()->tExitMsg, selResult);
 		operation::getInstance()->tProcess.gbloadedLEDExitMsg = true;
 		return iDBSuccess;
 	}
@@ -5424,32 +3008,34 @@ DBError db::loadExitLcdAndLedMessage(std::vector<ReaderItem>& selResult)
 
 DBError db::loadExitmessage()
 {
-	int r = -1;
+	MessageRows rows;
+	FetchMessageRows(rows);
+	return ApplyExitMessageRows(rows);
+}
+
+DBError db::ApplyExitMessageRows(MessageRows& rows)
+{
 	DBError retErr;
-	vector<ReaderItem> exitLedSelResult;
-	vector<ReaderItem> exitLcdSelResult;
 
-	r = localdb->SQLSelect("select msg_id, msg_body from message_mst", &exitLedSelResult, true);
-	if (r != 0)
+	if (rows.led.ret != 0)
 	{
 		operation::getInstance()->writelog("load Exit LED message failed.", "DB");
 		return iLocalFail;
 	}
 
-	retErr = loadExitLcdAndLedMessage(exitLedSelResult);
+	retErr = loadExitLcdAndLedMessage(rows.led.rows);
 	if (retErr == DBError::iNoData)
 	{
 		return retErr;
 	}
 
-	r = localdb->SQLSelect("select msg_id, msg_body from message_mst where m_status >= 10", &exitLcdSelResult, true);
-	if (r != 0)
+	if (rows.lcd.ret != 0)
 	{
 		operation::getInstance()->writelog("load Exit LCD message failed.", "DB");
 		return iLocalFail;
 	}
 
-	retErr = loadExitLcdAndLedMessage(exitLcdSelResult);
+	retErr = loadExitLcdAndLedMessage(rows.lcd.rows);
 	if (retErr == DBError::iNoData)
 	{
 		return retErr;
@@ -5460,9 +3046,13 @@ DBError db::loadExitmessage()
 
 DBError db::loadTR(int iType)
 {
-	int r = -1;
-	DBError retErr;
-	vector<ReaderItem> trSelResult;
+	ConfigRows rows;
+	FetchTRRows(rows, iType);
+	return ApplyTRRows(rows);
+}
+
+void db::FetchTRRows(ConfigRows& rows, int iType)
+{
 	std::string sqlStmt;
 	//----
 	iType = 2;
@@ -5470,8 +3060,14 @@ DBError db::loadTR(int iType)
 	sqlStmt = "SELECT LineText, LineVar, LineFont, LineAlign from TR_mst";
 	sqlStmt = sqlStmt + " WHERE TRType=" + std::to_string(iType) + " AND Enabled = 1 ORDER BY Line_no";
 
-	r = localdb->SQLSelect(sqlStmt, &trSelResult, true);
-	if (r != 0)
+	rows.ret = selectConfig(sqlStmt, &rows.rows, true);
+}
+
+DBError db::ApplyTRRows(ConfigRows& rows)
+{
+	vector<ReaderItem>& trSelResult = rows.rows;
+
+	if (rows.ret != 0)
 	{
 		operation::getInstance()->writelog("load LTR failed.", "DB");
 		return iLocalFail;
@@ -5480,6 +3076,8 @@ DBError db::loadTR(int iType)
 	if (trSelResult.size() > 0)
 	{
 		int i = 0;
+		// A reload replaces the formats, it is not appended to the ones loaded at boot
+		operation::getInstance()->tTR.clear();
 		for (int j = 0; j < trSelResult.size(); j++)
 		{
 			struct tTR_struc tr;
@@ -5519,181 +3117,149 @@ string  db::GetPartialSeasonMsg(int iTransType)
 	return "";
 }
 
-void db::moveOfflineTransToCentral()
+int db::CountOfflineTrans(Ctrl_Type ctrl, const string& sStationID)
 {
-	time_t vfdate,vtdate;
-	CE_Time vfdt,vtdt;
-	int r=-1;// success flag
-	std::string tableNm="";
-	tEntryTrans_Struct ter;
-	tExitTrans_Struct tex;
-	int s=-1;
-	int s1=-1;
-	Ctrl_Type ctrl;
-	vector<ReaderItem> selResult;
 	vector<ReaderItem> tResult;
+	std::string sqlStmt = "SELECT count(iu_tk_no) FROM ";
+	sqlStmt = sqlStmt + ((ctrl == s_Entry) ? "Entry_Trans" : "Exit_Trans");
+	if (!sStationID.empty())
+	{
+		sqlStmt = sqlStmt + " WHERE Station_ID = '" + sStationID + "'";
+	}
+
+	int r = localdb->SQLSelect(sqlStmt, &tResult, false);
+	if ((r != 0) || (tResult.size() < 1))
+	{
+		m_local_db_err_flag = 1;
+		return -1;
+	}
+
+	m_local_db_err_flag = 0;
+	return std::stoi(tResult[0].GetDataItem(0));
+}
+
+int db::FetchOfflineEntryTrans(const string& sStationID, int iLimit, vector<tEntryTrans_Struct>& trans)
+{
+	vector<ReaderItem> selResult;
 	std::string sqlStmt;
-	int j;
-	int d=-1;
-	int k;
 
-	operation::getInstance()->tProcess.offline_status=0;
-	
-	if(operation::getInstance()->gtStation.iType==tientry)
+	try
 	{
-		r = localdb->SQLSelect("SELECT count(iu_tk_no) FROM Entry_Trans",&tResult,false);
-		if(r!=0) {
+		sqlStmt= "SELECT Station_ID,Entry_Time,iu_tk_No,";
+		sqlStmt=sqlStmt + "trans_type,Status";
+		sqlStmt=sqlStmt + ",TK_SerialNo";
+		sqlStmt=sqlStmt + ",Card_Type";
+		sqlStmt=sqlStmt + ",card_no,paid_amt,parking_fee";
+		sqlStmt=sqlStmt +  ",gst_amt";
+		sqlStmt = sqlStmt + ",lpn";
+		sqlStmt= sqlStmt+ " FROM Entry_Trans";
+		if (!sStationID.empty())
+		{
+			sqlStmt = sqlStmt + " WHERE Station_ID = '" + sStationID + "'";
+		}
+		// Oldest first, the upload resumes from the oldest row still here
+		sqlStmt= sqlStmt+ " ORDER by Entry_Time asc LIMIT " + std::to_string(iLimit);
+
+		int r = localdb->SQLSelect(sqlStmt,&selResult,true);
+		if(r!=0)
+		{
 			m_local_db_err_flag=1;
-			operation::getInstance()->writelog("move offline data fail.","DB");
-			return;
+			return -1;
 		}
-		else 
+		m_local_db_err_flag=0;
+
+		for(auto& row : selResult)
 		{
-			m_local_db_err_flag=0;
-			k=std::stoi(tResult[0].GetDataItem(0));
-			if (k>0){
-				operation::getInstance()->writelog("Total " + std::string (tResult[0].GetDataItem(0)) + " Entry trans to be upload.","DB");
-				operation::getInstance()->tProcess.offline_status=1;
-			}
+			tEntryTrans_Struct ter;
+			ter.esid=row.GetDataItem(0);
+			ter.sEntryTime=row.GetDataItem(1);
+			ter.sIUTKNo=row.GetDataItem(2);
+			ter.iTransType=std::stoi(row.GetDataItem(3));
+			ter.iStatus=std::stoi(row.GetDataItem(4));
+			ter.sSerialNo=row.GetDataItem(5);
+			ter.iCardType=std::stoi(row.GetDataItem(6));
+			ter.sCardNo=row.GetDataItem(7);
+			ter.sPaidAmt=std::stof(row.GetDataItem(8));
+			ter.sFee=std::stof(row.GetDataItem(9));
+			ter.sGSTAmt=std::stof(row.GetDataItem(10));
+			ter.sLPN[0] = row.GetDataItem(11);
+			trans.push_back(ter);
 		}
 	}
-	else if(operation::getInstance()->gtStation.iType==tiExit)
+	catch (const std::exception &e)
 	{
-		
-		r= localdb->SQLSelect("SELECT count(iu_tk_no) FROM Exit_Trans",&tResult,false);
-		if(r!=0) m_local_db_err_flag=1;
-		else 
-		{
-			m_local_db_err_flag=0;
-			k=std::stoi(tResult[0].GetDataItem(0));
-			if(k > 0){
-				operation::getInstance()->writelog("Total " + std::string (tResult[0].GetDataItem(0)) + " Enxit trans to be upload.", "DB");
-			  	operation::getInstance()->tProcess.offline_status=1;
-			}
-		}
+		operation::getInstance()->writelog("DB: FetchOfflineEntryTrans error: " + std::string(e.what()),"DB");
+		m_local_db_err_flag=1;
+		return -1;
 	}
-	
-	if (operation::getInstance()->tProcess.offline_status ==0) {return;}
+	return 0;
+}
 
-	try {
-		if(operation::getInstance()->gtStation.iType==tientry)
+int db::FetchOfflineExitTrans(const string& sStationID, int iLimit, vector<tExitTrans_Struct>& trans)
+{
+	vector<ReaderItem> selResult;
+	std::string sqlStmt;
+
+	try
+	{
+		sqlStmt= "SELECT Station_ID,Exit_Time,iu_tk_No,";
+		sqlStmt=sqlStmt + "card_mc_no,trans_type,status,";
+		sqlStmt=sqlStmt + "parked_time,Parking_Fee,Paid_Amt,Receipt_No,";
+		sqlStmt=sqlStmt + "Redeem_amt,Redeem_time,Redeem_no";
+		sqlStmt=sqlStmt +  ",gst_amt,chu_debit_code,Card_Type,Top_Up_Amt";
+		sqlStmt = sqlStmt + ",lpn,Entry_ID, entry_time";
+		sqlStmt= sqlStmt+ " FROM Exit_Trans";
+		if (!sStationID.empty())
 		{
-			tableNm="Entry_Trans";
-			ctrl=s_Entry;
-			std::string dtFormat= std::string(1, '"')+ "%Y-%m-%d %H:%i:%s" + std::string(1, '"') ;
-			sqlStmt= "SELECT Station_ID,Entry_Time,iu_tk_No,";
-			sqlStmt=sqlStmt + "trans_type,Status";
-			sqlStmt=sqlStmt + ",TK_SerialNo";
-			sqlStmt=sqlStmt + ",Card_Type";
-			sqlStmt=sqlStmt + ",card_no,paid_amt,parking_fee";
-			sqlStmt=sqlStmt +  ",gst_amt";
-			sqlStmt = sqlStmt + ",lpn";
-			sqlStmt= sqlStmt+ " FROM " + tableNm  + " ORDER by Entry_Time desc";
+			sqlStmt = sqlStmt + " WHERE Station_ID = '" + sStationID + "'";
 		}
-		else if(operation::getInstance()->gtStation.iType==tiExit)
+		// Oldest first, the upload resumes from the oldest row still here
+		sqlStmt= sqlStmt+ " ORDER by Exit_Time asc LIMIT " + std::to_string(iLimit);
+
+		int r = localdb->SQLSelect(sqlStmt,&selResult,true);
+		if(r!=0)
 		{
-			tableNm="Exit_Trans";
-			ctrl=s_Exit;
-			std::string dtFormat= std::string(1, '"')+ "%Y-%m-%d %H:%i:%s" + std::string(1, '"') ;
-
-			sqlStmt= "SELECT Station_ID,Exit_Time,iu_tk_No,";
-			sqlStmt=sqlStmt + "card_mc_no,trans_type,status,";
-			sqlStmt=sqlStmt + "parked_time,Parking_Fee,Paid_Amt,Receipt_No,";
-			sqlStmt=sqlStmt + "Redeem_amt,Redeem_time,Redeem_no";
-			sqlStmt=sqlStmt +  ",gst_amt,chu_debit_code,Card_Type,Top_Up_Amt";
-			sqlStmt = sqlStmt + ",lpn,Entry_ID, entry_time";
-			
-			sqlStmt= sqlStmt+ " FROM " + tableNm  + " ORDER by Exit_Time desc";
+			m_local_db_err_flag=1;
+			return -1;
 		}
-		
-		r = localdb->SQLSelect(sqlStmt,&selResult,true);
-		if(r!=0) m_local_db_err_flag=1;
-		else  m_local_db_err_flag=0;
-
-		if (selResult.size()>0){
-			operation::getInstance()->writelog("uploading  " + std::to_string (selResult.size()) + " Records: Started", "DB");
-			for(j=0;j<selResult.size();j++){
-				
-				if(operation::getInstance()->gtStation.iType==tientry)
-				{
-					ter.esid=selResult[j].GetDataItem(0);
-					ter.sEntryTime=selResult[j].GetDataItem(1);
-					ter.sIUTKNo=selResult[j].GetDataItem(2);
-					ter.iTransType=std::stoi(selResult[j].GetDataItem(3));
-					ter.iStatus=std::stoi(selResult[j].GetDataItem(4));
-					ter.sSerialNo=selResult[j].GetDataItem(5);
-					ter.iCardType=std::stoi(selResult[j].GetDataItem(6));
-					ter.sCardNo=selResult[j].GetDataItem(7);
-					ter.sPaidAmt=std::stof(selResult[j].GetDataItem(8));
-					ter.sFee=std::stof(selResult[j].GetDataItem(9));
-					ter.sGSTAmt=std::stof(selResult[j].GetDataItem(10));
-					ter.sLPN[0] = selResult[j].GetDataItem(11);
-					
-					s=insertTransToCentralEntryTransTmp(ter);
-				}
-				else if(operation::getInstance()->gtStation.iType==tiExit) 
-				{
-					tex.xsid=selResult[j].GetDataItem(0);
-					tex.sExitTime=selResult[j].GetDataItem(1);
-					tex.sIUNo=selResult[j].GetDataItem(2);
-					tex.sCardNo=selResult[j].GetDataItem(3);
-					tex.iTransType=std::stoi(selResult[j].GetDataItem(4));
-					tex.iStatus=std::stoi(selResult[j].GetDataItem(5));
-					tex.lParkedTime=std::stoi(selResult[j].GetDataItem(6));
-					tex.sFee=std::stof(selResult[j].GetDataItem(7));
-					tex.sPaidAmt=std::stof(selResult[j].GetDataItem(8));
-					tex.sReceiptNo=selResult[j].GetDataItem(9);
-					tex.sRedeemAmt=std::stof(selResult[j].GetDataItem(10));
-					tex.iRedeemTime=std::stoi(selResult[j].GetDataItem(11));
-					tex.sRedeemNo=selResult[j].GetDataItem(12);
-					tex.sGSTAmt=std::stof(selResult[j].GetDataItem(13));
-					tex.sCHUDebitCode=selResult[j].GetDataItem(14);
-					tex.iCardType=std::stoi(selResult[j].GetDataItem(15));
-					tex.sTopupAmt=std::stof(selResult[j].GetDataItem(16));
-					tex.lpn = selResult[j].GetDataItem(17);
-					tex.iEntryID = std::stoi(selResult[j].GetDataItem(18));
-					tex.sEntryTime = selResult[j].GetDataItem(19);
-					
-					s=insertTransToCentralExitTransTmp(tex);
-					
-				}
-				
-				//insert record into central DB
-
-				if (s==0)
-				{
-			
-					if(operation::getInstance()->gtStation.iType==tientry){
-						d=deleteLocalTrans (ter.sIUTKNo,ter.sEntryTime,ctrl);
-					}
-					else{
-						s1=DeleteBeforeInsertMT(tex);
-						s1=insert2movementtrans(tex);
-						d=deleteLocalTrans (tex.sIUNo,tex.sExitTime,ctrl);
-					}
-					if (d==0) m_local_db_err_flag=0;
-					else m_local_db_err_flag=1;
-
+		m_local_db_err_flag=0;
 
-					//-----------------------
-					m_remote_db_err_flag.store(0);
-				}
-				else m_remote_db_err_flag.store(1);     
-			}
-			operation::getInstance()->writelog("uploading trans Records: End","DB");
-		}       
+		for(auto& row : selResult)
+		{
+			tExitTrans_Struct tex;
+			tex.xsid=row.GetDataItem(0);
+			tex.sExitTime=row.GetDataItem(1);
+			tex.sIUNo=row.GetDataItem(2);
+			tex.sCardNo=row.GetDataItem(3);
+			tex.iTransType=std::stoi(row.GetDataItem(4));
+			tex.iStatus=std::stoi(row.GetDataItem(5));
+			tex.lParkedTime=std::stoi(row.GetDataItem(6));
+			tex.sFee=std::stof(row.GetDataItem(7));
+			tex.sPaidAmt=std::stof(row.GetDataItem(8));
+			tex.sReceiptNo=row.GetDataItem(9);
+			tex.sRedeemAmt=std::stof(row.GetDataItem(10));
+			tex.iRedeemTime=std::stoi(row.GetDataItem(11));
+			tex.sRedeemNo=row.GetDataItem(12);
+			tex.sGSTAmt=std::stof(row.GetDataItem(13));
+			tex.sCHUDebitCode=row.GetDataItem(14);
+			tex.iCardType=std::stoi(row.GetDataItem(15));
+			tex.sTopupAmt=std::stof(row.GetDataItem(16));
+			tex.lpn = row.GetDataItem(17);
+			tex.iEntryID = std::stoi(row.GetDataItem(18));
+			tex.sEntryTime = row.GetDataItem(19);
+			trans.push_back(tex);
+		}
 	}
 	catch (const std::exception &e)
 	{
-		r=-1;// success flag
-		// cout << "ERROR: " << err << endl;
-		operation::getInstance()->writelog("DB: moveOfflineTransToCentral error: " + std::string(e.what()),"DB");
+		operation::getInstance()->writelog("DB: FetchOfflineExitTrans error: " + std::string(e.what()),"DB");
 		m_local_db_err_flag=1;
-	} 
-
+		return -1;
+	}
+	return 0;
 }
 
-int db::insertTransToCentralEntryTransTmp(tEntryTrans_Struct ter)
+int db::insertTransToCentralEntryTransTmp(tEntryTrans_Struct ter, std::size_t* sentBytes)
 {
 
 	int r=0;
@@ -5704,8 +3270,10 @@ int db::insertTransToCentralEntryTransTmp(tEntryTrans_Struct ter)
 	
 	//operation::getInstance()->writelog("Central DB: INSERT IUNo= " + ter.sIUTKNo +" and EntryTime="+ ter.sEntryTime  + " INTO "+ tbName +" : Started","DB");
 
-	// insert into Central trans tmp table
-	sqstr="INSERT INTO " + tbName +" (Station_ID,Entry_Time,IU_Tk_No,trans_type,status,TK_Serialno,Card_Type";
+	// insert into Central trans tmp table, unless a run cut short after this insert already did
+	std::string sKey = "Station_ID='" + ter.esid + "' AND Entry_Time=convert(datetime,'" + ter.sEntryTime + "',120) AND IU_Tk_No='" + ter.sIUTKNo + "'";
+	sqstr="IF NOT EXISTS (SELECT 1 FROM " + tbName + " WHERE " + sKey + ") AND NOT EXISTS (SELECT 1 FROM Entry_Trans WHERE " + sKey + ") ";
+	sqstr=sqstr + "INSERT INTO " + tbName +" (Station_ID,Entry_Time,IU_Tk_No,trans_type,status,TK_Serialno,Card_Type";
 	sqstr=sqstr + ",card_no,paid_amt,parking_fee";        
 	sqstr=sqstr + ",gst_amt,lpn";
 	sqstr=sqstr + ") Values ('" + ter.esid+ "',convert(datetime,'" + ter.sEntryTime+ "',120),'" + ter.sIUTKNo;
@@ -5716,6 +3284,7 @@ int db::insertTransToCentralEntryTransTmp(tEntryTrans_Struct ter)
 	sqstr = sqstr + "','" + std::to_string(ter.sGSTAmt)+"','"+ter.sLPN[0]+"'";
 	sqstr = sqstr +  ")";
 
+	if (sentBytes != nullptr) *sentBytes = sqstr.size();
 	r = centraldb->SQLExecutNoneQuery(sqstr);
 
 	//operation::getInstance()->writelog(sqstr,"DB");
@@ -5731,7 +3300,7 @@ int db::insertTransToCentralEntryTransTmp(tEntryTrans_Struct ter)
 }
 
 
-int db::insertTransToCentralExitTransTmp(const tExitTrans_Struct& tex)
+int db::insertTransToCentralExitTransTmp(const tExitTrans_Struct& tex, std::size_t* sentBytes)
 {
 
 	int r=0;
@@ -5743,8 +3312,10 @@ int db::insertTransToCentralExitTransTmp(const tExitTrans_Struct& tex)
 	
 	operation::getInstance()->writelog("Central DB: INSERT IUNo= " + tex.sIUNo +" and ExitTime="+ tex.sExitTime  + " INTO "+ tbName +" : Started","DB");
 
-	// insert into Central trans tmp table
-	sqstr="INSERT INTO " + tbName +" (Station_ID,Exit_Time,IU_Tk_No,card_mc_no,trans_type,parked_time,parking_fee,paid_amt,receipt_no,status";
+	// insert into Central trans tmp table, unless a run cut short after this insert already did
+	std::string sKey = "Station_ID='" + tex.xsid + "' AND Exit_Time=convert(datetime,'" + tex.sExitTime + "',120) AND IU_Tk_No='" + tex.sIUNo + "'";
+	sqstr="IF NOT EXISTS (SELECT 1 FROM " + tbName + " WHERE " + sKey + ") AND NOT EXISTS (SELECT 1 FROM Exit_Trans WHERE " + sKey + ") ";
+	sqstr=sqstr + "INSERT INTO " + tbName +" (Station_ID,Exit_Time,IU_Tk_No,card_mc_no,trans_type,parked_time,parking_fee,paid_amt,receipt_no,status";
 	sqstr=sqstr + ",redeem_amt,redeem_time,redeem_no";        
 	sqstr=sqstr + ",gst_amt,chu_debit_code,card_type,top_up_amt";
 	sqstr=sqstr + ") Values ('" + tex.xsid+ "',convert(datetime,'" + tex.sExitTime+ "',120),'" + tex.sIUNo;
@@ -5756,6 +3327,7 @@ int db::insertTransToCentralExitTransTmp(const tExitTrans_Struct& tex)
 	sqstr = sqstr +  "','" +std::to_string(tex.sTopupAmt)+"'";
 	sqstr = sqstr +  ")";
 
+	if (sentBytes != nullptr) *sentBytes = sqstr.size();
 	r = centraldb->SQLExecutNoneQuery(sqstr);
 	
 	if (r==0) operation::getInstance()->writelog("Central DB: INSERT IUNo= " + tex.sIUNo +" and ExitTime="+ tex.sExitTime  + " INTO "+ tbName +" : Success","DB");
@@ -6028,25 +3600,26 @@ int db::updateEntryTrans(string lpn, string sTransID)
 {
 
 	int r=0;
+	long rowsAffected=0;
 	string sqstr="";
 
 	// insert into Central trans tmp table
 
 	sqstr="UPDATE Entry_trans_tmp set lpn = '"+ lpn + "' WHERE entry_lpn_sid = '"+ sTransID + "'";
 	
-	r = centraldb->SQLExecutNoneQuery(sqstr);
+	r = centraldb->SQLExecutNoneQuery(sqstr, &rowsAffected);
 
 	if (r==0) 
 	{
-		if (centraldb->NumberOfRowsAffected > 0){
+		if (rowsAffected > 0){
 			operation::getInstance()->writelog("Success update LPR to Entry_Trans_Tmp","DB");
 		}else
 		{
 			sqstr="UPDATE Entry_trans set lpn = '"+ lpn + "' WHERE entry_lpn_sid = '"+ sTransID + "'";
-			r = centraldb->SQLExecutNoneQuery(sqstr);
+			r = centraldb->SQLExecutNoneQuery(sqstr, &rowsAffected);
 
 			if (r==0) {
-				if (centraldb->NumberOfRowsAffected > 0)
+				if (rowsAffected > 0)
 				{
 					operation::getInstance()->writelog("Success update LPR to Entry_Trans","DB");
 					m_remote_db_err_flag.store(0);
@@ -6070,25 +3643,26 @@ int db::updateExitTrans(string lpn, string sTransID)
 {
 
 	int r=0;
+	long rowsAffected=0;
 	string sqstr="";
 
 	// insert into Central trans tmp table
 
 	sqstr="UPDATE Exit_trans_tmp set lpn = '"+ lpn + "' WHERE exit_lpn_sid = '"+ sTransID + "'";
 	
-	r = centraldb->SQLExecutNoneQuery(sqstr);
+	r = centraldb->SQLExecutNoneQuery(sqstr, &rowsAffected);
 
 	if (r==0) 
 	{
-		if (centraldb->NumberOfRowsAffected > 0){
+		if (rowsAffected > 0){
 			operation::getInstance()->writelog("Success update LPR to Exit_Trans_Tmp","DB");
 		}else
 		{
 			sqstr="UPDATE exit_trans set lpn = '"+ lpn + "' WHERE exit_lpn_sid = '"+ sTransID + "'";
-			r = centraldb->SQLExecutNoneQuery(sqstr);
+			r = centraldb->SQLExecutNoneQuery(sqstr, &rowsAffected);
 
 			if (r==0) {
-				if (centraldb->NumberOfRowsAffected > 0)
+				if (rowsAffected > 0)
 				{
 					operation::getInstance()->writelog("Success update LPR to Exit_Trans","DB");
 					m_remote_db_err_flag.store(0);
@@ -6243,25 +3817,26 @@ int db::updateExitReceiptNo(string sReceiptNo, string StnID)
 {
 
 	int r=0;
+	long rowsAffected=0;
 	string sqstr="";
 
 	// insert into Central trans tmp table
 
 	sqstr="UPDATE Exit_trans_tmp set receipt_no = '"+ sReceiptNo + "' WHERE station_id = '"+ StnID + "' and Exit_time = '"+ operation::getInstance()->tExit.sExitTime + "'";
 	
-	r = centraldb->SQLExecutNoneQuery(sqstr);
+	r = centraldb->SQLExecutNoneQuery(sqstr, &rowsAffected);
 
 	if (r==0) 
 	{
-		if (centraldb->NumberOfRowsAffected > 0){
+		if (rowsAffected > 0){
 			operation::getInstance()->writelog("Success update Receipt No to Exit_Trans_Tmp","DB");
 		}else
 		{
 			sqstr="UPDATE exit_trans set receipt_no = '"+ sReceiptNo + "' WHERE station_id = '"+ StnID + "' and Exit_time = '"+ operation::getInstance()->tExit.sExitTime + "'";
-			r = centraldb->SQLExecutNoneQuery(sqstr);
+			r = centraldb->SQLExecutNoneQuery(sqstr, &rowsAffected);
 
 			if (r==0) {
-				if (centraldb->NumberOfRowsAffected > 0)
+				if (rowsAffected > 0)
 				{
 					operation::getInstance()->writelog("Success update Receipt No to Exit_Trans","DB");
 					m_remote_db_err_flag.store(0);
@@ -6281,7 +3856,7 @@ int db::updateExitReceiptNo(string sReceiptNo, string StnID)
 	return r;
 }
 
-DBError db::LoadTariff()
+DBError db::LoadTariff(TariffSnapshot* builder)
 {
 
 	std::string sqlStmt;
@@ -6292,6 +3867,7 @@ DBError db::LoadTariff()
 	std::string sValue;
 	int r,j,k,i;
 	tariff_struct t;
+	TariffSnapshot loaded;
 	int w=-1;
 	int bTried=0;
 
@@ -6306,7 +3882,7 @@ DBError db::LoadTariff()
 
 	//	operation::getInstance()->writelog(sqlStmt, "DB");
 
-		r=localdb->SQLSelect(sqlStmt,&selResult,true);
+		r=selectConfig(sqlStmt,&selResult,true);
 		if (r!=0) return iLocalFail;
 		if (selResult.size()>0){
 			for(j=0;j<selResult.size();j++){
@@ -6349,12 +3925,16 @@ DBError db::LoadTariff()
 				{
 					t.dtype= std::stoi(tmpStr[i]);
 				//	operation::getInstance()->writelog("loading day_Type = "+ std::to_string(t.dtype), "DB");
-					w=WriteTariff2RAM(t);
+					w=WriteTariff2RAM(loaded, t);
 				//	operation::getInstance()->writelog("loadingA next", "DB");	
 				}
 				//operation::getInstance()->writelog("loading next", "DB");	
 			}
 
+			publishTariff(tbName, [&loaded](TariffSnapshot& next)
+			{
+				next.tariffs = std::move(loaded.tariffs);
+			}, builder);
 			operation::getInstance()->writelog("Load tariff parameters: success","DB");
 
 			return iDBSuccess;
@@ -6381,13 +3961,8 @@ DBError db::LoadTariff()
 
 }
 
-int db::WriteTariff2RAM(tariff_struct t)
+int db::WriteTariff2RAM(TariffSnapshot& tariff, const tariff_struct& t)
 {
-
-	time_t vfdate,vtdate;
-	CE_Time vfdt,vtdt;
-	int r=-1;// success flag
-	int debug=0;
 	int a,b;
 
 	a=t.dtype/8;
@@ -6398,37 +3973,55 @@ int db::WriteTariff2RAM(tariff_struct t)
 		a=a-1;
 		if(a<0)a=0;
 	}
-	
-	gtariff[a][b].day_type=std::to_string(t.dtype);
-
-	gtariff[a][b].tariff_id =t.tariff_id;
-	gtariff[a][b].day_index =t.day_index;		
-	for(int k=0;k<9;k++){
-		gtariff[a][b].start_time[k] =t.start_time[k];
-		gtariff[a][b].end_time[k] =t.end_time[k];
-		gtariff[a][b].rate_type[k] =t.rate_type[k];
-		gtariff[a][b].charge_time_block[k] =t.charge_time_block[k];
-		gtariff[a][b].charge_rate[k] =t.charge_rate[k];
-		gtariff[a][b].grace_time[k] =t.grace_time[k];
-		gtariff[a][b].first_free[k] =t.first_free[k];
-		gtariff[a][b].first_add[k] =t.first_add[k];
-		gtariff[a][b].second_free[k] =t.second_free[k];
-		gtariff[a][b].second_add[k] =t.second_add[k];
-		gtariff[a][b].third_free[k] =t.third_free[k];
-		gtariff[a][b].third_add[k] =t.third_add[k];
-		gtariff[a][b].allowance[k] =t.allowance[k];
-		gtariff[a][b].min_charge[k] =t.min_charge[k];
-		gtariff[a][b].max_charge[k] =t.max_charge[k];
-	}
-	gtariff[a][b].zone_cutoff =t.zone_cutoff;
-	gtariff[a][b].day_cutoff =t.day_cutoff;
-	gtariff[a][b].whole_day_max =t.whole_day_max;
-	gtariff[a][b].whole_day_min =t.whole_day_min;
+
+	tariff_struct& dayTariff = tariff.tariffs[TariffSnapshot::FnMakeKey(a, b)];
+	dayTariff = t;
+	dayTariff.day_type=std::to_string(t.dtype);
 	
 	return(1);
 }
 
-DBError db::LoadHoliday()
+std::shared_ptr<const TariffSnapshot> db::FnGetTariffSnapshot() const
+{
+	return std::atomic_load_explicit(&tariffSnapshot_, std::memory_order_acquire);
+}
+
+// Copies the current version, lets update replace one table and publishes the copy as the next version.
+// Readers never wait: the ones that pinned the old version finish with it, the next ones see the new one.
+void db::publishTariff(const std::string& tableName, const std::function<void(TariffSnapshot&)>& update, TariffSnapshot* builder)
+{
+	if (builder != nullptr)
+	{
+		update(*builder);
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(tariffMutex_);
+	auto next = std::make_shared<TariffSnapshot>(*FnGetTariffSnapshot());
+	update(*next);
+	next->version++;
+	std::atomic_store_explicit(&tariffSnapshot_, std::shared_ptr<const TariffSnapshot>(std::move(next)), std::memory_order_release);
+
+	operation::getInstance()->writelog("Tariff version " + std::to_string(FnGetTariffSnapshot()->version) + " published, reloaded " + tableName, "DB");
+}
+
+TariffSnapshot db::FnBeginTariffReload() const
+{
+	return *FnGetTariffSnapshot();
+}
+
+// A reload replaces whole tables, so the last of two overlapping reloads wins with all of its tables
+void db::FnPublishTariff(TariffSnapshot builder, const std::string& tableNames)
+{
+	std::lock_guard<std::mutex> lock(tariffMutex_);
+	auto next = std::make_shared<TariffSnapshot>(std::move(builder));
+	next->version = FnGetTariffSnapshot()->version + 1;
+	std::atomic_store_explicit(&tariffSnapshot_, std::shared_ptr<const TariffSnapshot>(std::move(next)), std::memory_order_release);
+
+	operation::getInstance()->writelog("Tariff version " + std::to_string(FnGetTariffSnapshot()->version) + " published, reloaded " + tableNames, "DB");
+}
+
+DBError db::LoadHoliday(TariffSnapshot* builder)
 {
 
 	std::string sqlStmt;
@@ -6450,20 +4043,25 @@ DBError db::LoadHoliday()
 		sqlStmt="Select date_format(holiday_date,'%Y-%m-%d') as YourDateAsString ";
 		sqlStmt= sqlStmt +  " FROM " + tbName + " Order by holiday_date";
 
-		r=localdb->SQLSelect(sqlStmt,&selResult,true);
+		r=selectConfig(sqlStmt,&selResult,true);
 		if (r!=0) return iLocalFail;
 
 		if (selResult.size()>0){
 		
-			msholiday.clear();
+			std::vector<std::string> holidays;
 		
 			for(j=0;j<selResult.size();j++){
 				
 				sValue=selResult[j].GetDataItem(0);
-				msholiday.push_back(sValue);
+				holidays.push_back(sValue);
 
 			}
 
+			publishTariff(tbName, [&holidays](TariffSnapshot& next)
+			{
+				next.holidays = std::move(holidays);
+			}, builder);
+
 			operation::getInstance()->writelog("Load holiday: success", "DB");
 
 			return iDBSuccess;
@@ -6518,7 +4116,7 @@ DBError db::ClearHoliday()
 }
 
 
-int db::GetDayTypeWithHE(CE_Time curr_date)
+int db::GetDayTypeWithHE(const TariffSnapshot& tariff, CE_Time curr_date)
 {
 	int iRet;
 	CE_Time next_date;
@@ -6533,8 +4131,8 @@ int db::GetDayTypeWithHE(CE_Time curr_date)
 	{
 		if(iRet!=7)
 		{
-			for(int i=0; i<msholiday.size();i++){
-				if(next_date.DateString().compare(msholiday[i])==0)
+			for(int i=0; i<tariff.holidays.size();i++){
+				if(next_date.DateString().compare(tariff.holidays[i])==0)
 				{
 					iRet=8;
 					break;
@@ -6543,8 +4141,8 @@ int db::GetDayTypeWithHE(CE_Time curr_date)
 		}
 	}
 	
-	for(int i=0; i<msholiday.size();i++){
-		if(curr_date.DateString().compare(msholiday[i])==0)
+	for(int i=0; i<tariff.holidays.size();i++){
+		if(curr_date.DateString().compare(tariff.holidays[i])==0)
 		{
 			iRet=7;
 			return(iRet);
@@ -6553,18 +4151,18 @@ int db::GetDayTypeWithHE(CE_Time curr_date)
 	return(iRet);
 }
 
-int db::GetDayTypeNoPE(CE_Time curr_date)
+int db::GetDayTypeNoPE(const TariffSnapshot& tariff, CE_Time curr_date)
 {
 	int iRet;
 //	operation::getInstance()->writelog("check day type, no holiday eve", "DB");
 //	operation::getInstance()->writelog("Current day: " + curr_date.DateString(), "DB");
 
 	iRet=curr_date.getweekday();
-	for(int i=0; i<msholiday.size();i++){
+	for(int i=0; i<tariff.holidays.size();i++){
 
-//		operation::getInstance()->writelog("holiday: " + msholiday[i], "DB");
+//		operation::getInstance()->writelog("holiday: " + tariff.holidays[i], "DB");
 
-		if(curr_date.DateString().compare(msholiday[i])==0)
+		if(curr_date.DateString().compare(tariff.holidays[i])==0)
 		{
 			iRet=8;
 			return(iRet);
@@ -6574,12 +4172,17 @@ int db::GetDayTypeNoPE(CE_Time curr_date)
 }
 
 int db::GetDayType(CE_Time curr_date)
+{
+	return GetDayType(*FnGetTariffSnapshot(), curr_date);
+}
+
+int db::GetDayType(const TariffSnapshot& tariff, CE_Time curr_date)
 {
 	int Ret;
 	if(operation::getInstance()->tParas.giHasHolidayEve==1)
-		Ret=GetDayTypeWithHE(curr_date);//PH is 7, EvePH is 8
+		Ret=GetDayTypeWithHE(tariff, curr_date);//PH is 7, EvePH is 8
 	else
-		Ret=GetDayTypeNoPE(curr_date);
+		Ret=GetDayTypeNoPE(tariff, curr_date);
 	return(Ret);
 	
 }
@@ -6604,17 +4207,30 @@ float db::HasPaidWithinPeriod(string sTimeFrom, string sTimeTo)
 
 	int r=-1;
 	float w=-1;
-	
-	sqlStmt= "Select paid_amt From exit_trans ";
-	sqlStmt=sqlStmt + "WHERE iu_tk_no = '"+msCurrentIU;
-	sqlStmt=sqlStmt + "'and paid_amt >0";
-	
+
+	// Card exits only count as trans type 7 or 22, a peer broadcast does not say which and only answers an IU
+	std::vector<int> transTypes;
 	if(msCurrentIU.length()==16)
-	sqlStmt=sqlStmt + " and (trans_type=7 or trans_type=22)";
-	sqlStmt=sqlStmt + " And convert(char(19),exit_time,120) > '"+ sTimeFrom+ "'";
+	transTypes={7, 22};
+
+	PaidExitCache::PaidExit paidExit;
+	if (PaidExitCache::getInstance()->FnFind(msCurrentIU, sTimeFrom, transTypes, paidExit))
+	{
+		operation::getInstance()->writelog("payfee is: " + std::to_string(paidExit.paidAmt) + " (cached, exit at " + paidExit.exitTime + ")", "DB");
+		return paidExit.paidAmt;
+	}
+
+	// exit_time is compared as a datetime so the index on it is used, only the latest exit is needed
+	std::string sTransTypeFilter = (msCurrentIU.length()==16) ? " AND trans_type IN (7, 22)" : "";
 
+	sqlStmt= "SELECT TOP 1 paid_amt, convert(char(19), exit_time, 120), trans_type FROM exit_trans";
+	sqlStmt=sqlStmt + " WHERE iu_tk_no = '"+msCurrentIU + "' AND paid_amt > 0" + sTransTypeFilter;
+	sqlStmt=sqlStmt + " AND exit_time > convert(datetime, '"+ sTimeFrom+ "', 120) ORDER BY exit_time DESC";
+
+	auto queryStartTime = std::chrono::steady_clock::now();
 	r = centraldb->SQLSelect(sqlStmt, &selResult, true);
-	
+	PaidExitCache::getInstance()->FnRecordMissQuery(std::chrono::steady_clock::now() - queryStartTime);
+
 	if(r!=0) 
 	{
 		m_remote_db_err_flag.store(1);
@@ -6625,6 +4241,7 @@ float db::HasPaidWithinPeriod(string sTimeFrom, string sTimeTo)
 	if (selResult.size()>0)
 	{
 		w=std::stof(selResult[0].GetDataItem(0));
+		PaidExitCache::getInstance()->FnRecord(msCurrentIU, {selResult[0].GetDataItem(1), w, std::stoi(selResult[0].GetDataItem(2))});
 		operation::getInstance()->writelog("payfee is: " + std::to_string(w), "DB");
 		return w;
 	}
@@ -6632,13 +4249,16 @@ float db::HasPaidWithinPeriod(string sTimeFrom, string sTimeTo)
 		r=-1; //should raise error
 		goto processLocal;
 	}
-	
+
 processLocal:
 
-	sqlStmt= "Select paid_amt From entry_trans ";
-	sqlStmt=sqlStmt + " Where iu_tk_no='"+ msCurrentIU + "' and paid_amt>0";
+	// Exits of this station not yet uploaded to central
+	selResult.clear();
+	sqlStmt= "SELECT paid_amt FROM Exit_Trans";
+	sqlStmt=sqlStmt + " WHERE iu_tk_no = '"+ msCurrentIU + "' AND paid_amt > 0" + sTransTypeFilter;
+	sqlStmt=sqlStmt + " AND exit_time > '"+ sTimeFrom+ "' ORDER BY exit_time DESC LIMIT 1";
 
-	r = centraldb->SQLSelect(sqlStmt, &selResult, true);
+	r = localdb->SQLSelect(sqlStmt, &selResult, false);
 
 	if(r!=0) m_local_db_err_flag=1;
 	else  m_local_db_err_flag=0;
@@ -6664,8 +4284,14 @@ float db::RoundIt(float val, int giTariffFeeMode)
 	
 };
 
-float db::CalFeeRAM2G(string eTime, string payTime,int iTransType, bool bNoGT) 
+float db::CalFeeRAM2G(string eTime, string payTime,int iTransType, bool bNoGT, uint64_t* tariffVersion) 
 {
+	// The whole calculation prices against one tariff version, a reload in between cannot mix two
+	std::shared_ptr<const TariffSnapshot> tariff = FnGetTariffSnapshot();
+	if (tariffVersion != nullptr)
+	{
+		*tariffVersion = tariff->version;
+	}
 	float iRet=0;
 	bool bUsedTariff[2];
 	int giGT,timediff;
@@ -6678,12 +4304,12 @@ float db::CalFeeRAM2G(string eTime, string payTime,int iTransType, bool bNoGT)
 	//-------
 	for(int i=0; i<2;i++){
 		bUsedTariff[i] = false;
-		if (eTime > gtarifftypeinfo[i].start_time) {
-			if (gtarifftypeinfo[i].end_time > payTime) {
+		if (eTime > tariff->typeInfo[i].start_time) {
+			if (tariff->typeInfo[i].end_time > payTime) {
 					bUsedTariff[i] = true;
 					break;
 			} else{
-				if (eTime < gtarifftypeinfo[i].end_time ) {
+				if (eTime < tariff->typeInfo[i].end_time ) {
 					if (i == 0){
 						bUsedTariff[i] = true;
 						bUsedTariff[i+1] = true;
@@ -6698,15 +4324,15 @@ float db::CalFeeRAM2G(string eTime, string payTime,int iTransType, bool bNoGT)
 
 	if (bUsedTariff[0] == true && bUsedTariff[1] == true) {
 		// cross two zone,need get grace time
-		giGT = std::stoi(gtariff[iTransType][1].grace_time[0]);
+		giGT = std::stoi(tariff->FnGetTariff(iTransType, 1).grace_time[0]);
 
 		timediff=calTime.diffmin(payET.GetUnixTimestamp(), payDT.GetUnixTimestamp());
 		if (timediff> giGT) {
-			giTransType = std::stoi(gtarifftypeinfo[0].tariff_type) *40;
-			iRet = CalFeeRAM2GR(eTime,gtarifftypeinfo[0].end_time,iTransType+ giTransType, true);
+			giTransType = std::stoi(tariff->typeInfo[0].tariff_type) *40;
+			iRet = CalFeeRAM2GR(*tariff, eTime,tariff->typeInfo[0].end_time,iTransType+ giTransType, true);
 			operation::getInstance()->writelog("Fee For Early Tariff: " + Common::getInstance()->SetFeeFormat(iRet),"DB");
-			giTransType = std::stoi(gtarifftypeinfo[1].tariff_type) *40;
-			tempfee = CalFeeRAM2GR(gtarifftypeinfo[1].start_time,payTime,iTransType + giTransType, true);
+			giTransType = std::stoi(tariff->typeInfo[1].tariff_type) *40;
+			tempfee = CalFeeRAM2GR(*tariff, tariff->typeInfo[1].start_time,payTime,iTransType + giTransType, true);
 			operation::getInstance()->writelog("Fee For Current Tariff: " + Common::getInstance()->SetFeeFormat(tempfee),"DB");
 			iRet = iRet + tempfee;
 		} else{
@@ -6715,13 +4341,13 @@ float db::CalFeeRAM2G(string eTime, string payTime,int iTransType, bool bNoGT)
 		}
 	} else{
 		if (bUsedTariff[0] == true) {
-			operation::getInstance()->writelog("Use Tariff Type:" + gtarifftypeinfo[0].tariff_type, "DB");
-			giTransType = std::stoi(gtarifftypeinfo[0].tariff_type) *40;
-			tempfee = CalFeeRAM2GR(eTime,payTime,iTransType + giTransType, bNoGT);
+			operation::getInstance()->writelog("Use Tariff Type:" + tariff->typeInfo[0].tariff_type, "DB");
+			giTransType = std::stoi(tariff->typeInfo[0].tariff_type) *40;
+			tempfee = CalFeeRAM2GR(*tariff, eTime,payTime,iTransType + giTransType, bNoGT);
 		}else{
-			operation::getInstance()->writelog("Use Tariff Type:" + gtarifftypeinfo[1].tariff_type, "DB");
-			giTransType = std::stoi(gtarifftypeinfo[1].tariff_type) *40;
-			tempfee = CalFeeRAM2GR(eTime,payTime,iTransType + giTransType, bNoGT);
+			operation::getInstance()->writelog("Use Tariff Type:" + tariff->typeInfo[1].tariff_type, "DB");
+			giTransType = std::stoi(tariff->typeInfo[1].tariff_type) *40;
+			tempfee = CalFeeRAM2GR(*tariff, eTime,payTime,iTransType + giTransType, bNoGT);
 		}
 		iRet = tempfee;
 	}
@@ -6732,6 +4358,11 @@ float db::CalFeeRAM2G(string eTime, string payTime,int iTransType, bool bNoGT)
 }
 
 float db::CalFeeRAM2GR(string eTime, string payTime,int iTransType, bool bNoGT) 
+{
+	return CalFeeRAM2GR(*FnGetTariffSnapshot(), eTime, payTime, iTransType, bNoGT);
+}
+
+float db::CalFeeRAM2GR(const TariffSnapshot& tariff, string eTime, string payTime,int iTransType, bool bNoGT) 
 {
 	CE_Time entryTime;
 	CE_Time payDT;
@@ -6816,9 +4447,9 @@ float db::CalFeeRAM2GR(string eTime, string payTime,int iTransType, bool bNoGT)
 		{
 			dayFee=0;
 			Lpd.SetTime(PD.GetUnixTimestamp()-86400);
-			iDayType=GetDayType(Lpd);
+			iDayType=GetDayType(tariff, Lpd);
 			//operation:: getInstance()->writelog("last day Type:" + to_string(iDayType), "DB");
-			if(gtariff[iTransType][iDayType].start_time[0].empty())
+			if(tariff.FnGetTariff(iTransType, iDayType).start_time[0].empty())
 			{
 				//operation::getInstance()->writelog("No Tariff defined for DayType: "+to_string(iDayType), "DB");
 				return(-2); //No Tariff defined for DayType
@@ -6826,7 +4457,7 @@ float db::CalFeeRAM2GR(string eTime, string payTime,int iTransType, bool bNoGT)
 			maxZone=0;
 			for(int k=1;k<10;k++){
 
-				if(gtariff[iTransType][iDayType].end_time[k-1].compare(gtariff[iTransType][iDayType].start_time[0])==0)
+				if(tariff.FnGetTariff(iTransType, iDayType).end_time[k-1].compare(tariff.FnGetTariff(iTransType, iDayType).start_time[0])==0)
 				{
 					maxZone=k;
 					//operation::getInstance()->writelog("Max zone for last day is: " + to_string(maxZone), "DB");
@@ -6836,29 +4467,29 @@ float db::CalFeeRAM2GR(string eTime, string payTime,int iTransType, bool bNoGT)
 			
 			if(maxZone==0) return(-4); //time zone wrong
 			// put last zone of last day in array(0)
-			rateType[0]=std::stoi(gtariff[iTransType][iDayType].rate_type[maxZone-1]);
-			chargeRate[0]=std::stod(gtariff[iTransType][iDayType].charge_rate[maxZone-1]);
-			CTB[0]=std::stoi(gtariff[iTransType][iDayType].charge_time_block[maxZone-1]);
-			zoneMin[0]=std::stod(gtariff[iTransType][iDayType].min_charge[maxZone-1]);
-			zoneMax[0]=std::stod(gtariff[iTransType][iDayType].max_charge[maxZone-1]);
-			GT[0]=std::stoi(gtariff[iTransType][iDayType].grace_time[maxZone-1]);
-			firstAdd[0]=std::stod(gtariff[iTransType][iDayType].first_add[maxZone-1]);
-			firstFree[0]=std::stoi(gtariff[iTransType][iDayType].first_free[maxZone-1]);
-			secondAdd[0]=std::stod(gtariff[iTransType][iDayType].second_add[maxZone-1]);
-			secondFree[0]=std::stoi(gtariff[iTransType][iDayType].second_free[maxZone-1]);
-			thirdAdd[0]=std::stod(gtariff[iTransType][iDayType].third_add[maxZone-1]);
-			thirdFree[0]=std::stoi(gtariff[iTransType][iDayType].third_free[maxZone-1]);
-			iAllowance[0]=std::stoi(gtariff[iTransType][iDayType].allowance[maxZone-1]);
-			zt.SetTime(gtariff[iTransType][iDayType].start_time[maxZone-1]);
+			rateType[0]=std::stoi(tariff.FnGetTariff(iTransType, iDayType).rate_type[maxZone-1]);
+			chargeRate[0]=std::stod(tariff.FnGetTariff(iTransType, iDayType).charge_rate[maxZone-1]);
+			CTB[0]=std::stoi(tariff.FnGetTariff(iTransType, iDayType).charge_time_block[maxZone-1]);
+			zoneMin[0]=std::stod(tariff.FnGetTariff(iTransType, iDayType).min_charge[maxZone-1]);
+			zoneMax[0]=std::stod(tariff.FnGetTariff(iTransType, iDayType).max_charge[maxZone-1]);
+			GT[0]=std::stoi(tariff.FnGetTariff(iTransType, iDayType).grace_time[maxZone-1]);
+			firstAdd[0]=std::stod(tariff.FnGetTariff(iTransType, iDayType).first_add[maxZone-1]);
+			firstFree[0]=std::stoi(tariff.FnGetTariff(iTransType, iDayType).first_free[maxZone-1]);
+			secondAdd[0]=std::stod(tariff.FnGetTariff(iTransType, iDayType).second_add[maxZone-1]);
+			secondFree[0]=std::stoi(tariff.FnGetTariff(iTransType, iDayType).second_free[maxZone-1]);
+			thirdAdd[0]=std::stod(tariff.FnGetTariff(iTransType, iDayType).third_add[maxZone-1]);
+			thirdFree[0]=std::stoi(tariff.FnGetTariff(iTransType, iDayType).third_free[maxZone-1]);
+			iAllowance[0]=std::stoi(tariff.FnGetTariff(iTransType, iDayType).allowance[maxZone-1]);
+			zt.SetTime(tariff.FnGetTariff(iTransType, iDayType).start_time[maxZone-1]);
 			
 			dtStr=Lpd.DateString()+" "+ zt.TimeString();
 
 			zoneTime[0].SetTime(dtStr);
 			//operation::getInstance()->writelog ("lastest Zone time for last day start:" + zoneTime[0].DateTimeString(), "DB");
 			//get day of PD
-			iDayType=GetDayType(PD);
+			iDayType=GetDayType(tariff, PD);
 			//operation::getInstance()->writelog("Current day Type: "+ std::to_string(iDayType), "DB");
-			if(gtariff[iTransType][iDayType].start_time[0].empty())
+			if(tariff.FnGetTariff(iTransType, iDayType).start_time[0].empty())
 			{
 				operation::getInstance()->writelog ("No Tariff defined for Daytype: "+ to_string(iDayType), "DB");
 				return(-2); //No Tariff defined for DayType
@@ -6866,7 +4497,7 @@ float db::CalFeeRAM2GR(string eTime, string payTime,int iTransType, bool bNoGT)
 
 			maxZone=0;
 			for(int k=1;k<10;k++){
-				if(gtariff[iTransType][iDayType].end_time[k-1].compare(gtariff[iTransType][iDayType].start_time[0])==0)
+				if(tariff.FnGetTariff(iTransType, iDayType).end_time[k-1].compare(tariff.FnGetTariff(iTransType, iDayType).start_time[0])==0)
 				{
 					maxZone=k;
 					//operation::getInstance()->writelog ("max zone for current day is: "+ std:: to_string(maxZone),"DB");
@@ -6876,22 +4507,22 @@ float db::CalFeeRAM2GR(string eTime, string payTime,int iTransType, bool bNoGT)
 			//---------------------
 			if(maxZone==0) return(-4); //time zone wrong
 			for(int k=1;k<=maxZone;k++){
-				rateType[k]=std::stoi(gtariff[iTransType][iDayType].rate_type[k-1]);
-				chargeRate[k]=std::stod(gtariff[iTransType][iDayType].charge_rate[k-1]);
-				CTB[k]=std::stoi(gtariff[iTransType][iDayType].charge_time_block[k-1]);
-				zoneMin[k]=std::stod(gtariff[iTransType][iDayType].min_charge[k-1]);
-				zoneMax[k]=std::stod(gtariff[iTransType][iDayType].max_charge[k-1]);
-				GT[k]=std::stoi(gtariff[iTransType][iDayType].grace_time[k-1]);
-				firstAdd[k]=std::stod(gtariff[iTransType][iDayType].first_add[k-1]);
-				firstFree[k]=std::stoi(gtariff[iTransType][iDayType].first_free[k-1]);
-				secondAdd[k]=std::stod(gtariff[iTransType][iDayType].second_add[k-1]);
-				secondFree[k]=std::stoi(gtariff[iTransType][iDayType].second_free[k-1]);
-				thirdAdd[k]=std::stod(gtariff[iTransType][iDayType].third_add[k-1]);
-				thirdFree[k]=std::stoi(gtariff[iTransType][iDayType].third_free[k-1]);
-				iAllowance[k]=std::stoi(gtariff[iTransType][iDayType].allowance[k-1]);
+				rateType[k]=std::stoi(tariff.FnGetTariff(iTransType, iDayType).rate_type[k-1]);
+				chargeRate[k]=std::stod(tariff.FnGetTariff(iTransType, iDayType).charge_rate[k-1]);
+				CTB[k]=std::stoi(tariff.FnGetTariff(iTransType, iDayType).charge_time_block[k-1]);
+				zoneMin[k]=std::stod(tariff.FnGetTariff(iTransType, iDayType).min_charge[k-1]);
+				zoneMax[k]=std::stod(tariff.FnGetTariff(iTransType, iDayType).max_charge[k-1]);
+				GT[k]=std::stoi(tariff.FnGetTariff(iTransType, iDayType).grace_time[k-1]);
+				firstAdd[k]=std::stod(tariff.FnGetTariff(iTransType, iDayType).first_add[k-1]);
+				firstFree[k]=std::stoi(tariff.FnGetTariff(iTransType, iDayType).first_free[k-1]);
+				secondAdd[k]=std::stod(tariff.FnGetTariff(iTransType, iDayType).second_add[k-1]);
+				secondFree[k]=std::stoi(tariff.FnGetTariff(iTransType, iDayType).second_free[k-1]);
+				thirdAdd[k]=std::stod(tariff.FnGetTariff(iTransType, iDayType).third_add[k-1]);
+				thirdFree[k]=std::stoi(tariff.FnGetTariff(iTransType, iDayType).third_free[k-1]);
+				iAllowance[k]=std::stoi(tariff.FnGetTariff(iTransType, iDayType).allowance[k-1]);
 				
-				//operation::getInstance()->writelog("Zone time from db is: " + gtariff[iTransType][iDayType].start_time[k-1], "DB");
-				zt.SetTime(gtariff[iTransType][iDayType].start_time[k-1]);
+				//operation::getInstance()->writelog("Zone time from db is: " + tariff.FnGetTariff(iTransType, iDayType).start_time[k-1], "DB");
+				zt.SetTime(tariff.FnGetTariff(iTransType, iDayType).start_time[k-1]);
 				//operation::getInstance()->writelog("Zone time convert is: " + zt.DateTimeString(), "DB");
 				dtStr=PD.DateString()+" "+zt.TimeString();
 				
@@ -6899,25 +4530,25 @@ float db::CalFeeRAM2GR(string eTime, string payTime,int iTransType, bool bNoGT)
 				zoneTime[k].SetTime(dtStr);
 				//operation::getInstance()->writelog("time zone" + std::to_string(k) + " start: " + zoneTime[k].DateTimeString(), "DB");
 			}
-			dayMin = std::stod(gtariff[iTransType][iDayType].whole_day_min);
-			dayMax = std::stod(gtariff[iTransType][iDayType].whole_day_max);
-			iZoneCutoff = std::stoi(gtariff[iTransType][iDayType].zone_cutoff);
-			iDayCutoff = std::stoi(gtariff[iTransType][iDayType].day_cutoff);
+			dayMin = std::stod(tariff.FnGetTariff(iTransType, iDayType).whole_day_min);
+			dayMax = std::stod(tariff.FnGetTariff(iTransType, iDayType).whole_day_max);
+			iZoneCutoff = std::stoi(tariff.FnGetTariff(iTransType, iDayType).zone_cutoff);
+			iDayCutoff = std::stoi(tariff.FnGetTariff(iTransType, iDayType).day_cutoff);
 
 			//operation::getInstance()->writelog("daymin =" + Common::getInstance()->SetFeeFormat(dayMin), "DB");
 			//operation::getInstance()->writelog("dayMax = "+ Common::getInstance()->SetFeeFormat(dayMax), "DB");
 			//get firstzone for next day
 			Npd.SetTime(PD.GetUnixTimestamp()+86400);      // add one day
-			iDayType=GetDayType(Npd);
+			iDayType=GetDayType(tariff, Npd);
 			//operation::getInstance()->writelog("Next day type: "+ to_string(iDayType), "DB");
-			if(gtariff[iTransType][iDayType].start_time[0].empty())
+			if(tariff.FnGetTariff(iTransType, iDayType).start_time[0].empty())
 			{
 				operation::getInstance()->writelog ("No tariff defined for DayType: " + to_string(iDayType), "DB");
 				return(-2); //No Tariff defined for DayType
 			}
-			iNextGT = stoi(gtariff[iTransType][iDayType].grace_time[0]);
-			iNextRT = stoi(gtariff[iTransType][iDayType].rate_type[0]);
-			zt.SetTime(gtariff[iTransType][iDayType].start_time[0]);
+			iNextGT = stoi(tariff.FnGetTariff(iTransType, iDayType).grace_time[0]);
+			iNextRT = stoi(tariff.FnGetTariff(iTransType, iDayType).rate_type[0]);
+			zt.SetTime(tariff.FnGetTariff(iTransType, iDayType).start_time[0]);
 			if(iDayCutoff==1)
 				dtStr=Npd.DateString()+" 00:00:00";
 			else
@@ -7423,7 +5054,7 @@ SettleFirstFree2:
 
 }
 
-DBError db::LoadTariffTypeInfo()
+DBError db::LoadTariffTypeInfo(TariffSnapshot* builder)
 {
 
 	std::string sqlStmt;
@@ -7445,19 +5076,27 @@ DBError db::LoadTariffTypeInfo()
 		sqlStmt="Select tariff_type, start_time, end_time ";
 		sqlStmt= sqlStmt +  " FROM " + tbName + " Order by start_time ASC";
 
-		r=localdb->SQLSelect(sqlStmt,&selResult,true);
+		r=selectConfig(sqlStmt,&selResult,true);
 		if (r!=0) return iLocalFail;
 
 		if (selResult.size()>0){
 		
-			for(j=0;j<selResult.size();j++){
+			tariff_type_info_struct typeInfo[2];
+			// Only two tariff types are kept, further rows used to write past the end
+			for(j=0;j<selResult.size() && j<2;j++){
 				
-				gtarifftypeinfo[j].tariff_type = selResult[j].GetDataItem(0);
-				gtarifftypeinfo[j].start_time = selResult[j].GetDataItem(1);
-				gtarifftypeinfo[j].end_time = selResult[j].GetDataItem(2);
+				typeInfo[j].tariff_type = selResult[j].GetDataItem(0);
+				typeInfo[j].start_time = selResult[j].GetDataItem(1);
+				typeInfo[j].end_time = selResult[j].GetDataItem(2);
 
 			}
 
+			publishTariff(tbName, [&typeInfo](TariffSnapshot& next)
+			{
+				next.typeInfo[0] = typeInfo[0];
+				next.typeInfo[1] = typeInfo[1];
+			}, builder);
+
 			operation::getInstance()->writelog("Load Tariff Type Info: success", "DB");
 
 			return iDBSuccess;
@@ -7540,7 +5179,7 @@ string db::CalParkedTime(long lpt)
 	return(ret);
 }
 
-DBError db::LoadXTariff()
+DBError db::LoadXTariff(TariffSnapshot* builder)
 {
 
 	std::string sqlStmt;
@@ -7562,11 +5201,11 @@ DBError db::LoadXTariff()
 		sqlStmt="Select * ";
 		sqlStmt= sqlStmt +  " FROM " + tbName;
 
-		r=localdb->SQLSelect(sqlStmt,&selResult,true);
+		r=selectConfig(sqlStmt,&selResult,true);
 		if (r!=0) return iLocalFail;
 
 		if (selResult.size()>0){
-			msxtariff.clear();
+			std::vector<XTariff_Struct> xTariffs;
 			for(j=0;j<selResult.size();j++){
 				xtariff.day_index = selResult[j].GetDataItem(0);
             	xtariff.autocharge[0] = selResult[j].GetDataItem(1);
@@ -7578,8 +5217,12 @@ DBError db::LoadXTariff()
 					xtariff.autocharge[i] = selResult[j].GetDataItem(4+(i-1) *3);
 					xtariff.fee[i] = selResult[j].GetDataItem(5+(i-1)*3);
 				}
-				msxtariff.push_back(xtariff);
+				xTariffs.push_back(xtariff);
 			}
+			publishTariff(tbName, [&xTariffs](TariffSnapshot& next)
+			{
+				next.xTariffs = std::move(xTariffs);
+			}, builder);
 			operation::getInstance()->writelog("Load XTariff: success", "DB");
 
 			return iDBSuccess;
@@ -7614,15 +5257,17 @@ int db::GetXTariff(int &iAutoDebit, float &sAmt, int iVType)
 	CE_Time pDt;
 	int i,j;
 	bool gbfound = false;
+	std::shared_ptr<const TariffSnapshot> tariff = FnGetTariffSnapshot();
+	const std::vector<XTariff_Struct>& xTariffs = tariff->xTariffs;
 	//------
 	pDt.SetTime();
 	//operation::getInstance()->writelog("PD is:"+pDt.DateTimeString(),"DB");
-  	iDayIdx = GetDayType(pDt);
+  	iDayIdx = GetDayType(*tariff, pDt);
     iDayIdx = iDayIdx + iVType * 3;
     sDayIdx = "," + std::to_string(iDayIdx) + ",";
 	//------
-	for(i=0; i<msxtariff.size();i++){
-		sDayIndex= ","+ msxtariff[i].day_index + ",";	
+	for(i=0; i<xTariffs.size();i++){
+		sDayIndex= ","+ xTariffs[i].day_index + ",";	
 		if (sDayIndex.find(sDayIdx) != std::string::npos) {
 			gbfound = true;
 			break;
@@ -7633,9 +5278,9 @@ int db::GetXTariff(int &iAutoDebit, float &sAmt, int iVType)
 		//operation::getInstance()->writelog("Day Index Record: "+ std::to_string(i), "DB");
 		//operation::getInstance()->writelog("Current Time: "+ pDt.HMTimeString(), "DB");
 		for(j=0; j< 5; j++) {
-        	if (pDt.HMTimeString() <= msxtariff[i].time[j + 1]) {
-            	iAutoDebit = std:: stoi(msxtariff[i].autocharge[j]);
-           	 	sAmt = std::stod(msxtariff[i].fee[j]);
+        	if (pDt.HMTimeString() <= xTariffs[i].time[j + 1]) {
+            	iAutoDebit = std:: stoi(xTariffs[i].autocharge[j]);
+           	 	sAmt = std::stod(xTariffs[i].fee[j]);
 				//operation::getInstance()->writelog("Autocharge: "+ std::to_string(iAutoDebit), "DB");
 				//operation::getInstance()->writelog("chargeAmt: "+ std::to_string(sAmt), "DB");
 				return(1);
@@ -7646,20 +5291,14 @@ int db::GetXTariff(int &iAutoDebit, float &sAmt, int iVType)
 }
 
 
-int db::FetchEntryinfo(string sIUNo)
+int db::FetchCentralEntryinfo(const string& sIUNo, EntryInfo& info)
 {
 	// Return: -1=cannot connect to db
-    // 0=Ok, found, 1=paid, 2=lost card,
-    // 3=no entry, 4=no sale
-    // 5=complimentary
+    // 0=Ok, found, 3=no entry
 
 	std::string sqlStmt;
 	vector<ReaderItem> selResult;
-	vector<ReaderItem> selResult2;
-	std::string sValue;
-	int r,i,j;
-	int w=-1;
-	int bTried=0;
+	int r;
 	string gsZoneEntries = operation::getInstance()->tParas.gsZoneEntries;
 
 	sqlStmt = "SELECT Entry_time, trans_type,parking_fee,paid_amt, owe_amt, entry_station FROM Movement_trans_tmp where (iu_tk_no = '"+ sIUNo + "'";
@@ -7678,32 +5317,37 @@ int db::FetchEntryinfo(string sIUNo)
 	if (r != 0)
 	{
 		m_remote_db_err_flag.store(1);
-		goto processLocal;
-	}
-	else
-	{
-		m_remote_db_err_flag.store(0);
+		return -1;
 	}
+	m_remote_db_err_flag.store(0);
 
 	if (selResult.size()>0)
 	{
-		operation::getInstance()->tExit.sEntryTime=selResult[0].GetDataItem(0);
-		operation::getInstance()->tExit.iTransType=std::stoi(selResult[0].GetDataItem(1));
-		operation::getInstance()->tExit.sOweAmt=std::stof(selResult[0].GetDataItem(4));
-		operation::getInstance()->tExit.iEntryID=std::stoi(selResult[0].GetDataItem(5));	
-		operation::getInstance()->writelog("Fetch Entry time from central:  " + operation::getInstance()->tExit.sEntryTime, "DB");
-		return r;
-	}
-	else{
-		//no record
-		operation::getInstance()->writelog("No Entry record in Central DB.", "DB");
-		return 3;
+		info.sEntryTime=selResult[0].GetDataItem(0);
+		info.iTransType=std::stoi(selResult[0].GetDataItem(1));
+		info.sOweAmt=std::stof(selResult[0].GetDataItem(4));
+		info.iEntryID=std::stoi(selResult[0].GetDataItem(5));	
+		operation::getInstance()->writelog("Fetch Entry time from central:  " + info.sEntryTime, "DB");
+		return 0;
 	}
-	
-processLocal:
+
+	//no record
+	operation::getInstance()->writelog("No Entry record in Central DB.", "DB");
+	return 3;
+}
+
+int db::FetchLocalEntryinfo(const string& sIUNo, EntryInfo& info)
+{
+	// Return: -1=cannot connect to db
+    // 0=Ok, found, 3=no entry
+
+	std::string sqlStmt;
+	vector<ReaderItem> selResult;
+	int r;
+
 	sqlStmt = "Select Entry_time,trans_type,paid_amt, Owe_Amt, Station_id From Entry_Trans where Status = 0 and iu_tk_no = '"+ sIUNo +"' order by entry_time desc";
 	
-	r=localdb->SQLSelect(sqlStmt,&selResult2,true);
+	r=localdb->SQLSelect(sqlStmt,&selResult,true);
 
 	//operation::getInstance()->writelog(sqlStmt, "DB");
 	if (r!=0)
@@ -7712,19 +5356,19 @@ processLocal:
 		return r;
 	}
 	
-	if (selResult2.size()>0)
+	if (selResult.size()>0)
 	{            
-		operation::getInstance()->tExit.sEntryTime=selResult2[0].GetDataItem(0);
-		operation::getInstance()->tExit.iTransType=std::stoi(selResult2[0].GetDataItem(1));
-		operation::getInstance()->tExit.sOweAmt=std::stof(selResult2[0].GetDataItem(3));
-		operation::getInstance()->tExit.iEntryID=std::stoi(selResult2[0].GetDataItem(4));	
+		info.sEntryTime=selResult[0].GetDataItem(0);
+		info.iTransType=std::stoi(selResult[0].GetDataItem(1));
+		info.sOweAmt=std::stof(selResult[0].GetDataItem(3));
+		info.iEntryID=std::stoi(selResult[0].GetDataItem(4));	
 	}
 	else
 	{
 		operation::getInstance()->writelog("No entry record in local DB","DB");
 		return 3;
 	}
-	operation::getInstance()->writelog("Fetch Entry time from Local:  " + operation::getInstance()->tExit.sEntryTime, "DB");
+	operation::getInstance()->writelog("Fetch Entry time from Local:  " + info.sEntryTime, "DB");
 	return r;
 }
 
@@ -7965,24 +5609,24 @@ int db::isValidBarCodeTicket(bool isRedemptionTicket, std::string sBarcodeTicket
 	return iRet;
 }
 
-DBError db::update99PaymentTrans()
+DBError db::update99PaymentTrans(const tExitTrans_Struct& tExit, int iSID)
 {
 	int r;
 	std::string sqlStmt="";
 
 	sqlStmt = "UPDATE Exit_trans_tmp set status=0";
 
-	if (operation::getInstance()->tExit.sRebateAmt > 0)
+	if (tExit.sRebateAmt > 0)
 	{
-		sqlStmt = sqlStmt + ",redeem_amt=" + std::to_string(operation::getInstance()->tExit.sRebateAmt);
-		sqlStmt = sqlStmt + ",paid_amt=" + std::to_string(operation::getInstance()->tExit.sPaidAmt);
-		sqlStmt = sqlStmt + ",gst_amt=" + std::to_string(operation::getInstance()->tExit.sGSTAmt);
-		sqlStmt = sqlStmt + ",Trans_Type=" + std::to_string(operation::getInstance()->tExit.iTransType);
-		sqlStmt = sqlStmt + ",Card_mc_no='" + operation::getInstance()->tExit.sCardNo + "'";
-		sqlStmt = sqlStmt + ",redeem_no='" + operation::getInstance()->tExit.sRedeemNo + "'";
+		sqlStmt = sqlStmt + ",redeem_amt=" + std::to_string(tExit.sRebateAmt);
+		sqlStmt = sqlStmt + ",paid_amt=" + std::to_string(tExit.sPaidAmt);
+		sqlStmt = sqlStmt + ",gst_amt=" + std::to_string(tExit.sGSTAmt);
+		sqlStmt = sqlStmt + ",Trans_Type=" + std::to_string(tExit.iTransType);
+		sqlStmt = sqlStmt + ",Card_mc_no='" + tExit.sCardNo + "'";
+		sqlStmt = sqlStmt + ",redeem_no='" + tExit.sRedeemNo + "'";
 	}
 
-	sqlStmt = sqlStmt + " WHERE iu_tk_no='" + operation::getInstance()->tExit.sIUNo + "' and status = 99 AND Station_ID=" + std::to_string(operation::getInstance()->gtStation.iSID);
+	sqlStmt = sqlStmt + " WHERE iu_tk_no='" + tExit.sIUNo + "' and status = 99 AND Station_ID=" + std::to_string(iSID);
 
 	r = centraldb->SQLExecutNoneQuery(sqlStmt);
 	if (r == 0)
@@ -6,11 +6,17 @@
 #include <sstream>
 #include <iostream>
 #include <list>
+#include <functional>
+#include <memory>
 
 #include <math.h>
 #include "structuredata.h"
+#include "circuit_breaker.h"
 #include "odbc.h"
 #include "udp.h"
+#include "lazy_instance.h"
+#include "table_replication.h"
+#include "tariff_snapshot.h"
 
 
 //using namespace std;
@@ -30,12 +36,82 @@ typedef enum
 
 }DBError;
 
+// Entry record of a vehicle that has not exited yet, the exit flow copies it into tExit
+struct EntryInfo
+{
+    std::string sEntryTime;
+    int iTransType = 0;
+    float sOweAmt = 0;
+    int iEntryID = 0;
+};
+
+// Redemption or complimentary ticket from the central ticket tables
+struct BarcodeTicketInfo
+{
+    std::tm dtExpireTime = {};
+    double gbRedeemAmt = 0.00;
+    int giRedeemTime = 0;
+};
+
+// Season record of a season check, the check flow copies it into tSeason. Only the local season table has
+// the type and status.
+struct SeasonInfo
+{
+    bool hasRecord = false;
+    bool hasStatus = false;
+    std::string sSeasonType;
+    std::string sStatus;
+    std::string sDateFrom;
+    std::string sDateTo;
+    std::string sRateType;
+    std::string sRedeemAmt;
+    std::string sRedeemTime;
+};
+
+// Rows of one configuration query, read on a job or DB thread and applied on the lane's flow strand
+struct ConfigRows
+{
+    int ret = -1;
+    std::vector<ReaderItem> rows;
+};
+
+// Station parameters kept in the central DB, a has flag stays false when the central DB had no row for it
+struct CentralParams
+{
+    bool hasSite = false;
+    int iGroupID = 0;
+    int iSite = 0;
+    bool hasZoneEntries = false;
+    std::string sZoneEntries;
+    bool hasLastSerialNo = false;
+    long lLastSerialNo = 0;
+};
+
+struct ParamRows
+{
+    ConfigRows zoneEntries;
+    bool hasCentral = false;
+    CentralParams central;
+    ConfigRows params;
+};
+
+// message_mst holds the entry and the exit messages, both loads apply the same rows
+struct MessageRows
+{
+    ConfigRows led;
+    ConfigRows lcd;
+};
 
 class db {
 public:
     static db* getInstance();
     int connectlocaldb(string connectstr,int LocalSQLTimeOut,int SP_SQLTimeOut,float mPingTimeOut);
     int connectcentraldb(string connectStr,string connectIP,int CentralSQLTimeOut, int SP_SQLTimeOut,float mPingTimeOut);
+    // Create the connections without connecting, so they exist before any thread can reach them
+    void FnSetupLocalDB(string connectstr,int LocalSQLTimeOut,int SP_SQLTimeOut,float mPingTimeOut);
+    void FnSetupCentralDB(string connectStr,string connectIP,int CentralSQLTimeOut, int SP_SQLTimeOut,float mPingTimeOut);
+    // Re-runs the lane's snapshot config queries against the local DB, returns the statements whose rows changed
+    std::vector<std::string> FnRevalidateConfigSnapshot();
     virtual ~db();
 
     int sp_isvalidseason(const std::string & sSeasonNo,
@@ -46,16 +122,14 @@ public:
                       std::string &dtValidTo,
                       std::string &dtValidFrom);
 
-	int local_isvalidseason(string L_sSeasonNo,unsigned int iZoneID);
+	int local_isvalidseason(string L_sSeasonNo,unsigned int iZoneID, SeasonInfo& season);
 
-	int isvalidseason(string m_sSeasonNo,BYTE iInOut, unsigned int iZoneID);
+	// isFromLocal, when given, tells whether the central DB failed and the local season table answered
+	int isvalidseason(string m_sSeasonNo,BYTE iInOut, unsigned int iZoneID, SeasonInfo& season, bool* isFromLocal = nullptr);
     void synccentraltime ();
     int downloadseason();
-    int writeseason2local(tseason_struct& v);
     int downloadvehicletype();
-    int writevehicletype2local(string iucode,string iutype);
     int downloadledmessage();
-    int writeledmessage2local(string m_id,string m_body, string m_status);
     int downloadparameter();
     int writeparameter2local(string name,string value);
     int downloadstationsetup();
@@ -69,7 +143,6 @@ public:
     int downloadxtariff(int iGrpID, int iSiteID, int iCheckStatus = 0);
     int writextariff2local(x_tariff_struct& x_tariff);
     int downloadholidaymst(int iCheckStatus = 0);
-    int writeholidaymst2local(std::string holiday_date, std::string descrip);
     int download3tariffinfo();
     int write3tariffinfo2local(tariff_info_struct& tariff_info);
     int downloadratefreeinfo(int iCheckStatus = 0);
@@ -80,14 +153,17 @@ public:
     int writeratetypeinfo2local(rate_type_info_struct rate_type_info);
     int downloadratemaxinfo(int iCheckStatus = 0);
     int writeratemaxinfo2local(rate_max_info_struct rate_max_info);
-    int WriteTariff2RAM(tariff_struct t);
+    int WriteTariff2RAM(TariffSnapshot& tariff, const tariff_struct& t);
     int GetDayType(CE_Time curr_date);
-    int GetDayTypeNoPE(CE_Time curr_date);
-    int GetDayTypeWithHE(CE_Time curr_date);
+    int GetDayType(const TariffSnapshot& tariff, CE_Time curr_date);
+    int GetDayTypeNoPE(const TariffSnapshot& tariff, CE_Time curr_date);
+    int GetDayTypeWithHE(const TariffSnapshot& tariff, CE_Time curr_date);
     float HasPaidWithinPeriod(string sTimeFrom, string sTimeTo);
     float RoundIt(float val, int giTariffFeeMode);
     float CalFeeRAM2GR(string eTime, string payTime,int iTransType, bool bNoGT = false);
-    float CalFeeRAM2G(string eTime, string payTime,int iTransType, bool bNoGT = false);
+    float CalFeeRAM2GR(const TariffSnapshot& tariff, string eTime, string payTime,int iTransType, bool bNoGT = false);
+    // tariffVersion, when given, receives the version of the tariff the fee was calculated with
+    float CalFeeRAM2G(string eTime, string payTime,int iTransType, bool bNoGT = false, uint64_t* tariffVersion = nullptr);
     int GetXTariff(int &iAutoDebit, float &sAmt, int iVType = 0);
     string CalParkedTime(long lpt);
 
@@ -102,23 +178,50 @@ public:
     DBError loadExitmessage();
 	DBError loadParam();
     DBError loadparamfromCentral();
+    // loadparamfromCentral in two halves, the fetch for a DB thread and the apply for the lane's flow strand
+    DBError FetchCentralParams(CentralParams& params);
+    void ApplyCentralParams(const CentralParams& params);
 	DBError loadstationsetup();
-    DBError loadZoneEntriesfromLocal();
     DBError loadvehicletype();
     DBError loadTR(int iType = 0);
-    DBError LoadTariff();
-    DBError LoadHoliday();
+    // The loads above in two halves as well, for a reload while the lane is open
+    void FetchParamRows(ParamRows& rows);
+    DBError ApplyParamRows(ParamRows& rows);
+    void FetchMessageRows(MessageRows& rows);
+    DBError ApplyEntryMessageRows(MessageRows& rows);
+    DBError ApplyExitMessageRows(MessageRows& rows);
+    void FetchStationSetupRows(ConfigRows& rows);
+    DBError ApplyStationSetupRows(ConfigRows& rows);
+    void FetchVehicleTypeRows(ConfigRows& rows);
+    DBError ApplyVehicleTypeRows(ConfigRows& rows);
+    void FetchTRRows(ConfigRows& rows, int iType = 0);
+    DBError ApplyTRRows(ConfigRows& rows);
+    // A tariff load publishes its table as the next version, or only fills builder when one is given
+    DBError LoadTariff(TariffSnapshot* builder = nullptr);
+    DBError LoadHoliday(TariffSnapshot* builder = nullptr);
     DBError ClearHoliday();
-    DBError LoadTariffTypeInfo();
-    DBError LoadXTariff();
+    DBError LoadTariffTypeInfo(TariffSnapshot* builder = nullptr);
+    DBError LoadXTariff(TariffSnapshot* builder = nullptr);
+    // Pins the current tariff version, it stays valid and unchanged for as long as the pointer is held
+    std::shared_ptr<const TariffSnapshot> FnGetTariffSnapshot() const;
+    // A reload of several tables: load them into the builder this returns, then publish it once
+    TariffSnapshot FnBeginTariffReload() const;
+    void FnPublishTariff(TariffSnapshot builder, const std::string& tableNames);
 
     int FnGetVehicleType(std::string IUCode);
     string GetPartialSeasonMsg(int iTransType);
-    int FetchEntryinfo(string sIUNo);
+    // Return: -1=cannot connect to db, 0=found, 3=no entry
+    int FetchCentralEntryinfo(const string& sIUNo, EntryInfo& info);
+    int FetchLocalEntryinfo(const string& sIUNo, EntryInfo& info);
 
-    void moveOfflineTransToCentral();
-	int insertTransToCentralEntryTransTmp(tEntryTrans_Struct ter);
-	int insertTransToCentralExitTransTmp(const tExitTrans_Struct& tex);
+    // Transactions saved locally while the central DB was unreachable, sStationID blank for every station.
+    // Count returns -1 when the local DB fails, the fetches 0 or -1 and the oldest iLimit rows.
+    int CountOfflineTrans(Ctrl_Type ctrl, const string& sStationID);
+    int FetchOfflineEntryTrans(const string& sStationID, int iLimit, vector<tEntryTrans_Struct>& trans);
+    int FetchOfflineExitTrans(const string& sStationID, int iLimit, vector<tExitTrans_Struct>& trans);
+    // Skip a row the central DB already has, sentBytes receives the statement size
+	int insertTransToCentralEntryTransTmp(tEntryTrans_Struct ter, std::size_t* sentBytes = nullptr);
+	int insertTransToCentralExitTransTmp(const tExitTrans_Struct& tex, std::size_t* sentBytes = nullptr);
 	int deleteLocalTrans(string iuno,string trantime,Ctrl_Type ctrl);
     int clearseason();
     int IsBlackListIU(string sIU);
@@ -127,13 +230,17 @@ public:
     int AddSysEvent(string sEvent);
 
     int FnGetDatabaseErrorFlag();
+    // Reachability ping of the central DB server, feeds the central DB circuit breaker
+    void FnRecordCentralDBProbe(bool isReachable);
+    void FnLogCentralDBStats();
+    void FnLogTableSyncStats();
     int HouseKeeping();
     int clearexpiredseason();
     int updateEntryTrans(string lpn, string sTransID);
     int updateExitTrans(string lpn, string sTransID);
     int updateExitReceiptNo(string sReceiptNo, string StnID); 
     int isValidBarCodeTicket(bool isRedemptionTicket, std::string sBarcodeTicket, std::tm& dtExpireTime, double& gbRedeemAmt, int& giRedeemTime);
-    DBError update99PaymentTrans();
+    DBError update99PaymentTrans(const tExitTrans_Struct& tExit, int iSID);
     int fetchUnmatchedEntryInfo(std::vector<EntryRecord>& records);
 
     long  glToalRowAffed;
@@ -160,8 +267,11 @@ private:
     template <typename T>
         string ToString(T a);
 
-    DBError loadEntrymessage(std::vector<ReaderItem>& selResult);
+    DBError loadEntrymessage(std::vector<ReaderItem>& selResult, bool isReportingUnknown);
     DBError loadExitLcdAndLedMessage(std::vector<ReaderItem>& selResult);
+    void logFieldReport(const std::string& tableName, const std::vector<std::string>& unknown, const std::vector<std::string>& malformed);
+    // Local select for configuration tables, goes through the lane's config snapshot
+    int selectConfig(const std::string& statement, std::vector<ReaderItem>* result, bool fullResult);
 
     
     int season_update_flag;
@@ -184,17 +294,22 @@ private:
 
 	odbc *centraldb;
 	odbc *localdb;
+	std::shared_ptr<CircuitBreaker> centralBreaker_;
+	void onCentralBreakerChange(CircuitBreaker::State from, CircuitBreaker::State to, const std::string& reason);
+	TableReplicator replicator_;
+	// Central to local copy of a configuration table, returns the rows written or -1, result receives the details
+	int syncTable(const TableReplicator::Spec& spec, TableReplicator::Result* result = nullptr);
 
-    static db* db_;
+    static std::atomic<db*> db_;
     static std::mutex mutex_;
     db();
     //-----------------------
-    struct  tariff_struct gtariff[300][10];
-    struct  tariff_type_info_struct  gtarifftypeinfo[2];
+    // Tariff, tariff type, holiday and XTariff tables, read with std::atomic_load and replaced with std::atomic_store
+    std::shared_ptr<const TariffSnapshot> tariffSnapshot_;
+    std::mutex tariffMutex_;
+    void publishTariff(const std::string& tableName, const std::function<void(TariffSnapshot&)>& update, TariffSnapshot* builder);
     //---------------
-    std::vector<std::string> msholiday;
     std::vector<std::string> mspecialday;
-    std::vector<struct XTariff_Struct> msxtariff;
 
 };
 
@@ -1,19 +1,27 @@
+#include <cerrno>
+#include <cstring>
 #include <functional>
+#include <poll.h>
 #include <sstream>
 #include <thread>
 #include "common.h"
 #include "dio.h"
+#include "dio_sequencer.h"
 #include "event_manager.h"
 #include "gpio.h"
+#include "gpio_simulator.h"
 #include "ini_parser.h"
+#include "io_executor.h"
 #include "log.h"
 #include "operation.h"
+#include "vehicle_classifier.h"
 
-DIO* DIO::dio_ = nullptr;
+std::array<std::atomic<DIO*>, LaneContext::MAX_LANES> DIO::dios_ = {};
 std::mutex DIO::mutex_;
 
 DIO::DIO()
-    : loop_a_di_(0),
+    : laneId_(LaneContext::FnGetCurrentLane()),
+    loop_a_di_(0),
     loop_b_di_(0),
     loop_c_di_(0),
     intercom_di_(0),
@@ -46,13 +54,7 @@ DIO::DIO()
 
 DIO* DIO::getInstance()
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (dio_ == nullptr)
-    {
-        dio_ = new DIO();
-    }
-
-    return dio_;
+    return LazyInstance::FnGet(dios_[LaneContext::FnGetCurrentLane()], mutex_, []() { return new DIO(); });
 }
 
 void DIO::FnDIOInit()
@@ -72,14 +74,25 @@ void DIO::FnDIOInit()
     open_barrier_do_ = getOutputPinNum(IniParser::getInstance()->FnGetOpenbarrier());
     lcd_backlight_do_ = getOutputPinNum(IniParser::getInstance()->FnGetLCDbacklight());
     close_barrier_do_ = getOutputPinNum(IniParser::getInstance()->FnGetclosebarrier());
+    VehicleClassifier::getInstance()->FnSetWindows(IniParser::getInstance()->FnGetVehicleClassifyWindowMs(), IniParser::getInstance()->FnGetVehicleMinOverlapMs());
 
     Logger::getInstance()->FnCreateLogFile(logFileName_);
 
-    if (GPIOManager::getInstance()->FnGPIOInit())
+    // GPIO is the controller's, the first lane brings it up and further lanes only map their own pins
+    bool isGPIOReady = (laneId_ == LaneContext::DEFAULT_LANE) ? GPIOManager::getInstance()->FnGPIOInit(IniParser::getInstance()->FnGetGPIOBackend()) : true;
+    if (isGPIOReady)
     {
+        if ((laneId_ == LaneContext::DEFAULT_LANE)
+            && (GPIOManager::getInstance()->FnGetBackend() == GPIOManager::GPIO_BACKEND_SIMULATOR)
+            && !IniParser::getInstance()->FnGetGPIOSimulatorScript().empty())
+        {
+            GPIOSimulator::getInstance()->FnLoadScript(IniParser::getInstance()->FnGetGPIOSimulatorScript());
+        }
+
         Logger::getInstance()->FnLog("DIO initialization completed.");
         Logger::getInstance()->FnLog("DIO initialization completed.", logFileName_, "DIO");
         isGPIOInitialized_ = true;
+        DIOSequencer::getInstance()->FnStartSequencer();
     }
     else
     {
@@ -99,6 +112,12 @@ void DIO::FnStartDIOMonitoring()
         {
             isDIOMonitoringThreadRunning_.store(true);
             dioMonitoringThread_ = std::thread(&DIO::monitoringDIOChangeThreadFunction, this);
+
+            // Scripted edges only start once the monitoring thread is there to see them
+            if ((laneId_ == LaneContext::DEFAULT_LANE) && (GPIOManager::getInstance()->FnGetBackend() == GPIOManager::GPIO_BACKEND_SIMULATOR))
+            {
+                GPIOSimulator::getInstance()->FnStartScript();
+            }
         }
     }
     else
@@ -116,61 +135,184 @@ void DIO::FnStopDIOMonitoring()
         isDIOMonitoringThreadRunning_.store(false);
         dioMonitoringThread_.join();
     }
+
+    // The sequencer drives every lane's outputs, main stops it at controller shutdown
+}
+
+void DIO::raiseDIOEvent(DIO_EVENT dioEvent)
+{
+    // Stamp with the time the edge woke the monitoring thread, not the time it was processed
+    EventManager::getInstance()->FnEnqueueEvent(EventID::DIO_EVENT, DIOEventData{ static_cast<int>(dioEvent), edgeTimestamp_ });
+}
+
+int DIO::readGPIOValue(int pinNum) const
+{
+    GPIOPin* gpio = GPIOManager::getInstance()->FnGetGPIO(pinNum);
+
+    return (gpio != nullptr) ? gpio->FnGetValue() : 0;
+}
+
+bool DIO::buildInputPollFds(std::vector<struct pollfd>& pollFds)
+{
+    const int inputPins[] = { loop_a_di_, loop_b_di_, loop_c_di_, intercom_di_, station_door_open_di_,
+                              barrier_door_open_di_, barrier_status_di_, manual_open_barrier_di_, lorry_sensor_di_, arm_broken_di_ };
+
+    pollFds.clear();
+    pollPins_.clear();
+
+    for (int pinNum : inputPins)
+    {
+        GPIOPin* gpio = GPIOManager::getInstance()->FnGetGPIO(pinNum);
+        if (gpio == nullptr)
+        {
+            continue;
+        }
+
+        // Every configured input must notify on edges, otherwise a change on it would go unseen until timeout
+        if (!gpio->FnIsEdgeEnabled() || gpio->FnGetValueFd() < 0)
+        {
+            std::stringstream ss;
+            ss << "Edge notification not enabled for pin " << pinNum << ", use polling.";
+            Logger::getInstance()->FnLog(ss.str(), logFileName_, "DIO");
+            pollFds.clear();
+            pollPins_.clear();
+            return false;
+        }
+
+        bool isDuplicate = false;
+        for (const auto& pfd : pollFds)
+        {
+            if (pfd.fd == gpio->FnGetValueFd())
+            {
+                isDuplicate = true;
+                break;
+            }
+        }
+
+        if (!isDuplicate)
+        {
+            struct pollfd pfd;
+            pfd.fd = gpio->FnGetValueFd();
+            pfd.events = gpio->FnGetPollEvents();
+            pfd.revents = 0;
+            pollFds.push_back(pfd);
+            pollPins_.push_back(gpio);
+        }
+    }
+
+    return !pollFds.empty();
+}
+
+bool DIO::waitForInputChange(std::vector<struct pollfd>& pollFds, bool& isEdgeTriggered)
+{
+    if (isEdgeTriggered)
+    {
+        // Wake up early when the vehicle classifier has a window to close
+        int timeoutMs = VehicleClassifier::getInstance()->FnGetNextTimeoutMs(std::chrono::steady_clock::now(), DIO_EDGE_WAIT_TIMEOUT_MS);
+        int ret = poll(pollFds.data(), pollFds.size(), timeoutMs);
+        edgeTimestamp_ = std::chrono::steady_clock::now();
+
+        if (ret > 0)
+        {
+            // Use the earliest edge reported by the backend
+            for (std::size_t i = 0; i < pollFds.size(); i++)
+            {
+                if (pollFds[i].revents != 0)
+                {
+                    std::chrono::steady_clock::time_point edgeTime = pollPins_[i]->FnAcknowledgeEdge();
+                    if (edgeTime < edgeTimestamp_)
+                    {
+                        edgeTimestamp_ = edgeTime;
+                    }
+                }
+            }
+
+            // Let contact bounce settle before sampling, the values are read back by the caller
+            std::this_thread::sleep_for(std::chrono::milliseconds(DIO_DEBOUNCE_MS));
+            return true;
+        }
+        else if ((ret < 0) && (errno != EINTR))
+        {
+            std::stringstream ss;
+            ss << "DIO poll failed, errno: " << std::strerror(errno) << ", fall back to polling.";
+            Logger::getInstance()->FnLog(ss.str(), logFileName_, "DIO");
+            isEdgeTriggered = false;
+        }
+
+        return false;
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(DIO_POLL_INTERVAL_MS));
+    edgeTimestamp_ = std::chrono::steady_clock::now();
+
+    return true;
 }
 
 void DIO::monitoringDIOChangeThreadFunction()
 {
+    IOExecutor::FnNameCurrentThread("pbs-dio-" + std::to_string(laneId_));
+    LaneContext::FnSetThreadLane(laneId_);
+
+    std::vector<struct pollfd> pollFds;
+    bool isEdgeTriggered = buildInputPollFds(pollFds);
+    edgeTimestamp_ = std::chrono::steady_clock::now();
+
+    std::stringstream ss;
+    ss << "DIO monitoring mode: " << (isEdgeTriggered ? "edge triggered" : "polling");
+    Logger::getInstance()->FnLog(ss.str(), logFileName_, "DIO");
+
     while (isDIOMonitoringThreadRunning_.load())
     {
-        static std::string barrier_open_time_ = "";
-
-        int loop_a_curr_val = (GPIOManager::getInstance()->FnGetGPIO(loop_a_di_) != nullptr) ? GPIOManager::getInstance()->FnGetGPIO(loop_a_di_)->FnGetValue() : 0;
-        int loop_b_curr_val = (GPIOManager::getInstance()->FnGetGPIO(loop_b_di_) != nullptr) ? GPIOManager::getInstance()->FnGetGPIO(loop_b_di_)->FnGetValue() : 0;
-        int loop_c_curr_val = (GPIOManager::getInstance()->FnGetGPIO(loop_c_di_) != nullptr) ? GPIOManager::getInstance()->FnGetGPIO(loop_c_di_)->FnGetValue() : 0;
-        int intercom_curr_val = (GPIOManager::getInstance()->FnGetGPIO(intercom_di_) != nullptr) ? GPIOManager::getInstance()->FnGetGPIO(intercom_di_)->FnGetValue() : 0;
-        int station_door_open_curr_val = (GPIOManager::getInstance()->FnGetGPIO(station_door_open_di_) != nullptr) ? GPIOManager::getInstance()->FnGetGPIO(station_door_open_di_)->FnGetValue() : 0;
-        int barrier_door_open_curr_val = (GPIOManager::getInstance()->FnGetGPIO(barrier_door_open_di_) != nullptr) ? GPIOManager::getInstance()->FnGetGPIO(barrier_door_open_di_)->FnGetValue() : 0;
-        int barrier_status_curr_value = (GPIOManager::getInstance()->FnGetGPIO(barrier_status_di_) != nullptr) ? GPIOManager::getInstance()->FnGetGPIO(barrier_status_di_)->FnGetValue() : 0;
-        int manual_open_barrier_status_curr_value = (GPIOManager::getInstance()->FnGetGPIO(manual_open_barrier_di_) != nullptr) ? GPIOManager::getInstance()->FnGetGPIO(manual_open_barrier_di_)->FnGetValue() : 0;
-        int lorry_sensor_curr_val = (GPIOManager::getInstance()->FnGetGPIO(lorry_sensor_di_) != nullptr) ? GPIOManager::getInstance()->FnGetGPIO(lorry_sensor_di_)->FnGetValue() : 0;
-        int arm_broken_curr_val = (GPIOManager::getInstance()->FnGetGPIO(arm_broken_di_) != nullptr) ? GPIOManager::getInstance()->FnGetGPIO(arm_broken_di_)->FnGetValue() : 0;
+        int loop_a_curr_val = readGPIOValue(loop_a_di_);
+        int loop_b_curr_val = readGPIOValue(loop_b_di_);
+        int loop_c_curr_val = readGPIOValue(loop_c_di_);
+        int intercom_curr_val = readGPIOValue(intercom_di_);
+        int station_door_open_curr_val = readGPIOValue(station_door_open_di_);
+        int barrier_door_open_curr_val = readGPIOValue(barrier_door_open_di_);
+        int barrier_status_curr_value = readGPIOValue(barrier_status_di_);
+        int manual_open_barrier_status_curr_value = readGPIOValue(manual_open_barrier_di_);
+        int lorry_sensor_curr_val = readGPIOValue(lorry_sensor_di_);
+        int arm_broken_curr_val = readGPIOValue(arm_broken_di_);
+
+        VehicleClassifier::getInstance()->FnOnLoopState(loop_a_curr_val, loop_b_curr_val, loop_c_curr_val, edgeTimestamp_);
+        VehicleClassifier::getInstance()->FnCheckTimeout(std::chrono::steady_clock::now());
         
         // Case : Loop A on, Loop B no change 
         if ((loop_a_curr_val == GPIOManager::GPIO_HIGH && loop_a_di_last_val_ == GPIOManager::GPIO_LOW)
             && (loop_b_curr_val == GPIOManager::GPIO_LOW && loop_b_di_last_val_ == GPIOManager::GPIO_LOW))
         {
-            EventManager::getInstance()->FnEnqueueEvent<int>("Evt_handleDIOEvent", static_cast<int>(DIO_EVENT::LOOP_A_ON_EVENT));
+            raiseDIOEvent(DIO_EVENT::LOOP_A_ON_EVENT);
         }
         // Case : Loop B on, Loop A no change
         else if ((loop_b_curr_val == GPIOManager::GPIO_HIGH && loop_b_di_last_val_ == GPIOManager::GPIO_LOW) 
                 && (loop_a_curr_val == GPIOManager::GPIO_LOW && loop_a_di_last_val_ == GPIOManager::GPIO_LOW))
         {
-            EventManager::getInstance()->FnEnqueueEvent<int>("Evt_handleDIOEvent", static_cast<int>(DIO_EVENT::LOOP_A_ON_EVENT));
+            raiseDIOEvent(DIO_EVENT::LOOP_A_ON_EVENT);
         }
         // Case : Loop A on, Loop B on
         else if ((loop_a_curr_val == GPIOManager::GPIO_HIGH && loop_a_di_last_val_ == GPIOManager::GPIO_LOW)
                 && (loop_b_curr_val == GPIOManager::GPIO_HIGH && loop_b_di_last_val_ == GPIOManager::GPIO_LOW))
         {
-            EventManager::getInstance()->FnEnqueueEvent<int>("Evt_handleDIOEvent", static_cast<int>(DIO_EVENT::LOOP_A_ON_EVENT));
+            raiseDIOEvent(DIO_EVENT::LOOP_A_ON_EVENT);
         }
 
         // Case : Loop A off, Loop B no change
         if ((loop_a_curr_val == GPIOManager::GPIO_LOW && loop_a_di_last_val_ == GPIOManager::GPIO_HIGH)
             && (loop_b_curr_val == GPIOManager::GPIO_LOW && loop_b_di_last_val_ == GPIOManager::GPIO_LOW))
         {
-            EventManager::getInstance()->FnEnqueueEvent<int>("Evt_handleDIOEvent", static_cast<int>(DIO_EVENT::LOOP_A_OFF_EVENT));
+            raiseDIOEvent(DIO_EVENT::LOOP_A_OFF_EVENT);
         }
         // Case : Loop B off, Loop A no change
         else if ((loop_b_curr_val == GPIOManager::GPIO_LOW && loop_b_di_last_val_ == GPIOManager::GPIO_HIGH)
                 && (loop_a_curr_val == GPIOManager::GPIO_LOW && loop_a_di_last_val_ == GPIOManager::GPIO_LOW))
         {
-            EventManager::getInstance()->FnEnqueueEvent<int>("Evt_handleDIOEvent", static_cast<int>(DIO_EVENT::LOOP_A_OFF_EVENT));
+            raiseDIOEvent(DIO_EVENT::LOOP_A_OFF_EVENT);
         }
         // Case : Loop A off, Loop B off
         else if ((loop_a_curr_val == GPIOManager::GPIO_LOW && loop_a_di_last_val_ == GPIOManager::GPIO_HIGH)
             && (loop_b_curr_val == GPIOManager::GPIO_LOW && loop_b_di_last_val_ == GPIOManager::GPIO_HIGH))
         {
-            EventManager::getInstance()->FnEnqueueEvent<int>("Evt_handleDIOEvent", static_cast<int>(DIO_EVENT::LOOP_A_OFF_EVENT));
+            raiseDIOEvent(DIO_EVENT::LOOP_A_OFF_EVENT);
         }
 
         // Start -- Check the input pin status for Loop A and Loop B and send to Monitor
@@ -203,7 +345,7 @@ void DIO::monitoringDIOChangeThreadFunction()
         
         if (loop_c_curr_val == GPIOManager::GPIO_HIGH && loop_c_di_last_val_ == GPIOManager::GPIO_LOW)
         {
-            EventManager::getInstance()->FnEnqueueEvent<int>("Evt_handleDIOEvent", static_cast<int>(DIO_EVENT::LOOP_C_ON_EVENT));
+            raiseDIOEvent(DIO_EVENT::LOOP_C_ON_EVENT);
             
             operation::getInstance()->tProcess.gbLoopCIsOn = true;
             // Send to Input Pin Status to Monitor
@@ -211,7 +353,7 @@ void DIO::monitoringDIOChangeThreadFunction()
         }
         else if (loop_c_curr_val == GPIOManager::GPIO_LOW && loop_c_di_last_val_ == GPIOManager::GPIO_HIGH)
         {
-            EventManager::getInstance()->FnEnqueueEvent<int>("Evt_handleDIOEvent", static_cast<int>(DIO_EVENT::LOOP_C_OFF_EVENT));
+            raiseDIOEvent(DIO_EVENT::LOOP_C_OFF_EVENT);
             
             operation::getInstance()->tProcess.gbLoopCIsOn = false;
             // Send to Input Pin Status to Monitor
@@ -220,14 +362,14 @@ void DIO::monitoringDIOChangeThreadFunction()
         
         if (intercom_curr_val == GPIOManager::GPIO_HIGH && intercom_di_last_val_ == GPIOManager::GPIO_LOW)
         {
-            EventManager::getInstance()->FnEnqueueEvent<int>("Evt_handleDIOEvent", static_cast<int>(DIO_EVENT::INTERCOM_ON_EVENT));
+            raiseDIOEvent(DIO_EVENT::INTERCOM_ON_EVENT);
             
             // Send to Input Pin Status to Monitor
             operation::getInstance()->FnSendDIOInputStatusToMonitor(IniParser::getInstance()->FnGetIntercom(), 1);
         }
         else if (intercom_curr_val == GPIOManager::GPIO_LOW && intercom_di_last_val_ == GPIOManager::GPIO_HIGH)
         {
-            EventManager::getInstance()->FnEnqueueEvent<int>("Evt_handleDIOEvent", static_cast<int>(DIO_EVENT::INTERCOM_OFF_EVENT));
+            raiseDIOEvent(DIO_EVENT::INTERCOM_OFF_EVENT);
             
             // Send to Input Pin Status to Monitor
             operation::getInstance()->FnSendDIOInputStatusToMonitor(IniParser::getInstance()->FnGetIntercom(), 0);
@@ -235,14 +377,14 @@ void DIO::monitoringDIOChangeThreadFunction()
         
         if (station_door_open_curr_val == GPIOManager::GPIO_HIGH && station_door_open_di_last_val_ == GPIOManager::GPIO_LOW)
         {
-            EventManager::getInstance()->FnEnqueueEvent<int>("Evt_handleDIOEvent", static_cast<int>(DIO_EVENT::STATION_DOOR_OPEN_EVENT));
+            raiseDIOEvent(DIO_EVENT::STATION_DOOR_OPEN_EVENT);
             
             // Send to Input Pin Status to Monitor
             operation::getInstance()->FnSendDIOInputStatusToMonitor(IniParser::getInstance()->FnGetStationDooropen(), 1);
         }
         else if (station_door_open_curr_val == GPIOManager::GPIO_LOW && station_door_open_di_last_val_ == GPIOManager::GPIO_HIGH)
         {
-            EventManager::getInstance()->FnEnqueueEvent<int>("Evt_handleDIOEvent", static_cast<int>(DIO_EVENT::STATION_DOOR_CLOSE_EVENT));
+            raiseDIOEvent(DIO_EVENT::STATION_DOOR_CLOSE_EVENT);
             
             // Send to Input Pin Status to Monitor
             operation::getInstance()->FnSendDIOInputStatusToMonitor(IniParser::getInstance()->FnGetStationDooropen(), 0);
@@ -250,14 +392,14 @@ void DIO::monitoringDIOChangeThreadFunction()
         
         if (barrier_door_open_curr_val == GPIOManager::GPIO_HIGH && barrier_door_open_di_last_val_ == GPIOManager::GPIO_LOW)
         {
-            EventManager::getInstance()->FnEnqueueEvent<int>("Evt_handleDIOEvent", static_cast<int>(DIO_EVENT::BARRIER_DOOR_OPEN_EVENT));
+            raiseDIOEvent(DIO_EVENT::BARRIER_DOOR_OPEN_EVENT);
             
             // Send to Input Pin Status to Monitor
             operation::getInstance()->FnSendDIOInputStatusToMonitor(IniParser::getInstance()->FnGetBarrierDooropen(), 1);
         }
         else if (barrier_door_open_curr_val == GPIOManager::GPIO_LOW && barrier_door_open_di_last_val_ == GPIOManager::GPIO_HIGH)
         {
-            EventManager::getInstance()->FnEnqueueEvent<int>("Evt_handleDIOEvent", static_cast<int>(DIO_EVENT::BARRIER_DOOR_CLOSE_EVENT));
+            raiseDIOEvent(DIO_EVENT::BARRIER_DOOR_CLOSE_EVENT);
             
             // Send to Input Pin Status to Monitor
             operation::getInstance()->FnSendDIOInputStatusToMonitor(IniParser::getInstance()->FnGetBarrierDooropen(), 0);
@@ -265,7 +407,7 @@ void DIO::monitoringDIOChangeThreadFunction()
         
         if (barrier_status_curr_value == GPIOManager::GPIO_HIGH && barrier_status_di_last_val_ == GPIOManager::GPIO_LOW)
         {
-            EventManager::getInstance()->FnEnqueueEvent<int>("Evt_handleDIOEvent", static_cast<int>(DIO_EVENT::BARRIER_STATUS_ON_EVENT));
+            raiseDIOEvent(DIO_EVENT::BARRIER_STATUS_ON_EVENT);
             
             // Send to Input Pin Status to Monitor
             operation::getInstance()->FnSendDIOInputStatusToMonitor(IniParser::getInstance()->FnGetBarrierStatus(), 1);
@@ -275,7 +417,7 @@ void DIO::monitoringDIOChangeThreadFunction()
         }
         else if (barrier_status_curr_value == GPIOManager::GPIO_LOW && barrier_status_di_last_val_ == GPIOManager::GPIO_HIGH)
         {
-            EventManager::getInstance()->FnEnqueueEvent<int>("Evt_handleDIOEvent", static_cast<int>(DIO_EVENT::BARRIER_STATUS_OFF_EVENT));
+            raiseDIOEvent(DIO_EVENT::BARRIER_STATUS_OFF_EVENT);
             
             // Send to Input Pin Status to Monitor
             operation::getInstance()->FnSendDIOInputStatusToMonitor(IniParser::getInstance()->FnGetBarrierStatus(), 0);
@@ -286,13 +428,13 @@ void DIO::monitoringDIOChangeThreadFunction()
             if (bIsBarrierOpenTooLongTime_ == true)
             {
                 bIsBarrierOpenTooLongTime_ = false;
-                EventManager::getInstance()->FnEnqueueEvent<int>("Evt_handleDIOEvent", static_cast<int>(DIO_EVENT::BARRIER_OPEN_TOO_LONG_OFF_EVENT));
+                raiseDIOEvent(DIO_EVENT::BARRIER_OPEN_TOO_LONG_OFF_EVENT);
             }
         }
 
         if (manual_open_barrier_status_curr_value == GPIOManager::GPIO_HIGH && manual_open_barrier_di_last_val_ == GPIOManager::GPIO_LOW)
         {
-            EventManager::getInstance()->FnEnqueueEvent<int>("Evt_handleDIOEvent", static_cast<int>(DIO_EVENT::MANUAL_OPEN_BARRIED_ON_EVENT));
+            raiseDIOEvent(DIO_EVENT::MANUAL_OPEN_BARRIED_ON_EVENT);
             FnSetManualOpenBarrierStatusFlag(1);
             
             // Send to Input Pin Status to Monitor
@@ -300,7 +442,7 @@ void DIO::monitoringDIOChangeThreadFunction()
         }
         else if (manual_open_barrier_status_curr_value == GPIOManager::GPIO_LOW && manual_open_barrier_di_last_val_ == GPIOManager::GPIO_HIGH)
         {
-            EventManager::getInstance()->FnEnqueueEvent<int>("Evt_handleDIOEvent", static_cast<int>(DIO_EVENT::MANUAL_OPEN_BARRIED_OFF_EVENT));
+            raiseDIOEvent(DIO_EVENT::MANUAL_OPEN_BARRIED_OFF_EVENT);
             
             // Send to Input Pin Status to Monitor
             operation::getInstance()->FnSendDIOInputStatusToMonitor(IniParser::getInstance()->FnGetManualOpenBarrier(), 0);
@@ -309,7 +451,7 @@ void DIO::monitoringDIOChangeThreadFunction()
         if (lorry_sensor_curr_val == GPIOManager::GPIO_HIGH && lorry_sensor_di_last_val_ == GPIOManager::GPIO_LOW)
         {
             operation::getInstance()->tProcess.gbLorrySensorIsOn = true;
-            EventManager::getInstance()->FnEnqueueEvent<int>("Evt_handleDIOEvent", static_cast<int>(DIO_EVENT::LORRY_SENSOR_ON_EVENT));
+            raiseDIOEvent(DIO_EVENT::LORRY_SENSOR_ON_EVENT);
 
             // Send to Input Pin Status to Monitor
             operation::getInstance()->FnSendDIOInputStatusToMonitor(IniParser::getInstance()->FnGetLorrysensor(), 1);
@@ -317,7 +459,7 @@ void DIO::monitoringDIOChangeThreadFunction()
         else if (lorry_sensor_curr_val == GPIOManager::GPIO_LOW && lorry_sensor_di_last_val_ == GPIOManager::GPIO_HIGH)
         {
             operation::getInstance()->tProcess.gbLorrySensorIsOn = false;
-            EventManager::getInstance()->FnEnqueueEvent<int>("Evt_handleDIOEvent", static_cast<int>(DIO_EVENT::LORRY_SENSOR_OFF_EVENT));
+            raiseDIOEvent(DIO_EVENT::LORRY_SENSOR_OFF_EVENT);
 
             // Send to Input Pin Status to Monitor
             operation::getInstance()->FnSendDIOInputStatusToMonitor(IniParser::getInstance()->FnGetLorrysensor(), 0);
@@ -325,14 +467,14 @@ void DIO::monitoringDIOChangeThreadFunction()
 
         if (arm_broken_curr_val == GPIOManager::GPIO_HIGH && arm_broken_di_last_val_ == GPIOManager::GPIO_LOW)
         {
-            EventManager::getInstance()->FnEnqueueEvent<int>("Evt_handleDIOEvent", static_cast<int>(DIO_EVENT::ARM_BROKEN_ON_EVENT));
+            raiseDIOEvent(DIO_EVENT::ARM_BROKEN_ON_EVENT);
 
             // Send to Input Pin Status to Monitor
             operation::getInstance()->FnSendDIOInputStatusToMonitor(IniParser::getInstance()->FnGetArmbroken(), 1);
         }
         else if (arm_broken_curr_val == GPIOManager::GPIO_LOW && arm_broken_di_last_val_ == GPIOManager::GPIO_HIGH)
         {
-            EventManager::getInstance()->FnEnqueueEvent<int>("Evt_handleDIOEvent", static_cast<int>(DIO_EVENT::ARM_BROKEN_OFF_EVENT));
+            raiseDIOEvent(DIO_EVENT::ARM_BROKEN_OFF_EVENT);
 
             // Send to Input Pin Status to Monitor
             operation::getInstance()->FnSendDIOInputStatusToMonitor(IniParser::getInstance()->FnGetArmbroken(), 0);
@@ -348,7 +490,7 @@ void DIO::monitoringDIOChangeThreadFunction()
             if (duration_sec > iBarrierOpenTooLongTime_)
             {
                 bIsBarrierOpenTooLongTime_ = true;
-                EventManager::getInstance()->FnEnqueueEvent<int>("Evt_handleDIOEvent", static_cast<int>(DIO_EVENT::BARRIER_OPEN_TOO_LONG_ON_EVENT));
+                raiseDIOEvent(DIO_EVENT::BARRIER_OPEN_TOO_LONG_ON_EVENT);
                 barrier_open_time_.clear();
             }
         }
@@ -364,7 +506,7 @@ void DIO::monitoringDIOChangeThreadFunction()
         lorry_sensor_di_last_val_ = lorry_sensor_curr_val;
         arm_broken_di_last_val_ = arm_broken_curr_val;
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        waitForInputChange(pollFds, isEdgeTriggered);
     }
 }
 
@@ -400,104 +542,123 @@ void DIO::FnSetCloseBarrier(int value)
     }
 }
 
+void DIO::FnPulseOpenBarrier(int durationMs)
+{
+    Logger::getInstance()->FnLog(__func__, logFileName_, "DIO");
+
+    DIOSequencer::getInstance()->FnPulse(open_barrier_do_, durationMs);
+}
+
+void DIO::FnPulseCloseBarrier(int durationMs)
+{
+    Logger::getInstance()->FnLog(__func__, logFileName_, "DIO");
+
+    DIOSequencer::getInstance()->FnPulse(close_barrier_do_, durationMs);
+}
+
+void DIO::FnHoldOpenBarrier()
+{
+    Logger::getInstance()->FnLog(__func__, logFileName_, "DIO");
+
+    DIOSequencer::getInstance()->FnHold(open_barrier_do_, 1);
+}
+
+void DIO::FnReleaseOpenBarrier()
+{
+    Logger::getInstance()->FnLog(__func__, logFileName_, "DIO");
+
+    DIOSequencer::getInstance()->FnSet(open_barrier_do_, 0);
+}
+
 int DIO::FnGetOpenBarrier() const
 {
     Logger::getInstance()->FnLog(__func__, logFileName_, "DIO");
 
-    return (GPIOManager::getInstance()->FnGetGPIO(open_barrier_do_) != nullptr) ? GPIOManager::getInstance()->FnGetGPIO(open_barrier_do_)->FnGetValue() : 0;
+    return readGPIOValue(open_barrier_do_);
 }
 
 void DIO::FnSetLCDBacklight(int value)
 {
     Logger::getInstance()->FnLog(__func__, logFileName_, "DIO");
 
-    if (GPIOManager::getInstance()->FnGetGPIO(lcd_backlight_do_) != nullptr)
-    {
-        GPIOManager::getInstance()->FnGetGPIO(lcd_backlight_do_)->FnSetValue(value);
-    }
-    else
-    {
-        std::stringstream ss;
-        ss << "Nullptr, Unable to set backlight DO pin : " << lcd_backlight_do_;
-        Logger::getInstance()->FnLog(ss.str(), logFileName_, "DIO");
-    }
+    DIOSequencer::getInstance()->FnSet(lcd_backlight_do_, value);
 }
 
 int DIO::FnGetLCDBacklight() const
 {
     Logger::getInstance()->FnLog(__func__, logFileName_, "DIO");
 
-    return (GPIOManager::getInstance()->FnGetGPIO(lcd_backlight_do_) != nullptr) ? GPIOManager::getInstance()->FnGetGPIO(lcd_backlight_do_)->FnGetValue() : 0;
+    return readGPIOValue(lcd_backlight_do_);
 }
 
 int DIO::FnGetLoopAStatus() const
 {
     Logger::getInstance()->FnLog(__func__, logFileName_, "DIO");
 
-    return (GPIOManager::getInstance()->FnGetGPIO(loop_a_di_) != nullptr) ? GPIOManager::getInstance()->FnGetGPIO(loop_a_di_)->FnGetValue() : 0;
+    return readGPIOValue(loop_a_di_);
 }
 
 int DIO::FnGetLoopBStatus() const
 {
     Logger::getInstance()->FnLog(__func__, logFileName_, "DIO");
 
-    return (GPIOManager::getInstance()->FnGetGPIO(loop_b_di_) != nullptr) ? GPIOManager::getInstance()->FnGetGPIO(loop_b_di_)->FnGetValue() : 0;
+    return readGPIOValue(loop_b_di_);
 }
 
 int DIO::FnGetLoopCStatus() const
 {
     Logger::getInstance()->FnLog(__func__, logFileName_, "DIO");
 
-    return (GPIOManager::getInstance()->FnGetGPIO(loop_c_di_) != nullptr) ? GPIOManager::getInstance()->FnGetGPIO(loop_c_di_)->FnGetValue() : 0;
+    return readGPIOValue(loop_c_di_);
 }
 
 int DIO::FnGetIntercomStatus() const
 {
     Logger::getInstance()->FnLog(__func__, logFileName_, "DIO");
 
-    return (GPIOManager::getInstance()->FnGetGPIO(intercom_di_) != nullptr) ? GPIOManager::getInstance()->FnGetGPIO(intercom_di_)->FnGetValue() : 0;
+    return readGPIOValue(intercom_di_);
 }
 
 int DIO::FnGetStationDoorStatus() const
 {
     Logger::getInstance()->FnLog(__func__, logFileName_, "DIO");
 
-    return (GPIOManager::getInstance()->FnGetGPIO(station_door_open_di_) != nullptr) ? GPIOManager::getInstance()->FnGetGPIO(station_door_open_di_)->FnGetValue() : 0;
+    return readGPIOValue(station_door_open_di_);
 }
 
 int DIO::FnGetBarrierDoorStatus() const
 {
     Logger::getInstance()->FnLog(__func__, logFileName_, "DIO");
 
-    return (GPIOManager::getInstance()->FnGetGPIO(barrier_door_open_di_) != nullptr) ? GPIOManager::getInstance()->FnGetGPIO(barrier_door_open_di_)->FnGetValue() : 0;
+    return readGPIOValue(barrier_door_open_di_);
 }
 
 int DIO::FnGetBarrierStatus() const
 {
     Logger::getInstance()->FnLog(__func__, logFileName_, "DIO");
 
-    return (GPIOManager::getInstance()->FnGetGPIO(barrier_status_di_) != nullptr) ? GPIOManager::getInstance()->FnGetGPIO(barrier_status_di_)->FnGetValue() : 0;
+    return readGPIOValue(barrier_status_di_);
 }
 
 int DIO::FnGetManualOpenBarrierStatus() const
 {
     Logger::getInstance()->FnLog(__func__, logFileName_, "DIO");
 
-    return (GPIOManager::getInstance()->FnGetGPIO(manual_open_barrier_di_) != nullptr) ? GPIOManager::getInstance()->FnGetGPIO(manual_open_barrier_di_)->FnGetValue() : 0;
+    return readGPIOValue(manual_open_barrier_di_);
 }
 
 int DIO::FnGetLorrySensor() const
 {
     Logger::getInstance()->FnLog(__func__, logFileName_, "DIO");
 
-    return (GPIOManager::getInstance()->FnGetGPIO(lorry_sensor_di_) != nullptr) ? GPIOManager::getInstance()->FnGetGPIO(lorry_sensor_di_)->FnGetValue() : 0;
+    return readGPIOValue(lorry_sensor_di_);
 }
 
 int DIO::FnGetArmbroken() const
 {
     Logger::getInstance()->FnLog(__func__, logFileName_, "DIO");
 
-    return (GPIOManager::getInstance()->FnGetGPIO(arm_broken_di_) != nullptr) ? GPIOManager::getInstance()->FnGetGPIO(arm_broken_di_)->FnGetValue() : 0;
+    return readGPIOValue(arm_broken_di_);
 }
 
 int DIO::FnGetOutputPinNum(int pinNum)
@@ -1,13 +1,23 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <fcntl.h>
 #include <fstream>
 #include <memory>
 #include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
+#include <poll.h>
 #include "boost/asio.hpp"
 #include "boost/asio/posix/stream_descriptor.hpp"
+#include "lane_context.h"
+#include "lazy_instance.h"
+
+class GPIOPin;
 
 class DIO
 {
@@ -40,6 +50,10 @@ public:
         BARRIER_OPEN_TOO_LONG_OFF_EVENT = 23
     };
 
+    static const int DIO_POLL_INTERVAL_MS = 50;
+    static const int DIO_EDGE_WAIT_TIMEOUT_MS = 1000;
+    static const int DIO_DEBOUNCE_MS = 5;
+
     static DIO* getInstance();
     void FnDIOInit();
     void FnStartDIOMonitoring();
@@ -48,6 +62,11 @@ public:
     int FnGetOpenBarrier() const;
     void FnSetLCDBacklight(int value);
     void FnSetCloseBarrier(int value);
+    // Sequenced barrier outputs, these return immediately
+    void FnPulseOpenBarrier(int durationMs);
+    void FnPulseCloseBarrier(int durationMs);
+    void FnHoldOpenBarrier();
+    void FnReleaseOpenBarrier();
     int FnGetLCDBacklight() const;
     int FnGetLoopAStatus() const;
     int FnGetLoopBStatus() const;
@@ -76,9 +95,10 @@ public:
     void operator=(const DIO&) = delete;
 
 private:
-    static DIO* dio_;
+    static std::array<std::atomic<DIO*>, LaneContext::MAX_LANES> dios_;
     static std::mutex mutex_;
     std::string logFileName_;
+    int laneId_;
     int loop_a_di_;
     int loop_b_di_;
     int loop_c_di_;
@@ -109,8 +129,15 @@ private:
     std::mutex manual_open_barrier_status_flag_mutex_;
     int64_t iBarrierOpenTooLongTime_;
     bool bIsBarrierOpenTooLongTime_;
+    std::string barrier_open_time_;     // only the lane's monitoring thread touches it
+    std::chrono::steady_clock::time_point edgeTimestamp_;
+    std::vector<GPIOPin*> pollPins_;
     DIO();
     int getInputPinNum(int pinNum);
     int getOutputPinNum(int pinNum);
+    void raiseDIOEvent(DIO_EVENT dioEvent);
+    int readGPIOValue(int pinNum) const;
+    bool buildInputPollFds(std::vector<struct pollfd>& pollFds);
+    bool waitForInputChange(std::vector<struct pollfd>& pollFds, bool& isEdgeTriggered);
     void monitoringDIOChangeThreadFunction();
 };
\ No newline at end of file
@@ -0,0 +1,297 @@
+#include <algorithm>
+#include <sstream>
+#include "dio_sequencer.h"
+#include "gpio.h"
+#include "io_executor.h"
+#include "log.h"
+
+std::atomic<DIOSequencer*> DIOSequencer::dioSequencer_(nullptr);
+std::mutex DIOSequencer::mutex_;
+
+DIOSequencer::DIOSequencer()
+    : logFileName_("dio"),
+    nextSequence_(0),
+    isSequencerRunning_(false),
+    commandCount_(0),
+    writeCount_(0),
+    supersededCount_(0),
+    totalLateUs_(0),
+    maxLateUs_(0)
+{
+}
+
+DIOSequencer* DIOSequencer::getInstance()
+{
+    return LazyInstance::FnGet(dioSequencer_, mutex_, []() { return new DIOSequencer(); });
+}
+
+const char* DIOSequencer::FnGetCommandName(OutputCommand command)
+{
+    switch (command)
+    {
+        case OutputCommand::SET:    return "SET";
+        case OutputCommand::PULSE:  return "PULSE";
+        case OutputCommand::BLINK:  return "BLINK";
+        case OutputCommand::HOLD:   return "HOLD";
+        default:                    return "UNKNOWN";
+    }
+}
+
+void DIOSequencer::FnStartSequencer()
+{
+    Logger::getInstance()->FnLog(__func__, logFileName_, "DIO");
+
+    if (!isSequencerRunning_.load())
+    {
+        isSequencerRunning_.store(true);
+        sequencerThread_ = std::thread(&DIOSequencer::sequencerThreadFunction, this);
+    }
+}
+
+void DIOSequencer::FnStopSequencer()
+{
+    Logger::getInstance()->FnLog(__func__, logFileName_, "DIO");
+
+    if (isSequencerRunning_.load())
+    {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex_);
+            isSequencerRunning_.store(false);
+        }
+        queueCondition_.notify_one();
+
+        if (sequencerThread_.joinable())
+        {
+            sequencerThread_.join();
+        }
+    }
+}
+
+uint64_t DIOSequencer::beginCommand(int pinNumber)
+{
+    // Bumping the pin generation drops every step still queued for the pin
+    commandCount_++;
+    return ++pinGenerations_[pinNumber];
+}
+
+void DIOSequencer::pushStep(std::chrono::steady_clock::time_point due, uint64_t generation, int pinNumber, int value, OutputCommand command, int onMs, int offMs, int remainingToggles)
+{
+    OutputStep step;
+    step.due = due;
+    step.sequence = nextSequence_++;
+    step.generation = generation;
+    step.pinNumber = pinNumber;
+    step.value = value;
+    step.command = command;
+    step.onMs = onMs;
+    step.offMs = offMs;
+    step.remainingToggles = remainingToggles;
+
+    steps_.push(step);
+}
+
+bool DIOSequencer::isCurrent(const OutputStep& step) const
+{
+    auto it = pinGenerations_.find(step.pinNumber);
+    return (it != pinGenerations_.end()) && (it->second == step.generation);
+}
+
+void DIOSequencer::FnSet(int pinNumber, int value)
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        uint64_t generation = beginCommand(pinNumber);
+        pushStep(std::chrono::steady_clock::now(), generation, pinNumber, value, OutputCommand::SET);
+    }
+    queueCondition_.notify_one();
+}
+
+void DIOSequencer::FnPulse(int pinNumber, int durationMs, int value)
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        auto now = std::chrono::steady_clock::now();
+        uint64_t generation = beginCommand(pinNumber);
+        pushStep(now, generation, pinNumber, value, OutputCommand::PULSE);
+        pushStep(now + std::chrono::milliseconds(std::max(durationMs, 0)), generation, pinNumber, (value != 0) ? 0 : 1, OutputCommand::PULSE);
+    }
+    queueCondition_.notify_one();
+}
+
+void DIOSequencer::FnBlink(int pinNumber, int onMs, int offMs, int count)
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        uint64_t generation = beginCommand(pinNumber);
+
+        // count on/off cycles, the last toggle leaves the output off; count <= 0 blinks until replaced
+        int remainingToggles = (count > 0) ? ((count * 2) - 1) : -1;
+        pushStep(std::chrono::steady_clock::now(), generation, pinNumber, 1, OutputCommand::BLINK, std::max(onMs, 1), std::max(offMs, 1), remainingToggles);
+    }
+    queueCondition_.notify_one();
+}
+
+void DIOSequencer::FnHold(int pinNumber, int value, int maxHoldMs)
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        auto now = std::chrono::steady_clock::now();
+        uint64_t generation = beginCommand(pinNumber);
+        pushStep(now, generation, pinNumber, value, OutputCommand::HOLD);
+
+        // Held until the next command on the pin, with an optional safety release
+        if (maxHoldMs > 0)
+        {
+            pushStep(now + std::chrono::milliseconds(maxHoldMs), generation, pinNumber, (value != 0) ? 0 : 1, OutputCommand::HOLD);
+        }
+    }
+    queueCondition_.notify_one();
+}
+
+void DIOSequencer::FnCancel(int pinNumber)
+{
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    beginCommand(pinNumber);
+}
+
+void DIOSequencer::sequencerThreadFunction()
+{
+    IOExecutor::FnNameCurrentThread("pbs-dio-seq");
+
+    std::unique_lock<std::mutex> lock(queueMutex_);
+
+    while (isSequencerRunning_.load())
+    {
+        if (steps_.empty())
+        {
+            queueCondition_.wait(lock);
+            continue;
+        }
+
+        OutputStep step = steps_.top();
+
+        if (!isCurrent(step))
+        {
+            steps_.pop();
+            supersededCount_++;
+            continue;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now < step.due)
+        {
+            // Woken early by a new command or at the deadline, either way re-check the earliest step
+            queueCondition_.wait_until(lock, step.due);
+            continue;
+        }
+
+        steps_.pop();
+
+        uint64_t lateUs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now - step.due).count());
+        totalLateUs_ += lateUs;
+        maxLateUs_ = std::max(maxLateUs_, lateUs);
+        writeCount_++;
+
+        // Next blink toggle is scheduled from the due time, so the pattern does not drift
+        if ((step.command == OutputCommand::BLINK) && (step.remainingToggles != 0))
+        {
+            int periodMs = (step.value != 0) ? step.onMs : step.offMs;
+            int remainingToggles = (step.remainingToggles > 0) ? (step.remainingToggles - 1) : -1;
+            pushStep(step.due + std::chrono::milliseconds(periodMs), step.generation, step.pinNumber, (step.value != 0) ? 0 : 1, OutputCommand::BLINK, step.onMs, step.offMs, remainingToggles);
+        }
+
+        lock.unlock();
+        writeOutput(step.pinNumber, step.value);
+        lock.lock();
+    }
+}
+
+void DIOSequencer::writeOutput(int pinNumber, int value)
+{
+    GPIOPin* gpio = GPIOManager::getInstance()->FnGetGPIO(pinNumber);
+    if (gpio != nullptr)
+    {
+        gpio->FnSetValue(value);
+    }
+    else
+    {
+        std::stringstream ss;
+        ss << "Nullptr, Unable to set DO pin : " << pinNumber;
+        Logger::getInstance()->FnLog(ss.str(), logFileName_, "DIO");
+    }
+}
+
+std::vector<DIOSequencer::PendingOutput> DIOSequencer::FnGetPendingOutputs()
+{
+    std::lock_guard<std::mutex> lock(queueMutex_);
+
+    // Copy of the heap, the queue only ever holds a handful of steps
+    auto steps = steps_;
+    auto now = std::chrono::steady_clock::now();
+    std::vector<PendingOutput> pending;
+
+    while (!steps.empty())
+    {
+        const OutputStep& step = steps.top();
+        if (isCurrent(step))
+        {
+            pending.push_back(PendingOutput{ step.pinNumber, step.value, step.command, std::chrono::duration_cast<std::chrono::milliseconds>(step.due - now).count() });
+        }
+        steps.pop();
+    }
+
+    return pending;
+}
+
+DIOSequencer::DIOSequencerStats DIOSequencer::FnGetStats()
+{
+    std::lock_guard<std::mutex> lock(queueMutex_);
+
+    DIOSequencerStats stats;
+    stats.commands = commandCount_;
+    stats.writes = writeCount_;
+    stats.superseded = supersededCount_;
+    stats.avgLateUs = (writeCount_ > 0) ? (totalLateUs_ / writeCount_) : 0;
+    stats.maxLateUs = maxLateUs_;
+    stats.depth = steps_.size();
+
+    return stats;
+}
+
+void DIOSequencer::FnLogStats()
+{
+    DIOSequencerStats stats = FnGetStats();
+    if (stats.commands == 0)
+    {
+        return;
+    }
+
+    std::stringstream ss;
+    ss << "DIO Sequencer => commands: " << stats.commands;
+    ss << ", writes: " << stats.writes;
+    ss << ", superseded: " << stats.superseded;
+    ss << ", depth: " << stats.depth;
+    ss << ", avg late: " << stats.avgLateUs << "us";
+    ss << ", max late: " << stats.maxLateUs << "us";
+
+    for (const auto& output : FnGetPendingOutputs())
+    {
+        ss << " | pin " << output.pinNumber << " " << FnGetCommandName(output.command) << " -> " << output.value << " in " << output.dueInMs << "ms";
+    }
+
+    Logger::getInstance()->FnLog(ss.str(), logFileName_, "DIO");
+}
+
+std::string DIOSequencer::FnGetStatusString()
+{
+    DIOSequencerStats stats = FnGetStats();
+
+    std::stringstream ss;
+    ss << stats.commands << "," << stats.writes << "," << stats.superseded << "," << stats.depth << "," << stats.avgLateUs << "," << stats.maxLateUs;
+    for (const auto& output : FnGetPendingOutputs())
+    {
+        ss << ";" << output.pinNumber << "," << FnGetCommandName(output.command) << "," << output.value << "," << output.dueInMs;
+    }
+
+    return ss.str();
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "lazy_instance.h"
+
+// Timed DIO outputs (pulse, blink, hold) driven from one thread, so callers never sleep on an output.
+// Pin numbers are board pin numbers, the same ones GPIOManager::FnGetGPIO() takes.
+class DIOSequencer
+{
+public:
+    enum class OutputCommand
+    {
+        SET,
+        PULSE,
+        BLINK,
+        HOLD
+    };
+
+    struct PendingOutput
+    {
+        int pinNumber;
+        int value;
+        OutputCommand command;
+        int64_t dueInMs;
+    };
+
+    struct DIOSequencerStats
+    {
+        uint64_t commands;
+        uint64_t writes;
+        uint64_t superseded;
+        uint64_t avgLateUs;
+        uint64_t maxLateUs;
+        std::size_t depth;
+    };
+
+    static DIOSequencer* getInstance();
+    void FnStartSequencer();
+    void FnStopSequencer();
+
+    // A new command on a pin replaces whatever is still scheduled on that pin
+    void FnSet(int pinNumber, int value);
+    void FnPulse(int pinNumber, int durationMs, int value = 1);
+    void FnBlink(int pinNumber, int onMs, int offMs, int count);
+    void FnHold(int pinNumber, int value, int maxHoldMs = 0);
+    void FnCancel(int pinNumber);
+
+    std::vector<PendingOutput> FnGetPendingOutputs();
+    DIOSequencerStats FnGetStats();
+    void FnLogStats();
+    // For the monitor: commands,writes,superseded,depth,avg late us,max late us then ;pin,command,value,due in ms per pending output
+    std::string FnGetStatusString();
+
+    static const char* FnGetCommandName(OutputCommand command);
+
+    /**
+     * Singleton DIOSequencer should not be cloneable.
+     */
+    DIOSequencer(DIOSequencer& dioSequencer) = delete;
+
+    /**
+     * Singleton DIOSequencer should not be assignable.
+     */
+    void operator=(const DIOSequencer&) = delete;
+
+private:
+    struct OutputStep
+    {
+        std::chrono::steady_clock::time_point due;
+        uint64_t sequence;
+        uint64_t generation;
+        int pinNumber;
+        int value;
+        OutputCommand command;
+        int onMs;
+        int offMs;
+        int remainingToggles;   // Blink only, -1 blinks until replaced
+    };
+
+    // Earliest step first, steps due at the same time keep the order they were queued
+    struct OutputStepLater
+    {
+        bool operator()(const OutputStep& a, const OutputStep& b) const
+        {
+            return (a.due != b.due) ? (a.due > b.due) : (a.sequence > b.sequence);
+        }
+    };
+
+    static std::atomic<DIOSequencer*> dioSequencer_;
+    static std::mutex mutex_;
+    std::string logFileName_;
+    std::mutex queueMutex_;
+    std::condition_variable queueCondition_;
+    std::priority_queue<OutputStep, std::vector<OutputStep>, OutputStepLater> steps_;
+    std::unordered_map<int, uint64_t> pinGenerations_;
+    uint64_t nextSequence_;
+    std::atomic<bool> isSequencerRunning_;
+    std::thread sequencerThread_;
+    uint64_t commandCount_;
+    uint64_t writeCount_;
+    uint64_t supersededCount_;
+    uint64_t totalLateUs_;
+    uint64_t maxLateUs_;
+    DIOSequencer();
+    uint64_t beginCommand(int pinNumber);
+    void pushStep(std::chrono::steady_clock::time_point due, uint64_t generation, int pinNumber, int value, OutputCommand command, int onMs = 0, int offMs = 0, int remainingToggles = 0);
+    bool isCurrent(const OutputStep& step) const;
+    void sequencerThreadFunction();
+    void writeOutput(int pinNumber, int value);
+};
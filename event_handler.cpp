@@ -9,88 +9,51 @@
 #include "operation.h"
 #include "lpr.h"
 
-EventHandler* EventHandler::eventHandler_ = nullptr;
+std::atomic<EventHandler*> EventHandler::eventHandler_(nullptr);
 std::mutex EventHandler::mutex_;
 
-std::map<std::string, EventHandler::EventFunction> EventHandler::eventMap = 
-{
-    // DIO Event
-    {   "Evt_handleDIOEvent"                    ,std::bind(&EventHandler::handleDIOEvent                   ,eventHandler_, std::placeholders::_1) },
-
-    // LPR Event
-    {   "Evt_handleLPRReceive"                  ,std::bind(&EventHandler::handleLPRReceive                 ,eventHandler_, std::placeholders::_1) },
-
-    // Barcode Scanner Event
-    {   "Evt_handleBarcodeReceived"             ,std::bind(&EventHandler::handleBarcodeReceived            ,eventHandler_, std::placeholders::_1) },
-
-    // Touch N Go Reader Event
-    // Touch N Go Reader Request Event
-    {   "Evt_handleTnGPayRequest"               ,std::bind(&EventHandler::handleTnGPayRequest              ,eventHandler_, std::placeholders::_1) },
-    {   "Evt_handleTnGPayCancelRequest"         ,std::bind(&EventHandler::handleTnGPayCancelRequest        ,eventHandler_, std::placeholders::_1) },
-    {   "Evt_handleTnGEnableReaderRequest"      ,std::bind(&EventHandler::handleTnGEnableReaderRequest     ,eventHandler_, std::placeholders::_1) },
-    // Touch N Go Reader Response Event
-    {   "Evt_handleTnGPayResultReceived"        ,std::bind(&EventHandler::handleTnGPayResultReceived       ,eventHandler_, std::placeholders::_1) },
-    {   "Evt_handleTnGCardNumReceived"          ,std::bind(&EventHandler::handleTnGCardNumReceived         ,eventHandler_, std::placeholders::_1) }
-};
-
 EventHandler::EventHandler()
 {
 }
 
 EventHandler* EventHandler::getInstance()
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (eventHandler_ == nullptr)
-    {
-        eventHandler_ = new EventHandler();
-    }
-    return eventHandler_;
+    return LazyInstance::FnGet(eventHandler_, mutex_, []() { return new EventHandler(); });
 }
 
-void EventHandler::FnHandleEvents(const std::string& eventName, const BaseEvent* event)
+void EventHandler::FnRegisterEvents()
 {
-    auto it = eventMap.find(eventName);
+    EventManager* eventManager = EventManager::getInstance();
 
-    if (it != eventMap.end())
-    {
-        EventFunction& handler = it->second;
+    // DIO Event
+    eventManager->FnRegisterEvent(EventID::DIO_EVENT                    ,std::bind(&EventHandler::handleDIOEvent                   ,this, std::placeholders::_1));
+    eventManager->FnRegisterEvent(EventID::VEHICLE_CLASSIFIED           ,std::bind(&EventHandler::handleVehicleClassified          ,this, std::placeholders::_1));
 
-        bool ret = false;
-        try
-        {
-            ret = handler(event);
-        }
-        catch (const std::exception& e)
-        {
-            std::stringstream ss;
-            ss << __func__ << ", Exception: " << e.what();
-            Logger::getInstance()->FnLogExceptionError(ss.str());
-        }
-        catch (...)
-        {
-            std::stringstream ss;
-            ss << __func__ << ", Exception: Unknown Exception";
-            Logger::getInstance()->FnLogExceptionError(ss.str());
-        }
-    }
-    else
-    {
-        std::stringstream ss;
-        ss << __func__ << " Event not found : " << eventName;
-        Logger::getInstance()->FnLog(ss.str());
-        Logger::getInstance()->FnLog(ss.str(), eventLogFileName, "EVT");
-    }
+    // LPR Event
+    eventManager->FnRegisterEvent(EventID::LPR_RECEIVE                  ,std::bind(&EventHandler::handleLPRReceive                 ,this, std::placeholders::_1));
+
+    // Barcode Scanner Event
+    eventManager->FnRegisterEvent(EventID::BARCODE_RECEIVED             ,std::bind(&EventHandler::handleBarcodeReceived            ,this, std::placeholders::_1));
+
+    // Touch N Go Reader Event
+    // Touch N Go Reader Request Event
+    eventManager->FnRegisterEvent(EventID::TNG_PAY_REQUEST              ,std::bind(&EventHandler::handleTnGPayRequest              ,this, std::placeholders::_1));
+    eventManager->FnRegisterEvent(EventID::TNG_PAY_CANCEL_REQUEST       ,std::bind(&EventHandler::handleTnGPayCancelRequest        ,this, std::placeholders::_1));
+    eventManager->FnRegisterEvent(EventID::TNG_ENABLE_READER_REQUEST    ,std::bind(&EventHandler::handleTnGEnableReaderRequest     ,this, std::placeholders::_1));
+    // Touch N Go Reader Response Event
+    eventManager->FnRegisterEvent(EventID::TNG_PAY_RESULT_RECEIVED      ,std::bind(&EventHandler::handleTnGPayResultReceived       ,this, std::placeholders::_1));
+    eventManager->FnRegisterEvent(EventID::TNG_CARD_NUM_RECEIVED        ,std::bind(&EventHandler::handleTnGCardNumReceived         ,this, std::placeholders::_1));
 }
 
-bool EventHandler::handleDIOEvent(const BaseEvent* event)
+bool EventHandler::handleDIOEvent(const EventPayload& payload)
 {
     bool ret = true;
 
-    const Event<int>* intEvent = dynamic_cast<const Event<int>*>(event);
+    const DIOEventData* dioEventData = std::get_if<DIOEventData>(&payload);
 
-    if (intEvent != nullptr)
+    if (dioEventData != nullptr)
     {
-        DIO::DIO_EVENT dioEvent = static_cast<DIO::DIO_EVENT>(intEvent->data);
+        DIO::DIO_EVENT dioEvent = static_cast<DIO::DIO_EVENT>(dioEventData->dioEvent);
 
         switch (dioEvent)
         {
@@ -256,16 +219,43 @@ bool EventHandler::handleDIOEvent(const BaseEvent* event)
     return ret;
 }
 
-bool EventHandler::handleLPRReceive(const BaseEvent* event)
+bool EventHandler::handleVehicleClassified(const EventPayload& payload)
 {
     bool ret = true;
 
-    const Event<std::string>* strEvent = dynamic_cast<const Event<std::string>*>(event);
+    const VehicleClassData* vehicleClassData = std::get_if<VehicleClassData>(&payload);
 
-    if (strEvent != nullptr)
+    if (vehicleClassData != nullptr)
     {
-        struct Lpr::LPREventData eventData = Lpr::getInstance()->deserializeEventData(strEvent->data);
-        
+        std::stringstream ss;
+        ss << __func__ << " Successfully, Event Data : " << "vehicleType : " << vehicleClassData->vehicleType;
+        ss << ", resolveMs : " << vehicleClassData->resolveMs;
+        Logger::getInstance()->FnLog(ss.str(), eventLogFileName, "EVT");
+
+        operation::getInstance()->VehicleClassified(vehicleClassData->vehicleType);
+    }
+    else
+    {
+        std::stringstream ss;
+        ss << __func__ << " Event Data casting failed.";
+        Logger::getInstance()->FnLog(ss.str());
+        Logger::getInstance()->FnLog(ss.str(), eventLogFileName, "EVT");
+        ret = false;
+    }
+
+    return ret;
+}
+
+bool EventHandler::handleLPRReceive(const EventPayload& payload)
+{
+    bool ret = true;
+
+    const Lpr::LPREventData* lprEventData = std::get_if<Lpr::LPREventData>(&payload);
+
+    if (lprEventData != nullptr)
+    {
+        const Lpr::LPREventData& eventData = *lprEventData;
+
         std::stringstream ss;
         ss << __func__ << " Successfully, Event Data : " << "camType : " << static_cast<int>(eventData.camType);
         ss << ", LPN : " << eventData.LPN;
@@ -273,11 +263,7 @@ bool EventHandler::handleLPRReceive(const BaseEvent* event)
         ss << ", imagePath : " << eventData.imagePath;
         Logger::getInstance()->FnLog(ss.str(), eventLogFileName, "EVT");
 
-        Lpr::CType camType = eventData.camType;
-        std::string LPN = eventData.LPN;
-        std::string TransID = eventData.TransID;
-        std::string imagePath = eventData.imagePath;
-        operation::getInstance()->ReceivedLPR(camType,LPN, TransID, imagePath);
+        operation::getInstance()->ReceivedLPR(eventData.camType, eventData.LPN, eventData.TransID, eventData.imagePath);
     }
     else
     {
@@ -291,19 +277,19 @@ bool EventHandler::handleLPRReceive(const BaseEvent* event)
     return ret;
 }
 
-bool EventHandler::handleBarcodeReceived(const BaseEvent* event)
+bool EventHandler::handleBarcodeReceived(const EventPayload& payload)
 {
     bool ret = true;
 
-    const Event<std::string>* strEvent = dynamic_cast<const Event<std::string>*>(event);
+    const std::string* strEvent = std::get_if<std::string>(&payload);
 
     if (strEvent != nullptr)
     {
         std::stringstream ss;
-        ss << __func__ << " Successfully, Event Data : " << strEvent->data;
+        ss << __func__ << " Successfully, Event Data : " << *strEvent;
         Logger::getInstance()->FnLog(ss.str(), eventLogFileName, "EVT");
         // process barcode data
-        operation::getInstance()->ProcessBarcodeData(strEvent->data);
+        operation::getInstance()->ProcessBarcodeData(*strEvent);
 
     }
     else
@@ -318,15 +304,15 @@ bool EventHandler::handleBarcodeReceived(const BaseEvent* event)
     return ret;
 }
 
-bool EventHandler::handleTnGPayRequest(const BaseEvent* event)
+bool EventHandler::handleTnGPayRequest(const EventPayload& payload)
 {
     bool ret = true;
 
-    const Event<bool>* boolEvent = dynamic_cast<const Event<bool>*>(event);
+    const bool* boolEvent = std::get_if<bool>(&payload);
 
     if (boolEvent != nullptr)
     {
-        bool value = boolEvent->data;
+        bool value = *boolEvent;
 
         std::stringstream ss;
         ss << __func__ << " Successfully, Event Data : " << value;
@@ -356,15 +342,15 @@ bool EventHandler::handleTnGPayRequest(const BaseEvent* event)
     return ret;
 }
 
-bool EventHandler::handleTnGPayCancelRequest(const BaseEvent* event)
+bool EventHandler::handleTnGPayCancelRequest(const EventPayload& payload)
 {
     bool ret = true;
 
-    const Event<bool>* boolEvent = dynamic_cast<const Event<bool>*>(event);
+    const bool* boolEvent = std::get_if<bool>(&payload);
 
     if (boolEvent != nullptr)
     {
-        bool value = boolEvent->data;
+        bool value = *boolEvent;
 
         std::stringstream ss;
         ss << __func__ << " Successfully, Event Data : " << value;
@@ -394,15 +380,15 @@ bool EventHandler::handleTnGPayCancelRequest(const BaseEvent* event)
     return ret;
 }
 
-bool EventHandler::handleTnGEnableReaderRequest(const BaseEvent* event)
+bool EventHandler::handleTnGEnableReaderRequest(const EventPayload& payload)
 {
     bool ret = true;
 
-    const Event<bool>* boolEvent = dynamic_cast<const Event<bool>*>(event);
+    const bool* boolEvent = std::get_if<bool>(&payload);
 
     if (boolEvent != nullptr)
     {
-        bool value = boolEvent->data;
+        bool value = *boolEvent;
 
         std::stringstream ss;
         ss << __func__ << " Successfully, Event Data : " << value;
@@ -432,19 +418,19 @@ bool EventHandler::handleTnGEnableReaderRequest(const BaseEvent* event)
     return ret;
 }
 
-bool EventHandler::handleTnGPayResultReceived(const BaseEvent* event)
+bool EventHandler::handleTnGPayResultReceived(const EventPayload& payload)
 {
     bool ret = true;
 
-    const Event<std::string>* strEvent = dynamic_cast<const Event<std::string>*>(event);
+    const std::string* strEvent = std::get_if<std::string>(&payload);
 
     if (strEvent != nullptr)
     {
         std::stringstream ss;
-        ss << __func__ << " Successfully, Event Data : " << strEvent->data;
+        ss << __func__ << " Successfully, Event Data : " << *strEvent;
         Logger::getInstance()->FnLog(ss.str(), eventLogFileName, "EVT");
         // process Touch N Go Pay Result Received
-        operation::getInstance()->processTnGResponse("PayResult", strEvent->data);
+        operation::getInstance()->processTnGResponse("PayResult", *strEvent);
 
     }
     else
@@ -459,19 +445,19 @@ bool EventHandler::handleTnGPayResultReceived(const BaseEvent* event)
     return ret;
 }
 
-bool EventHandler::handleTnGCardNumReceived(const BaseEvent* event)
+bool EventHandler::handleTnGCardNumReceived(const EventPayload& payload)
 {
     bool ret = true;
 
-    const Event<std::string>* strEvent = dynamic_cast<const Event<std::string>*>(event);
+    const std::string* strEvent = std::get_if<std::string>(&payload);
 
     if (strEvent != nullptr)
     {
         std::stringstream ss;
-        ss << __func__ << " Successfully, Event Data : " << strEvent->data;
+        ss << __func__ << " Successfully, Event Data : " << *strEvent;
         Logger::getInstance()->FnLog(ss.str(), eventLogFileName, "EVT");
         // process Touch N Go Card Number Received
-        operation::getInstance()->processTnGResponse("TnGCardNumResult", strEvent->data);
+        operation::getInstance()->processTnGResponse("TnGCardNumResult", *strEvent);
 
     }
     else
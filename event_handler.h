@@ -2,20 +2,16 @@
 
 #include <iostream>
 #include <functional>
-#include <map>
 #include <mutex>
 #include <string>
 #include "event_manager.h"
+#include "lazy_instance.h"
 
 class EventHandler
 {
 
 public:
-    typedef std::function<bool(const BaseEvent*)> EventFunction;
-
-    static std::map<std::string, EventHandler::EventFunction> eventMap;
-
-    void FnHandleEvents(const std::string& eventName, const BaseEvent* event);
+    void FnRegisterEvents();
     static EventHandler* getInstance();
 
     /**
@@ -29,23 +25,24 @@ public:
     void operator=(const EventHandler&) = delete;
 
 private:
-    static EventHandler* eventHandler_;
+    static std::atomic<EventHandler*> eventHandler_;
     static std::mutex mutex_;
     EventHandler();
 
     // DIO Event Handler
-    bool handleDIOEvent(const BaseEvent* event);
+    bool handleDIOEvent(const EventPayload& payload);
+    bool handleVehicleClassified(const EventPayload& payload);
 
     // LPR Event Handler
-    bool handleLPRReceive(const BaseEvent* event);
+    bool handleLPRReceive(const EventPayload& payload);
 
     // Barcode Scanner Event Handler
-    bool handleBarcodeReceived(const BaseEvent* event);
+    bool handleBarcodeReceived(const EventPayload& payload);
 
     // Touch N Go Reader Event Handler
-    bool handleTnGPayRequest(const BaseEvent* event);
-    bool handleTnGPayCancelRequest(const BaseEvent* event);
-    bool handleTnGEnableReaderRequest(const BaseEvent* event);
-    bool handleTnGPayResultReceived(const BaseEvent* event);
-    bool handleTnGCardNumReceived(const BaseEvent* event);
+    bool handleTnGPayRequest(const EventPayload& payload);
+    bool handleTnGPayCancelRequest(const EventPayload& payload);
+    bool handleTnGEnableReaderRequest(const EventPayload& payload);
+    bool handleTnGPayResultReceived(const EventPayload& payload);
+    bool handleTnGCardNumReceived(const EventPayload& payload);
 };
\ No newline at end of file
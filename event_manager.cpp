@@ -1,119 +1,508 @@
 #include <iostream>
 #include <sstream>
+#include "async_flow.h"
 #include "event_manager.h"
+#include "io_executor.h"
+#include "lane_context.h"
 #include "log.h"
 
-EventManager* EventManager::eventManager_ = nullptr;
+std::atomic<EventManager*> EventManager::eventManager_(nullptr);
 std::mutex EventManager::mutex_;
 const std::string eventLogFileName = "event";
 
+static_assert((EventManager::EVENT_QUEUE_CAPACITY & (EventManager::EVENT_QUEUE_CAPACITY - 1)) == 0, "Event queue capacity must be a power of two.");
+
+EventManager::EventQueue::EventQueue(EventPriority queuePriority)
+    : priority(queuePriority),
+    slots(EVENT_QUEUE_CAPACITY),
+    enqueuePos(0),
+    dequeuePos(0),
+    overflowDepth(0),
+    enqueued(0),
+    processed(0),
+    dropped(0),
+    overflowed(0),
+    maxDepth(0),
+    totalLatencyUs(0),
+    maxLatencyUs(0),
+    maxHandlerUs(0)
+{
+    for (std::size_t i = 0; i < slots.size(); i++)
+    {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
 EventManager::EventManager()
-    : isEventThreadRunning_(false)
+    : isEventThreadRunning_(false),
+    isDispatcherWaiting_(false)
 {
+    for (std::size_t i = 0; i < eventQueues_.size(); i++)
+    {
+        eventQueues_[i].reset(new EventQueue(static_cast<EventPriority>(i)));
+    }
+
+    for (auto& isLaneBusy : isLaneBusy_)
+    {
+        isLaneBusy.store(false);
+    }
+
     logFileName_ = eventLogFileName;
     Logger::getInstance()->FnCreateLogFile(logFileName_);
 }
 
 EventManager* EventManager::getInstance()
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (eventManager_ == nullptr)
+    return LazyInstance::FnGet(eventManager_, mutex_, []() { return new EventManager(); });
+}
+
+const char* EventManager::FnGetEventName(EventID eventID)
+{
+    switch (eventID)
     {
-        eventManager_ = new EventManager();
+        case EventID::DIO_EVENT:                    return "Evt_handleDIOEvent";
+        case EventID::VEHICLE_CLASSIFIED:           return "Evt_handleVehicleClassified";
+        case EventID::LPR_RECEIVE:                  return "Evt_handleLPRReceive";
+        case EventID::BARCODE_RECEIVED:             return "Evt_handleBarcodeReceived";
+        case EventID::TNG_PAY_REQUEST:              return "Evt_handleTnGPayRequest";
+        case EventID::TNG_PAY_CANCEL_REQUEST:       return "Evt_handleTnGPayCancelRequest";
+        case EventID::TNG_ENABLE_READER_REQUEST:    return "Evt_handleTnGEnableReaderRequest";
+        case EventID::TNG_PAY_RESULT_RECEIVED:      return "Evt_handleTnGPayResultReceived";
+        case EventID::TNG_CARD_NUM_RECEIVED:        return "Evt_handleTnGCardNumReceived";
+        default:                                    return "Evt_Unknown";
     }
-    return eventManager_;
 }
 
-void EventManager::FnStartEventThread()
+const char* EventManager::FnGetPriorityName(EventPriority priority)
 {
-    Logger::getInstance()->FnLog(__func__, logFileName_, "EVT");
+    switch (priority)
+    {
+        case EventPriority::SAFETY:         return "SAFETY";
+        case EventPriority::PAYMENT:        return "PAYMENT";
+        case EventPriority::LPR:            return "LPR";
+        case EventPriority::HOUSEKEEPING:   return "HOUSEKEEPING";
+        default:                            return "UNKNOWN";
+    }
+}
 
-    if (!isEventThreadRunning_)
+EventPriority EventManager::FnGetEventPriority(EventID eventID)
+{
+    // Every event ID maps to exactly one class, so events from the same source stay in order
+    switch (eventID)
     {
-        isEventThreadRunning_ = true;
-        eventThread_ = std::thread(&EventManager::processEventsFromQueue, this);
+        case EventID::DIO_EVENT:
+        case EventID::VEHICLE_CLASSIFIED:
+            return EventPriority::SAFETY;
+        case EventID::TNG_PAY_REQUEST:
+        case EventID::TNG_PAY_CANCEL_REQUEST:
+        case EventID::TNG_ENABLE_READER_REQUEST:
+        case EventID::TNG_PAY_RESULT_RECEIVED:
+        case EventID::TNG_CARD_NUM_RECEIVED:
+            return EventPriority::PAYMENT;
+        case EventID::LPR_RECEIVE:
+        case EventID::BARCODE_RECEIVED:
+            return EventPriority::LPR;
+        default:
+            return EventPriority::HOUSEKEEPING;
     }
 }
 
-void EventManager::FnStopEventThread()
+void EventManager::FnStartEventThread()
 {
     Logger::getInstance()->FnLog(__func__, logFileName_, "EVT");
 
-    if (isEventThreadRunning_)
+    if (!isEventThreadRunning_.load())
     {
-        isEventThreadRunning_ = false;
-        condition_.notify_one();
-        eventThread_.join();
+        isEventThreadRunning_.store(true);
+        dispatchThread_ = std::thread(&EventManager::dispatchEvents, this);
     }
 }
 
-void EventManager::FnRegisterEvent(const EventSignal::slot_type& subscriber)
+void EventManager::FnStopEventThread()
 {
     Logger::getInstance()->FnLog(__func__, logFileName_, "EVT");
 
-    eventSignal_.connect(subscriber);
+    if (isEventThreadRunning_.load())
+    {
+        isEventThreadRunning_.store(false);
+        {
+            std::lock_guard<std::mutex> lock(dispatchMutex_);
+            dispatchCondition_.notify_one();
+        }
+        if (dispatchThread_.joinable())
+        {
+            dispatchThread_.join();
+        }
+    }
 }
 
-template <typename EventType>
-void EventManager::FnEnqueueEvent(const std::string& eventName, EventType eventData)
+void EventManager::FnRegisterEvent(EventID eventID, EventFunction handler)
 {
     std::stringstream ss;
-    ss << __func__ << " Event Name : " << eventName;
+    ss << __func__ << " Event Name : " << FnGetEventName(eventID) << ", Priority : " << FnGetPriorityName(FnGetEventPriority(eventID));
     Logger::getInstance()->FnLog(ss.str(), logFileName_, "EVT");
 
-    auto event = std::make_unique<Event<EventType>>(std::move(eventData));
+    // Handlers are registered once at startup, before the event threads are started
+    eventHandlers_[static_cast<std::size_t>(eventID)] = std::move(handler);
+}
+
+uint64_t EventManager::FnGetDroppedEventCount() const
+{
+    uint64_t dropped = 0;
+    for (const auto& queue : eventQueues_)
+    {
+        dropped += queue->dropped.load();
+    }
+    return dropped;
+}
+
+EventQueueStats EventManager::FnGetEventQueueStats(EventPriority priority) const
+{
+    const EventQueue& queue = *eventQueues_[static_cast<std::size_t>(priority)];
+
+    EventQueueStats stats;
+    stats.enqueued = queue.enqueued.load();
+    stats.processed = queue.processed.load();
+    stats.dropped = queue.dropped.load();
+    stats.overflowed = queue.overflowed.load();
+    stats.depth = (stats.enqueued > stats.processed) ? static_cast<std::size_t>(stats.enqueued - stats.processed) : 0;
+    stats.maxDepth = queue.maxDepth.load();
+    stats.avgLatencyUs = (stats.processed > 0) ? (queue.totalLatencyUs.load() / stats.processed) : 0;
+    stats.maxLatencyUs = queue.maxLatencyUs.load();
+    stats.maxHandlerUs = queue.maxHandlerUs.load();
+    return stats;
+}
 
+void EventManager::FnLogEventQueueStats()
+{
+    for (std::size_t i = 0; i < eventQueues_.size(); i++)
     {
-        std::unique_lock<std::mutex> lock(eventThreadMutex_);
-        eventQueue.push_back(std::make_pair(eventName, std::move(event)));
+        EventPriority priority = static_cast<EventPriority>(i);
+        EventQueueStats stats = FnGetEventQueueStats(priority);
+
+        if (stats.enqueued == 0)
+        {
+            continue;
+        }
+
+        std::stringstream ss;
+        ss << "Event Queue " << FnGetPriorityName(priority);
+        ss << " => enqueued: " << stats.enqueued;
+        ss << ", processed: " << stats.processed;
+        ss << ", dropped: " << stats.dropped;
+        ss << ", overflowed: " << stats.overflowed;
+        ss << ", depth: " << stats.depth;
+        ss << ", max depth: " << stats.maxDepth;
+        ss << ", avg wait: " << stats.avgLatencyUs << "us";
+        ss << ", max wait: " << stats.maxLatencyUs << "us";
+        ss << ", max handler: " << stats.maxHandlerUs << "us";
+        Logger::getInstance()->FnLog(ss.str(), logFileName_, "EVT");
     }
-    
-    condition_.notify_one();
 }
 
-void EventManager::processEventsFromQueue()
+void EventManager::updateMax(std::atomic<uint64_t>& maxValue, uint64_t value)
 {
-    while (isEventThreadRunning_)
+    uint64_t current = maxValue.load(std::memory_order_relaxed);
+    while (value > current && !maxValue.compare_exchange_weak(current, value, std::memory_order_relaxed))
     {
-        std::unique_lock<std::mutex> lock(eventThreadMutex_);
+    }
+}
 
-        condition_.wait(lock, [this] { return !eventQueue.empty() || !isEventThreadRunning_;});
+bool EventManager::FnEnqueueEvent(EventID eventID, EventPayload eventData)
+{
+    EventQueue& queue = *eventQueues_[static_cast<std::size_t>(FnGetEventPriority(eventID))];
 
-        while (!eventQueue.empty())
+    if (queue.priority == EventPriority::SAFETY)
+    {
+        // A loop or barrier event must never be lost. Once the ring is full, later events queue behind
+        // the overflow list until it drains, so they still reach the handler in the order they happened.
+        std::lock_guard<std::mutex> lock(queue.overflowMutex);
+        if (!queue.overflow.empty() || !pushSlot(queue, eventID, eventData))
         {
-            auto front = std::move(eventQueue.front());
-            eventQueue.pop_front();
-            lock.unlock();
+            if (queue.overflow.empty())
+            {
+                std::stringstream ss;
+                ss << __func__ << " Event queue " << FnGetPriorityName(queue.priority) << " full, overflow Event Name : " << FnGetEventName(eventID);
+                Logger::getInstance()->FnLog(ss.str(), logFileName_, "EVT");
+            }
+
+            queue.overflow.push_back(QueuedEvent{ eventID, std::move(eventData), std::chrono::steady_clock::now(), LaneContext::FnGetCurrentLane() });
+            queue.overflowDepth.store(queue.overflow.size());
+            queue.overflowed.fetch_add(1);
+        }
+    }
+    else if (!pushSlot(queue, eventID, eventData))
+    {
+        queue.dropped.fetch_add(1);
+
+        std::stringstream ss;
+        ss << __func__ << " Event queue " << FnGetPriorityName(queue.priority) << " full, dropped Event Name : " << FnGetEventName(eventID);
+        Logger::getInstance()->FnLog(ss.str(), logFileName_, "EVT");
+        return false;
+    }
+
+    uint64_t enqueued = queue.enqueued.fetch_add(1) + 1;
+    uint64_t processed = queue.processed.load();
+    std::size_t depth = (enqueued > processed) ? static_cast<std::size_t>(enqueued - processed) : 0;
+    std::size_t maxDepth = queue.maxDepth.load(std::memory_order_relaxed);
+    while (depth > maxDepth && !queue.maxDepth.compare_exchange_weak(maxDepth, depth, std::memory_order_relaxed))
+    {
+    }
+
+    // Only wake the dispatcher when it is actually sleeping
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (isDispatcherWaiting_.load())
+    {
+        std::lock_guard<std::mutex> lock(dispatchMutex_);
+        dispatchCondition_.notify_one();
+    }
+
+    return true;
+}
+
+bool EventManager::pushSlot(EventQueue& queue, EventID eventID, EventPayload& eventData)
+{
+    const std::size_t mask = EVENT_QUEUE_CAPACITY - 1;
+    EventSlot* slot = nullptr;
+    std::size_t pos = queue.enqueuePos.load(std::memory_order_relaxed);
+
+    while (true)
+    {
+        slot = &queue.slots[pos & mask];
+        std::size_t seq = slot->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
 
-            try
+        if (diff == 0)
+        {
+            if (queue.enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
             {
-                processEvent(front.first, front.second.get());
+                break;
             }
-            catch (const std::exception& e)
+        }
+        else if (diff < 0)
+        {
+            // Queue full
+            return false;
+        }
+        else
+        {
+            pos = queue.enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->eventID = eventID;
+    slot->payload = std::move(eventData);
+    slot->enqueueTime = std::chrono::steady_clock::now();
+    slot->laneId = LaneContext::FnGetCurrentLane();
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    return true;
+}
+
+bool EventManager::hasEvent(const EventQueue& queue)
+{
+    const EventSlot& slot = queue.slots[queue.dequeuePos & (EVENT_QUEUE_CAPACITY - 1)];
+    return (slot.sequence.load(std::memory_order_acquire) == queue.dequeuePos + 1) || (queue.overflowDepth.load() > 0);
+}
+
+bool EventManager::dequeueEvent(EventQueue& queue, QueuedEvent& event)
+{
+    const std::size_t mask = EVENT_QUEUE_CAPACITY - 1;
+    EventSlot& slot = queue.slots[queue.dequeuePos & mask];
+    std::size_t seq = slot.sequence.load(std::memory_order_acquire);
+
+    if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(queue.dequeuePos + 1) < 0)
+    {
+        // Ring empty, the overflow comes after everything the ring held
+        if (queue.overflowDepth.load() == 0)
+        {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(queue.overflowMutex);
+        event = std::move(queue.overflow.front());
+        queue.overflow.pop_front();
+        queue.overflowDepth.store(queue.overflow.size());
+        return true;
+    }
+
+    event.eventID = slot.eventID;
+    event.payload = std::move(slot.payload);
+    event.enqueueTime = slot.enqueueTime;
+    event.laneId = slot.laneId;
+    slot.payload = std::monostate{};
+    slot.sequence.store(queue.dequeuePos + EVENT_QUEUE_CAPACITY, std::memory_order_release);
+    queue.dequeuePos++;
+
+    return true;
+}
+
+void EventManager::addPendingEvent(EventQueue& queue, QueuedEvent event)
+{
+    std::deque<QueuedEvent>& pending = pendingEvents_[event.laneId][static_cast<std::size_t>(queue.priority)];
+
+    // SAFETY is never dropped, the other classes keep at most a ring's worth per lane behind a busy handler
+    if ((queue.priority != EventPriority::SAFETY) && (pending.size() >= EVENT_QUEUE_CAPACITY))
+    {
+        // Counted as dropped instead of enqueued, as when the ring itself is full
+        queue.enqueued.fetch_sub(1);
+        queue.dropped.fetch_add(1);
+
+        std::stringstream ss;
+        ss << __func__ << " Lane " << event.laneId << " " << FnGetPriorityName(queue.priority) << " events full, dropped Event Name : " << FnGetEventName(event.eventID);
+        Logger::getInstance()->FnLog(ss.str(), logFileName_, "EVT");
+        return;
+    }
+
+    pending.push_back(std::move(event));
+}
+
+bool EventManager::hasDispatchWork() const
+{
+    for (const auto& queue : eventQueues_)
+    {
+        if (hasEvent(*queue))
+        {
+            return true;
+        }
+    }
+
+    for (int laneId = 0; laneId < LaneContext::MAX_LANES; laneId++)
+    {
+        if (isLaneBusy_[laneId].load())
+        {
+            continue;
+        }
+        for (const auto& pending : pendingEvents_[laneId])
+        {
+            if (!pending.empty())
             {
-                std::stringstream ss;
-                ss << __func__ << ", Event Name:" << front.first << ", Exception: " << e.what();
-                Logger::getInstance()->FnLogExceptionError(ss.str());
+                return true;
             }
-            catch (...)
+        }
+    }
+
+    return false;
+}
+
+void EventManager::dispatchEvents()
+{
+    IOExecutor::FnNameCurrentThread("pbs-evt");
+
+    QueuedEvent event;
+
+    while (isEventThreadRunning_.load())
+    {
+        // Everything raised so far goes to its lane's pending events, so no lane waits behind another one
+        for (auto& queue : eventQueues_)
+        {
+            while (dequeueEvent(*queue, event))
             {
-                std::stringstream ss;
-                ss << __func__ << ", Event Name:" << front.first << ", Exception: Unknown Exception";
-                Logger::getInstance()->FnLogExceptionError(ss.str());
+                addPendingEvent(*queue, std::move(event));
             }
+        }
 
+        // Each idle lane takes its highest class first, so a waiting loop event goes ahead of queued LPR results
+        for (int laneId = 0; laneId < LaneContext::MAX_LANES; laneId++)
+        {
+            if (isLaneBusy_[laneId].load())
+            {
+                continue;
+            }
 
-            lock.lock();
+            for (std::size_t i = 0; i < eventQueues_.size(); i++)
+            {
+                std::deque<QueuedEvent>& pending = pendingEvents_[laneId][i];
+                if (!pending.empty())
+                {
+                    event = std::move(pending.front());
+                    pending.pop_front();
+                    isLaneBusy_[laneId].store(true);
+                    runOnLane(*eventQueues_[i], std::move(event));
+                    break;
+                }
+            }
         }
+
+        std::unique_lock<std::mutex> lock(dispatchMutex_);
+        isDispatcherWaiting_.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        dispatchCondition_.wait_for(lock, std::chrono::milliseconds(100), [this] {
+            return hasDispatchWork() || !isEventThreadRunning_.load();
+        });
+
+        isDispatcherWaiting_.store(false);
     }
 }
 
-void EventManager::processEvent(const std::string& eventName, BaseEvent* event)
+void EventManager::runOnLane(EventQueue& queue, QueuedEvent event)
+{
+    int laneId = event.laneId;
+
+    // Handlers change the lane's tProcess, tEntry and tExit, the flow strand is the one place they may do so
+    LaneContext::Scope laneScope(laneId);
+    AsyncFlow::getInstance()->FnPost([this, &queue, event = std::move(event)]()
+    {
+        auto startTime = std::chrono::steady_clock::now();
+        uint64_t latencyUs = std::chrono::duration_cast<std::chrono::microseconds>(startTime - event.enqueueTime).count();
+        queue.totalLatencyUs.fetch_add(latencyUs, std::memory_order_relaxed);
+        updateMax(queue.maxLatencyUs, latencyUs);
+
+        try
+        {
+            processEvent(event.eventID, event.payload);
+        }
+        catch (const std::exception& e)
+        {
+            std::stringstream ss;
+            ss << "runOnLane, Event Name:" << FnGetEventName(event.eventID) << ", Exception: " << e.what();
+            Logger::getInstance()->FnLogExceptionError(ss.str());
+        }
+        catch (...)
+        {
+            std::stringstream ss;
+            ss << "runOnLane, Event Name:" << FnGetEventName(event.eventID) << ", Exception: Unknown Exception";
+            Logger::getInstance()->FnLogExceptionError(ss.str());
+        }
+
+        uint64_t handlerUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+        updateMax(queue.maxHandlerUs, handlerUs);
+        queue.processed.fetch_add(1);
+        laneFinished(event.laneId);
+    });
+}
+
+void EventManager::laneFinished(int laneId)
 {
-    eventSignal_(eventName, event);
+    isLaneBusy_[laneId].store(false);
+
+    // Only wake the dispatcher when it is actually sleeping
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (isDispatcherWaiting_.load())
+    {
+        std::lock_guard<std::mutex> lock(dispatchMutex_);
+        dispatchCondition_.notify_one();
+    }
 }
 
-// Add other template specializations if needed
-template void EventManager::FnEnqueueEvent<int>(const std::string&, int);
-template void EventManager::FnEnqueueEvent<bool>(const std::string&, bool);
-template void EventManager::FnEnqueueEvent<std::string>(const std::string&, std::string);
\ No newline at end of file
+void EventManager::processEvent(EventID eventID, const EventPayload& payload)
+{
+    std::stringstream ss;
+    ss << __func__ << " Event Name : " << FnGetEventName(eventID);
+    Logger::getInstance()->FnLog(ss.str(), logFileName_, "EVT");
+
+    const EventFunction& handler = eventHandlers_[static_cast<std::size_t>(eventID)];
+
+    if (handler)
+    {
+        handler(payload);
+    }
+    else
+    {
+        std::stringstream oss;
+        oss << __func__ << " Event not found : " << FnGetEventName(eventID);
+        Logger::getInstance()->FnLog(oss.str());
+        Logger::getInstance()->FnLog(oss.str(), logFileName_, "EVT");
+    }
+}
@@ -1,47 +1,109 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <mutex>
 #include <thread>
 #include <condition_variable>
-#include <queue>
-#include <unordered_map>
-#include <typeinfo>
-#include "boost/signals2.hpp"
+#include <deque>
+#include <variant>
+#include <vector>
+#include "lane_context.h"
+#include "lpr.h"
+#include "lazy_instance.h"
 
 extern const std::string eventLogFileName;
 
-class BaseEvent
+enum class EventID : uint8_t
 {
+    // DIO Event
+    DIO_EVENT = 0,
+    VEHICLE_CLASSIFIED,
 
-public:
-    virtual ~BaseEvent() = default;
+    // LPR Event
+    LPR_RECEIVE,
+
+    // Barcode Scanner Event
+    BARCODE_RECEIVED,
+
+    // Touch N Go Reader Request Event
+    TNG_PAY_REQUEST,
+    TNG_PAY_CANCEL_REQUEST,
+    TNG_ENABLE_READER_REQUEST,
+
+    // Touch N Go Reader Response Event
+    TNG_PAY_RESULT_RECEIVED,
+    TNG_CARD_NUM_RECEIVED,
+
+    EVENT_ID_COUNT
 };
 
-template <typename EventType>
-class Event : public BaseEvent
+// Each priority class has its own queue. One dispatcher posts each lane's highest class first to the lane's
+// flow strand, one handler in flight per lane, so a lane's handlers never overlap each other or its flows.
+// A lane whose handler is still running never holds up another lane's events.
+enum class EventPriority : uint8_t
 {
+    SAFETY = 0,         // DIO
+    PAYMENT,            // Touch N Go
+    LPR,                // LPR, barcode
+    HOUSEKEEPING,
 
-public:
-    EventType data;
+    PRIORITY_COUNT
+};
+
+struct DIOEventData
+{
+    int dioEvent;
+    std::chrono::steady_clock::time_point timestamp;
+};
 
-    Event(EventType eventData) : data(std::move(eventData)) {};
+struct VehicleClassData
+{
+    int vehicleType;
+    std::chrono::steady_clock::time_point arrivalTime;
+    int64_t resolveMs;
+};
+
+using EventPayload = std::variant<std::monostate, bool, std::string, DIOEventData, VehicleClassData, Lpr::LPREventData>;
+
+struct EventQueueStats
+{
+    uint64_t enqueued;
+    uint64_t processed;
+    uint64_t dropped;
+    uint64_t overflowed;
+    std::size_t depth;
+    std::size_t maxDepth;
+    uint64_t avgLatencyUs;
+    uint64_t maxLatencyUs;
+    uint64_t maxHandlerUs;
 };
 
 class EventManager
 {
 
 public:
-    using EventSignal = boost::signals2::signal<void(const std::string&, BaseEvent*)>;
+    using EventFunction = std::function<bool(const EventPayload&)>;
+
+    static const std::size_t EVENT_QUEUE_CAPACITY = 1024;
 
     void FnStartEventThread();
     void FnStopEventThread();
-    void FnRegisterEvent(const EventSignal::slot_type& subscriber);
-
-    template <typename EventType>
-    void FnEnqueueEvent(const std::string& eventName, EventType eventData);
+    void FnRegisterEvent(EventID eventID, EventFunction handler);
+    bool FnEnqueueEvent(EventID eventID, EventPayload eventData);
+    uint64_t FnGetDroppedEventCount() const;
+    EventQueueStats FnGetEventQueueStats(EventPriority priority) const;
+    void FnLogEventQueueStats();
 
+    static EventPriority FnGetEventPriority(EventID eventID);
+    static const char* FnGetEventName(EventID eventID);
+    static const char* FnGetPriorityName(EventPriority priority);
     static EventManager* getInstance();
 
     /**
@@ -55,16 +117,70 @@ public:
     void operator=(const EventManager&) = delete;
 
 private:
-    static EventManager* eventManager_;
+    // Bounded MPSC ring, slots are allocated once and reused, each slot carries its own sequence number
+    struct EventSlot
+    {
+        std::atomic<std::size_t> sequence;
+        EventID eventID;
+        EventPayload payload;
+        std::chrono::steady_clock::time_point enqueueTime;
+        int laneId;     // Lane of the thread that raised the event, the handler runs in it
+    };
+
+    struct QueuedEvent
+    {
+        EventID eventID;
+        EventPayload payload;
+        std::chrono::steady_clock::time_point enqueueTime;
+        int laneId;
+    };
+
+    struct EventQueue
+    {
+        EventPriority priority;
+        std::vector<EventSlot> slots;
+        std::atomic<std::size_t> enqueuePos;
+        std::size_t dequeuePos;
+        // SAFETY only: events that found the ring full, in order, taken once the ring is empty. Never dropped.
+        std::mutex overflowMutex;
+        std::deque<QueuedEvent> overflow;
+        std::atomic<std::size_t> overflowDepth;
+
+        std::atomic<uint64_t> enqueued;
+        std::atomic<uint64_t> processed;
+        std::atomic<uint64_t> dropped;
+        std::atomic<uint64_t> overflowed;
+        std::atomic<std::size_t> maxDepth;
+        std::atomic<uint64_t> totalLatencyUs;
+        std::atomic<uint64_t> maxLatencyUs;
+        std::atomic<uint64_t> maxHandlerUs;
+
+        explicit EventQueue(EventPriority queuePriority);
+    };
+
+    static std::atomic<EventManager*> eventManager_;
     static std::mutex mutex_;
-    EventSignal eventSignal_;
-    std::deque<std::pair<std::string, std::unique_ptr<BaseEvent>>> eventQueue;
-    std::mutex eventThreadMutex_;
-    std::condition_variable condition_;
-    bool isEventThreadRunning_;
-    std::thread eventThread_;
+    std::array<EventFunction, static_cast<std::size_t>(EventID::EVENT_ID_COUNT)> eventHandlers_;
+    std::array<std::unique_ptr<EventQueue>, static_cast<std::size_t>(EventPriority::PRIORITY_COUNT)> eventQueues_;
+    std::atomic<bool> isEventThreadRunning_;
+    std::thread dispatchThread_;
+    std::atomic<bool> isDispatcherWaiting_;
+    // Dispatcher thread only: events taken from the queues that wait for their lane's handler to finish
+    std::array<std::array<std::deque<QueuedEvent>, static_cast<std::size_t>(EventPriority::PRIORITY_COUNT)>, LaneContext::MAX_LANES> pendingEvents_;
+    std::array<std::atomic<bool>, LaneContext::MAX_LANES> isLaneBusy_;
+    std::mutex dispatchMutex_;
+    std::condition_variable dispatchCondition_;
     std::string logFileName_;
     EventManager();
-    void processEventsFromQueue();
-    void processEvent(const std::string& eventName, BaseEvent* event);
-};
\ No newline at end of file
+    bool pushSlot(EventQueue& queue, EventID eventID, EventPayload& eventData);
+    static bool hasEvent(const EventQueue& queue);
+    bool dequeueEvent(EventQueue& queue, QueuedEvent& event);
+    void addPendingEvent(EventQueue& queue, QueuedEvent event);
+    bool hasDispatchWork() const;
+    void dispatchEvents();
+    // Posts the handler to the lane's flow strand and returns at once, the lane is busy until it finishes
+    void runOnLane(EventQueue& queue, QueuedEvent event);
+    void laneFinished(int laneId);
+    void processEvent(EventID eventID, const EventPayload& payload);
+    static void updateMax(std::atomic<uint64_t>& maxValue, uint64_t value);
+};
@@ -1,9 +1,18 @@
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
 #include <unistd.h>
 #include <sstream>
+#include <linux/gpio.h>
+#include <sys/ioctl.h>
+#include "boost/filesystem.hpp"
 #include "gpio.h"
+#include "gpio_simulator.h"
 #include "log.h"
 
-SysfsGPIO::SysfsGPIO(int pinNumber) : pinNumber_(pinNumber)
+SysfsGPIO::SysfsGPIO(int pinNumber) : pinNumber_(pinNumber), valueFd_(-1), edgeEnabled_(false)
 {
     gpioPath_ = "/sys/class/gpio/gpio" + std::to_string(pinNumber_) + "/";
     FnExportGPIO();
@@ -11,9 +20,29 @@ SysfsGPIO::SysfsGPIO(int pinNumber) : pinNumber_(pinNumber)
 
 SysfsGPIO::~SysfsGPIO()
 {
+    if (valueFd_ >= 0)
+    {
+        close(valueFd_);
+        valueFd_ = -1;
+    }
     FnUnexportGPIO();
 }
 
+bool SysfsGPIO::openValueFd()
+{
+    // Keep the value file open, read and write with pread/pwrite instead of reopening on every access
+    if (valueFd_ < 0)
+    {
+        valueFd_ = open((gpioPath_ + "value").c_str(), O_RDWR | O_CLOEXEC);
+        if (valueFd_ < 0)
+        {
+            valueFd_ = open((gpioPath_ + "value").c_str(), O_RDONLY | O_CLOEXEC);
+        }
+    }
+
+    return (valueFd_ >= 0);
+}
+
 bool SysfsGPIO::FnExportGPIO()
 {
     try
@@ -100,6 +129,13 @@ bool SysfsGPIO::FnSetDirection(const std::string& direction)
         directionFile << direction;
         directionFile.close();
 
+        if (!openValueFd())
+        {
+            std::stringstream ss;
+            ss << "Failed to open GPIO value file for pin " << std::to_string(pinNumber_);
+            Logger::getInstance()->FnLog(ss.str());
+        }
+
         return true;
     }
     catch (const std::exception& e)
@@ -118,9 +154,59 @@ bool SysfsGPIO::FnSetDirection(const std::string& direction)
     }
 }
 
+bool SysfsGPIO::FnSetEdge(const std::string& edge)
+{
+    std::lock_guard<std::mutex> lock(gpioMutex_);
+    try
+    {
+        std::ofstream edgeFile(gpioPath_ + "edge");
+        if (!edgeFile.is_open())
+        {
+            std::stringstream ss;
+            ss << "Failed to set GPIO edge for pin " << std::to_string(pinNumber_) << std::endl;
+            Logger::getInstance()->FnLog(ss.str());
+            edgeEnabled_ = false;
+            return false;
+        }
+
+        edgeFile << edge;
+        edgeFile.close();
+
+        edgeEnabled_ = (edgeFile.good() && (edge != "none") && openValueFd());
+
+        return edgeEnabled_;
+    }
+    catch (const std::exception& e)
+    {
+        std::stringstream ss;
+        ss << __func__ << ", GPIO: " << std::to_string(pinNumber_) << ", Edge: " << edge << ", Exception: " << e.what();
+        Logger::getInstance()->FnLogExceptionError(ss.str());
+        edgeEnabled_ = false;
+        return false;
+    }
+    catch (...)
+    {
+        std::stringstream ss;
+        ss << __func__ << ", GPIO: " << std::to_string(pinNumber_) << ", Edge: " << edge << ", Exception: Unknown Exception";
+        Logger::getInstance()->FnLogExceptionError(ss.str());
+        edgeEnabled_ = false;
+        return false;
+    }
+}
+
 bool SysfsGPIO::FnSetValue(int value)
 {
     std::lock_guard<std::mutex> lock(gpioMutex_);
+
+    if (valueFd_ >= 0)
+    {
+        const char buf = (value != 0) ? '1' : '0';
+        if (pwrite(valueFd_, &buf, 1, 0) == 1)
+        {
+            return true;
+        }
+    }
+
     try
     {
         std::ofstream valueFile(gpioPath_ + "value");
@@ -156,6 +242,17 @@ bool SysfsGPIO::FnSetValue(int value)
 int SysfsGPIO::FnGetValue() const
 {
     std::lock_guard<std::mutex> lock(gpioMutex_);
+
+    if (valueFd_ >= 0)
+    {
+        // Reading from offset 0 also clears a pending edge notification for poll()
+        char buf[4] = {0};
+        if (pread(valueFd_, buf, sizeof(buf) - 1, 0) > 0)
+        {
+            return (buf[0] == '1') ? 1 : 0;
+        }
+    }
+
     try
     {
         std::ifstream valueFile(gpioPath_ + "value");
@@ -190,17 +287,335 @@ int SysfsGPIO::FnGetValue() const
     }
 }
 
+int SysfsGPIO::FnGetValueFd() const
+{
+    return valueFd_;
+}
+
+short SysfsGPIO::FnGetPollEvents() const
+{
+    return POLLPRI | POLLERR;
+}
+
+std::chrono::steady_clock::time_point SysfsGPIO::FnAcknowledgeEdge()
+{
+    std::lock_guard<std::mutex> lock(gpioMutex_);
+
+    // sysfs does not report when the edge happened, the wake-up time is the closest we have
+    if (valueFd_ >= 0)
+    {
+        char buf[4] = {0};
+        pread(valueFd_, buf, sizeof(buf) - 1, 0);
+    }
+
+    return std::chrono::steady_clock::now();
+}
+
+bool SysfsGPIO::FnIsEdgeEnabled() const
+{
+    return edgeEnabled_;
+}
+
+int SysfsGPIO::FnGetPinNumber() const
+{
+    return pinNumber_;
+}
+
 std::string SysfsGPIO::FnGetGPIOPath() const
 {
     return gpioPath_;
 }
 
 
+// Chardev GPIO Code
+ChardevGPIO::ChardevGPIO(int pinNumber) : pinNumber_(pinNumber), chipPath_(""), lineOffset_(0), lineFd_(-1), edgeEnabled_(false)
+{
+    if (!resolveLine())
+    {
+        std::stringstream ss;
+        ss << "Failed to find GPIO chip for pin " << std::to_string(pinNumber_);
+        Logger::getInstance()->FnLog(ss.str());
+    }
+}
+
+ChardevGPIO::~ChardevGPIO()
+{
+    releaseLine();
+}
+
+bool ChardevGPIO::resolveLine()
+{
+    // Board pin numbers are global sysfs numbers, find the chip whose [base, base + ngpio) holds the pin
+    try
+    {
+        boost::filesystem::path gpioClassPath("/sys/class/gpio");
+        if (!boost::filesystem::exists(gpioClassPath))
+        {
+            return false;
+        }
+
+        for (const auto& entry : boost::filesystem::directory_iterator(gpioClassPath))
+        {
+            std::string name = entry.path().filename().string();
+            if (name.rfind("gpiochip", 0) != 0)
+            {
+                continue;
+            }
+
+            int base = -1;
+            int ngpio = 0;
+            std::ifstream baseFile((entry.path() / "base").string());
+            std::ifstream ngpioFile((entry.path() / "ngpio").string());
+            if (!(baseFile >> base) || !(ngpioFile >> ngpio))
+            {
+                continue;
+            }
+
+            if ((pinNumber_ < base) || (pinNumber_ >= (base + ngpio)))
+            {
+                continue;
+            }
+
+            boost::filesystem::path devicePath = entry.path() / "device";
+            if (!boost::filesystem::exists(devicePath))
+            {
+                continue;
+            }
+
+            for (const auto& deviceEntry : boost::filesystem::directory_iterator(devicePath))
+            {
+                std::string deviceName = deviceEntry.path().filename().string();
+                if ((deviceName.rfind("gpiochip", 0) == 0) && boost::filesystem::exists("/dev/" + deviceName))
+                {
+                    chipPath_ = "/dev/" + deviceName;
+                    lineOffset_ = static_cast<unsigned int>(pinNumber_ - base);
+                    return true;
+                }
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::stringstream ss;
+        ss << __func__ << ", GPIO: " << std::to_string(pinNumber_) << ", Exception: " << e.what();
+        Logger::getInstance()->FnLogExceptionError(ss.str());
+    }
+    catch (...)
+    {
+        std::stringstream ss;
+        ss << __func__ << ", GPIO: " << std::to_string(pinNumber_) << ", Exception: Unknown Exception";
+        Logger::getInstance()->FnLogExceptionError(ss.str());
+    }
+
+    return false;
+}
+
+bool ChardevGPIO::requestLine(bool isOutput, bool isEdge)
+{
+    releaseLine();
+
+    if (chipPath_.empty())
+    {
+        return false;
+    }
+
+    int chipFd = open(chipPath_.c_str(), O_RDWR | O_CLOEXEC);
+    if (chipFd < 0)
+    {
+        std::stringstream ss;
+        ss << "Failed to open " << chipPath_ << " for pin " << std::to_string(pinNumber_) << ", errno: " << std::strerror(errno);
+        Logger::getInstance()->FnLog(ss.str());
+        return false;
+    }
+
+    int ret = -1;
+    if (isEdge)
+    {
+        struct gpioevent_request req;
+        std::memset(&req, 0, sizeof(req));
+        req.lineoffset = lineOffset_;
+        req.handleflags = GPIOHANDLE_REQUEST_INPUT;
+        req.eventflags = GPIOEVENT_REQUEST_BOTH_EDGES;
+        std::strncpy(req.consumer_label, "linuxpbs", sizeof(req.consumer_label) - 1);
+
+        ret = ioctl(chipFd, GPIO_GET_LINEEVENT_IOCTL, &req);
+        if (ret == 0)
+        {
+            lineFd_ = req.fd;
+            fcntl(lineFd_, F_SETFL, fcntl(lineFd_, F_GETFL) | O_NONBLOCK);
+        }
+    }
+    else
+    {
+        struct gpiohandle_request req;
+        std::memset(&req, 0, sizeof(req));
+        req.lineoffsets[0] = lineOffset_;
+        req.lines = 1;
+        req.flags = isOutput ? GPIOHANDLE_REQUEST_OUTPUT : GPIOHANDLE_REQUEST_INPUT;
+        req.default_values[0] = 0;
+        std::strncpy(req.consumer_label, "linuxpbs", sizeof(req.consumer_label) - 1);
+
+        ret = ioctl(chipFd, GPIO_GET_LINEHANDLE_IOCTL, &req);
+        if (ret == 0)
+        {
+            lineFd_ = req.fd;
+        }
+    }
+
+    if (ret != 0)
+    {
+        std::stringstream ss;
+        ss << "Failed to request line " << lineOffset_ << " of " << chipPath_ << " for pin " << std::to_string(pinNumber_) << ", errno: " << std::strerror(errno);
+        Logger::getInstance()->FnLog(ss.str());
+    }
+
+    close(chipFd);
+
+    return (lineFd_ >= 0);
+}
+
+void ChardevGPIO::releaseLine()
+{
+    if (lineFd_ >= 0)
+    {
+        close(lineFd_);
+        lineFd_ = -1;
+    }
+    edgeEnabled_ = false;
+}
+
+bool ChardevGPIO::FnSetDirection(const std::string& direction)
+{
+    std::lock_guard<std::mutex> lock(gpioMutex_);
+
+    return requestLine(direction == "out", false);
+}
+
+bool ChardevGPIO::FnSetEdge(const std::string& edge)
+{
+    std::lock_guard<std::mutex> lock(gpioMutex_);
+
+    if (edge == "none")
+    {
+        requestLine(false, false);
+        return false;
+    }
+
+    edgeEnabled_ = requestLine(false, true);
+    if (!edgeEnabled_)
+    {
+        // Keep the pin usable as a plain input
+        requestLine(false, false);
+    }
+
+    return edgeEnabled_;
+}
+
+bool ChardevGPIO::FnSetValue(int value)
+{
+    std::lock_guard<std::mutex> lock(gpioMutex_);
+
+    struct gpiohandle_data data;
+    std::memset(&data, 0, sizeof(data));
+    data.values[0] = (value != 0) ? 1 : 0;
+
+    if ((lineFd_ < 0) || (ioctl(lineFd_, GPIOHANDLE_SET_LINE_VALUES_IOCTL, &data) != 0))
+    {
+        std::stringstream ss;
+        ss << "Failed to set GPIO value for pin " << std::to_string(pinNumber_);
+        Logger::getInstance()->FnLog(ss.str());
+        return false;
+    }
+
+    return true;
+}
+
+int ChardevGPIO::FnGetValue() const
+{
+    std::lock_guard<std::mutex> lock(gpioMutex_);
+
+    struct gpiohandle_data data;
+    std::memset(&data, 0, sizeof(data));
+
+    if ((lineFd_ < 0) || (ioctl(lineFd_, GPIOHANDLE_GET_LINE_VALUES_IOCTL, &data) != 0))
+    {
+        std::stringstream ss;
+        ss << "Failed to get GPIO value for pin " << std::to_string(pinNumber_);
+        Logger::getInstance()->FnLog(ss.str());
+        return -1;
+    }
+
+    return data.values[0];
+}
+
+int ChardevGPIO::FnGetValueFd() const
+{
+    return lineFd_;
+}
+
+short ChardevGPIO::FnGetPollEvents() const
+{
+    return POLLIN;
+}
+
+bool ChardevGPIO::FnIsEdgeEnabled() const
+{
+    return edgeEnabled_;
+}
+
+std::chrono::steady_clock::time_point ChardevGPIO::FnAcknowledgeEdge()
+{
+    std::lock_guard<std::mutex> lock(gpioMutex_);
+
+    // Drain every queued edge, the earliest one is when the input started changing
+    bool hasEvent = false;
+    uint64_t firstTimestampNs = 0;
+    struct gpioevent_data event;
+
+    while ((lineFd_ >= 0) && (read(lineFd_, &event, sizeof(event)) == static_cast<ssize_t>(sizeof(event))))
+    {
+        if (!hasEvent)
+        {
+            firstTimestampNs = event.timestamp;
+            hasEvent = true;
+        }
+    }
+
+    return hasEvent ? toSteadyClock(firstTimestampNs) : std::chrono::steady_clock::now();
+}
+
+int ChardevGPIO::FnGetPinNumber() const
+{
+    return pinNumber_;
+}
+
+std::chrono::steady_clock::time_point ChardevGPIO::toSteadyClock(uint64_t timestampNs)
+{
+    // Kernels before 5.7 stamp line events with CLOCK_REALTIME, later ones with CLOCK_MONOTONIC
+    struct timespec mono;
+    struct timespec real;
+    clock_gettime(CLOCK_MONOTONIC, &mono);
+    clock_gettime(CLOCK_REALTIME, &real);
+
+    int64_t monoNs = static_cast<int64_t>(mono.tv_sec) * 1000000000LL + mono.tv_nsec;
+    int64_t realNs = static_cast<int64_t>(real.tv_sec) * 1000000000LL + real.tv_nsec;
+    int64_t eventNs = static_cast<int64_t>(timestampNs);
+
+    if (std::llabs(eventNs - realNs) < std::llabs(eventNs - monoNs))
+    {
+        eventNs -= (realNs - monoNs);
+    }
+
+    return std::chrono::steady_clock::time_point(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(eventNs)));
+}
+
+
 // GPIO Manager Code
-GPIOManager* GPIOManager::GPIOManager_;
+std::atomic<GPIOManager*> GPIOManager::GPIOManager_(nullptr);
 std::mutex GPIOManager::mutex_;
 
 GPIOManager::GPIOManager()
+    : backend_(GPIO_BACKEND_SYSFS)
 {
 
 }
@@ -212,16 +627,24 @@ GPIOManager::~GPIOManager()
 
 GPIOManager* GPIOManager::getInstance()
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (GPIOManager_ == nullptr)
-    {
-        GPIOManager_ = new GPIOManager();
-    }
-    return GPIOManager_;
+    return LazyInstance::FnGet(GPIOManager_, mutex_, []() { return new GPIOManager(); });
 }
 
-bool GPIOManager::FnGPIOInit()
+bool GPIOManager::FnGPIOInit(const std::string& backend)
 {
+    if ((backend == GPIO_BACKEND_SYSFS) || (backend == GPIO_BACKEND_CHARDEV) || (backend == GPIO_BACKEND_SIMULATOR))
+    {
+        backend_ = backend;
+    }
+    else
+    {
+        Logger::getInstance()->FnLog("Unknown GPIO backend: " + backend + ", use sysfs.");
+        backend_ = GPIO_BACKEND_SYSFS;
+    }
+    Logger::getInstance()->FnLog("GPIO backend: " + backend_);
+
+    gpioPins_.clear();
+
     // List all output pins
     const std::vector<int> outputPins = {
         PIN_DO1, PIN_DO2, PIN_DO3, PIN_DO4, PIN_DO5, PIN_DO6,
@@ -259,19 +682,46 @@ bool GPIOManager::FnGPIOInit()
     return true;
 }
 
-SysfsGPIO* GPIOManager::FnGetGPIO(int pinNumber)
+GPIOPin* GPIOManager::FnGetGPIO(int pinNumber)
 {
     auto it = gpioPins_.find(pinNumber);
     return (it != gpioPins_.end()) ? it->second.get() : nullptr;
 }
 
+std::string GPIOManager::FnGetBackend() const
+{
+    return backend_;
+}
+
+std::unique_ptr<GPIOPin> GPIOManager::createPin(int pinNumber)
+{
+    if (backend_ == GPIO_BACKEND_CHARDEV)
+    {
+        return std::make_unique<ChardevGPIO>(pinNumber);
+    }
+    else if (backend_ == GPIO_BACKEND_SIMULATOR)
+    {
+        return std::make_unique<SimulatedGPIO>(pinNumber);
+    }
+
+    return std::make_unique<SysfsGPIO>(pinNumber);
+}
+
 bool GPIOManager::FnInitSetGPIODirection(int pinNumber, const std::string& dir)
 {
     bool success = false;
-    std::unique_ptr<SysfsGPIO> gpio = std::make_unique<SysfsGPIO>(pinNumber);
+    std::unique_ptr<GPIOPin> gpio = createPin(pinNumber);
     if (dir == GPIO_IN)
     {
         success = gpio->FnSetDirection(GPIO_IN);
+
+        // Edge notification is optional, DIO falls back to polling for pins without it
+        if (success && !gpio->FnSetEdge(GPIO_EDGE_BOTH))
+        {
+            std::stringstream ss;
+            ss << "Edge notification not available for pin " << std::to_string(pinNumber);
+            Logger::getInstance()->FnLog(ss.str());
+        }
     }
     else if (dir == GPIO_OUT)
     {
@@ -1,30 +1,94 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <iostream>
 #include <fstream>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include "lazy_instance.h"
 
-class SysfsGPIO
+// GPIO backend interface, pin numbers are the board pin numbers regardless of backend
+class GPIOPin
+{
+
+public:
+    virtual ~GPIOPin() = default;
+    virtual bool FnSetDirection(const std::string& direction) = 0;
+    virtual bool FnSetEdge(const std::string& edge) = 0;
+    virtual bool FnSetValue(int value) = 0;
+    virtual int FnGetValue() const = 0;
+    // File descriptor to poll() for edges and the events to wait for, -1 if edges are not available
+    virtual int FnGetValueFd() const = 0;
+    virtual short FnGetPollEvents() const = 0;
+    virtual bool FnIsEdgeEnabled() const = 0;
+    // Clear a pending edge after poll() reported it, return the time the edge happened
+    virtual std::chrono::steady_clock::time_point FnAcknowledgeEdge() = 0;
+    virtual int FnGetPinNumber() const = 0;
+};
+
+
+class SysfsGPIO : public GPIOPin
 {
 
 public:
     SysfsGPIO(int pinNumber);
     ~SysfsGPIO();
-    bool FnSetDirection(const std::string& direction);
-    bool FnSetValue(int value);
-    int FnGetValue() const;
+    bool FnSetDirection(const std::string& direction) override;
+    bool FnSetEdge(const std::string& edge) override;
+    bool FnSetValue(int value) override;
+    int FnGetValue() const override;
+    int FnGetValueFd() const override;
+    short FnGetPollEvents() const override;
+    bool FnIsEdgeEnabled() const override;
+    std::chrono::steady_clock::time_point FnAcknowledgeEdge() override;
+    int FnGetPinNumber() const override;
     std::string FnGetGPIOPath() const;
 
 private:
     int pinNumber_;
     std::string gpioPath_;
+    int valueFd_;
+    bool edgeEnabled_;
     mutable std::mutex gpioMutex_;
 
     bool FnExportGPIO();
     bool FnUnexportGPIO();
+    bool openValueFd();
+};
+
+
+// GPIO character device (/dev/gpiochipN), edges are queued by the kernel with their own timestamp
+class ChardevGPIO : public GPIOPin
+{
+
+public:
+    ChardevGPIO(int pinNumber);
+    ~ChardevGPIO();
+    bool FnSetDirection(const std::string& direction) override;
+    bool FnSetEdge(const std::string& edge) override;
+    bool FnSetValue(int value) override;
+    int FnGetValue() const override;
+    int FnGetValueFd() const override;
+    short FnGetPollEvents() const override;
+    bool FnIsEdgeEnabled() const override;
+    std::chrono::steady_clock::time_point FnAcknowledgeEdge() override;
+    int FnGetPinNumber() const override;
+
+private:
+    int pinNumber_;
+    std::string chipPath_;
+    unsigned int lineOffset_;
+    int lineFd_;
+    bool edgeEnabled_;
+    mutable std::mutex gpioMutex_;
+
+    bool resolveLine();
+    bool requestLine(bool isOutput, bool isEdge);
+    void releaseLine();
+    static std::chrono::steady_clock::time_point toSteadyClock(uint64_t timestampNs);
 };
 
 
@@ -35,6 +99,10 @@ class GPIOManager
 public:
     const std::string GPIO_OUT             = "out";
     const std::string GPIO_IN              = "in";
+    const std::string GPIO_EDGE_BOTH       = "both";
+    static constexpr const char* GPIO_BACKEND_SYSFS     = "sysfs";
+    static constexpr const char* GPIO_BACKEND_CHARDEV   = "chardev";
+    static constexpr const char* GPIO_BACKEND_SIMULATOR = "simulator";
     static const int GPIO_HIGH             = 1;
     static const int GPIO_LOW              = 0;
 
@@ -73,8 +141,9 @@ public:
     static const int PIN_DI16              = 421;   // J2 010
 
     static GPIOManager* getInstance();
-    bool FnGPIOInit();
-    SysfsGPIO* FnGetGPIO(int pinNumber);
+    bool FnGPIOInit(const std::string& backend = GPIO_BACKEND_SYSFS);
+    GPIOPin* FnGetGPIO(int pinNumber);
+    std::string FnGetBackend() const;
 
     /**
      * Singleton GPIOManager should not be cloneable.
@@ -87,10 +156,12 @@ public:
     void operator=(const GPIOManager &) = delete;
 
 private:
-    static GPIOManager* GPIOManager_;
+    static std::atomic<GPIOManager*> GPIOManager_;
     static std::mutex mutex_;
-    std::unordered_map<int, std::unique_ptr<SysfsGPIO>> gpioPins_;
+    std::unordered_map<int, std::unique_ptr<GPIOPin>> gpioPins_;
+    std::string backend_;
     GPIOManager();
     ~GPIOManager();
+    std::unique_ptr<GPIOPin> createPin(int pinNumber);
     bool FnInitSetGPIODirection(int pinNumber, const std::string& dir);
 };
\ No newline at end of file
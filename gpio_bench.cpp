@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "boost/asio.hpp"
+#include "dio_sequencer.h"
+#include "event_handler.h"
+#include "event_manager.h"
+#include "gpio.h"
+#include "gpio_simulator.h"
+#include "ini_parser.h"
+#include "io_executor.h"
+#include "log.h"
+#include "operation.h"
+#include "shutdown_manager.h"
+
+// Drives the first lane with scripted vehicles through the GPIO simulator, DIO and operation, then reports
+// the output writes (open and close barrier, ...) and how long after the last edge they came:
+//   pbs_gpio_bench [vehicles per minute] [vehicles]
+// Reads LinuxPBS.ini like linuxpbs, which must select GPIOBackend=simulator. A GPIOSimulatorScript there
+// replaces the generated vehicles.
+
+namespace
+{
+    // Loop A on, Loop B on, Loop A off, Loop B off per vehicle, evenly spaced
+    std::vector<GPIOSimulator::SimulatedEdge> buildVehicleScript(int vehiclesPerMinute, int vehicles)
+    {
+        int loopAPin = GPIOSimulator::FnParsePinName("DI" + std::to_string(IniParser::getInstance()->FnGetLoopA()));
+        int loopBPin = GPIOSimulator::FnParsePinName("DI" + std::to_string(IniParser::getInstance()->FnGetLoopB()));
+        int gapMs = std::max(4, 60000 / vehiclesPerMinute);
+        int stepMs = std::max(1, gapMs / 5);
+
+        std::vector<GPIOSimulator::SimulatedEdge> script;
+        for (int vehicle = 0; vehicle < vehicles; vehicle++)
+        {
+            script.push_back(GPIOSimulator::SimulatedEdge{ gapMs - (3 * stepMs), loopAPin, 1 });
+            script.push_back(GPIOSimulator::SimulatedEdge{ stepMs, loopBPin, 1 });
+            script.push_back(GPIOSimulator::SimulatedEdge{ stepMs, loopAPin, 0 });
+            script.push_back(GPIOSimulator::SimulatedEdge{ stepMs, loopBPin, 0 });
+        }
+        return script;
+    }
+
+    bool waitFor(const std::function<bool()>& condition, std::chrono::steady_clock::duration timeout)
+    {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!condition())
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+            {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        return true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    int vehiclesPerMinute = (argc > 1) ? std::atoi(argv[1]) : 1000;
+    int vehicles = (argc > 2) ? std::atoi(argv[2]) : 1000;
+    if ((vehiclesPerMinute <= 0) || (vehicles <= 0))
+    {
+        std::cerr << "Usage: " << argv[0] << " [vehicles per minute] [vehicles]" << std::endl;
+        return 1;
+    }
+
+    boost::asio::io_context& ioContext = IOExecutor::getInstance()->FnGetIOContext();
+    auto workGuard = boost::asio::make_work_guard(ioContext);
+    ShutdownManager::getInstance()->set(&ioContext, &workGuard);
+
+    IniParser::getInstance()->FnReadIniFile();
+    Logger::getInstance()->FnCreateLogFile();
+
+    if (IniParser::getInstance()->FnGetGPIOBackend() != GPIOManager::GPIO_BACKEND_SIMULATOR)
+    {
+        std::cerr << "LinuxPBS.ini must set GPIOBackend=" << GPIOManager::GPIO_BACKEND_SIMULATOR << std::endl;
+        return 1;
+    }
+
+    // DIO starts the script once its monitoring thread is up
+    GPIOSimulator::getInstance()->FnSetScript(buildVehicleScript(vehiclesPerMinute, vehicles), 1);
+
+    EventHandler::getInstance()->FnRegisterEvents();
+    EventManager::getInstance()->FnStartEventThread();
+    IOExecutor::getInstance()->FnStartBlockingThreads(IniParser::getInstance()->FnGetDBWorkerThreads(), IniParser::getInstance()->FnGetDBThreadCPUs());
+    operation::getInstance()->OperationInit(ioContext);
+
+    std::thread ioThread([]()
+    {
+        IOExecutor::getInstance()->FnRunIOThreads(IniParser::getInstance()->FnGetIOThreads(), IniParser::getInstance()->FnGetIOThreadCPUs());
+    });
+
+    GPIOSimulator* simulator = GPIOSimulator::getInstance();
+    bool isStarted = waitFor([simulator]() { return simulator->FnIsScriptRunning() || (simulator->FnGetInjectedEdgeCount() > 0); }, std::chrono::seconds(120));
+    auto startTime = std::chrono::steady_clock::now();
+    bool isFinished = isStarted && waitFor([simulator]() { return !simulator->FnIsScriptRunning(); }, std::chrono::minutes(1 + (vehicles / vehiclesPerMinute) * 2));
+    auto scriptMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+
+    // The last vehicles' events and flows finish before the report
+    waitFor([]() { return EventManager::getInstance()->FnGetEventQueueStats(EventPriority::SAFETY).depth == 0; }, std::chrono::seconds(30));
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+
+    if (!isStarted)
+    {
+        std::cerr << "The lane never started DIO monitoring, see the boot log." << std::endl;
+    }
+    else
+    {
+        std::cout << (isFinished ? "Script finished" : "Script timed out") << " after " << scriptMs << " ms, "
+            << vehicles << " vehicles at " << vehiclesPerMinute << " per minute requested" << std::endl;
+        std::cout << simulator->FnLogOutputReport() << std::endl;
+        EventManager::getInstance()->FnLogEventQueueStats();
+    }
+
+    simulator->FnStopScript();
+    workGuard.reset();
+    ioContext.stop();
+    ioThread.join();
+    EventManager::getInstance()->FnStopEventThread();
+    DIOSequencer::getInstance()->FnStopSequencer();
+    IOExecutor::getInstance()->FnStopBlockingThreads();
+
+    return (isStarted && isFinished) ? 0 : 1;
+}
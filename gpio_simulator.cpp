@@ -0,0 +1,428 @@
+#include <algorithm>
+#include <fstream>
+#include <poll.h>
+#include <sstream>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include "gpio_simulator.h"
+#include "io_executor.h"
+#include "log.h"
+
+// Simulated GPIO Code
+SimulatedGPIO::SimulatedGPIO(int pinNumber)
+    : pinNumber_(pinNumber),
+    isOutput_(false),
+    edgeEnabled_(false),
+    eventFd_(-1),
+    value_(0),
+    hasPendingEdge_(false)
+{
+    eventFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+}
+
+SimulatedGPIO::~SimulatedGPIO()
+{
+    if (eventFd_ >= 0)
+    {
+        close(eventFd_);
+        eventFd_ = -1;
+    }
+}
+
+bool SimulatedGPIO::FnSetDirection(const std::string& direction)
+{
+    isOutput_ = (direction == "out");
+    return true;
+}
+
+bool SimulatedGPIO::FnSetEdge(const std::string& edge)
+{
+    edgeEnabled_ = ((edge != "none") && (eventFd_ >= 0));
+    return edgeEnabled_;
+}
+
+bool SimulatedGPIO::FnSetValue(int value)
+{
+    value_.store((value != 0) ? 1 : 0);
+
+    if (isOutput_)
+    {
+        GPIOSimulator::getInstance()->FnRecordOutput(pinNumber_, value_.load());
+    }
+
+    return true;
+}
+
+int SimulatedGPIO::FnGetValue() const
+{
+    return value_.load();
+}
+
+int SimulatedGPIO::FnGetValueFd() const
+{
+    return eventFd_;
+}
+
+short SimulatedGPIO::FnGetPollEvents() const
+{
+    return POLLIN;
+}
+
+bool SimulatedGPIO::FnIsEdgeEnabled() const
+{
+    return edgeEnabled_;
+}
+
+std::chrono::steady_clock::time_point SimulatedGPIO::FnAcknowledgeEdge()
+{
+    std::lock_guard<std::mutex> lock(edgeMutex_);
+
+    uint64_t count = 0;
+    if (eventFd_ >= 0)
+    {
+        read(eventFd_, &count, sizeof(count));
+    }
+
+    std::chrono::steady_clock::time_point timestamp = hasPendingEdge_ ? pendingEdgeTime_ : std::chrono::steady_clock::now();
+    hasPendingEdge_ = false;
+
+    return timestamp;
+}
+
+int SimulatedGPIO::FnGetPinNumber() const
+{
+    return pinNumber_;
+}
+
+bool SimulatedGPIO::FnInjectValue(int value, std::chrono::steady_clock::time_point timestamp)
+{
+    int newValue = (value != 0) ? 1 : 0;
+    if (value_.exchange(newValue) == newValue)
+    {
+        return false;
+    }
+
+    if (edgeEnabled_)
+    {
+        std::lock_guard<std::mutex> lock(edgeMutex_);
+
+        // Keep the earliest unacknowledged edge, same as the chardev backend
+        if (!hasPendingEdge_)
+        {
+            pendingEdgeTime_ = timestamp;
+            hasPendingEdge_ = true;
+        }
+
+        uint64_t one = 1;
+        write(eventFd_, &one, sizeof(one));
+    }
+
+    return true;
+}
+
+
+// GPIO Simulator Code
+std::atomic<GPIOSimulator*> GPIOSimulator::gpioSimulator_(nullptr);
+std::mutex GPIOSimulator::mutex_;
+
+GPIOSimulator::GPIOSimulator()
+    : repeatCount_(1),
+    isScriptRunning_(false),
+    hasInjected_(false),
+    injectedEdgeCount_(0),
+    outputWriteCount_(0)
+{
+
+}
+
+GPIOSimulator* GPIOSimulator::getInstance()
+{
+    return LazyInstance::FnGet(gpioSimulator_, mutex_, []() { return new GPIOSimulator(); });
+}
+
+int GPIOSimulator::FnParsePinName(const std::string& pinName)
+{
+    static const int inputPins[] = {
+        GPIOManager::PIN_DI1, GPIOManager::PIN_DI2, GPIOManager::PIN_DI3, GPIOManager::PIN_DI4,
+        GPIOManager::PIN_DI5, GPIOManager::PIN_DI6, GPIOManager::PIN_DI7, GPIOManager::PIN_DI8,
+        GPIOManager::PIN_DI9, GPIOManager::PIN_DI10, GPIOManager::PIN_DI11, GPIOManager::PIN_DI12,
+        GPIOManager::PIN_DI13, GPIOManager::PIN_DI14, GPIOManager::PIN_DI15, GPIOManager::PIN_DI16
+    };
+
+    static const int outputPins[] = {
+        GPIOManager::PIN_DO1, GPIOManager::PIN_DO2, GPIOManager::PIN_DO3, GPIOManager::PIN_DO4,
+        GPIOManager::PIN_DO5, GPIOManager::PIN_DO6, GPIOManager::PIN_DO7, GPIOManager::PIN_DO8,
+        GPIOManager::PIN_DO9
+    };
+
+    try
+    {
+        if ((pinName.size() > 2) && (pinName.compare(0, 2, "DI") == 0))
+        {
+            int index = std::stoi(pinName.substr(2));
+            return ((index >= 1) && (index <= 16)) ? inputPins[index - 1] : -1;
+        }
+        else if ((pinName.size() > 2) && (pinName.compare(0, 2, "DO") == 0))
+        {
+            int index = std::stoi(pinName.substr(2));
+            return ((index >= 1) && (index <= 9)) ? outputPins[index - 1] : -1;
+        }
+
+        return std::stoi(pinName);
+    }
+    catch (...)
+    {
+        return -1;
+    }
+}
+
+bool GPIOSimulator::FnLoadScript(const std::string& filePath)
+{
+    // Script format, one step per line:
+    //   repeat <count>              (0 repeats forever)
+    //   <delay_ms> <DIn|DOn|pin> <0|1>
+    std::ifstream scriptFile(filePath);
+    if (!scriptFile.is_open())
+    {
+        Logger::getInstance()->FnLog("Failed to open GPIO simulator script: " + filePath);
+        return false;
+    }
+
+    std::vector<SimulatedEdge> script;
+    int repeatCount = 1;
+    std::string line;
+    int lineNo = 0;
+
+    while (std::getline(scriptFile, line))
+    {
+        lineNo++;
+
+        std::size_t commentPos = line.find('#');
+        if (commentPos != std::string::npos)
+        {
+            line.erase(commentPos);
+        }
+
+        std::istringstream iss(line);
+        std::string first;
+        if (!(iss >> first))
+        {
+            continue;
+        }
+
+        if (first == "repeat")
+        {
+            if (!(iss >> repeatCount) || (repeatCount < 0))
+            {
+                Logger::getInstance()->FnLog("Invalid repeat count in GPIO simulator script line " + std::to_string(lineNo));
+                return false;
+            }
+            continue;
+        }
+
+        SimulatedEdge edge;
+        std::string pinName;
+        try
+        {
+            edge.delayMs = std::stoi(first);
+        }
+        catch (...)
+        {
+            edge.delayMs = -1;
+        }
+
+        if ((edge.delayMs < 0) || !(iss >> pinName >> edge.value) || ((edge.pinNumber = FnParsePinName(pinName)) < 0))
+        {
+            Logger::getInstance()->FnLog("Invalid GPIO simulator script line " + std::to_string(lineNo) + ": " + line);
+            return false;
+        }
+
+        script.push_back(edge);
+    }
+
+    FnSetScript(script, repeatCount);
+
+    std::stringstream ss;
+    ss << "GPIO simulator script loaded: " << filePath << ", steps: " << script.size() << ", repeat: " << repeatCount;
+    Logger::getInstance()->FnLog(ss.str());
+
+    return true;
+}
+
+void GPIOSimulator::FnSetScript(const std::vector<SimulatedEdge>& script, int repeatCount)
+{
+    std::lock_guard<std::mutex> lock(scriptMutex_);
+    script_ = script;
+    repeatCount_ = repeatCount;
+}
+
+bool GPIOSimulator::FnStartScript()
+{
+    {
+        std::lock_guard<std::mutex> lock(scriptMutex_);
+        if (script_.empty())
+        {
+            return false;
+        }
+    }
+
+    FnStopScript();
+
+    isScriptRunning_.store(true);
+    scriptThread_ = std::thread(&GPIOSimulator::scriptThreadFunction, this);
+
+    return true;
+}
+
+void GPIOSimulator::FnStopScript()
+{
+    isScriptRunning_.store(false);
+
+    if (scriptThread_.joinable())
+    {
+        scriptThread_.join();
+    }
+}
+
+bool GPIOSimulator::FnIsScriptRunning() const
+{
+    return isScriptRunning_.load();
+}
+
+void GPIOSimulator::scriptThreadFunction()
+{
+    IOExecutor::FnNameCurrentThread("pbs-gpio-sim");
+
+    std::vector<SimulatedEdge> script;
+    int repeatCount;
+    {
+        std::lock_guard<std::mutex> lock(scriptMutex_);
+        script = script_;
+        repeatCount = repeatCount_;
+    }
+
+    // Steps are scheduled against an absolute deadline so sleep overshoot does not accumulate
+    auto deadline = std::chrono::steady_clock::now();
+
+    for (int iteration = 0; isScriptRunning_.load() && ((repeatCount == 0) || (iteration < repeatCount)); iteration++)
+    {
+        for (const auto& edge : script)
+        {
+            deadline += std::chrono::milliseconds(edge.delayMs);
+
+            // Sleep in short slices so FnStopScript() does not wait for a long delay
+            while (isScriptRunning_.load() && (std::chrono::steady_clock::now() < deadline))
+            {
+                std::this_thread::sleep_until(std::min(deadline, std::chrono::steady_clock::now() + std::chrono::milliseconds(100)));
+            }
+
+            if (!isScriptRunning_.load())
+            {
+                break;
+            }
+
+            FnInjectEdge(edge.pinNumber, edge.value);
+        }
+    }
+
+    isScriptRunning_.store(false);
+    Logger::getInstance()->FnLog("GPIO simulator script finished, injected edges: " + std::to_string(injectedEdgeCount_.load()));
+    FnLogOutputReport();
+}
+
+bool GPIOSimulator::FnInjectEdge(int pinNumber, int value)
+{
+    SimulatedGPIO* gpio = dynamic_cast<SimulatedGPIO*>(GPIOManager::getInstance()->FnGetGPIO(pinNumber));
+    if (gpio == nullptr)
+    {
+        return false;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (gpio->FnInjectValue(value, now))
+    {
+        injectedEdgeCount_.fetch_add(1);
+
+        std::lock_guard<std::mutex> lock(outputMutex_);
+        lastInjectTime_ = now;
+        hasInjected_ = true;
+    }
+
+    return true;
+}
+
+void GPIOSimulator::FnRecordOutput(int pinNumber, int value)
+{
+    outputWriteCount_.fetch_add(1);
+
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(outputMutex_);
+    int64_t reactionUs = hasInjected_ ? std::chrono::duration_cast<std::chrono::microseconds>(now - lastInjectTime_).count() : -1;
+    if (outputWrites_.size() < MAX_OUTPUT_WRITES)
+    {
+        outputWrites_.push_back(OutputWrite{ pinNumber, value, now, reactionUs });
+    }
+
+    // Totals keep counting once the write records are full
+    OutputReport& totals = outputTotals_.emplace(pinNumber, OutputReport{ pinNumber, 0, 0, 0, 0 }).first->second;
+    totals.writes++;
+    totals.highs += (value != 0) ? 1 : 0;
+    if (reactionUs >= 0)
+    {
+        totalReactionUs_[pinNumber] += static_cast<uint64_t>(reactionUs);
+        totals.maxReactionUs = std::max(totals.maxReactionUs, static_cast<uint64_t>(reactionUs));
+    }
+}
+
+std::vector<GPIOSimulator::OutputWrite> GPIOSimulator::FnGetOutputWrites()
+{
+    std::lock_guard<std::mutex> lock(outputMutex_);
+    return outputWrites_;
+}
+
+void GPIOSimulator::FnClearOutputWrites()
+{
+    std::lock_guard<std::mutex> lock(outputMutex_);
+    outputWrites_.clear();
+    outputTotals_.clear();
+    totalReactionUs_.clear();
+}
+
+uint64_t GPIOSimulator::FnGetInjectedEdgeCount() const
+{
+    return injectedEdgeCount_.load();
+}
+
+uint64_t GPIOSimulator::FnGetOutputWriteCount() const
+{
+    return outputWriteCount_.load();
+}
+
+std::vector<GPIOSimulator::OutputReport> GPIOSimulator::FnGetOutputReport()
+{
+    std::lock_guard<std::mutex> lock(outputMutex_);
+
+    std::vector<OutputReport> report;
+    for (const auto& totals : outputTotals_)
+    {
+        OutputReport pinReport = totals.second;
+        pinReport.avgReactionUs = (pinReport.writes > 0) ? (totalReactionUs_[totals.first] / pinReport.writes) : 0;
+        report.push_back(pinReport);
+    }
+    return report;
+}
+
+std::string GPIOSimulator::FnLogOutputReport()
+{
+    std::stringstream ss;
+    ss << "GPIO simulator outputs => injected edges: " << FnGetInjectedEdgeCount() << ", output writes: " << FnGetOutputWriteCount();
+    for (const auto& pinReport : FnGetOutputReport())
+    {
+        ss << std::endl << "  pin " << pinReport.pinNumber;
+        ss << ": writes " << pinReport.writes << " (high " << pinReport.highs << ", low " << (pinReport.writes - pinReport.highs) << ")";
+        ss << ", after last edge avg " << pinReport.avgReactionUs << "us, max " << pinReport.maxReactionUs << "us";
+    }
+
+    Logger::getInstance()->FnLog(ss.str());
+    return ss.str();
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gpio.h"
+#include "lazy_instance.h"
+
+// In-memory GPIO pin, inputs are driven by GPIOSimulator and signal edges through an eventfd
+class SimulatedGPIO : public GPIOPin
+{
+
+public:
+    SimulatedGPIO(int pinNumber);
+    ~SimulatedGPIO();
+    bool FnSetDirection(const std::string& direction) override;
+    bool FnSetEdge(const std::string& edge) override;
+    bool FnSetValue(int value) override;
+    int FnGetValue() const override;
+    int FnGetValueFd() const override;
+    short FnGetPollEvents() const override;
+    bool FnIsEdgeEnabled() const override;
+    std::chrono::steady_clock::time_point FnAcknowledgeEdge() override;
+    int FnGetPinNumber() const override;
+    bool FnInjectValue(int value, std::chrono::steady_clock::time_point timestamp);
+
+private:
+    int pinNumber_;
+    bool isOutput_;
+    bool edgeEnabled_;
+    int eventFd_;
+    std::atomic<int> value_;
+    std::mutex edgeMutex_;
+    bool hasPendingEdge_;
+    std::chrono::steady_clock::time_point pendingEdgeTime_;
+};
+
+
+class GPIOSimulator
+{
+
+public:
+    // One scripted step, delayMs is relative to the previous step
+    struct SimulatedEdge
+    {
+        int delayMs;
+        int pinNumber;
+        int value;
+    };
+
+    struct OutputWrite
+    {
+        int pinNumber;
+        int value;
+        std::chrono::steady_clock::time_point timestamp;
+        int64_t reactionUs;         // since the last injected edge, -1 before the first one
+    };
+
+    // Per output pin, over every write since start up or FnClearOutputWrites()
+    struct OutputReport
+    {
+        int pinNumber;
+        uint64_t writes;
+        uint64_t highs;
+        uint64_t avgReactionUs;
+        uint64_t maxReactionUs;
+    };
+
+    static const std::size_t MAX_OUTPUT_WRITES = 100000;
+
+    static GPIOSimulator* getInstance();
+    bool FnLoadScript(const std::string& filePath);
+    void FnSetScript(const std::vector<SimulatedEdge>& script, int repeatCount);
+    bool FnStartScript();
+    void FnStopScript();
+    bool FnIsScriptRunning() const;
+    bool FnInjectEdge(int pinNumber, int value);
+    void FnRecordOutput(int pinNumber, int value);
+    std::vector<OutputWrite> FnGetOutputWrites();
+    void FnClearOutputWrites();
+    uint64_t FnGetInjectedEdgeCount() const;
+    uint64_t FnGetOutputWriteCount() const;
+    std::vector<OutputReport> FnGetOutputReport();
+    // Injected edges and the outputs they led to, e.g. open and close barrier, to the log and returned
+    std::string FnLogOutputReport();
+    // DIn, DOn or a board pin number, -1 if unknown
+    static int FnParsePinName(const std::string& pinName);
+
+    /**
+     * Singleton GPIOSimulator should not be cloneable.
+     */
+    GPIOSimulator(GPIOSimulator& gpioSimulator) = delete;
+
+    /**
+     * Singleton GPIOSimulator should not be assignable.
+     */
+    void operator=(const GPIOSimulator&) = delete;
+
+private:
+    static std::atomic<GPIOSimulator*> gpioSimulator_;
+    static std::mutex mutex_;
+    std::mutex scriptMutex_;
+    std::vector<SimulatedEdge> script_;
+    int repeatCount_;
+    std::atomic<bool> isScriptRunning_;
+    std::thread scriptThread_;
+    std::mutex outputMutex_;
+    std::vector<OutputWrite> outputWrites_;
+    std::map<int, OutputReport> outputTotals_;
+    std::map<int, uint64_t> totalReactionUs_;
+    std::chrono::steady_clock::time_point lastInjectTime_;
+    bool hasInjected_;
+    std::atomic<uint64_t> injectedEdgeCount_;
+    std::atomic<uint64_t> outputWriteCount_;
+    GPIOSimulator();
+    void scriptThreadFunction();
+};
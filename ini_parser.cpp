@@ -1,32 +1,219 @@
+#include <sys/inotify.h>
+#include <unistd.h>
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <boost/algorithm/string.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/ini_parser.hpp>
 #include "ini_parser.h"
 #include "log.h"
+#include "operation.h"
 
-IniParser* IniParser::iniParser_;
+std::array<std::atomic<IniParser*>, LaneContext::MAX_LANES> IniParser::iniParsers_ = {};
 std::mutex IniParser::mutex_;
 
-IniParser::IniParser()
+namespace
 {
+    // Typed reads of the merged ini tree, every bad value is added to errors and leaves the default
+    class IniReader
+    {
+    public:
+        IniReader(const boost::property_tree::ptree& pt, std::vector<std::string>& errors)
+            : pt_(pt), errors_(errors)
+        {
+        }
+
+        void text(const std::string& key, std::string& value) const
+        {
+            value = pt_.get<std::string>(key, value);
+        }
+
+        void number(const std::string& key, int& value, bool isRequired = false, int minValue = 0, int maxValue = 1000000) const
+        {
+            std::string raw = boost::algorithm::trim_copy(pt_.get<std::string>(key, ""));
+            if (raw.empty())
+            {
+                if (isRequired)
+                {
+                    errors_.push_back(key + " is missing");
+                }
+                return;
+            }
+
+            try
+            {
+                size_t pos = 0;
+                int result = std::stoi(raw, &pos);
+                if (pos != raw.size())
+                {
+                    errors_.push_back(key + " is not a number: " + raw);
+                }
+                else if ((result < minValue) || (result > maxValue))
+                {
+                    errors_.push_back(key + " is out of range: " + raw);
+                }
+                else
+                {
+                    value = result;
+                }
+            }
+            catch (const std::exception&)
+            {
+                errors_.push_back(key + " is not a number: " + raw);
+            }
+        }
+
+        void decimal(const std::string& key, float& value) const
+        {
+            std::string raw = boost::algorithm::trim_copy(pt_.get<std::string>(key, ""));
+            if (raw.empty())
+            {
+                return;
+            }
 
+            try
+            {
+                size_t pos = 0;
+                float result = std::stof(raw, &pos);
+                if (pos != raw.size())
+                {
+                    errors_.push_back(key + " is not a number: " + raw);
+                }
+                else
+                {
+                    value = result;
+                }
+            }
+            catch (const std::exception&)
+            {
+                errors_.push_back(key + " is not a number: " + raw);
+            }
+        }
+
+        void flag(const std::string& key, bool& value) const
+        {
+            int result = value ? 1 : 0;
+            number(key, result, true);
+            value = (result == 1);
+        }
+
+    private:
+        const boost::property_tree::ptree& pt_;
+        std::vector<std::string>& errors_;
+    };
+
+    // Keys that are only read while a lane starts, a reload logs them but they apply after a restart
+    bool isRestartKey(const std::string& key)
+    {
+        static const char* liveKeys[] = {
+            "setting.SeasonOnly", "setting.NotAllowHourly", "setting.ShowTime", "setting.BlockIUPrefix",
+            "setting.WholeLpnMatchRateThreshold", "setting.DigitLpnMatchRateThreshold", "setting.LpnTimeout",
+            "setting.CentralUsername", "setting.CentralPassword",
+            "setting.MonitorStatusIntervalMs", "setting.MonitorKeyframeSec"
+        };
+
+        for (const char* liveKey : liveKeys)
+        {
+            if (key == liveKey)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const uint32_t INOTIFY_MASK = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE;
+    const int RELOAD_SETTLE_MS = 500;
+
+    // The controller has one ini folder, so one watch serves every lane
+    struct IniWatch
+    {
+        std::unique_ptr<boost::asio::posix::stream_descriptor> descriptor;
+        std::unique_ptr<boost::asio::steady_timer> settleTimer;
+        std::array<char, 4096> buffer;
+    };
+    IniWatch iniWatch;
+
+    void reloadAllLanes()
+    {
+        for (int laneId = 0; laneId < LaneContext::FnGetLaneCount(); laneId++)
+        {
+            LaneContext::Scope laneScope(laneId, false);
+            IniParser::getInstance()->FnReloadIniFile();
+        }
+    }
+
+    void readIniEvents()
+    {
+        iniWatch.descriptor->async_read_some(boost::asio::buffer(iniWatch.buffer), [](const boost::system::error_code& ec, std::size_t length)
+        {
+            if (ec)
+            {
+                if (ec != boost::asio::error::operation_aborted)
+                {
+                    Logger::getInstance()->FnLogExceptionError("Ini watch stopped: " + ec.message());
+                }
+                return;
+            }
+
+            bool isIniChanged = false;
+            size_t offset = 0;
+            while ((offset + sizeof(inotify_event)) <= length)
+            {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(iniWatch.buffer.data() + offset);
+                std::string name = (event->len > 0) ? std::string(event->name) : "";
+                if (boost::algorithm::ends_with(name, ".ini"))
+                {
+                    isIniChanged = true;
+                }
+                offset += sizeof(inotify_event) + event->len;
+            }
+
+            // An editor writes a file in several steps, the reload waits until they settle
+            if (isIniChanged)
+            {
+                iniWatch.settleTimer->expires_after(std::chrono::milliseconds(RELOAD_SETTLE_MS));
+                iniWatch.settleTimer->async_wait([](const boost::system::error_code& timerEc)
+                {
+                    if (!timerEc)
+                    {
+                        reloadAllLanes();
+                    }
+                });
+            }
+
+            readIniEvents();
+        });
+    }
+}
+
+IniParser::IniParser()
+    : config_(nullptr)
+{
+    publish(std::unique_ptr<const IniConfig>(new IniConfig()));
 }
 
 IniParser* IniParser::getInstance()
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (iniParser_ == nullptr)
-    {
-        iniParser_ = new IniParser();
-    }
-    return iniParser_;
+    return LazyInstance::FnGet(iniParsers_[LaneContext::FnGetCurrentLane()], mutex_, []() { return new IniParser(); });
 }
 
-void IniParser::FnReadIniFile()
+const IniConfig* IniParser::FnGetConfig() const
 {
+    return config_.load(std::memory_order_acquire);
+}
+
+void IniParser::publish(std::unique_ptr<const IniConfig> config)
+{
+    std::lock_guard<std::mutex> lock(configMutex_);
+    config_.store(config.get(), std::memory_order_release);
+    configs_.push_back(std::move(config));
+}
 
+bool IniParser::readConfig(IniConfig& config, std::vector<std::string>& errors) const
+{
     // Create local INI folder
     try
     {
@@ -43,56 +230,118 @@ void IniParser::FnReadIniFile()
         if (!boost::filesystem::exists(INI_FILE))
         {
             Logger::getInstance()->FnLogExceptionError("INI file not found: " + INI_FILE);
-            return; // or throw if you prefer
+            return false;
         }
 
         boost::property_tree::ptree pt;
         boost::property_tree::ini_parser::read_ini(INI_FILE, pt);
 
-        // Temp: Revisit and implement storing to private variable function
-        StationID_                      = pt.get<std::string>("setting.StationID", "");
-        LogFolder_                      = pt.get<std::string>("setting.LogFolder", "");
-        LocalDB_                        = pt.get<std::string>("setting.LocalDB", "");
-        CentralDBName_                  = pt.get<std::string>("setting.CentralDBName", "");
-        CentralDBServer_                = pt.get<std::string>("setting.CentralDBServer", "");
-        CentralUsername_                = pt.get<std::string>("setting.CentralUsername", "");
-        CentralPassword_                = pt.get<std::string>("setting.CentralPassword", "");
-        LocalUDPPort_                   = pt.get<std::string>("setting.LocalUDPPort", "");
-        RemoteUDPPort_                  = pt.get<std::string>("setting.RemoteUDPPort", "");
-        SeasonOnly_                     = pt.get<std::string>("setting.SeasonOnly", "");
-        NotAllowHourly_                 = pt.get<std::string>("setting.NotAllowHourly", "");
-        LPRIP4Front_                    = pt.get<std::string>("setting.LPRIP4Front", "");
-        LPRIP4Rear_                     = pt.get<std::string>("setting.LPRIP4Rear", "");
-        LPRPort_                        = pt.get<std::string>("setting.LPRPort", "");
-        WaitLPRNoTime_                  = pt.get<std::string>("setting.WaitLPRNoTime", "");
-        LPRErrorTime_                   = pt.get<std::string>("setting.LPRErrorTime", "");
-        LPRErrorCount_                  = pt.get<std::string>("setting.LPRErrorCount", "");
-        ShowTime_                       = (std::stoi(pt.get<std::string>("setting.ShowTime", "")) == 1) ? true : false;
-        BlockIUPrefix_                  = pt.get<std::string>("setting.BlockIUPrefix", "");
-        TnGRemoteServerHost_            = pt.get<std::string>("setting.TnGRemoteServerHost", "");
-        TnGRemoteServerPort_            = pt.get<std::string>("setting.TnGRemoteServerPort", "");
-        TnGListenHost_                  = pt.get<std::string>("setting.TnGListenHost", "");
-        TnGListenPort_                  = pt.get<std::string>("setting.TnGListenPort", "");
-        WholeLpnMatchRateThreshold_     = pt.get<int>("setting.WholeLpnMatchRateThreshold");
-        DigitLpnMatchRateThreshold_     = pt.get<int>("setting.DigitLpnMatchRateThreshold");
-        LpnTimeout_                     = pt.get<int>("setting.LpnTimeout");
+        // A further lane only lists what differs from the first: station ID, ports, devices and DIO pins
+        int laneId = LaneContext::FnGetCurrentLane();
+        if (laneId != LaneContext::DEFAULT_LANE)
+        {
+            std::string laneIniFile = FnGetLaneIniFile(laneId);
+            if (boost::filesystem::exists(laneIniFile))
+            {
+                boost::property_tree::ptree lanePt;
+                boost::property_tree::ini_parser::read_ini(laneIniFile, lanePt);
+                for (const auto& section : lanePt)
+                {
+                    for (const auto& key : section.second)
+                    {
+                        pt.put(section.first + "." + key.first, key.second.data());
+                    }
+                }
+            }
+            else
+            {
+                Logger::getInstance()->FnLogExceptionError("Lane INI file not found: " + laneIniFile);
+            }
+        }
+
+        for (const auto& section : pt)
+        {
+            for (const auto& key : section.second)
+            {
+                config.Values[section.first + "." + key.first] = key.second.data();
+            }
+        }
+
+        IniReader reader(pt, errors);
+        reader.text("setting.StationID", config.StationID);
+        reader.text("setting.LogFolder", config.LogFolder);
+        reader.text("setting.LocalDB", config.LocalDB);
+        reader.text("setting.CentralDBName", config.CentralDBName);
+        reader.text("setting.CentralDBServer", config.CentralDBServer);
+        reader.text("setting.CentralUsername", config.CentralUsername);
+        reader.text("setting.CentralPassword", config.CentralPassword);
+        reader.number("setting.LocalUDPPort", config.LocalUDPPort, true, 1, 65535);
+        reader.number("setting.RemoteUDPPort", config.RemoteUDPPort, true, 1, 65535);
+        reader.number("setting.SeasonOnly", config.SeasonOnly);
+        reader.number("setting.NotAllowHourly", config.NotAllowHourly);
+        reader.text("setting.LPRIP4Front", config.LPRIP4Front);
+        reader.text("setting.LPRIP4Rear", config.LPRIP4Rear);
+        reader.number("setting.LPRPort", config.LPRPort, false, 0, 65535);
+        reader.decimal("setting.WaitLPRNoTime", config.WaitLPRNoTime);
+        reader.number("setting.LPRErrorTime", config.LPRErrorTime);
+        reader.number("setting.LPRErrorCount", config.LPRErrorCount);
+        reader.flag("setting.ShowTime", config.ShowTime);
+        reader.text("setting.BlockIUPrefix", config.BlockIUPrefix);
+        reader.text("setting.TnGRemoteServerHost", config.TnGRemoteServerHost);
+        reader.text("setting.TnGRemoteServerPort", config.TnGRemoteServerPort);
+        reader.text("setting.TnGListenHost", config.TnGListenHost);
+        reader.text("setting.TnGListenPort", config.TnGListenPort);
+        reader.number("setting.WholeLpnMatchRateThreshold", config.WholeLpnMatchRateThreshold, true, 0, 100);
+        reader.number("setting.DigitLpnMatchRateThreshold", config.DigitLpnMatchRateThreshold, true, 0, 100);
+        reader.number("setting.LpnTimeout", config.LpnTimeout, true);
+        reader.number("setting.LogQueryListenPort", config.LogQueryListenPort, false, 1, 65535);
+        reader.text("setting.GPIOBackend", config.GPIOBackend);
+        reader.text("setting.GPIOSimulatorScript", config.GPIOSimulatorScript);
+        reader.number("setting.VehicleClassifyWindowMs", config.VehicleClassifyWindowMs);
+        reader.number("setting.VehicleMinOverlapMs", config.VehicleMinOverlapMs);
+        reader.number("setting.DBStepTimeoutMs", config.DBStepTimeoutMs, false, 1);
+        reader.number("setting.DBSaveTimeoutMs", config.DBSaveTimeoutMs, false, 1);
+        reader.number("setting.DBWorkerThreads", config.DBWorkerThreads, false, 1, 64);
+        reader.number("setting.DBBreakerFailures", config.DBBreakerFailures, false, 1, 100);
+        reader.number("setting.DBBreakerSlowMs", config.DBBreakerSlowMs, false, 100, 60000);
+        reader.number("setting.DBBreakerOpenSec", config.DBBreakerOpenSec, false, 1, 600);
+        reader.number("setting.DBBreakerTrialCalls", config.DBBreakerTrialCalls, false, 1, 10);
+        reader.number("setting.DecisionBudgetMs", config.DecisionBudgetMs, false, 0, 60000);
+        reader.number("setting.LocalLookupMs", config.LocalLookupMs, false, 0, 10000);
+        reader.number("setting.PaidExitCacheHours", config.PaidExitCacheHours, false, 0, 168);
+        reader.number("setting.UploadRowsPerSec", config.UploadRowsPerSec, false, 1, 1000);
+        reader.number("setting.UploadKBytesPerSec", config.UploadKBytesPerSec, false, 0, 100000);
+        reader.number("setting.Lanes", config.Lanes, false, 1, LaneContext::MAX_LANES);
+        reader.text("setting.LCDDevice", config.LCDDevice);
+        reader.number("setting.IOThreads", config.IOThreads, false, 0, 64);
+        reader.text("setting.IOThreadCPUs", config.IOThreadCPUs);
+        reader.text("setting.DBThreadCPUs", config.DBThreadCPUs);
+        reader.flag("setting.MonitorStatusDelta", config.MonitorStatusDelta);
+        reader.number("setting.MonitorStatusIntervalMs", config.MonitorStatusIntervalMs, false, 100, 60000);
+        reader.number("setting.MonitorKeyframeSec", config.MonitorKeyframeSec, false, 0, 3600);
+
+        // The station ID names the log files and keys the DB, it has to be a number
+        int stationId = 0;
+        reader.number("setting.StationID", stationId, true);
 
         // Confirm [DI]
-        LoopA_                          = pt.get<int>("DI.LoopA");
-        LoopC_                          = pt.get<int>("DI.LoopC");
-        LoopB_                          = pt.get<int>("DI.LoopB");
-        Intercom_                       = pt.get<int>("DI.Intercom");
-        StationDooropen_                = pt.get<int>("DI.StationDooropen");
-        BarrierDooropen_                = pt.get<int>("DI.BarrierDooropen");
-        BarrierStatus_                  = pt.get<int>("DI.BarrierStatus");
-        ManualOpenBarrier_              = pt.get<int>("DI.ManualOpenBarrier");
-        Lorrysensor_                    = pt.get<int>("DI.Lorrysensor");
-        Armbroken_                      = pt.get<int>("DI.Armbroken");
+        reader.number("DI.LoopA", config.LoopA, true);
+        reader.number("DI.LoopC", config.LoopC, true);
+        reader.number("DI.LoopB", config.LoopB, true);
+        reader.number("DI.Intercom", config.Intercom, true);
+        reader.number("DI.StationDooropen", config.StationDooropen, true);
+        reader.number("DI.BarrierDooropen", config.BarrierDooropen, true);
+        reader.number("DI.BarrierStatus", config.BarrierStatus, true);
+        reader.number("DI.ManualOpenBarrier", config.ManualOpenBarrier, true);
+        reader.number("DI.Lorrysensor", config.Lorrysensor, true);
+        reader.number("DI.Armbroken", config.Armbroken, true);
 
         // Confirm [DO]
-        Openbarrier_                    = pt.get<int>("DO.Openbarrier");
-        LCDbacklight_                   = pt.get<int>("DO.LCDbacklight");
-        closebarrier_                   = pt.get<int>("DO.closebarrier");
+        reader.number("DO.Openbarrier", config.Openbarrier, true);
+        reader.number("DO.LCDbacklight", config.LCDbacklight, true);
+        reader.number("DO.closebarrier", config.closebarrier, true);
+
+        return true;
     }
     catch (const boost::filesystem::filesystem_error& e)
     {
@@ -112,6 +361,119 @@ void IniParser::FnReadIniFile()
         ss << __func__ << ", Exception: Unknown Exception";
         Logger::getInstance()->FnLogExceptionError(ss.str());
     }
+
+    return false;
+}
+
+void IniParser::FnReadIniFile()
+{
+    std::unique_ptr<IniConfig> config(new IniConfig());
+    std::vector<std::string> errors;
+
+    if (!readConfig(*config, errors))
+    {
+        return;
+    }
+
+    // The lane has to start, a bad value keeps its default and is reported
+    for (const auto& error : errors)
+    {
+        Logger::getInstance()->FnLogExceptionError("INI setting " + error);
+    }
+    publish(std::move(config));
+}
+
+void IniParser::FnReloadIniFile()
+{
+    std::unique_ptr<IniConfig> config(new IniConfig());
+    std::vector<std::string> errors;
+    int laneId = LaneContext::FnGetCurrentLane();
+
+    if (!readConfig(*config, errors))
+    {
+        return;
+    }
+
+    if (!errors.empty())
+    {
+        Logger::getInstance()->FnLog("Lane " + std::to_string(laneId) + " ini reload rejected, kept the running settings: " + boost::algorithm::join(errors, "; "), "", "INI");
+        return;
+    }
+
+    std::vector<std::string> changes = diffConfig(*FnGetConfig(), *config);
+    if (changes.empty())
+    {
+        return;
+    }
+
+    publish(std::move(config));
+
+    std::string changeText = boost::algorithm::join(changes, ";");
+    Logger::getInstance()->FnLog("Lane " + std::to_string(laneId) + " ini reloaded, changed: " + changeText, "", "INI");
+    // 316 pushes the change to the monitor, '|' separates the message fields
+    operation::getInstance()->SendMsg2Monitor("316", boost::algorithm::replace_all_copy(changeText, "|", "/"));
+}
+
+// key:old->new per changed key, "(restart)" marks keys the lane only reads while starting
+std::vector<std::string> IniParser::diffConfig(const IniConfig& older, const IniConfig& newer)
+{
+    std::vector<std::string> changes;
+    std::map<std::string, std::pair<std::string, std::string>> values;
+
+    for (const auto& entry : older.Values)
+    {
+        values[entry.first].first = entry.second;
+    }
+    for (const auto& entry : newer.Values)
+    {
+        values[entry.first].second = entry.second;
+    }
+
+    for (const auto& entry : values)
+    {
+        if (entry.second.first == entry.second.second)
+        {
+            continue;
+        }
+
+        bool isSecret = boost::algorithm::icontains(entry.first, "password");
+        std::string change = entry.first + ":" + (isSecret ? "***" : entry.second.first) + "->" + (isSecret ? "***" : entry.second.second);
+        if (isRestartKey(entry.first))
+        {
+            change += "(restart)";
+        }
+        changes.push_back(change);
+    }
+
+    return changes;
+}
+
+void IniParser::FnStartWatching(boost::asio::io_context& ioContext)
+{
+    if (iniWatch.descriptor)
+    {
+        return;
+    }
+
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0)
+    {
+        Logger::getInstance()->FnLogExceptionError("Ini watch not started, inotify_init1 failed");
+        return;
+    }
+
+    std::string iniFilePath = getInstance()->INI_FILE_PATH;
+    if (inotify_add_watch(fd, iniFilePath.c_str(), INOTIFY_MASK) < 0)
+    {
+        close(fd);
+        Logger::getInstance()->FnLogExceptionError("Ini watch not started, unable to watch " + iniFilePath);
+        return;
+    }
+
+    iniWatch.descriptor.reset(new boost::asio::posix::stream_descriptor(ioContext, fd));
+    iniWatch.settleTimer.reset(new boost::asio::steady_timer(ioContext));
+    readIniEvents();
+    Logger::getInstance()->FnLog("Watching " + iniFilePath + " for ini changes", "", "INI");
 }
 
 void IniParser::FnPrintIniFile()
@@ -157,199 +519,331 @@ void IniParser::FnPrintIniFile()
     }
 }
 
-std::string IniParser::FnGetStationID() const
+const std::string& IniParser::FnGetStationID() const
 {
-    return StationID_;
+    return FnGetConfig()->StationID;
 }
 
 std::string IniParser::FnGetLogFolder() const
 {
-    return LogFolder_;
+    return FnGetConfig()->LogFolder;
 }
 
 std::string IniParser::FnGetLocalDB() const
 {
-    return LocalDB_;
+    return FnGetConfig()->LocalDB;
 }
 
 std::string IniParser::FnGetCentralDBName() const
 {
-    return CentralDBName_;
+    return FnGetConfig()->CentralDBName;
 }
 
 std::string IniParser::FnGetCentralDBServer() const
 {
-    return CentralDBServer_;
+    return FnGetConfig()->CentralDBServer;
 }
 
 std::string IniParser::FnGetCentralUsername() const
 {
-    return CentralUsername_;
+    return FnGetConfig()->CentralUsername;
 }
 
 std::string IniParser::FnGetCentralPassword() const
 {
-    return CentralPassword_;
+    return FnGetConfig()->CentralPassword;
 }
 
-std::string IniParser::FnGetLocalUDPPort() const
+int IniParser::FnGetLocalUDPPort() const
 {
-    return LocalUDPPort_;
+    return FnGetConfig()->LocalUDPPort;
 }
 
-std::string IniParser::FnGetRemoteUDPPort() const
+int IniParser::FnGetRemoteUDPPort() const
 {
-    return RemoteUDPPort_;
+    return FnGetConfig()->RemoteUDPPort;
 }
 
-std::string IniParser::FnGetSeasonOnly() const
+int IniParser::FnGetSeasonOnly() const
 {
-    return SeasonOnly_;
+    return FnGetConfig()->SeasonOnly;
 }
 
-std::string IniParser::FnGetNotAllowHourly() const
+int IniParser::FnGetNotAllowHourly() const
 {
-    return NotAllowHourly_;
+    return FnGetConfig()->NotAllowHourly;
 }
 
 std::string IniParser::FnGetLPRIP4Front() const
 {
-    return LPRIP4Front_;
+    return FnGetConfig()->LPRIP4Front;
 }
 
 std::string IniParser::FnGetLPRIP4Rear() const
 {
-    return LPRIP4Rear_;
+    return FnGetConfig()->LPRIP4Rear;
 }
 
-std::string IniParser::FnGetLPRPort() const
+int IniParser::FnGetLPRPort() const
 {
-    return LPRPort_;
+    return FnGetConfig()->LPRPort;
 }
 
-std::string IniParser::FnGetWaitLPRNoTime() const
+float IniParser::FnGetWaitLPRNoTime() const
 {
-    return WaitLPRNoTime_;
+    return FnGetConfig()->WaitLPRNoTime;
 }
 
-std::string IniParser::FnGetLPRErrorTime() const
+int IniParser::FnGetLPRErrorTime() const
 {
-    return LPRErrorTime_;
+    return FnGetConfig()->LPRErrorTime;
 }
 
-std::string IniParser::FnGetLPRErrorCount() const
+int IniParser::FnGetLPRErrorCount() const
 {
-    return LPRErrorCount_;
+    return FnGetConfig()->LPRErrorCount;
 }
 
 bool IniParser::FnGetShowTime() const
 {
-    return ShowTime_;
+    return FnGetConfig()->ShowTime;
 }
 
 std::string IniParser::FnGetBlockIUPrefix() const
 {
-    return BlockIUPrefix_;
+    return FnGetConfig()->BlockIUPrefix;
 }
 
 std::string IniParser::FnGetTnGRemoteServerHost() const
 {
-    return TnGRemoteServerHost_;
+    return FnGetConfig()->TnGRemoteServerHost;
 }
 
 std::string IniParser::FnGetTnGRemoteServerPort() const
 {
-    return TnGRemoteServerPort_;
+    return FnGetConfig()->TnGRemoteServerPort;
 }
 
 std::string IniParser::FnGetTnGListenHost() const
 {
-    return TnGListenHost_;
+    return FnGetConfig()->TnGListenHost;
 }
 
 std::string IniParser::FnGetTnGListenPort() const
 {
-    return TnGListenPort_;
+    return FnGetConfig()->TnGListenPort;
 }
 
 int IniParser::FnGetWholeLpnMatchRateThreshold() const
 {
-    return WholeLpnMatchRateThreshold_;
+    return FnGetConfig()->WholeLpnMatchRateThreshold;
 }
 
 int IniParser::FnGetDigitLpnMatchRateThreshold() const
 {
-    return DigitLpnMatchRateThreshold_;
+    return FnGetConfig()->DigitLpnMatchRateThreshold;
 }
 
 int IniParser::FnGetLpnTimeout() const
 {
-    return LpnTimeout_;
+    return FnGetConfig()->LpnTimeout;
+}
+
+int IniParser::FnGetLogQueryListenPort() const
+{
+    return FnGetConfig()->LogQueryListenPort;
+}
+
+std::string IniParser::FnGetGPIOBackend() const
+{
+    return FnGetConfig()->GPIOBackend;
+}
+
+std::string IniParser::FnGetGPIOSimulatorScript() const
+{
+    return FnGetConfig()->GPIOSimulatorScript;
+}
+
+int IniParser::FnGetVehicleClassifyWindowMs() const
+{
+    return FnGetConfig()->VehicleClassifyWindowMs;
+}
+
+int IniParser::FnGetVehicleMinOverlapMs() const
+{
+    return FnGetConfig()->VehicleMinOverlapMs;
+}
+
+int IniParser::FnGetDBStepTimeoutMs() const
+{
+    return FnGetConfig()->DBStepTimeoutMs;
+}
+
+int IniParser::FnGetDBSaveTimeoutMs() const
+{
+    return FnGetConfig()->DBSaveTimeoutMs;
+}
+
+int IniParser::FnGetDBWorkerThreads() const
+{
+    return FnGetConfig()->DBWorkerThreads;
+}
+
+int IniParser::FnGetDBBreakerFailures() const
+{
+    return FnGetConfig()->DBBreakerFailures;
+}
+
+int IniParser::FnGetDBBreakerSlowMs() const
+{
+    return FnGetConfig()->DBBreakerSlowMs;
+}
+
+int IniParser::FnGetDBBreakerOpenSec() const
+{
+    return FnGetConfig()->DBBreakerOpenSec;
+}
+
+int IniParser::FnGetDBBreakerTrialCalls() const
+{
+    return FnGetConfig()->DBBreakerTrialCalls;
+}
+
+int IniParser::FnGetDecisionBudgetMs() const
+{
+    return FnGetConfig()->DecisionBudgetMs;
+}
+
+int IniParser::FnGetLocalLookupMs() const
+{
+    return FnGetConfig()->LocalLookupMs;
+}
+
+int IniParser::FnGetPaidExitCacheHours() const
+{
+    return FnGetConfig()->PaidExitCacheHours;
+}
+
+int IniParser::FnGetUploadRowsPerSec() const
+{
+    return FnGetConfig()->UploadRowsPerSec;
+}
+
+int IniParser::FnGetUploadKBytesPerSec() const
+{
+    return FnGetConfig()->UploadKBytesPerSec;
+}
+
+int IniParser::FnGetLanes() const
+{
+    return FnGetConfig()->Lanes;
+}
+
+std::string IniParser::FnGetLCDDevice() const
+{
+    return FnGetConfig()->LCDDevice;
+}
+
+std::string IniParser::FnGetLaneIniFile(int laneId) const
+{
+    return INI_FILE_PATH + "/LinuxPBS_lane" + std::to_string(laneId) + ".ini";
+}
+
+int IniParser::FnGetIOThreads() const
+{
+    return FnGetConfig()->IOThreads;
+}
+
+std::string IniParser::FnGetIOThreadCPUs() const
+{
+    return FnGetConfig()->IOThreadCPUs;
+}
+
+std::string IniParser::FnGetDBThreadCPUs() const
+{
+    return FnGetConfig()->DBThreadCPUs;
+}
+
+bool IniParser::FnGetMonitorStatusDelta() const
+{
+    return FnGetConfig()->MonitorStatusDelta;
+}
+
+int IniParser::FnGetMonitorStatusIntervalMs() const
+{
+    return FnGetConfig()->MonitorStatusIntervalMs;
+}
+
+int IniParser::FnGetMonitorKeyframeSec() const
+{
+    return FnGetConfig()->MonitorKeyframeSec;
 }
 
 // Confirm [DI]
+
 int IniParser::FnGetLoopA() const
 {
-    return LoopA_;
+    return FnGetConfig()->LoopA;
 }
 
 int IniParser::FnGetLoopC() const
 {
-    return LoopC_;
+    return FnGetConfig()->LoopC;
 }
 
 int IniParser::FnGetLoopB() const
 {
-    return LoopB_;
+    return FnGetConfig()->LoopB;
 }
 
 int IniParser::FnGetIntercom() const
 {
-    return Intercom_;
+    return FnGetConfig()->Intercom;
 }
 
 int IniParser::FnGetStationDooropen() const
 {
-    return StationDooropen_;
+    return FnGetConfig()->StationDooropen;
 }
 
 int IniParser::FnGetBarrierDooropen() const
 {
-    return BarrierDooropen_;
+    return FnGetConfig()->BarrierDooropen;
 }
 
 int IniParser::FnGetBarrierStatus() const
 {
-    return BarrierStatus_;
+    return FnGetConfig()->BarrierStatus;
 }
 
 int IniParser::FnGetManualOpenBarrier() const
 {
-    return ManualOpenBarrier_;
+    return FnGetConfig()->ManualOpenBarrier;
 }
 
 int IniParser::FnGetLorrysensor() const
 {
-    return Lorrysensor_;
+    return FnGetConfig()->Lorrysensor;
 }
 
 int IniParser::FnGetArmbroken() const
 {
-    return Armbroken_;
+    return FnGetConfig()->Armbroken;
 }
 
 // Confirm [DO]
+
 int IniParser::FnGetOpenbarrier() const
 {
-    return Openbarrier_;
+    return FnGetConfig()->Openbarrier;
 }
 
 int IniParser::FnGetLCDbacklight() const
 {
-    return LCDbacklight_;
+    return FnGetConfig()->LCDbacklight;
 }
 
 int IniParser::FnGetclosebarrier() const
 {
-    return closebarrier_;
-}
\ No newline at end of file
+    return FnGetConfig()->closebarrier;
+}
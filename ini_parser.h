@@ -1,8 +1,91 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
+#include "boost/asio.hpp"
+#include "lane_context.h"
+#include "lazy_instance.h"
+
+// One lane's settings, parsed and checked once per read of the ini files
+struct IniConfig
+{
+    std::string StationID;
+    std::string LogFolder;
+    std::string LocalDB;
+    std::string CentralDBName;
+    std::string CentralDBServer;
+    std::string CentralUsername;
+    std::string CentralPassword;
+    int LocalUDPPort = 0;
+    int RemoteUDPPort = 0;
+    int SeasonOnly = 0;
+    int NotAllowHourly = 0;
+    std::string LPRIP4Front;
+    std::string LPRIP4Rear;
+    int LPRPort = 0;
+    float WaitLPRNoTime = 0;
+    int LPRErrorTime = 0;
+    int LPRErrorCount = 0;
+    bool ShowTime = false;
+    std::string BlockIUPrefix;
+    std::string TnGRemoteServerHost;
+    std::string TnGRemoteServerPort;
+    std::string TnGListenHost;
+    std::string TnGListenPort;
+    int WholeLpnMatchRateThreshold = 0;
+    int DigitLpnMatchRateThreshold = 0;
+    int LpnTimeout = 0;
+    int LogQueryListenPort = 3081;
+    std::string GPIOBackend = "sysfs";
+    std::string GPIOSimulatorScript;
+    int VehicleClassifyWindowMs = 500;
+    int VehicleMinOverlapMs = 0;
+    int DBStepTimeoutMs = 1500;
+    int DBSaveTimeoutMs = 2000;
+    int DBWorkerThreads = 3;
+    int DBBreakerFailures = 3;
+    int DBBreakerSlowMs = 3000;
+    int DBBreakerOpenSec = 15;
+    int DBBreakerTrialCalls = 1;
+    int DecisionBudgetMs = 0;
+    int LocalLookupMs = 200;
+    int PaidExitCacheHours = 24;
+    int UploadRowsPerSec = 10;
+    int UploadKBytesPerSec = 0;
+    int Lanes = 1;
+    std::string LCDDevice = "/dev/ch34x_pis0";
+    int IOThreads = 0;
+    std::string IOThreadCPUs;
+    std::string DBThreadCPUs;
+    bool MonitorStatusDelta = false;
+    int MonitorStatusIntervalMs = 1000;
+    int MonitorKeyframeSec = 60;
+
+    // Confirm [DI]
+    int LoopA = 0;
+    int LoopC = 0;
+    int LoopB = 0;
+    int Intercom = 0;
+    int StationDooropen = 0;
+    int BarrierDooropen = 0;
+    int BarrierStatus = 0;
+    int ManualOpenBarrier = 0;
+    int Lorrysensor = 0;
+    int Armbroken = 0;
+
+    // Confirm [DO]
+    int Openbarrier = 0;
+    int LCDbacklight = 0;
+    int closebarrier = 0;
+
+    // Every key read as section.key, lane overlay applied, what a reload compares
+    std::map<std::string, std::string> Values;
+};
 
 class IniParser
 {
@@ -11,26 +94,37 @@ public:
     const std::string INI_FILE_PATH = "/home/root/carpark/Ini";
     const std::string INI_FILE = "/home/root/carpark/Ini/LinuxPBS.ini";
 
+    // One per lane, lanes after the first read INI_FILE overridden by their own FnGetLaneIniFile()
     static IniParser* getInstance();
     void FnReadIniFile();
+    // Reads the files again and publishes them if they are valid, the changed keys are logged and sent to the monitor
+    void FnReloadIniFile();
+    std::string FnGetLaneIniFile(int laneId) const;
     void FnPrintIniFile();
-    std::string FnGetStationID() const;
+
+    // The current settings, one acquire load. A replaced config is kept, so the pointer stays valid.
+    const IniConfig* FnGetConfig() const;
+
+    // Watches the ini folder and reloads every lane when one of its files is written
+    static void FnStartWatching(boost::asio::io_context& ioContext);
+
+    const std::string& FnGetStationID() const;
     std::string FnGetLogFolder() const;
     std::string FnGetLocalDB() const;
     std::string FnGetCentralDBName() const;
     std::string FnGetCentralDBServer() const;
     std::string FnGetCentralUsername() const;
     std::string FnGetCentralPassword() const;
-    std::string FnGetLocalUDPPort() const;
-    std::string FnGetRemoteUDPPort() const;
-    std::string FnGetSeasonOnly() const;
-    std::string FnGetNotAllowHourly() const;
+    int FnGetLocalUDPPort() const;
+    int FnGetRemoteUDPPort() const;
+    int FnGetSeasonOnly() const;
+    int FnGetNotAllowHourly() const;
     std::string FnGetLPRIP4Front() const;
     std::string FnGetLPRIP4Rear() const;
-    std::string FnGetLPRPort() const;
-    std::string FnGetWaitLPRNoTime() const;
-    std::string FnGetLPRErrorTime() const;
-    std::string FnGetLPRErrorCount() const;
+    int FnGetLPRPort() const;
+    float FnGetWaitLPRNoTime() const;
+    int FnGetLPRErrorTime() const;
+    int FnGetLPRErrorCount() const;
     bool FnGetShowTime() const;
     std::string FnGetBlockIUPrefix() const;
     std::string FnGetTnGRemoteServerHost() const;
@@ -40,6 +134,31 @@ public:
     int FnGetWholeLpnMatchRateThreshold() const;
     int FnGetDigitLpnMatchRateThreshold() const;
     int FnGetLpnTimeout() const;
+    int FnGetLogQueryListenPort() const;
+    std::string FnGetGPIOBackend() const;
+    std::string FnGetGPIOSimulatorScript() const;
+    int FnGetVehicleClassifyWindowMs() const;
+    int FnGetVehicleMinOverlapMs() const;
+    int FnGetDBStepTimeoutMs() const;
+    int FnGetDBSaveTimeoutMs() const;
+    int FnGetDBWorkerThreads() const;
+    int FnGetDBBreakerFailures() const;
+    int FnGetDBBreakerSlowMs() const;
+    int FnGetDBBreakerOpenSec() const;
+    int FnGetDBBreakerTrialCalls() const;
+    int FnGetDecisionBudgetMs() const;
+    int FnGetLocalLookupMs() const;
+    int FnGetPaidExitCacheHours() const;
+    int FnGetUploadRowsPerSec() const;
+    int FnGetUploadKBytesPerSec() const;
+    int FnGetLanes() const;
+    std::string FnGetLCDDevice() const;
+    int FnGetIOThreads() const;
+    std::string FnGetIOThreadCPUs() const;
+    std::string FnGetDBThreadCPUs() const;
+    bool FnGetMonitorStatusDelta() const;
+    int FnGetMonitorStatusIntervalMs() const;
+    int FnGetMonitorKeyframeSec() const;
 
     // Confirm [DI]
     int FnGetLoopA() const;
@@ -69,51 +188,15 @@ public:
     void operator=(const IniParser &) = delete;
 
 private:
-    static IniParser* iniParser_;
+    static std::array<std::atomic<IniParser*>, LaneContext::MAX_LANES> iniParsers_;
     static std::mutex mutex_;
     IniParser();
 
-    std::string StationID_;
-    std::string LogFolder_;
-    std::string LocalDB_;
-    std::string CentralDBName_;
-    std::string CentralDBServer_;
-    std::string CentralUsername_;
-    std::string CentralPassword_;
-    std::string LocalUDPPort_;
-    std::string RemoteUDPPort_;
-    std::string SeasonOnly_;
-    std::string NotAllowHourly_;
-    std::string LPRIP4Front_;
-    std::string LPRIP4Rear_;
-    std::string LPRPort_;
-    std::string WaitLPRNoTime_;
-    std::string LPRErrorTime_;
-    std::string LPRErrorCount_;
-    bool ShowTime_;
-    std::string BlockIUPrefix_;
-    std::string TnGRemoteServerHost_;
-    std::string TnGRemoteServerPort_;
-    std::string TnGListenHost_;
-    std::string TnGListenPort_;
-    int WholeLpnMatchRateThreshold_;
-    int DigitLpnMatchRateThreshold_;
-    int LpnTimeout_;
-
-    // Confirm [DI]
-    int LoopA_;
-    int LoopC_;
-    int LoopB_;
-    int Intercom_;
-    int StationDooropen_;
-    int BarrierDooropen_;
-    int BarrierStatus_;
-    int ManualOpenBarrier_;
-    int Lorrysensor_;
-    int Armbroken_;
-
-    // Confirm [DO]
-    int Openbarrier_;
-    int LCDbacklight_;
-    int closebarrier_;
+    std::atomic<const IniConfig*> config_;
+    // Every config this lane published, readers may still hold an older one
+    std::vector<std::unique_ptr<const IniConfig>> configs_;
+    std::mutex configMutex_;
+    bool readConfig(IniConfig& config, std::vector<std::string>& errors) const;
+    void publish(std::unique_ptr<const IniConfig> config);
+    static std::vector<std::string> diffConfig(const IniConfig& older, const IniConfig& newer);
 };
\ No newline at end of file
@@ -0,0 +1,256 @@
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include "boost/algorithm/string.hpp"
+#include "io_executor.h"
+#include "log.h"
+
+std::atomic<IOExecutor*> IOExecutor::ioExecutor_(nullptr);
+std::mutex IOExecutor::mutex_;
+
+IOExecutor::IOExecutor()
+    : logFileName_("executor"),
+    ioContext_(),
+    blockingContext_(),
+    blockingWorkGuard_(boost::asio::make_work_guard(blockingContext_)),
+    ioThreadCount_(0),
+    lastContextSwitches_(FnGetContextSwitches()),
+    lastTransactions_(0)
+{
+}
+
+IOExecutor* IOExecutor::getInstance()
+{
+    return LazyInstance::FnGet(ioExecutor_, mutex_, []() { return new IOExecutor(); });
+}
+
+boost::asio::io_context& IOExecutor::FnGetIOContext()
+{
+    return ioContext_;
+}
+
+boost::asio::io_context& IOExecutor::FnGetBlockingContext()
+{
+    return blockingContext_;
+}
+
+int IOExecutor::resolveThreadCount(int numThreads)
+{
+    if (numThreads <= 0)
+    {
+        numThreads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+
+    return std::min(std::max(numThreads, 1), MAX_IO_THREADS);
+}
+
+std::vector<int> IOExecutor::FnParseCPUList(const std::string& cpuList)
+{
+    std::vector<int> cpus;
+    std::vector<std::string> tokens;
+    boost::split(tokens, cpuList, boost::is_any_of(","));
+
+    for (auto& token : tokens)
+    {
+        boost::trim(token);
+        if (token.empty())
+        {
+            continue;
+        }
+
+        try
+        {
+            int cpu = std::stoi(token);
+            if ((cpu >= 0) && (cpu < CPU_SETSIZE))
+            {
+                cpus.push_back(cpu);
+            }
+        }
+        catch (...)
+        {
+            Logger::getInstance()->FnLog("Invalid CPU in list : " + token, "executor", "EXEC");
+        }
+    }
+
+    return cpus;
+}
+
+void IOExecutor::FnNameCurrentThread(const std::string& name)
+{
+    // The kernel keeps 15 characters of a thread name
+    pthread_setname_np(pthread_self(), name.substr(0, MAX_THREAD_NAME_LEN).c_str());
+}
+
+bool IOExecutor::FnPinCurrentThread(const std::vector<int>& cpus)
+{
+    if (cpus.empty())
+    {
+        return false;
+    }
+
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (int cpu : cpus)
+    {
+        CPU_SET(cpu, &cpuSet);
+    }
+
+    return (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0);
+}
+
+void IOExecutor::runThread(boost::asio::io_context& ioContext, const std::string& name, const std::vector<int>& cpus)
+{
+    FnNameCurrentThread(name);
+    if (!cpus.empty() && !FnPinCurrentThread(cpus))
+    {
+        Logger::getInstance()->FnLog("Unable to set CPU affinity for " + name, logFileName_, "EXEC");
+    }
+
+    // A handler that throws must not take the whole pool down with it
+    while (!ioContext.stopped())
+    {
+        try
+        {
+            ioContext.run();
+        }
+        catch (const std::exception& e)
+        {
+            std::stringstream ss;
+            ss << __func__ << ", Thread: " << name << ", Exception: " << e.what();
+            Logger::getInstance()->FnLogExceptionError(ss.str());
+        }
+        catch (...)
+        {
+            std::stringstream ss;
+            ss << __func__ << ", Thread: " << name << ", Exception: Unknown Exception";
+            Logger::getInstance()->FnLogExceptionError(ss.str());
+        }
+    }
+}
+
+void IOExecutor::FnStartBlockingThreads(int numThreads, const std::string& cpuList)
+{
+    if (!blockingThreads_.empty())
+    {
+        return;
+    }
+
+    int threadCount = resolveThreadCount(numThreads);
+    std::vector<int> cpus = FnParseCPUList(cpuList);
+
+    for (int i = 0; i < threadCount; i++)
+    {
+        std::string name = "pbs-db-" + std::to_string(i);
+        blockingThreads_.emplace_back([this, name, cpus]() { runThread(blockingContext_, name, cpus); });
+    }
+
+    std::stringstream ss;
+    ss << __func__ << " Blocking threads : " << threadCount << ", CPUs : " << (cpus.empty() ? "any" : cpuList);
+    Logger::getInstance()->FnLog(ss.str(), logFileName_, "EXEC");
+}
+
+void IOExecutor::FnStopBlockingThreads()
+{
+    Logger::getInstance()->FnLog(__func__, logFileName_, "EXEC");
+
+    // Queued DB work still runs, the threads leave once the context is out of work
+    blockingWorkGuard_.reset();
+    for (auto& thread : blockingThreads_)
+    {
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+    blockingThreads_.clear();
+}
+
+void IOExecutor::FnRunIOThreads(int numThreads, const std::string& cpuList)
+{
+    ioThreadCount_ = resolveThreadCount(numThreads);
+    std::vector<int> cpus = FnParseCPUList(cpuList);
+
+    std::stringstream ss;
+    ss << __func__ << " IO threads : " << ioThreadCount_ << ", CPUs : " << (cpus.empty() ? "any" : cpuList);
+    Logger::getInstance()->FnLog(ss.str(), logFileName_, "EXEC");
+
+    for (int i = 0; i < ioThreadCount_; i++)
+    {
+        std::string name = "pbs-io-" + std::to_string(i);
+        ioThreads_.emplace_back([this, name, cpus]() { runThread(ioContext_, name, cpus); });
+    }
+
+    // The calling thread only waits, it keeps the process name and is not pinned
+    for (auto& thread : ioThreads_)
+    {
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+    ioThreads_.clear();
+}
+
+IOExecutor::ContextSwitchStats IOExecutor::FnGetContextSwitches()
+{
+    ContextSwitchStats stats = { 0, 0 };
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+        stats.voluntary = static_cast<uint64_t>(usage.ru_nvcsw);
+        stats.involuntary = static_cast<uint64_t>(usage.ru_nivcsw);
+    }
+
+    return stats;
+}
+
+int IOExecutor::FnGetThreadCount()
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+
+    while (std::getline(status, line))
+    {
+        if (line.compare(0, 8, "Threads:") == 0)
+        {
+            try
+            {
+                return std::stoi(line.substr(8));
+            }
+            catch (...)
+            {
+                return 0;
+            }
+        }
+    }
+
+    return 0;
+}
+
+void IOExecutor::FnLogStats(uint64_t transactions)
+{
+    ContextSwitchStats current = FnGetContextSwitches();
+    uint64_t voluntary = current.voluntary - lastContextSwitches_.voluntary;
+    uint64_t involuntary = current.involuntary - lastContextSwitches_.involuntary;
+    uint64_t newTransactions = transactions - lastTransactions_;
+
+    lastContextSwitches_ = current;
+    lastTransactions_ = transactions;
+
+    std::stringstream ss;
+    ss << "IO Executor => threads: " << FnGetThreadCount();
+    ss << ", io threads: " << ioThreadCount_;
+    ss << ", db threads: " << blockingThreads_.size();
+    ss << ", ctx switches vol: " << voluntary;
+    ss << ", invol: " << involuntary;
+    ss << ", transactions: " << newTransactions;
+    if (newTransactions > 0)
+    {
+        ss << ", ctx switches per transaction: " << ((voluntary + involuntary) / newTransactions);
+    }
+    Logger::getInstance()->FnLog(ss.str(), logFileName_, "EXEC");
+}
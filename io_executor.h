@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "boost/asio.hpp"
+#include "lazy_instance.h"
+
+// One io_context shared by the main program and every device (LED, LCD, LPR, TnG), each device keeps
+// its handlers on its own strand. Blocking ODBC work runs on a second, bounded context so a slow query
+// never holds an I/O thread. Both pools are sized and optionally pinned from [setting].
+class IOExecutor
+{
+public:
+    static const int MAX_IO_THREADS = 8;
+    static const int MAX_THREAD_NAME_LEN = 15;
+
+    struct ContextSwitchStats
+    {
+        uint64_t voluntary;
+        uint64_t involuntary;
+    };
+
+    static IOExecutor* getInstance();
+    boost::asio::io_context& FnGetIOContext();
+    boost::asio::io_context& FnGetBlockingContext();
+
+    // numThreads <= 0 uses one thread per core; cpuList is a comma separated CPU list, blank leaves threads unpinned
+    void FnStartBlockingThreads(int numThreads, const std::string& cpuList);
+    void FnStopBlockingThreads();
+
+    // Runs the shared io_context on numThreads named threads, returns once it is stopped and they have joined
+    void FnRunIOThreads(int numThreads, const std::string& cpuList);
+
+    static void FnNameCurrentThread(const std::string& name);
+    static bool FnPinCurrentThread(const std::vector<int>& cpus);
+    static std::vector<int> FnParseCPUList(const std::string& cpuList);
+
+    // Process wide, from getrusage()
+    static ContextSwitchStats FnGetContextSwitches();
+    static int FnGetThreadCount();
+
+    // Context switches since the previous call, per transaction when transactions > 0
+    void FnLogStats(uint64_t transactions);
+
+    /**
+     * Singleton IOExecutor should not be cloneable.
+     */
+    IOExecutor(IOExecutor& ioExecutor) = delete;
+
+    /**
+     * Singleton IOExecutor should not be assignable.
+     */
+    void operator=(const IOExecutor&) = delete;
+
+private:
+    static std::atomic<IOExecutor*> ioExecutor_;
+    static std::mutex mutex_;
+    std::string logFileName_;
+    boost::asio::io_context ioContext_;
+    boost::asio::io_context blockingContext_;
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type> blockingWorkGuard_;
+    std::vector<std::thread> ioThreads_;
+    std::vector<std::thread> blockingThreads_;
+    int ioThreadCount_;
+    ContextSwitchStats lastContextSwitches_;
+    uint64_t lastTransactions_;
+    IOExecutor();
+    static int resolveThreadCount(int numThreads);
+    void runThread(boost::asio::io_context& ioContext, const std::string& name, const std::vector<int>& cpus);
+};
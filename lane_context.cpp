@@ -0,0 +1,127 @@
+#include <time.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include "lane_context.h"
+#include "log.h"
+
+thread_local int LaneContext::currentLane_ = LaneContext::DEFAULT_LANE;
+thread_local int LaneContext::accountedDepth_ = 0;
+std::atomic<int> LaneContext::laneCount_(1);
+std::array<std::atomic<uint64_t>, LaneContext::MAX_LANES> LaneContext::laneCpuUs_ = {};
+std::array<std::atomic<uint64_t>, LaneContext::MAX_LANES> LaneContext::laneMemoryKB_ = {};
+
+LaneContext::Scope::Scope(int laneId, bool isAccounted)
+    : previousLane_(currentLane_),
+    isAccounted_(isAccounted),
+    isMeasuring_(isAccounted && (accountedDepth_ == 0)),
+    cpuStartUs_(isMeasuring_ ? threadCpuUs() : 0)
+{
+    currentLane_ = clampLane(laneId);
+    if (isAccounted_)
+    {
+        accountedDepth_++;
+    }
+}
+
+LaneContext::Scope::~Scope()
+{
+    if (isMeasuring_)
+    {
+        laneCpuUs_[currentLane_].fetch_add(threadCpuUs() - cpuStartUs_, std::memory_order_relaxed);
+    }
+    if (isAccounted_)
+    {
+        accountedDepth_--;
+    }
+
+    currentLane_ = previousLane_;
+}
+
+int LaneContext::clampLane(int laneId)
+{
+    return ((laneId >= 0) && (laneId < MAX_LANES)) ? laneId : DEFAULT_LANE;
+}
+
+uint64_t LaneContext::threadCpuUs()
+{
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+    {
+        return 0;
+    }
+
+    return (static_cast<uint64_t>(ts.tv_sec) * 1000000) + (static_cast<uint64_t>(ts.tv_nsec) / 1000);
+}
+
+int LaneContext::FnGetCurrentLane()
+{
+    return currentLane_;
+}
+
+void LaneContext::FnSetThreadLane(int laneId)
+{
+    currentLane_ = clampLane(laneId);
+}
+
+void LaneContext::FnSetLaneCount(int laneCount)
+{
+    laneCount_.store(std::min(std::max(laneCount, 1), MAX_LANES));
+}
+
+int LaneContext::FnGetLaneCount()
+{
+    return laneCount_.load();
+}
+
+void LaneContext::FnRecordLaneMemory(int laneId, uint64_t residentStartKB)
+{
+    uint64_t residentKB = FnGetResidentKB();
+    laneMemoryKB_[clampLane(laneId)].store((residentKB > residentStartKB) ? (residentKB - residentStartKB) : 0);
+}
+
+uint64_t LaneContext::FnGetResidentKB()
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+
+    while (std::getline(status, line))
+    {
+        if (line.compare(0, 6, "VmRSS:") == 0)
+        {
+            try
+            {
+                return static_cast<uint64_t>(std::stoull(line.substr(6)));
+            }
+            catch (...)
+            {
+                return 0;
+            }
+        }
+    }
+
+    return 0;
+}
+
+LaneContext::LaneStats LaneContext::FnGetLaneStats(int laneId)
+{
+    LaneStats stats;
+    stats.cpuUs = laneCpuUs_[clampLane(laneId)].load();
+    stats.memoryKB = laneMemoryKB_[clampLane(laneId)].load();
+
+    return stats;
+}
+
+void LaneContext::FnLogStats()
+{
+    std::stringstream ss;
+    ss << "Lanes => count: " << FnGetLaneCount();
+
+    for (int laneId = 0; laneId < FnGetLaneCount(); laneId++)
+    {
+        LaneStats stats = FnGetLaneStats(laneId);
+        ss << " | lane " << laneId << " cpu: " << (stats.cpuUs / 1000) << "ms, memory: " << stats.memoryKB << "KB";
+    }
+
+    Logger::getInstance()->FnLog(ss.str(), "lane", "LANE");
+}
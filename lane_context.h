@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+// Which lane the calling thread is working for. Lane state (operation, AsyncFlow, IniParser, DIO, LCD,
+// LEDManager, Lpr, TnG_Reader, VehicleClassifier) is kept once per lane and looked up through it, while
+// the DB, the executor, the event queues and GPIO are shared by every lane on the controller.
+// Threads that never enter a lane work for DEFAULT_LANE, so a single lane controller behaves as before.
+class LaneContext
+{
+public:
+    static const int DEFAULT_LANE = 0;
+    static const int MAX_LANES = 4;
+
+    // Makes laneId the calling thread's lane until the scope ends. The thread CPU time spent inside an
+    // accounted scope is added to the lane, nested scopes are only counted once.
+    class Scope
+    {
+    public:
+        explicit Scope(int laneId, bool isAccounted = true);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        void operator=(const Scope&) = delete;
+
+    private:
+        int previousLane_;
+        bool isAccounted_;
+        bool isMeasuring_;
+        uint64_t cpuStartUs_;
+    };
+
+    struct LaneStats
+    {
+        uint64_t cpuUs;
+        uint64_t memoryKB;
+    };
+
+    static int FnGetCurrentLane();
+
+    // For threads that only ever work for one lane, e.g. the lane's DIO monitoring thread
+    static void FnSetThreadLane(int laneId);
+
+    // Wraps a handler so it runs in laneId, for callbacks that come back on executor threads
+    template <typename Handler>
+    static auto FnBind(int laneId, Handler handler)
+    {
+        return [laneId, handler](auto&&... args) mutable
+        {
+            Scope scope(laneId);
+            return handler(std::forward<decltype(args)>(args)...);
+        };
+    }
+
+    static void FnSetLaneCount(int laneCount);
+    static int FnGetLaneCount();
+
+    // Records the resident memory growth since residentStartKB as the memory the lane took to start up
+    static void FnRecordLaneMemory(int laneId, uint64_t residentStartKB);
+    static uint64_t FnGetResidentKB();
+
+    static LaneStats FnGetLaneStats(int laneId);
+    static void FnLogStats();
+
+private:
+    static thread_local int currentLane_;
+    static thread_local int accountedDepth_;
+    static std::atomic<int> laneCount_;
+    static std::array<std::atomic<uint64_t>, MAX_LANES> laneCpuUs_;
+    static std::array<std::atomic<uint64_t>, MAX_LANES> laneMemoryKB_;
+    static int clampLane(int laneId);
+    static uint64_t threadCpuUs();
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+// Creates a singleton on its first use. Only the callers that race to create it take the mutex, every
+// later getInstance() is one acquire load, so hot paths such as FnLog never contend on a lock.
+class LazyInstance
+{
+public:
+    template <typename T, typename Factory>
+    static T* FnGet(std::atomic<T*>& instance, std::mutex& mutex, Factory factory)
+    {
+        T* current = instance.load(std::memory_order_acquire);
+        if (current == nullptr)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            current = instance.load(std::memory_order_relaxed);
+            if (current == nullptr)
+            {
+                current = factory();
+                instance.store(current, std::memory_order_release);
+            }
+        }
+
+        return current;
+    }
+
+    LazyInstance() = delete;
+};
@@ -2,32 +2,31 @@
 #include <iomanip>
 #include <sstream>
 #include <unistd.h>
+#ifndef PBS_HOST_BUILD
 #include "ch341_lib.h"
+#endif
+#include "io_executor.h"
+#include "ini_parser.h"
 #include "lcd.h"
 #include "log.h"
+#ifndef PBS_HOST_BUILD
 #include "ps_par.h"
+#endif
 
-LCD* LCD::lcd_ = nullptr;
+std::array<std::atomic<LCD*>, LaneContext::MAX_LANES> LCD::lcds_ = {};
 std::mutex LCD::mutex_;
 
 LCD::LCD()
     : lcdFd_(0),
     lcdInitialized_(false),
-    ioContext_(),
-    strand_(boost::asio::make_strand(ioContext_)),
-    workGuard_(boost::asio::make_work_guard(ioContext_))
+    strand_(boost::asio::make_strand(IOExecutor::getInstance()->FnGetIOContext()))
 {
 
 }
 
 LCD* LCD::getInstance()
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (lcd_ == nullptr)
-    {
-        lcd_ = new LCD();
-    }
-    return lcd_;
+    return LazyInstance::FnGet(lcds_[LaneContext::FnGetCurrentLane()], mutex_, []() { return new LCD(); });
 }
 
 bool LCD::FnLCDInit()
@@ -54,7 +53,13 @@ void LCD::FnLCDInitDriver()
 {
     if (!lcdInitialized_)
     {
-        lcdFd_ = CH34xOpenDevice("/dev/ch34x_pis0");
+        std::string lcdDevice = IniParser::getInstance()->FnGetLCDDevice();
+#ifdef PBS_HOST_BUILD
+        // No CH34x parallel driver on a host build, the lane runs without its LCD
+        lcdFd_ = -1;
+#else
+        lcdFd_ = CH34xOpenDevice(const_cast<char*>(lcdDevice.c_str()));
+#endif
         if (lcdFd_ < 0)
         {
             std::stringstream ss;
@@ -64,7 +69,6 @@ void LCD::FnLCDInitDriver()
         else
         {
             lcdInitialized_ = true;
-            startIoContextThread();
 
             char cmd1[] = "0x38";
             sendCommandDataToDriver(lcdFd_, cmd1, 0);
@@ -76,14 +80,6 @@ void LCD::FnLCDInitDriver()
     }
 }
 
-void LCD::startIoContextThread()
-{
-    if (!ioContextThread_.joinable())
-    {
-        ioContextThread_ = std::thread([this]() { ioContext_.run(); });
-    }
-}
-
 void LCD::sendCommandDataToDriver(int fd, char* data, bool value)
 {
     // Check for null input
@@ -96,7 +92,9 @@ void LCD::sendCommandDataToDriver(int fd, char* data, bool value)
     std::vector<char> safeData(data, data + strlen(data) + 1);
 
     boost::asio::post(strand_, [this, fd, safeData, value] () mutable {
+#ifndef PBS_HOST_BUILD
         ps_par(fd, safeData.data(), value);
+#endif
     });
 }
 
@@ -539,12 +537,14 @@ void LCD::FnLCDDeinitDriver()
     if (lcdInitialized_ == false)
         return;
 
+#ifndef PBS_HOST_BUILD
     if(!CH34xCloseDevice(lcdFd_))
     {
         std::stringstream ss;
         ss << "Failed to close LCD device, fd :" << std::to_string(lcdFd_) << std::endl;
         Logger::getInstance()->FnLog(ss.str());
     }
+#endif
 }
 
 void LCD::FnLCDClose()
@@ -552,13 +552,10 @@ void LCD::FnLCDClose()
     if (lcdInitialized_ == false)
         return;
 
-    workGuard_.reset();
-    ioContext_.stop();
-    if (ioContextThread_.joinable())
+    // Closed on the strand, after the writes already queued for the display
+    boost::asio::post(strand_, [this]()
     {
-        ioContextThread_.join();
-    }
-
-    FnLCDDeinitDriver();
-    lcdInitialized_ = false;
+        FnLCDDeinitDriver();
+        lcdInitialized_ = false;
+    });
 }
\ No newline at end of file
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <mutex>
 #include <thread>
 #include "boost/asio.hpp"
 #include "boost/asio/serial_port.hpp"
+#include "lane_context.h"
+#include "lazy_instance.h"
 
 class LCD
 {
@@ -49,18 +52,14 @@ public:
     void operator=(const LCD&) = delete;
 
 private:
-    static LCD* lcd_;
+    static std::array<std::atomic<LCD*>, LaneContext::MAX_LANES> lcds_;
     static std::mutex mutex_;
     int lcdFd_;
     bool lcdInitialized_;
-    boost::asio::io_context ioContext_;
-    boost::asio::executor_work_guard<boost::asio::io_context::executor_type> workGuard_;
     boost::asio::strand<boost::asio::io_context::executor_type> strand_;
-    std::thread ioContextThread_;
     LCD();
     void FnLCDInitDriver();
     void FnLCDDeinitDriver();
-    void startIoContextThread();
     void sendCommandDataToDriver(int fd, char* data, bool value);
     void formatAndPostData(const char* raw_data, bool is_data);
     void clearDisplayLineWithPostData();
@@ -1,4 +1,5 @@
 #include "led.h"
+#include "io_executor.h"
 #include "log.h"
 #include "operation.h"
 
@@ -7,10 +8,8 @@ const char LED::ETX1 = 0x0D;
 const char LED::ETX2 = 0x0A;
 
 LED::LED(unsigned int baudRate, const std::string& comPortName, int maxCharacterPerRow)
-    : ioContext_(),
-    workGuard_(boost::asio::make_work_guard(ioContext_)),
-    strand_(boost::asio::make_strand(ioContext_)),
-    serialPort_(ioContext_),
+    : strand_(boost::asio::make_strand(IOExecutor::getInstance()->FnGetIOContext())),
+    serialPort_(strand_),
     baudRate_(baudRate),
     comPortName_(comPortName),
     maxCharPerRow_(maxCharacterPerRow)
@@ -44,8 +43,6 @@ LED::LED(unsigned int baudRate, const std::string& comPortName, int maxCharacter
         serialPort_.set_option(boost::asio::serial_port_base::stop_bits(boost::asio::serial_port_base::stop_bits::one));
         serialPort_.set_option(boost::asio::serial_port_base::character_size(8));
 
-        startIoContextThread();
-
         if (serialPort_.is_open())
         {
             std::stringstream ss;
@@ -93,24 +90,6 @@ LED::~LED()
         serialPort_.cancel(ec);
         serialPort_.close(ec);
     }
-
-    // Stop io_context and join the thread
-    workGuard_.reset();
-    ioContext_.stop();
-    if (ioContextThread_.joinable())
-    {
-        ioContextThread_.join();
-    }
-}
-
-void LED::startIoContextThread()
-{
-    Logger::getInstance()->FnLog(__func__, logFileName_, "LED");
-
-    if (!ioContextThread_.joinable())
-    {
-        ioContextThread_ = std::thread([this] { ioContext_.run(); });
-    }
 }
 
 unsigned int LED::FnGetLEDBaudRate() const
@@ -283,7 +262,7 @@ void LED::FnFormatDisplayMsg(const std::string& LedId, LED::Line lineNo, const s
 }
 
 // LED Manager
-LEDManager* LEDManager::ledManager_ = nullptr;
+std::array<std::atomic<LEDManager*>, LaneContext::MAX_LANES> LEDManager::ledManagers_ = {};
 std::mutex LEDManager::mutex_;
 
 LEDManager::LEDManager()
@@ -293,13 +272,7 @@ LEDManager::LEDManager()
 
 LEDManager* LEDManager::getInstance()
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (ledManager_ == nullptr)
-    {
-        ledManager_ = new LEDManager();
-    }
-
-    return ledManager_;
+    return LazyInstance::FnGet(ledManagers_[LaneContext::FnGetCurrentLane()], mutex_, []() { return new LEDManager(); });
 }
 
 void LEDManager::createLED(unsigned int baudRate, const std::string& comPortName, int maxCharacterPerRow)
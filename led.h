@@ -1,11 +1,14 @@
 #pragma once
 
+#include <array>
 #include <iostream>
 #include <string>
 #include <memory>
 #include <mutex>
 #include "boost/asio.hpp"
 #include "boost/asio/serial_port.hpp"
+#include "lane_context.h"
+#include "lazy_instance.h"
 
 class LED
 {
@@ -46,17 +49,13 @@ public:
     int FnGetLEDMaxCharPerRow() const;
 
 private:
-    boost::asio::io_context ioContext_;
-    boost::asio::executor_work_guard<boost::asio::io_context::executor_type> workGuard_;
     boost::asio::strand<boost::asio::io_context::executor_type> strand_;
-    std::thread ioContextThread_;
     boost::asio::serial_port serialPort_;
     unsigned int baudRate_;
     std::string comPortName_;
     int maxCharPerRow_;
     std::string logFileName_;
 
-    void startIoContextThread();
     void FnFormatDisplayMsg(const std::string& LedId, LED::Line lineNo, const std::string& text, LED::Alignment align, std::vector<char>& result);
 };
 
@@ -82,7 +81,7 @@ public:
     void operator=(const LEDManager&) = delete;
 
 private:
-    static LEDManager* ledManager_;
+    static std::array<std::atomic<LEDManager*>, LaneContext::MAX_LANES> ledManagers_;
     std::vector<std::unique_ptr<LED>> leds_;
     LEDManager();
 
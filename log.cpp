@@ -6,8 +6,9 @@
 #include "ini_parser.h"
 #include "operation.h"
 #include "log.h"
+#include "log_index.h"
 
-Logger* Logger::logger_ = nullptr;
+std::atomic<Logger*> Logger::logger_(nullptr);
 std::mutex Logger::mutex_;
 
 Logger::Logger()
@@ -23,12 +24,7 @@ Logger::~Logger()
 
 Logger* Logger::getInstance()
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (logger_ == nullptr)
-    {
-        logger_ = new Logger();
-    }
-    return logger_;
+    return LazyInstance::FnGet(logger_, mutex_, []() { return new Logger(); });
 }
 
 void Logger::FnCreateLogFile(std::string filename)
@@ -92,6 +88,7 @@ void Logger::FnCreateLogFile(std::string filename)
 void Logger::FnLog(std::string sMsg, std::string filename, std::string sOption)
 {
     std::stringstream sLogMsg;
+    std::string sIndexOption = sOption;
 
     sOption += ":";
     sLogMsg << Common::getInstance()->FnGetDateTime();
@@ -100,8 +97,8 @@ void Logger::FnLog(std::string sMsg, std::string filename, std::string sOption)
     sLogMsg << sMsg;
 
     // Check whether file exists or not, if not exists, then create a new file
-    // Temp: need to get the station_ID from file
-    std::string sStationID = IniParser::getInstance()->FnGetStationID();
+    // A published ini config is never freed, the reference stays valid across a reload
+    const std::string& sStationID = IniParser::getInstance()->FnGetStationID();
 
     time_t timer = time(0);
     struct tm timeinfo = {};
@@ -137,6 +134,7 @@ void Logger::FnLog(std::string sMsg, std::string filename, std::string sOption)
         {
             spdlog::drop(loggerNameExtra);
             FnCreateLogFile(filename);
+            LogIndex::getInstance()->FnResetFile(absoluteExtraFilePath);
         }
 
         auto extraLogger = spdlog::get(loggerNameExtra);
@@ -148,7 +146,12 @@ void Logger::FnLog(std::string sMsg, std::string filename, std::string sOption)
 
         if (extraLogger)
         {
-            extraLogger->info(sLogMsg.str());
+            {
+                // Index and queue under one lock, so the recorded offset matches the write order
+                std::lock_guard<std::mutex> lock(writeMutex_);
+                LogIndex::getInstance()->FnIndexRecord(absoluteExtraFilePath, dateStr, sIndexOption, timer, sLogMsg.str().size() + 1);
+                extraLogger->info(sLogMsg.str());
+            }
             extraLogger->flush();
 
             // Update active date
@@ -163,6 +166,7 @@ void Logger::FnLog(std::string sMsg, std::string filename, std::string sOption)
         {
             spdlog::drop(loggerNameMain);
             FnCreateLogFile();
+            LogIndex::getInstance()->FnResetFile(absoluteMainFilePath);
         }
 
         auto mainLogger = spdlog::get(loggerNameMain);
@@ -174,7 +178,12 @@ void Logger::FnLog(std::string sMsg, std::string filename, std::string sOption)
 
         if (mainLogger)
         {
-            mainLogger->info(sLogMsg.str());
+            {
+                // Index and queue under one lock, so the recorded offset matches the write order
+                std::lock_guard<std::mutex> lock(writeMutex_);
+                LogIndex::getInstance()->FnIndexRecord(absoluteMainFilePath, dateStr, sIndexOption, timer, sLogMsg.str().size() + 1);
+                mainLogger->info(sLogMsg.str());
+            }
             mainLogger->flush();
 
             // Update active date
@@ -10,6 +10,7 @@
 #include "spdlog/async.h"
 #include "spdlog/sinks/basic_file_sink.h"
 #include <unordered_map>
+#include "lazy_instance.h"
 
 
 class Logger
@@ -35,8 +36,9 @@ public:
     void operator=(const Logger &) = delete;
 
 private:
-    static Logger* logger_;
+    static std::atomic<Logger*> logger_;
     static std::mutex mutex_;
+    std::mutex writeMutex_;
     Logger();
     ~Logger();
     std::unordered_map<std::string, std::string> activeLoggerDates_; // loggerName -> date
@@ -0,0 +1,557 @@
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <boost/filesystem.hpp>
+#include "common.h"
+#include "log.h"
+#include "log_index.h"
+
+std::atomic<LogIndex*> LogIndex::logIndex_(nullptr);
+std::mutex LogIndex::mutex_;
+
+LogIndex::LogIndex()
+    : droppedRecords_(0)
+{
+    activeTransSlots_.fill(-1);
+}
+
+LogIndex* LogIndex::getInstance()
+{
+    return LazyInstance::FnGet(logIndex_, mutex_, []() { return new LogIndex(); });
+}
+
+int32_t& LogIndex::activeTransSlot()
+{
+    return activeTransSlots_[LaneContext::FnGetCurrentLane()];
+}
+
+void LogIndex::clearIndex()
+{
+    // Carry the lanes' active transactions over to the new day, so a vehicle crossing midnight stays searchable
+    std::array<TransactionEntry, LaneContext::MAX_LANES> activeTrans;
+    for (std::size_t lane = 0; lane < activeTransSlots_.size(); lane++)
+    {
+        if (activeTransSlots_[lane] >= 0)
+        {
+            activeTrans[lane].transID = transactions_[activeTransSlots_[lane]].transID;
+            activeTrans[lane].keys = transactions_[activeTransSlots_[lane]].keys;
+        }
+    }
+
+    files_.clear();
+    fileOffsets_.clear();
+    fileIds_.clear();
+    records_.clear();
+    transactions_.clear();
+    keyIndex_.clear();
+    droppedRecords_ = 0;
+
+    for (std::size_t lane = 0; lane < activeTransSlots_.size(); lane++)
+    {
+        if (activeTransSlots_[lane] < 0)
+        {
+            continue;
+        }
+
+        activeTransSlots_[lane] = static_cast<int32_t>(transactions_.size());
+        transactions_.push_back(activeTrans[lane]);
+        addKey(activeTrans[lane].transID, activeTransSlots_[lane]);
+        for (const auto& key : activeTrans[lane].keys)
+        {
+            addKey(key, activeTransSlots_[lane]);
+        }
+    }
+}
+
+uint16_t LogIndex::getFileId(const std::string& filePath)
+{
+    auto it = fileIds_.find(filePath);
+    if (it != fileIds_.end())
+    {
+        return it->second;
+    }
+
+    // File written before this process started, continue from its current end
+    uint64_t offset = 0;
+    boost::system::error_code ec;
+    if (boost::filesystem::exists(filePath, ec))
+    {
+        offset = boost::filesystem::file_size(filePath, ec);
+        if (ec)
+        {
+            offset = 0;
+        }
+    }
+
+    uint16_t fileId = static_cast<uint16_t>(files_.size());
+    files_.push_back(filePath);
+    fileOffsets_.push_back(offset);
+    fileIds_[filePath] = fileId;
+    return fileId;
+}
+
+uint8_t LogIndex::getOptionId(const std::string& option)
+{
+    auto it = optionIds_.find(option);
+    if (it != optionIds_.end())
+    {
+        return it->second;
+    }
+
+    uint8_t optionId = static_cast<uint8_t>(options_.size());
+    options_.push_back(option);
+    optionIds_[option] = optionId;
+    return optionId;
+}
+
+void LogIndex::addKey(const std::string& key, int32_t transSlot)
+{
+    if (key.empty())
+    {
+        return;
+    }
+
+    auto& slots = keyIndex_[key];
+    if (slots.empty() || slots.back() != transSlot)
+    {
+        slots.push_back(transSlot);
+    }
+}
+
+void LogIndex::FnIndexRecord(const std::string& filePath, const std::string& dateStr, const std::string& option, std::time_t timestamp, std::size_t length)
+{
+    std::lock_guard<std::mutex> lock(indexMutex_);
+
+    if (indexDate_ != dateStr)
+    {
+        indexDate_ = dateStr;
+        clearIndex();
+    }
+
+    uint16_t fileId = getFileId(filePath);
+    uint64_t offset = fileOffsets_[fileId];
+    fileOffsets_[fileId] += length;
+
+    if ((records_.size() >= MAX_RECORDS) || (options_.size() >= UINT8_MAX && optionIds_.find(option) == optionIds_.end()))
+    {
+        droppedRecords_++;
+        return;
+    }
+
+    LogRecordRef ref;
+    ref.offset = offset;
+    ref.length = static_cast<uint32_t>(length);
+    ref.fileId = fileId;
+    ref.optionId = getOptionId(option);
+    ref.transSlot = activeTransSlot();
+    ref.timestamp = timestamp;
+
+    uint32_t recordId = static_cast<uint32_t>(records_.size());
+    records_.push_back(ref);
+
+    if (ref.transSlot >= 0)
+    {
+        transactions_[ref.transSlot].records.push_back(recordId);
+    }
+}
+
+void LogIndex::FnResetFile(const std::string& filePath)
+{
+    std::lock_guard<std::mutex> lock(indexMutex_);
+
+    // Log file was removed and is being recreated, new records start from zero
+    auto it = fileIds_.find(filePath);
+    if (it != fileIds_.end())
+    {
+        fileOffsets_[it->second] = 0;
+    }
+}
+
+void LogIndex::FnBeginTransaction(const std::string& transID)
+{
+    std::lock_guard<std::mutex> lock(indexMutex_);
+
+    TransactionEntry trans;
+    trans.transID = transID;
+    transactions_.push_back(trans);
+    activeTransSlot() = static_cast<int32_t>(transactions_.size() - 1);
+    addKey(transID, activeTransSlot());
+}
+
+void LogIndex::FnTagTransaction(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock(indexMutex_);
+
+    int32_t transSlot = activeTransSlot();
+    if (transSlot < 0 || key.empty())
+    {
+        return;
+    }
+
+    auto& keys = transactions_[transSlot].keys;
+    if (std::find(keys.begin(), keys.end(), key) == keys.end())
+    {
+        keys.push_back(key);
+        addKey(key, transSlot);
+    }
+}
+
+void LogIndex::FnEndTransaction()
+{
+    std::lock_guard<std::mutex> lock(indexMutex_);
+
+    activeTransSlot() = -1;
+}
+
+std::size_t LogIndex::FnGetRecordCount()
+{
+    std::lock_guard<std::mutex> lock(indexMutex_);
+
+    return records_.size();
+}
+
+bool LogIndex::readRecord(std::ifstream& file, const LogRecordRef& ref, std::string& line)
+{
+    line.resize(ref.length);
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(ref.offset));
+    file.read(&line[0], ref.length);
+    if (file.gcount() != static_cast<std::streamsize>(ref.length))
+    {
+        // Record still queued in the async logger, or the file has been moved away
+        return false;
+    }
+    return true;
+}
+
+std::string LogIndex::FnQuery(const LogQuery& query, std::size_t& recordCount)
+{
+    std::vector<LogRecordRef> matches;
+    std::vector<std::string> files;
+
+    {
+        std::lock_guard<std::mutex> lock(indexMutex_);
+
+        std::vector<uint8_t> optionFilter;
+        for (const auto& option : query.options)
+        {
+            auto it = optionIds_.find(option);
+            if (it != optionIds_.end())
+            {
+                optionFilter.push_back(it->second);
+            }
+        }
+
+        auto isMatch = [&](const LogRecordRef& ref) {
+            if (query.fromTime != 0 && ref.timestamp < query.fromTime)
+            {
+                return false;
+            }
+            if (query.toTime != 0 && ref.timestamp > query.toTime)
+            {
+                return false;
+            }
+            if (!query.options.empty() && std::find(optionFilter.begin(), optionFilter.end(), ref.optionId) == optionFilter.end())
+            {
+                return false;
+            }
+            return true;
+        };
+
+        if (!query.transID.empty() || !query.key.empty())
+        {
+            std::vector<int32_t> slots;
+            bool first = true;
+            for (const auto& key : { query.transID, query.key })
+            {
+                if (key.empty())
+                {
+                    continue;
+                }
+
+                std::vector<int32_t> keySlots;
+                auto it = keyIndex_.find(key);
+                if (it != keyIndex_.end())
+                {
+                    keySlots = it->second;
+                }
+
+                if (first)
+                {
+                    slots = keySlots;
+                    first = false;
+                }
+                else
+                {
+                    std::vector<int32_t> common;
+                    std::set_intersection(slots.begin(), slots.end(), keySlots.begin(), keySlots.end(), std::back_inserter(common));
+                    slots.swap(common);
+                }
+            }
+
+            std::vector<uint32_t> recordIds;
+            for (int32_t slot : slots)
+            {
+                const auto& records = transactions_[slot].records;
+                recordIds.insert(recordIds.end(), records.begin(), records.end());
+            }
+            std::sort(recordIds.begin(), recordIds.end());
+
+            for (uint32_t recordId : recordIds)
+            {
+                if (matches.size() >= query.limit)
+                {
+                    break;
+                }
+                if (isMatch(records_[recordId]))
+                {
+                    matches.push_back(records_[recordId]);
+                }
+            }
+        }
+        else if (query.fromTime != 0 || query.toTime != 0)
+        {
+            // Records are appended in time order, so a time window is a binary search
+            auto it = std::lower_bound(records_.begin(), records_.end(), query.fromTime,
+                [](const LogRecordRef& ref, std::time_t t) { return ref.timestamp < t; });
+
+            for (; it != records_.end() && matches.size() < query.limit; ++it)
+            {
+                if (query.toTime != 0 && it->timestamp > query.toTime)
+                {
+                    break;
+                }
+                if (isMatch(*it))
+                {
+                    matches.push_back(*it);
+                }
+            }
+        }
+
+        files = files_;
+    }
+
+    // Read the records outside the index lock, logging carries on meanwhile
+    std::ostringstream oss;
+    std::unordered_map<uint16_t, std::unique_ptr<std::ifstream>> openFiles;
+    std::string line;
+    recordCount = 0;
+
+    for (const auto& ref : matches)
+    {
+        auto& file = openFiles[ref.fileId];
+        if (!file)
+        {
+            file.reset(new std::ifstream(files[ref.fileId], std::ios::in | std::ios::binary));
+        }
+
+        if (file->is_open() && readRecord(*file, ref, line))
+        {
+            oss << line;
+            recordCount++;
+        }
+    }
+
+    return oss.str();
+}
+
+std::string LogIndex::urlDecode(const std::string& str)
+{
+    std::string result;
+    result.reserve(str.size());
+
+    for (std::size_t i = 0; i < str.size(); i++)
+    {
+        if (str[i] == '%' && i + 2 < str.size() && std::isxdigit(static_cast<unsigned char>(str[i + 1])) && std::isxdigit(static_cast<unsigned char>(str[i + 2])))
+        {
+            result += static_cast<char>(std::stoi(str.substr(i + 1, 2), nullptr, 16));
+            i += 2;
+        }
+        else if (str[i] == '+')
+        {
+            result += ' ';
+        }
+        else
+        {
+            result += str[i];
+        }
+    }
+
+    return result;
+}
+
+std::time_t LogIndex::parseQueryTime(const std::string& str)
+{
+    // Format: yyyymmddhhmmss
+    if (str.size() != 14 || !Common::getInstance()->FnIsStringNumeric(str))
+    {
+        return 0;
+    }
+
+    std::tm timeinfo = {};
+    std::istringstream iss(str);
+    iss >> std::get_time(&timeinfo, "%Y%m%d%H%M%S");
+    if (iss.fail())
+    {
+        return 0;
+    }
+    timeinfo.tm_isdst = -1;
+
+    return std::mktime(&timeinfo);
+}
+
+boost::beast::http::response<boost::beast::http::string_body> LogIndex::handleQueryRequest(const boost::beast::http::request<boost::beast::http::string_body>& req)
+{
+    boost::beast::http::response<boost::beast::http::string_body> res{boost::beast::http::status::ok, req.version()};
+    res.set(boost::beast::http::field::server, "BOOST_BEAST_VERSION_STRING");
+    res.set(boost::beast::http::field::content_type, "text/plain");
+
+    std::string target(req.target().data(), req.target().size());
+    std::string path = target;
+    std::string queryString;
+    std::size_t pos = target.find('?');
+    if (pos != std::string::npos)
+    {
+        path = target.substr(0, pos);
+        queryString = target.substr(pos + 1);
+    }
+
+    if (req.method() != boost::beast::http::verb::get)
+    {
+        res.result(boost::beast::http::status::bad_request);
+        res.body() = "Method not allowed";
+    }
+    else if (path == "/log/query")
+    {
+        try
+        {
+            LogQuery query;
+            std::string limit;
+
+            for (const auto& param : Common::getInstance()->FnParseString(queryString, '&'))
+            {
+                std::size_t eq = param.find('=');
+                if (eq == std::string::npos)
+                {
+                    continue;
+                }
+
+                std::string name = param.substr(0, eq);
+                std::string value = urlDecode(param.substr(eq + 1));
+
+                if (name == "trans")
+                {
+                    query.transID = value;
+                }
+                else if (name == "key")
+                {
+                    query.key = value;
+                }
+                else if (name == "from")
+                {
+                    query.fromTime = parseQueryTime(value);
+                }
+                else if (name == "to")
+                {
+                    query.toTime = parseQueryTime(value);
+                }
+                else if (name == "opt")
+                {
+                    query.options = Common::getInstance()->FnParseString(value, ',');
+                }
+                else if (name == "limit")
+                {
+                    limit = value;
+                }
+            }
+
+            if (!limit.empty() && Common::getInstance()->FnIsStringNumeric(limit))
+            {
+                query.limit = std::min<std::size_t>(std::stoul(limit), MAX_QUERY_RECORDS);
+            }
+
+            if (query.transID.empty() && query.key.empty() && query.fromTime == 0 && query.toTime == 0)
+            {
+                res.result(boost::beast::http::status::bad_request);
+                res.body() = "Query requires trans, key, from or to";
+            }
+            else
+            {
+                auto start = std::chrono::steady_clock::now();
+                std::size_t recordCount = 0;
+                res.body() = FnQuery(query, recordCount);
+                auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+                res.set("X-Record-Count", std::to_string(recordCount));
+                res.set("X-Query-Time-Us", std::to_string(duration.count()));
+
+                std::ostringstream oss;
+                oss << "Log query => " << target << " , records: " << recordCount << " , time: " << duration.count() << "us";
+                Logger::getInstance()->FnLog(oss.str(), "", "OPR");
+            }
+        }
+        catch (const std::exception& e)
+        {
+            std::stringstream ss;
+            ss << __func__ << ", Exception: " << e.what();
+            Logger::getInstance()->FnLogExceptionError(ss.str());
+
+            res.result(boost::beast::http::status::bad_request);
+            res.body() = "Invalid query";
+        }
+    }
+    else if (path == "/log/stats")
+    {
+        std::ostringstream oss;
+        {
+            std::lock_guard<std::mutex> lock(indexMutex_);
+            oss << "date=" << indexDate_;
+            oss << ",records=" << records_.size();
+            oss << ",transactions=" << transactions_.size();
+            oss << ",keys=" << keyIndex_.size();
+            oss << ",files=" << files_.size();
+            oss << ",dropped=" << droppedRecords_;
+        }
+        res.body() = oss.str();
+    }
+    else
+    {
+        res.result(boost::beast::http::status::not_found);
+        res.body() = "Not Found";
+    }
+
+    res.prepare_payload();
+    return res;
+}
+
+void LogIndex::handleQueryServerFailure(const std::string& what)
+{
+    std::ostringstream oss;
+    oss << "Log query server error: " << what;
+    Logger::getInstance()->FnLog(oss.str(), "", "OPR");
+}
+
+void LogIndex::FnStartQueryServer(boost::asio::io_context& ioContext, unsigned short port)
+{
+    if (port == 0)
+    {
+        Logger::getInstance()->FnLog("Log query server disabled.", "", "OPR");
+        return;
+    }
+
+    try
+    {
+        queryServer_ = std::make_shared<HttpServer>(ioContext, boost::asio::ip::tcp::endpoint{boost::asio::ip::tcp::v4(), port},
+                        std::bind(&LogIndex::handleQueryServerFailure, this, std::placeholders::_1),
+                        std::bind(&LogIndex::handleQueryRequest, this, std::placeholders::_1));
+        queryServer_->run();
+
+        Logger::getInstance()->FnLog("Log query server listening on port " + std::to_string(port), "", "OPR");
+    }
+    catch (const std::exception& e)
+    {
+        std::stringstream ss;
+        ss << __func__ << ", Exception: " << e.what();
+        Logger::getInstance()->FnLogExceptionError(ss.str());
+    }
+}
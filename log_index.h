@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "http_server.h"
+#include "lane_context.h"
+#include "lazy_instance.h"
+
+class LogIndex
+{
+public:
+    static const std::size_t MAX_RECORDS = 500000;
+    static const std::size_t MAX_QUERY_RECORDS = 5000;
+
+    struct LogQuery
+    {
+        std::string transID;
+        std::string key;
+        std::time_t fromTime = 0;
+        std::time_t toTime = 0;
+        std::vector<std::string> options;
+        std::size_t limit = MAX_QUERY_RECORDS;
+    };
+
+    static LogIndex* getInstance();
+
+    // Called by Logger with its write lock held, so offsets follow the order records are queued to spdlog
+    void FnIndexRecord(const std::string& filePath, const std::string& dateStr, const std::string& option, std::time_t timestamp, std::size_t length);
+    void FnResetFile(const std::string& filePath);
+
+    // Transaction context of the calling lane, every record that lane logs while it is active is indexed under it
+    void FnBeginTransaction(const std::string& transID);
+    void FnTagTransaction(const std::string& key);
+    void FnEndTransaction();
+
+    std::string FnQuery(const LogQuery& query, std::size_t& recordCount);
+    std::size_t FnGetRecordCount();
+
+    void FnStartQueryServer(boost::asio::io_context& ioContext, unsigned short port);
+
+    /**
+     * Singleton LogIndex should not be cloneable.
+     */
+    LogIndex(LogIndex& logIndex) = delete;
+
+    /**
+     * Singleton LogIndex should not be assignable.
+     */
+    void operator=(const LogIndex&) = delete;
+
+private:
+    struct LogRecordRef
+    {
+        uint64_t offset;
+        uint32_t length;
+        uint16_t fileId;
+        uint8_t optionId;
+        int32_t transSlot;
+        std::time_t timestamp;
+    };
+
+    struct TransactionEntry
+    {
+        std::string transID;
+        std::vector<std::string> keys;
+        std::vector<uint32_t> records;
+    };
+
+    static std::atomic<LogIndex*> logIndex_;
+    static std::mutex mutex_;
+    std::mutex indexMutex_;
+    std::string indexDate_;
+    std::vector<std::string> files_;
+    std::vector<uint64_t> fileOffsets_;
+    std::unordered_map<std::string, uint16_t> fileIds_;
+    std::vector<std::string> options_;
+    std::unordered_map<std::string, uint8_t> optionIds_;
+    std::vector<LogRecordRef> records_;
+    std::vector<TransactionEntry> transactions_;
+    std::unordered_map<std::string, std::vector<int32_t>> keyIndex_;
+    std::array<int32_t, LaneContext::MAX_LANES> activeTransSlots_;
+    uint64_t droppedRecords_;
+    std::shared_ptr<HttpServer> queryServer_;
+    LogIndex();
+    void clearIndex();
+    int32_t& activeTransSlot();
+    uint16_t getFileId(const std::string& filePath);
+    uint8_t getOptionId(const std::string& option);
+    void addKey(const std::string& key, int32_t transSlot);
+    static bool readRecord(std::ifstream& file, const LogRecordRef& ref, std::string& line);
+    boost::beast::http::response<boost::beast::http::string_body> handleQueryRequest(const boost::beast::http::request<boost::beast::http::string_body>& req);
+    void handleQueryServerFailure(const std::string& what);
+    static std::string urlDecode(const std::string& str);
+    static std::time_t parseQueryTime(const std::string& str);
+};
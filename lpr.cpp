@@ -1,4 +1,5 @@
 #include "ini_parser.h"
+#include "io_executor.h"
 #include "lpr.h"
 #include "log.h"
 #include <boost/asio.hpp>
@@ -10,15 +11,14 @@
 #include "structuredata.h"
 #include "operation.h"
 
-Lpr* Lpr::lpr_ = nullptr;
+std::array<std::atomic<Lpr*>, LaneContext::MAX_LANES> Lpr::lprs_ = {};
 std::mutex Lpr::mutex_;
 
 Lpr::Lpr()
-    : ioContext_(),
-    strand_(boost::asio::make_strand(ioContext_)),
-    workGuard_(boost::asio::make_work_guard(ioContext_)),
-    periodicReconnectTimer_(ioContext_),
-    periodicReconnectTimer2_(ioContext_),
+    : laneId_(LaneContext::FnGetCurrentLane()),
+    strand_(boost::asio::make_strand(IOExecutor::getInstance()->FnGetIOContext())),
+    periodicReconnectTimer_(strand_),
+    periodicReconnectTimer2_(strand_),
     cameraNo_(0),
     lprIp4Front_(""),
     lprIp4Rear_(""),
@@ -37,13 +37,7 @@ Lpr::Lpr()
 
 Lpr* Lpr::getInstance()
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (lpr_ == nullptr)
-    {
-        lpr_ = new Lpr();
-    }
-
-    return lpr_;
+    return LazyInstance::FnGet(lprs_[LaneContext::FnGetCurrentLane()], mutex_, []() { return new Lpr(); });
 }
 
 void Lpr::FnLprInit()
@@ -60,13 +54,12 @@ void Lpr::FnLprInit()
         */
         reconnTime_ = 2000;
         reconnTime2_ = 2000;
-        commErrorTimeCriteria_ = std::stoi(IniParser::getInstance()->FnGetLPRErrorTime());
-        transErrorCountCriteria_ = std::stoi(IniParser::getInstance()->FnGetLPRErrorCount());
-        lprPort_ = std::stoi(IniParser::getInstance()->FnGetLPRPort());
+        commErrorTimeCriteria_ = IniParser::getInstance()->FnGetLPRErrorTime();
+        transErrorCountCriteria_ = IniParser::getInstance()->FnGetLPRErrorCount();
+        lprPort_ = IniParser::getInstance()->FnGetLPRPort();
 
         Logger::getInstance()->FnCreateLogFile(logFileName_);
 
-        startIoContextThread();
         initFrontCamera(lprIp4Front_, lprPort_, "CH1");
         initRearCamera(lprIp4Rear_, lprPort_, "CH1");
     }
@@ -84,16 +77,6 @@ void Lpr::FnLprInit()
     }
 }
 
-void Lpr::startIoContextThread()
-{
-    Logger::getInstance()->FnLog(__func__, logFileName_, "LPR");
-
-    if (!ioContextThread_.joinable())
-    {
-        ioContextThread_ = std::thread([this] { ioContext_.run(); });
-    }
-}
-
 void Lpr::FnLprClose()
 {
     Logger::getInstance()->FnLog(__func__, logFileName_, "LPR");
@@ -109,13 +92,6 @@ void Lpr::FnLprClose()
         pRearCamera_->close();
         pRearCamera_.reset();
     }
-
-    workGuard_.reset();
-    ioContext_.stop();
-    if (ioContextThread_.joinable())
-    {
-        ioContextThread_.join();
-    }
 }
 
 void Lpr::initFrontCamera(const std::string& cameraIP, int tcpPort, const std::string cameraCH)
@@ -139,11 +115,11 @@ void Lpr::initFrontCamera(const std::string& cameraIP, int tcpPort, const std::s
     try
     {
         frontCamCH_ = cameraCH;
-        pFrontCamera_ = std::make_unique<AppTcpClient>(ioContext_, cameraIP, tcpPort);
-        pFrontCamera_->setConnectHandler([this](bool success, const std::string& message) { handleFrontSocketConnect(success, message); });
-        pFrontCamera_->setCloseHandler([this](bool success, const std::string& message) { handleFrontSocketClose(success, message); });
-        pFrontCamera_->setReceiveHandler([this](bool success, const std::vector<uint8_t>& data) { handleReceiveFrontCameraData(success, data); });
-        pFrontCamera_->setSendHandler([this](bool success, const std::string& message) { handleFrontSocketSend(success, message); });
+        pFrontCamera_ = std::make_unique<AppTcpClient>(strand_, cameraIP, tcpPort);
+        pFrontCamera_->setConnectHandler(LaneContext::FnBind(laneId_, [this](bool success, const std::string& message) { handleFrontSocketConnect(success, message); }));
+        pFrontCamera_->setCloseHandler(LaneContext::FnBind(laneId_, [this](bool success, const std::string& message) { handleFrontSocketClose(success, message); }));
+        pFrontCamera_->setReceiveHandler(LaneContext::FnBind(laneId_, [this](bool success, const std::vector<uint8_t>& data) { handleReceiveFrontCameraData(success, data); }));
+        pFrontCamera_->setSendHandler(LaneContext::FnBind(laneId_, [this](bool success, const std::string& message) { handleFrontSocketSend(success, message); }));
         pFrontCamera_->connect();
 
         startReconnectTimer();
@@ -197,7 +173,7 @@ void Lpr::startReconnectTimer()
 {
     periodicReconnectTimer_.expires_after(std::chrono::milliseconds(reconnTime_));
     periodicReconnectTimer_.async_wait(boost::asio::bind_executor(strand_,
-        std::bind(&Lpr::handleReconnectTimerTimeout, this, std::placeholders::_1)));
+        LaneContext::FnBind(laneId_, std::bind(&Lpr::handleReconnectTimerTimeout, this, std::placeholders::_1))));
 }
 
 void Lpr::handleFrontSocketConnect(bool success, const std::string& message)
@@ -315,11 +291,11 @@ void Lpr::initRearCamera(const std::string& cameraIP, int tcpPort, const std::st
         try
         {
             rearCamCH_ = cameraCH;
-            pRearCamera_ = std::make_unique<AppTcpClient>(ioContext_, cameraIP, tcpPort);
-            pRearCamera_->setConnectHandler([this](bool success, const std::string& message) { handleRearSocketConnect(success, message); });
-            pRearCamera_->setCloseHandler([this](bool success, const std::string& message) { handleRearSocketClose(success, message); });
-            pRearCamera_->setReceiveHandler([this](bool success, const std::vector<uint8_t>& data) { handleReceiveRearCameraData(success, data); });
-            pRearCamera_->setSendHandler([this](bool success, const std::string& message) { handleRearSocketSend(success, message); });
+            pRearCamera_ = std::make_unique<AppTcpClient>(strand_, cameraIP, tcpPort);
+            pRearCamera_->setConnectHandler(LaneContext::FnBind(laneId_, [this](bool success, const std::string& message) { handleRearSocketConnect(success, message); }));
+            pRearCamera_->setCloseHandler(LaneContext::FnBind(laneId_, [this](bool success, const std::string& message) { handleRearSocketClose(success, message); }));
+            pRearCamera_->setReceiveHandler(LaneContext::FnBind(laneId_, [this](bool success, const std::vector<uint8_t>& data) { handleReceiveRearCameraData(success, data); }));
+            pRearCamera_->setSendHandler(LaneContext::FnBind(laneId_, [this](bool success, const std::string& message) { handleRearSocketSend(success, message); }));
             pRearCamera_->connect();
 
             startReconnectTimer2();
@@ -375,7 +351,7 @@ void Lpr::startReconnectTimer2()
 {
     periodicReconnectTimer2_.expires_after(std::chrono::milliseconds(reconnTime2_));
     periodicReconnectTimer2_.async_wait(boost::asio::bind_executor(strand_,
-        std::bind(&Lpr::handleReconnectTimer2Timeout, this, std::placeholders::_1)));
+        LaneContext::FnBind(laneId_, std::bind(&Lpr::handleReconnectTimer2Timeout, this, std::placeholders::_1))));
 }
 
 void Lpr::handleRearSocketConnect(bool success, const std::string& message)
@@ -755,8 +731,7 @@ void Lpr::extractLPRData(const std::string& tcpData, CType camType)
             data.TransID = TransID;
             data.imagePath = imagePath;
 
-            std::string serializedData = serializeEventData(data);
-            EventManager::getInstance()->FnEnqueueEvent("Evt_handleLPRReceive", serializedData);
+            EventManager::getInstance()->FnEnqueueEvent(EventID::LPR_RECEIVE, std::move(data));
 
             std::stringstream ss;
             ss << "Raise LPRReceive. LPN Not recognized. @ " << m_CType;
@@ -772,8 +747,7 @@ void Lpr::extractLPRData(const std::string& tcpData, CType camType)
             data.TransID = TransID;
             data.imagePath = imagePath;
 
-            std::string serializedData = serializeEventData(data);
-            EventManager::getInstance()->FnEnqueueEvent("Evt_handleLPRReceive", serializedData);
+            EventManager::getInstance()->FnEnqueueEvent(EventID::LPR_RECEIVE, std::move(data));
 
             Logger::getInstance()->FnLog("data.TransID : " + data.TransID);
 
@@ -803,8 +777,7 @@ void Lpr::extractLPRData(const std::string& tcpData, CType camType)
                     data.TransID = TransID;
                     data.imagePath = imagePath;
 
-                    std::string serializedData = serializeEventData(data);
-                    EventManager::getInstance()->FnEnqueueEvent("Evt_handleLPRReceive", serializedData);
+                    EventManager::getInstance()->FnEnqueueEvent(EventID::LPR_RECEIVE, std::move(data));
 
                     std::stringstream ss;
                     ss << "Raise LPRReceive. LPN Not recognized. @ " << m_CType;
@@ -820,8 +793,7 @@ void Lpr::extractLPRData(const std::string& tcpData, CType camType)
                     data.TransID = TransID;
                     data.imagePath = imagePath;
 
-                    std::string serializedData = serializeEventData(data);
-                    EventManager::getInstance()->FnEnqueueEvent("Evt_handleLPRReceive", serializedData);
+                    EventManager::getInstance()->FnEnqueueEvent(EventID::LPR_RECEIVE, std::move(data));
 
                     std::stringstream ss;
                     ss << "Raise LPRReceive. @ " << m_CType;
@@ -854,51 +826,4 @@ void Lpr::extractLPRData(const std::string& tcpData, CType camType)
             Logger::getInstance()->FnLog(ss.str(), logFileName_, "LPR");
         }
     }
-}
-
-std::string Lpr::serializeEventData(const LPREventData& eventData)
-{
-    std::stringstream ss;
-    ss << static_cast<int>(eventData.camType) << "," << eventData.LPN << "," << eventData.TransID << "," << eventData.imagePath;
-    return ss.str();
-}
-
-struct Lpr::LPREventData Lpr::deserializeEventData(const std::string& serializeData)
-{
-    struct LPREventData eventData{};
-
-    try
-    {
-        std::stringstream ss(serializeData);
-        std::string token;
-
-        std::getline(ss, token, ',');
-        int camTypeValue = std::stoi(token);
-        eventData.camType = static_cast<Lpr::CType>(camTypeValue);
-
-        std::getline(ss, token, ',');
-        eventData.LPN = token;
-
-        std::getline(ss, token, ',');
-        eventData.TransID = token;
-
-        std::getline(ss, token, ',');
-        eventData.imagePath = token;
-
-        return eventData;
-    }
-    catch (const std::exception& e)
-    {
-        std::stringstream ss;
-        ss << __func__ << ", Data: " << serializeData << ", Exception: " << e.what();
-        Logger::getInstance()->FnLogExceptionError(ss.str());
-        return {};
-    }
-    catch (...)
-    {
-        std::stringstream ss;
-        ss << __func__ << ", Data: " << serializeData << ", Exception: Unknown Exception";
-        Logger::getInstance()->FnLogExceptionError(ss.str());
-        return {};
-    }
 }
\ No newline at end of file
@@ -1,11 +1,14 @@
 #pragma once
 
+#include <array>
 #include <chrono>
 #include <iostream>
 #include <string>
 #include <memory>
 #include <mutex>
 #include "tcp_client.h"
+#include "lane_context.h"
+#include "lazy_instance.h"
 
 class Lpr
 {
@@ -28,7 +31,6 @@ public:
 
     void FnLprInit();
     void FnSendTransIDToLPR(const std::string& transID, bool useFrontCamera);
-    struct LPREventData deserializeEventData(const std::string& serializeData);
     void FnLprClose();
 
     /**
@@ -42,12 +44,10 @@ public:
     void operator=(const Lpr&) = delete;
 
 private:
-    static Lpr* lpr_;
+    static std::array<std::atomic<Lpr*>, LaneContext::MAX_LANES> lprs_;
     static std::mutex mutex_;
-    boost::asio::io_context ioContext_;
-    boost::asio::executor_work_guard<boost::asio::io_context::executor_type> workGuard_;
+    int laneId_;
     boost::asio::strand<boost::asio::io_context::executor_type> strand_;
-    std::thread ioContextThread_;
     int cameraNo_;
     std::string lprIp4Front_;
     std::string lprIp4Rear_;
@@ -69,7 +69,6 @@ private:
     bool lastFrontCameraConnected_;
     bool lastRearCameraConnected_;
     Lpr();
-    void startIoContextThread();
     void initFrontCamera(const std::string& cameraIP, int tcpPort, const std::string cameraCH);
     void initRearCamera(const std::string& cameraIP, int tcpPort, const std::string cameraCH);
     void startReconnectTimer();
@@ -92,5 +91,4 @@ private:
     std::string extractSTX(const std::string& sMsg);
     std::string extractETX(const std::string& sMsg);
     void extractLPRData(const std::string& tcpData, CType camType);
-    std::string serializeEventData(const struct LPREventData& eventData);
 };
\ No newline at end of file
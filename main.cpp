@@ -5,50 +5,48 @@
 #include <string>
 #include <thread>
 #include "boost/asio.hpp"
+#include "boost/bind/bind.hpp"
+#include "async_flow.h"
 #include "common.h"
 #include "dio.h"
+#include "dio_sequencer.h"
 #include "gpio.h"
 #include "ini_parser.h"
+#include "io_executor.h"
+#include "lane_context.h"
 #include "lcd.h"
 #include "led.h"
 #include "log.h"
+#include "log_index.h"
 #include "system_info.h"
 #include "event_manager.h"
 #include "event_handler.h"
 #include "db.h"
 #include "odbc.h"
 #include "structuredata.h"
+#include "offline_uploader.h"
 #include "operation.h"
+#include "paid_exit_cache.h"
 #include "udp.h"
 #include <filesystem>
 #include "touchngo_reader.h"
 #include "shutdown_manager.h"
 
 
-void dailyProcessTimerHandler(const boost::system::error_code &ec, boost::asio::steady_timer * timer, boost::asio::strand<boost::asio::io_context::executor_type>* strand_)
+// Periodic checks of one lane, returns true when it synced the time from PMS
+bool dailyProcessLane(int laneId, bool isTimeSyncDue, bool isCentralReachable)
 {
-    auto start = std::chrono::steady_clock::now(); // Measure the start time of the handler execution
-
-    // Print the start time in HH:MM:SS format
-    //auto startTime = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-    //std::cout << "Start Time: " << std::put_time(std::localtime(&startTime), "%T") << std::endl;
-
-    //Sync PMS time duration
-    static auto lastSyncTime = std::chrono::steady_clock::now();
-    auto durationSinceSync = std::chrono::duration_cast<std::chrono::hours>(start - lastSyncTime);
+    LaneContext::Scope laneScope(laneId);
+    bool isTimeSynced = false;
 
     //------ timer process start
     if (operation::getInstance()->FnIsOperationInitialized())
     {
         if (operation::getInstance()->tProcess.gbLoopApresent.load() == false) 
         {
-            std::string details;
-            if (operation::getInstance()->tProcess.giSystemOnline == 1)
+            if ((operation::getInstance()->tProcess.giSystemOnline == 1) && isCentralReachable)
             {
-                if (PingWithTimeOut(IniParser::getInstance()->FnGetCentralDBServer(), 1, details) == true)
-                {
-                    operation::getInstance()->tProcess.giSystemOnline = 0;
-                }
+                operation::getInstance()->tProcess.giSystemOnline = 0;
             }
 
             // DB OK
@@ -74,18 +72,18 @@ void dailyProcessTimerHandler(const boost::system::error_code &ec, boost::asio::
 
             if (operation::getInstance()->tProcess.giSystemOnline == 0 && operation::getInstance()->tProcess.glNoofOfflineData > 0)
             {
-                db::getInstance()->moveOfflineTransToCentral();
+                OfflineUploader::getInstance()->FnRequest("timer");
             }
 
-            // Sysnc time from PMS per hour
-            if (durationSinceSync >= std::chrono::hours(1))
+            // Sysnc time from PMS per hour, the local DB and clock are shared so the first lane does it
+            if (isTimeSyncDue && (laneId == LaneContext::DEFAULT_LANE))
             {
                 db::getInstance()->synccentraltime();
-                lastSyncTime = start;
+                isTimeSynced = true;
             }
 
             // Clear expired season
-            if (operation::getInstance()->tProcess.giLastHousekeepingDate != Common::getInstance()->FnGetCurrentDay())
+            if ((laneId == LaneContext::DEFAULT_LANE) && (operation::getInstance()->tProcess.giLastHousekeepingDate != Common::getInstance()->FnGetCurrentDay()))
             {
                 db::getInstance()->HouseKeeping();
                 operation::getInstance()->tProcess.giLastHousekeepingDate = Common::getInstance()->FnGetCurrentDay();
@@ -118,6 +116,36 @@ void dailyProcessTimerHandler(const boost::system::error_code &ec, boost::asio::
         }
     }
 
+    return isTimeSynced;
+}
+
+void dailyProcessTimerHandler(const boost::system::error_code &ec, boost::asio::steady_timer * timer, boost::asio::strand<boost::asio::io_context::executor_type>* strand_)
+{
+    auto start = std::chrono::steady_clock::now(); // Measure the start time of the handler execution
+
+    // Print the start time in HH:MM:SS format
+    //auto startTime = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    //std::cout << "Start Time: " << std::put_time(std::localtime(&startTime), "%T") << std::endl;
+
+    //Sync PMS time duration
+    static auto lastSyncTime = std::chrono::steady_clock::now();
+    auto durationSinceSync = std::chrono::duration_cast<std::chrono::hours>(start - lastSyncTime);
+
+    // One ping for every lane, it also keeps the central DB circuit breaker open while the server is unreachable
+    std::string details;
+    bool isCentralReachable = PingWithTimeOut(IniParser::getInstance()->FnGetCentralDBServer(), 1, details);
+    db::getInstance()->FnRecordCentralDBProbe(isCentralReachable);
+
+    bool isTimeSynced = false;
+    for (int laneId = 0; laneId < LaneContext::FnGetLaneCount(); laneId++)
+    {
+        isTimeSynced = dailyProcessLane(laneId, (durationSinceSync >= std::chrono::hours(1)), isCentralReachable) || isTimeSynced;
+    }
+    if (isTimeSynced)
+    {
+        lastSyncTime = start;
+    }
+
     //--------
     auto end = std::chrono::steady_clock::now(); // Measure the end time of the handler execution
 
@@ -137,6 +165,32 @@ void dailyLogHandler(const boost::system::error_code &ec, boost::asio::steady_ti
 {
     auto start = std::chrono::steady_clock::now(); // Measure the start time of the handler execution
 
+    // Event queue depth and latency per priority class
+    EventManager::getInstance()->FnLogEventQueueStats();
+    DIOSequencer::getInstance()->FnLogStats();
+    operation::getInstance()->FnSendDIOSequencerToMonitor();
+    uint64_t flows = 0;
+    for (int laneId = 0; laneId < LaneContext::FnGetLaneCount(); laneId++)
+    {
+        LaneContext::Scope laneScope(laneId, false);
+        AsyncFlow::getInstance()->FnLogStats();
+        flows += AsyncFlow::getInstance()->FnGetStats().flows;
+        OfflineUploader::getInstance()->FnLogStats();
+        if (operation::getInstance()->m_udp != nullptr)
+        {
+            operation::getInstance()->m_udp->FnLogSendStats("PMS lane " + std::to_string(laneId));
+        }
+        if (operation::getInstance()->m_Monitorudp != nullptr)
+        {
+            operation::getInstance()->m_Monitorudp->FnLogSendStats("Monitor lane " + std::to_string(laneId));
+        }
+    }
+    IOExecutor::getInstance()->FnLogStats(flows);
+    db::getInstance()->FnLogCentralDBStats();
+    db::getInstance()->FnLogTableSyncStats();
+    PaidExitCache::getInstance()->FnLogStats();
+    LaneContext::FnLogStats();
+
     // Get today's date
     auto today = std::chrono::system_clock::now();
     auto todayDate = std::chrono::system_clock::to_time_t(today);
@@ -571,7 +625,8 @@ void signalHandler(const boost::system::error_code& ec, int signal, boost::asio:
 int main (int agrc, char* argv[])
 {
     // Initialization
-    boost::asio::io_context ioContext;
+    // Shared by the main program and every device, sized from [setting] once the ini file is read
+    boost::asio::io_context& ioContext = IOExecutor::getInstance()->FnGetIOContext();
     auto workGuard = boost::asio::make_work_guard(ioContext);
 
     ShutdownManager::getInstance()->set(&ioContext, &workGuard);
@@ -594,9 +649,25 @@ int main (int agrc, char* argv[])
 
     Common::getInstance()->FnLogExecutableInfo(argv[0]);
     SystemInfo::getInstance()->FnLogSysInfo();
-    EventManager::getInstance()->FnRegisterEvent(std::bind(&EventHandler::FnHandleEvents, EventHandler::getInstance(), std::placeholders::_1, std::placeholders::_2));
+    EventHandler::getInstance()->FnRegisterEvents();
     EventManager::getInstance()->FnStartEventThread();
+    IOExecutor::getInstance()->FnStartBlockingThreads(IniParser::getInstance()->FnGetDBWorkerThreads(), IniParser::getInstance()->FnGetDBThreadCPUs());
+    uint64_t residentKB = LaneContext::FnGetResidentKB();
     operation::getInstance()->OperationInit(ioContext);
+    LaneContext::FnRecordLaneMemory(LaneContext::DEFAULT_LANE, residentKB);
+
+    // Further lanes read their overlay ini and start their own devices and flows on the shared executor
+    LaneContext::FnSetLaneCount(IniParser::getInstance()->FnGetLanes());
+    for (int laneId = 1; laneId < LaneContext::FnGetLaneCount(); laneId++)
+    {
+        LaneContext::Scope laneScope(laneId, false);
+        residentKB = LaneContext::FnGetResidentKB();
+        IniParser::getInstance()->FnReadIniFile();
+        operation::getInstance()->OperationInit(ioContext);
+        LaneContext::FnRecordLaneMemory(laneId, residentKB);
+    }
+    IniParser::FnStartWatching(ioContext);
+    LogIndex::getInstance()->FnStartQueryServer(ioContext, static_cast<unsigned short>(IniParser::getInstance()->FnGetLogQueryListenPort()));
 
     // Start daily process timer
     boost::asio::steady_timer dailyProcessTimer(strand_, boost::asio::chrono::seconds(1));
@@ -606,30 +677,21 @@ int main (int agrc, char* argv[])
     boost::asio::steady_timer dailyLogTimer(logStrand_, boost::asio::chrono::seconds(1));
     dailyLogTimer.async_wait(boost::bind(dailyLogHandler, boost::asio::placeholders::error, &dailyLogTimer, &logStrand_));
 
-    // Create a pool of threads to run the io_context
-    std::vector<std::thread> threadPool;
-    const int numThreads = 6;
-
-    for (int i = 0; i < numThreads; i++)
-    {
-        threadPool.emplace_back([&ioContext]() {
-            ioContext.run();
-        });
-    }
-
-    // Join all threads
-    for (auto& thread: threadPool)
-    {
-        if (thread.joinable())
-        {
-            thread.join();
-        }
-    }
+    // Run the shared io_context, returns once it is stopped
+    IOExecutor::getInstance()->FnRunIOThreads(IniParser::getInstance()->FnGetIOThreads(), IniParser::getInstance()->FnGetIOThreadCPUs());
 
     // Perform cleanup actions after all threads have joined
     EventManager::getInstance()->FnStopEventThread();
-    Lpr::getInstance()->FnLprClose();
-    TnG_Reader::getInstance()->FnTnGReaderClose();
+    // Every lane opened its own devices, each one closes them
+    for (int laneId = 0; laneId < LaneContext::FnGetLaneCount(); laneId++)
+    {
+        LaneContext::Scope laneScope(laneId, false);
+        DIO::getInstance()->FnStopDIOMonitoring();
+        Lpr::getInstance()->FnLprClose();
+        TnG_Reader::getInstance()->FnTnGReaderClose();
+    }
+    DIOSequencer::getInstance()->FnStopSequencer();
+    IOExecutor::getInstance()->FnStopBlockingThreads();
 
     return 0;
 }
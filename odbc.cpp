@@ -95,9 +95,37 @@ odbc::~odbc()
     SQLFreeHandle(SQL_HANDLE_ENV, env);    
 }
 
+void odbc::FnSetCircuitBreaker(std::shared_ptr<CircuitBreaker> breaker)
+{
+    breaker_ = std::move(breaker);
+}
+
+// Communication link failures (08xxx) and timeouts (HYT00/HYT01) say nothing about the statement
+bool odbc::isConnectionFault(const std::string& sqlState)
+{
+    return (sqlState.compare(0, 2, "08") == 0) || (sqlState.compare(0, 3, "HYT") == 0);
+}
+
 // connect to datasource
 
 int odbc::Connect()
+{
+    CircuitBreaker::Call call(breaker_.get());
+    if (!call.FnIsAllowed())
+    {
+        return -1;
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(connectionMutex_);
+    int ret = connect();
+    if (ret != 0)
+    {
+        call.FnSetFailed();
+    }
+    return ret;
+}
+
+int odbc::connect()
 {
     SQLRETURN ret; //return status
     SQLCHAR outstr[1024]; // output string
@@ -154,12 +182,19 @@ int odbc::Connect()
 
 	if (result) result->clear();
 
+    CircuitBreaker::Call call(breaker_.get());
+    if (!call.FnIsAllowed())
+    {
+        return -1;
+    }
+    std::lock_guard<std::recursive_mutex> lock(connectionMutex_);
+
     try
     {
         if (IsConnected()!=1)
         {
             Disconnect();
-            if (Connect() != 0) {return -1;}
+            if (connect() != 0) {call.FnSetFailed(); return -1;}
         }
 
         ret = SQLAllocHandle(SQL_HANDLE_STMT, dbc, &stmt); // allocate statement handle
@@ -172,7 +207,9 @@ int odbc::Connect()
 
         ret = SQLExecDirect(stmt, (SQLCHAR*)statement.c_str(), SQL_NTS);
         if (!SQL_SUCCEEDED(ret)) {
-          GetError("SQLExecDirect", stmt, SQL_HANDLE_STMT);
+          std::string sqlState;
+          GetError("SQLExecDirect", stmt, SQL_HANDLE_STMT, &sqlState);
+          if (isConnectionFault(sqlState)) call.FnSetFailed();
           SQLFreeHandle(SQL_HANDLE_STMT, stmt);
           return -1;
         }    
@@ -200,7 +237,9 @@ int odbc::Connect()
 
                 if (!(ret==SQL_SUCCESS||ret==SQL_SUCCESS_WITH_INFO))
                 {
-                  	GetError("SQLGetData", stmt, SQL_HANDLE_STMT);
+                  	std::string sqlState;
+                  	GetError("SQLGetData", stmt, SQL_HANDLE_STMT, &sqlState);
+                  	if (isConnectionFault(sqlState)) call.FnSetFailed();
 				  	SQLFreeStmt(stmt, SQL_CLOSE); // Clean up before exit
 				  	SQLFreeHandle(SQL_HANDLE_STMT, stmt);
                 	return -1;
@@ -249,20 +288,27 @@ int odbc::Connect()
     }
 }
 
-int odbc::SQLExecutNoneQuery(std::string statement)
+int odbc::SQLExecutNoneQuery(std::string statement, long *rowsAffected)
 {
     SQLSMALLINT columns; // number of columns
     SQLLEN rows; // number of rows
     int ret=-1;
-    NumberOfRowsAffected=0;
     SQLHSTMT stmt = SQL_NULL_HSTMT;
 
+  CircuitBreaker::Call call(breaker_.get());
+  if (!call.FnIsAllowed())
+  {
+      return ret;
+  }
+  std::lock_guard<std::recursive_mutex> lock(connectionMutex_);
+  NumberOfRowsAffected=0;
+
   try
   {
       if (IsConnected()!=1)
       {
           Disconnect();
-          if (Connect() != 0){return ret;}
+          if (connect() != 0){call.FnSetFailed(); return ret;}
       }
 
       ret = SQLAllocHandle(SQL_HANDLE_STMT, dbc, &stmt); // allocate statement handle
@@ -275,7 +321,9 @@ int odbc::SQLExecutNoneQuery(std::string statement)
 
       ret = SQLExecDirect(stmt, (SQLCHAR*)statement.c_str(), SQL_NTS);
       if (!SQL_SUCCEEDED(ret)) {
-        GetError("SQLExecDirect", stmt, SQL_HANDLE_STMT);
+        std::string sqlState;
+        GetError("SQLExecDirect", stmt, SQL_HANDLE_STMT, &sqlState);
+        if (isConnectionFault(sqlState)) call.FnSetFailed();
         SQLFreeHandle(SQL_HANDLE_STMT, stmt);
         return ret;
       }    
@@ -287,6 +335,7 @@ int odbc::SQLExecutNoneQuery(std::string statement)
       }
     // printf("Number of rows affected: %ld \n",(long int)rows);
       NumberOfRowsAffected=(long int)rows;
+      if (rowsAffected != nullptr) *rowsAffected = NumberOfRowsAffected;
       ret=0;
       
 	    SQLFreeStmt(stmt, SQL_CLOSE);
@@ -318,6 +367,7 @@ int odbc::SQLExecutNoneQuery(std::string statement)
 int odbc::Disconnect()
 {
     SQLRETURN ret; //return status
+    std::lock_guard<std::recursive_mutex> lock(connectionMutex_);
     try
     {
       SQLDisconnect(dbc); // disconnect    
@@ -339,7 +389,7 @@ int odbc::Disconnect()
     return 0;
 }
 
-std::vector<std::string> odbc::GetError(char const *fn,SQLHANDLE handle,SQLSMALLINT type)
+std::vector<std::string> odbc::GetError(char const *fn,SQLHANDLE handle,SQLSMALLINT type,std::string *sqlState)
 {
     SQLINTEGER   i = 0;
     SQLINTEGER   native;
@@ -363,6 +413,7 @@ std::vector<std::string> odbc::GetError(char const *fn,SQLHANDLE handle,SQLSMALL
         Logger::getInstance()->FnLog(ss.str(), "", "ODBC");
 
         emes.push_back((char*)text);
+        if ((sqlState != nullptr) && sqlState->empty()) *sqlState = (char *)state;
         }            
     } while( ret == SQL_SUCCESS );
     return emes;
@@ -380,6 +431,10 @@ int odbc::IsConnected()
 
 //  if (vPing(m_IP,pingTimeOut)==false) return -1;
 
+  // Seen as disconnected while the breaker is open, the caller's reconnect then fails at once
+  if ((breaker_ != nullptr) && breaker_->FnIsOpen()) return 0;
+  std::lock_guard<std::recursive_mutex> lock(connectionMutex_);
+
   ret = SQLGetConnectAttr(dbc,SQL_ATTR_CONNECTION_DEAD,(SQLPOINTER)&uIntVal,(SQLINTEGER) sizeof(uIntVal),NULL);
   if (!SQL_SUCCEEDED(ret)) {
     GetError("SQLGetConnectAttr(SQL_ATTR_CONNECTION_DEAD)", dbc, SQL_HANDLE_DBC);
@@ -413,6 +468,12 @@ int odbc::isValidSeason(const std::string & sSeasonNo,
     bool debugFlag=false;
     SQLHSTMT stmt = SQL_NULL_HSTMT;
 
+    CircuitBreaker::Call call(breaker_.get());
+    if (!call.FnIsAllowed())
+    {
+        return -1;
+    }
+    std::lock_guard<std::recursive_mutex> lock(connectionMutex_);
 
 try
 {
@@ -462,7 +523,7 @@ try
     if (IsConnected()!=1)
     {
         Disconnect();
-        if (Connect()!=0 ){return -1;} 
+        if (connect()!=0 ){call.FnSetFailed(); return -1;} 
     }
 
 
@@ -754,7 +815,9 @@ SQLSetStmtAttr(stmt, SQL_QUERY_TIMEOUT, (SQLPOINTER)(intptr_t) queryTimeOut, SQL
 
     if (!SQL_SUCCEEDED(nRet))
     {
-      GetError("SQLExecute(SQL_HANDLE_STMT)", stmt, SQL_HANDLE_STMT);
+      std::string sqlState;
+      GetError("SQLExecute(SQL_HANDLE_STMT)", stmt, SQL_HANDLE_STMT, &sqlState);
+      if (isConnectionFault(sqlState)) call.FnSetFailed();
       //exit(1);
       //throw(20);
       //goto exit;
@@ -5,9 +5,12 @@
 #include <sql.h>
 #include <sqlext.h>
 #include <string.h>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include "ce_time.h"
+#include "circuit_breaker.h"
 #include "ping.h"
 
 class ReaderItem
@@ -34,11 +37,15 @@ public:
 
 
   int SQLSelect(std::string statement, std::vector<ReaderItem> *result,bool FullResult);
-  int SQLExecutNoneQuery(std::string statement);
+  // rowsAffected, when given, receives the row count under the connection lock, NumberOfRowsAffected
+  // may already belong to another caller's statement by the time it is read
+  int SQLExecutNoneQuery(std::string statement, long *rowsAffected = nullptr);
   int Connect();
 
   int Disconnect();
   int IsConnected();
+  // Every call of this connection then goes through the breaker, while it is open they fail without a timeout
+  void FnSetCircuitBreaker(std::shared_ptr<CircuitBreaker> breaker);
   long NumberOfRowsAffected;
 
 
@@ -61,7 +68,14 @@ private:
   SQLHENV env; //environment handle
   SQLHDBC dbc; //connection handle
   //SQLHSTMT stmt; // statement handle
-  std::vector<std::string> GetError(char const *fn,SQLHANDLE handle,SQLSMALLINT type);
+  std::shared_ptr<CircuitBreaker> breaker_;
+  // FreeTDS runs one statement at a time per connection, every call holds the connection from
+  // connect to the last fetch. Recursive, the calls check and reconnect through each other.
+  std::recursive_mutex connectionMutex_;
+  // sqlState, when given, receives the SQLSTATE of the first diagnostic record
+  std::vector<std::string> GetError(char const *fn,SQLHANDLE handle,SQLSMALLINT type,std::string *sqlState = nullptr);
+  static bool isConnectionFault(const std::string& sqlState);
+  int connect();
   bool vPing(string IP,float timeOut);
 
 };
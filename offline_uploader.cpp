@@ -0,0 +1,461 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include "async_flow.h"
+#include "db.h"
+#include "ini_parser.h"
+#include "log.h"
+#include "offline_uploader.h"
+#include "operation.h"
+
+std::array<std::atomic<OfflineUploader*>, LaneContext::MAX_LANES> OfflineUploader::offlineUploaders_ = {};
+std::mutex OfflineUploader::mutex_;
+const std::string OfflineUploader::CURSOR_FILE_PATH = "/home/root/carpark/Upload";
+
+OfflineUploader::OfflineUploader()
+    : logFileName_("upload"),
+    laneId_(LaneContext::FnGetCurrentLane()),
+    isStarted_(false),
+    isRequestPending_(false),
+    progress_(),
+    isRunning_(false),
+    ctrl_(s_Entry),
+    consecutiveFailures_(0),
+    isCursorInserted_(false)
+{
+    progress_.etaSec = -1;
+}
+
+OfflineUploader* OfflineUploader::getInstance()
+{
+    return LazyInstance::FnGet(offlineUploaders_[LaneContext::FnGetCurrentLane()], mutex_, []() { return new OfflineUploader(); });
+}
+
+void OfflineUploader::FnStart(boost::asio::io_context& blockingContext, Reporter reporter)
+{
+    if (isStarted_.load())
+    {
+        return;
+    }
+
+    reporter_ = std::move(reporter);
+    strand_ = std::make_unique<boost::asio::strand<boost::asio::io_context::executor_type>>(boost::asio::make_strand(blockingContext));
+    timer_ = std::make_unique<boost::asio::steady_timer>(*strand_);
+    loadCursor();
+    isStarted_.store(true);
+
+    if (isRequestPending_.exchange(false))
+    {
+        FnRequest("pending");
+    }
+}
+
+void OfflineUploader::FnRequest(const std::string& reason)
+{
+    if (!isStarted_.load())
+    {
+        isRequestPending_.store(true);
+        return;
+    }
+
+    boost::asio::post(*strand_, LaneContext::FnBind(laneId_, [this, reason]()
+    {
+        if (isRunning_)
+        {
+            return;
+        }
+
+        try
+        {
+            startRun(reason);
+        }
+        catch (const std::exception& e)
+        {
+            std::stringstream ss;
+            ss << __func__ << ", Exception: " << e.what();
+            Logger::getInstance()->FnLogExceptionError(ss.str());
+        }
+        catch (...)
+        {
+            std::stringstream ss;
+            ss << __func__ << ", Exception: Unknown Exception";
+            Logger::getInstance()->FnLogExceptionError(ss.str());
+        }
+    }));
+}
+
+OfflineUploader::Progress OfflineUploader::FnGetProgress() const
+{
+    std::lock_guard<std::mutex> lock(progressMutex_);
+    return progress_;
+}
+
+void OfflineUploader::FnLogStats()
+{
+    Progress progress = FnGetProgress();
+    if ((progress.uploaded == 0) && !progress.isRunning)
+    {
+        return;
+    }
+
+    std::stringstream ss;
+    ss << "Lane " << laneId_ << " offline upload => uploaded: " << progress.uploaded;
+    ss << ", resumed: " << progress.resumed << ", yields: " << progress.yields;
+    if (progress.isRunning)
+    {
+        ss << ", running: " << progress.done << "/" << progress.total;
+    }
+    Logger::getInstance()->FnLog(ss.str(), logFileName_, "UPLD");
+}
+
+void OfflineUploader::startRun(const std::string& reason)
+{
+    operation* op = operation::getInstance();
+    if (op->gtStation.iType == tientry)
+    {
+        ctrl_ = s_Entry;
+    }
+    else if (op->gtStation.iType == tiExit)
+    {
+        ctrl_ = s_Exit;
+    }
+    else
+    {
+        return;
+    }
+
+    // The local DB is shared, with several lanes each one only uploads its own station's rows
+    stationID_ = (LaneContext::FnGetLaneCount() > 1) ? std::to_string(op->gtStation.iSID) : "";
+
+    int count = db::getInstance()->CountOfflineTrans(ctrl_, stationID_);
+    if (count < 0)
+    {
+        op->writelog("move offline data fail.", "DB");
+        return;
+    }
+
+    op->tProcess.glNoofOfflineData = count;
+    op->tProcess.offline_status = (count > 0) ? 1 : 0;
+    if (count == 0)
+    {
+        return;
+    }
+
+    isRunning_ = true;
+    consecutiveFailures_ = 0;
+    entries_.clear();
+    exits_.clear();
+    runStartTime_ = std::chrono::steady_clock::now();
+    lastReportTime_ = runStartTime_;
+    {
+        std::lock_guard<std::mutex> lock(progressMutex_);
+        progress_.isRunning = true;
+        progress_.done = 0;
+        progress_.total = static_cast<uint64_t>(count);
+        progress_.rowsPerSec = 0;
+        progress_.etaSec = -1;
+    }
+
+    std::string table = (ctrl_ == s_Entry) ? "Entry" : "Exit";
+    op->writelog("Total " + std::to_string(count) + " " + table + " trans to be upload (" + reason + ").", "DB");
+    report("started");
+    scheduleNext(0);
+}
+
+void OfflineUploader::finishRun(const std::string& state)
+{
+    isRunning_ = false;
+    entries_.clear();
+    exits_.clear();
+
+    // Rows saved during the run are counted too
+    operation* op = operation::getInstance();
+    int remaining = db::getInstance()->CountOfflineTrans(ctrl_, stationID_);
+    if (remaining >= 0)
+    {
+        op->tProcess.glNoofOfflineData = remaining;
+        op->tProcess.offline_status = (remaining > 0) ? 1 : 0;
+    }
+
+    Progress progress;
+    {
+        std::lock_guard<std::mutex> lock(progressMutex_);
+        progress_.isRunning = false;
+        progress_.etaSec = (remaining == 0) ? 0 : -1;
+        progress = progress_;
+    }
+
+    op->writelog("uploading trans Records: End, " + state + ", " + std::to_string(progress.done) + " uploaded, " + std::to_string(remaining) + " left", "DB");
+    report(state);
+}
+
+void OfflineUploader::scheduleNext(int delayMs)
+{
+    timer_->expires_after(std::chrono::milliseconds(delayMs));
+    timer_->async_wait(boost::asio::bind_executor(*strand_, LaneContext::FnBind(laneId_, [this](const boost::system::error_code& ec)
+    {
+        if (ec)
+        {
+            return;
+        }
+
+        try
+        {
+            uploadNext();
+        }
+        catch (const std::exception& e)
+        {
+            std::stringstream ss;
+            ss << __func__ << ", Exception: " << e.what();
+            Logger::getInstance()->FnLogExceptionError(ss.str());
+            finishRun("failed");
+        }
+        catch (...)
+        {
+            std::stringstream ss;
+            ss << __func__ << ", Exception: Unknown Exception";
+            Logger::getInstance()->FnLogExceptionError(ss.str());
+            finishRun("failed");
+        }
+    })));
+}
+
+void OfflineUploader::uploadNext()
+{
+    // A vehicle at any lane goes first, the central link and the DB pool are shared
+    if (AsyncFlow::FnIsAnyFlowRunning())
+    {
+        {
+            std::lock_guard<std::mutex> lock(progressMutex_);
+            progress_.yields++;
+        }
+        scheduleNext(YIELD_MS);
+        return;
+    }
+
+    if (entries_.empty() && exits_.empty())
+    {
+        bool isEmpty = false;
+        if (!fetchBatch(isEmpty))
+        {
+            finishRun("local db failed");
+            return;
+        }
+        if (isEmpty)
+        {
+            finishRun("done");
+            return;
+        }
+    }
+
+    std::size_t sentBytes = 0;
+    bool isUploaded = (ctrl_ == s_Entry) ? uploadEntry(entries_.front(), sentBytes) : uploadExit(exits_.front(), sentBytes);
+
+    if (ctrl_ == s_Entry)
+    {
+        entries_.pop_front();
+    }
+    else
+    {
+        exits_.pop_front();
+    }
+
+    if (!isUploaded)
+    {
+        // One bad row stays behind for the next run, a run of them means a DB is down. What is left waits
+        // for the next request, the daily process timer asks again while rows are left.
+        if (++consecutiveFailures_ >= MAX_CONSECUTIVE_FAILURES)
+        {
+            finishRun("stopped");
+        }
+        else
+        {
+            scheduleNext(throttleMs(sentBytes));
+        }
+        return;
+    }
+    consecutiveFailures_ = 0;
+
+    auto now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(progressMutex_);
+        progress_.done++;
+        progress_.uploaded++;
+        double elapsedSec = std::chrono::duration<double>(now - runStartTime_).count();
+        progress_.rowsPerSec = (elapsedSec > 0) ? (progress_.done / elapsedSec) : 0;
+        uint64_t left = (progress_.total > progress_.done) ? (progress_.total - progress_.done) : 0;
+        progress_.etaSec = (progress_.rowsPerSec > 0) ? static_cast<int64_t>(left / progress_.rowsPerSec) : -1;
+    }
+
+    if (now - lastReportTime_ >= std::chrono::seconds(PROGRESS_INTERVAL_SEC))
+    {
+        lastReportTime_ = now;
+        report("uploading");
+    }
+
+    scheduleNext(throttleMs(sentBytes));
+}
+
+bool OfflineUploader::fetchBatch(bool& isEmpty)
+{
+    int r;
+    if (ctrl_ == s_Entry)
+    {
+        std::vector<tEntryTrans_Struct> trans;
+        r = db::getInstance()->FetchOfflineEntryTrans(stationID_, BATCH_ROWS, trans);
+        entries_.assign(trans.begin(), trans.end());
+    }
+    else
+    {
+        std::vector<tExitTrans_Struct> trans;
+        r = db::getInstance()->FetchOfflineExitTrans(stationID_, BATCH_ROWS, trans);
+        exits_.assign(trans.begin(), trans.end());
+    }
+
+    isEmpty = entries_.empty() && exits_.empty();
+    return (r == 0);
+}
+
+bool OfflineUploader::uploadEntry(const tEntryTrans_Struct& ter, std::size_t& sentBytes)
+{
+    std::string key = "Entry_Trans|" + ter.esid + "|" + ter.sEntryTime + "|" + ter.sIUTKNo;
+
+    if ((key == cursorKey_) && isCursorInserted_)
+    {
+        std::lock_guard<std::mutex> lock(progressMutex_);
+        progress_.resumed++;
+    }
+    else
+    {
+        if (db::getInstance()->insertTransToCentralEntryTransTmp(ter, &sentBytes) != 0)
+        {
+            return false;
+        }
+        saveCursor(key, true);
+    }
+
+    if (db::getInstance()->deleteLocalTrans(ter.sIUTKNo, ter.sEntryTime, s_Entry) != 0)
+    {
+        return false;
+    }
+    saveCursor(key, false);
+    return true;
+}
+
+bool OfflineUploader::uploadExit(tExitTrans_Struct tex, std::size_t& sentBytes)
+{
+    std::string key = "Exit_Trans|" + tex.xsid + "|" + tex.sExitTime + "|" + tex.sIUNo;
+
+    if ((key == cursorKey_) && isCursorInserted_)
+    {
+        std::lock_guard<std::mutex> lock(progressMutex_);
+        progress_.resumed++;
+    }
+    else
+    {
+        if (db::getInstance()->insertTransToCentralExitTransTmp(tex, &sentBytes) != 0)
+        {
+            return false;
+        }
+        saveCursor(key, true);
+    }
+
+    // Deletes before it inserts, so a repeat after a crash leaves one movement record
+    db::getInstance()->DeleteBeforeInsertMT(tex);
+    db::getInstance()->insert2movementtrans(tex);
+
+    if (db::getInstance()->deleteLocalTrans(tex.sIUNo, tex.sExitTime, s_Exit) != 0)
+    {
+        return false;
+    }
+    saveCursor(key, false);
+    return true;
+}
+
+// Read on every row, a reload of the ini changes the rate of a running upload
+int OfflineUploader::throttleMs(std::size_t sentBytes) const
+{
+    int rowsPerSec = IniParser::getInstance()->FnGetUploadRowsPerSec();
+    int kBytesPerSec = IniParser::getInstance()->FnGetUploadKBytesPerSec();
+
+    int delayMs = (rowsPerSec > 0) ? (1000 / rowsPerSec) : 0;
+    if (kBytesPerSec > 0)
+    {
+        delayMs = std::max(delayMs, static_cast<int>(sentBytes * 1000 / (static_cast<std::size_t>(kBytesPerSec) * 1024)));
+    }
+    return delayMs;
+}
+
+void OfflineUploader::report(const std::string& state)
+{
+    if (!reporter_)
+    {
+        return;
+    }
+
+    Progress progress = FnGetProgress();
+    std::stringstream ss;
+    ss << state << "," << progress.done << "," << progress.total;
+    ss << "," << std::fixed << std::setprecision(1) << progress.rowsPerSec << "," << progress.etaSec;
+    reporter_(ss.str());
+}
+
+std::string OfflineUploader::getCursorFilePath() const
+{
+    return CURSOR_FILE_PATH + "/offline_lane" + std::to_string(laneId_) + ".cursor";
+}
+
+// One line: the row key, a tab, and I when its central insert is done but the local row not yet deleted
+void OfflineUploader::loadCursor()
+{
+    std::ifstream file(getCursorFilePath());
+    std::string line;
+    if (!file || !std::getline(file, line))
+    {
+        return;
+    }
+
+    std::size_t separator = line.rfind('\t');
+    if (separator == std::string::npos)
+    {
+        return;
+    }
+
+    cursorKey_ = line.substr(0, separator);
+    isCursorInserted_ = (line.substr(separator + 1) == "I");
+    if (isCursorInserted_)
+    {
+        Logger::getInstance()->FnLog("Lane " + std::to_string(laneId_) + " resumes the offline upload at " + cursorKey_, logFileName_, "UPLD");
+    }
+}
+
+void OfflineUploader::saveCursor(const std::string& key, bool isInserted)
+{
+    cursorKey_ = key;
+    isCursorInserted_ = isInserted;
+
+    std::string path = getCursorFilePath();
+    std::string tempPath = path + ".tmp";
+    std::error_code ec;
+    std::filesystem::create_directories(CURSOR_FILE_PATH, ec);
+    {
+        std::ofstream file(tempPath, std::ios::trunc);
+        file << key << "\t" << (isInserted ? "I" : "D") << "\n";
+        file.flush();
+        if (!file)
+        {
+            Logger::getInstance()->FnLog("Unable to write " + tempPath, logFileName_, "UPLD");
+            return;
+        }
+    }
+
+    // Renamed over the cursor, a crash never leaves half a line behind
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0)
+    {
+        Logger::getInstance()->FnLog("Unable to rename " + tempPath, logFileName_, "UPLD");
+        std::remove(tempPath.c_str());
+    }
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "boost/asio.hpp"
+#include "lane_context.h"
+#include "lazy_instance.h"
+#include "structuredata.h"
+
+// Uploads the transactions a lane saved locally while the central DB was unreachable, oldest first, on a
+// strand of the blocking pool so the backlog after an outage never holds up the lane's timers or flows.
+// One row at a time within UploadRowsPerSec and UploadKBytesPerSec, none while any lane is in a transaction.
+// A cursor file records the row whose central insert went through, so after a crash or restart that row is
+// only deleted locally; the central inserts also skip a row the central DB already has.
+class OfflineUploader
+{
+public:
+    static const int BATCH_ROWS = 20;
+    static const int YIELD_MS = 200;
+    static const int MAX_CONSECUTIVE_FAILURES = 3;
+    static const int PROGRESS_INTERVAL_SEC = 5;
+    static const std::string CURSOR_FILE_PATH;
+
+    struct Progress
+    {
+        bool isRunning;
+        uint64_t done;          // rows of the current or last run
+        uint64_t total;         // rows found when the run started
+        uint64_t uploaded;      // since start up
+        uint64_t resumed;       // rows found inserted but not deleted by an earlier run
+        uint64_t yields;
+        double rowsPerSec;
+        int64_t etaSec;         // -1 when not known yet
+    };
+
+    // "320" to the monitor: state,done,total,rows per second,eta in seconds
+    using Reporter = std::function<void(const std::string& data)>;
+
+    static OfflineUploader* getInstance();
+
+    void FnStart(boost::asio::io_context& blockingContext, Reporter reporter);
+    // Upload what the local table holds, a request during a run is served by that run. Safe from any thread.
+    void FnRequest(const std::string& reason);
+    Progress FnGetProgress() const;
+    void FnLogStats();
+
+    /**
+     * Singleton OfflineUploader should not be cloneable.
+     */
+    OfflineUploader(OfflineUploader& offlineUploader) = delete;
+
+    /**
+     * Singleton OfflineUploader should not be assignable.
+     */
+    void operator=(const OfflineUploader&) = delete;
+
+private:
+    static std::array<std::atomic<OfflineUploader*>, LaneContext::MAX_LANES> offlineUploaders_;
+    static std::mutex mutex_;
+    mutable std::mutex progressMutex_;
+    std::string logFileName_;
+    int laneId_;
+    std::atomic<bool> isStarted_;
+    std::atomic<bool> isRequestPending_;
+    Reporter reporter_;
+    std::unique_ptr<boost::asio::strand<boost::asio::io_context::executor_type>> strand_;
+    std::unique_ptr<boost::asio::steady_timer> timer_;
+    Progress progress_;
+    // Only used on the strand
+    bool isRunning_;
+    Ctrl_Type ctrl_;
+    int consecutiveFailures_;
+    std::string stationID_;
+    std::deque<tEntryTrans_Struct> entries_;
+    std::deque<tExitTrans_Struct> exits_;
+    std::string cursorKey_;
+    bool isCursorInserted_;
+    std::chrono::steady_clock::time_point runStartTime_;
+    std::chrono::steady_clock::time_point lastReportTime_;
+    OfflineUploader();
+    void startRun(const std::string& reason);
+    void finishRun(const std::string& state);
+    void scheduleNext(int delayMs);
+    void uploadNext();
+    bool fetchBatch(bool& isEmpty);
+    bool uploadEntry(const tEntryTrans_Struct& ter, std::size_t& sentBytes);
+    bool uploadExit(tExitTrans_Struct tex, std::size_t& sentBytes);
+    int throttleMs(std::size_t sentBytes) const;
+    void report(const std::string& state);
+    std::string getCursorFilePath() const;
+    void loadCursor();
+    void saveCursor(const std::string& key, bool isInserted);
+};
@@ -1,5 +1,6 @@
 
 #include <sys/mount.h>
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <memory>
@@ -11,29 +12,95 @@
 #include <functional>
 #include <cstdio>
 #include <cctype>
+#include <climits>
 #include <cmath>
 #include <map>
+#include "async_flow.h"
+#include "boot_sequence.h"
 #include "common.h"
+#include "config_snapshot.h"
 #include "gpio.h"
+#include "io_executor.h"
 #include "operation.h"
 #include "ini_parser.h"
+#include "lane_context.h"
 #include "structuredata.h"
 #include "db.h"
 #include "led.h"
 #include "lcd.h"
 #include "log.h"
+#include "log_index.h"
+#include "offline_uploader.h"
+#include "paid_exit_cache.h"
+#include "station_status.h"
+#include "vehicle_classifier.h"
 #include "udp.h"
 #include "dio.h"
+#include "dio_sequencer.h"
 #include "lpr.h"
 #include "barcode_reader.h"
 #include "boost/algorithm/string.hpp"
 #include "touchngo_reader.h"
 
-operation* operation::operation_ = nullptr;
+std::array<std::atomic<operation*>, LaneContext::MAX_LANES> operation::operations_ = {};
 std::mutex operation::mutex_;
 
+namespace
+{
+    // Results of the lookups an entry/exit flow runs together
+    struct FlowLookup
+    {
+        int iBlackList = -1;
+        int iEntry = -1;
+        int iSeason = 8;
+    };
+
+    // The local answer a flow decided with and the central answer that came after it, compared once both are in
+    template <typename T>
+    struct LateLookup
+    {
+        std::function<void(const T& decided, const T& late)> compare;
+        bool hasDecided = false;
+        bool hasLate = false;
+        T decided;
+        T late;
+
+        void FnSetDecided(const T& value)
+        {
+            decided = value;
+            hasDecided = true;
+            check();
+        }
+
+        void FnSetLate(const T& value)
+        {
+            late = value;
+            hasLate = true;
+            check();
+        }
+
+        void check()
+        {
+            if (hasDecided && hasLate && compare)
+            {
+                compare(decided, late);
+            }
+        }
+    };
+
+    // Snapshots the monitor only needs the latest of: status, date time, LED mirror
+    UdpSendClass monitorSendClass(const std::string& cmdcode)
+    {
+        if ((cmdcode == "300") || (cmdcode == "304") || (cmdcode == "306"))
+        {
+            return UdpSendClass::Status;
+        }
+        return UdpSendClass::Event;
+    }
+}
+
 operation::operation()
-    : m_db(nullptr), m_udp(nullptr), m_Monitorudp(nullptr)
+    : m_db(nullptr), m_udp(nullptr), m_Monitorudp(nullptr), laneId_(LaneContext::FnGetCurrentLane()), isConfigFromSnapshot_(false), dbStepTimeoutMs_(1500), dbSaveTimeoutMs_(2000), decisionBudgetMs_(0), localLookupMs_(200)
 {
     isOperationInitialized_.store(false);
     lastLEDMsg_ = "";
@@ -43,12 +110,7 @@ operation::operation()
 
 operation* operation::getInstance()
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (operation_ == nullptr)
-    {
-        operation_ = new operation();
-    }
-    return operation_;
+    return LazyInstance::FnGet(operations_[LaneContext::FnGetCurrentLane()], mutex_, []() { return new operation(); });
 }
 
 void operation::OperationInit(io_context& ioContext)
@@ -60,14 +122,20 @@ void operation::OperationInit(io_context& ioContext)
     tParas.gsCentralDBServer = IniParser::getInstance()->FnGetCentralDBServer();
     //
     iCurrentContext = &ioContext;
+    //--- entry/exit flows, DB steps run on the executor's blocking pool
+    dbStepTimeoutMs_ = IniParser::getInstance()->FnGetDBStepTimeoutMs();
+    dbSaveTimeoutMs_ = IniParser::getInstance()->FnGetDBSaveTimeoutMs();
+    decisionBudgetMs_ = IniParser::getInstance()->FnGetDecisionBudgetMs();
+    localLookupMs_ = IniParser::getInstance()->FnGetLocalLookupMs();
+    AsyncFlow::getInstance()->FnInit(ioContext, IOExecutor::getInstance()->FnGetBlockingContext());
     //--- broad cast UDP
     tProcess.gsBroadCastIP = getIPAddress();
     if (!tProcess.gsBroadCastIP.empty())
     {
         try
         {
-            unsigned short remoteUDPPort_ = static_cast<unsigned short>(std::stoi(IniParser::getInstance()->FnGetRemoteUDPPort()));
-            unsigned short localUDPPort_ = static_cast<unsigned short>(std::stoi(IniParser::getInstance()->FnGetLocalUDPPort()));
+            unsigned short remoteUDPPort_ = static_cast<unsigned short>(IniParser::getInstance()->FnGetRemoteUDPPort());
+            unsigned short localUDPPort_ = static_cast<unsigned short>(IniParser::getInstance()->FnGetLocalUDPPort());
             m_udp = new udpclient(ioContext, tProcess.gsBroadCastIP, remoteUDPPort_, localUDPPort_, true);
         }
         catch (const boost::system::system_error& e) // Catch Boost.Asio system errors
@@ -84,10 +152,18 @@ void operation::OperationInit(io_context& ioContext)
             writelog ("Unknown Exception during PMS UDP initialization.","OPR");
         }
 
-        // monitor UDP
+        // monitor UDP, the port is the controller's, further lanes send through the first lane's client
         try
         {
-            m_Monitorudp = new udpclient(ioContext, tParas.gsCentralDBServer, 2008,2008);
+            if (laneId_ == LaneContext::DEFAULT_LANE)
+            {
+                m_Monitorudp = new udpclient(ioContext, tParas.gsCentralDBServer, 2008,2008);
+            }
+            else
+            {
+                LaneContext::Scope defaultLane(LaneContext::DEFAULT_LANE, false);
+                m_Monitorudp = operation::getInstance()->m_Monitorudp;
+            }
         }
         catch (const boost::system::system_error& e) // Catch Boost.Asio system errors
         {
@@ -103,37 +179,71 @@ void operation::OperationInit(io_context& ioContext)
             writelog ("Unknown Exception during Monitor UDP initialization.","OPR");
         }
     }
+    //--- monitor status as versioned deltas of one model, instead of the separate 302/304/306 messages
+    if (IniParser::getInstance()->FnGetMonitorStatusDelta())
+    {
+        StationStatus::getInstance()->FnStart(ioContext, [this](StationStatusModel& model)
+        {
+            for (int i = 0; (i < Errsize) && (i < StationStatusModel::MAX_ERRORS); i++)
+            {
+                model.errors[i] = tPBSError[i].ErrNo;
+            }
+            model.dateTime = Common::getInstance()->FnGetDateTimeFormat_yyyymmddhhmm();
+            model.systemOnline = tProcess.giSystemOnline;
+            model.databaseError = (m_db != nullptr) ? m_db->FnGetDatabaseErrorFlag() : 0;
+            model.carparkFull = tProcess.gbcarparkfull.load();
+            model.offlineTransactions = tProcess.glNoofOfflineData;
+            model.flows = AsyncFlow::getInstance()->FnGetStats().flows;
+        },
+        [this](const std::string& data)
+        {
+            if ((m_Monitorudp == nullptr) || !m_Monitorudp->FnGetMonitorStatus())
+            {
+                return false;
+            }
+            SendMsg2Monitor("318", data);
+            return true;
+        });
+    }
+    //--- transactions saved offline go up in the background, progress to the monitor
+    OfflineUploader::getInstance()->FnStart(IOExecutor::getInstance()->FnGetBlockingContext(), [this](const std::string& data)
+    {
+        if ((m_Monitorudp != nullptr) && m_Monitorudp->FnGetMonitorStatus())
+        {
+            SendMsg2Monitor("320", data);
+        }
+    });
     //
-    int iRet = 0;
     m_db = db::getInstance();
+    // The lane serves from the local DB until the central DB is connected
+    tProcess.giSystemOnline = 1;
 
-    //iRet = m_db->connectlocaldb("DSN={MariaDB-server};DRIVER={MariaDB ODBC 3.0 Driver};SERVER=127.0.0.1;PORT=3306;DATABASE=linux_pbs;UID=linuxpbs;PWD=SJ2001;",2,2,1);
-    iRet = m_db->connectlocaldb("DRIVER={MariaDB ODBC 3.0 Driver};SERVER=localhost;PORT=3306;DATABASE=linux_pbs;UID=linuxpbs;PWD=SJ2001;",2,2,1);
-    if (iRet != 1) {
-        writelog ("Unable to connect local DB.","OPR");
-        exit(0); 
-    }
-    string m_connstring;
-    writelog ("Connect Central (" +tParas.gsCentralDBServer +  ") DB:"+tParas.gsCentralDBName,"OPR");
-    for (int i = 0 ; i < 5; ++i ) {
-      //  m_connstring = "DSN=mssqlserver;DATABASE=" + tParas.gsCentralDBName + ";UID=sa;PWD=yzhh2007";
-        m_connstring = "DRIVER=FreeTDS;SERVER=" + tParas.gsCentralDBServer + ";PORT=1433;DATABASE=" + tParas.gsCentralDBName + ";UID=sa;PWD=yzhh2007";
-        iRet = m_db->connectcentraldb(m_connstring,tParas.gsCentralDBServer,2,2,1);
-        if (iRet == 1) break;
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-    }
-    // sync central time
-    if (iRet == 1) {
-        m_db->synccentraltime();
-    } else
+    bootSequence_ = std::make_shared<BootSequence>(laneId_);
+    addBootPhases();
+    bootSequence_->FnStart(IOExecutor::getInstance()->FnGetBlockingContext(), [this]()
+    {
+        FnSendBootTimelineToMonitor();
+    });
+
+    if (!bootSequence_->FnWaitFor("localdb"))
     {
-        tProcess.giSystemOnline = 1;
+        if (!isConfigFromSnapshot_)
+        {
+            writelog ("Unable to connect local DB.","OPR");
+            exit(0);
+        }
+        writelog ("Unable to connect local DB, running on the config snapshot.","OPR");
     }
     //
-    if (LoadParameter()) {
+    if (bootSequence_->FnWaitFor("params")) {
         HandlePBSError(ParamOk);
 
-        Initdevice(ioContext);
+        // Devices come up in parallel, the lane opens once each of them has finished trying
+        for (const char* device : { "led", "tng", "dio", "lpr" })
+        {
+            bootSequence_->FnWaitFor(device);
+        }
+        startDeviceTimers(ioContext, bootSequence_->FnWaitFor("lcd"));
         //----
         writelog("EPS in operation","OPR");
         //------
@@ -152,9 +262,6 @@ void operation::OperationInit(io_context& ioContext)
         isOperationInitialized_.store(true);
         DIO::getInstance()->FnStartDIOMonitoring();
         SendMsg2Server("90",",,,,,Starting OK");
-        //-----
-        m_db->downloadseason();
-        m_db->moveOfflineTransToCentral();
 
         // Check Barrier
         writelog("Check barrier", "OPR");
@@ -168,7 +275,7 @@ void operation::OperationInit(io_context& ioContext)
         tProcess.gbInitParamFail = 1;
         HandlePBSError(ParamError);
         writelog("Unable to load parameter, Please download or check!", "OPR");
-        if (iRet == 1)
+        if (bootSequence_->FnWaitFor("centraldb"))
         {
             m_db->downloadstationsetup();
             m_db->loadstationsetup();
@@ -176,6 +283,217 @@ void operation::OperationInit(io_context& ioContext)
     }
 }
 
+// One attempt per call on the blocking pool, a timer waits out the second between attempts so no pool
+// thread sleeps. The timer is on the blocking context, the I/O threads are not running yet at boot.
+void operation::connectCentralDB(const std::string& connString, const std::string& server, int attemptsLeft, std::function<void(bool)> done)
+{
+    if (m_db->connectcentraldb(connString,server,2,2,1) == 1)
+    {
+        // sync central time
+        m_db->synccentraltime();
+        done(true);
+        return;
+    }
+
+    if (--attemptsLeft <= 0)
+    {
+        done(false);
+        return;
+    }
+
+    auto retryTimer = std::make_shared<boost::asio::steady_timer>(IOExecutor::getInstance()->FnGetBlockingContext(), std::chrono::milliseconds(1000));
+    retryTimer->async_wait(LaneContext::FnBind(laneId_, [this, retryTimer, connString, server, attemptsLeft, done](const boost::system::error_code& ec)
+    {
+        if (ec)
+        {
+            done(false);
+            return;
+        }
+        connectCentralDB(connString, server, attemptsLeft, done);
+    }));
+}
+
+void operation::addBootPhases()
+{
+    //iRet = m_db->connectlocaldb("DSN={MariaDB-server};DRIVER={MariaDB ODBC 3.0 Driver};SERVER=127.0.0.1;PORT=3306;DATABASE=linux_pbs;UID=linuxpbs;PWD=SJ2001;",2,2,1);
+    const std::string localConnString = "DRIVER={MariaDB ODBC 3.0 Driver};SERVER=localhost;PORT=3306;DATABASE=linux_pbs;UID=linuxpbs;PWD=SJ2001;";
+    //  m_connstring = "DSN=mssqlserver;DATABASE=" + tParas.gsCentralDBName + ";UID=sa;PWD=yzhh2007";
+    const std::string centralConnString = "DRIVER=FreeTDS;SERVER=" + tParas.gsCentralDBServer + ";PORT=1433;DATABASE=" + tParas.gsCentralDBName + ";UID=sa;PWD=yzhh2007";
+    const std::string centralServer = tParas.gsCentralDBServer;
+
+    // Phases run side by side and lanes open before central connects, so both connections are created up front
+    if (laneId_ == LaneContext::DEFAULT_LANE)
+    {
+        m_db->FnSetupLocalDB(localConnString,2,2,1);
+        m_db->FnSetupCentralDB(centralConnString,centralServer,2,2,1);
+    }
+
+    // The local DB connection is shared, further lanes use the one the first lane opened
+    bootSequence_->FnAddPhase("localdb", {}, [this, localConnString]()
+    {
+        if (laneId_ != LaneContext::DEFAULT_LANE)
+        {
+            return true;
+        }
+        return (m_db->connectlocaldb(localConnString,2,2,1) == 1);
+    });
+
+    // Central DB runs beside the local loads, a slow central server no longer holds the lane closed
+    if (laneId_ == LaneContext::DEFAULT_LANE)
+    {
+        bootSequence_->FnAddAsyncPhase("centraldb", {}, [this, centralConnString, centralServer](std::function<void(bool)> done)
+        {
+            writelog ("Connect Central (" + centralServer +  ") DB:"+tParas.gsCentralDBName,"OPR");
+            connectCentralDB(centralConnString, centralServer, 5, done);
+        });
+    }
+    else
+    {
+        // Finishes with the first lane's central phase, no pool thread is held while it connects
+        bootSequence_->FnAddAsyncPhase("centraldb", {}, [this](std::function<void(bool)> done)
+        {
+            std::shared_ptr<BootSequence> defaultLaneBoot;
+            {
+                LaneContext::Scope defaultLane(LaneContext::DEFAULT_LANE, false);
+                defaultLaneBoot = operation::getInstance()->bootSequence_;
+            }
+            if (!defaultLaneBoot)
+            {
+                done(false);
+                return;
+            }
+
+            defaultLaneBoot->FnOnPhaseFinished("centraldb", [this, done](bool isConnected)
+            {
+                if (isConnected)
+                {
+                    LaneContext::Scope laneScope(laneId_);
+                    tProcess.giSystemOnline = 0;
+                }
+                done(isConnected);
+            });
+        });
+    }
+
+    // With a valid config snapshot the parameters replay from it and no longer wait for the local DB
+    isConfigFromSnapshot_ = ConfigSnapshot::getInstance()->FnLoad(gtStation.iSID);
+    std::vector<std::string> paramsDependsOn;
+    if (!isConfigFromSnapshot_)
+    {
+        paramsDependsOn.push_back("localdb");
+    }
+
+    bootSequence_->FnAddPhase("params", paramsDependsOn, [this]()
+    {
+        bool isLoaded = LoadParameter();
+        ConfigSnapshot::getInstance()->FnEndReplay();
+        return isLoaded;
+    });
+
+    // loadParam leaves the central parameters to this phase when it replayed the snapshot. The lane may be
+    // open by now, so they are fetched here and applied on the flow strand its flows read them from.
+    bootSequence_->FnAddAsyncPhase("centralparams", { "centraldb", "params" }, [this](std::function<void(bool)> done)
+    {
+        if (!isConfigFromSnapshot_)
+        {
+            done(true);
+            return;
+        }
+
+        auto params = std::make_shared<CentralParams>();
+        m_db->FetchCentralParams(*params);
+        AsyncFlow::getInstance()->FnPost([this, params, done]()
+        {
+            centralParams_ = params;
+            m_db->ApplyCentralParams(*params);
+            done(true);
+        });
+    });
+
+    // Checks the replayed rows against the local DB and keeps the snapshot current for the next boot. Changed
+    // rows are read here, the reload replays them from memory on the flow strand so no flow sees half of it.
+    bootSequence_->FnAddAsyncPhase("revalidate", { "localdb", "params" }, [this](std::function<void(bool)> done)
+    {
+        std::vector<std::string> changed;
+        if (isConfigFromSnapshot_)
+        {
+            changed = m_db->FnRevalidateConfigSnapshot();
+        }
+        bool isSaved = ConfigSnapshot::getInstance()->FnSave(gtStation.iSID);
+
+        if (changed.empty())
+        {
+            done(isSaved);
+            return;
+        }
+
+        writelog("Config changed since the snapshot, reloading: " + boost::algorithm::join(changed, "; "), "OPR");
+        ConfigSnapshot::getInstance()->FnReplayRevalidated();
+        AsyncFlow::getInstance()->FnPost([this, isSaved, done]()
+        {
+            LoadParameter();
+            ConfigSnapshot::getInstance()->FnEndReplay();
+
+            // The reload took the local zone entries, the central ones win as they did at boot
+            if (centralParams_)
+            {
+                m_db->ApplyCentralParams(*centralParams_);
+            }
+            done(isSaved);
+        });
+    });
+
+    // Device settings come from the parameter table
+    bootSequence_->FnAddPhase("led", { "params" }, [this]()
+    {
+        initLED();
+        return true;
+    });
+    bootSequence_->FnAddPhase("lcd", { "params" }, []()
+    {
+        return LCD::getInstance()->FnLCDInit();
+    });
+    bootSequence_->FnAddPhase("tng", { "params" }, [this]()
+    {
+        initTnG();
+        return true;
+    });
+    bootSequence_->FnAddPhase("dio", { "params" }, []()
+    {
+        DIO::getInstance()->FnDIOInit();
+        return true;
+    });
+    bootSequence_->FnAddPhase("lpr", { "params" }, []()
+    {
+        Lpr::getInstance()->FnLprInit();
+        return true;
+    });
+
+    //----- local DB is shared, only the first lane syncs it
+    if (laneId_ == LaneContext::DEFAULT_LANE)
+    {
+        bootSequence_->FnAddPhase("season", { "centraldb", "params" }, [this]()
+        {
+            m_db->downloadseason();
+            OfflineUploader::getInstance()->FnRequest("boot");
+            return true;
+        });
+    }
+}
+
+void operation::FnSendBootTimelineToMonitor()
+{
+    if (bootSequence_)
+    {
+        SendMsg2Monitor("315", bootSequence_->FnGetTimelineString());
+    }
+}
+
+void operation::FnSendDIOSequencerToMonitor()
+{
+    SendMsg2Monitor("321", DIOSequencer::getInstance()->FnGetStatusString());
+}
+
 bool operation::LoadParameter()
 {
     DBError iReturn;
@@ -241,7 +559,9 @@ bool operation::LoadParameter()
         }
         gbLoadParameter = false;
     }
-     iReturn = m_db->LoadTariffTypeInfo();
+    // The tariff tables go out as one version once all of them are loaded
+    TariffSnapshot tariff = m_db->FnBeginTariffReload();
+     iReturn = m_db->LoadTariffTypeInfo(&tariff);
      if (iReturn != 0)
     {
         if (iReturn == 1)
@@ -255,7 +575,7 @@ bool operation::LoadParameter()
         gbLoadParameter = false;
     }
 
-    iReturn = m_db->LoadHoliday();
+    iReturn = m_db->LoadHoliday(&tariff);
     
     if (iReturn != 0)
     {
@@ -270,7 +590,7 @@ bool operation::LoadParameter()
         gbLoadParameter = false;
     }
 
-    iReturn = m_db->LoadTariff();
+    iReturn = m_db->LoadTariff(&tariff);
 
      if (iReturn != 0)
     {
@@ -285,7 +605,7 @@ bool operation::LoadParameter()
         gbLoadParameter = false;
     }
 
-    iReturn = m_db->LoadXTariff();
+    iReturn = m_db->LoadXTariff(&tariff);
 
      if (iReturn != 0)
     {
@@ -299,6 +619,7 @@ bool operation::LoadParameter()
         }
         gbLoadParameter = false;
     }
+    m_db->FnPublishTariff(std::move(tariff), "tariff_type_info, holiday_mst, tariff_setup, X_Tariff");
     return gbLoadParameter;
 }
 
@@ -353,7 +674,7 @@ void operation::handleLoopAPeriodicTimerTimeout(const boost::system::error_code
         }
 
         pLoopATimer_->expires_after(std::chrono::seconds(1));
-        pLoopATimer_->async_wait(boost::asio::bind_executor(*operationStrand_, std::bind(&operation::handleLoopAPeriodicTimerTimeout, this, std::placeholders::_1)));
+        pLoopATimer_->async_wait(boost::asio::bind_executor(*operationStrand_, LaneContext::FnBind(laneId_, std::bind(&operation::handleLoopAPeriodicTimerTimeout, this, std::placeholders::_1))));
     }
     else if (ec == boost::asio::error::operation_aborted)
     {
@@ -373,7 +694,7 @@ void operation::startLoopAPeriodicTimer()
     if (pLoopATimer_)
     {
         pLoopATimer_->expires_after(std::chrono::seconds(1));
-        pLoopATimer_->async_wait(boost::asio::bind_executor(*operationStrand_, std::bind(&operation::handleLoopAPeriodicTimerTimeout, this, std::placeholders::_1)));
+        pLoopATimer_->async_wait(boost::asio::bind_executor(*operationStrand_, LaneContext::FnBind(laneId_, std::bind(&operation::handleLoopAPeriodicTimerTimeout, this, std::placeholders::_1))));
     }
     else
     {
@@ -424,22 +745,12 @@ void operation::LoopACome()
     Clearme();
     DIO::getInstance()->FnSetLCDBacklight(1);
     //----
-    int vechicleType = 7;
-    for (int i = 0; i < 50; ++i)
-    {
-        if (DIO::getInstance()->FnGetLoopBStatus() && DIO::getInstance()->FnGetLoopAStatus())
-        {
-            vechicleType = 1;
-            break;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
-    }
+    // Vehicle type is resolved from the loop edges, VehicleClassified() continues the transaction
+    VehicleClassifier::getInstance()->FnRequestClassification();
+}
 
-    // Temp: Check after 500ms, if loopBStatus is on, then it is car
-    if (vechicleType == 7 && DIO::getInstance()->FnGetLoopBStatus())
-    {
-        vechicleType = 1;
-    }
+void operation::VehicleClassified(int vechicleType)
+{
     std::string transID = "";
     bool useFrontCamera = false;
     // Motorcycle - use rear camera
@@ -457,6 +768,7 @@ void operation::LoopACome()
     }
 
     tProcess.gsTransID = transID;
+    LogIndex::getInstance()->FnBeginTransaction(transID);
     Lpr::getInstance()->FnSendTransIDToLPR(tProcess.gsTransID, useFrontCamera);
 
     //----
@@ -533,11 +845,7 @@ void operation::Openbarrier()
 
     if (tParas.gsBarrierPulse == 0){tParas.gsBarrierPulse = 500;}
 
-    DIO::getInstance()->FnSetOpenBarrier(1);
-    
-    std::this_thread::sleep_for(std::chrono::milliseconds(tParas.gsBarrierPulse));
-    
-    DIO::getInstance()->FnSetOpenBarrier(0);
+    DIO::getInstance()->FnPulseOpenBarrier(tParas.gsBarrierPulse);
 }
 
 void operation::closeBarrier()
@@ -547,13 +855,9 @@ void operation::closeBarrier()
     if (tParas.gsBarrierPulse == 0){tParas.gsBarrierPulse = 500;}
 
     // Reset the continue open barrier
-    DIO::getInstance()->FnSetOpenBarrier(0);
+    DIO::getInstance()->FnReleaseOpenBarrier();
 
-    DIO::getInstance()->FnSetCloseBarrier(1);
-    //
-    std::this_thread::sleep_for(std::chrono::milliseconds(tParas.gsBarrierPulse));
-    //
-    DIO::getInstance()->FnSetCloseBarrier(0);
+    DIO::getInstance()->FnPulseCloseBarrier(tParas.gsBarrierPulse);
 
     tProcess.giBarrierContinueOpened = 0;
 }
@@ -562,13 +866,17 @@ void operation::continueOpenBarrier()
 {
     Logger::getInstance()->FnLog("Continue Open Barrier", "OPR");
 
-    DIO::getInstance()->FnSetOpenBarrier(1);
+    // Held until closeBarrier() releases it
+    DIO::getInstance()->FnHoldOpenBarrier();
 
     tProcess.giBarrierContinueOpened = 1;
 }
 
 void operation::Clearme()
 {
+    // Steps still in flight belong to the previous vehicle
+    AsyncFlow::getInstance()->FnInvalidateFlows();
+    LogIndex::getInstance()->FnEndTransaction();
     tProcess.giShowType = 1;
     tProcess.giIsSeason = 0;
     tProcess.giCardIsIn = 0;
@@ -609,6 +917,7 @@ void operation::Clearme()
 	    tExit.iTransType = 0;
 	    tExit.lParkedTime = 0;
 	    tExit.sFee = 0.00 ;
+	    tExit.iTariffVersion = 0;
 	    tExit.sPaidAmt = 0.00;
 	    tExit.sReceiptNo = "";
         tExit.iflag4Receipt= 0;
@@ -688,6 +997,18 @@ std::string operation::getSerialPort(const std::string& key)
 }
 
 void operation::Initdevice(io_context& ioContext)
+{
+    initLED();
+    bool isLCDReady = LCD::getInstance()->FnLCDInit();
+    initTnG();
+    DIO::getInstance()->FnDIOInit();
+    Lpr::getInstance()->FnLprInit();
+    // BARCODE_READER::getInstance()->FnBarcodeReaderInit();
+
+    startDeviceTimers(ioContext, isLCDReady);
+}
+
+void operation::initLED()
 {
     if (tParas.giCommPortLED > 0)
     {
@@ -708,13 +1029,24 @@ void operation::Initdevice(io_context& ioContext)
     {
         LEDManager::getInstance()->createLED(9600, getSerialPort(std::to_string(tParas.giCommportLED401)), LED::LED614_MAX_CHAR_PER_ROW);
     }
+}
 
-    if (LCD::getInstance()->FnLCDInit())
+void operation::initTnG()
+{
+    if (!IniParser::getInstance()->FnGetTnGRemoteServerHost().empty())
+    {
+        TnG_Reader::getInstance()->FnTnGReaderInit(IniParser::getInstance()->FnGetTnGRemoteServerHost(), IniParser::getInstance()->FnGetTnGRemoteServerPort(), IniParser::getInstance()->FnGetTnGListenHost(), IniParser::getInstance()->FnGetTnGListenPort());
+    }
+}
+
+void operation::startDeviceTimers(io_context& ioContext, bool isLCDReady)
+{
+    if (isLCDReady)
     {
         pLCDIdleTimer_ = std::make_unique<boost::asio::steady_timer>(ioContext);
 
         pLCDIdleTimer_->expires_after(std::chrono::seconds(1));
-        pLCDIdleTimer_->async_wait(boost::asio::bind_executor(*operationStrand_, [this] (const boost::system::error_code &ec)
+        pLCDIdleTimer_->async_wait(boost::asio::bind_executor(*operationStrand_, LaneContext::FnBind(laneId_, [this] (const boost::system::error_code &ec)
         {
             if (!ec)
             {
@@ -730,24 +1062,15 @@ void operation::Initdevice(io_context& ioContext)
                 ss << "LCD Idle timer timeout error :" << ec.message();
                 Logger::getInstance()->FnLog(ss.str(), "", "OPR");
             }
-        }));
+        })));
     }
 
-    if (!IniParser::getInstance()->FnGetTnGRemoteServerHost().empty())
-    {
-        TnG_Reader::getInstance()->FnTnGReaderInit(IniParser::getInstance()->FnGetTnGRemoteServerHost(), IniParser::getInstance()->FnGetTnGRemoteServerPort(), IniParser::getInstance()->FnGetTnGListenHost(), IniParser::getInstance()->FnGetTnGListenPort());
-    }
-
-    DIO::getInstance()->FnDIOInit();
-    Lpr::getInstance()->FnLprInit();
-    // BARCODE_READER::getInstance()->FnBarcodeReaderInit();
-
     // Loop A timer
     pLoopATimer_ = std::make_unique<boost::asio::steady_timer>(ioContext);
 
     pMsgDisplayTimer_ = std::make_unique<boost::asio::steady_timer>(ioContext);
     pMsgDisplayTimer_->expires_after(std::chrono::seconds(1));
-    pMsgDisplayTimer_->async_wait(boost::asio::bind_executor(*operationStrand_, [this] (const boost::system::error_code &ec)
+    pMsgDisplayTimer_->async_wait(boost::asio::bind_executor(*operationStrand_, LaneContext::FnBind(laneId_, [this] (const boost::system::error_code &ec)
     {
         if (!ec)
         {
@@ -763,7 +1086,7 @@ void operation::Initdevice(io_context& ioContext)
             ss << "Message Display timer timeout error :" << ec.message();
             Logger::getInstance()->FnLog(ss.str(), "", "OPR");
         }
-    }));
+    })));
 }
 
 void operation::LcdIdleTimerTimeoutHandler()
@@ -790,7 +1113,7 @@ void operation::LcdIdleTimerTimeoutHandler()
 
     // Restart the lcd idle timer
     pLCDIdleTimer_->expires_at(pLCDIdleTimer_->expiry() + std::chrono::seconds(1));
-    pLCDIdleTimer_->async_wait(boost::asio::bind_executor(*operationStrand_, [this] (const boost::system::error_code &ec)
+    pLCDIdleTimer_->async_wait(boost::asio::bind_executor(*operationStrand_, LaneContext::FnBind(laneId_, [this] (const boost::system::error_code &ec)
     {
         if (!ec)
         {
@@ -806,7 +1129,7 @@ void operation::LcdIdleTimerTimeoutHandler()
             ss << "LCD Idle timer timeout error :" << ec.message();
             Logger::getInstance()->FnLog(ss.str(), "", "OPR");
         }
-    }));
+    })));
 }
 
 void operation::MsgDisplayTimerTimeoutHandler()
@@ -848,7 +1171,7 @@ void operation::MsgDisplayTimerTimeoutHandler()
 
     // Restart the message display timer
     pMsgDisplayTimer_->expires_after(std::chrono::seconds(1));
-    pMsgDisplayTimer_->async_wait(boost::asio::bind_executor(*operationStrand_, [this] (const boost::system::error_code &ec)
+    pMsgDisplayTimer_->async_wait(boost::asio::bind_executor(*operationStrand_, LaneContext::FnBind(laneId_, [this] (const boost::system::error_code &ec)
     {
         if (!ec)
         {
@@ -864,7 +1187,7 @@ void operation::MsgDisplayTimerTimeoutHandler()
             ss << "Message Display timer timeout error :" << ec.message();
             Logger::getInstance()->FnLog(ss.str(), "", "OPR");
         }
-    }));
+    })));
 }
 
 void operation::ShowLEDMsg(string LEDMsg, string LCDMsg)
@@ -888,19 +1211,54 @@ void operation::ShowLEDMsg(string LEDMsg, string LCDMsg)
 
 void operation::PBSEntry(string sIU)
 {
-    int iRet;
+    AsyncFlow::getInstance()->FnStartFlow("PBSEntry", [this, sIU](AsyncFlow::FlowPtr flow)
+    {
+        flow->FnSetBudget(decisionBudgetMs_);
+        // Queued behind the flow that already let this vehicle in
+        if (tEntry.gbEntryOK == true) return;
+        pbsEntryFlow(flow, sIU);
+    });
+}
 
+void operation::pbsEntryFlow(AsyncFlow::FlowPtr flow, string sIU)
+{
     tEntry.sIUTKNo = sIU;
     tEntry.sEntryTime= Common::getInstance()->FnGetDateTimeFormat_yyyy_mm_dd_hh_mm_ss();
+    LogIndex::getInstance()->FnTagTransaction(sIU);
 
     if (sIU == "") return;
-    //check blacklist
     SendMsg2Server("90",","+sIU+",,"+tEntry.sLPN[0]+ ",,PMS_DVR");
-    iRet = m_db->IsBlackListIU(sIU);
-    if (iRet >= 0){
+
+    // Blacklist and season are looked up together, the results are handled in the original order
+    auto lookup = std::make_shared<FlowLookup>();
+    auto joined = AsyncFlow::FnJoin(2, [this, flow, sIU, lookup]()
+    {
+        pbsEntryLookedUp(flow, sIU, lookup->iBlackList, lookup->iSeason);
+    });
+
+    AsyncFlow::getInstance()->FnRunStep<int>(flow, "IsBlackListIU", centralStepTimeoutMs(flow),
+        [this, sIU]() { return m_db->IsBlackListIU(sIU); }, -1,
+        [flow, lookup, joined](int iRet, bool timedOut)
+        {
+            flow->FnRecordSource("blacklist", timedOut ? "none" : "central", timedOut);
+            lookup->iBlackList = iRet;
+            joined();
+        });
+    CheckSeason(flow, sIU, 1, [lookup, joined](int iRet) { lookup->iSeason = iRet; joined(); });
+}
+
+void operation::pbsEntryLookedUp(AsyncFlow::FlowPtr flow, string sIU, int iBlackList, int iSeason)
+{
+    string sMsg;
+    string sLCD;
+
+    flow->FnMarkDecided();
+
+    //check blacklist
+    if (iBlackList >= 0){
         ShowLEDMsg(tMsg.MsgBlackList[0], tMsg.MsgBlackList[1]);
         SendMsg2Server("90",sIU+",,,,,Blacklist IU");
-        if(iRet ==0) return;
+        if(iBlackList ==0) return;
     }
     //check block 
     string gsBlockIUPrefix = IniParser::getInstance()->FnGetBlockIUPrefix();
@@ -921,16 +1279,26 @@ void operation::PBSEntry(string sIU)
         return;
     }
     tEntry.iVehicleType = (tEntry.iTransType -1 )/3;
-    
-    iRet = CheckSeason(sIU,1);
 
+    //showLED message
+    if (iSeason != 8 ) {
+        FormatSeasonMsg(iSeason, sIU, sMsg, sLCD);
+    }
+    AsyncFlow::getInstance()->FnDelay(flow, seasonMsgHoldMs(iSeason), [this, flow, sIU, iSeason]()
+    {
+        pbsEntrySeasonShown(flow, sIU, iSeason);
+    });
+}
+
+void operation::pbsEntrySeasonShown(AsyncFlow::FlowPtr flow, string sIU, int iRet)
+{
     if (tProcess.gbcarparkfull.load() == true && iRet == 1 && (std::stoi(tSeason.rate_type) !=0) && tParas.giFullAction ==iNoPartial )
     {   
         writelog ("VIP Season Only.", "OPR");
         ShowLEDMsg("Carpark Full!^VIP Season Only", "Carpark Full!^VIP Season Only");
         return;
     } 
-    if ((std::stoi(IniParser::getInstance()->FnGetSeasonOnly()) > 0) && iRet != 1 )
+    if ((IniParser::getInstance()->FnGetSeasonOnly() > 0) && iRet != 1 )
     {   
         writelog ("Season Only.", "OPR");
         ShowLEDMsg(tMsg.Msg_SeasonOnly[0], tMsg.Msg_SeasonOnly[1]);
@@ -965,12 +1333,13 @@ void operation::PBSEntry(string sIU)
         tProcess.giShowType = 1;
     }
         //---------
-    SaveEntry();
-    tEntry.gbEntryOK = true;
-    Openbarrier();
+    SaveEntry(flow, [this]()
+    {
+        tEntry.gbEntryOK = true;
+        Openbarrier();
+    });
 }
 
-
 void operation:: Setdefaultparameter()
 {
     tParas = {0};
@@ -1104,12 +1473,24 @@ void operation::FnSyncCentralDBTime()
 
 void operation::FnSendDIOInputStatusToMonitor(int pinNum, int pinValue)
 {
+    if (StationStatus::getInstance()->FnIsStarted())
+    {
+        StationStatus::getInstance()->FnUpdate([pinNum, pinValue](StationStatusModel& model) { model.dioInputs[pinNum] = pinValue; });
+        return;
+    }
+
     std::string str = std::to_string(pinNum) + "," + std::to_string(pinValue);
     SendMsg2Monitor("302", str);
 }
 
 void operation::FnSendDateTimeToMonitor()
 {
+    // Sampled into the station status on every tick
+    if (StationStatus::getInstance()->FnIsStarted())
+    {
+        return;
+    }
+
     std::string str = Common::getInstance()->FnGetDateTimeFormat_yyyymmddhhmm();
     SendMsg2Monitor("304", str);
 }
@@ -1121,13 +1502,23 @@ void operation::FnSendLogMessageToMonitor(std::string msg)
         if (m_Monitorudp->FnGetMonitorStatus())
         {
             std::string str = "[" + gtStation.sPCName + "|" + std::to_string(gtStation.iSID) + "|" + "305" + "|" + msg + "|]";
-            m_Monitorudp->send(str);
+            m_Monitorudp->send(str, UdpSendClass::Log);
         }
     }
 }
 
 void operation::FnSendLEDMessageToMonitor(std::string line1TextMsg, std::string line2TextMsg)
 {
+    if (StationStatus::getInstance()->FnIsStarted())
+    {
+        StationStatus::getInstance()->FnUpdate([&line1TextMsg, &line2TextMsg](StationStatusModel& model)
+        {
+            model.ledLine1 = line1TextMsg;
+            model.ledLine2 = line2TextMsg;
+        });
+        return;
+    }
+
     std::string str = line1TextMsg + "," + line2TextMsg;
     SendMsg2Monitor("306", str);
 }
@@ -1453,7 +1844,7 @@ void operation::SendMsg2Monitor(string cmdcode,string dstr)
         {
             string str="["+ gtStation.sPCName +"|"+to_string(gtStation.iSID)+"|"+cmdcode+"|";
             str+=dstr+"|]";
-            m_Monitorudp->send(str);
+            m_Monitorudp->send(str, monitorSendClass(cmdcode));
             //----
             writelog ("Message to Monitor: " + str,"OPR");
         }
@@ -1472,17 +1863,177 @@ void operation::SendMsg2Server(string cmdcode,string dstr)
     }
 }
 
-int operation::CheckSeason(string sIU,int iInOut)
+void operation::CheckSeason(AsyncFlow::FlowPtr flow, string sIU, int iInOut, std::function<void(int)> next)
+{
+    // Central season check, the local season table answers when central does not reply within the budget.
+    // The record is copied into tSeason here on the flow strand, a late central answer is only compared.
+    using SeasonLookup = std::pair<int, SeasonInfo>;
+    auto isFromLocal = std::make_shared<bool>(false);
+    auto late = std::make_shared<LateLookup<int>>();
+    late->compare = [sIU](const int& decided, const int& central)
+    {
+        AsyncFlow::getInstance()->FnRecordLateAnswer("season", sIU, (decided == 1) != (central == 1),
+            "central " + std::to_string(central) + ", local " + std::to_string(decided));
+    };
+
+    AsyncFlow::getInstance()->FnRunStep<SeasonLookup>(flow, "isvalidseason", centralStepTimeoutMs(flow),
+        [this, sIU, iInOut, isFromLocal]()
+        {
+            SeasonLookup season(-1, SeasonInfo());
+            season.first = db::getInstance()->isvalidseason(sIU, iInOut, gtStation.iZoneID, season.second, isFromLocal.get());
+            return season;
+        },
+        SeasonLookup(-1, SeasonInfo()),
+        [this, flow, sIU, next, isFromLocal, late](SeasonLookup season, bool timedOut)
+        {
+            if (!timedOut)
+            {
+                flow->FnRecordSource("season", *isFromLocal ? "local" : "central");
+                applySeasonInfo(season.second);
+                next(season.first);
+                return;
+            }
+
+            AsyncFlow::getInstance()->FnRunStep<SeasonLookup>(flow, "local_isvalidseason", localStepTimeoutMs(flow),
+                [this, sIU]()
+                {
+                    SeasonLookup season(static_cast<int>(iLocalFail), SeasonInfo());
+                    season.first = db::getInstance()->local_isvalidseason(sIU, gtStation.iZoneID, season.second);
+                    return season;
+                },
+                SeasonLookup(static_cast<int>(iLocalFail), SeasonInfo()),
+                [this, flow, next, late](SeasonLookup localSeason, bool localTimedOut)
+                {
+                    int iSeasonRet = (localSeason.first == iDBSuccess) ? 1 : 8;
+                    writelog ("Check Local Season Return = "+ std::to_string(iSeasonRet), "OPR");
+                    flow->FnRecordSource("season", localTimedOut ? "none" : "local", true);
+                    applySeasonInfo(localSeason.second);
+                    late->FnSetDecided(iSeasonRet);
+                    next(iSeasonRet);
+                });
+        },
+        [isFromLocal, late](SeasonLookup season)
+        {
+            if (!*isFromLocal)
+            {
+                late->FnSetLate(season.first);
+            }
+        });
+}
+
+void operation::applySeasonInfo(const SeasonInfo& season)
+{
+    if (!season.hasRecord)
+    {
+        return;
+    }
+
+    if (season.hasStatus)
+    {
+        tSeason.SeasonType = season.sSeasonType;
+        tSeason.s_status = season.sStatus;
+    }
+    tSeason.date_from = season.sDateFrom;
+    tSeason.date_to = season.sDateTo;
+    tSeason.rate_type = season.sRateType;
+    tSeason.redeem_amt = season.sRedeemAmt;
+    tSeason.redeem_time = season.sRedeemTime;
+}
+
+void operation::FetchEntry(AsyncFlow::FlowPtr flow, string sIU, std::function<void(int)> next)
+{
+    // Central entry record, the local one answers when central fails or does not reply within the budget.
+    // The record is copied into tExit here on the flow strand, a late central answer is only compared.
+    using EntryLookup = std::pair<int, EntryInfo>;
+    auto late = std::make_shared<LateLookup<EntryLookup>>();
+    late->compare = [sIU](const EntryLookup& decided, const EntryLookup& central)
+    {
+        bool isMismatch = (decided.first != central.first) || (decided.second.sEntryTime != central.second.sEntryTime);
+        AsyncFlow::getInstance()->FnRecordLateAnswer("entry", sIU, isMismatch,
+            "central " + std::to_string(central.first) + " " + central.second.sEntryTime + ", local " + std::to_string(decided.first) + " " + decided.second.sEntryTime);
+    };
+
+    AsyncFlow::getInstance()->FnRunStep<EntryLookup>(flow, "FetchCentralEntryinfo", centralStepTimeoutMs(flow),
+        [this, sIU]()
+        {
+            EntryLookup entry(-1, EntryInfo());
+            entry.first = m_db->FetchCentralEntryinfo(sIU, entry.second);
+            return entry;
+        },
+        EntryLookup(-1, EntryInfo()),
+        [this, flow, sIU, next, late](EntryLookup entry, bool timedOut)
+        {
+            if (!timedOut && (entry.first != -1))
+            {
+                flow->FnRecordSource("entry", "central");
+                applyEntryInfo(entry.first, entry.second);
+                next(entry.first);
+                return;
+            }
+
+            AsyncFlow::getInstance()->FnRunStep<EntryLookup>(flow, "FetchLocalEntryinfo", localStepTimeoutMs(flow),
+                [this, sIU]()
+                {
+                    EntryLookup entry(-1, EntryInfo());
+                    entry.first = m_db->FetchLocalEntryinfo(sIU, entry.second);
+                    return entry;
+                },
+                EntryLookup(-1, EntryInfo()),
+                [this, flow, next, late, timedOut](EntryLookup localEntry, bool localTimedOut)
+                {
+                    flow->FnRecordSource("entry", localTimedOut ? "none" : "local", timedOut);
+                    applyEntryInfo(localEntry.first, localEntry.second);
+                    if (timedOut)
+                    {
+                        late->FnSetDecided(localEntry);
+                    }
+                    next(localEntry.first);
+                });
+        },
+        [late](EntryLookup entry)
+        {
+            if (entry.first != -1)
+            {
+                late->FnSetLate(entry);
+            }
+        });
+}
+
+void operation::applyEntryInfo(int iRet, const EntryInfo& entryInfo)
+{
+    if (iRet != 0)
+    {
+        return;
+    }
+
+    tExit.sEntryTime = entryInfo.sEntryTime;
+    tExit.iTransType = entryInfo.iTransType;
+    tExit.sOweAmt = entryInfo.sOweAmt;
+    tExit.iEntryID = entryInfo.iEntryID;
+}
+
+int operation::centralStepTimeoutMs(const AsyncFlow::FlowPtr& flow) const
+{
+    // What is left of the decision budget once the local fallback has its share, nothing left falls back at once
+    int budgetLeftMs = flow->FnGetBudgetLeftMs();
+    if (budgetLeftMs == INT_MAX)
+    {
+        return dbStepTimeoutMs_;
+    }
+    return std::max(0, std::min(dbStepTimeoutMs_, budgetLeftMs - localLookupMs_));
+}
+
+int operation::localStepTimeoutMs(const AsyncFlow::FlowPtr& flow) const
 {
-   int iRet;
-   string sMsg;
-   string sLCD;
-   iRet = db::getInstance()->isvalidseason(sIU,iInOut,gtStation.iZoneID);
-   //showLED message
-   if (iRet != 8 ) {
-        FormatSeasonMsg(iRet, sIU, sMsg, sLCD);
-   } 
-   return iRet;
+    // The local DB gets its share even when the budget is spent, a decision needs some answer
+    return std::min(dbStepTimeoutMs_, std::max(localLookupMs_, flow->FnGetBudgetLeftMs()));
+}
+
+int operation::seasonMsgHoldMs(int iRet)
+{
+    // Season message from FormatSeasonMsg stays up before the flow shows the next one
+    if (iRet == 8) return 0;
+    return (iRet != 1 || std::stoi(tSeason.rate_type) != 0) ? SEASON_MSG_HOLD_MS : 0;
 }
 
 void operation::writelog(string sMsg, string soption)
@@ -1773,23 +2324,16 @@ int operation::GetVTypeFromLoop()
 
 }
 
-void operation::SaveEntry()
+void operation::SaveEntry(AsyncFlow::FlowPtr flow, std::function<void()> next)
 {
-    int iRet;
     std::string sLPRNo = "";
     
-    if (tEntry.sIUTKNo== "") return;
-    writelog ("Save Entry trans:"+ tEntry.sIUTKNo, "OPR");
-
-    iRet = db::getInstance()->insertentrytrans(tEntry);
-    //----
-    if (iRet == iDBSuccess)
+    if (tEntry.sIUTKNo== "")
     {
-        tProcess.setLastIUNo(tEntry.sIUTKNo);
-        tProcess.setLastIUEntryTime(std::chrono::steady_clock::now());
+        next();
+        return;
     }
-    //-------
-    tPBSError[iDB].ErrNo = (iRet == iDBSuccess) ? 0 : (iRet == iCentralFail) ? -1 : -2;
+    writelog ("Save Entry trans:"+ tEntry.sIUTKNo, "OPR");
 
     if ((tEntry.sLPN[0] != "")|| (tEntry.sLPN[1] != ""))
 	{
@@ -1803,14 +2347,46 @@ void operation::SaveEntry()
 		}
 	}
 
-    std::string sMsg2Send = (iRet == iDBSuccess) ? "Entry OK" : (iRet == iCentralFail) ? "Entry Central Failed" : "Entry Local Failed";
+    // Saved from a copy, the result may arrive after the barrier opened and Clearme() ran
+    auto entry = std::make_shared<tEntryTrans_Struct>(tEntry);
+    int iShowType = tProcess.giShowType;
+    auto entrySaved = [this, entry, sLPRNo, iShowType](int iRet)
+    {
+        if (iRet == iDBSuccess)
+        {
+            tProcess.setLastIUNo(entry->sIUTKNo);
+            tProcess.setLastIUEntryTime(std::chrono::steady_clock::now());
+        }
+        //-------
+        tPBSError[iDB].ErrNo = (iRet == iDBSuccess) ? 0 : (iRet == iCentralFail) ? -1 : -2;
+
+        std::string sMsg2Send = (iRet == iDBSuccess) ? "Entry OK" : (iRet == iCentralFail) ? "Entry Central Failed" : "Entry Local Failed";
 
-    sMsg2Send = tEntry.sIUTKNo + ",,," + sLPRNo + "," + std::to_string(tProcess.giShowType) + "," + sMsg2Send;
+        sMsg2Send = entry->sIUTKNo + ",,," + sLPRNo + "," + std::to_string(iShowType) + "," + sMsg2Send;
+
+        if (entry->iStatus == 0) {
+            SendMsg2Server("90", sMsg2Send);
+        }
+    };
 
-    if (tEntry.iStatus == 0) {
-        SendMsg2Server("90", sMsg2Send);
-    }
     tProcess.gbsavedtrans = true;
+
+    AsyncFlow::getInstance()->FnRunStep<int>(flow, "SaveEntry", dbSaveTimeoutMs_,
+        [entry]() { return static_cast<int>(db::getInstance()->insertentrytrans(*entry)); }, static_cast<int>(iCentralFail),
+        [this, entry, entrySaved, next](int iRet, bool timedOut)
+        {
+            if (timedOut)
+            {
+                writelog ("Save Entry still pending on DB:"+ entry->sIUTKNo, "OPR");
+            }
+            else
+            {
+                tEntry.sEntryTime = entry->sEntryTime;
+                entrySaved(iRet);
+            }
+            next();
+        },
+        entrySaved);
 }
 
 void operation::ShowTotalLots(std::string totallots, std::string LEDId)
@@ -1845,7 +2421,24 @@ void operation::FormatSeasonMsg(int iReturn, string sNo, string sMsg, string sLC
 
     if (giSeasonTransType > 49)
     {
-        sMsgPartialSeason = db::getInstance()->GetPartialSeasonMsg(giSeasonTransType);
+        // Trans type descriptions do not change. The first vehicle of a type gets the plain season message
+        // and the description is fetched off the strand for the next one, nothing waits on central DB.
+        auto it = partialSeasonMsg_.find(giSeasonTransType);
+        if (it != partialSeasonMsg_.end())
+        {
+            sMsgPartialSeason = it->second;
+        }
+        else
+        {
+            AsyncFlow::getInstance()->FnRunDetached("GetPartialSeasonMsg", [this, giSeasonTransType]()
+            {
+                std::string sMsg = db::getInstance()->GetPartialSeasonMsg(giSeasonTransType);
+                if (!sMsg.empty())
+                {
+                    AsyncFlow::getInstance()->FnPost([this, giSeasonTransType, sMsg]() { partialSeasonMsg_[giSeasonTransType] = sMsg; });
+                }
+            });
+        }
         writelog("partial season msg:" + sMsgPartialSeason + ", trans type: " + std::to_string(giSeasonTransType),"OPR");
     }
 
@@ -2045,9 +2638,6 @@ void operation::FormatSeasonMsg(int iReturn, string sNo, string sMsg, string sLC
     }
     
     ShowLEDMsg(sMsg,sLCD);
-    
-    if (iReturn != 1 || std::stoi(tSeason.rate_type) != 0) std::this_thread::sleep_for(std::chrono::milliseconds(500));
-
 }
 
 void operation::ManualOpenBarrier(bool bPMS)
@@ -2055,24 +2645,37 @@ void operation::ManualOpenBarrier(bool bPMS)
      if (bPMS == true) writelog ("Manual open barrier by PMS", "OPR");
      else writelog ("Manual open barrier by operator", "OPR");
      //------------
-     if (gtStation.iType == tientry){
-	    tEntry.sEntryTime = Common::getInstance()->FnGetDateTimeFormat_yyyy_mm_dd_hh_mm_ss();
-        tEntry.iStatus = 4;
-        //---------
-        m_db->AddRemoteControl(std::to_string(gtStation.iSID),"Manual open barrier","Auto save for IU:"+tEntry.sIUTKNo);
-        SaveEntry();
-        Openbarrier();
-     }else{
-        if (tExit.sExitTime == "") tExit.sExitTime = Common::getInstance()->FnGetDateTimeFormat_yyyy_mm_dd_hh_mm_ss();
-        m_db->AddRemoteControl(std::to_string(gtStation.iSID),"Manual open barrier","Auto save for IU:"+tExit.sIUNo);
-        CloseExitOperation(Manualopen);
-     }
+     AsyncFlow::getInstance()->FnStartFlow("ManualOpenBarrier", [this](AsyncFlow::FlowPtr flow)
+     {
+        if (gtStation.iType == tientry){
+            tEntry.sEntryTime = Common::getInstance()->FnGetDateTimeFormat_yyyy_mm_dd_hh_mm_ss();
+            tEntry.iStatus = 4;
+            //---------
+            std::string sRemarks = "Auto save for IU:"+tEntry.sIUTKNo;
+            AsyncFlow::getInstance()->FnRunDetached("AddRemoteControl", [this, sRemarks]()
+            {
+                m_db->AddRemoteControl(std::to_string(gtStation.iSID),"Manual open barrier",sRemarks);
+            });
+            SaveEntry(flow, [this]() { Openbarrier(); });
+        }else{
+            if (tExit.sExitTime == "") tExit.sExitTime = Common::getInstance()->FnGetDateTimeFormat_yyyy_mm_dd_hh_mm_ss();
+            std::string sRemarks = "Auto save for IU:"+tExit.sIUNo;
+            AsyncFlow::getInstance()->FnRunDetached("AddRemoteControl", [this, sRemarks]()
+            {
+                m_db->AddRemoteControl(std::to_string(gtStation.iSID),"Manual open barrier",sRemarks);
+            });
+            closeExitFlow(flow, Manualopen);
+        }
+     });
 }
 
 void operation::ManualCloseBarrier()
 {
     writelog ("Manual Close barrier.", "OPR");
-    m_db->AddRemoteControl(std::to_string(gtStation.iSID),"Manual close barrier","");
+    AsyncFlow::getInstance()->FnRunDetached("AddRemoteControl", [this]()
+    {
+        m_db->AddRemoteControl(std::to_string(gtStation.iSID),"Manual close barrier","");
+    });
     
     closeBarrier();
 }
@@ -2271,6 +2874,7 @@ void operation::ReceivedLPR(Lpr::CType CType,string LPN, string sTransid, string
 
     if (tProcess.gsTransID == sTransid && tProcess.gbLoopApresent.load() == true && tProcess.gbsavedtrans == false)
     {
+       LogIndex::getInstance()->FnTagTransaction(LPN);
        if (gtStation.iType == tientry) {
             // For EdgeBox
             tEntry.sLPN[0]=LPN;
@@ -2285,8 +2889,12 @@ void operation::ReceivedLPR(Lpr::CType CType,string LPN, string sTransid, string
     }
     else
     {
-        if (gtStation.iType == tientry) db::getInstance()->updateEntryTrans(LPN,sTransid);
-        else db::getInstance()->updateExitTrans(LPN,sTransid);
+        tStationType iStationType = gtStation.iType;
+        AsyncFlow::getInstance()->FnRunDetached("UpdateTransLPN", [iStationType, LPN, sTransid]()
+        {
+            if (iStationType == tientry) db::getInstance()->updateEntryTrans(LPN,sTransid);
+            else db::getInstance()->updateExitTrans(LPN,sTransid);
+        });
     }
 
     /*
@@ -2302,22 +2910,23 @@ void operation::DebitOK(const std::string& sIUNO, const std::string& sCardNo,
                 int iCardType, const std::string& sTopupAmt,
                 DeviceType iDevicetype, const std::string& sTransTime)
 {
+    AsyncFlow::getInstance()->FnStartFlow("DebitOK", [this, sCardNo, sPaidAmt, sBal, iCardType](AsyncFlow::FlowPtr flow)
+    {
+        //---------
+        tExit.sCardNo = sCardNo;
+        if (sPaidAmt != "") tExit.sPaidAmt = GfeeFormat(std::stof(sPaidAmt));
+        tExit.iCardType = iCardType;
+        //--------
+        tProcess.gsLastPaidTrans = tExit.sIUNo;
+        tProcess.gbLastPaidStatus.store(true);
+        tProcess.gsLastCardNo = sCardNo;
+        if (sBal != "") tProcess.gfLastCardBal= GfeeFormat(std::stof(sBal));
+        else tProcess.gfLastCardBal = 0;
+        //-------
+        tExit.giDeductionStatus = DeductionSuccessed;
 
-    //---------
-    tExit.sCardNo = sCardNo;
-    if (sPaidAmt != "") tExit.sPaidAmt = GfeeFormat(std::stof(sPaidAmt));
-    tExit.iCardType = iCardType;
-    //--------
-    tProcess.gsLastPaidTrans = tExit.sIUNo;
-    tProcess.gbLastPaidStatus.store(true);
-    tProcess.gsLastCardNo = sCardNo;
-    if (sBal != "") tProcess.gfLastCardBal= GfeeFormat(std::stof(sBal));
-    else tProcess.gfLastCardBal = 0;
-    //-------
-    tExit.giDeductionStatus = DeductionSuccessed;
-
-    CloseExitOperation(DeductionOK);
-
+        closeExitFlow(flow, DeductionOK);
+    });
 }
 
 std::string operation::GetVTypeStr(int iVType)
@@ -2349,11 +2958,19 @@ std::string operation::GetVTypeStr(int iVType)
 }
 
  void operation::CheckIUorCardStatus(string sCheckNo, DeviceType iDevicetype,string sCardNo, int sCardType, float sCardBal)
+ {
+    AsyncFlow::getInstance()->FnStartFlow("CheckIUorCardStatus", [this, sCheckNo, iDevicetype, sCardNo, sCardType, sCardBal](AsyncFlow::FlowPtr flow)
+    {
+        flow->FnSetBudget(decisionBudgetMs_);
+        checkIUorCardStatusFlow(flow, sCheckNo, iDevicetype, sCardNo, sCardType, sCardBal);
+    });
+ }
+
+ void operation::checkIUorCardStatusFlow(AsyncFlow::FlowPtr flow, string sCheckNo, DeviceType iDevicetype, string sCardNo, int sCardType, float sCardBal)
  {
     // device type : 0 = PMS(EntryTime), 1 = Ant, 2 = LCSC, 3 = UPOS, 4 = CHU
 
     string gsCompareNo;
-    int iRet;
     string sMsg;
     //--------
     if (tExit.giDeductionStatus == CardExpired || tExit.giDeductionStatus == CardFault ) {
@@ -2400,29 +3017,33 @@ std::string operation::GetVTypeStr(int iVType)
     //---------
     if (tExit.giDeductionStatus == WaitingCard) {
         //CheckCardOK 
-        iRet = m_db->CheckCardOK(sCardNo);
-        if (iRet > 0) {
-            if (iRet == 5) {
-                tExit.iTransType = 2;
-                ShowLEDMsg("Master Card!", "Master Card!");
-                std::this_thread::sleep_for(std::chrono::milliseconds(500));
-            }
-            else {
-                tExit.iTransType = 10;
-                ShowLEDMsg("Complimentary!", "Complimentary!");
-                std::this_thread::sleep_for(std::chrono::milliseconds(500));
-            }
-            tExit.sCardNo = sCardNo;
-            tExit.iCardType = sCardType;
-            tExit.sPaidAmt = 0;
-            CloseExitOperation(FreeParking);
-            return;
-        } 
-       if (GfeeFormat(tExit.sPaidAmt) > 0)
-        {
-            writelog("Send deduction command to T&G Reader: ", "OPR");
-            TnG_Reader::getInstance()->FnTnGReader_PayRequest(tExit.sPaidAmt * 100, 0, Common::getInstance()->FnGetUtcTimestamp(Common::getInstance()->FnGetDateTimeFormat_yyyymmddhhmmss()), Common::getInstance()->FnGetUtcTimestamp(Common::getInstance()->FnGetDateTimeFormat_yyyymmddhhmmss()), tProcess.gsTransID);
-        }
+        AsyncFlow::getInstance()->FnRunStep<int>(flow, "CheckCardOK", centralStepTimeoutMs(flow),
+            [this, sCardNo]() { return m_db->CheckCardOK(sCardNo); }, 0,
+            [this, flow, sCardNo, sCardType](int iRet, bool timedOut)
+            {
+                flow->FnRecordSource("card", timedOut ? "none" : "central", timedOut);
+                flow->FnMarkDecided();
+                if (iRet > 0) {
+                    if (iRet == 5) {
+                        tExit.iTransType = 2;
+                        ShowLEDMsg("Master Card!", "Master Card!");
+                    }
+                    else {
+                        tExit.iTransType = 10;
+                        ShowLEDMsg("Complimentary!", "Complimentary!");
+                    }
+                    tExit.sCardNo = sCardNo;
+                    tExit.iCardType = sCardType;
+                    tExit.sPaidAmt = 0;
+                    AsyncFlow::getInstance()->FnDelay(flow, SEASON_MSG_HOLD_MS, [this, flow]() { closeExitFlow(flow, FreeParking); });
+                    return;
+                } 
+               if (GfeeFormat(tExit.sPaidAmt) > 0)
+                {
+                    writelog("Send deduction command to T&G Reader: ", "OPR");
+                    TnG_Reader::getInstance()->FnTnGReader_PayRequest(tExit.sPaidAmt * 100, 0, Common::getInstance()->FnGetUtcTimestamp(Common::getInstance()->FnGetDateTimeFormat_yyyymmddhhmmss()), Common::getInstance()->FnGetUtcTimestamp(Common::getInstance()->FnGetDateTimeFormat_yyyymmddhhmmss()), tProcess.gsTransID);
+                }
+            });
     }
     else {
         gsCompareNo = tProcess.gsLastPaidTrans;
@@ -2445,28 +3066,61 @@ std::string operation::GetVTypeStr(int iVType)
                 if (tExit.sPaidAmt > 0) {
                     if (iDevicetype == Ant) EnableCashcard(true);
                 } 
-                else PBSExit (sCheckNo,iDevicetype,sCardNo,sCardType,sCardBal);   
+                else pbsExitFlow (flow,sCheckNo,iDevicetype,sCardNo,sCardType,sCardBal);   
             }
         } else{
-            PBSExit (sCheckNo,iDevicetype,sCardNo,sCardType,sCardBal);
+            pbsExitFlow (flow,sCheckNo,iDevicetype,sCardNo,sCardType,sCardBal);
         }
     }
  }
 
- void operation::PBSExit(string sIU, DeviceType iDevicetype, string sCardNo, int sCardType,float sCardBal)
+void operation::PBSExit(string sIU, DeviceType iDevicetype, string sCardNo, int sCardType,float sCardBal)
+{
+    AsyncFlow::getInstance()->FnStartFlow("PBSExit", [this, sIU, iDevicetype, sCardNo, sCardType, sCardBal](AsyncFlow::FlowPtr flow)
+    {
+        flow->FnSetBudget(decisionBudgetMs_);
+        pbsExitFlow(flow, sIU, iDevicetype, sCardNo, sCardType, sCardBal);
+    });
+}
+
+void operation::pbsExitFlow(AsyncFlow::FlowPtr flow, string sIU, DeviceType iDevicetype, string sCardNo, int sCardType, float sCardBal)
 {
-    int iRet;
-    CE_Time pt,pd,calTime;
-  
     if (sIU == tExit.sIUNo) return;
     tExit.sIUNo = sIU;
+    LogIndex::getInstance()->FnTagTransaction(sIU);
+    LogIndex::getInstance()->FnTagTransaction(sCardNo);
+
+    // Blacklist, entry record and season are looked up together, the results are handled in the original order
+    bool bFetchEntry = (tExit.bNoEntryRecord == -1);
+    auto lookup = std::make_shared<FlowLookup>();
+    auto joined = AsyncFlow::FnJoin(bFetchEntry ? 3 : 2, [this, flow, sIU, lookup]()
+    {
+        pbsExitLookedUp(flow, sIU, lookup->iBlackList, lookup->iEntry, lookup->iSeason);
+    });
+
+    AsyncFlow::getInstance()->FnRunStep<int>(flow, "IsBlackListIU", centralStepTimeoutMs(flow),
+        [this, sIU]() { return m_db->IsBlackListIU(sIU); }, -1,
+        [flow, lookup, joined](int iRet, bool timedOut)
+        {
+            flow->FnRecordSource("blacklist", timedOut ? "none" : "central", timedOut);
+            lookup->iBlackList = iRet;
+            joined();
+        });
+    //---Get Entry time
+    if (bFetchEntry)
+    {
+        FetchEntry(flow, sIU, [lookup, joined](int iRet) { lookup->iEntry = iRet; joined(); });
+    }
+    CheckSeason(flow, sIU, 2, [lookup, joined](int iRet) { lookup->iSeason = iRet; joined(); });
+}
 
+void operation::pbsExitLookedUp(AsyncFlow::FlowPtr flow, string sIU, int iBlackList, int iEntry, int iSeason)
+{
     //check blacklist
-    iRet = m_db->IsBlackListIU(sIU);
-    if (iRet >= 0){
+    if (iBlackList >= 0){
         ShowLEDMsg(tExitMsg.MsgExit_BlackList[0], tExitMsg.MsgExit_BlackList[1]);
         SendMsg2Server("90",sIU+",,,,,Blacklist IU");
-        if(iRet ==0) return;
+        if(iBlackList ==0) return;
     }
     //check block 
     string gsBlockIUPrefix = IniParser::getInstance()->FnGetBlockIUPrefix();
@@ -2477,105 +3131,130 @@ std::string operation::GetVTypeStr(int iVType)
         SendMsg2Server("90",sIU+",,,,,Block IU");
         return;
     }
-    //---Get Entry time
-    if (tExit.bNoEntryRecord == -1)
+    if (tExit.bNoEntryRecord == -1 && iEntry == 3)
     {
-        iRet = m_db->FetchEntryinfo(sIU);
-        if (iRet == 3)
-        {
-            // Partial Matching
-            writelog("No entry record found, proceed to partial matching", "OPR");
-            std::vector<EntryRecord> entryRecords;
-            int ret = m_db->fetchUnmatchedEntryInfo(entryRecords);
-            if (ret == 0)
+        // Partial Matching
+        writelog("No entry record found, proceed to partial matching", "OPR");
+        using UnmatchedEntries = std::pair<int, std::vector<EntryRecord>>;
+        AsyncFlow::getInstance()->FnRunStep<UnmatchedEntries>(flow, "fetchUnmatchedEntryInfo", centralStepTimeoutMs(flow),
+            [this]()
             {
-                try
-                {
-                    // Calculate the highest LPN matching rate
-                    LpnMatchScore highestWholeLpnMatchScore = {"", "", "0", "0", "0.00", 0, 0};
-                    LpnMatchScore highestDigitLpnMatchScore = {"", "", "0", "0", "0.00", 0, 0};
-                    for (const auto& entry : entryRecords)
-                    {
-                        int wholeLpnMatchRate = getMaxSimilarity(entry.lpn, sIU);
-                        int digitLpnMatchRate = getMaxSimilarity(getDigitFromString(entry.lpn), getDigitFromString(sIU));
-
-                        // Checks if the current whole match rate is STRICTLY higher than the max found so far.
-                        // Checks if whole rates are EQUAL AND the current digit rate is STRICTLY higher.
-                        if ((wholeLpnMatchRate > highestWholeLpnMatchScore.wholeLpnMatchRate)
-                            ||
-                            (wholeLpnMatchRate == highestWholeLpnMatchScore.wholeLpnMatchRate
-                            && digitLpnMatchRate > highestWholeLpnMatchScore.digitLpnMatchRate))
-                        {
-                            highestWholeLpnMatchScore.entryTime = entry.entryTime;
-                            highestWholeLpnMatchScore.lpn = entry.lpn;
-                            highestWholeLpnMatchScore.entryStn = entry.entryStn;
-                            highestWholeLpnMatchScore.transType = entry.transType;
-                            highestWholeLpnMatchScore.oweAmt = entry.oweAmt;
-                            highestWholeLpnMatchScore.wholeLpnMatchRate = wholeLpnMatchRate;
-                            highestWholeLpnMatchScore.digitLpnMatchRate = digitLpnMatchRate;
-                        }
-
-                        // Checks if the current digit match rate is STRICTLY higher than the max found so far.
-                        // Checks if digit rates are EQUAL AND the current whole rate is STRICTLY higher.
-                        if ((digitLpnMatchRate > highestWholeLpnMatchScore.digitLpnMatchRate)
-                            ||
-                            (digitLpnMatchRate == highestWholeLpnMatchScore.digitLpnMatchRate
-                            && wholeLpnMatchRate > highestDigitLpnMatchScore.wholeLpnMatchRate))
-                        {
-                            highestDigitLpnMatchScore.entryTime = entry.entryTime;
-                            highestDigitLpnMatchScore.lpn = entry.lpn;
-                            highestDigitLpnMatchScore.entryStn = entry.entryStn;
-                            highestDigitLpnMatchScore.transType = entry.transType;
-                            highestDigitLpnMatchScore.oweAmt = entry.oweAmt;
-                            highestDigitLpnMatchScore.wholeLpnMatchRate = wholeLpnMatchRate;
-                            highestDigitLpnMatchScore.digitLpnMatchRate = digitLpnMatchRate;
-                        }
-                    }
-
-                    if (highestDigitLpnMatchScore.digitLpnMatchRate >= IniParser::getInstance()->FnGetDigitLpnMatchRateThreshold())
-                    {
-                        tExit.sEntryTime = highestDigitLpnMatchScore.entryTime;
-                        tExit.iTransType = std::stoi(highestDigitLpnMatchScore.transType);
-                        tExit.sOweAmt = std::stof(highestDigitLpnMatchScore.oweAmt);
-                        tExit.iEntryID = std::stoi(highestDigitLpnMatchScore.entryStn);
-                        writelog("Highest Digit rate LPN : " + std::string(highestDigitLpnMatchScore.lpn) + " with digit rate of : " + std::to_string(highestDigitLpnMatchScore.digitLpnMatchRate), "OPR");
-                        writelog("Exit LPN : " + tExit.sLPN[0] + " matched with outstanding entry in movement_trans : " + std::string(highestDigitLpnMatchScore.lpn) + " matched with digit rate >= 75", "OPR");
-                    }
-                    else if (highestWholeLpnMatchScore.wholeLpnMatchRate > IniParser::getInstance()->FnGetWholeLpnMatchRateThreshold())
-                    {
-                        tExit.sEntryTime = highestWholeLpnMatchScore.entryTime;
-                        tExit.iTransType = std::stoi(highestWholeLpnMatchScore.transType);
-                        tExit.sOweAmt = std::stof(highestWholeLpnMatchScore.oweAmt);
-                        tExit.iEntryID = std::stoi(highestWholeLpnMatchScore.entryStn);
-                        writelog("Highest Whole rate LPN : " + std::string(highestWholeLpnMatchScore.lpn) + " with whole rate of : " + std::to_string(highestWholeLpnMatchScore.wholeLpnMatchRate), "OPR");
-                        writelog("Exit LPN : " + tExit.sLPN[0] + " matched with outstanding entry in movement_trans : " + std::string(highestWholeLpnMatchScore.lpn) + " matched with whole rate > 60", "OPR");
-                    }
-                    else
-                    {
-                        writelog("No partial matching found for Exit LPN : " +  tExit.sLPN[0] + " in movement_trans",  "OPR");
-                        writelog("Highest Digit rate LPN : " + std::string(highestDigitLpnMatchScore.lpn) + " with digit rate of : " + std::to_string(highestDigitLpnMatchScore.digitLpnMatchRate), "OPR");
-                        writelog("Highest Whole rate LPN : " + std::string(highestWholeLpnMatchScore.lpn) + " with whole rate of : " + std::to_string(highestWholeLpnMatchScore.wholeLpnMatchRate), "OPR");
-                    }
-                }
-                catch (const std::exception& e)
+                UnmatchedEntries entries;
+                entries.first = m_db->fetchUnmatchedEntryInfo(entries.second);
+                return entries;
+            },
+            UnmatchedEntries(-1, std::vector<EntryRecord>()),
+            [this, flow, sIU, iSeason](UnmatchedEntries entries, bool timedOut)
+            {
+                flow->FnRecordSource("partial match", timedOut ? "none" : "central", timedOut);
+                if (entries.first == 0)
                 {
-                    std::stringstream ss;
-                    ss << __func__ << ", Exception: " << e.what();
-                    Logger::getInstance()->FnLogExceptionError(ss.str());
+                    matchPartialEntry(entries.second, sIU);
                 }
-                catch (...)
+                else
                 {
-                    std::stringstream ss;
-                    ss << __func__ << ", Exception: Unknown Exception";
-                    Logger::getInstance()->FnLogExceptionError(ss.str());
+                    writelog("Failed to fetched unmatched Entry records.",  "OPR");
                 }
+                pbsExitEntryResolved(flow, sIU, iSeason);
+            });
+        return;
+    }
+    pbsExitEntryResolved(flow, sIU, iSeason);
+}
+
+void operation::matchPartialEntry(const std::vector<EntryRecord>& entryRecords, const string& sIU)
+{
+    try
+    {
+        // Calculate the highest LPN matching rate
+        LpnMatchScore highestWholeLpnMatchScore = {"", "", "0", "0", "0.00", 0, 0};
+        LpnMatchScore highestDigitLpnMatchScore = {"", "", "0", "0", "0.00", 0, 0};
+        for (const auto& entry : entryRecords)
+        {
+            int wholeLpnMatchRate = getMaxSimilarity(entry.lpn, sIU);
+            int digitLpnMatchRate = getMaxSimilarity(getDigitFromString(entry.lpn), getDigitFromString(sIU));
+
+            // Checks if the current whole match rate is STRICTLY higher than the max found so far.
+            // Checks if whole rates are EQUAL AND the current digit rate is STRICTLY higher.
+            if ((wholeLpnMatchRate > highestWholeLpnMatchScore.wholeLpnMatchRate)
+                ||
+                (wholeLpnMatchRate == highestWholeLpnMatchScore.wholeLpnMatchRate
+                && digitLpnMatchRate > highestWholeLpnMatchScore.digitLpnMatchRate))
+            {
+                highestWholeLpnMatchScore.entryTime = entry.entryTime;
+                highestWholeLpnMatchScore.lpn = entry.lpn;
+                highestWholeLpnMatchScore.entryStn = entry.entryStn;
+                highestWholeLpnMatchScore.transType = entry.transType;
+                highestWholeLpnMatchScore.oweAmt = entry.oweAmt;
+                highestWholeLpnMatchScore.wholeLpnMatchRate = wholeLpnMatchRate;
+                highestWholeLpnMatchScore.digitLpnMatchRate = digitLpnMatchRate;
             }
-            else
+
+            // Checks if the current digit match rate is STRICTLY higher than the max found so far.
+            // Checks if digit rates are EQUAL AND the current whole rate is STRICTLY higher.
+            if ((digitLpnMatchRate > highestWholeLpnMatchScore.digitLpnMatchRate)
+                ||
+                (digitLpnMatchRate == highestWholeLpnMatchScore.digitLpnMatchRate
+                && wholeLpnMatchRate > highestDigitLpnMatchScore.wholeLpnMatchRate))
             {
-                writelog("Failed to fetched unmatched Entry records.",  "OPR");
+                highestDigitLpnMatchScore.entryTime = entry.entryTime;
+                highestDigitLpnMatchScore.lpn = entry.lpn;
+                highestDigitLpnMatchScore.entryStn = entry.entryStn;
+                highestDigitLpnMatchScore.transType = entry.transType;
+                highestDigitLpnMatchScore.oweAmt = entry.oweAmt;
+                highestDigitLpnMatchScore.wholeLpnMatchRate = wholeLpnMatchRate;
+                highestDigitLpnMatchScore.digitLpnMatchRate = digitLpnMatchRate;
             }
         }
 
+        if (highestDigitLpnMatchScore.digitLpnMatchRate >= IniParser::getInstance()->FnGetDigitLpnMatchRateThreshold())
+        {
+            tExit.sEntryTime = highestDigitLpnMatchScore.entryTime;
+            tExit.iTransType = std::stoi(highestDigitLpnMatchScore.transType);
+            tExit.sOweAmt = std::stof(highestDigitLpnMatchScore.oweAmt);
+            tExit.iEntryID = std::stoi(highestDigitLpnMatchScore.entryStn);
+            writelog("Highest Digit rate LPN : " + std::string(highestDigitLpnMatchScore.lpn) + " with digit rate of : " + std::to_string(highestDigitLpnMatchScore.digitLpnMatchRate), "OPR");
+            writelog("Exit LPN : " + tExit.sLPN[0] + " matched with outstanding entry in movement_trans : " + std::string(highestDigitLpnMatchScore.lpn) + " matched with digit rate >= 75", "OPR");
+        }
+        else if (highestWholeLpnMatchScore.wholeLpnMatchRate > IniParser::getInstance()->FnGetWholeLpnMatchRateThreshold())
+        {
+            tExit.sEntryTime = highestWholeLpnMatchScore.entryTime;
+            tExit.iTransType = std::stoi(highestWholeLpnMatchScore.transType);
+            tExit.sOweAmt = std::stof(highestWholeLpnMatchScore.oweAmt);
+            tExit.iEntryID = std::stoi(highestWholeLpnMatchScore.entryStn);
+            writelog("Highest Whole rate LPN : " + std::string(highestWholeLpnMatchScore.lpn) + " with whole rate of : " + std::to_string(highestWholeLpnMatchScore.wholeLpnMatchRate), "OPR");
+            writelog("Exit LPN : " + tExit.sLPN[0] + " matched with outstanding entry in movement_trans : " + std::string(highestWholeLpnMatchScore.lpn) + " matched with whole rate > 60", "OPR");
+        }
+        else
+        {
+            writelog("No partial matching found for Exit LPN : " +  tExit.sLPN[0] + " in movement_trans",  "OPR");
+            writelog("Highest Digit rate LPN : " + std::string(highestDigitLpnMatchScore.lpn) + " with digit rate of : " + std::to_string(highestDigitLpnMatchScore.digitLpnMatchRate), "OPR");
+            writelog("Highest Whole rate LPN : " + std::string(highestWholeLpnMatchScore.lpn) + " with whole rate of : " + std::to_string(highestWholeLpnMatchScore.wholeLpnMatchRate), "OPR");
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::stringstream ss;
+        ss << __func__ << ", Exception: " << e.what();
+        Logger::getInstance()->FnLogExceptionError(ss.str());
+    }
+    catch (...)
+    {
+        std::stringstream ss;
+        ss << __func__ << ", Exception: Unknown Exception";
+        Logger::getInstance()->FnLogExceptionError(ss.str());
+    }
+}
+
+void operation::pbsExitEntryResolved(AsyncFlow::FlowPtr flow, string sIU, int iSeason)
+{
+    string sMsg;
+    string sLCD;
+
+    flow->FnMarkDecided();
+
+    if (tExit.bNoEntryRecord == -1)
+    {
         if (tExit.sEntryTime == "") {
              tExit.bNoEntryRecord = 1;
              tExit.lParkedTime = -1;
@@ -2589,7 +3268,20 @@ std::string operation::GetVTypeStr(int iVType)
 
     tExit.iVehicleType = (tExit.iTransType - 1 )/3;
 
-    iRet = CheckSeason(sIU,2);
+    //showLED message
+    if (iSeason != 8 ) {
+        FormatSeasonMsg(iSeason, sIU, sMsg, sLCD);
+    }
+    AsyncFlow::getInstance()->FnDelay(flow, seasonMsgHoldMs(iSeason), [this, flow, sIU, iSeason]()
+    {
+        pbsExitSeasonShown(flow, sIU, iSeason);
+    });
+}
+
+void operation::pbsExitSeasonShown(AsyncFlow::FlowPtr flow, string sIU, int iRet)
+{
+    CE_Time pt,pd,calTime;
+    int iHoldMs = 0;
 
     if (iRet == 1 or iRet == 12 or iRet == 9)
     {   
@@ -2598,7 +3290,7 @@ std::string operation::GetVTypeStr(int iVType)
             tExit.sFee = 0;
             tExit.sPaidAmt = 0;
             tExit.sExitTime = Common::getInstance()->FnGetDateTimeFormat_yyyy_mm_dd_hh_mm_ss();
-            CloseExitOperation(SeasonParking);
+            closeExitFlow(flow, SeasonParking);
             return;
         }
     }
@@ -2609,7 +3301,7 @@ std::string operation::GetVTypeStr(int iVType)
             tExit.sPaidAmt = 0;
             tExit.sCardNo = tExit.sRedeemNo;
             ShowLEDMsg("No Entry Record^Compl Ticket","No Entry Record^Compl Ticket");
-            CloseExitOperation(FreeParking);
+            closeExitFlow(flow, FreeParking);
             EnableCashcard(false);
             return;
         }     
@@ -2653,7 +3345,7 @@ std::string operation::GetVTypeStr(int iVType)
                     tExit.sFee = CalFeeRAM(tExit.sEntryTime, tSeason.date_from, tExit.iVehicleType);
                     ShowLEDMsg("Season Start On^" + tSeason.date_from.substr(0,16),"Season Start On^" + tSeason.date_from.substr(0,16));
                     //-----
-                   std::this_thread::sleep_for(std::chrono::milliseconds(500));
+                    iHoldMs = SEASON_MSG_HOLD_MS;
                 } else
                 {
                     tExit.sFee = CalFeeRAM(tExit.sEntryTime, tExit.sExitTime, tExit.iVehicleType);
@@ -2666,20 +3358,28 @@ std::string operation::GetVTypeStr(int iVType)
                 writelog ("Season expired. EntryTime early than date to, cal fee for date to ~ exit", "OPR");
                 tExit.sFee = CalFeeRAM(tSeason.date_to, tExit.sExitTime, tExit.iVehicleType);
                 ShowLEDMsg("Season Expire On^" + tSeason.date_to.substr(0,16) ,"Season Expire On^" + tSeason.date_to.substr(0,16));
-                std::this_thread::sleep_for(std::chrono::milliseconds(500));
+                iHoldMs = SEASON_MSG_HOLD_MS;
             } else
             {
                 tExit.sFee = CalFeeRAM(tExit.sEntryTime, tExit.sExitTime, tExit.iVehicleType);
             }
         }
-        //------ whole day season 
-        if ((iRet == 1 && std::stoi(tSeason.rate_type) == 0) or iRet == 9 or iRet == 12)
-        {
-            if (iRet == 9) { tExit.iTransType = 10;}
-            tExit.sPaidAmt = 0;
-            CloseExitOperation(SeasonParking);
-            return;
-        }
+    }
+    AsyncFlow::getInstance()->FnDelay(flow, iHoldMs, [this, flow, iRet]()
+    {
+        pbsExitFeeCalculated(flow, iRet);
+    });
+}
+
+void operation::pbsExitFeeCalculated(AsyncFlow::FlowPtr flow, int iRet)
+{
+    //------ whole day season 
+    if (tExit.bNoEntryRecord != 1 && ((iRet == 1 && std::stoi(tSeason.rate_type) == 0) or iRet == 9 or iRet == 12))
+    {
+        if (iRet == 9) { tExit.iTransType = 10;}
+        tExit.sPaidAmt = 0;
+        closeExitFlow(flow, SeasonParking);
+        return;
     }
     //-------
     if (tExit.iRedeemTime > 0) RedeemTime2Amt();
@@ -2689,6 +3389,11 @@ std::string operation::GetVTypeStr(int iVType)
     //------
     writelog("Total paid Amt: " + Common::getInstance()->SetFeeFormat(tExit.sPaidAmt), "OPR");
     //------
+    AsyncFlow::getInstance()->FnDelay(flow, FEE_MSG_DELAY_MS, [this, flow]() { pbsExitCharge(flow); });
+}
+
+void operation::pbsExitCharge(AsyncFlow::FlowPtr flow)
+{
     showFee2User();
     //-------------
    // ShowLEDMsg("Fee: RM"+ Common::getInstance()->SetFeeFormat(tExit.sPaidAmt) +"^Please Wait...","Fee: RM"+ Common::getInstance()->SetFeeFormat(tExit.sPaidAmt) +"^Please Wait...");
@@ -2698,7 +3403,7 @@ std::string operation::GetVTypeStr(int iVType)
         tExit.sPaidAmt = 0;
         tExit.sCardNo = tExit.sRedeemNo;
         ShowLEDMsg("Fee: RM"+ Common::getInstance()->SetFeeFormat(tExit.sPaidAmt) +"^Compl Ticket","Fee: RM"+ Common::getInstance()->SetFeeFormat(tExit.sPaidAmt) +"^Compl Ticket");
-        CloseExitOperation(FreeParking);
+        closeExitFlow(flow, FreeParking);
         EnableCashcard(false);
         return;
    } 
@@ -2722,9 +3427,8 @@ std::string operation::GetVTypeStr(int iVType)
     }
     else
     {
-       CloseExitOperation(FreeParking);
+       closeExitFlow(flow, FreeParking);
     } 
-
 }
 
 float operation::CalFeeRAM(string eTime, string payTime,int iTransType, bool bNoGT)
@@ -2732,20 +3436,23 @@ float operation::CalFeeRAM(string eTime, string payTime,int iTransType, bool bNo
     
     float parkingfee;
     
-    parkingfee = m_db->CalFeeRAM2G(eTime,payTime,iTransType);
+    parkingfee = m_db->CalFeeRAM2G(eTime,payTime,iTransType,false,&tExit.iTariffVersion);
    
     return parkingfee;
 }
 
-void operation::SaveExit()
+void operation::SaveExit(AsyncFlow::FlowPtr flow, std::function<void()> next)
 {
-    int iRet;
     int giPMSEntryRecord = 0;
     std::string sLPRNo = "";
     CE_Time pt,pd,calTime;
     
-    if (tExit.sIUNo== "") return;
-    writelog ("Save Exit trans:"+ tExit.sIUNo, "OPR");
+    if (tExit.sIUNo== "")
+    {
+        next();
+        return;
+    }
+    writelog ("Save Exit trans:"+ tExit.sIUNo + ", tariff version:" + std::to_string(tExit.iTariffVersion), "OPR");
     //----
     if (tExit.sRedeemAmt > (tExit.sFee - tExit.sRebateAmt + tExit.sOweAmt)) tExit.sRedeemAmt = tExit.sFee - tExit.sRebateAmt + tExit.sOweAmt;
     //----
@@ -2755,26 +3462,6 @@ void operation::SaveExit()
         pd.SetTime(tExit.sExitTime);
         tExit.lParkedTime = calTime.diffmin(pt.GetUnixTimestamp(), pd.GetUnixTimestamp());
     }
-    //----
-    iRet = db::getInstance()->insertexittrans(tExit);
-    if (iRet == iCentralSuccess){
-        if (tExit.bNoEntryRecord == 0 && giPMSEntryRecord == 0 ) {
-            iRet = db::getInstance()->updatemovementtrans(tExit);
-        }else  {
-            iRet = db::getInstance()->insert2movementtrans(tExit);
-        }
-    }
-    //------ delete Local Entry
-    db::getInstance()->UpdateLocalEntry(tExit.sIUNo);
-    //----
-    if (iRet == iCentralSuccess or iRet == iLocalSuccess)
-    {
-        tProcess.setLastIUNo(tExit.sIUNo);
-        tProcess.setLastPaidTrans(tExit.sIUNo);
-        tProcess.setLastTransTime(std::chrono::steady_clock::now());
-    }
-    //-------
-    tPBSError[iDB].ErrNo = (iRet == iCentralSuccess or iRet == iLocalSuccess) ? 0 : (iRet == iCentralFail) ? -1 : -2;
 
     if ((tExit.sLPN[0] != "") or (tExit.sLPN[1] != ""))
 	{
@@ -2788,19 +3475,71 @@ void operation::SaveExit()
 		}
 	}
 
-    std::string sMsg2Send = (iRet == iCentralSuccess or iRet == iLocalSuccess) ? "Exit OK" : (iRet == iCentralFail) ? "Exit Central Failed" : "Exit Local Failed";
+    // Saved from a copy, the result may arrive after the barrier opened and Clearme() ran
+    auto exitTrans = std::make_shared<tExitTrans_Struct>(tExit);
+    int iShowType = tProcess.giShowType;
+    auto exitSaved = [this, exitTrans, sLPRNo, iShowType](int iRet)
+    {
+        if (iRet == iCentralSuccess or iRet == iLocalSuccess)
+        {
+            tProcess.setLastIUNo(exitTrans->sIUNo);
+            tProcess.setLastPaidTrans(exitTrans->sIUNo);
+            tProcess.setLastTransTime(std::chrono::steady_clock::now());
+
+            // Answers the paid within period check when the vehicle comes back
+            PaidExitCache::PaidExit paidExit{exitTrans->sExitTime, exitTrans->sPaidAmt, exitTrans->iTransType};
+            for (const std::string& key : {exitTrans->sIUNo, exitTrans->sCardNo, sLPRNo})
+            {
+                PaidExitCache::getInstance()->FnRecord(key, paidExit);
+            }
+        }
+        //-------
+        tPBSError[iDB].ErrNo = (iRet == iCentralSuccess or iRet == iLocalSuccess) ? 0 : (iRet == iCentralFail) ? -1 : -2;
+
+        std::string sMsg2Send = (iRet == iCentralSuccess or iRet == iLocalSuccess) ? "Exit OK" : (iRet == iCentralFail) ? "Exit Central Failed" : "Exit Local Failed";
 
-    sMsg2Send = tExit.sIUNo + "," + tExit.sCardNo + "," + Common::getInstance()->SetFeeFormat(tExit.sPaidAmt) + "," + sLPRNo + "," + std::to_string(tProcess.giShowType) + "," + sMsg2Send;
+        sMsg2Send = exitTrans->sIUNo + "," + exitTrans->sCardNo + "," + Common::getInstance()->SetFeeFormat(exitTrans->sPaidAmt) + "," + sLPRNo + "," + std::to_string(iShowType) + "," + sMsg2Send;
+
+        if (exitTrans->iStatus == 0) {
+            SendMsg2Server("90", sMsg2Send);
+        }
+    };
 
-    if (tExit.iStatus == 0) {
-        SendMsg2Server("90", sMsg2Send);
-    }
     tProcess.gbsavedtrans = true;
     tExit.gbPaid.store(true);
     if (tExit.sPaidAmt == 0) {
         tProcess.gsLastCardNo = tExit.sCardNo;
         tProcess.gbLastPaidStatus.store(true);
     }
+
+    AsyncFlow::getInstance()->FnRunStep<int>(flow, "SaveExit", dbSaveTimeoutMs_,
+        [exitTrans, giPMSEntryRecord]()
+        {
+            int iRet = db::getInstance()->insertexittrans(*exitTrans);
+            if (iRet == iCentralSuccess){
+                if (exitTrans->bNoEntryRecord == 0 && giPMSEntryRecord == 0 ) {
+                    iRet = db::getInstance()->updatemovementtrans(*exitTrans);
+                }else  {
+                    iRet = db::getInstance()->insert2movementtrans(*exitTrans);
+                }
+            }
+            //------ delete Local Entry
+            db::getInstance()->UpdateLocalEntry(exitTrans->sIUNo);
+            return iRet;
+        }, static_cast<int>(iCentralFail),
+        [this, exitTrans, exitSaved, next](int iRet, bool timedOut)
+        {
+            if (timedOut)
+            {
+                writelog ("Save Exit still pending on DB:"+ exitTrans->sIUNo, "OPR");
+            }
+            else
+            {
+                exitSaved(iRet);
+            }
+            next();
+        },
+        exitSaved);
 }
 
 float operation::GfeeFormat(float value) {
@@ -2808,6 +3547,14 @@ float operation::GfeeFormat(float value) {
 }
 
 void operation::CloseExitOperation(TransType iStatus)
+{
+    AsyncFlow::getInstance()->FnStartFlow("CloseExitOperation", [this, iStatus](AsyncFlow::FlowPtr flow)
+    {
+        closeExitFlow(flow, iStatus);
+    });
+}
+
+void operation::closeExitFlow(AsyncFlow::FlowPtr flow, TransType iStatus)
 {
    
     string sLEDMsg = "";
@@ -2869,10 +3616,8 @@ void operation::CloseExitOperation(TransType iStatus)
     }
 
     if (sLEDMsg != "") ShowLEDMsg(sLEDMsg,sLCDMsg);
-
     writelog ("Enter close Exit for: " + tExit.sIUNo, "OPR");
-    SaveExit();
-    Openbarrier();
+    SaveExit(flow, [this]() { Openbarrier(); });
 }
 
 void operation::RedeemTime2Amt() 
@@ -2940,12 +3685,7 @@ void operation::RedeemTime2Amt()
 
 void operation::ticketScan(std::string skeyedNo)
 {
-    int iRet = 0;
     std::string sCardTkNo = "";
-    std::tm dtExpireTime;
-    double gbRedeemAmt = 0.00;
-    int giRedeemTime = 0;
-    std::string sMsg = "";
     long lParkTime = 0;
     std::string TT = "";
     bool isRedemptionTicket = false;
@@ -3048,9 +3788,36 @@ void operation::ticketScan(std::string skeyedNo)
         goto Exit_Sub;
     }
 
+    // The ticket tables are central only, no local table can answer for a ticket. A central DB that does not
+    // reply in time is handled as a DB error, the ticket can be scanned again.
+    AsyncFlow::getInstance()->FnStartFlow("TicketScan", [this, skeyedNo, sCardTkNo, isRedemptionTicket](AsyncFlow::FlowPtr flow)
+    {
+        using TicketLookup = std::pair<int, BarcodeTicketInfo>;
+        AsyncFlow::getInstance()->FnRunStep<TicketLookup>(flow, "isValidBarCodeTicket", dbStepTimeoutMs_,
+            [skeyedNo, isRedemptionTicket]()
+            {
+                TicketLookup ticket(-1, BarcodeTicketInfo());
+                ticket.first = db::getInstance()->isValidBarCodeTicket(isRedemptionTicket, skeyedNo, ticket.second.dtExpireTime, ticket.second.gbRedeemAmt, ticket.second.giRedeemTime);
+                return ticket;
+            },
+            TicketLookup(-1, BarcodeTicketInfo()),
+            [this, flow, sCardTkNo, isRedemptionTicket](TicketLookup ticket, bool timedOut)
+            {
+                flow->FnRecordSource("ticket", timedOut ? "none" : "central");
+                ticketLookedUp(flow, sCardTkNo, isRedemptionTicket, ticket.first, ticket.second);
+            });
+    });
+    return;
+
+Exit_Sub:
+    ticketRejected();
+}
+
+void operation::ticketLookedUp(AsyncFlow::FlowPtr flow, std::string sCardTkNo, bool isRedemptionTicket, int iRet, const BarcodeTicketInfo& ticket)
+{
+    std::string sMsg = "";
+
     // Ret : 0 = Expired, 1 = Valid, 2 = Used, 6 = Not Started, -1 = DB Error, 4 = Not Found
-    iRet = db::getInstance()->isValidBarCodeTicket(isRedemptionTicket, skeyedNo, dtExpireTime, gbRedeemAmt, giRedeemTime);
-   
     switch (iRet)
     {
         // DB Error
@@ -3086,11 +3853,11 @@ void operation::ticketScan(std::string skeyedNo)
             //--------
             if (isRedemptionTicket == true)
             {
-                writelog("Redemption Ticket: " + sCardTkNo + ", Expire: " + Common::getInstance()->FnFormatDateTime(dtExpireTime, "%Y-%m-%d %H:%M:%S"), "OPR");
+                writelog("Redemption Ticket: " + sCardTkNo + ", Expire: " + Common::getInstance()->FnFormatDateTime(ticket.dtExpireTime, "%Y-%m-%d %H:%M:%S"), "OPR");
 
-                if (giRedeemTime > 0)
+                if (ticket.giRedeemTime > 0)
                 {
-                    tExit.iRedeemTime = giRedeemTime;
+                    tExit.iRedeemTime = ticket.giRedeemTime;
                     sMsg = "Redemption: ^" + std::to_string(tExit.iRedeemTime) + " Mins";
                     if(tExit.sPaidAmt > 0) {
                         writelog ("Call Redeemtime2Amt", "OPR");
@@ -3099,7 +3866,7 @@ void operation::ticketScan(std::string skeyedNo)
                 }
                 else
                 {
-                    tExit.sRedeemAmt = GfeeFormat(gbRedeemAmt);
+                    tExit.sRedeemAmt = GfeeFormat(ticket.gbRedeemAmt);
                     sMsg = "Redemption: ^RM" + Common::getInstance()->SetFeeFormat(tExit.sRedeemAmt);
                 }
 
@@ -3138,7 +3905,7 @@ void operation::ticketScan(std::string skeyedNo)
                 // Complimentary
             else
             {
-                writelog("Complimentary Ticket: " + sCardTkNo + ", Expire: " + Common::getInstance()->FnFormatDateTime(dtExpireTime, "%Y-%m-%d %H:%M:%S"), "OPR");
+                writelog("Complimentary Ticket: " + sCardTkNo + ", Expire: " + Common::getInstance()->FnFormatDateTime(ticket.dtExpireTime, "%Y-%m-%d %H:%M:%S"), "OPR");
 
                 if (tParas.giNeedCard4Complimentary  == 0)
                 {
@@ -3154,7 +3921,7 @@ void operation::ticketScan(std::string skeyedNo)
                         tExit.sRedeemAmt = GfeeFormat(tExit.sFee);
                         tExit.sPaidAmt = 0;
                         tExit.sGSTAmt = 0;
-                        db::getInstance()->update99PaymentTrans();
+                        update99PaymentTrans(flow);
                         return;
                     }
                 }
@@ -3177,7 +3944,7 @@ void operation::ticketScan(std::string skeyedNo)
                             tExit.sRedeemAmt = GfeeFormat(tExit.sFee);
                             tExit.sPaidAmt = 0;
                             tExit.sGSTAmt = 0;
-                            db::getInstance()->update99PaymentTrans();
+                            update99PaymentTrans(flow);
                             return;
                         }
                         ShowLEDMsg(tExitMsg.MsgExit_Complimentary[0], tExitMsg.MsgExit_Complimentary[1]);
@@ -3223,7 +3990,11 @@ void operation::ticketScan(std::string skeyedNo)
     }
 
 Exit_Sub:
+    ticketRejected();
+}
 
+void operation::ticketRejected()
+{
     showFee2User();
 
     if (tExit.bPayByEZPay == true)
@@ -3232,8 +4003,23 @@ Exit_Sub:
     }
 
     EnableCashcard(true);
+}
 
-    return;
+void operation::update99PaymentTrans(AsyncFlow::FlowPtr flow)
+{
+    // The EZPay refund is written from a copy, Clearme() may run before central answers
+    auto exitTrans = std::make_shared<tExitTrans_Struct>(tExit);
+    int iSID = gtStation.iSID;
+    AsyncFlow::getInstance()->FnRunStep<int>(flow, "update99PaymentTrans", dbSaveTimeoutMs_,
+        [exitTrans, iSID]() { return static_cast<int>(db::getInstance()->update99PaymentTrans(*exitTrans, iSID)); },
+        static_cast<int>(iCentralFail),
+        [this, exitTrans](int iRet, bool timedOut)
+        {
+            if (timedOut)
+            {
+                writelog ("Update 99 Trans still pending on DB:"+ exitTrans->sIUNo, "OPR");
+            }
+        });
 }
 
 void operation::ticketOK()
@@ -3276,7 +4062,6 @@ void operation::showFee2User(bool bPaying)
 
     std::string sMsg = sUpp + "^" + sLow;
 
-    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
     ShowLEDMsg(sMsg, sMsg);
 
     std::string exit_entry_time = "00:00";
@@ -3303,33 +4088,37 @@ void operation::showFee2User(bool bPaying)
 
 void operation::ReceivedEntryRecord()
 {
-    CE_Time pt,pd,calTime;
-
-    tExit.sExitTime = Common::getInstance()->FnGetDateTimeFormat_yyyy_mm_dd_hh_mm_ss();
+    AsyncFlow::getInstance()->FnStartFlow("ReceivedEntryRecord", [this](AsyncFlow::FlowPtr flow)
+    {
+        tExit.sExitTime = Common::getInstance()->FnGetDateTimeFormat_yyyy_mm_dd_hh_mm_ss();
 
-    writelog("Cal Fee Time: " + tExit.sExitTime, "OPR");
-    
-    tExit.sFee = CalFeeRAM(tExit.sEntryTime, tExit.sExitTime, tExit.iVehicleType);
-    //--------------
-    if (tExit.iRedeemTime > 0) RedeemTime2Amt();
-    //-----
-    tExit.sPaidAmt = GfeeFormat(tExit.sFee - tExit.sRebateAmt - tExit.sRedeemAmt + tExit.sOweAmt);
+        writelog("Cal Fee Time: " + tExit.sExitTime, "OPR");
+        
+        tExit.sFee = CalFeeRAM(tExit.sEntryTime, tExit.sExitTime, tExit.iVehicleType);
+        //--------------
+        if (tExit.iRedeemTime > 0) RedeemTime2Amt();
+        //-----
+        tExit.sPaidAmt = GfeeFormat(tExit.sFee - tExit.sRebateAmt - tExit.sRedeemAmt + tExit.sOweAmt);
 
-    if (tExit.sPaidAmt < 0)  tExit.sPaidAmt = 0;
-    //------
-    writelog("Total paid Amt: " + Common::getInstance()->SetFeeFormat(tExit.sPaidAmt), "OPR");
-    //------
-    showFee2User();
-    //-------------
-    if (tExit.sPaidAmt > 0) 
-    {
-        tExit.giDeductionStatus = WaitingCard;
-        EnableCashcard(true);
-    }
-    else
-    {
-       CloseExitOperation(FreeParking);
-    } 
+        if (tExit.sPaidAmt < 0)  tExit.sPaidAmt = 0;
+        //------
+        writelog("Total paid Amt: " + Common::getInstance()->SetFeeFormat(tExit.sPaidAmt), "OPR");
+        //------
+        AsyncFlow::getInstance()->FnDelay(flow, FEE_MSG_DELAY_MS, [this, flow]()
+        {
+            showFee2User();
+            //-------------
+            if (tExit.sPaidAmt > 0) 
+            {
+                tExit.giDeductionStatus = WaitingCard;
+                EnableCashcard(true);
+            }
+            else
+            {
+               closeExitFlow(flow, FreeParking);
+            } 
+        });
+    });
 }
 
 void operation::processTnGResponse(const std::string& respCmd, const std::string& sResult)
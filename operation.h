@@ -1,15 +1,22 @@
 #pragma once
 
 #include <stdio.h>
+#include <array>
+#include <functional>
 #include <string>
 #include <sstream>
 #include <iostream>
 #include <mutex>
+#include <map>
 #include <queue>
+#include "async_flow.h"
+#include "boot_sequence.h"
+#include "lane_context.h"
 #include "structuredata.h"
 #include "db.h"
 #include "udp.h"
 #include "lpr.h"
+#include "lazy_instance.h"
 
 typedef enum : unsigned int
 {
@@ -59,6 +66,7 @@ public:
     void OperationInit(io_context& ioContext);
     bool FnIsOperationInitialized() const;
     void LoopACome();
+    void VehicleClassified(int vechicleType);
     void LoopAGone();
     void LoopCCome();
     void LoopCGone();
@@ -81,15 +89,18 @@ public:
     void FnSendCmdDownloadParamAckToMonitor(bool success);
     void FnSendCmdDownloadIniAckToMonitor(bool success);
     void FnSendCmdGetStationCurrLogToMonitor();
+    void FnSendBootTimelineToMonitor();
+    void FnSendDIOSequencerToMonitor();
     bool CopyIniFile(const std::string& serverIpAddress, const std::string& stationID);
     void SendMsg2Monitor(string cmdcode,string dstr);
     void SendMsg2Server(string cmdcode,string dstr);
-    int  CheckSeason(string sIU,int iInOut);
+    void CheckSeason(AsyncFlow::FlowPtr flow, string sIU, int iInOut, std::function<void(int)> next);
+    void FetchEntry(AsyncFlow::FlowPtr flow, string sIU, std::function<void(int)> next);
     void writelog(string sMsg, string soption);
     void HandlePBSError(EPSError iEPSErr, int iErrCode=0);
     int  GetVTypeFromLoop();
-    void SaveEntry();
-    void SaveExit();
+    void SaveEntry(AsyncFlow::FlowPtr flow, std::function<void()> next);
+    void SaveExit(AsyncFlow::FlowPtr flow, std::function<void()> next);
     void CloseExitOperation(TransType iStatus);
     void ShowTotalLots(std::string totallots, std::string LEDId = "***");
     void FormatSeasonMsg(int iReturn, string sNo, string sMsg, string sLCD, int iExpires=-1);
@@ -143,8 +154,19 @@ public:
     
 private:
     
-    static operation* operation_;
+    // How long a message stays on the display before the flow shows the next one
+    static const int SEASON_MSG_HOLD_MS = 500;
+    static const int FEE_MSG_DELAY_MS = 1000;
+
+    // One operation per lane, see LaneContext
+    static std::array<std::atomic<operation*>, LaneContext::MAX_LANES> operations_;
     static std::mutex mutex_;
+    int laneId_;
+    std::shared_ptr<BootSequence> bootSequence_;
+    // The lane's configuration was replayed from its config snapshot rather than read from the local DB
+    bool isConfigFromSnapshot_;
+    // What the centralparams boot phase fetched, set on the flow strand and applied again after a reload
+    std::shared_ptr<CentralParams> centralParams_;
     std::unique_ptr<boost::asio::io_context::strand> operationStrand_;
     std::unique_ptr<boost::asio::steady_timer> pLCDIdleTimer_;
     std::unique_ptr<boost::asio::steady_timer> pLoopATimer_;
@@ -155,16 +177,48 @@ private:
     std::mutex queueMutex_;
     std::string lastLEDMsg_;
     std::string lastLCDMsg_;
+    int dbStepTimeoutMs_;
+    int dbSaveTimeoutMs_;
+    // Entry/exit flows decide within decisionBudgetMs_ (0 = no budget), localLookupMs_ of it is kept for the local DB
+    int decisionBudgetMs_;
+    int localLookupMs_;
+    int centralStepTimeoutMs(const AsyncFlow::FlowPtr& flow) const;
+    int localStepTimeoutMs(const AsyncFlow::FlowPtr& flow) const;
+    void applyEntryInfo(int iRet, const EntryInfo& entryInfo);
+    void applySeasonInfo(const SeasonInfo& season);
+    void ticketLookedUp(AsyncFlow::FlowPtr flow, std::string sCardTkNo, bool isRedemptionTicket, int iRet, const BarcodeTicketInfo& ticket);
+    void ticketRejected();
+    void update99PaymentTrans(AsyncFlow::FlowPtr flow);
+    std::map<int, std::string> partialSeasonMsg_;
     operation();
     ~operation() {
         delete m_udp;
         delete m_db;
-        delete operation_;
     };
     std::string getSerialPort(const std::string& key);
+    void addBootPhases();
+    void connectCentralDB(const std::string& connString, const std::string& server, int attemptsLeft, std::function<void(bool)> done);
+    void initLED();
+    void initTnG();
+    void startDeviceTimers(io_context& ioContext, bool isLCDReady);
     bool copyFiles(const std::string& mountPoint, const std::string& sharedFolderPath, 
                     const std::string& username, const std::string& password, const std::string& outputFolderPath);
     void startLoopAPeriodicTimer();
     void stopLoopAPeriodicTimer();
     void handleLoopAPeriodicTimerTimeout(const boost::system::error_code &ec);
+
+    // Entry/Exit flow stages, run on the AsyncFlow strand
+    void pbsEntryFlow(AsyncFlow::FlowPtr flow, string sIU);
+    void pbsEntryLookedUp(AsyncFlow::FlowPtr flow, string sIU, int iBlackList, int iSeason);
+    void pbsEntrySeasonShown(AsyncFlow::FlowPtr flow, string sIU, int iRet);
+    void checkIUorCardStatusFlow(AsyncFlow::FlowPtr flow, string sCheckNo, DeviceType iDevicetype, string sCardNo, int sCardType, float sCardBal);
+    void pbsExitFlow(AsyncFlow::FlowPtr flow, string sIU, DeviceType iDevicetype, string sCardNo, int sCardType, float sCardBal);
+    void pbsExitLookedUp(AsyncFlow::FlowPtr flow, string sIU, int iBlackList, int iEntry, int iSeason);
+    void pbsExitEntryResolved(AsyncFlow::FlowPtr flow, string sIU, int iSeason);
+    void pbsExitSeasonShown(AsyncFlow::FlowPtr flow, string sIU, int iRet);
+    void pbsExitFeeCalculated(AsyncFlow::FlowPtr flow, int iRet);
+    void pbsExitCharge(AsyncFlow::FlowPtr flow);
+    void closeExitFlow(AsyncFlow::FlowPtr flow, TransType iStatus);
+    void matchPartialEntry(const std::vector<EntryRecord>& entryRecords, const string& sIU);
+    int  seasonMsgHoldMs(int iRet);
 };
@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <ctime>
+#include <sstream>
+#include "ini_parser.h"
+#include "log.h"
+#include "paid_exit_cache.h"
+
+std::atomic<PaidExitCache*> PaidExitCache::paidExitCache_(nullptr);
+std::mutex PaidExitCache::mutex_;
+
+PaidExitCache::PaidExitCache()
+    : logFileName_("db"),
+    stats_()
+{
+}
+
+PaidExitCache* PaidExitCache::getInstance()
+{
+    return LazyInstance::FnGet(paidExitCache_, mutex_, []() { return new PaidExitCache(); });
+}
+
+std::string PaidExitCache::formatTime(std::chrono::system_clock::time_point timePoint)
+{
+    std::time_t time = std::chrono::system_clock::to_time_t(timePoint);
+    std::tm localTime;
+    localtime_r(&time, &localTime);
+
+    char buffer[20];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &localTime);
+    return buffer;
+}
+
+void PaidExitCache::FnRecord(const std::string& key, const PaidExit& paidExit)
+{
+    if (key.empty() || (paidExit.paidAmt <= 0) || (IniParser::getInstance()->FnGetPaidExitCacheHours() <= 0))
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    std::deque<PaidExit>& exits = exits_[key];
+
+    // A central answer repeats what we may already hold
+    for (const auto& cached : exits)
+    {
+        if ((cached.exitTime == paidExit.exitTime) && (cached.paidAmt == paidExit.paidAmt))
+        {
+            return;
+        }
+    }
+
+    auto position = std::find_if(exits.begin(), exits.end(), [&paidExit](const PaidExit& cached) { return cached.exitTime < paidExit.exitTime; });
+    exits.insert(position, paidExit);
+    if (exits.size() > MAX_EXITS_PER_KEY)
+    {
+        exits.pop_back();
+    }
+
+    if (exits_.size() > MAX_KEYS)
+    {
+        prune();
+    }
+}
+
+bool PaidExitCache::FnFind(const std::string& key, const std::string& timeFrom, const std::vector<int>& transTypes, PaidExit& paidExit)
+{
+    if (IniParser::getInstance()->FnGetPaidExitCacheHours() <= 0)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    stats_.lookups++;
+
+    auto it = exits_.find(key);
+    if (it != exits_.end())
+    {
+        for (const auto& cached : it->second)
+        {
+            if (cached.exitTime <= timeFrom)
+            {
+                break;
+            }
+            if (transTypes.empty() || (std::find(transTypes.begin(), transTypes.end(), cached.transType) != transTypes.end()))
+            {
+                paidExit = cached;
+                stats_.hits++;
+                return true;
+            }
+        }
+    }
+
+    stats_.misses++;
+    return false;
+}
+
+void PaidExitCache::FnRecordMissQuery(std::chrono::steady_clock::duration elapsed)
+{
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    stats_.missQueryMs += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+}
+
+void PaidExitCache::prune()
+{
+    std::string expiry = formatTime(std::chrono::system_clock::now() - std::chrono::hours(IniParser::getInstance()->FnGetPaidExitCacheHours()));
+
+    for (auto it = exits_.begin(); it != exits_.end(); )
+    {
+        std::deque<PaidExit>& exits = it->second;
+        while (!exits.empty() && (exits.back().exitTime <= expiry))
+        {
+            exits.pop_back();
+        }
+        it = exits.empty() ? exits_.erase(it) : std::next(it);
+    }
+
+    // Still full of recent exits, the keys last seen longest ago make room
+    while (exits_.size() > MAX_KEYS)
+    {
+        auto oldest = std::min_element(exits_.begin(), exits_.end(), [](const auto& a, const auto& b)
+        {
+            return a.second.front().exitTime < b.second.front().exitTime;
+        });
+        exits_.erase(oldest);
+    }
+}
+
+PaidExitCache::Stats PaidExitCache::FnGetStats() const
+{
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    Stats stats = stats_;
+    stats.keys = exits_.size();
+    return stats;
+}
+
+void PaidExitCache::FnLogStats()
+{
+    Stats stats = FnGetStats();
+    if (stats.lookups == 0)
+    {
+        return;
+    }
+
+    uint64_t averageMissMs = (stats.misses > 0) ? (stats.missQueryMs / stats.misses) : 0;
+    std::stringstream ss;
+    ss << "Paid exit cache => lookups: " << stats.lookups;
+    ss << ", hits: " << stats.hits << " (" << (stats.hits * 100 / stats.lookups) << "%)";
+    ss << ", keys: " << stats.keys;
+    ss << ", miss query: " << averageMissMs << "ms avg";
+    ss << ", saved: ~" << (stats.hits * averageMissMs) << "ms";
+    Logger::getInstance()->FnLog(ss.str(), logFileName_, "DB");
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "lazy_instance.h"
+
+// Recent paid exits by IU, card and LPN, so a vehicle that comes back answers the paid within period check
+// from memory. It only holds what this controller saw (its own exits and the peers' "Exit OK" broadcasts),
+// so a miss is no answer and still goes to the central DB.
+class PaidExitCache
+{
+public:
+    static const std::size_t MAX_KEYS = 4096;
+    static const std::size_t MAX_EXITS_PER_KEY = 4;
+
+    struct PaidExit
+    {
+        std::string exitTime;   // yyyy-mm-dd hh:mm:ss
+        float paidAmt;
+        int transType;          // -1 when not known (peer broadcast)
+    };
+
+    struct Stats
+    {
+        uint64_t lookups;
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t missQueryMs;   // total time of the central queries on a miss
+        std::size_t keys;
+    };
+
+    static PaidExitCache* getInstance();
+
+    void FnRecord(const std::string& key, const PaidExit& paidExit);
+    // Latest paid exit of key after timeFrom, of one of transTypes (empty = any)
+    bool FnFind(const std::string& key, const std::string& timeFrom, const std::vector<int>& transTypes, PaidExit& paidExit);
+    // Time a miss spent on the central query, the saved latency is estimated from it
+    void FnRecordMissQuery(std::chrono::steady_clock::duration elapsed);
+    Stats FnGetStats() const;
+    void FnLogStats();
+
+    /**
+     * Singleton PaidExitCache should not be cloneable.
+     */
+    PaidExitCache(PaidExitCache& paidExitCache) = delete;
+
+    /**
+     * Singleton PaidExitCache should not be assignable.
+     */
+    void operator=(const PaidExitCache&) = delete;
+
+private:
+    static std::atomic<PaidExitCache*> paidExitCache_;
+    static std::mutex mutex_;
+    mutable std::mutex cacheMutex_;
+    std::string logFileName_;
+    std::unordered_map<std::string, std::deque<PaidExit>> exits_;   // newest first
+    Stats stats_;
+    PaidExitCache();
+    // Exits older than PaidExitCacheHours go, then the keys whose latest exit is the oldest
+    void prune();
+    static std::string formatTime(std::chrono::system_clock::time_point timePoint);
+};
@@ -0,0 +1,358 @@
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include "boost/algorithm/string.hpp"
+#include "param_table.h"
+
+bool FieldValue::FnParseLong(const std::string& value, long& result)
+{
+    std::string trimmed = boost::algorithm::trim_copy(value);
+    if (trimmed.empty())
+    {
+        return false;
+    }
+
+    char* end = nullptr;
+    errno = 0;
+    long parsed = std::strtol(trimmed.c_str(), &end, 10);
+    if ((errno != 0) || (*end != '\0'))
+    {
+        return false;
+    }
+
+    result = parsed;
+    return true;
+}
+
+bool FieldValue::FnParseInt(const std::string& value, int& result)
+{
+    long parsed;
+    if (!FnParseLong(value, parsed) || (parsed < INT_MIN) || (parsed > INT_MAX))
+    {
+        return false;
+    }
+
+    result = static_cast<int>(parsed);
+    return true;
+}
+
+bool FieldValue::FnParseFloat(const std::string& value, float& result)
+{
+    std::string trimmed = boost::algorithm::trim_copy(value);
+    if (trimmed.empty())
+    {
+        return false;
+    }
+
+    char* end = nullptr;
+    errno = 0;
+    float parsed = std::strtof(trimmed.c_str(), &end);
+    if ((errno != 0) || (*end != '\0'))
+    {
+        return false;
+    }
+
+    result = parsed;
+    return true;
+}
+
+bool FieldValue::FnIsLcdOverride(const std::string& value)
+{
+    return ((!value.empty()) && (boost::algorithm::to_lower_copy(value) != "null"));
+}
+
+const FieldTable<tParas_Struct>& ParamTable::FnGetParamTable()
+{
+    using Param = FieldTable<tParas_Struct>;
+    static const Param table({
+        Param::FnIntField("EPS", &tParas_Struct::giEPS),
+        Param::FnStringField("carparkcode", &tParas_Struct::gscarparkcode),
+        Param::FnStringField("CPOID", &tParas_Struct::gsCPOID),
+        Param::FnStringField("CPID", &tParas_Struct::gsCPID),
+        Param::FnIntField("CommPortLED", &tParas_Struct::giCommPortLED),
+        Param::FnIntField("HasMCycle", &tParas_Struct::giHasMCycle),
+        Param::FnIntField("TicketSiteID", &tParas_Struct::giTicketSiteID),
+        Param::FnIntField("DataKeepDays", &tParas_Struct::giDataKeepDays),
+        Param::FnIntField("BarrierPulse", &tParas_Struct::gsBarrierPulse),
+        Param::FnIntField("AntMaxRetry", &tParas_Struct::giAntMaxRetry),
+        Param::FnIntField("AntMinOKTimes", &tParas_Struct::giAntMinOKTimes),
+        Param::FnIntField("AntInqTO", &tParas_Struct::giAntInqTO),
+        Param::FnBoolField("AntiIURepetition", &tParas_Struct::gbAntiIURepetition),
+        Param::FnIntField("commportled401", &tParas_Struct::giCommportLED401),
+        Param::FnIntField("IsHDBSite", &tParas_Struct::giIsHDBSite),
+        Param::FnStringField("allowedholdertype", &tParas_Struct::gsAllowedHolderType),
+        Param::FnIntField("LEDMaxChar", &tParas_Struct::giLEDMaxChar),
+        Param::FnBoolField("AlwaysTryOnline", &tParas_Struct::gbAlwaysTryOnline),
+        Param::FnBoolField("AutoDebitNoEntry", &tParas_Struct::gbAutoDebitNoEntry),
+        Param::FnIntField("LoopAHangTime", &tParas_Struct::giLoopAHangTime),
+        Param::FnIntField("OperationTO", &tParas_Struct::giOperationTO),
+        Param::FnIntField("FullAction", &tParas_Struct::giFullAction),
+        Param::FnIntField("barrieropentoolongtime", &tParas_Struct::giBarrierOpenTooLongTime),
+        Param::FnIntField("bitbarrierarmbroken", &tParas_Struct::giBitBarrierArmBroken),
+        Param::FnIntField("mccontrolaction", &tParas_Struct::giMCControlAction),
+        Param::FnStringField("LogBackFolder", &tParas_Struct::gsLogBackFolder),
+        Param::FnIntField("LogKeepDays", &tParas_Struct::giLogKeepDays),
+        Param::FnStringField("DBBackupFolder", &tParas_Struct::gsDBBackupFolder),
+        Param::FnIntField("maxsendofflineno", &tParas_Struct::giMaxSendOfflineNo),
+        Param::FnLongField("maxlocaldbsize", &tParas_Struct::glMaxLocalDBSize),
+        Param::FnLongField("MaxTransInterval", &tParas_Struct::giMaxTransInterval),
+        Param::FnIntField("NoIURetry", &tParas_Struct::giNoIURetry),
+        Param::FnIntField("MaxDiffIU", &tParas_Struct::giMaxDiffIU),
+        Param::FnBoolField("LockBarrier", &tParas_Struct::gbLockBarrier),
+        Param::FnIntField("commportled2", &tParas_Struct::giCommPortLED2),
+        Param::FnStringField("CHUIP", &tParas_Struct::gsCHUIP),
+        Param::FnStringField("Site", &tParas_Struct::gsSite),
+        Param::FnStringField("Address", &tParas_Struct::gsAddress),
+        Param::FnIntField("TryTimes4NE", &tParas_Struct::giTryTimes4NE),
+        Param::FnIntField("processreversedcmd", &tParas_Struct::giProcessReversedCMD),
+        Param::FnIntField("hasthreewheelmc", &tParas_Struct::giHasThreeWheelMC),
+        Param::FnIntField("MaxDebitDays", &tParas_Struct::giMaxDebitDays),
+        Param::FnIntField("FirstHourMode", &tParas_Struct::giFirstHourMode),
+        Param::FnIntField("PEAllowance", &tParas_Struct::giPEAllowance),
+        Param::FnIntField("TariffFeeMode", &tParas_Struct::giTariffFeeMode),
+        Param::FnIntField("TariffGTmode", &tParas_Struct::giTariffGTMode),
+        Param::FnIntField("Hr2PEAllowance", &tParas_Struct::giHr2PEAllowance),
+        Param::FnIntField("SeasonCharge", &tParas_Struct::giSeasonCharge),
+        Param::FnIntField("ShowSeasonExpireDays", &tParas_Struct::giShowSeasonExpireDays),
+        Param::FnIntField("ShowExpiredTime", &tParas_Struct::giShowExpiredTime),
+        Param::FnIntField("MCyclePerDay", &tParas_Struct::giMCyclePerDay),
+        Param::FnIntField("V3TransType", &tParas_Struct::giV3TransType),
+        Param::FnIntField("V4TransType", &tParas_Struct::giV4TransType),
+        Param::FnIntField("V5TransType", &tParas_Struct::giV5TransType),
+        Param::FnIntField("FirstHour", &tParas_Struct::giFirstHour),
+        Param::FnIntField("HasHolidayEve", &tParas_Struct::giHasHolidayEve),
+        Param::FnBoolField("HasRedemption", &tParas_Struct::gbHasRedemption),
+        Param::FnStringField("Company", &tParas_Struct::gsCompany),
+        Param::FnStringField("GSTNo", &tParas_Struct::gsGSTNo),
+        Param::FnStringField("Tel", &tParas_Struct::gsTel),
+        Param::FnStringField("ZIP", &tParas_Struct::gsZIP),
+        Param::FnFloatField("GSTRate", &tParas_Struct::gfGSTRate),
+        Param::FnFloatField("CHUCnTO", &tParas_Struct::giCHUCnTO),
+        Param::FnStringField("HdRec", &tParas_Struct::gsHdRec),
+        Param::FnStringField("HdTk", &tParas_Struct::gsHdTk),
+        Param::FnIntField("needcard4complimentary", &tParas_Struct::giNeedCard4Complimentary),
+        Param::FnIntField("ExitTicketRedemption", &tParas_Struct::giExitTicketRedemption)
+    });
+
+    return table;
+}
+
+// message_mst holds entry and exit messages, C<name> rows are the LCD text of <name>
+const FieldTable<tMsg_Struct>& ParamTable::FnGetEntryMessageTable()
+{
+    using Msg = FieldTable<tMsg_Struct>;
+    static const Msg table({
+        Msg::FnMessageField("AltDefaultLED", &tMsg_Struct::Msg_AltDefaultLED),
+        Msg::FnMessageField("AltDefaultLED2", &tMsg_Struct::Msg_AltDefaultLED2),
+        Msg::FnMessageField("AltDefaultLED3", &tMsg_Struct::Msg_AltDefaultLED3),
+        Msg::FnMessageField("AltDefaultLED4", &tMsg_Struct::Msg_AltDefaultLED4),
+        Msg::FnMessageField("authorizedvehicle", &tMsg_Struct::Msg_authorizedvehicle),
+        Msg::FnMessageField("CardReadingError", &tMsg_Struct::Msg_CardReadingError),
+        Msg::FnLcdMessageField("CCardReadingError", &tMsg_Struct::Msg_CardReadingError),
+        Msg::FnMessageField("CardTaken", &tMsg_Struct::Msg_CardTaken),
+        Msg::FnLcdMessageField("CCardTaken", &tMsg_Struct::Msg_CardTaken),
+        Msg::FnMessageField("CarFullLED", &tMsg_Struct::Msg_CarFullLED),
+        Msg::FnMessageField("CarParkFull2LED", &tMsg_Struct::Msg_CarParkFull2LED),
+        Msg::FnMessageField("DBError", &tMsg_Struct::Msg_DBError),
+        Msg::FnMessageField("DefaultIU", &tMsg_Struct::Msg_DefaultIU),
+        Msg::FnLcdMessageField("CDefaultIU", &tMsg_Struct::Msg_DefaultIU),
+        Msg::FnMessageField("DefaultLED", &tMsg_Struct::Msg_DefaultLED),
+        Msg::FnLcdMessageField("CDefaultLED", &tMsg_Struct::Msg_DefaultLED),
+        Msg::FnMessageField("DefaultLED2", &tMsg_Struct::Msg_DefaultLED2),
+        Msg::FnLcdMessageField("CDefaultLED2", &tMsg_Struct::Msg_DefaultLED2),
+        Msg::FnMessageField("DefaultMsg2LED", &tMsg_Struct::Msg_DefaultMsg2LED),
+        Msg::FnMessageField("DefaultMsgLED", &tMsg_Struct::Msg_DefaultMsgLED),
+        Msg::FnMessageField("EenhancedMCParking", &tMsg_Struct::Msg_EenhancedMCParking),
+        Msg::FnMessageField("ESeasonWithinAllowance", &tMsg_Struct::Msg_ESeasonWithinAllowance),
+        Msg::FnLcdMessageField("CESeasonWithinAllowance", &tMsg_Struct::Msg_ESeasonWithinAllowance),
+        Msg::FnMessageField("ESPT3Parking", &tMsg_Struct::Msg_ESPT3Parking),
+        Msg::FnMessageField("EVIPHolderParking", &tMsg_Struct::Msg_EVIPHolderParking),
+        Msg::FnMessageField("ExpiringSeason", &tMsg_Struct::Msg_ExpiringSeason),
+        Msg::FnLcdMessageField("CExpiringSeason", &tMsg_Struct::Msg_ExpiringSeason),
+        Msg::FnMessageField("FullLED", &tMsg_Struct::Msg_FullLED),
+        Msg::FnLcdMessageField("CFullLED", &tMsg_Struct::Msg_FullLED),
+        Msg::FnMessageField("Idle", &tMsg_Struct::Msg_Idle),
+        Msg::FnLcdMessageField("CIdle", &tMsg_Struct::Msg_Idle),
+        Msg::FnMessageField("InsertCashcard", &tMsg_Struct::Msg_InsertCashcard),
+        Msg::FnLcdMessageField("CInsertCashcard", &tMsg_Struct::Msg_InsertCashcard),
+        Msg::FnMessageField("IUProblem", &tMsg_Struct::Msg_IUProblem),
+        Msg::FnLcdMessageField("CIUProblem", &tMsg_Struct::Msg_IUProblem),
+        Msg::FnMessageField("LockStation", &tMsg_Struct::Msg_LockStation),
+        Msg::FnLcdMessageField("CLockStation", &tMsg_Struct::Msg_LockStation),
+        Msg::FnMessageField("LoopA", &tMsg_Struct::Msg_LoopA),
+        Msg::FnLcdMessageField("CLoopA", &tMsg_Struct::Msg_LoopA),
+        Msg::FnMessageField("LoopAFull", &tMsg_Struct::Msg_LoopAFull),
+        Msg::FnLcdMessageField("CLoopAFull", &tMsg_Struct::Msg_LoopAFull),
+        Msg::FnMessageField("LorryFullLED", &tMsg_Struct::Msg_LorryFullLED),
+        Msg::FnMessageField("LotAdjustmentMsg", &tMsg_Struct::Msg_LotAdjustmentMsg),
+        Msg::FnMessageField("LowBal", &tMsg_Struct::Msg_LowBal),
+        Msg::FnLcdMessageField("CLowBal", &tMsg_Struct::Msg_LowBal),
+        Msg::FnMessageField("NoIU", &tMsg_Struct::Msg_NoIU),
+        Msg::FnLcdMessageField("CNoIU", &tMsg_Struct::Msg_NoIU),
+        Msg::FnMessageField("NoNightParking2LED", &tMsg_Struct::Msg_NoNightParking2LED),
+        Msg::FnMessageField("Offline", &tMsg_Struct::Msg_Offline),
+        Msg::FnLcdMessageField("COffline", &tMsg_Struct::Msg_Offline),
+        Msg::FnMessageField("Processing", &tMsg_Struct::Msg_Processing),
+        Msg::FnLcdMessageField("CProcessing", &tMsg_Struct::Msg_Processing),
+        Msg::FnMessageField("ReaderCommError", &tMsg_Struct::Msg_ReaderCommError),
+        Msg::FnLcdMessageField("CReaderCommError", &tMsg_Struct::Msg_ReaderCommError),
+        Msg::FnMessageField("ReaderError", &tMsg_Struct::Msg_ReaderError),
+        Msg::FnLcdMessageField("CReaderError", &tMsg_Struct::Msg_ReaderError),
+        Msg::FnMessageField("SameLastIU", &tMsg_Struct::Msg_SameLastIU),
+        Msg::FnLcdMessageField("CSameLastIU", &tMsg_Struct::Msg_SameLastIU),
+        Msg::FnMessageField("ScanEntryTicket", &tMsg_Struct::Msg_ScanEntryTicket),
+        Msg::FnLcdMessageField("CScanEntryTicket", &tMsg_Struct::Msg_ScanEntryTicket),
+        Msg::FnMessageField("ScanValTicket", &tMsg_Struct::Msg_ScanValTicket),
+        Msg::FnLcdMessageField("CScanValTicket", &tMsg_Struct::Msg_ScanValTicket),
+        Msg::FnMessageField("SeasonAsHourly", &tMsg_Struct::Msg_SeasonAsHourly),
+        Msg::FnLcdMessageField("CSeasonAsHourly", &tMsg_Struct::Msg_SeasonAsHourly),
+        Msg::FnMessageField("SeasonBlocked", &tMsg_Struct::Msg_SeasonBlocked),
+        Msg::FnLcdMessageField("CSeasonBlocked", &tMsg_Struct::Msg_SeasonBlocked),
+        Msg::FnMessageField("SeasonExpired", &tMsg_Struct::Msg_SeasonExpired),
+        Msg::FnLcdMessageField("CSeasonExpired", &tMsg_Struct::Msg_SeasonExpired),
+        Msg::FnMessageField("SeasonInvalid", &tMsg_Struct::Msg_SeasonInvalid),
+        Msg::FnLcdMessageField("CSeasonInvalid", &tMsg_Struct::Msg_SeasonInvalid),
+        Msg::FnMessageField("SeasonMultiFound", &tMsg_Struct::Msg_SeasonMultiFound),
+        Msg::FnLcdMessageField("CSeasonMultiFound", &tMsg_Struct::Msg_SeasonMultiFound),
+        Msg::FnMessageField("SeasonNotFound", &tMsg_Struct::Msg_SeasonNotFound),
+        Msg::FnLcdMessageField("CSeasonNotFound", &tMsg_Struct::Msg_SeasonNotFound),
+        Msg::FnMessageField("SeasonNotStart", &tMsg_Struct::Msg_SeasonNotStart),
+        Msg::FnLcdMessageField("CSeasonNotStart", &tMsg_Struct::Msg_SeasonNotStart),
+        Msg::FnMessageField("SeasonNotValid", &tMsg_Struct::Msg_SeasonNotValid),
+        Msg::FnLcdMessageField("CSeasonNotValid", &tMsg_Struct::Msg_SeasonNotValid),
+        Msg::FnMessageField("SeasonOnly", &tMsg_Struct::Msg_SeasonOnly),
+        Msg::FnLcdMessageField("CSeasonOnly", &tMsg_Struct::Msg_SeasonOnly),
+        Msg::FnMessageField("SeasonPassback", &tMsg_Struct::Msg_SeasonPassback),
+        Msg::FnLcdMessageField("CSeasonPassback", &tMsg_Struct::Msg_SeasonPassback),
+        Msg::FnMessageField("SeasonTerminated", &tMsg_Struct::Msg_SeasonTerminated),
+        Msg::FnLcdMessageField("CSeasonTerminated", &tMsg_Struct::Msg_SeasonTerminated),
+        Msg::FnMessageField("SystemError", &tMsg_Struct::Msg_SystemError),
+        Msg::FnLcdMessageField("CSystemError", &tMsg_Struct::Msg_SystemError),
+        Msg::FnMessageField("ValidSeason", &tMsg_Struct::Msg_ValidSeason),
+        Msg::FnLcdMessageField("CValidSeason", &tMsg_Struct::Msg_ValidSeason),
+        Msg::FnMessageField("VVIP", &tMsg_Struct::Msg_VVIP),
+        Msg::FnLcdMessageField("CVVIP", &tMsg_Struct::Msg_VVIP),
+        Msg::FnMessageField("WholeDayParking", &tMsg_Struct::Msg_WholeDayParking),
+        Msg::FnLcdMessageField("CWholeDayParking", &tMsg_Struct::Msg_WholeDayParking),
+        Msg::FnMessageField("WithIU", &tMsg_Struct::Msg_WithIU),
+        Msg::FnLcdMessageField("CWithIU", &tMsg_Struct::Msg_WithIU),
+        Msg::FnMessageField("BlackList", &tMsg_Struct::MsgBlackList),
+        Msg::FnLcdMessageField("CBlackList", &tMsg_Struct::MsgBlackList),
+        Msg::FnMessageField("E1enhancedMCParking", &tMsg_Struct::Msg_E1enhancedMCParking)
+    });
+
+    return table;
+}
+
+const FieldTable<tExitMsg_struct>& ParamTable::FnGetExitMessageTable()
+{
+    using Msg = FieldTable<tExitMsg_struct>;
+    static const Msg table({
+        Msg::FnMessageField("BlackList", &tExitMsg_struct::MsgExit_BlackList),
+        Msg::FnLcdMessageField("CBlackList", &tExitMsg_struct::MsgExit_BlackList),
+        Msg::FnMessageField("CardError", &tExitMsg_struct::MsgExit_CardError),
+        Msg::FnLcdMessageField("CCardError", &tExitMsg_struct::MsgExit_CardError),
+        Msg::FnMessageField("CardIn", &tExitMsg_struct::MsgExit_CardIn),
+        Msg::FnLcdMessageField("CCardIn", &tExitMsg_struct::MsgExit_CardIn),
+        Msg::FnMessageField("Comp2Val", &tExitMsg_struct::MsgExit_Comp2Val),
+        Msg::FnLcdMessageField("CComp2Val", &tExitMsg_struct::MsgExit_Comp2Val),
+        Msg::FnMessageField("CompExpired", &tExitMsg_struct::MsgExit_CompExpired),
+        Msg::FnLcdMessageField("CCompExpired", &tExitMsg_struct::MsgExit_CompExpired),
+        Msg::FnMessageField("Complimentary", &tExitMsg_struct::MsgExit_Complimentary),
+        Msg::FnLcdMessageField("CComplimentary", &tExitMsg_struct::MsgExit_Complimentary),
+        Msg::FnMessageField("DebitFail", &tExitMsg_struct::MsgExit_DebitFail),
+        Msg::FnLcdMessageField("CDebitFail", &tExitMsg_struct::MsgExit_DebitFail),
+        Msg::FnMessageField("DebitNak", &tExitMsg_struct::MsgExit_DebitNak),
+        Msg::FnLcdMessageField("CDebitNak", &tExitMsg_struct::MsgExit_DebitNak),
+        Msg::FnMessageField("EntryDebit", &tExitMsg_struct::MsgExit_EntryDebit),
+        Msg::FnLcdMessageField("CEntryDebit", &tExitMsg_struct::MsgExit_EntryDebit),
+        Msg::FnMessageField("ExpCard", &tExitMsg_struct::MsgExit_ExpCard),
+        Msg::FnLcdMessageField("CExpCard", &tExitMsg_struct::MsgExit_ExpCard),
+        Msg::FnMessageField("FleetCard", &tExitMsg_struct::MsgExit_FleetCard),
+        Msg::FnLcdMessageField("CFleetCard", &tExitMsg_struct::MsgExit_FleetCard),
+        Msg::FnMessageField("FreeParking", &tExitMsg_struct::MsgExit_FreeParking),
+        Msg::FnLcdMessageField("CFreeParking", &tExitMsg_struct::MsgExit_FreeParking),
+        Msg::FnMessageField("GracePeriod", &tExitMsg_struct::MsgExit_GracePeriod),
+        Msg::FnLcdMessageField("CGracePeriod", &tExitMsg_struct::MsgExit_GracePeriod),
+        Msg::FnMessageField("InvalidTicket", &tExitMsg_struct::MsgExit_InvalidTicket),
+        Msg::FnLcdMessageField("CInvalidTicket", &tExitMsg_struct::MsgExit_InvalidTicket),
+        Msg::FnMessageField("WrongTicket", &tExitMsg_struct::MsgExit_WrongTicket),
+        Msg::FnLcdMessageField("CWrongTicket", &tExitMsg_struct::MsgExit_WrongTicket),
+        Msg::FnMessageField("RedemptionExpired", &tExitMsg_struct::MsgExit_RedemptionExpired),
+        Msg::FnLcdMessageField("CRedemptionExpired", &tExitMsg_struct::MsgExit_RedemptionExpired),
+        Msg::FnMessageField("IUProblem", &tExitMsg_struct::MsgExit_IUProblem),
+        Msg::FnLcdMessageField("CIUProblem", &tExitMsg_struct::MsgExit_IUProblem),
+        Msg::FnMessageField("MasterSeason", &tExitMsg_struct::MsgExit_MasterSeason),
+        Msg::FnLcdMessageField("CMasterSeason", &tExitMsg_struct::MsgExit_MasterSeason),
+        Msg::FnMessageField("NoEntry", &tExitMsg_struct::MsgExit_NoEntry),
+        Msg::FnLcdMessageField("CNoEntry", &tExitMsg_struct::MsgExit_NoEntry),
+        Msg::FnMessageField("RedemptionTicket", &tExitMsg_struct::MsgExit_RedemptionTicket),
+        Msg::FnLcdMessageField("CRedemptionTicket", &tExitMsg_struct::MsgExit_RedemptionTicket),
+        Msg::FnMessageField("SeasonBlocked", &tExitMsg_struct::MsgExit_SeasonBlocked),
+        Msg::FnLcdMessageField("CSeasonBlocked", &tExitMsg_struct::MsgExit_SeasonBlocked),
+        Msg::FnMessageField("SeasonExpired", &tExitMsg_struct::MsgExit_SeasonExpired),
+        Msg::FnLcdMessageField("CSeasonExpired", &tExitMsg_struct::MsgExit_SeasonExpired),
+        Msg::FnMessageField("SeasonInvalid", &tExitMsg_struct::MsgExit_SeasonInvalid),
+        Msg::FnLcdMessageField("CSeasonInvalid", &tExitMsg_struct::MsgExit_SeasonInvalid),
+        Msg::FnMessageField("SeasonNotStart", &tExitMsg_struct::MsgExit_SeasonNotStart),
+        Msg::FnLcdMessageField("CSeasonNotStart", &tExitMsg_struct::MsgExit_SeasonNotStart),
+        Msg::FnMessageField("SeasonOnly", &tExitMsg_struct::MsgExit_SeasonOnly),
+        Msg::FnLcdMessageField("CSeasonOnly", &tExitMsg_struct::MsgExit_SeasonOnly),
+        Msg::FnMessageField("SeasonPassback", &tExitMsg_struct::MsgExit_SeasonPassback),
+        Msg::FnLcdMessageField("CSeasonPassback", &tExitMsg_struct::MsgExit_SeasonPassback),
+        Msg::FnMessageField("SeasonRegNoIU", &tExitMsg_struct::MsgExit_SeasonRegNoIU),
+        Msg::FnLcdMessageField("CSeasonRegNoIU", &tExitMsg_struct::MsgExit_SeasonRegNoIU),
+        Msg::FnMessageField("SeasonRegOK", &tExitMsg_struct::MsgExit_SeasonRegOK),
+        Msg::FnLcdMessageField("CSeasonRegOK", &tExitMsg_struct::MsgExit_SeasonRegOK),
+        Msg::FnMessageField("SeasonTerminated", &tExitMsg_struct::MsgExit_SeasonTerminated),
+        Msg::FnLcdMessageField("CSeasonTerminated", &tExitMsg_struct::MsgExit_SeasonTerminated),
+        Msg::FnMessageField("SystemError", &tExitMsg_struct::MsgExit_SystemError),
+        Msg::FnLcdMessageField("CSystemErrord", &tExitMsg_struct::MsgExit_SystemError),
+        Msg::FnMessageField("TakeCard", &tExitMsg_struct::MsgExit_TakeCard),
+        Msg::FnLcdMessageField("CTakeCard", &tExitMsg_struct::MsgExit_TakeCard),
+        Msg::FnMessageField("TicketExpired", &tExitMsg_struct::MsgExit_TicketExpired),
+        Msg::FnLcdMessageField("CTicketExpired", &tExitMsg_struct::MsgExit_TicketExpired),
+        Msg::FnMessageField("TicketNotFound", &tExitMsg_struct::MsgExit_TicketNotFound),
+        Msg::FnLcdMessageField("CTicketNotFound", &tExitMsg_struct::MsgExit_TicketNotFound),
+        Msg::FnMessageField("UsedTicket", &tExitMsg_struct::MsgExit_UsedTicket),
+        Msg::FnLcdMessageField("CUsedTicket", &tExitMsg_struct::MsgExit_UsedTicket),
+        Msg::FnMessageField("WrongCard", &tExitMsg_struct::MsgExit_WrongCard),
+        Msg::FnLcdMessageField("CWrongCard", &tExitMsg_struct::MsgExit_WrongCard),
+        Msg::FnMessageField("XCardAgain", &tExitMsg_struct::MsgExit_XCardAgain),
+        Msg::FnLcdMessageField("CXCardAgain", &tExitMsg_struct::MsgExit_XCardAgain),
+        Msg::FnMessageField("XCardTaken", &tExitMsg_struct::MsgExit_XCardTaken),
+        Msg::FnLcdMessageField("CXCardTaken", &tExitMsg_struct::MsgExit_XCardTaken),
+        Msg::FnMessageField("XDefaultIU", &tExitMsg_struct::MsgExit_XDefaultIU),
+        Msg::FnLcdMessageField("CXDefaultIU", &tExitMsg_struct::MsgExit_XDefaultIU),
+        Msg::FnMessageField("XDefaultLED", &tExitMsg_struct::MsgExit_XDefaultLED),
+        Msg::FnLcdMessageField("CXDefaultLED", &tExitMsg_struct::MsgExit_XDefaultLED),
+        Msg::FnMessageField("XDefaultLED2", &tExitMsg_struct::MsgExit_XDefaultLED2),
+        Msg::FnLcdMessageField("CXDefaultLED2", &tExitMsg_struct::MsgExit_XDefaultLED2),
+        Msg::FnMessageField("XExpiringSeason", &tExitMsg_struct::MsgExit_XExpiringSeason),
+        Msg::FnLcdMessageField("CXExpiringSeason", &tExitMsg_struct::MsgExit_XExpiringSeason),
+        Msg::FnMessageField("XIdle", &tExitMsg_struct::MsgExit_XIdle),
+        Msg::FnLcdMessageField("CXIdle", &tExitMsg_struct::MsgExit_XIdle),
+        Msg::FnMessageField("XLoopA", &tExitMsg_struct::MsgExit_XLoopA),
+        Msg::FnLcdMessageField("CXLoopA", &tExitMsg_struct::MsgExit_XLoopA),
+        Msg::FnMessageField("XLowBal", &tExitMsg_struct::MsgExit_XLowBal),
+        Msg::FnLcdMessageField("CXLowBal", &tExitMsg_struct::MsgExit_XLowBal),
+        Msg::FnMessageField("XNoCard", &tExitMsg_struct::MsgExit_XNoCard),
+        Msg::FnLcdMessageField("CXNoCard", &tExitMsg_struct::MsgExit_XNoCard),
+        Msg::FnMessageField("XNoCHU", &tExitMsg_struct::MsgExit_XNoCHU),
+        Msg::FnLcdMessageField("CXNoCHU", &tExitMsg_struct::MsgExit_XNoCHU),
+        Msg::FnMessageField("XNoIU", &tExitMsg_struct::MsgExit_XNoIU),
+        Msg::FnLcdMessageField("CXNoIU", &tExitMsg_struct::MsgExit_XNoIU),
+        Msg::FnMessageField("XSameLastIU", &tExitMsg_struct::MsgExit_XSameLastIU),
+        Msg::FnLcdMessageField("CXSameLastIU", &tExitMsg_struct::MsgExit_XSameLastIU),
+        Msg::FnMessageField("XSeasonWithinAllowance", &tExitMsg_struct::MsgExit_XSeasonWithinAllowance),
+        Msg::FnLcdMessageField("CXSeasonWithinAllowance", &tExitMsg_struct::MsgExit_XSeasonWithinAllowance),
+        Msg::FnMessageField("XValidSeason", &tExitMsg_struct::MsgExit_XValidSeason),
+        Msg::FnLcdMessageField("CXValidSeason", &tExitMsg_struct::MsgExit_XValidSeason),
+        Msg::FnMessageField("X1enhancedMCParking", &tExitMsg_struct::MsgExit_X1enhancedMCParking),
+        Msg::FnMessageField("XenhancedMCParking", &tExitMsg_struct::MsgExit_XenhancedMCParking),
+        Msg::FnMessageField("XSPT3Parking", &tExitMsg_struct::MsgExit_XSPT3Parking),
+        Msg::FnMessageField("XVIPHolderParking", &tExitMsg_struct::MsgExit_XVIPHolderParking)
+    });
+
+    return table;
+}
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "odbc.h"
+#include "structuredata.h"
+
+// Strict parsing of Param_mst values, the whole value (spaces aside) has to be a number
+class FieldValue
+{
+public:
+    static bool FnParseInt(const std::string& value, int& result);
+    static bool FnParseLong(const std::string& value, long& result);
+    static bool FnParseFloat(const std::string& value, float& result);
+
+    // message_mst LCD overrides (C<name>) only apply when they hold text
+    static bool FnIsLcdOverride(const std::string& value);
+};
+
+// Maps the names in a name/value table (Param_mst, message_mst) to typed setters of one struct. The table is
+// sorted once, so a row costs one binary search and one parse, and a name no field knows is reported back.
+template <typename Target>
+class FieldTable
+{
+public:
+    // Returns false when the value does not parse, the field is then left as it was
+    using Setter = std::function<bool(Target& target, const std::string& value)>;
+
+    struct Field
+    {
+        std::string name;
+        Setter setter;
+    };
+
+    struct ApplyReport
+    {
+        size_t applied;
+        std::vector<std::string> unknown;
+        std::vector<std::string> malformed;
+    };
+
+    explicit FieldTable(std::vector<Field> fields)
+        : fields_(std::move(fields))
+    {
+        std::sort(fields_.begin(), fields_.end(), [](const Field& a, const Field& b) { return a.name < b.name; });
+    }
+
+    const Field* FnFind(const std::string& name) const
+    {
+        auto it = std::lower_bound(fields_.begin(), fields_.end(), name, [](const Field& field, const std::string& key) { return field.name < key; });
+        return ((it != fields_.end()) && (it->name == name)) ? &(*it) : nullptr;
+    }
+
+    // Rows are name, value pairs, rows of another size are ignored as before
+    ApplyReport FnApply(Target& target, std::vector<ReaderItem>& rows) const
+    {
+        ApplyReport report = { 0, {}, {} };
+
+        for (auto& row : rows)
+        {
+            if (row.getDataSize() != 2)
+            {
+                continue;
+            }
+
+            std::string name = row.GetDataItem(0);
+            std::string value = row.GetDataItem(1);
+            const Field* field = FnFind(name);
+
+            if (field == nullptr)
+            {
+                report.unknown.push_back(name);
+            }
+            else if (field->setter(target, value))
+            {
+                report.applied++;
+            }
+            else
+            {
+                report.malformed.push_back(name + "='" + value + "'");
+            }
+        }
+
+        return report;
+    }
+
+    template <typename Member>
+    static Field FnIntField(const char* name, Member Target::*member)
+    {
+        return { name, [member](Target& target, const std::string& value)
+        {
+            int result;
+            if (!FieldValue::FnParseInt(value, result))
+            {
+                return false;
+            }
+            target.*member = static_cast<Member>(result);
+            return true;
+        } };
+    }
+
+    template <typename Member>
+    static Field FnLongField(const char* name, Member Target::*member)
+    {
+        return { name, [member](Target& target, const std::string& value)
+        {
+            long result;
+            if (!FieldValue::FnParseLong(value, result))
+            {
+                return false;
+            }
+            target.*member = static_cast<Member>(result);
+            return true;
+        } };
+    }
+
+    template <typename Member>
+    static Field FnFloatField(const char* name, Member Target::*member)
+    {
+        return { name, [member](Target& target, const std::string& value)
+        {
+            float result;
+            if (!FieldValue::FnParseFloat(value, result))
+            {
+                return false;
+            }
+            target.*member = static_cast<Member>(result);
+            return true;
+        } };
+    }
+
+    // 1 is true, any other number is false
+    static Field FnBoolField(const char* name, bool Target::*member)
+    {
+        return { name, [member](Target& target, const std::string& value)
+        {
+            int result;
+            if (!FieldValue::FnParseInt(value, result))
+            {
+                return false;
+            }
+            target.*member = (result == 1);
+            return true;
+        } };
+    }
+
+    static Field FnStringField(const char* name, std::string Target::*member)
+    {
+        return { name, [member](Target& target, const std::string& value)
+        {
+            target.*member = value;
+            return true;
+        } };
+    }
+
+    // Sets both the LED (index 0) and LCD (index 1) text
+    static Field FnMessageField(const char* name, std::string (Target::*member)[2])
+    {
+        return { name, [member](Target& target, const std::string& value)
+        {
+            (target.*member)[0] = value;
+            (target.*member)[1] = value;
+            return true;
+        } };
+    }
+
+    // Replaces the LCD text only, blank and "null" keep the LED text
+    static Field FnLcdMessageField(const char* name, std::string (Target::*member)[2])
+    {
+        return { name, [member](Target& target, const std::string& value)
+        {
+            if (FieldValue::FnIsLcdOverride(value))
+            {
+                (target.*member)[1] = value;
+            }
+            return true;
+        } };
+    }
+
+private:
+    std::vector<Field> fields_;
+};
+
+// The tables db loads Param_mst and message_mst through, built on first use
+class ParamTable
+{
+public:
+    static const FieldTable<tParas_Struct>& FnGetParamTable();
+    static const FieldTable<tMsg_Struct>& FnGetEntryMessageTable();
+    static const FieldTable<tExitMsg_struct>& FnGetExitMessageTable();
+};
@@ -3,7 +3,7 @@
 #include "lcd.h"
 #include "log.h"
 
-ShutdownManager* ShutdownManager::shutdownManager_ = nullptr;
+std::atomic<ShutdownManager*> ShutdownManager::shutdownManager_(nullptr);
 std::mutex ShutdownManager::mutex_;
 
 ShutdownManager::ShutdownManager()
@@ -13,12 +13,7 @@ ShutdownManager::ShutdownManager()
 
 ShutdownManager* ShutdownManager::getInstance()
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (shutdownManager_ == nullptr)
-    {
-        shutdownManager_ = new ShutdownManager();
-    }
-    return shutdownManager_;
+    return LazyInstance::FnGet(shutdownManager_, mutex_, []() { return new ShutdownManager(); });
 }
 
 void ShutdownManager::set(boost::asio::io_context* io, boost::asio::executor_work_guard<boost::asio::io_context::executor_type>* guard)
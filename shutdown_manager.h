@@ -3,6 +3,7 @@
 #include <iostream>
 #include <mutex>
 #include "boost/asio.hpp"
+#include "lazy_instance.h"
 
 class ShutdownManager
 {
@@ -29,7 +30,7 @@ public:
     void operator=(const ShutdownManager&) = delete;
 
 private:
-    static ShutdownManager* shutdownManager_;
+    static std::atomic<ShutdownManager*> shutdownManager_;
     static std::mutex mutex_;
     boost::asio::io_context* ioContext_ = nullptr;
     boost::asio::executor_work_guard<boost::asio::io_context::executor_type>* workGuard_ = nullptr;
@@ -0,0 +1,98 @@
+#include <ctime>
+#include <iostream>
+#include <string>
+#include "config_snapshot_file.h"
+
+// Offline inspection of config snapshots:
+//   pbs_snapshot_tool dump <file>
+//   pbs_snapshot_tool diff <old file> <new file>
+
+namespace
+{
+    bool readSnapshot(const std::string& path, ConfigSnapshotFile& file)
+    {
+        std::string error;
+        if (!file.FnRead(path, error))
+        {
+            std::cerr << path << " : " << error << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    int dump(const std::string& path)
+    {
+        ConfigSnapshotFile file;
+        if (!readSnapshot(path, file))
+        {
+            return 1;
+        }
+
+        std::time_t createdTime = static_cast<std::time_t>(file.FnGetCreatedTime());
+        char createdText[32] = "";
+        std::strftime(createdText, sizeof(createdText), "%Y-%m-%d %H:%M:%S", std::localtime(&createdTime));
+
+        std::cout << "format version : " << ConfigSnapshotFile::FORMAT_VERSION << std::endl;
+        std::cout << "station id     : " << file.FnGetStationId() << std::endl;
+        std::cout << "created        : " << createdText << std::endl;
+        std::cout << "queries        : " << file.FnGetEntries().size() << std::endl;
+
+        for (const auto& entry : file.FnGetEntries())
+        {
+            std::cout << std::endl << entry.first << " (" << entry.second.size() << " rows)" << std::endl;
+            for (const auto& row : entry.second)
+            {
+                std::cout << " ";
+                for (const auto& cell : row)
+                {
+                    std::cout << " | " << cell;
+                }
+                std::cout << std::endl;
+            }
+        }
+
+        return 0;
+    }
+
+    int diff(const std::string& olderPath, const std::string& newerPath)
+    {
+        ConfigSnapshotFile older;
+        ConfigSnapshotFile newer;
+        if (!readSnapshot(olderPath, older) || !readSnapshot(newerPath, newer))
+        {
+            return 1;
+        }
+
+        if (older.FnGetStationId() != newer.FnGetStationId())
+        {
+            std::cout << "station id : " << older.FnGetStationId() << " -> " << newer.FnGetStationId() << std::endl;
+        }
+
+        auto differences = ConfigSnapshotFile::FnDiff(older, newer);
+        for (const auto& line : differences)
+        {
+            std::cout << line << std::endl;
+        }
+
+        // diff(1) convention, 1 when the snapshots differ
+        return differences.empty() ? 0 : 1;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::string command = (argc > 1) ? argv[1] : "";
+
+    if ((command == "dump") && (argc == 3))
+    {
+        return dump(argv[2]);
+    }
+    else if ((command == "diff") && (argc == 4))
+    {
+        return diff(argv[2], argv[3]);
+    }
+
+    std::cerr << "usage: " << argv[0] << " dump <file>" << std::endl;
+    std::cerr << "       " << argv[0] << " diff <old file> <new file>" << std::endl;
+    return 2;
+}
@@ -0,0 +1,220 @@
+#include <sstream>
+#include "ini_parser.h"
+#include "log.h"
+#include "station_status.h"
+
+std::array<std::atomic<StationStatus*>, LaneContext::MAX_LANES> StationStatus::stationStatuses_ = {};
+std::mutex StationStatus::mutex_;
+
+StationStatus::StationStatus()
+    : logFileName_("status"),
+    laneId_(LaneContext::FnGetCurrentLane()),
+    isStarted_(false),
+    isKeyframeRequested_(true),
+    version_(0)
+{
+    model_.laneId = laneId_;
+}
+
+StationStatus* StationStatus::getInstance()
+{
+    return LazyInstance::FnGet(stationStatuses_[LaneContext::FnGetCurrentLane()], mutex_, []() { return new StationStatus(); });
+}
+
+void StationStatus::FnStart(boost::asio::io_context& ioContext, Sampler sampler, Sender sender)
+{
+    if (isStarted_.load())
+    {
+        return;
+    }
+
+    sampler_ = std::move(sampler);
+    sender_ = std::move(sender);
+    strand_ = std::make_unique<boost::asio::strand<boost::asio::io_context::executor_type>>(boost::asio::make_strand(ioContext));
+    timer_ = std::make_unique<boost::asio::steady_timer>(*strand_);
+    lastKeyframeTime_ = std::chrono::steady_clock::now();
+    isStarted_.store(true);
+
+    Logger::getInstance()->FnLog("Lane " + std::to_string(laneId_) + " station status publisher started", logFileName_, "STAT");
+    scheduleTick();
+}
+
+bool StationStatus::FnIsStarted() const
+{
+    return isStarted_.load();
+}
+
+void StationStatus::FnUpdate(const std::function<void(StationStatusModel& model)>& update)
+{
+    std::lock_guard<std::mutex> lock(statusMutex_);
+    update(model_);
+}
+
+void StationStatus::FnRequestKeyframe()
+{
+    std::lock_guard<std::mutex> lock(statusMutex_);
+    isKeyframeRequested_ = true;
+}
+
+void StationStatus::FnRequestKeyframeAllLanes()
+{
+    for (auto& stationStatus : stationStatuses_)
+    {
+        StationStatus* instance = stationStatus.load();
+        if (instance != nullptr)
+        {
+            instance->FnRequestKeyframe();
+        }
+    }
+}
+
+void StationStatus::scheduleTick()
+{
+    // Read on every tick, a reload of the ini changes the rate without a restart
+    int intervalMs = IniParser::getInstance()->FnGetMonitorStatusIntervalMs();
+
+    timer_->expires_after(std::chrono::milliseconds(intervalMs));
+    timer_->async_wait(boost::asio::bind_executor(*strand_, LaneContext::FnBind(laneId_, [this](const boost::system::error_code& ec)
+    {
+        if (ec)
+        {
+            return;
+        }
+
+        try
+        {
+            tick();
+        }
+        catch (const std::exception& e)
+        {
+            std::stringstream ss;
+            ss << __func__ << ", Exception: " << e.what();
+            Logger::getInstance()->FnLogExceptionError(ss.str());
+        }
+        catch (...)
+        {
+            std::stringstream ss;
+            ss << __func__ << ", Exception: Unknown Exception";
+            Logger::getInstance()->FnLogExceptionError(ss.str());
+        }
+
+        scheduleTick();
+    })));
+}
+
+void StationStatus::tick()
+{
+    StationStatusModel model;
+    bool isKeyframe;
+    {
+        std::lock_guard<std::mutex> lock(statusMutex_);
+        model = model_;
+        isKeyframe = isKeyframeRequested_;
+    }
+
+    if (sampler_)
+    {
+        sampler_(model);
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    int keyframeSec = IniParser::getInstance()->FnGetMonitorKeyframeSec();
+    if ((keyframeSec > 0) && (now - lastKeyframeTime_ >= std::chrono::seconds(keyframeSec)))
+    {
+        isKeyframe = true;
+    }
+
+    std::vector<std::pair<std::string, std::string>> changed;
+    std::vector<std::pair<std::string, std::string>> fields = toFields(model);
+    for (const auto& field : fields)
+    {
+        auto it = published_.find(field.first);
+        if ((it == published_.end()) || (it->second != field.second))
+        {
+            changed.push_back(field);
+        }
+    }
+
+    if (!isKeyframe && changed.empty())
+    {
+        return;
+    }
+
+    uint64_t version = changed.empty() ? version_ : version_ + 1;
+    std::stringstream ss;
+    ss << version << ";" << (isKeyframe ? "K" : "D");
+    for (const auto& field : (isKeyframe ? fields : changed))
+    {
+        ss << ";" << field.first << "=" << escape(field.second);
+    }
+
+    if (!sender_(ss.str()))
+    {
+        // Nobody received it, the monitor gets everything once it is back
+        std::lock_guard<std::mutex> lock(statusMutex_);
+        isKeyframeRequested_ = true;
+        return;
+    }
+
+    version_ = version;
+    for (const auto& field : changed)
+    {
+        published_[field.first] = field.second;
+    }
+
+    if (isKeyframe)
+    {
+        lastKeyframeTime_ = now;
+        std::lock_guard<std::mutex> lock(statusMutex_);
+        isKeyframeRequested_ = false;
+    }
+}
+
+std::vector<std::pair<std::string, std::string>> StationStatus::toFields(const StationStatusModel& model)
+{
+    std::vector<std::pair<std::string, std::string>> fields;
+
+    fields.emplace_back("lane", std::to_string(model.laneId));
+    for (int i = 0; i < StationStatusModel::MAX_ERRORS; i++)
+    {
+        fields.emplace_back("err" + std::to_string(i), std::to_string(model.errors[i]));
+    }
+    for (const auto& input : model.dioInputs)
+    {
+        fields.emplace_back("di" + std::to_string(input.first), std::to_string(input.second));
+    }
+    fields.emplace_back("led1", model.ledLine1);
+    fields.emplace_back("led2", model.ledLine2);
+    fields.emplace_back("time", model.dateTime);
+    fields.emplace_back("online", std::to_string(model.systemOnline));
+    fields.emplace_back("dberr", std::to_string(model.databaseError));
+    fields.emplace_back("full", model.carparkFull ? "1" : "0");
+    fields.emplace_back("offline", std::to_string(model.offlineTransactions));
+    fields.emplace_back("flows", std::to_string(model.flows));
+
+    return fields;
+}
+
+// The frame separators and '%' itself go as %XX, LED text can hold any of them
+std::string StationStatus::escape(const std::string& value)
+{
+    static const char HEX_DIGITS[] = "0123456789ABCDEF";
+    std::string escaped;
+    escaped.reserve(value.size());
+
+    for (char c : value)
+    {
+        if ((c == '%') || (c == ';') || (c == '=') || (c == '|') || (c == '[') || (c == ']'))
+        {
+            escaped += '%';
+            escaped += HEX_DIGITS[(static_cast<unsigned char>(c) >> 4) & 0x0F];
+            escaped += HEX_DIGITS[static_cast<unsigned char>(c) & 0x0F];
+        }
+        else
+        {
+            escaped += c;
+        }
+    }
+
+    return escaped;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "boost/asio.hpp"
+#include "lane_context.h"
+#include "lazy_instance.h"
+
+// Everything the monitor shows about a lane
+struct StationStatusModel
+{
+    static const int MAX_ERRORS = 17;           // operation::Errsize
+
+    int laneId = 0;
+    std::array<int, MAX_ERRORS> errors{};      // tPBSError ErrNo by EPS error index
+    std::map<int, int> dioInputs;               // pin, value
+    std::string ledLine1;
+    std::string ledLine2;
+    std::string dateTime;                       // yyyymmddhhmm
+    int systemOnline = 0;
+    int databaseError = 0;
+    bool carparkFull = false;
+    long offlineTransactions = 0;
+    uint64_t flows = 0;
+};
+
+// Publishes a lane's StationStatusModel to the monitor as "318" frames, "version;K|D;name=value;..."
+// A delta (D) only carries the fields that changed and bumps the version by one, so a monitor that sees
+// a gap asks for a resync; a keyframe (K) carries every field and goes out periodically, on request
+// and when the monitor connects. At most one frame per MonitorStatusIntervalMs, nothing when idle.
+class StationStatus
+{
+public:
+    using Sampler = std::function<void(StationStatusModel& model)>;
+    // Returns false when the frame could not go out (monitor not connected), a keyframe follows then
+    using Sender = std::function<bool(const std::string& data)>;
+
+    static StationStatus* getInstance();
+
+    // sampler fills the fields read from the lane's state on every tick
+    void FnStart(boost::asio::io_context& ioContext, Sampler sampler, Sender sender);
+    bool FnIsStarted() const;
+
+    // For the fields that are only known when they change (DIO inputs, LED text). Safe from any thread.
+    void FnUpdate(const std::function<void(StationStatusModel& model)>& update);
+    void FnRequestKeyframe();
+    // The monitor socket is shared by the lanes, a resync from it concerns all of them
+    static void FnRequestKeyframeAllLanes();
+
+    /**
+     * Singleton StationStatus should not be cloneable.
+     */
+    StationStatus(StationStatus& stationStatus) = delete;
+
+    /**
+     * Singleton StationStatus should not be assignable.
+     */
+    void operator=(const StationStatus&) = delete;
+
+private:
+    static std::array<std::atomic<StationStatus*>, LaneContext::MAX_LANES> stationStatuses_;
+    static std::mutex mutex_;
+    mutable std::mutex statusMutex_;
+    std::string logFileName_;
+    int laneId_;
+    std::atomic<bool> isStarted_;
+    StationStatusModel model_;
+    Sampler sampler_;
+    Sender sender_;
+    std::unique_ptr<boost::asio::strand<boost::asio::io_context::executor_type>> strand_;
+    std::unique_ptr<boost::asio::steady_timer> timer_;
+    bool isKeyframeRequested_;
+    // Only used on the strand
+    std::map<std::string, std::string> published_;
+    uint64_t version_;
+    std::chrono::steady_clock::time_point lastKeyframeTime_;
+    StationStatus();
+    void scheduleTick();
+    void tick();
+    static std::vector<std::pair<std::string, std::string>> toFields(const StationStatusModel& model);
+    static std::string escape(const std::string& value);
+};
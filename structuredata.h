@@ -2,6 +2,7 @@
 
 #include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <mutex>
 #include "ce_time.h"
 
@@ -305,6 +306,15 @@ struct  tEntryTrans_Struct
 	string sCHUDebitCode;
 };
 
+// std::atomic<bool> that can be copied, so a transaction can be snapshotted for a DB save
+struct tCopyableFlag : public std::atomic<bool>
+{
+	tCopyableFlag(bool value = false) : std::atomic<bool>(value) {}
+	tCopyableFlag(const tCopyableFlag& other) : std::atomic<bool>(other.load()) {}
+	tCopyableFlag& operator=(const tCopyableFlag& other) { store(other.load()); return *this; }
+	tCopyableFlag& operator=(bool value) { store(value); return *this; }
+};
+
 struct  tExitTrans_Struct
 {
 	string xsid;
@@ -339,6 +349,7 @@ struct  tExitTrans_Struct
 	float sRebateAmt;
 	float sRebateBalance;
 	string sRebateDate;
+	uint64_t iTariffVersion = 0;	// tariff version the fee was calculated with
 	//------
 	string sCHUDebitCode;
 	float sTopupAmt;
@@ -364,8 +375,8 @@ struct  tExitTrans_Struct
 	string sRPLPN;
 	//-----
 	eProcessStatus giDeductionStatus;        // 0: init    1: waiting card   2: doing deduction  3: deduction succeed 4: deduction failed
-	std::atomic<bool> gbPaid;
-	std::atomic<bool> bPayByEZPay;
+	tCopyableFlag gbPaid;
+	tCopyableFlag bPayByEZPay;
 	string sTag;
 };
 
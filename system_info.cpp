@@ -6,7 +6,7 @@
 
 #include <sys/sysinfo.h>
 
-SystemInfo* SystemInfo::systeminfo_;
+std::atomic<SystemInfo*> SystemInfo::systeminfo_(nullptr);
 std::mutex SystemInfo::mutex_;
 
 SystemInfo::SystemInfo()
@@ -16,12 +16,7 @@ SystemInfo::SystemInfo()
 
 SystemInfo* SystemInfo::getInstance()
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (systeminfo_ == nullptr)
-    {
-        systeminfo_ = new SystemInfo();
-    }
-    return systeminfo_;
+    return LazyInstance::FnGet(systeminfo_, mutex_, []() { return new SystemInfo(); });
 }
 
 void SystemInfo::FnLogSysInfo()
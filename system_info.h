@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <mutex>
+#include "lazy_instance.h"
 
 class SystemInfo
 {
@@ -21,7 +22,7 @@ public:
     void operator=(const SystemInfo &) = delete;
 
 private:
-    static SystemInfo* systeminfo_;
+    static std::atomic<SystemInfo*> systeminfo_;
     static std::mutex mutex_;
     SystemInfo();
 };
\ No newline at end of file
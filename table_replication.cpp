@@ -0,0 +1,578 @@
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include "boost/crc.hpp"
+#include "log.h"
+#include "odbc.h"
+#include "table_replication.h"
+
+TableReplicator::TableReplicator()
+{
+}
+
+TableReplicator::Result TableReplicator::FnSync(const Spec& spec, odbc* central, odbc* local)
+{
+    Result result{};
+    result.isVerified = true;
+    uint32_t checksum = 0;
+    auto startTime = std::chrono::steady_clock::now();
+
+    bool isOk = spec.fetchedFlag.empty() ? syncCompared(spec, central, local, result, checksum) : syncFlagged(spec, central, local, result, checksum);
+
+    int64_t elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+    {
+        std::lock_guard<std::mutex> lock(statsMutex_);
+        Stats& stats = stats_[spec.name];
+        stats.syncs++;
+        stats.fetched += result.fetched;
+        stats.applied += result.applied;
+        stats.unchanged += result.unchanged;
+        stats.deleted += result.deleted;
+        stats.failures += isOk ? 0 : 1;
+        stats.verifyMismatches += result.isVerified ? 0 : 1;
+        stats.lastMs = elapsedMs;
+        stats.lastChecksum = checksum;
+    }
+
+    std::stringstream ss;
+    ss << "Sync " << spec.name << ": fetched " << result.fetched << ", applied " << result.applied;
+    ss << ", unchanged " << result.unchanged << ", deleted " << result.deleted;
+    ss << ", checksum " << std::hex << std::setw(8) << std::setfill('0') << checksum << std::dec;
+    ss << (result.isVerified ? "" : " MISMATCH") << ", " << elapsedMs << " ms";
+    if (!isOk)
+    {
+        ss << ", failed on the " << (result.isCentralError ? "central" : "local") << " DB";
+    }
+    Logger::getInstance()->FnLog(ss.str(), "", "DB");
+
+    return result;
+}
+
+bool TableReplicator::syncFlagged(const Spec& spec, odbc* central, odbc* local, Result& result, uint32_t& checksum)
+{
+    std::string statement = "SELECT ";
+    if (spec.batchRows > 0)
+    {
+        statement += "TOP " + std::to_string(spec.batchRows) + " ";
+    }
+    statement += spec.centralSelect + " FROM " + spec.centralTable + " WHERE " + spec.fetchedFlag + " = 0";
+    if (!spec.centralFilter.empty())
+    {
+        statement += " AND " + spec.centralFilter;
+    }
+
+    for (int batch = 0; batch < MAX_BATCHES; batch++)
+    {
+        std::vector<Row> rows;
+        if (!readCentral(spec, central, statement, rows))
+        {
+            result.isCentralError = true;
+            return false;
+        }
+        if (rows.empty())
+        {
+            return true;
+        }
+        result.fetched += static_cast<int>(rows.size());
+
+        bool isMatched = true;
+        if (!writeRows(spec, local, rows) || !verify(spec, local, rows, isMatched, checksum))
+        {
+            result.isLocalError = true;
+            return false;
+        }
+        result.isVerified = result.isVerified && isMatched;
+
+        // Not marked, the rows come again next time and are written over
+        if (!markFetched(spec, central, rows))
+        {
+            result.isCentralError = true;
+            return false;
+        }
+        result.applied += static_cast<int>(rows.size());
+
+        if ((spec.batchRows <= 0) || (rows.size() < static_cast<std::size_t>(spec.batchRows)))
+        {
+            return true;
+        }
+    }
+
+    return true;
+}
+
+bool TableReplicator::syncCompared(const Spec& spec, odbc* central, odbc* local, Result& result, uint32_t& checksum)
+{
+    std::string statement = "SELECT " + spec.centralSelect + " FROM " + spec.centralTable;
+    if (!spec.centralFilter.empty())
+    {
+        statement += " WHERE " + spec.centralFilter;
+    }
+
+    std::vector<Row> rows;
+    if (!readCentral(spec, central, statement, rows))
+    {
+        result.isCentralError = true;
+        return false;
+    }
+    result.fetched = static_cast<int>(rows.size());
+
+    std::map<std::string, Row> localRows;
+    if (!readLocal(spec, local, nullptr, localRows))
+    {
+        result.isLocalError = true;
+        return false;
+    }
+
+    std::vector<Row> changed;
+    std::set<std::string> keys;
+    for (const auto& row : rows)
+    {
+        std::string key = keyOf(spec, row);
+        keys.insert(key);
+        auto it = localRows.find(key);
+        if ((it == localRows.end()) || !isSame(it->second, row))
+        {
+            changed.push_back(row);
+        }
+    }
+
+    // An empty answer is more likely a fault than an empty table, it deletes nothing
+    std::vector<Row> missing;
+    if (spec.isDeletingMissing && !rows.empty())
+    {
+        for (const auto& localRow : localRows)
+        {
+            if (keys.find(localRow.first) == keys.end())
+            {
+                missing.push_back(localRow.second);
+            }
+        }
+    }
+
+    // Missing rows go first, a local key printed differently from the central one must not take a new row along
+    if ((!missing.empty() && !deleteRows(spec, local, missing)) || (!changed.empty() && !writeRows(spec, local, changed)))
+    {
+        result.isLocalError = true;
+        return false;
+    }
+    result.applied = static_cast<int>(changed.size());
+    result.unchanged = result.fetched - result.applied;
+    result.deleted = static_cast<int>(missing.size());
+
+    // Nothing written, the local rows already read are what the DB holds
+    bool isMatched = true;
+    if (changed.empty() && missing.empty())
+    {
+        checksum = checksumOf(spec, rows);
+        return true;
+    }
+
+    if (!verify(spec, local, rows, isMatched, checksum))
+    {
+        result.isLocalError = true;
+        return false;
+    }
+    result.isVerified = isMatched;
+    return true;
+}
+
+bool TableReplicator::readCentral(const Spec& spec, odbc* central, const std::string& statement, std::vector<Row>& rows)
+{
+    std::vector<ReaderItem> selResult;
+    if (central->SQLSelect(statement, &selResult, true) != 0)
+    {
+        return false;
+    }
+
+    for (auto& item : selResult)
+    {
+        Row row;
+        for (const auto& column : spec.columns)
+        {
+            if (static_cast<unsigned long>(column.centralIndex) >= item.getDataSize())
+            {
+                Logger::getInstance()->FnLog("Sync " + spec.name + ": central column " + std::to_string(column.centralIndex) + " not found", "", "DB");
+                return false;
+            }
+            row.push_back(item.GetDataItem(column.centralIndex));
+        }
+        rows.push_back(std::move(row));
+    }
+    return true;
+}
+
+bool TableReplicator::readLocal(const Spec& spec, odbc* local, const std::vector<Row>* keyRows, std::map<std::string, Row>& rows)
+{
+    std::vector<std::string> keyNames;
+    std::string statement = "SELECT ";
+    for (std::size_t i = 0; i < spec.columns.size(); i++)
+    {
+        statement += ((i > 0) ? "," : "") + spec.columns[i].localName;
+        if (spec.columns[i].isKey)
+        {
+            keyNames.push_back(spec.columns[i].localName);
+        }
+    }
+    statement += " FROM " + spec.localTable;
+
+    std::size_t count = (keyRows != nullptr) ? keyRows->size() : 1;
+    for (std::size_t begin = 0; begin < count; begin += ROWS_PER_STATEMENT)
+    {
+        std::string chunkStatement = statement;
+        if (keyRows != nullptr)
+        {
+            chunkStatement += " WHERE " + keyCondition(keyNames, spec, *keyRows, begin, std::min(count, begin + ROWS_PER_STATEMENT), true);
+        }
+
+        std::vector<ReaderItem> selResult;
+        if (local->SQLSelect(chunkStatement, &selResult, true) != 0)
+        {
+            return false;
+        }
+
+        for (auto& item : selResult)
+        {
+            Row row;
+            for (unsigned long i = 0; (i < item.getDataSize()) && (i < spec.columns.size()); i++)
+            {
+                row.push_back(item.GetDataItem(i));
+            }
+            rows[keyOf(spec, row)] = std::move(row);
+        }
+    }
+    return true;
+}
+
+bool TableReplicator::writeRows(const Spec& spec, odbc* local, const std::vector<Row>& rows)
+{
+    bool isUpsert = hasUniqueKey(spec, local);
+    bool isAllWritten = true;
+
+    for (std::size_t begin = 0; begin < rows.size(); begin += ROWS_PER_STATEMENT)
+    {
+        std::size_t end = std::min(rows.size(), begin + ROWS_PER_STATEMENT);
+        if (!isUpsert)
+        {
+            std::vector<Row> chunk(rows.begin() + begin, rows.begin() + end);
+            if (!deleteRows(spec, local, chunk))
+            {
+                return false;
+            }
+        }
+
+        if (local->SQLExecutNoneQuery(insertStatement(spec, rows, begin, end, isUpsert)) == 0)
+        {
+            continue;
+        }
+
+        // Without a unique key the chunk's keys are already deleted, so every row that can be written is
+        Logger::getInstance()->FnLog("Sync " + spec.name + ": bulk insert failed, retrying " + std::to_string(end - begin) + " rows one by one", "", "DB");
+        for (std::size_t i = begin; i < end; i++)
+        {
+            if (local->SQLExecutNoneQuery(insertStatement(spec, rows, i, i + 1, isUpsert)) != 0)
+            {
+                Logger::getInstance()->FnLog("Sync " + spec.name + ": insert failed for key " + keyOf(spec, rows[i]), "", "DB");
+                isAllWritten = false;
+            }
+        }
+    }
+    return isAllWritten;
+}
+
+std::string TableReplicator::insertStatement(const Spec& spec, const std::vector<Row>& rows, std::size_t begin, std::size_t end, bool isUpsert)
+{
+    std::string statement = "INSERT INTO " + spec.localTable + " (";
+    for (std::size_t i = 0; i < spec.columns.size(); i++)
+    {
+        statement += ((i > 0) ? "," : "") + spec.columns[i].localName;
+    }
+    statement += ") VALUES ";
+
+    for (std::size_t i = begin; i < end; i++)
+    {
+        statement += (i > begin) ? ",(" : "(";
+        for (std::size_t j = 0; j < rows[i].size(); j++)
+        {
+            statement += ((j > 0) ? "," : "") + quote(rows[i][j], true);
+        }
+        statement += ")";
+    }
+
+    if (isUpsert)
+    {
+        statement += " ON DUPLICATE KEY UPDATE ";
+        for (std::size_t i = 0; i < spec.columns.size(); i++)
+        {
+            statement += ((i > 0) ? "," : "") + spec.columns[i].localName + "=VALUES(" + spec.columns[i].localName + ")";
+        }
+    }
+    return statement;
+}
+
+bool TableReplicator::hasUniqueKey(const Spec& spec, odbc* local)
+{
+    // Column names are not case sensitive
+    auto lower = [](std::string name)
+    {
+        std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return name;
+    };
+
+    std::set<std::string> keyNames;
+    for (const auto& column : spec.columns)
+    {
+        if (column.isKey)
+        {
+            keyNames.insert(lower(column.localName));
+        }
+    }
+
+    // Key_name and Column_name of every column of every unique index
+    std::vector<ReaderItem> selResult;
+    if (keyNames.empty() || (local->SQLSelect("SHOW INDEX FROM " + spec.localTable + " WHERE Non_unique = 0", &selResult, true) != 0))
+    {
+        return false;
+    }
+
+    std::map<std::string, std::set<std::string>> indexes;
+    for (auto& item : selResult)
+    {
+        if (item.getDataSize() > 4)
+        {
+            indexes[item.GetDataItem(2)].insert(lower(item.GetDataItem(4)));
+        }
+    }
+
+    for (const auto& index : indexes)
+    {
+        if (index.second == keyNames)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TableReplicator::deleteRows(const Spec& spec, odbc* local, const std::vector<Row>& rows)
+{
+    std::vector<std::string> keyNames;
+    for (const auto& column : spec.columns)
+    {
+        if (column.isKey)
+        {
+            keyNames.push_back(column.localName);
+        }
+    }
+
+    for (std::size_t begin = 0; begin < rows.size(); begin += ROWS_PER_STATEMENT)
+    {
+        std::size_t end = std::min(rows.size(), begin + ROWS_PER_STATEMENT);
+        if (local->SQLExecutNoneQuery("DELETE FROM " + spec.localTable + " WHERE " + keyCondition(keyNames, spec, rows, begin, end, true)) != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TableReplicator::markFetched(const Spec& spec, odbc* central, const std::vector<Row>& rows)
+{
+    for (std::size_t begin = 0; begin < rows.size(); begin += ROWS_PER_STATEMENT)
+    {
+        std::size_t end = std::min(rows.size(), begin + ROWS_PER_STATEMENT);
+        std::string statement = "UPDATE " + spec.centralTable + " SET " + spec.fetchedFlag + " = '1' WHERE ";
+        statement += keyCondition(spec.centralKeys, spec, rows, begin, end, false);
+        if (central->SQLExecutNoneQuery(statement) != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TableReplicator::verify(const Spec& spec, odbc* local, const std::vector<Row>& rows, bool& isMatched, uint32_t& checksum)
+{
+    std::map<std::string, Row> localRows;
+    if (!readLocal(spec, local, &rows, localRows))
+    {
+        return false;
+    }
+
+    std::vector<Row> readBack;
+    for (const auto& row : rows)
+    {
+        auto it = localRows.find(keyOf(spec, row));
+        if (it != localRows.end())
+        {
+            readBack.push_back(it->second);
+        }
+    }
+
+    checksum = checksumOf(spec, readBack);
+    isMatched = (readBack.size() == rows.size()) && (checksum == checksumOf(spec, rows));
+    return true;
+}
+
+std::string TableReplicator::keyOf(const Spec& spec, const Row& row)
+{
+    std::string key;
+    for (std::size_t i = 0; (i < spec.columns.size()) && (i < row.size()); i++)
+    {
+        if (spec.columns[i].isKey)
+        {
+            key += normalize(row[i]) + '\x1f';
+        }
+    }
+    return key;
+}
+
+std::string TableReplicator::keyCondition(const std::vector<std::string>& keyNames, const Spec& spec, const std::vector<Row>& rows, std::size_t begin, std::size_t end, bool isLocal)
+{
+    std::vector<std::size_t> keyIndexes;
+    for (std::size_t i = 0; i < spec.columns.size(); i++)
+    {
+        if (spec.columns[i].isKey)
+        {
+            keyIndexes.push_back(i);
+        }
+    }
+
+    std::string condition;
+    if ((keyIndexes.size() == 1) && (keyNames.size() == 1))
+    {
+        condition = keyNames[0] + " IN (";
+        for (std::size_t i = begin; i < end; i++)
+        {
+            condition += ((i > begin) ? "," : "") + quote(rows[i][keyIndexes[0]], isLocal);
+        }
+        return condition + ")";
+    }
+
+    for (std::size_t i = begin; i < end; i++)
+    {
+        condition += (i > begin) ? " OR (" : "(";
+        for (std::size_t k = 0; (k < keyIndexes.size()) && (k < keyNames.size()); k++)
+        {
+            condition += ((k > 0) ? " AND " : "") + keyNames[k] + "=" + quote(rows[i][keyIndexes[k]], isLocal);
+        }
+        condition += ")";
+    }
+    return condition;
+}
+
+// The local DB is MySQL, where a backslash escapes too; the central DB only doubles the quote
+std::string TableReplicator::quote(const std::string& value, bool isLocal)
+{
+    if (value == "NULL")
+    {
+        return value;
+    }
+
+    std::string quoted = "'";
+    for (char c : value)
+    {
+        if (c == '\'')
+        {
+            quoted += "''";
+        }
+        else if (isLocal && (c == '\\'))
+        {
+            quoted += "\\\\";
+        }
+        else
+        {
+            quoted += c;
+        }
+    }
+    return quoted + "'";
+}
+
+// The two DBs print the same value differently: padded chars, 1.50 against 1.5, a .000 millisecond part
+std::string TableReplicator::normalize(const std::string& value)
+{
+    std::size_t first = value.find_first_not_of(' ');
+    if (first == std::string::npos)
+    {
+        return "";
+    }
+    std::string normalized = value.substr(first, value.find_last_not_of(' ') - first + 1);
+
+    std::size_t point = normalized.find('.');
+    if (point == std::string::npos)
+    {
+        return normalized;
+    }
+
+    bool isFractionDigits = (point + 1 < normalized.size()) && std::all_of(normalized.begin() + point + 1, normalized.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; });
+    bool isNumber = isFractionDigits && std::all_of(normalized.begin() + ((normalized[0] == '-') ? 1 : 0), normalized.begin() + point, [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; });
+    bool isTime = isFractionDigits && (point >= 8) && (normalized[point - 3] == ':');
+    if (isNumber || isTime)
+    {
+        std::size_t last = normalized.find_last_not_of('0');
+        normalized.erase((last == point) ? point : last + 1);
+    }
+    return normalized;
+}
+
+bool TableReplicator::isSame(const Row& a, const Row& b)
+{
+    if (a.size() != b.size())
+    {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < a.size(); i++)
+    {
+        if (normalize(a[i]) != normalize(b[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t TableReplicator::checksumOf(const Spec& spec, const std::vector<Row>& rows)
+{
+    std::vector<std::pair<std::string, const Row*>> sorted;
+    for (const auto& row : rows)
+    {
+        sorted.emplace_back(keyOf(spec, row), &row);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    boost::crc_32_type crc;
+    for (const auto& entry : sorted)
+    {
+        for (const auto& value : *entry.second)
+        {
+            std::string normalized = normalize(value);
+            crc.process_bytes(normalized.data(), normalized.size());
+            crc.process_byte('\x1f');
+        }
+        crc.process_byte('\x1e');
+    }
+    return crc.checksum();
+}
+
+std::map<std::string, TableReplicator::Stats> TableReplicator::FnGetStats() const
+{
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    return stats_;
+}
+
+void TableReplicator::FnLogStats()
+{
+    for (const auto& entry : FnGetStats())
+    {
+        const Stats& stats = entry.second;
+        std::stringstream ss;
+        ss << "Table sync " << entry.first << " => syncs: " << stats.syncs << ", fetched: " << stats.fetched;
+        ss << ", applied: " << stats.applied << ", unchanged: " << stats.unchanged << ", deleted: " << stats.deleted;
+        ss << ", failures: " << stats.failures << ", mismatches: " << stats.verifyMismatches;
+        ss << ", last: " << stats.lastMs << " ms, checksum " << std::hex << std::setw(8) << std::setfill('0') << stats.lastChecksum;
+        Logger::getInstance()->FnLog(ss.str(), "", "DB");
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class odbc;
+
+// Copies a configuration table from the central DB to the local one as a Spec declares it, in place of a
+// hand written select, update or insert loop per table. Only changed rows move:
+//   - a table with a per station fetched flag reads the rows whose flag is still 0 and sets it once written
+//   - any other table is compared with the local copy, only new and different rows are written
+// Rows are written in bulk. When a unique index of the local table is on the key columns, a multi row
+// INSERT ... ON DUPLICATE KEY UPDATE replaces them in place; otherwise a multi row DELETE of their keys comes
+// first, so a key never ends up twice. A bulk INSERT that fails is retried row by row, a bad row only costs
+// itself. The written rows are read back and their checksum compared with the central one; every sync is
+// counted per table.
+class TableReplicator
+{
+public:
+    static const std::size_t ROWS_PER_STATEMENT = 100;
+    static const int MAX_BATCHES = 1000;
+
+    struct Column
+    {
+        std::string localName;
+        int centralIndex;                       // position in Spec::centralSelect
+        bool isKey;
+    };
+
+    struct Spec
+    {
+        std::string name;                       // in the logs and stats
+        std::string centralTable;
+        std::string centralSelect;              // "*" or a column list
+        std::string centralFilter;              // extra condition on the central rows, blank for none
+        std::string localTable;
+        std::vector<Column> columns;
+        std::string fetchedFlag;                // per station change marker, e.g. s3_fetched, blank to compare
+        std::vector<std::string> centralKeys;   // central names of the key columns, to set the fetched flag
+        int batchRows;                          // central rows per read of a flagged table, 0 = all at once
+        bool isDeletingMissing;                 // compared table: local rows the central DB no longer has go
+    };
+
+    struct Result
+    {
+        int fetched;
+        int applied;
+        int unchanged;
+        int deleted;
+        bool isCentralError;
+        bool isLocalError;
+        bool isVerified;
+    };
+
+    struct Stats
+    {
+        uint64_t syncs;
+        uint64_t fetched;
+        uint64_t applied;
+        uint64_t unchanged;
+        uint64_t deleted;
+        uint64_t failures;
+        uint64_t verifyMismatches;
+        int64_t lastMs;
+        uint32_t lastChecksum;
+    };
+
+    TableReplicator();
+
+    // Runs on the caller's thread, two syncs of the same table must not overlap
+    Result FnSync(const Spec& spec, odbc* central, odbc* local);
+    std::map<std::string, Stats> FnGetStats() const;
+    void FnLogStats();
+
+    TableReplicator(const TableReplicator&) = delete;
+    void operator=(const TableReplicator&) = delete;
+
+private:
+    using Row = std::vector<std::string>;       // values in Spec::columns order
+
+    mutable std::mutex statsMutex_;
+    std::map<std::string, Stats> stats_;
+    bool syncFlagged(const Spec& spec, odbc* central, odbc* local, Result& result, uint32_t& checksum);
+    bool syncCompared(const Spec& spec, odbc* central, odbc* local, Result& result, uint32_t& checksum);
+    static bool readCentral(const Spec& spec, odbc* central, const std::string& statement, std::vector<Row>& rows);
+    // keyRows nullptr reads the whole local table
+    static bool readLocal(const Spec& spec, odbc* local, const std::vector<Row>* keyRows, std::map<std::string, Row>& rows);
+    static bool writeRows(const Spec& spec, odbc* local, const std::vector<Row>& rows);
+    static std::string insertStatement(const Spec& spec, const std::vector<Row>& rows, std::size_t begin, std::size_t end, bool isUpsert);
+    // Whether a unique index of the local table is on exactly the key columns
+    static bool hasUniqueKey(const Spec& spec, odbc* local);
+    static bool deleteRows(const Spec& spec, odbc* local, const std::vector<Row>& rows);
+    static bool markFetched(const Spec& spec, odbc* central, const std::vector<Row>& rows);
+    // Whether the local DB now holds rows as they are, checksum receives theirs
+    static bool verify(const Spec& spec, odbc* local, const std::vector<Row>& rows, bool& isMatched, uint32_t& checksum);
+    static std::string keyOf(const Spec& spec, const Row& row);
+    static std::string keyCondition(const std::vector<std::string>& keyNames, const Spec& spec, const std::vector<Row>& rows, std::size_t begin, std::size_t end, bool isLocal);
+    static std::string quote(const std::string& value, bool isLocal);
+    static std::string normalize(const std::string& value);
+    static bool isSame(const Row& a, const Row& b);
+    static uint32_t checksumOf(const Spec& spec, const std::vector<Row>& rows);
+};
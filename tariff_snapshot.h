@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include "structuredata.h"
+
+// One version of the tariff tables. A published version is never changed: a reload builds the next version
+// beside it and swaps the pointer, so a fee calculation that pinned a version sees all of a reload or none of it.
+struct TariffSnapshot
+{
+    // 0 until the first tariff load, then bumped by every reload
+    uint64_t version = 0;
+    // tariff_setup by rate type and day type, only the defined ones
+    std::map<int, tariff_struct> tariffs;
+    tariff_type_info_struct typeInfo[2];
+    std::vector<std::string> holidays;
+    std::vector<XTariff_Struct> xTariffs;
+
+    static int FnMakeKey(int rateType, int dayType)
+    {
+        return (rateType * 10) + dayType;
+    }
+
+    // An undefined tariff comes back empty (no start time), as the unset array entries did
+    const tariff_struct& FnGetTariff(int rateType, int dayType) const
+    {
+        static const tariff_struct emptyTariff = {};
+        auto it = tariffs.find(FnMakeKey(rateType, dayType));
+        return (it != tariffs.end()) ? it->second : emptyTariff;
+    }
+};
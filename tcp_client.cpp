@@ -11,6 +11,16 @@ AppTcpClient::AppTcpClient(boost::asio::io_context& io_context, const std::strin
 
 }
 
+AppTcpClient::AppTcpClient(boost::asio::strand<boost::asio::io_context::executor_type> strand, const std::string& ipAddress, unsigned short port)
+    :   strand_(std::move(strand)),
+        socket_(strand_),
+        endpoint_(boost::asio::ip::address::from_string(ipAddress), port),
+        buffer_(2048),
+        isConnected_(false)
+{
+
+}
+
 void AppTcpClient::send(const std::vector<uint8_t>& message)
 {
     if (!isConnected_.load())
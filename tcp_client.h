@@ -11,6 +11,8 @@ class AppTcpClient
 {
 public:
     AppTcpClient(boost::asio::io_context& io_context, const std::string& ipAddress, unsigned short port);
+    // Handlers run on the owner's strand, for owners that keep their own state on that strand
+    AppTcpClient(boost::asio::strand<boost::asio::io_context::executor_type> strand, const std::string& ipAddress, unsigned short port);
 
     void send(const std::vector<uint8_t>& message);
     void connect();
@@ -1,15 +1,15 @@
 #include "touchngo_reader.h"
+#include "io_executor.h"
 #include "log.h"
 #include <boost/json.hpp>
 #include "event_manager.h"
 
-TnG_Reader* TnG_Reader::TnG_Reader_;
+std::array<std::atomic<TnG_Reader*>, LaneContext::MAX_LANES> TnG_Reader::TnG_Readers_ = {};
 std::mutex TnG_Reader::mutex_;
 
 TnG_Reader::TnG_Reader()
-    : ioContext_(),
-    strand_(boost::asio::make_strand(ioContext_)),
-    work_(ioContext_),
+    : laneId_(LaneContext::FnGetCurrentLane()),
+    strand_(boost::asio::make_strand(IOExecutor::getInstance()->FnGetIOContext())),
     initialized_(false),
     logFileName_("tng")
 {
@@ -18,12 +18,7 @@ TnG_Reader::TnG_Reader()
 
 TnG_Reader* TnG_Reader::getInstance()
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (TnG_Reader_ == nullptr)
-    {
-        TnG_Reader_ = new TnG_Reader();
-    }
-    return TnG_Reader_;
+    return LazyInstance::FnGet(TnG_Readers_[LaneContext::FnGetCurrentLane()], mutex_, []() { return new TnG_Reader(); });
 }
 
 void TnG_Reader::FnTnGReaderInit(const std::string& remoteServerHost, const std::string& remoteServerPort, const std::string& listenHost, const std::string& listenPort)
@@ -39,12 +34,12 @@ void TnG_Reader::FnTnGReaderInit(const std::string& remoteServerHost, const std:
 
         auto const listen_address = boost::asio::ip::make_address(listenHost_);
         auto const listen_port = static_cast<unsigned short>(std::stoi(listenPort_));
-        startIoContextThread();
+        boost::asio::io_context& ioContext = IOExecutor::getInstance()->FnGetIOContext();
 
-        httpClient_ = std::make_shared<HttpClient>(ioContext_);
-        httpServer_ = std::make_shared<HttpServer>(ioContext_, boost::asio::ip::tcp::endpoint{listen_address, listen_port},
-                        std::bind(&TnG_Reader::serverHandleFailureCb, this, std::placeholders::_1),
-                        std::bind(&TnG_Reader::serverHandleRequestCb, this, std::placeholders::_1));
+        httpClient_ = std::make_shared<HttpClient>(ioContext);
+        httpServer_ = std::make_shared<HttpServer>(ioContext, boost::asio::ip::tcp::endpoint{listen_address, listen_port},
+                        LaneContext::FnBind(laneId_, std::bind(&TnG_Reader::serverHandleFailureCb, this, std::placeholders::_1)),
+                        LaneContext::FnBind(laneId_, std::bind(&TnG_Reader::serverHandleRequestCb, this, std::placeholders::_1)));
         httpServer_->run();
 
         initialized_.store(true);
@@ -73,22 +68,6 @@ void TnG_Reader::FnTnGReaderClose()
     initialized_.store(false);
 
     Logger::getInstance()->FnLog(__func__, logFileName_, "TNG");
-
-    ioContext_.stop();
-    if (ioContextThread_.joinable())
-    {
-        ioContextThread_.join();
-    }
-}
-
-void TnG_Reader::startIoContextThread()
-{
-    Logger::getInstance()->FnLog(__func__, logFileName_, "TNG");
-
-    if (!ioContextThread_.joinable())
-    {
-        ioContextThread_ = std::thread([this]() { ioContext_.run(); });
-    }
 }
 
 void TnG_Reader::FnTnGReader_PayRequest(int payAmt, int discountAmt, long long enterTime, long long payTime, const std::string& orderId)
@@ -109,8 +88,8 @@ void TnG_Reader::FnTnGReader_PayRequest(int payAmt, int discountAmt, long long e
 
                 httpClient_->post(remoteServerHost_, remoteServerPort_, "/w4g/PayRequest", 
                     boost::json::serialize(obj), 
-                    std::bind(&TnG_Reader::payRequestSuccessCb, this, std::placeholders::_1),
-                    std::bind(&TnG_Reader::payRequestFailureCb, this, std::placeholders::_1, std::placeholders::_2));
+                    LaneContext::FnBind(laneId_, std::bind(&TnG_Reader::payRequestSuccessCb, this, std::placeholders::_1)),
+                    LaneContext::FnBind(laneId_, std::bind(&TnG_Reader::payRequestFailureCb, this, std::placeholders::_1, std::placeholders::_2)));
                 
                 std::ostringstream oss;
                 oss << "Outgoing req => " << " path: /w4g/PayRequest , data: " << boost::json::serialize(obj);
@@ -126,7 +105,7 @@ void TnG_Reader::payRequestSuccessCb(const boost::beast::http::response<boost::b
     oss << __func__ << " Incoming res <= data: " << res.body();
     Logger::getInstance()->FnLog(oss.str(), logFileName_, "TNG");
 
-    EventManager::getInstance()->FnEnqueueEvent("Evt_handleTnGPayRequest", true);
+    EventManager::getInstance()->FnEnqueueEvent(EventID::TNG_PAY_REQUEST, true);
 }
 
 void TnG_Reader::payRequestFailureCb(const std::string& what, const boost::beast::error_code& ec)
@@ -135,7 +114,7 @@ void TnG_Reader::payRequestFailureCb(const std::string& what, const boost::beast
     oss << __func__ << " Error: " << what << ": " << ec.message();
     Logger::getInstance()->FnLog(oss.str(), logFileName_, "TNG");
 
-    EventManager::getInstance()->FnEnqueueEvent("Evt_handleTnGPayRequest", false);
+    EventManager::getInstance()->FnEnqueueEvent(EventID::TNG_PAY_REQUEST, false);
 }
 
 void TnG_Reader::FnTnGReader_PayCancel(const std::string& orderId)
@@ -152,8 +131,8 @@ void TnG_Reader::FnTnGReader_PayCancel(const std::string& orderId)
 
                 httpClient_->post(remoteServerHost_, remoteServerPort_, "/w4g/PayCancel",
                     boost::json::serialize(obj),
-                    std::bind(&TnG_Reader::payCancelSuccessCb, this, std::placeholders::_1),
-                    std::bind(&TnG_Reader::payCancelFailureCb, this, std::placeholders::_1, std::placeholders::_2));
+                    LaneContext::FnBind(laneId_, std::bind(&TnG_Reader::payCancelSuccessCb, this, std::placeholders::_1)),
+                    LaneContext::FnBind(laneId_, std::bind(&TnG_Reader::payCancelFailureCb, this, std::placeholders::_1, std::placeholders::_2)));
                 
                 std::ostringstream oss;
                 oss << "Outgoing req => " << " path: /w4g/PayCancel , data: " << boost::json::serialize(obj);
@@ -169,7 +148,7 @@ void TnG_Reader::payCancelSuccessCb(const boost::beast::http::response<boost::be
     oss << __func__ << " Incoming res <= data: " << res.body();
     Logger::getInstance()->FnLog(oss.str(), logFileName_, "TNG");
 
-    EventManager::getInstance()->FnEnqueueEvent("Evt_handleTnGPayCancelRequest", true);
+    EventManager::getInstance()->FnEnqueueEvent(EventID::TNG_PAY_CANCEL_REQUEST, true);
 }
 
 void TnG_Reader::payCancelFailureCb(const std::string& what, const boost::beast::error_code& ec)
@@ -178,7 +157,7 @@ void TnG_Reader::payCancelFailureCb(const std::string& what, const boost::beast:
     oss << __func__ << " Error: " << what << ": " << ec.message();
     Logger::getInstance()->FnLog(oss.str(), logFileName_, "TNG");
 
-    EventManager::getInstance()->FnEnqueueEvent("Evt_handleTnGPayCancelRequest", false);
+    EventManager::getInstance()->FnEnqueueEvent(EventID::TNG_PAY_CANCEL_REQUEST, false);
 }
 
 void TnG_Reader::FnTnGReader_EnableReader(int enable, const std::string& orderId)
@@ -197,8 +176,8 @@ void TnG_Reader::FnTnGReader_EnableReader(int enable, const std::string& orderId
 
                 httpClient_->post(remoteServerHost_, remoteServerPort_, "/w4g/ReaderCtrl",
                     boost::json::serialize(obj),
-                    std::bind(&TnG_Reader::enableReaderSuccessCb, this, std::placeholders::_1),
-                    std::bind(&TnG_Reader::enableReaderFailureCb, this, std::placeholders::_1, std::placeholders::_2));
+                    LaneContext::FnBind(laneId_, std::bind(&TnG_Reader::enableReaderSuccessCb, this, std::placeholders::_1)),
+                    LaneContext::FnBind(laneId_, std::bind(&TnG_Reader::enableReaderFailureCb, this, std::placeholders::_1, std::placeholders::_2)));
                 
                 std::ostringstream oss;
                 oss << "Outgoing req => " << " path: /w4g/ReaderCtrl , data: " << boost::json::serialize(obj);
@@ -214,7 +193,7 @@ void TnG_Reader::enableReaderSuccessCb(const boost::beast::http::response<boost:
     oss << __func__ << " Incoming res <= data: " << res.body();
     Logger::getInstance()->FnLog(oss.str(), logFileName_, "TNG");
 
-    EventManager::getInstance()->FnEnqueueEvent("Evt_handleTnGEnableReaderRequest", true);
+    EventManager::getInstance()->FnEnqueueEvent(EventID::TNG_ENABLE_READER_REQUEST, true);
 }
 
 void TnG_Reader::enableReaderFailureCb(const std::string& what, const boost::beast::error_code& ec)
@@ -223,7 +202,7 @@ void TnG_Reader::enableReaderFailureCb(const std::string& what, const boost::bea
     oss << __func__ << " Error: " << what << ": " << ec.message();
     Logger::getInstance()->FnLog(oss.str(), logFileName_, "TNG");
 
-    EventManager::getInstance()->FnEnqueueEvent("Evt_handleTnGEnableReaderRequest", false);
+    EventManager::getInstance()->FnEnqueueEvent(EventID::TNG_ENABLE_READER_REQUEST, false);
 }
 
 void TnG_Reader::serverHandleFailureCb(const std::string& what)
@@ -332,7 +311,7 @@ boost::beast::http::response<boost::beast::http::string_body> TnG_Reader::server
                     oss << ",apprCode=" << apprCode;
                     Logger::getInstance()->FnLog(oss.str(), logFileName_, "TNG");
 
-                    EventManager::getInstance()->FnEnqueueEvent("Evt_handleTnGPayResultReceived", oss.str());
+                    EventManager::getInstance()->FnEnqueueEvent(EventID::TNG_PAY_RESULT_RECEIVED, oss.str());
                 }
                 else if (path == "/w4g/CardNoUpl")
                 {
@@ -359,7 +338,7 @@ boost::beast::http::response<boost::beast::http::string_body> TnG_Reader::server
                     oss << ",orderId=" << orderId;
                     Logger::getInstance()->FnLog(oss.str(), logFileName_, "TNG");
 
-                    EventManager::getInstance()->FnEnqueueEvent("Evt_handleTnGCardNumReceived", oss.str());
+                    EventManager::getInstance()->FnEnqueueEvent(EventID::TNG_CARD_NUM_RECEIVED, oss.str());
                 }
                 else
                 {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <iostream>
 #include <string>
 #include <thread>
@@ -12,6 +13,8 @@
 #include "boost/asio/strand.hpp"
 #include "http_client.h"
 #include "http_server.h"
+#include "lane_context.h"
+#include "lazy_instance.h"
 
 
 // Touch N Go Reader Class
@@ -38,13 +41,11 @@ public:
     void operator=(const TnG_Reader&) = delete;
 
 private:
-    static TnG_Reader* TnG_Reader_;
+    static std::array<std::atomic<TnG_Reader*>, LaneContext::MAX_LANES> TnG_Readers_;
     static std::mutex mutex_;
-    boost::asio::io_context ioContext_;
-    boost::asio::io_context::work work_;
+    int laneId_;
     boost::asio::strand<boost::asio::io_context::executor_type> strand_;
     std::atomic<bool> initialized_;
-    std::thread ioContextThread_;
     std::string logFileName_;
     std::string remoteServerHost_;
     std::string remoteServerPort_;
@@ -53,7 +54,6 @@ private:
     std::shared_ptr<HttpClient> httpClient_;
     std::shared_ptr<HttpServer> httpServer_;
     TnG_Reader();
-    void startIoContextThread();
     void payRequestSuccessCb(const boost::beast::http::response<boost::beast::http::string_body>& res);
     void payRequestFailureCb(const std::string& what, const boost::beast::error_code& ec);
     void payCancelSuccessCb(const boost::beast::http::response<boost::beast::http::string_body>& res);
@@ -1,600 +1,730 @@
 
 #include "udp.h"
 #include "ce_time.h"
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <cstdlib>
 #include <string>
+#include <string_view>
+#include "async_flow.h"
 #include "dio.h"
+#include "dio_sequencer.h"
 #include "gpio.h"
-#include "parsedata.h"
 #include "operation.h"
 #include "db.h"
 #include "lcd.h"
 #include "log.h"
+#include "offline_uploader.h"
+#include "paid_exit_cache.h"
 #include "version.h"
 #include "common.h"
 #include "shutdown_manager.h"
+#include "station_status.h"
 
-void udpclient::processmonitordata (const char* data, std::size_t length) 
+namespace
 {
-	try
+	// Job acknowledgements and results, the PMS takes them as info messages, the monitor has a code of its own
+	void replyToPms(const std::string& text)
 	{
-		int rxcmd;
-		int n,i;
-		string sData;
-		//-------
-
-		ParseData pField('[',']','|');
-		n=pField.Parse(data);
-		
-		if(n < 4){
-			//std::stringstream dbss;
-			//dbss << "URX: invalid number of arguments" ;
-			//Logger::getInstance()->FnLog(dbss.str(), "", "UDP");
-			return;
+		operation::getInstance()->SendMsg2Server("99", text);
+	}
+
+	void replyToMonitor(const std::string& text)
+	{
+		operation::getInstance()->SendMsg2Monitor("317", text);
+	}
+
+	// A download that found nothing to fetch still succeeded, unless the central DB could not be read
+	UdpJobExecutor::JobResult downloadResult(int ret, const std::string& tableName)
+	{
+		std::stringstream ss;
+		ss << "Download " << ((ret > 0) ? ret : 0) << " " << tableName;
+		return { db::getInstance()->FnGetDatabaseErrorFlag() == 0, ss.str() };
+	}
+
+	// The rows are read on the job thread, the lane's copy is replaced on its flow strand between its flows
+	template <typename Rows>
+	void reloadLane(std::function<void(Rows&)> fetch, std::function<void(Rows&)> apply)
+	{
+		auto rows = std::make_shared<Rows>();
+		fetch(*rows);
+		AsyncFlow::getInstance()->FnPost([rows, apply]() { apply(*rows); });
+	}
+
+	// A table every lane shares was downloaded, each lane reloads its own copy of it
+	template <typename Rows>
+	void reloadEachLane(std::function<void(Rows&)> fetch, std::function<void(Rows&)> apply)
+	{
+		for (int laneId = 0; laneId < LaneContext::FnGetLaneCount(); laneId++)
+		{
+			LaneContext::Scope laneScope(laneId, false);
+			reloadLane<Rows>(fetch, apply);
 		}
-		
-		rxcmd = std::stoi(pField.Field(2));
-		switch(rxcmd)
+	}
+
+	void reloadParam()
+	{
+		reloadLane<ParamRows>([](ParamRows& rows) { operation::getInstance()->m_db->FetchParamRows(rows); },
+			[](ParamRows& rows) { operation::getInstance()->m_db->ApplyParamRows(rows); });
+	}
+}
+
+void udpclient::submitJob(const std::string& key, UdpJobExecutor::JobScope scope, JobReply reply, UdpJobExecutor::JobFunction job, JobFinished finished)
+{
+	UdpJobExecutor::Submission submission = UdpJobExecutor::getInstance()->FnSubmit(key, scope, std::move(job), [this, key, reply, finished](uint64_t jobId, const UdpJobExecutor::JobResult& result)
+	{
+		// The result is reported from the receive strand, where the command used to finish
+		boost::asio::post(strand_, LaneContext::FnBind(laneId_, [key, reply, finished, jobId, result]()
+		{
+			std::stringstream ss;
+			ss << "Job " << jobId << " " << key << (result.success ? " done" : " failed");
+			if (!result.message.empty())
+			{
+				ss << ", " << result.message;
+			}
+			reply(ss.str());
+
+			if (finished)
+			{
+				finished(jobId, result);
+			}
+		}));
+	});
+
+	std::stringstream ss;
+	ss << "Job " << submission.jobId << " " << key << " " << UdpJobExecutor::FnGetStatusText(submission.status);
+	operation::getInstance()->writelog(ss.str(), "UDP");
+	reply(ss.str());
+}
+
+void udpclient::registerMonitorCommands()
+{
+	monitorCommands_.FnRegister(CmdMonitorStatus, [this](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		bool isConnected = (frame.FnGetInt(UdpFrame::DATA_FIELD) == 1);
+		if (isConnected && !monitorStatus_)
+		{
+			// A monitor that (re)connects starts from a full station status
+			StationStatus::FnRequestKeyframeAllLanes();
+		}
+		monitorStatus_ = isConnected;
+	});
+
+	// Sent by the monitor when it sees a gap in the status versions
+	monitorCommands_.FnRegister(CmdMonitorStatusResync, [](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		StationStatus::FnRequestKeyframeAllLanes();
+	});
+
+	monitorCommands_.FnRegister(CmdMonitorEnquiry, [](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		operation::getInstance()->FnSendMyStatusToMonitor();
+	});
+
+	monitorCommands_.FnRegister(CmdMonitorFeeTest, [](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+	});
+
+	monitorCommands_.FnRegister(CmdMonitorOutput, [](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		std::vector<std::string_view> dataTokens = frame.FnSplit(UdpFrame::DATA_FIELD, ',');
+
+		if (dataTokens.size() == 2)
 		{
-			case CmdMonitorStatus:
+			std::cout << "pinNum : " << dataTokens[0] << std::endl;
+			std::cout << "pinValue : " << dataTokens[1] << std::endl;
+			int pinNum = 0;
+			int pinValue = -1;
+			UdpFrame::FnParseInt(dataTokens[0], pinNum);
+			UdpFrame::FnParseInt(dataTokens[1], pinValue);
+			int actualDIOPinNum = DIO::getInstance()->FnGetOutputPinNum(pinNum);
+
+			if ((actualDIOPinNum != 0) && (pinValue == 0 || pinValue == 1))
 			{
-				operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
-				int status = std::stoi(pField.Field(3));
-				if (status == 1)
+				if (GPIOManager::getInstance()->FnGetGPIO(actualDIOPinNum) != nullptr)
 				{
-					monitorStatus_ = true;
+					DIOSequencer::getInstance()->FnSet(actualDIOPinNum, pinValue);
 				}
 				else
 				{
-					monitorStatus_ = false;
+					operation::getInstance()->writelog("Nullptr, Invalid DIO", "UDP");
 				}
-				break;
 			}
-			case CmdMonitorEnquiry:
+			else
 			{
-				operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
-				operation::getInstance()->FnSendMyStatusToMonitor();
-				break;
+				operation::getInstance()->writelog("Invalid DIO", "UDP");
 			}
-			case CmdMonitorFeeTest:
+		}
+	});
+
+	monitorCommands_.FnRegister(CmdDownloadIni, [this](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		operation::getInstance()->writelog("download INI file","UDP");
+
+		std::string serverIpAddress = frame.FnGetText(UdpFrame::SENDER_FIELD);
+		std::string stationID = frame.FnGetText(UdpFrame::DATA_FIELD);
+		submitJob("DownloadIni", UdpJobExecutor::JobScope::Lane, replyToMonitor, [serverIpAddress, stationID]()
+		{
+			bool success = operation::getInstance()->CopyIniFile(serverIpAddress, stationID);
+			return UdpJobExecutor::JobResult{ success, "" };
+		},
+		[](uint64_t, const UdpJobExecutor::JobResult& result)
+		{
+			operation::getInstance()->FnSendCmdDownloadIniAckToMonitor(result.success);
+		});
+	});
+
+	monitorCommands_.FnRegister(CmdDownloadParam, [this](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		operation::getInstance()->writelog("download Parameter","UDP");
+
+		submitJob("DownloadParam", UdpJobExecutor::JobScope::Lane, replyToMonitor, []()
+		{
+			int ret = operation::getInstance()->m_db->downloadparameter();
+			if (db::getInstance()->FnGetDatabaseErrorFlag() != 0)
 			{
-				operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
-				break;
+				return UdpJobExecutor::JobResult{ false, "" };
 			}
-			case CmdMonitorOutput:
+			reloadParam();
+			return downloadResult(ret, "Parameter");
+		},
+		[](uint64_t, const UdpJobExecutor::JobResult& result)
+		{
+			operation::getInstance()->FnSendCmdDownloadParamAckToMonitor(result.success);
+		});
+	});
+
+	monitorCommands_.FnRegister(CmdMonitorSyncTime, [](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		operation::getInstance()->FnSyncCentralDBTime();
+	});
+
+	monitorCommands_.FnRegister(CmdStopStationSoftware, [](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		operation::getInstance()->SendMsg2Monitor("11", "99");
+
+		std::exit(0);
+	});
+
+	monitorCommands_.FnRegister(CmdMonitorStationVersion, [](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		operation::getInstance()->SendMsg2Monitor("313", SW_VERSION);
+	});
+
+	monitorCommands_.FnRegister(CmdMonitorGetStationCurrLog, [](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		operation::getInstance()->FnSendCmdGetStationCurrLogToMonitor();
+	});
+
+	monitorCommands_.FnRegister(CmdMonitorBootTimeline, [](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		operation::getInstance()->FnSendBootTimelineToMonitor();
+	});
+
+	monitorCommands_.FnRegister(CmdMonitorDIOSequencer, [](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		operation::getInstance()->FnSendDIOSequencerToMonitor();
+	});
+}
+
+void udpclient::registerPmsCommands()
+{
+	pmsCommands_.FnRegister(CmdStopStationSoftware, [](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		operation::getInstance()->SendMsg2Server("09","11Stopping...");
+		operation::getInstance()->writelog("Exit by PMS", "UDP");
+
+		ShutdownManager::getInstance()->gracefulShutdown();
+	});
+
+	pmsCommands_.FnRegister(CmdStatusEnquiry, [](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		operation::getInstance()->Sendmystatus();
+	});
+
+	pmsCommands_.FnRegister(CmdStatusOnline, [](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+
+		// If system current state is offline
+		if (operation::getInstance()->tProcess.giSystemOnline != 0)
+		{
+			std::stringstream ss;
+			ss << "Status: " << (operation::getInstance()->tProcess.giSystemOnline == 0) ? "Online" : "Offline";
+			operation::getInstance()->writelog(ss.str(), "UDP");
+
+			// Set the system current state to online
+			operation::getInstance()->tProcess.giSystemOnline = 0;
+
+			// Check and move the offline data
+			if (operation::getInstance()->tProcess.glNoofOfflineData > 0)
 			{
-				operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
-				std::vector<std::string> dataTokens;
-				std::stringstream ss(pField.Field(3));
-				std::string token;
+				OfflineUploader::getInstance()->FnRequest("online");
+			}
+		}
+		operation::getInstance()->SendMsg2Server("99", "");
+	});
 
-				while (std::getline(ss, token, ','))
-				{
-					dataTokens.push_back(token);
-				}
+	pmsCommands_.FnRegister(CmdUpdateSeason, [this](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		submitJob("DownloadSeason", UdpJobExecutor::JobScope::Lane, replyToPms, []()
+		{
+			int ret = operation::getInstance()->m_db->downloadseason();
+			return downloadResult(ret, "Season");
+		});
+	});
 
-				if (dataTokens.size() == 2)
+	pmsCommands_.FnRegister(CmdDownloadMsg, [this](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		operation::getInstance()->writelog("download LED message","UDP");
+		submitJob("DownloadMsg", UdpJobExecutor::JobScope::Lane, replyToPms, []()
+		{
+			int ret = operation::getInstance()->m_db->downloadledmessage();
+			reloadLane<MessageRows>([](MessageRows& rows) { operation::getInstance()->m_db->FetchMessageRows(rows); },
+				[](MessageRows& rows)
 				{
-					std::cout << "pinNum : " << dataTokens[0] << std::endl;
-					std::cout << "pinValue : " << dataTokens[1] << std::endl;
-					int pinNum = std::stoi(dataTokens[0]);
-					int pinValue = std::stoi(dataTokens[1]);
-					int actualDIOPinNum = DIO::getInstance()->FnGetOutputPinNum(pinNum);
+					operation::getInstance()->m_db->ApplyEntryMessageRows(rows);
+					operation::getInstance()->m_db->ApplyExitMessageRows(rows);
 
-					if ((actualDIOPinNum != 0) && (pinValue == 0 || pinValue == 1))
+					// The idle messages are taken from the new ones
+					if (operation::getInstance()->tProcess.gbcarparkfull.load() == false)
 					{
-						if (GPIOManager::getInstance()->FnGetGPIO(actualDIOPinNum) != nullptr)
+						if (operation::getInstance()->gtStation.iType == tientry)
 						{
-							GPIOManager::getInstance()->FnGetGPIO(actualDIOPinNum)->FnSetValue(pinValue);
+							operation::getInstance()->tProcess.setIdleMsg(0, operation::getInstance()->tMsg.Msg_DefaultLED[0]);
+							operation::getInstance()->tProcess.setIdleMsg(1, operation::getInstance()->tMsg.Msg_Idle[1]);
 						}
 						else
 						{
-							operation::getInstance()->writelog("Nullptr, Invalid DIO", "UDP");
+							operation::getInstance()->tProcess.setIdleMsg(0, operation::getInstance()->tExitMsg.MsgExit_XDefaultLED[0]);
+							operation::getInstance()->tProcess.setIdleMsg(1, operation::getInstance()->tExitMsg.MsgExit_XIdle[1]);
 						}
 					}
-					else
-					{
-						operation::getInstance()->writelog("Invalid DIO", "UDP");
-					}
-				}
-				break;
-			}
-			case CmdDownloadIni:
-			{
-				operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
-				operation::getInstance()->writelog("download INI file","UDP");
+				});
+			return downloadResult(ret, "Messages");
+		});
+	});
 
-				if (operation::getInstance()->CopyIniFile(pField.Field(0), pField.Field(3)))
-				{
-					operation::getInstance()->FnSendCmdDownloadIniAckToMonitor(true);
-				}
-				else
-				{
-					operation::getInstance()->FnSendCmdDownloadIniAckToMonitor(false);
-				}
-				break;
-			}
-			case CmdDownloadParam:
-			{
-				operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
-				operation::getInstance()->writelog("download Parameter","UDP");
-				operation::getInstance()->m_db->downloadparameter();
+	pmsCommands_.FnRegister(CmdFeeTest, [this](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		operation::getInstance()->writelog("Fee test command","UDP");
+		// entry time, pay time, trans type
+		std::vector<std::string_view> tmpStr = frame.FnSplit(UdpFrame::DATA_FIELD, ',');
+		int iTransType;
+		if ((tmpStr.size() < 3) || !UdpFrame::FnParseInt(tmpStr[2], iTransType))
+		{
+			operation::getInstance()->writelog("Invalid fee test data", "UDP");
+			return;
+		}
 
-				if (db::getInstance()->FnGetDatabaseErrorFlag() == 0)
-				{
-					operation::getInstance()->m_db->loadParam();
-					operation::getInstance()->FnSendCmdDownloadParamAckToMonitor(true);
-				}
-				else
-				{
-					operation::getInstance()->FnSendCmdDownloadParamAckToMonitor(false);
-				}
-				break;
-			}
-			case CmdMonitorSyncTime:
-			{
-				operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
-				operation::getInstance()->FnSyncCentralDBTime();
-				break;
-			}
-			case CmdStopStationSoftware:
+		// The same test asked again while it runs gets the one answer
+		std::string sData = frame.FnGetText(UdpFrame::DATA_FIELD);
+		std::string sEntryTime(tmpStr[0]);
+		std::string sPayTime(tmpStr[1]);
+		submitJob("FeeTest " + sData, UdpJobExecutor::JobScope::Lane, replyToPms, [sData, sEntryTime, sPayTime, iTransType]()
+		{
+			float parkingfee = operation::getInstance()->m_db->CalFeeRAM2G(sEntryTime, sPayTime, iTransType);
+			if (parkingfee < 0)
 			{
-				operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
-				operation::getInstance()->SendMsg2Monitor("11", "99");
-
-				std::exit(0);
-				break;
+				return UdpJobExecutor::JobResult{ false, "" };
 			}
-			case CmdMonitorStationVersion:
+			return UdpJobExecutor::JobResult{ true, sData + "," + Common::getInstance()->SetFeeFormat(parkingfee) + ", Fee OK" };
+		},
+		[](uint64_t, const UdpJobExecutor::JobResult& result)
+		{
+			if (result.success)
 			{
-				operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
-				operation::getInstance()->SendMsg2Monitor("313", SW_VERSION);
-				break;
+				operation::getInstance()->SendMsg2Server("302", result.message);
 			}
-			case CmdMonitorGetStationCurrLog:
+		});
+	});
+
+	pmsCommands_.FnRegister(CmdDownloadXTariff, [this](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		operation::getInstance()->writelog("download XTariff","UDP");
+		submitJob("DownloadXTariff", UdpJobExecutor::JobScope::Lane, replyToPms, []()
+		{
+			int ret = operation::getInstance()->m_db->downloadxtariff(operation::getInstance()->tParas.giGroupID,operation::getInstance()->tParas.giSite, 0);
+			if (ret > 0)
 			{
-				operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
-				operation::getInstance()->FnSendCmdGetStationCurrLogToMonitor();
-				break;
+				operation::getInstance()->m_db->LoadXTariff();
 			}
-			default:
-				break;
-		}
-	}
-	catch (const std::exception& e)
-    {
-        std::stringstream ss;
-        ss << __func__ << ", Exception: " << e.what();
-        Logger::getInstance()->FnLogExceptionError(ss.str());
-    }
-    catch (...)
-    {
-        std::stringstream ss;
-        ss << __func__ << ", Exception: Unknown Exception";
-        Logger::getInstance()->FnLogExceptionError(ss.str());
-    }
-}
+			return downloadResult(ret, "XTariff");
+		});
+	});
 
-void udpclient::processdata (const char* data, std::size_t length) 
-{
-	try
+	pmsCommands_.FnRegister(CmdDownloadTariff, [this](const UdpFrame& frame)
 	{
-		// Your processing logic here
-		// Example: Print the received data
-
-		int rxcmd;
-		int n,i;
-		string sData;
-		//-------
-
-		ParseData pField('[',']','|');
-		n=pField.Parse(data);
-		
-		if(n < 4){
-			//std::stringstream dbss;
-			//dbss << "URX: invalid number of arguments" ;
-			//Logger::getInstance()->FnLog(dbss.str(), "", "UDP");
-			return;
-		}
-		
-		rxcmd = std::stoi(pField.Field(2));
-		//---------
-		switch(rxcmd)
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		submitJob("DownloadTariff", UdpJobExecutor::JobScope::Lane, replyToPms, []()
 		{
-			case CmdStopStationSoftware:
+			int ret;
+			// Both tables go out as one tariff version, a fee is never calculated with one new and one old
+			TariffSnapshot tariff = operation::getInstance()->m_db->FnBeginTariffReload();
+			bool isLoaded = false;
+			operation::getInstance()->writelog("download Tariff Type Info","UDP");
+			ret = operation::getInstance()->m_db->downloadtarifftypeinfo();
+			if (ret > 0)
 			{
-				operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
-				operation::getInstance()->SendMsg2Server("09","11Stopping...");
-				operation::getInstance()->writelog("Exit by PMS", "UDP");
-
-				ShutdownManager::getInstance()->gracefulShutdown();
-				/*
-				// Display Station Stopped on LCD
-				std::string LCDMsg = "Station Stopped!";
-				char* sLCDMsg = const_cast<char*>(LCDMsg.data());
-				LCD::getInstance()->FnLCDClearDisplayRow(1);
-				LCD::getInstance()->FnLCDDisplayRow(1, sLCDMsg);
-
-				std::exit(0);
-				*/
-				break;
+				isLoaded = (operation::getInstance()->m_db->LoadTariffTypeInfo(&tariff) == iDBSuccess) || isLoaded;
 			}
-			case CmdStatusEnquiry:
+			//---------
+			operation::getInstance()->writelog("download Tariff","UDP");
+			ret = operation::getInstance()->m_db->downloadtariffsetup(operation::getInstance()->tParas.giGroupID,operation::getInstance()->tParas.giSite, 0);
+			if (ret > 0)
 			{
-				operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
-				operation::getInstance()->Sendmystatus();
-				break;
+				isLoaded = (operation::getInstance()->m_db->LoadTariff(&tariff) == iDBSuccess) || isLoaded;
 			}
-			case CmdStatusOnline:
+			if (isLoaded)
 			{
-				operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
+				operation::getInstance()->m_db->FnPublishTariff(std::move(tariff), "tariff_type_info, tariff_setup");
+			}
+			return downloadResult(ret, "Tariff");
+		});
+	});
 
-				// If system current state is offline
-				if (operation::getInstance()->tProcess.giSystemOnline != 0)
-				{
-					std::stringstream ss;
-					ss << "Status: " << (operation::getInstance()->tProcess.giSystemOnline == 0) ? "Online" : "Offline";
-					operation::getInstance()->writelog(ss.str(), "UDP");
+	pmsCommands_.FnRegister(CmdDownloadHoliday, [this](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		operation::getInstance()->writelog("download Holiday", "UDP");
+		submitJob("DownloadHoliday", UdpJobExecutor::JobScope::Lane, replyToPms, []()
+		{
+			int ret = operation::getInstance()->m_db->downloadholidaymst(1);
+			operation::getInstance()->m_db->LoadHoliday();
+			return downloadResult(ret, "Holiday");
+		});
+	});
 
-					// Set the system current state to online
-					operation::getInstance()->tProcess.giSystemOnline = 0;
+	pmsCommands_.FnRegister(CmdUpdateParam, [this](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		operation::getInstance()->writelog("download Parameter","UDP");
+		submitJob("DownloadParam", UdpJobExecutor::JobScope::Lane, replyToPms, []()
+		{
+			int ret = operation::getInstance()->m_db->downloadparameter();
+			reloadParam();
+			return downloadResult(ret, "Parameter");
+		});
+	});
 
-					// Check and move the offline data
-					if (operation::getInstance()->tProcess.glNoofOfflineData > 0)
-					{
-						db::getInstance()->moveOfflineTransToCentral();
-					}
-				}
-				operation::getInstance()->SendMsg2Server("99", "");
-				break;
-			}
-			case CmdUpdateSeason:
-			{
-				operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
-				int ret = operation::getInstance()->m_db->downloadseason();
-				if (ret > 0)
-				{
-					std::stringstream ss;
-					ss << "Download " << ret << " Season";
-					operation::getInstance()->SendMsg2Server("99", ss.str());
-				}
-				break;
-			}
-			case CmdDownloadMsg:
-			{
-				operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
-				operation::getInstance()->writelog("download LED message","UDP");
-				int ret = operation::getInstance()->m_db->downloadledmessage();
-				if (ret > 0)
-				{
-					std::stringstream ss;
-					ss << "Download " << ret << " Messages";
-					operation::getInstance()->SendMsg2Server("99", ss.str());
-				}
-				operation::getInstance()->m_db->loadmessage();
-				operation::getInstance()->m_db->loadExitmessage();
-				if (operation::getInstance()->tProcess.gbcarparkfull.load() == false)
+	pmsCommands_.FnRegister(CmdDownloadtype, [this](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		operation::getInstance()->writelog("download Vehicle Type","UDP");
+		submitJob("DownloadVehicleType", UdpJobExecutor::JobScope::Controller, replyToPms, []()
+		{
+			int ret = operation::getInstance()->m_db->downloadvehicletype();
+			reloadEachLane<ConfigRows>([](ConfigRows& rows) { operation::getInstance()->m_db->FetchVehicleTypeRows(rows); },
+				[](ConfigRows& rows) { operation::getInstance()->m_db->ApplyVehicleTypeRows(rows); });
+			return downloadResult(ret, "Vehicle Type");
+		});
+	});
+
+	pmsCommands_.FnRegister(CmdOpenBarrier, [](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		operation::getInstance()->writelog("open barrier from PMS","UDP");
+		operation::getInstance()->ManualOpenBarrier(true);
+	});
+
+	pmsCommands_.FnRegister(CmdCloseBarrier, [](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		operation::getInstance()->writelog("Close barrier from PMS","UDP");
+
+		operation::getInstance()->ManualCloseBarrier();
+		if (db::getInstance()->writeparameter2local("LockBarrier", "0") == 0)
+		{
+			// Update it when update/insert the parameter successfully
+			operation::getInstance()->writelog("Update the parameter 'LockBarrier' successfully", "UDP");
+			operation::getInstance()->tParas.gbLockBarrier = false;
+		}
+		operation::getInstance()->SendMsg2Server("99", "Close Barrier");
+	});
+
+	pmsCommands_.FnRegister(CmdContinueOpenBarrier, [](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		operation::getInstance()->writelog("Continue open barrier from PMS","UDP");
+
+		operation::getInstance()->continueOpenBarrier();
+		if (db::getInstance()->writeparameter2local("LockBarrier", "1") == 0)
+		{
+			// Update it when update/insert the parameter successfully
+			operation::getInstance()->writelog("Update the parameter 'LockBarrier' successfully", "UDP");
+			operation::getInstance()->tParas.gbLockBarrier = true;
+		}
+		operation::getInstance()->SendMsg2Server("99", "Continue Open Barrier");
+	});
+
+	pmsCommands_.FnRegister(CmdSetTime, [](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		operation::getInstance()->FnSyncCentralDBTime();
+	});
+
+	pmsCommands_.FnRegister(CmdCarparkfull, [](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		bool bCarparkFull = static_cast<bool>(frame.FnGetInt(UdpFrame::DATA_FIELD));
+		if (bCarparkFull != operation::getInstance()->tProcess.gbcarparkfull.load()) {
+			operation::getInstance()->tProcess.gbcarparkfull.store(bCarparkFull);
+			if (bCarparkFull == false) {
+				string sIUNo = operation:: getInstance()->tEntry.sIUTKNo;
+				if (operation::getInstance()->tProcess.gbLoopApresent.load() == true and sIUNo != "" )
 				{
-					if (operation::getInstance()->gtStation.iType == tientry)
-					{
-						operation::getInstance()->tProcess.setIdleMsg(0, operation::getInstance()->tMsg.Msg_DefaultLED[0]);
-						operation::getInstance()->tProcess.setIdleMsg(1, operation::getInstance()->tMsg.Msg_Idle[1]);
-					}
-					else
-					{
-						operation::getInstance()->tProcess.setIdleMsg(0, operation::getInstance()->tExitMsg.MsgExit_XDefaultLED[0]);
-						operation::getInstance()->tProcess.setIdleMsg(1, operation::getInstance()->tExitMsg.MsgExit_XIdle[1]);
-					}
+					operation::getInstance()->PBSEntry(sIUNo);
 				}
-				break;
-			}
-			case CmdFeeTest:
-			{
-				operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
-				operation::getInstance()->writelog("Fee test command","UDP");
-				std::vector<std::string> tmpStr;
-				boost::algorithm::split(tmpStr, pField.Field(3), boost::algorithm::is_any_of(","));
-				float parkingfee; 
-				parkingfee = operation::getInstance()->m_db->CalFeeRAM2G(tmpStr[0],tmpStr[1],std::stoi(tmpStr[2]));
-				if (parkingfee >= 0)
+
+				if (operation::getInstance()->gtStation.iType == tientry)
 				{
-					sData = pField.Field(3);
-					sData = sData + "," + Common::getInstance()->SetFeeFormat(parkingfee) + ", Fee OK";
-					operation::getInstance()->SendMsg2Server("302", sData);
+					operation::getInstance()->tProcess.setIdleMsg(0, operation::getInstance()->tMsg.Msg_DefaultLED[0]);
+					operation::getInstance()->tProcess.setIdleMsg(1, operation::getInstance()->tMsg.Msg_Idle[1]);
 				}
-				
-				break;
-
-			}
-			case CmdDownloadXTariff:
-			{
-				operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
-				int ret;
-				operation::getInstance()->writelog("download XTariff","UDP");
-				ret = operation::getInstance()->m_db->downloadxtariff(operation::getInstance()->tParas.giGroupID,operation::getInstance()->tParas.giSite, 0);
-				if (ret > 0)
+				else
 				{
-					std::stringstream ss;
-					ss << "Download " << ret << " XTariff";
-					operation::getInstance()->SendMsg2Server("99", ss.str());
-					operation::getInstance()->m_db->LoadXTariff();
-					//int iAutoDebit;
-					//float sAmt;
-					//operation::getInstance()->m_db->GetXTariff(iAutoDebit, sAmt, 0);
-					//operation::getInstance()->writelog("Autocharge:"+std::to_string(iAutoDebit), "UDP");
-					//operation::getInstance()->writelog("ChargeAmt:"+std::to_string(sAmt), "UDP");
+					operation::getInstance()->tProcess.setIdleMsg(0, operation::getInstance()->tExitMsg.MsgExit_XDefaultLED[0]);
+					operation::getInstance()->tProcess.setIdleMsg(1, operation::getInstance()->tExitMsg.MsgExit_XIdle[1]);
 				}
-				break;
 			}
-			case CmdDownloadTariff:
+			else
 			{
-				operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
-				int ret;
-				operation::getInstance()->writelog("download Tariff Type Info","UDP");
-				ret = operation::getInstance()->m_db->downloadtarifftypeinfo();
-				if (ret > 0)
-				{
-					std::stringstream ss;
-					ss << "Download " << ret << " Tariff type info";
-					operation::getInstance()->m_db->LoadTariffTypeInfo();
-				}
-				//---------
-				operation::getInstance()->writelog("download Tariff","UDP");
-				ret = operation::getInstance()->m_db->downloadtariffsetup(operation::getInstance()->tParas.giGroupID,operation::getInstance()->tParas.giSite, 0);
-				if (ret > 0)
-				{
-					std::stringstream ss;
-					ss << "Download " << ret << " Tariff";
-					operation::getInstance()->SendMsg2Server("99", ss.str());
-					operation::getInstance()->m_db->LoadTariff();
-				}
-				break;
+				operation::getInstance()->tProcess.setIdleMsg(0, operation::getInstance()->tMsg.Msg_CarParkFull2LED[0]);
+				operation::getInstance()->tProcess.setIdleMsg(1, operation::getInstance()->tMsg.Msg_CarParkFull2LED[1]);
 			}
-			case CmdDownloadHoliday:
+		}
+	});
+
+	pmsCommands_.FnRegister(CmdClearSeason, [this](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		operation::getInstance()->writelog("Clear Local season.","UDP");
+		submitJob("ClearSeason", UdpJobExecutor::JobScope::Controller, replyToPms, []()
+		{
+			operation::getInstance()->m_db->clearseason();
+			return UdpJobExecutor::JobResult{ true, "" };
+		});
+	});
+
+	pmsCommands_.FnRegister(CmdUpdateSetting, [this](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		operation::getInstance()->writelog("download station set up","UDP");
+		submitJob("DownloadStationSetup", UdpJobExecutor::JobScope::Controller, replyToPms, []()
+		{
+			int ret = operation::getInstance()->m_db->downloadstationsetup();
+			reloadEachLane<ConfigRows>([](ConfigRows& rows) { operation::getInstance()->m_db->FetchStationSetupRows(rows); },
+				[](ConfigRows& rows) { operation::getInstance()->m_db->ApplyStationSetupRows(rows); });
+			return downloadResult(ret, "Station Setup");
+		});
+	});
+
+	pmsCommands_.FnRegister(CmdDownloadTR, [this](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:" + std::string(frame.FnGetRaw()), "UDP");
+		operation::getInstance()->writelog("download TR", "UDP");
+		submitJob("DownloadTR", UdpJobExecutor::JobScope::Controller, replyToPms, []()
+		{
+			int ret = operation::getInstance()->m_db->downloadTR();
+			reloadEachLane<ConfigRows>([](ConfigRows& rows) { operation::getInstance()->m_db->FetchTRRows(rows); },
+				[](ConfigRows& rows) { operation::getInstance()->m_db->ApplyTRRows(rows); });
+			return downloadResult(ret, "TR");
+		});
+	});
+
+	pmsCommands_.FnRegister(CmdTimeForNoEntry, [](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:" + std::string(frame.FnGetRaw()), "UDP");
+
+		if (operation::getInstance()->tProcess.gbLoopApresent.load() == true) {
+			// IU, entry time
+			std::vector<std::string_view> tmpStr = frame.FnSplit(UdpFrame::DATA_FIELD, ',');
+			if (tmpStr.size() < 2)
+			{
+				operation::getInstance()->writelog("No entry time in the data.", "UDP");
+				return;
+			}
+			//--------
+			operation::getInstance()->tExit.sEntryTime = std::string(tmpStr[1]);
+			operation::getInstance()->writelog("Received Entry time: " + operation::getInstance()->tExit.sEntryTime + " from PMS.", "UDP");
+			operation::getInstance()->tExit.bNoEntryRecord = 0;
+			operation::getInstance()->ReceivedEntryRecord();
+
+		}else {
+			operation::getInstance()->writelog("No Vehicle on the Loop.", "DB");
+
+		}
+	});
+
+	// Lot counts are kept by the PMS, nothing to do
+	pmsCommands_.FnRegister(CmdSetLotCount, [](const UdpFrame&)
+	{
+	});
+
+	pmsCommands_.FnRegister(CmdAvailableLots, [](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		operation::getInstance()->ShowTotalLots(frame.FnGetText(UdpFrame::DATA_FIELD));
+	});
+
+	// Pin number, pin value, optional pulse / blink period in ms, optional blink count
+	pmsCommands_.FnRegister(CmdSetDioOutput, [](const UdpFrame& frame)
+	{
+		operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+		int pinNum = frame.FnGetInt(3);
+		int pinValue = frame.FnGetInt(4);
+		int durationMs = frame.FnGetInt(5, 0);
+		int blinkCount = frame.FnGetInt(6, 0);
+		int actualDIOPinNum = DIO::getInstance()->FnGetOutputPinNum(pinNum);
+
+		if ((actualDIOPinNum != 0) && (pinValue == 0 || pinValue == 1))
+		{
+			if (GPIOManager::getInstance()->FnGetGPIO(actualDIOPinNum) != nullptr)
 			{
-				operation::getInstance()->writelog("Received data:"+ std::string(data,length), "UDP");
-				operation::getInstance()->writelog("download Holiday", "UDP");
-				int ret = operation:: getInstance()-> m_db->downloadholidaymst(1);
-				if (ret > 0)
+				if ((durationMs > 0) && (blinkCount > 0))
 				{
-					std::stringstream ss;
-					ss << "Download " << ret << " Holiday";
-					operation::getInstance()->SendMsg2Server("99", ss.str());
+					DIOSequencer::getInstance()->FnBlink(actualDIOPinNum, durationMs, durationMs, blinkCount);
 				}
-				operation::getInstance()->m_db->LoadHoliday();
-				break;
-			}
-			case CmdUpdateParam:
-			{
-				operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
-				operation::getInstance()->writelog("download Parameter","UDP");
-				int ret = operation::getInstance()->m_db->downloadparameter();
-				if (ret > 0)
+				else if (durationMs > 0)
 				{
-					std::stringstream ss;
-					ss << "Download " << ret << " Parameter";
-					operation::getInstance()->SendMsg2Server("99", ss.str());
+					DIOSequencer::getInstance()->FnPulse(actualDIOPinNum, durationMs, pinValue);
 				}
-				operation::getInstance()->m_db->loadParam();
-				break;
-			}
-			case CmdDownloadtype:
-			{
-				operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
-				operation::getInstance()->writelog("download Vehicle Type","UDP");
-				int ret = operation::getInstance()->m_db->downloadvehicletype();
-				if (ret > 0)
+				else
 				{
-					std::stringstream ss;
-					ss << "Download " << ret << " Vehicle Type";
-					operation::getInstance()->SendMsg2Server("99", ss.str());
+					DIOSequencer::getInstance()->FnSet(actualDIOPinNum, pinValue);
 				}
-				operation::getInstance()->m_db->loadvehicletype();
-				break;
 			}
-			case CmdOpenBarrier:
+			else
 			{
-				operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
-				operation::getInstance()->writelog("open barrier from PMS","UDP");
-				operation::getInstance()->ManualOpenBarrier(true);
-				break;
+				operation::getInstance()->writelog("Nullptr, Invalid DIO", "UDP");
 			}
-			case CmdCloseBarrier:
-			{
-				operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
-				operation::getInstance()->writelog("Close barrier from PMS","UDP");
+		}
+		else
+		{
+			operation::getInstance()->writelog("Invalid DIO", "UDP");
+		}
+	}, 5);
 
-				operation::getInstance()->ManualCloseBarrier();
-				if (db::getInstance()->writeparameter2local("LockBarrier", "0") == 0)
-				{
-					// Update it when update/insert the parameter successfully
-					operation::getInstance()->writelog("Update the parameter 'LockBarrier' successfully", "UDP");
-					operation::getInstance()->tParas.gbLockBarrier = false;
-				}
-				operation::getInstance()->SendMsg2Server("99", "Close Barrier");
-				break;
-			}
-			case CmdContinueOpenBarrier:
-			{
-				operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
-				operation::getInstance()->writelog("Continue open barrier from PMS","UDP");
+	pmsCommands_.FnRegister(CmdBroadcastSaveTrans, [](const UdpFrame& frame)
+	{
+		std::string_view sData = frame.FnGetField(UdpFrame::DATA_FIELD);
+		if (sData.find("Entry OK") != std::string_view::npos) {
+			operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+			string stnid = "," + frame.FnGetText(UdpFrame::STATION_FIELD) + ",";
+			string gsZoneEntries = operation::getInstance()->tParas.gsZoneEntries;
+			if (gsZoneEntries.find(stnid) != std::string::npos)
+			{
+				std::vector<std::string_view> tmpStr = frame.FnSplit(UdpFrame::DATA_FIELD, ',');
+				db::getInstance()->insertbroadcasttrans(frame.FnGetText(UdpFrame::STATION_FIELD), std::string(tmpStr[0]));
+			}
+		}else{
+			if (sData.find("Exit OK") != std::string_view::npos) {
+				operation::getInstance()->writelog("Received data:"+std::string(frame.FnGetRaw()), "UDP");
+				std::vector<std::string_view> tmpStr = frame.FnSplit(UdpFrame::DATA_FIELD, ',');
+				db::getInstance()->UpdateLocalEntry(std::string(tmpStr[0]));
 
-				operation::getInstance()->continueOpenBarrier();
-				if (db::getInstance()->writeparameter2local("LockBarrier", "1") == 0)
+				// A peer's paid exit, it carries no exit time or trans type so it is kept as paid now, of any type
+				float paidAmt = (tmpStr.size() > 3) ? std::strtof(std::string(tmpStr[2]).c_str(), nullptr) : 0;
+				if ((paidAmt > 0) && (frame.FnGetText(UdpFrame::STATION_FIELD) != std::to_string(operation::getInstance()->gtStation.iSID)))
 				{
-					// Update it when update/insert the parameter successfully
-					operation::getInstance()->writelog("Update the parameter 'LockBarrier' successfully", "UDP");
-					operation::getInstance()->tParas.gbLockBarrier = true;
-				}
-				operation::getInstance()->SendMsg2Server("99", "Continue Open Barrier");
-				break;
-			}
-			case CmdSetTime:
-			{
-				operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
-				operation::getInstance()->FnSyncCentralDBTime();
-				break;
-			}
-			case CmdCarparkfull:
-			{
-				operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
-				i=stoi(pField.Field(3));
-				bool bCarparkFull = static_cast<bool>(i);
-				if (bCarparkFull != operation::getInstance()->tProcess.gbcarparkfull.load()) {
-					operation::getInstance()->tProcess.gbcarparkfull.store(bCarparkFull);
-					if (bCarparkFull == false) {
-						string sIUNo = operation:: getInstance()->tEntry.sIUTKNo; 
-						if (operation::getInstance()->tProcess.gbLoopApresent.load() == true and sIUNo != "" )
-						{
-							operation::getInstance()->PBSEntry(sIUNo);
-						}
-
-						if (operation::getInstance()->gtStation.iType == tientry)
-						{
-							operation::getInstance()->tProcess.setIdleMsg(0, operation::getInstance()->tMsg.Msg_DefaultLED[0]);
-							operation::getInstance()->tProcess.setIdleMsg(1, operation::getInstance()->tMsg.Msg_Idle[1]);
-						}
-						else
-						{
-							operation::getInstance()->tProcess.setIdleMsg(0, operation::getInstance()->tExitMsg.MsgExit_XDefaultLED[0]);
-							operation::getInstance()->tProcess.setIdleMsg(1, operation::getInstance()->tExitMsg.MsgExit_XIdle[1]);
-						}
-					}
-					else
+					PaidExitCache::PaidExit paidExit{Common::getInstance()->FnGetDateTimeFormat_yyyy_mm_dd_hh_mm_ss(), paidAmt, -1};
+					for (std::size_t i : {0, 1, 3})
 					{
-						operation::getInstance()->tProcess.setIdleMsg(0, operation::getInstance()->tMsg.Msg_CarParkFull2LED[0]);
-						operation::getInstance()->tProcess.setIdleMsg(1, operation::getInstance()->tMsg.Msg_CarParkFull2LED[1]);
+						PaidExitCache::getInstance()->FnRecord(std::string(tmpStr[i]), paidExit);
 					}
 				}
-				break;
 			}
-			case CmdClearSeason:
-			{
-				operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
-				operation::getInstance()->writelog("Clear Local season.","UDP");
-				operation::getInstance()->m_db->clearseason();
-				break;
-			}
-			case CmdUpdateSetting:
-			{
-				operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
-				operation::getInstance()->writelog("download station set up","UDP");
-				int ret = operation::getInstance()->m_db->downloadstationsetup();
-				if (ret > 0)
-				{
-					std::stringstream ss;
-					ss << "Download " << ret << " Station Setup";
-					operation::getInstance()->SendMsg2Server("99", ss.str());
-				}
-				operation::getInstance()->m_db->loadstationsetup();
-				break;
-			}
-			case CmdDownloadTR:
-			{
-				operation::getInstance()->writelog("Received data:" + std::string(data, length), "UDP");
-				operation::getInstance()->writelog("download TR", "UDP");
-				int ret = operation::getInstance()->m_db->downloadTR();
-				if (ret > 0)
-				{
-					std::stringstream ss;
-					ss << "Download " << ret << " TR";
-					operation::getInstance()->SendMsg2Server("99", ss.str());
-				}
-				operation::getInstance()->m_db->loadTR();
-				break;
-			}
-			case CmdTimeForNoEntry:
-			{
-				operation::getInstance()->writelog("Received data:" + std::string(data, length), "UDP");
-				
-				if (operation::getInstance()->tProcess.gbLoopApresent.load() == true) {
-					std::vector<std::string> tmpStr;
-					boost::algorithm::split(tmpStr, pField.Field(3), boost::algorithm::is_any_of(","));
-					//--------
-					operation::getInstance()->tExit.sEntryTime = tmpStr[1];
-					operation::getInstance()->writelog("Received Entry time: " + operation::getInstance()->tExit.sEntryTime + " from PMS.", "UDP");
-					operation::getInstance()->tExit.bNoEntryRecord = 0;
-					operation::getInstance()->ReceivedEntryRecord();
-
-				}else {
-					operation::getInstance()->writelog("No Vehicle on the Loop.", "DB");
+		}
+	});
+}
 
-				}
-				break;
-			}
-			case CmdSetLotCount:
-				break;
-			case CmdAvailableLots:
+int udpclient::findStationLane(std::string_view station)
+{
+	int stationID = 0;
+	if (UdpFrame::FnParseInt(station, stationID))
+	{
+		for (int laneId = 0; laneId < LaneContext::FnGetLaneCount(); laneId++)
+		{
+			LaneContext::Scope laneScope(laneId, false);
+			if (operation::getInstance()->gtStation.iSID == stationID)
 			{
-				operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
-				sData = pField.Field(3);
-				operation::getInstance()->ShowTotalLots(sData);
-				break;
+				return laneId;
 			}
-			case CmdSetDioOutput:
-			{
-				operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
-				int pinNum = std::stoi(pField.Field(3));
-				int pinValue = std::stoi(pField.Field(4));
-				int actualDIOPinNum = DIO::getInstance()->FnGetOutputPinNum(pinNum);
+		}
+	}
 
-				if ((actualDIOPinNum != 0) && (pinValue == 0 || pinValue == 1))
-				{
-					if (GPIOManager::getInstance()->FnGetGPIO(actualDIOPinNum) != nullptr)
-					{
-						GPIOManager::getInstance()->FnGetGPIO(actualDIOPinNum)->FnSetValue(pinValue);
-					}
-					else
-					{
-						operation::getInstance()->writelog("Nullptr, Invalid DIO", "UDP");
-					}
-				}
-				else
-				{
-					operation::getInstance()->writelog("Invalid DIO", "UDP");
-				}
-				break;
-			}
-			case CmdBroadcastSaveTrans:
+	// Not one of ours, e.g. a broadcast, the receiving lane handles it
+	return LaneContext::FnGetCurrentLane();
+}
+
+void udpclient::dispatch(const UdpCommandRegistry& commands, const char* data, std::size_t length, bool isRoutedByStation)
+{
+	try
+	{
+		UdpFrame frame;
+		UdpFrame::Status status = frame.FnParse(std::string_view(data, length));
+
+		if (status != UdpFrame::Status::Ok)
+		{
+			// Malformed frames are dropped as before, only a failed checksum (a damaged datagram) is logged
+			if (status == UdpFrame::Status::BadChecksum)
 			{
-				if (pField.Field(3).find("Entry OK") != std::string::npos) {
-					operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
-					string stnid = "," + pField.Field(1) + ",";
-					string gsZoneEntries = operation::getInstance()->tParas.gsZoneEntries;
-					if (gsZoneEntries.find(stnid) != std::string::npos)
-					{
-						std::vector<std::string> tmpStr;
-						boost::algorithm::split(tmpStr, pField.Field(3), boost::algorithm::is_any_of(","));
-						db::getInstance()->insertbroadcasttrans (pField.Field(1), tmpStr[0]);
-					}
-				}else{
-					if (pField.Field(3).find("Exit OK") != std::string::npos) {
-						operation::getInstance()->writelog("Received data:"+std::string(data,length), "UDP");
-						std::vector<std::string> tmpStr;
-						boost::algorithm::split(tmpStr, pField.Field(3), boost::algorithm::is_any_of(","));
-						db::getInstance()->UpdateLocalEntry(tmpStr[0]);
-					}
-				}
-				break;
+				operation::getInstance()->writelog("URX: " + std::string(UdpFrame::FnGetStatusText(status)) + ", dropped data:" + std::string(data, length), "UDP");
 			}
-			default:
-				break;
+			return;
+		}
+
+		int laneId = isRoutedByStation ? findStationLane(frame.FnGetField(UdpFrame::STATION_FIELD)) : LaneContext::FnGetCurrentLane();
+		LaneContext::Scope laneScope(laneId);
+
+		if (commands.FnDispatch(frame) == UdpCommandRegistry::DispatchResult::MissingFields)
+		{
+			operation::getInstance()->writelog("URX: invalid number of arguments, data:" + std::string(data, length), "UDP");
 		}
 	}
 	catch (const std::exception& e)
-    {
-        std::stringstream ss;
-        ss << __func__ << ", Exception: " << e.what();
-        Logger::getInstance()->FnLogExceptionError(ss.str());
-    }
-    catch (...)
-    {
-        std::stringstream ss;
-        ss << __func__ << ", Exception: Unknown Exception";
-        Logger::getInstance()->FnLogExceptionError(ss.str());
-    }
+	{
+		std::stringstream ss;
+		ss << __func__ << ", Exception: " << e.what();
+		Logger::getInstance()->FnLogExceptionError(ss.str());
+	}
+	catch (...)
+	{
+		std::stringstream ss;
+		ss << __func__ << ", Exception: Unknown Exception";
+		Logger::getInstance()->FnLogExceptionError(ss.str());
+	}
+}
 
+void udpclient::processmonitordata(const char* data, std::size_t length)
+{
+	// Every lane shares the first lane's monitor socket
+	dispatch(monitorCommands_, data, length, true);
+}
+
+void udpclient::processdata(const char* data, std::size_t length)
+{
+	dispatch(pmsCommands_, data, length);
 }
 
 
@@ -603,9 +733,98 @@ bool udpclient::FnGetMonitorStatus()
 	return monitorStatus_;
 }
 
+void udpclient::send(const std::string& message, UdpSendClass sendClass)
+{
+	UdpSendQueue::PushResult result = sendQueue_.FnPush(message, sendClass);
+
+	if (result == UdpSendQueue::PushResult::Oversize)
+	{
+		sendOversize(message);
+		return;
+	}
+
+	if (result == UdpSendQueue::PushResult::Dropped)
+	{
+		return;
+	}
+
+	// The push happened before the lock, so a sender that just found the queue empty cannot strand it
+	std::lock_guard<std::mutex> lock(sendMutex_);
+	if (!isSending_)
+	{
+		isSending_ = true;
+		boost::asio::post(strand_, [this]() { sendNext(); });
+	}
+}
+
+void udpclient::sendNext()
+{
+	UdpSendQueue::Slot* slot;
+	{
+		std::lock_guard<std::mutex> lock(sendMutex_);
+		slot = sendQueue_.FnPopNext();
+		if (slot == nullptr)
+		{
+			isSending_ = false;
+			return;
+		}
+	}
+
+	// One datagram in flight at a time, the slot stays out of the pool until it has gone
+	socket_.async_send_to(buffer(slot->data.data(), slot->length), serverEndpoint_, boost::asio::bind_executor(strand_, [this, slot](const boost::system::error_code& error, std::size_t /*bytes_sent*/)
+	{
+		if (error)
+		{
+			std::stringstream dbss;
+			dbss << "Error for sending message: " << error.message() ;
+			Logger::getInstance()->FnLog(dbss.str(), "", "UDP");
+		}
+
+		sendQueue_.FnRelease(slot, !error);
+		sendNext();
+	}));
+}
+
+void udpclient::sendOversize(const std::string& message)
+{
+	// Larger than a pooled buffer, sent from its own copy outside the queue
+	sendQueue_.FnCountOversize();
+	auto data = std::make_shared<std::string>(message);
+
+	boost::asio::post(strand_, [this, data]()
+	{
+		socket_.async_send_to(buffer(*data), serverEndpoint_, boost::asio::bind_executor(strand_, [data](const boost::system::error_code& error, std::size_t /*bytes_sent*/)
+		{
+			if (error)
+			{
+				std::stringstream dbss;
+				dbss << "Error for sending message: " << error.message() ;
+				Logger::getInstance()->FnLog(dbss.str(), "", "UDP");
+			}
+		}));
+	});
+}
+
+void udpclient::FnLogSendStats(const std::string& name)
+{
+	UdpSendQueue::Stats stats = sendQueue_.FnGetStats();
+
+	std::stringstream ss;
+	ss << "UDP " << name << " send queue => depth: " << stats.depth << ", max depth: " << stats.maxDepth;
+	for (size_t i = 0; i < UdpSendQueue::CLASS_COUNT; i++)
+	{
+		const UdpSendQueue::ClassStats& classStats = stats.classes[i];
+		ss << ", " << UdpSendQueue::FnGetClassName(static_cast<UdpSendClass>(i));
+		ss << " queued/coalesced/dropped/sent/failed: " << classStats.queued << "/" << classStats.coalesced << "/" << classStats.dropped;
+		ss << "/" << classStats.sent << "/" << classStats.failed;
+	}
+	ss << ", oversize: " << stats.oversize;
+	Logger::getInstance()->FnLog(ss.str(), "", "UDP");
+}
+
 void udpclient::startreceive()
 {
-    socket_.async_receive_from(buffer(data_, max_length), senderEndpoint_, boost::asio::bind_executor(strand_, [this](const boost::system::error_code& error, std::size_t bytes_received)
+    socket_.async_receive_from(buffer(data_, max_length), senderEndpoint_, boost::asio::bind_executor(strand_, LaneContext::FnBind(laneId_, [this](const boost::system::error_code& error, std::size_t bytes_received)
     {
         if (!error)
         {
@@ -615,7 +834,7 @@ void udpclient::startreceive()
 		//	operation::getInstance()->writelog("Local IP:"+ operation:: getInstance()->tParas.gsLocalIP, "UDP");  
 				         
             if (sender_ip != operation:: getInstance()->tParas.gsLocalIP) {
-                if (socket_.local_endpoint().port() == static_cast<unsigned short>(std::stoi(IniParser::getInstance()->FnGetLocalUDPPort())))
+                if (socket_.local_endpoint().port() == static_cast<unsigned short>(IniParser::getInstance()->FnGetLocalUDPPort()))
                 {
                     processdata(data_, bytes_received);
                 }
@@ -633,7 +852,7 @@ void udpclient::startreceive()
         }
 
         startreceive();  // Continue with the next receive operation
-    }));
+    })));
 }
 
 	
\ No newline at end of file
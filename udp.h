@@ -3,8 +3,13 @@
 #include <iostream>
 #include <cstdlib>
 #include <ctime>
+#include <mutex>
 #include "boost/asio.hpp"
 #include <boost/algorithm/string.hpp>
+#include "lane_context.h"
+#include "udp_frame.h"
+#include "udp_jobs.h"
+#include "udp_send_queue.h"
 #include "log.h"
 
 using namespace boost::asio;
@@ -49,7 +54,10 @@ typedef enum : unsigned int
     CmdMonitorSyncTime          = 311,
     CmdMonitorStatus            = 312,
     CmdMonitorStationVersion    = 313,
-    CmdMonitorGetStationCurrLog = 314
+    CmdMonitorGetStationCurrLog = 314,
+    CmdMonitorBootTimeline      = 315,
+    CmdMonitorStatusResync      = 318,
+    CmdMonitorDIOSequencer      = 321
 } monitorudp_rx_command;
 
 class udpclient 
@@ -64,7 +72,9 @@ public:
         : strand_(boost::asio::make_strand(ioContext)),
           monitorStatus_(false),
           isBroadcast_(broadcast),
-          socket_(strand_, udp::endpoint(udp::v4(), LocalPort)), serverEndpoint_(ip::address::from_string(serverAddress), serverPort)
+          laneId_(LaneContext::FnGetCurrentLane()),
+          socket_(strand_, udp::endpoint(udp::v4(), LocalPort)), serverEndpoint_(ip::address::from_string(serverAddress), serverPort),
+          isSending_(false)
     {
         if (isBroadcast_)
         {
@@ -79,40 +89,42 @@ public:
             }
         }
 
+        registerPmsCommands();
+        registerMonitorCommands();
         startreceive();
     }
 
-    void send(const std::string& message)
-    {
-        startsend(message);
-    }
+    // Queues the message for the peer and returns, safe to call from any thread
+    void send(const std::string& message, UdpSendClass sendClass = UdpSendClass::Event);
+    void FnLogSendStats(const std::string& name);
 
  private:
     bool monitorStatus_;
     bool isBroadcast_;
+    int laneId_;    // Lane that owns the socket, received commands are handled in it
     boost::asio::strand<boost::asio::io_context::executor_type> strand_;
     udp::socket socket_;
     udp::endpoint serverEndpoint_;
     udp::endpoint senderEndpoint_;
     enum { max_length = 1024 };
     char data_[max_length];
+    UdpCommandRegistry pmsCommands_;
+    UdpCommandRegistry monitorCommands_;
+    void registerPmsCommands();
+    void registerMonitorCommands();
+    using JobReply = void (*)(const std::string& text);
+    using JobFinished = std::function<void(uint64_t jobId, const UdpJobExecutor::JobResult& result)>;
+    // Acknowledges a long command with its job id now and reports the result when the job pool has run it
+    void submitJob(const std::string& key, UdpJobExecutor::JobScope scope, JobReply reply, UdpJobExecutor::JobFunction job, JobFinished finished = nullptr);
+    // isRoutedByStation runs the handler in the lane whose station the frame names, for the shared monitor socket
+    void dispatch(const UdpCommandRegistry& commands, const char* data, std::size_t length, bool isRoutedByStation = false);
+    static int findStationLane(std::string_view station);
     void startreceive();
-    void startsend(const std::string& message)
-    {     
-        socket_.async_send_to(buffer(message), serverEndpoint_, boost::asio::bind_executor(strand_, [this](const boost::system::error_code& error, std::size_t /*bytes_sent*/)
-        {
-            if (!error)
-            {
-              //  std::cout << "Message sent successfully." << std::endl;
-            }
-            else
-            {
-                std::stringstream dbss;
-                dbss << "Error for sending message: " << error.message() ;
-                Logger::getInstance()->FnLog(dbss.str(), "", "UDP");
-            }
-        }));
-    }
+    UdpSendQueue sendQueue_;
+    std::mutex sendMutex_;
+    bool isSending_;    // a send is in flight on the strand, guarded by sendMutex_
+    void sendNext();
+    void sendOversize(const std::string& message);
 };
 
 
@@ -136,7 +148,8 @@ public:
 private:
     void sendHeartbeat()
     {
-        std::string message = "Heartbeat";
+        // Static, the buffer has to outlive the asynchronous send
+        static const std::string message = "Heartbeat";
         socket_.async_send_to(boost::asio::buffer(message), remoteEndpoint_,
             boost::asio::bind_executor(strand_, [&](const boost::system::error_code& error, std::size_t /*bytes_transferred*/)
             {
@@ -0,0 +1,255 @@
+#include <charconv>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include "udp_frame.h"
+
+namespace
+{
+    const char FRAME_START = '[';
+    const char FRAME_END = ']';
+    const char FIELD_SEPARATOR = '|';
+    const char CHECKSUM_MARK = '*';
+
+    int hexValue(char c)
+    {
+        if ((c >= '0') && (c <= '9'))
+        {
+            return c - '0';
+        }
+        if ((c >= 'A') && (c <= 'F'))
+        {
+            return c - 'A' + 10;
+        }
+        if ((c >= 'a') && (c <= 'f'))
+        {
+            return c - 'a' + 10;
+        }
+        return -1;
+    }
+
+    uint8_t xorChecksum(std::string_view text)
+    {
+        uint8_t sum = 0;
+        for (char c : text)
+        {
+            sum ^= static_cast<uint8_t>(c);
+        }
+        return sum;
+    }
+
+    bool isChecksumField(std::string_view field)
+    {
+        return (field.size() == 3) && (field[0] == CHECKSUM_MARK) && (hexValue(field[1]) >= 0) && (hexValue(field[2]) >= 0);
+    }
+}
+
+UdpFrame::UdpFrame()
+    : fieldCount_(0),
+    command_(0),
+    hasChecksum_(false)
+{
+}
+
+void UdpFrame::clear()
+{
+    fieldCount_ = 0;
+    command_ = 0;
+    hasChecksum_ = false;
+}
+
+UdpFrame::Status UdpFrame::FnParse(std::string_view datagram)
+{
+    clear();
+    raw_ = datagram;
+
+    size_t startPos = datagram.find(FRAME_START);
+    if (startPos == std::string_view::npos)
+    {
+        return Status::NoStartMarker;
+    }
+
+    size_t endPos = datagram.find(FRAME_END, startPos + 1);
+    if (endPos == std::string_view::npos)
+    {
+        return Status::NoEndMarker;
+    }
+
+    std::string_view body = datagram.substr(startPos + 1, endPos - startPos - 1);
+    size_t count = 0;
+
+    // "a|b|" is two fields, the text after the last separator only counts when there is some
+    while (!body.empty())
+    {
+        size_t separatorPos = body.find(FIELD_SEPARATOR);
+        std::string_view field = body.substr(0, separatorPos);
+
+        if (count == MAX_FIELDS)
+        {
+            return Status::TooManyFields;
+        }
+        fields_[count++] = field;
+
+        if (separatorPos == std::string_view::npos)
+        {
+            break;
+        }
+        body.remove_prefix(separatorPos + 1);
+    }
+
+    if ((count > MIN_FIELDS) && isChecksumField(fields_[count - 1]))
+    {
+        std::string_view checksumField = fields_[count - 1];
+        const char* bodyStart = datagram.data() + startPos + 1;
+        std::string_view covered(bodyStart, static_cast<size_t>(checksumField.data() - bodyStart));
+        int expected = (hexValue(checksumField[1]) << 4) | hexValue(checksumField[2]);
+
+        if (xorChecksum(covered) != expected)
+        {
+            return Status::BadChecksum;
+        }
+        hasChecksum_ = true;
+        count--;
+    }
+
+    if (count < MIN_FIELDS)
+    {
+        return Status::TooFewFields;
+    }
+
+    int command;
+    if (!FnParseInt(fields_[COMMAND_FIELD], command) || (command < 0))
+    {
+        return Status::BadCommand;
+    }
+
+    command_ = static_cast<unsigned int>(command);
+    fieldCount_ = count;
+    return Status::Ok;
+}
+
+const char* UdpFrame::FnGetStatusText(Status status)
+{
+    switch (status)
+    {
+        case Status::Ok:
+            return "ok";
+        case Status::NoStartMarker:
+            return "no start marker";
+        case Status::NoEndMarker:
+            return "no end marker";
+        case Status::TooFewFields:
+            return "too few fields";
+        case Status::TooManyFields:
+            return "too many fields";
+        case Status::BadCommand:
+            return "command is not a number";
+        case Status::BadChecksum:
+            return "checksum mismatch";
+    }
+    return "unknown";
+}
+
+std::string_view UdpFrame::FnGetRaw() const
+{
+    return raw_;
+}
+
+unsigned int UdpFrame::FnGetCommand() const
+{
+    return command_;
+}
+
+size_t UdpFrame::FnGetFieldCount() const
+{
+    return fieldCount_;
+}
+
+bool UdpFrame::FnHasChecksum() const
+{
+    return hasChecksum_;
+}
+
+std::string_view UdpFrame::FnGetField(size_t index) const
+{
+    return (index < fieldCount_) ? fields_[index] : std::string_view();
+}
+
+std::string UdpFrame::FnGetText(size_t index) const
+{
+    return std::string(FnGetField(index));
+}
+
+bool UdpFrame::FnParseInt(std::string_view text, int& result)
+{
+    // std::stoi took a leading '+', the senders never send one but keep accepting it
+    if (!text.empty() && (text[0] == '+'))
+    {
+        text.remove_prefix(1);
+    }
+
+    if (text.empty())
+    {
+        return false;
+    }
+
+    auto parsed = std::from_chars(text.data(), text.data() + text.size(), result);
+    return (parsed.ec == std::errc()) && (parsed.ptr == text.data() + text.size());
+}
+
+int UdpFrame::FnGetInt(size_t index) const
+{
+    int result;
+    if (!FnParseInt(FnGetField(index), result))
+    {
+        throw std::invalid_argument("field " + std::to_string(index) + " is not a number : '" + FnGetText(index) + "'");
+    }
+    return result;
+}
+
+int UdpFrame::FnGetInt(size_t index, int defaultValue) const
+{
+    return FnGetField(index).empty() ? defaultValue : FnGetInt(index);
+}
+
+std::vector<std::string_view> UdpFrame::FnSplit(size_t index, char separator) const
+{
+    std::vector<std::string_view> tokens;
+    std::string_view field = FnGetField(index);
+
+    // Same as boost::algorithm::split, n separators always give n + 1 tokens
+    while (true)
+    {
+        size_t separatorPos = field.find(separator);
+        tokens.push_back(field.substr(0, separatorPos));
+        if (separatorPos == std::string_view::npos)
+        {
+            break;
+        }
+        field.remove_prefix(separatorPos + 1);
+    }
+
+    return tokens;
+}
+
+void UdpCommandRegistry::FnRegister(unsigned int command, Handler handler, size_t requiredFields)
+{
+    handlers_[command] = { requiredFields, std::move(handler) };
+}
+
+UdpCommandRegistry::DispatchResult UdpCommandRegistry::FnDispatch(const UdpFrame& frame) const
+{
+    auto it = handlers_.find(frame.FnGetCommand());
+    if (it == handlers_.end())
+    {
+        return DispatchResult::UnknownCommand;
+    }
+
+    if (frame.FnGetFieldCount() < it->second.requiredFields)
+    {
+        return DispatchResult::MissingFields;
+    }
+
+    it->second.handler(frame);
+    return DispatchResult::Handled;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// One PMS / monitor datagram, "[pcname|sid|command|data|...|]", split in place: every field is a view into the
+// receive buffer, so the buffer has to outlive the frame. A frame may end with a "*HH" field, HH being the XOR of
+// every byte from after '[' up to the '*' in hex; when present it is checked and not counted as a field.
+// Kept free of the logger so the parser can be linked alone.
+class UdpFrame
+{
+public:
+    enum class Status
+    {
+        Ok,
+        NoStartMarker,
+        NoEndMarker,
+        TooFewFields,
+        TooManyFields,
+        BadCommand,
+        BadChecksum
+    };
+
+    static const size_t MIN_FIELDS = 4;
+    static const size_t MAX_FIELDS = 16;
+    static const size_t SENDER_FIELD = 0;
+    static const size_t STATION_FIELD = 1;
+    static const size_t COMMAND_FIELD = 2;
+    static const size_t DATA_FIELD = 3;
+
+    UdpFrame();
+
+    // Nothing is copied, a frame that is not Ok has no fields
+    Status FnParse(std::string_view datagram);
+    static const char* FnGetStatusText(Status status);
+
+    std::string_view FnGetRaw() const;
+    unsigned int FnGetCommand() const;
+    size_t FnGetFieldCount() const;
+    bool FnHasChecksum() const;
+
+    // A field past the end is empty, as ParseData returned it
+    std::string_view FnGetField(size_t index) const;
+    std::string FnGetText(size_t index) const;
+
+    // The whole field has to be a number, throws std::invalid_argument otherwise
+    int FnGetInt(size_t index) const;
+    // Missing or empty fields give defaultValue, anything else has to be a number
+    int FnGetInt(size_t index, int defaultValue) const;
+    static bool FnParseInt(std::string_view text, int& result);
+
+    // Sub fields of a field, e.g. the ',' separated fee test data, as views into the same buffer
+    std::vector<std::string_view> FnSplit(size_t index, char separator) const;
+
+private:
+    std::string_view raw_;
+    std::array<std::string_view, MAX_FIELDS> fields_;
+    size_t fieldCount_;
+    unsigned int command_;
+    bool hasChecksum_;
+    void clear();
+};
+
+// Command id to handler for one UDP socket. Each command states the fields it needs, a shorter frame is
+// refused before the handler runs.
+class UdpCommandRegistry
+{
+public:
+    using Handler = std::function<void(const UdpFrame& frame)>;
+
+    enum class DispatchResult
+    {
+        Handled,
+        UnknownCommand,
+        MissingFields
+    };
+
+    void FnRegister(unsigned int command, Handler handler, size_t requiredFields = UdpFrame::MIN_FIELDS);
+    DispatchResult FnDispatch(const UdpFrame& frame) const;
+
+private:
+    struct Entry
+    {
+        size_t requiredFields;
+        Handler handler;
+    };
+
+    std::unordered_map<unsigned int, Entry> handlers_;
+};
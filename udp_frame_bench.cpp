@@ -0,0 +1,78 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "udp_frame.h"
+
+// Datagrams parsed and dispatched per second, over a mix of PMS and monitor commands:
+//   pbs_udp_frame_bench [seconds]
+
+namespace
+{
+    const std::vector<std::string> DATAGRAMS =
+    {
+        "[PMS01|1|300|2026-10-19 08:15:00|]",
+        "[PMS01|1|302|1|]",
+        "[PMS01|1|304|0,0,0,0,0,0,0,0,0,0|]",
+        "[PMS01|1|306|Entry Lane 1|Please Wait|]",
+        "[MONITOR|1|311|1111111111|2026-10-19 08:15:00|1|5.00|]",
+        "[MONITOR|1|316|2026-10-19 08:00:00,2026-10-19 08:15:00,1,2|]",
+        "[PMS01|1|309|1|0|2|*77|]",
+        "[PMS01|2|90|,,,,,Starting OK|]",
+    };
+}
+
+int main(int argc, char* argv[])
+{
+    int seconds = (argc > 1) ? std::atoi(argv[1]) : 5;
+    if (seconds <= 0)
+    {
+        std::cerr << "Usage: " << argv[0] << " [seconds]" << std::endl;
+        return 1;
+    }
+
+    UdpCommandRegistry registry;
+    uint64_t handled = 0;
+    for (unsigned int command : { 90U, 300U, 302U, 304U, 306U, 309U, 311U, 316U })
+    {
+        registry.FnRegister(command, [&handled](const UdpFrame& frame)
+        {
+            handled += frame.FnGetField(UdpFrame::DATA_FIELD).size();
+        });
+    }
+
+    UdpFrame frame;
+    uint64_t frames = 0;
+    uint64_t refused = 0;
+    auto startTime = std::chrono::steady_clock::now();
+    auto endTime = startTime + std::chrono::seconds(seconds);
+
+    // The clock is read once per pass over the mix, not once per datagram
+    while (std::chrono::steady_clock::now() < endTime)
+    {
+        for (int pass = 0; pass < 1000; pass++)
+        {
+            for (const auto& datagram : DATAGRAMS)
+            {
+                if (frame.FnParse(std::string_view(datagram)) == UdpFrame::Status::Ok)
+                {
+                    registry.FnDispatch(frame);
+                }
+                else
+                {
+                    refused++;
+                }
+                frames++;
+            }
+        }
+    }
+
+    double elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << frames << " datagrams in " << elapsedSeconds << " s, " << static_cast<uint64_t>(frames / elapsedSeconds) << " datagrams/s";
+    std::cout << ", refused " << refused << ", handler bytes " << handled << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,276 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "udp_frame.h"
+
+// Random and mutated datagrams through UdpFrame, checks every view stays inside the datagram and that
+// well formed frames come back as they were built:
+//   pbs_udp_frame_fuzz [iterations] [seed]
+// Each datagram is parsed from a buffer of exactly its size, build with -fsanitize=address,undefined to
+// have an over-read reported.
+
+namespace
+{
+    int failures = 0;
+
+    void fail(const std::string& what, std::string_view datagram)
+    {
+        if (failures++ < 20)
+        {
+            std::cerr << "FAIL " << what << " : '" << datagram << "'" << std::endl;
+        }
+    }
+
+    bool isInside(std::string_view view, std::string_view datagram)
+    {
+        return view.empty() || ((view.data() >= datagram.data()) && (view.data() + view.size() <= datagram.data() + datagram.size()));
+    }
+
+    std::string withChecksum(const std::string& body)
+    {
+        uint8_t sum = 0;
+        for (char c : body)
+        {
+            sum ^= static_cast<uint8_t>(c);
+        }
+        char checksum[4];
+        std::snprintf(checksum, sizeof(checksum), "*%02X", sum);
+        return "[" + body + checksum + "|]";
+    }
+
+    struct BuiltFrame
+    {
+        std::string datagram;
+        std::vector<std::string> fields;
+        bool hasChecksum;
+    };
+
+    BuiltFrame buildFrame(std::mt19937& random)
+    {
+        static const char fieldChars[] = "abcXYZ0123456789 ,.:-_";
+        std::uniform_int_distribution<int> fieldCount(static_cast<int>(UdpFrame::MIN_FIELDS), static_cast<int>(UdpFrame::MAX_FIELDS) - 1);
+        std::uniform_int_distribution<int> fieldLength(0, 12);
+        std::uniform_int_distribution<int> fieldChar(0, sizeof(fieldChars) - 2);
+
+        BuiltFrame frame;
+        frame.hasChecksum = (random() % 2) == 0;
+        int count = fieldCount(random);
+
+        std::string body;
+        for (int i = 0; i < count; i++)
+        {
+            std::string field;
+            if (i == static_cast<int>(UdpFrame::COMMAND_FIELD))
+            {
+                field = std::to_string(random() % 1000);
+            }
+            else
+            {
+                int length = fieldLength(random);
+                for (int c = 0; c < length; c++)
+                {
+                    field += fieldChars[fieldChar(random)];
+                }
+            }
+            frame.fields.push_back(field);
+            body += field + "|";
+        }
+
+        frame.datagram = frame.hasChecksum ? withChecksum(body) : "[" + body + "]";
+        return frame;
+    }
+
+    // Byte flips, cuts, separators and markers in random places
+    std::string mutate(std::string datagram, std::mt19937& random)
+    {
+        static const char interesting[] = { '[', ']', '|', '*', '\0', '-', '+', '9', 'F' };
+        int mutations = 1 + static_cast<int>(random() % 4);
+
+        for (int i = 0; (i < mutations) && !datagram.empty(); i++)
+        {
+            size_t pos = random() % datagram.size();
+            switch (random() % 5)
+            {
+                case 0:
+                    datagram[pos] = static_cast<char>(random() % 256);
+                    break;
+                case 1:
+                    datagram[pos] = interesting[random() % sizeof(interesting)];
+                    break;
+                case 2:
+                    datagram.erase(pos, 1 + (random() % 4));
+                    break;
+                case 3:
+                    datagram.insert(pos, 1, interesting[random() % sizeof(interesting)]);
+                    break;
+                default:
+                    datagram.resize(pos);
+                    break;
+            }
+        }
+        return datagram;
+    }
+
+    std::string randomBytes(std::mt19937& random)
+    {
+        std::string datagram(random() % 64, '\0');
+        for (auto& c : datagram)
+        {
+            c = static_cast<char>(random() % 256);
+        }
+        return datagram;
+    }
+
+    // The invariants that hold for any input, whatever the status. The frame's views point into buffer.
+    UdpFrame::Status check(std::string_view source, UdpFrame& frame, std::unique_ptr<char[]>& buffer)
+    {
+        buffer.reset(new char[source.size() == 0 ? 1 : source.size()]);
+        std::copy(source.begin(), source.end(), buffer.get());
+        std::string_view datagram(buffer.get(), source.size());
+
+        UdpFrame::Status status = frame.FnParse(datagram);
+        if (status != UdpFrame::Status::Ok)
+        {
+            if (frame.FnGetFieldCount() != 0)
+            {
+                fail("a refused frame kept fields", source);
+            }
+            return status;
+        }
+
+        if ((frame.FnGetFieldCount() < UdpFrame::MIN_FIELDS) || (frame.FnGetFieldCount() > UdpFrame::MAX_FIELDS))
+        {
+            fail("field count out of range", source);
+        }
+
+        for (size_t i = 0; i <= UdpFrame::MAX_FIELDS; i++)
+        {
+            std::string_view field = frame.FnGetField(i);
+            if (!isInside(field, datagram))
+            {
+                fail("field " + std::to_string(i) + " outside the datagram", source);
+            }
+            if ((i >= frame.FnGetFieldCount()) && !field.empty())
+            {
+                fail("field past the end is not empty", source);
+            }
+            for (std::string_view token : frame.FnSplit(i, ','))
+            {
+                if (!isInside(token, field))
+                {
+                    fail("split token outside its field", source);
+                }
+            }
+        }
+
+        int command;
+        if (!UdpFrame::FnParseInt(frame.FnGetField(UdpFrame::COMMAND_FIELD), command) || (command < 0) || (static_cast<unsigned int>(command) != frame.FnGetCommand()))
+        {
+            fail("command does not match its field", source);
+        }
+
+        return status;
+    }
+
+    void checkFixedCases()
+    {
+        struct Case
+        {
+            std::string datagram;
+            UdpFrame::Status expected;
+        };
+
+        const std::vector<Case> cases =
+        {
+            { "", UdpFrame::Status::NoStartMarker },
+            { "PMS|1|300|x|]", UdpFrame::Status::NoStartMarker },
+            { "[PMS|1|300|x|", UdpFrame::Status::NoEndMarker },
+            { "[]", UdpFrame::Status::TooFewFields },
+            { "[PMS|1|300|]", UdpFrame::Status::TooFewFields },
+            { "[PMS|1|3x0|data|]", UdpFrame::Status::BadCommand },
+            { "[PMS|1|-1|data|]", UdpFrame::Status::BadCommand },
+            { "[PMS|1||data|]", UdpFrame::Status::BadCommand },
+            { "[a|b|c|d|e|f|g|h|i|j|k|l|m|n|o|p|q|]", UdpFrame::Status::TooManyFields },
+            { "[PMS|1|300|data|*00|]", UdpFrame::Status::BadChecksum },
+            { "[PMS|1|300|data|]", UdpFrame::Status::Ok },
+            { "[PMS|1|+300|data]", UdpFrame::Status::Ok },
+            { "junk[PMS|1|300|data|]junk", UdpFrame::Status::Ok },
+            { withChecksum("PMS|1|300|data|"), UdpFrame::Status::Ok },
+        };
+
+        for (const auto& testCase : cases)
+        {
+            UdpFrame frame;
+            std::unique_ptr<char[]> buffer;
+            UdpFrame::Status status = check(testCase.datagram, frame, buffer);
+            if (status != testCase.expected)
+            {
+                fail(std::string("expected ") + UdpFrame::FnGetStatusText(testCase.expected) + ", got " + UdpFrame::FnGetStatusText(status), testCase.datagram);
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    long iterations = (argc > 1) ? std::atol(argv[1]) : 1000000;
+    unsigned int seed = (argc > 2) ? static_cast<unsigned int>(std::strtoul(argv[2], nullptr, 10)) : std::random_device()();
+    if (iterations <= 0)
+    {
+        std::cerr << "Usage: " << argv[0] << " [iterations] [seed]" << std::endl;
+        return 1;
+    }
+
+    std::mt19937 random(seed);
+    long okFrames = 0;
+
+    checkFixedCases();
+
+    for (long i = 0; i < iterations; i++)
+    {
+        UdpFrame frame;
+        std::unique_ptr<char[]> buffer;
+        BuiltFrame built = buildFrame(random);
+
+        switch (i % 3)
+        {
+            case 0:
+                // Well formed, every field comes back
+                if (check(built.datagram, frame, buffer) != UdpFrame::Status::Ok)
+                {
+                    fail("a well formed frame was refused", built.datagram);
+                    break;
+                }
+                if ((frame.FnGetFieldCount() != built.fields.size()) || (frame.FnHasChecksum() != built.hasChecksum))
+                {
+                    fail("field count or checksum flag differs", built.datagram);
+                    break;
+                }
+                for (size_t f = 0; f < built.fields.size(); f++)
+                {
+                    if (frame.FnGetField(f) != built.fields[f])
+                    {
+                        fail("field " + std::to_string(f) + " differs", built.datagram);
+                    }
+                }
+                okFrames++;
+                break;
+            case 1:
+                okFrames += (check(mutate(built.datagram, random), frame, buffer) == UdpFrame::Status::Ok) ? 1 : 0;
+                break;
+            default:
+                okFrames += (check(randomBytes(random), frame, buffer) == UdpFrame::Status::Ok) ? 1 : 0;
+                break;
+        }
+    }
+
+    std::cout << iterations << " datagrams, seed " << seed << ", " << okFrames << " parsed ok, " << failures << " failures" << std::endl;
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,173 @@
+#include <chrono>
+#include <sstream>
+#include "io_executor.h"
+#include "lane_context.h"
+#include "log.h"
+#include "udp_jobs.h"
+
+std::atomic<UdpJobExecutor*> UdpJobExecutor::udpJobExecutor_(nullptr);
+std::mutex UdpJobExecutor::mutex_;
+
+UdpJobExecutor::UdpJobExecutor()
+    : logFileName_("udpjob"),
+    ioContext_(),
+    workGuard_(boost::asio::make_work_guard(ioContext_)),
+    nextJobId_(1)
+{
+    for (int i = 0; i < JOB_THREADS; i++)
+    {
+        threads_.emplace_back([this, i]()
+        {
+            IOExecutor::FnNameCurrentThread("pbs-udpjob-" + std::to_string(i));
+            ioContext_.run();
+        });
+    }
+}
+
+UdpJobExecutor* UdpJobExecutor::getInstance()
+{
+    return LazyInstance::FnGet(udpJobExecutor_, mutex_, []() { return new UdpJobExecutor(); });
+}
+
+const char* UdpJobExecutor::FnGetStatusText(SubmitStatus status)
+{
+    switch (status)
+    {
+        case SubmitStatus::Queued:
+            return "accepted";
+        case SubmitStatus::Coalesced:
+            return "joined";
+        case SubmitStatus::Rejected:
+            return "rejected, busy";
+    }
+    return "unknown";
+}
+
+UdpJobExecutor::Submission UdpJobExecutor::FnSubmit(const std::string& key, JobScope scope, JobFunction job, DoneFunction done)
+{
+    int laneId = LaneContext::FnGetCurrentLane();
+    std::string laneKey = (scope == JobScope::Lane) ? (std::to_string(laneId) + ":" + key) : ("*:" + key);
+    // A controller job runs in the lane that queued it, each request is answered in its own
+    done = LaneContext::FnBind(laneId, std::move(done));
+    std::lock_guard<std::mutex> lock(jobMutex_);
+
+    auto it = jobs_.find(laneKey);
+    if (it != jobs_.end())
+    {
+        // A running pass may already have read the tables, so a request arriving now waits for one more pass
+        auto& existing = it->second;
+        if (existing->isRunning)
+        {
+            existing->isRerunRequested = true;
+            existing->waitingRerun.push_back(std::move(done));
+        }
+        else
+        {
+            existing->waiting.push_back(std::move(done));
+        }
+        return { SubmitStatus::Coalesced, existing->id };
+    }
+
+    if (jobs_.size() >= MAX_PENDING_JOBS)
+    {
+        Logger::getInstance()->FnLog("Job queue full, reject " + key, logFileName_, "UDP");
+        return { SubmitStatus::Rejected, 0 };
+    }
+
+    auto newJob = std::make_shared<Job>();
+    newJob->id = nextJobId_++;
+    newJob->laneId = laneId;
+    newJob->key = laneKey;
+    newJob->function = std::move(job);
+    newJob->isRunning = false;
+    newJob->isRerunRequested = false;
+    newJob->waiting.push_back(std::move(done));
+    jobs_[laneKey] = newJob;
+
+    boost::asio::post(ioContext_, [this, newJob]() { runJob(newJob); });
+    return { SubmitStatus::Queued, newJob->id };
+}
+
+void UdpJobExecutor::runJob(std::shared_ptr<Job> job)
+{
+    LaneContext::Scope scope(job->laneId);
+    auto startTime = std::chrono::steady_clock::now();
+
+    {
+        std::lock_guard<std::mutex> lock(jobMutex_);
+        job->isRunning = true;
+    }
+
+    JobResult result = { false, "" };
+    try
+    {
+        result = job->function();
+    }
+    catch (const std::exception& e)
+    {
+        std::stringstream ss;
+        ss << __func__ << ", Job: " << job->key << ", Exception: " << e.what();
+        Logger::getInstance()->FnLogExceptionError(ss.str());
+        result = { false, e.what() };
+    }
+    catch (...)
+    {
+        std::stringstream ss;
+        ss << __func__ << ", Job: " << job->key << ", Exception: Unknown Exception";
+        Logger::getInstance()->FnLogExceptionError(ss.str());
+        result = { false, "Unknown Exception" };
+    }
+
+    std::vector<DoneFunction> done;
+    bool isRerun;
+    {
+        std::lock_guard<std::mutex> lock(jobMutex_);
+        done.swap(job->waiting);
+        isRerun = job->isRerunRequested;
+        if (isRerun)
+        {
+            // Stays queued under its key, later requests keep joining it until the next pass starts
+            job->isRerunRequested = false;
+            job->isRunning = false;
+            job->waiting.swap(job->waitingRerun);
+        }
+        else
+        {
+            jobs_.erase(job->key);
+        }
+    }
+
+    std::stringstream ss;
+    ss << "Job " << job->id << " " << job->key << (result.success ? " done" : " failed");
+    ss << ", took " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count() << " ms";
+    if (isRerun)
+    {
+        ss << ", run again for the requests received meanwhile";
+    }
+    Logger::getInstance()->FnLog(ss.str(), logFileName_, "UDP");
+
+    for (auto& doneFunction : done)
+    {
+        try
+        {
+            doneFunction(job->id, result);
+        }
+        catch (const std::exception& e)
+        {
+            std::stringstream ess;
+            ess << __func__ << ", Job: " << job->key << ", Done Exception: " << e.what();
+            Logger::getInstance()->FnLogExceptionError(ess.str());
+        }
+        catch (...)
+        {
+            std::stringstream ess;
+            ess << __func__ << ", Job: " << job->key << ", Done Exception: Unknown Exception";
+            Logger::getInstance()->FnLogExceptionError(ess.str());
+        }
+    }
+
+    if (isRerun)
+    {
+        boost::asio::post(ioContext_, [this, job]() { runJob(job); });
+    }
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "boost/asio.hpp"
+#include "lazy_instance.h"
+
+// Runs the long UDP commands (table downloads, fee tests, ini copies) on a small pool of its own, so the
+// receive strands keep answering while a download runs and the DB pool keeps serving the transaction flows.
+// Every job has a key; a request whose key is already queued joins that job, one whose key is running
+// gets one more pass after it, and either way it is answered with the same job id.
+class UdpJobExecutor
+{
+public:
+    static const int JOB_THREADS = 2;
+    static const size_t MAX_PENDING_JOBS = 16;
+
+    struct JobResult
+    {
+        bool success;
+        std::string message;
+    };
+
+    using JobFunction = std::function<JobResult()>;
+    // Runs on a job thread in the lane that submitted the request
+    using DoneFunction = std::function<void(uint64_t jobId, const JobResult& result)>;
+
+    // A job on the lane's own rows is keyed per lane, the same command from two lanes runs twice. One that
+    // writes tables every lane shares is keyed for the whole controller, the lanes' requests join one job.
+    enum class JobScope
+    {
+        Lane,
+        Controller
+    };
+
+    enum class SubmitStatus
+    {
+        Queued,
+        Coalesced,
+        Rejected
+    };
+
+    struct Submission
+    {
+        SubmitStatus status;
+        uint64_t jobId;
+    };
+
+    static UdpJobExecutor* getInstance();
+
+    Submission FnSubmit(const std::string& key, JobScope scope, JobFunction job, DoneFunction done);
+    static const char* FnGetStatusText(SubmitStatus status);
+
+    /**
+     * Singleton UdpJobExecutor should not be cloneable.
+     */
+    UdpJobExecutor(UdpJobExecutor& udpJobExecutor) = delete;
+
+    /**
+     * Singleton UdpJobExecutor should not be assignable.
+     */
+    void operator=(const UdpJobExecutor&) = delete;
+
+private:
+    struct Job
+    {
+        uint64_t id;
+        int laneId;
+        std::string key;
+        JobFunction function;
+        bool isRunning;
+        bool isRerunRequested;
+        std::vector<DoneFunction> waiting;
+        std::vector<DoneFunction> waitingRerun;
+    };
+
+    static std::atomic<UdpJobExecutor*> udpJobExecutor_;
+    static std::mutex mutex_;
+    std::mutex jobMutex_;
+    std::string logFileName_;
+    boost::asio::io_context ioContext_;
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type> workGuard_;
+    std::vector<std::thread> threads_;
+    std::map<std::string, std::shared_ptr<Job>> jobs_;
+    uint64_t nextJobId_;
+    UdpJobExecutor();
+    void runJob(std::shared_ptr<Job> job);
+};
@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <cstring>
+#include "udp_frame.h"
+#include "udp_send_queue.h"
+
+UdpSendQueue::UdpSendQueue()
+    : slots_(),
+    nextSequence_(0),
+    depth_(0),
+    stats_()
+{
+}
+
+const char* UdpSendQueue::FnGetClassName(UdpSendClass sendClass)
+{
+    switch (sendClass)
+    {
+        case UdpSendClass::Event:
+            return "event";
+        case UdpSendClass::Status:
+            return "status";
+        case UdpSendClass::Log:
+            return "log";
+    }
+    return "unknown";
+}
+
+UdpSendQueue::ClassStats& UdpSendQueue::classStats(UdpSendClass sendClass)
+{
+    return stats_.classes[static_cast<size_t>(sendClass)];
+}
+
+UdpSendQueue::Slot* UdpSendQueue::findFree()
+{
+    for (auto& slot : slots_)
+    {
+        if (!slot.isQueued && !slot.isInFlight)
+        {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+UdpSendQueue::Slot* UdpSendQueue::findOldest(UdpSendClass sendClass)
+{
+    Slot* oldest = nullptr;
+    for (auto& slot : slots_)
+    {
+        if (slot.isQueued && (slot.sendClass == sendClass) && ((oldest == nullptr) || (slot.sequence < oldest->sequence)))
+        {
+            oldest = &slot;
+        }
+    }
+    return oldest;
+}
+
+UdpSendQueue::Slot* UdpSendQueue::findStatus(unsigned int command, std::string_view station)
+{
+    for (auto& slot : slots_)
+    {
+        if (slot.isQueued && (slot.sendClass == UdpSendClass::Status) && (slot.command == command)
+            && (std::string_view(slot.data.data() + slot.stationOffset, slot.stationLength) == station))
+        {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+void UdpSendQueue::copyMessage(Slot& slot, std::string_view message, std::string_view station)
+{
+    std::memcpy(slot.data.data(), message.data(), message.size());
+    slot.length = message.size();
+    slot.stationOffset = station.empty() ? 0 : static_cast<size_t>(station.data() - message.data());
+    slot.stationLength = station.size();
+}
+
+UdpSendQueue::Slot* UdpSendQueue::dropOldest(UdpSendClass sendClass)
+{
+    Slot* victim = findOldest(sendClass);
+    if (victim != nullptr)
+    {
+        victim->isQueued = false;
+        depth_--;
+        classStats(sendClass).dropped++;
+    }
+    return victim;
+}
+
+UdpSendQueue::PushResult UdpSendQueue::FnPush(std::string_view message, UdpSendClass sendClass)
+{
+    if (message.size() > SLOT_SIZE)
+    {
+        return PushResult::Oversize;
+    }
+
+    // A status is keyed by its station and command, a message that is not a frame never coalesces
+    UdpFrame frame;
+    bool isFrame = (frame.FnParse(message) == UdpFrame::Status::Ok);
+    unsigned int command = isFrame ? frame.FnGetCommand() : 0;
+    std::string_view station = isFrame ? frame.FnGetField(UdpFrame::STATION_FIELD) : std::string_view();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Slot* slot = nullptr;
+
+    if ((sendClass == UdpSendClass::Status) && (command != 0))
+    {
+        slot = findStatus(command, station);
+        if (slot != nullptr)
+        {
+            // Keeps its place in the queue, only the content is newer
+            copyMessage(*slot, message, station);
+            classStats(sendClass).coalesced++;
+            return PushResult::Coalesced;
+        }
+    }
+
+    if (sendClass == UdpSendClass::Log)
+    {
+        size_t logSlots = 0;
+        for (const auto& queued : slots_)
+        {
+            logSlots += (queued.isQueued && (queued.sendClass == UdpSendClass::Log)) ? 1 : 0;
+        }
+        if (logSlots >= MAX_LOG_SLOTS)
+        {
+            slot = dropOldest(UdpSendClass::Log);
+        }
+    }
+
+    if (slot == nullptr)
+    {
+        slot = findFree();
+    }
+
+    // Full: logs give way first, then statuses, events only to a newer event
+    if ((slot == nullptr) && (sendClass != UdpSendClass::Log))
+    {
+        slot = dropOldest(UdpSendClass::Log);
+        if (slot == nullptr)
+        {
+            slot = dropOldest(UdpSendClass::Status);
+        }
+        if ((slot == nullptr) && (sendClass == UdpSendClass::Event))
+        {
+            slot = dropOldest(UdpSendClass::Event);
+        }
+    }
+    else if (slot == nullptr)
+    {
+        slot = dropOldest(UdpSendClass::Log);
+    }
+
+    if (slot == nullptr)
+    {
+        classStats(sendClass).dropped++;
+        return PushResult::Dropped;
+    }
+
+    copyMessage(*slot, message, station);
+    slot->sendClass = sendClass;
+    slot->command = command;
+    slot->sequence = nextSequence_++;
+    slot->isQueued = true;
+    depth_++;
+    stats_.maxDepth = std::max(stats_.maxDepth, depth_);
+    classStats(sendClass).queued++;
+    return PushResult::Queued;
+}
+
+UdpSendQueue::Slot* UdpSendQueue::FnPopNext()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Slot* oldest = nullptr;
+
+    for (auto& slot : slots_)
+    {
+        if (slot.isQueued && ((oldest == nullptr) || (slot.sequence < oldest->sequence)))
+        {
+            oldest = &slot;
+        }
+    }
+
+    if (oldest != nullptr)
+    {
+        oldest->isQueued = false;
+        oldest->isInFlight = true;
+        depth_--;
+    }
+    return oldest;
+}
+
+void UdpSendQueue::FnRelease(Slot* slot, bool isSent)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    slot->isInFlight = false;
+
+    ClassStats& stats = classStats(slot->sendClass);
+    if (isSent)
+    {
+        stats.sent++;
+    }
+    else
+    {
+        stats.failed++;
+    }
+}
+
+void UdpSendQueue::FnCountOversize()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.oversize++;
+}
+
+UdpSendQueue::Stats UdpSendQueue::FnGetStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.depth = depth_;
+    return stats;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+
+// What a message is to its peer, decides what gives way when the queue is full
+enum class UdpSendClass
+{
+    Event,      // transactions, acks, replies; only dropped when the queue holds nothing else
+    Status,     // a snapshot (status, date time, LED mirror); a newer one replaces the queued one of the same station and command
+    Log         // forwarded log lines; limited to half the queue, the oldest goes first
+};
+
+// Outgoing datagrams of one UDP socket, which only ever sends to one peer. Messages are copied into a fixed
+// pool of datagram sized buffers, so a send allocates nothing and the queue can never hold more than the pool.
+// One frame per datagram is all the PMS and monitor parse, so coalescing replaces a queued status instead of
+// packing frames together.
+class UdpSendQueue
+{
+public:
+    static const size_t SLOT_COUNT = 32;
+    static const size_t SLOT_SIZE = 1472;     // Ethernet MTU less the IP and UDP headers, never fragmented
+    static const size_t MAX_LOG_SLOTS = SLOT_COUNT / 2;
+    static const size_t CLASS_COUNT = 3;
+
+    enum class PushResult
+    {
+        Queued,
+        Coalesced,
+        Dropped,
+        Oversize    // does not fit a slot, the caller sends it on its own
+    };
+
+    struct Slot
+    {
+        std::array<char, SLOT_SIZE> data;
+        size_t length;
+        UdpSendClass sendClass;
+        unsigned int command;
+        // The station field, where in data it is; lanes share the monitor socket, each station keeps its own status
+        size_t stationOffset;
+        size_t stationLength;
+        uint64_t sequence;
+        bool isQueued;
+        bool isInFlight;
+    };
+
+    struct ClassStats
+    {
+        uint64_t queued;
+        uint64_t coalesced;
+        uint64_t dropped;
+        uint64_t sent;
+        uint64_t failed;
+    };
+
+    struct Stats
+    {
+        std::array<ClassStats, CLASS_COUNT> classes;
+        uint64_t oversize;
+        size_t depth;
+        size_t maxDepth;
+    };
+
+    UdpSendQueue();
+
+    // Safe to call from any thread
+    PushResult FnPush(std::string_view message, UdpSendClass sendClass);
+
+    // Oldest queued message, now in flight until FnRelease, nullptr when nothing is queued
+    Slot* FnPopNext();
+    void FnRelease(Slot* slot, bool isSent);
+
+    void FnCountOversize();
+    Stats FnGetStats() const;
+    static const char* FnGetClassName(UdpSendClass sendClass);
+
+    UdpSendQueue(const UdpSendQueue&) = delete;
+    void operator=(const UdpSendQueue&) = delete;
+
+private:
+    mutable std::mutex mutex_;
+    std::array<Slot, SLOT_COUNT> slots_;
+    uint64_t nextSequence_;
+    size_t depth_;
+    Stats stats_;
+    Slot* findFree();
+    Slot* findOldest(UdpSendClass sendClass);
+    Slot* findStatus(unsigned int command, std::string_view station);
+    static void copyMessage(Slot& slot, std::string_view message, std::string_view station);
+    Slot* dropOldest(UdpSendClass sendClass);
+    ClassStats& classStats(UdpSendClass sendClass);
+};
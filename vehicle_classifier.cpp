@@ -0,0 +1,269 @@
+#include <algorithm>
+#include <sstream>
+#include "event_manager.h"
+#include "log.h"
+#include "vehicle_classifier.h"
+
+std::array<std::atomic<VehicleClassifier*>, LaneContext::MAX_LANES> VehicleClassifier::vehicleClassifiers_ = {};
+std::mutex VehicleClassifier::mutex_;
+
+VehicleClassifier::VehicleClassifier()
+    : logFileName_("dio"),
+    classifyWindowMs_(500),
+    minOverlapMs_(0),
+    state_(ClassifyState::IDLE),
+    loopA_(0),
+    loopB_(0),
+    loopC_(0),
+    record_(),
+    resolvedType_(VEHICLE_TYPE_MOTORCYCLE),
+    isRequestPending_(false),
+    vehicleCount_(0),
+    carCount_(0),
+    motorcycleCount_(0),
+    totalLoopADwellMs_(0),
+    totalLoopBDwellMs_(0),
+    totalResolveMs_(0),
+    maxResolveMs_(0)
+{
+}
+
+VehicleClassifier* VehicleClassifier::getInstance()
+{
+    return LazyInstance::FnGet(vehicleClassifiers_[LaneContext::FnGetCurrentLane()], mutex_, []() { return new VehicleClassifier(); });
+}
+
+void VehicleClassifier::FnSetWindows(int classifyWindowMs, int minOverlapMs)
+{
+    std::lock_guard<std::mutex> lock(classifierMutex_);
+    classifyWindowMs_ = std::max(classifyWindowMs, 0);
+    minOverlapMs_ = std::max(minOverlapMs, 0);
+
+    std::stringstream ss;
+    ss << __func__ << " Classify window : " << classifyWindowMs_ << " ms, Min Loop A/B overlap : " << minOverlapMs_ << " ms";
+    Logger::getInstance()->FnLog(ss.str(), logFileName_, "DIO");
+}
+
+int64_t VehicleClassifier::elapsedMs(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(to - from).count();
+}
+
+void VehicleClassifier::FnOnLoopState(int loopA, int loopB, int loopC, std::chrono::steady_clock::time_point timestamp)
+{
+    std::lock_guard<std::mutex> lock(classifierMutex_);
+
+    bool loopARise = (loopA != 0) && (loopA_ == 0);
+    bool loopAFall = (loopA == 0) && (loopA_ != 0);
+    bool loopBRise = (loopB != 0) && (loopB_ == 0);
+    bool loopBFall = (loopB == 0) && (loopB_ != 0);
+    bool wasOverlap = (loopA_ != 0) && (loopB_ != 0);
+    bool isOverlap = (loopA != 0) && (loopB != 0);
+
+    // Loop C is after the barrier, its dwell is reported on its own
+    if ((loopC != 0) && (loopC_ == 0))
+    {
+        loopCOnTime_ = timestamp;
+    }
+    else if ((loopC == 0) && (loopC_ != 0))
+    {
+        std::stringstream ss;
+        ss << "Loop C dwell : " << elapsedMs(loopCOnTime_, timestamp) << " ms";
+        Logger::getInstance()->FnLog(ss.str(), logFileName_, "DIO");
+    }
+
+    // A vehicle arrives on whichever of Loop A/Loop B triggers first, same as the DIO LOOP_A_ON_EVENT
+    if ((state_ == ClassifyState::IDLE) && (loopARise || loopBRise))
+    {
+        record_ = VehicleRecord();
+        record_.arrivalTime = timestamp;
+        deadline_ = timestamp + std::chrono::milliseconds(classifyWindowMs_);
+        state_ = ClassifyState::PENDING;
+    }
+
+    if (loopARise)
+    {
+        record_.loopAOnTime = timestamp;
+        if (!record_.isLoopASeen)
+        {
+            record_.firstLoopAOnTime = timestamp;
+            record_.isLoopASeen = true;
+        }
+    }
+    else if (loopAFall)
+    {
+        record_.loopADwellMs += elapsedMs(record_.loopAOnTime, timestamp);
+    }
+
+    if (loopBRise)
+    {
+        record_.loopBOnTime = timestamp;
+        if (!record_.isLoopBSeen)
+        {
+            record_.firstLoopBOnTime = timestamp;
+            record_.isLoopBSeen = true;
+        }
+    }
+    else if (loopBFall)
+    {
+        record_.loopBDwellMs += elapsedMs(record_.loopBOnTime, timestamp);
+    }
+
+    if (!wasOverlap && isOverlap)
+    {
+        record_.overlapStartTime = timestamp;
+    }
+    else if (wasOverlap && !isOverlap)
+    {
+        record_.overlapMs += elapsedMs(record_.overlapStartTime, timestamp);
+    }
+
+    loopA_ = loopA;
+    loopB_ = loopB;
+    loopC_ = loopC;
+
+    if (state_ == ClassifyState::PENDING)
+    {
+        if (isOverlap && (elapsedMs(record_.overlapStartTime, timestamp) >= minOverlapMs_))
+        {
+            resolve(VEHICLE_TYPE_CAR, timestamp);
+        }
+        else if ((loopA == 0) && (loopB == 0))
+        {
+            // Left both loops before Loop A and Loop B were covered together
+            resolve(VEHICLE_TYPE_MOTORCYCLE, timestamp);
+        }
+    }
+
+    if ((state_ == ClassifyState::RESOLVED) && (loopA == 0) && (loopB == 0))
+    {
+        completeVehicle();
+    }
+}
+
+void VehicleClassifier::FnCheckTimeout(std::chrono::steady_clock::time_point now)
+{
+    std::lock_guard<std::mutex> lock(classifierMutex_);
+
+    if (state_ != ClassifyState::PENDING)
+    {
+        return;
+    }
+
+    if ((loopA_ != 0) && (loopB_ != 0) && (minOverlapMs_ > 0)
+        && (now >= (record_.overlapStartTime + std::chrono::milliseconds(minOverlapMs_))))
+    {
+        resolve(VEHICLE_TYPE_CAR, record_.overlapStartTime + std::chrono::milliseconds(minOverlapMs_));
+    }
+    else if (now >= deadline_)
+    {
+        // Window expired, Loop B still covered means a longer vehicle
+        resolve((loopB_ != 0) ? VEHICLE_TYPE_CAR : VEHICLE_TYPE_MOTORCYCLE, deadline_);
+    }
+}
+
+int VehicleClassifier::FnGetNextTimeoutMs(std::chrono::steady_clock::time_point now, int maxTimeoutMs)
+{
+    std::lock_guard<std::mutex> lock(classifierMutex_);
+
+    if (state_ != ClassifyState::PENDING)
+    {
+        return maxTimeoutMs;
+    }
+
+    std::chrono::steady_clock::time_point next = deadline_;
+    if ((loopA_ != 0) && (loopB_ != 0) && (minOverlapMs_ > 0))
+    {
+        next = std::min(next, record_.overlapStartTime + std::chrono::milliseconds(minOverlapMs_));
+    }
+
+    // Round up so the wait does not end just before the deadline
+    int64_t waitMs = std::chrono::duration_cast<std::chrono::milliseconds>(next - now + std::chrono::microseconds(999)).count();
+
+    return static_cast<int>(std::max<int64_t>(0, std::min<int64_t>(waitMs, maxTimeoutMs)));
+}
+
+void VehicleClassifier::resolve(int vehicleType, std::chrono::steady_clock::time_point timestamp)
+{
+    state_ = ClassifyState::RESOLVED;
+    resolvedType_ = vehicleType;
+    record_.resolveMs = std::max<int64_t>(0, elapsedMs(record_.arrivalTime, timestamp));
+
+    std::stringstream ss;
+    ss << "Vehicle classified : " << ((vehicleType == VEHICLE_TYPE_CAR) ? "Car" : "Motorcycle") << ", resolved in " << record_.resolveMs << " ms";
+    Logger::getInstance()->FnLog(ss.str(), logFileName_, "DIO");
+
+    if (isRequestPending_)
+    {
+        isRequestPending_ = false;
+        raiseClassification();
+    }
+}
+
+void VehicleClassifier::completeVehicle()
+{
+    vehicleCount_++;
+    if (resolvedType_ == VEHICLE_TYPE_CAR)
+    {
+        carCount_++;
+    }
+    else
+    {
+        motorcycleCount_++;
+    }
+    totalLoopADwellMs_ += static_cast<uint64_t>(std::max<int64_t>(0, record_.loopADwellMs));
+    totalLoopBDwellMs_ += static_cast<uint64_t>(std::max<int64_t>(0, record_.loopBDwellMs));
+    totalResolveMs_ += static_cast<uint64_t>(record_.resolveMs);
+    maxResolveMs_ = std::max(maxResolveMs_, static_cast<uint64_t>(record_.resolveMs));
+
+    // Per vehicle loop timings, used to tune the classify window and overlap threshold
+    std::stringstream ss;
+    ss << "Vehicle dwell, Type : " << resolvedType_;
+    ss << ", Loop A : " << record_.loopADwellMs << " ms";
+    ss << ", Loop B : " << record_.loopBDwellMs << " ms";
+    ss << ", Overlap : " << record_.overlapMs << " ms";
+    if (record_.isLoopASeen && record_.isLoopBSeen)
+    {
+        ss << ", Loop A to Loop B : " << elapsedMs(record_.firstLoopAOnTime, record_.firstLoopBOnTime) << " ms";
+    }
+    ss << ", Resolve : " << record_.resolveMs << " ms";
+    Logger::getInstance()->FnLog(ss.str(), logFileName_, "DIO");
+
+    state_ = ClassifyState::IDLE;
+}
+
+void VehicleClassifier::FnRequestClassification()
+{
+    std::lock_guard<std::mutex> lock(classifierMutex_);
+
+    if (state_ == ClassifyState::PENDING)
+    {
+        isRequestPending_ = true;
+    }
+    else
+    {
+        // Already resolved, or the vehicle left before the request came in
+        raiseClassification();
+    }
+}
+
+void VehicleClassifier::raiseClassification()
+{
+    EventManager::getInstance()->FnEnqueueEvent(EventID::VEHICLE_CLASSIFIED, VehicleClassData{ resolvedType_, record_.arrivalTime, record_.resolveMs });
+}
+
+VehicleClassifier::VehicleClassifierStats VehicleClassifier::FnGetStats()
+{
+    std::lock_guard<std::mutex> lock(classifierMutex_);
+
+    VehicleClassifierStats stats;
+    stats.vehicles = vehicleCount_;
+    stats.cars = carCount_;
+    stats.motorcycles = motorcycleCount_;
+    stats.avgLoopADwellMs = (vehicleCount_ > 0) ? (totalLoopADwellMs_ / vehicleCount_) : 0;
+    stats.avgLoopBDwellMs = (vehicleCount_ > 0) ? (totalLoopBDwellMs_ / vehicleCount_) : 0;
+    stats.avgResolveMs = (vehicleCount_ > 0) ? (totalResolveMs_ / vehicleCount_) : 0;
+    stats.maxResolveMs = maxResolveMs_;
+
+    return stats;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include "lane_context.h"
+#include "lazy_instance.h"
+
+// Classifies the vehicle on Loop A/Loop B from loop edges fed by the DIO monitoring thread.
+// Nothing here blocks: the result is delivered as a VEHICLE_CLASSIFIED event once it is resolved.
+class VehicleClassifier
+{
+public:
+    static const int VEHICLE_TYPE_CAR = 1;
+    static const int VEHICLE_TYPE_MOTORCYCLE = 7;
+
+    struct VehicleClassifierStats
+    {
+        uint64_t vehicles;
+        uint64_t cars;
+        uint64_t motorcycles;
+        uint64_t avgLoopADwellMs;
+        uint64_t avgLoopBDwellMs;
+        uint64_t avgResolveMs;
+        uint64_t maxResolveMs;
+    };
+
+    static VehicleClassifier* getInstance();
+    void FnSetWindows(int classifyWindowMs, int minOverlapMs);
+
+    // Called from the DIO monitoring thread
+    void FnOnLoopState(int loopA, int loopB, int loopC, std::chrono::steady_clock::time_point timestamp);
+    void FnCheckTimeout(std::chrono::steady_clock::time_point now);
+    int FnGetNextTimeoutMs(std::chrono::steady_clock::time_point now, int maxTimeoutMs);
+
+    // Called from the event thread, the classification event is raised once the vehicle is resolved
+    void FnRequestClassification();
+    VehicleClassifierStats FnGetStats();
+
+    /**
+     * Singleton VehicleClassifier should not be cloneable.
+     */
+    VehicleClassifier(VehicleClassifier& vehicleClassifier) = delete;
+
+    /**
+     * Singleton VehicleClassifier should not be assignable.
+     */
+    void operator=(const VehicleClassifier&) = delete;
+
+private:
+    enum class ClassifyState
+    {
+        IDLE,
+        PENDING,
+        RESOLVED
+    };
+
+    // Loop timings of the vehicle currently on Loop A/Loop B
+    struct VehicleRecord
+    {
+        std::chrono::steady_clock::time_point arrivalTime;
+        std::chrono::steady_clock::time_point loopAOnTime;
+        std::chrono::steady_clock::time_point loopBOnTime;
+        std::chrono::steady_clock::time_point overlapStartTime;
+        std::chrono::steady_clock::time_point firstLoopAOnTime;
+        std::chrono::steady_clock::time_point firstLoopBOnTime;
+        bool isLoopASeen;
+        bool isLoopBSeen;
+        int64_t loopADwellMs;
+        int64_t loopBDwellMs;
+        int64_t overlapMs;
+        int64_t resolveMs;
+    };
+
+    static std::array<std::atomic<VehicleClassifier*>, LaneContext::MAX_LANES> vehicleClassifiers_;
+    static std::mutex mutex_;
+    std::mutex classifierMutex_;
+    std::string logFileName_;
+    int classifyWindowMs_;
+    int minOverlapMs_;
+    ClassifyState state_;
+    int loopA_;
+    int loopB_;
+    int loopC_;
+    std::chrono::steady_clock::time_point loopCOnTime_;
+    std::chrono::steady_clock::time_point deadline_;
+    VehicleRecord record_;
+    int resolvedType_;
+    bool isRequestPending_;
+    uint64_t vehicleCount_;
+    uint64_t carCount_;
+    uint64_t motorcycleCount_;
+    uint64_t totalLoopADwellMs_;
+    uint64_t totalLoopBDwellMs_;
+    uint64_t totalResolveMs_;
+    uint64_t maxResolveMs_;
+    VehicleClassifier();
+    void resolve(int vehicleType, std::chrono::steady_clock::time_point timestamp);
+    void completeVehicle();
+    void raiseClassification();
+    static int64_t elapsedMs(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to);
+};